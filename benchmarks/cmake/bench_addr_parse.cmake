@@ -0,0 +1,5 @@
+target_benchmark(bench_addr_parse)
+target_sources(bench_addr_parse
+    PRIVATE
+        src/bench_addr_parse.cpp
+)
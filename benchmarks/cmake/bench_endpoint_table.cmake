@@ -0,0 +1,5 @@
+target_benchmark(bench_endpoint_table)
+target_sources(bench_endpoint_table
+    PRIVATE
+        src/bench_endpoint_table.cpp
+)
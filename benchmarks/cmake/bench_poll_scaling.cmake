@@ -0,0 +1,2 @@
+target_benchmark(bench_poll_scaling)
+target_sources(bench_poll_scaling PRIVATE src/bench_poll_scaling.cpp)
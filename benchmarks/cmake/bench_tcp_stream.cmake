@@ -0,0 +1,2 @@
+target_benchmark(bench_tcp_stream)
+target_sources(bench_tcp_stream PRIVATE src/bench_tcp_stream.cpp)
@@ -0,0 +1,2 @@
+target_benchmark(bench_udp_pps)
+target_sources(bench_udp_pps PRIVATE src/bench_udp_pps.cpp)
@@ -0,0 +1,2 @@
+target_benchmark(bench_udp_rtt)
+target_sources(bench_udp_rtt PRIVATE src/bench_udp_rtt.cpp)
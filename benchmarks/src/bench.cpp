@@ -0,0 +1,211 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <numeric>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+options
+parse_options(int argc,
+              char* argv[])
+{
+    options opts;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            exit(EXIT_FAILURE);
+        }
+
+        if (strcmp(arg, "--duration") == 0)
+            opts.duration = strtod(value, nullptr);
+        else if (strcmp(arg, "--iterations") == 0)
+            opts.iterations = (size_t)strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--output") == 0)
+            opts.output = value;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--duration <seconds>] [--iterations <count>] [--output <file>]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+
+        i++;
+    }
+
+    if (opts.duration <= 0 || opts.iterations == 0)
+    {
+        fprintf(stderr, "Invalid duration or iterations\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return opts;
+}
+
+record::
+record(const char* benchmark)
+{
+    line = "{\"benchmark\":\"";
+    line += benchmark;
+    line += "\"";
+    field("version", clarinet_get_version());
+}
+
+record&
+record::
+field(const char* key,
+      const char* value)
+{
+    line += ",\"";
+    line += key;
+    line += "\":\"";
+    line += value;
+    line += "\"";
+    return *this;
+}
+
+record&
+record::
+field(const char* key,
+      uint64_t value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+    line += ",\"";
+    line += key;
+    line += "\":";
+    line += buf;
+    return *this;
+}
+
+record&
+record::
+field(const char* key,
+      double value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3f", value);
+    line += ",\"";
+    line += key;
+    line += "\":";
+    line += buf;
+    return *this;
+}
+
+void
+record::
+emit(const options& opts)
+{
+    const std::string text = line + "}\n";
+    fputs(text.c_str(), stdout);
+    fflush(stdout);
+
+    if (!opts.output.empty())
+    {
+        FILE* f = fopen(opts.output.c_str(), "a");
+        if (!f)
+        {
+            fprintf(stderr, "Cannot open %s\n", opts.output.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        fputs(text.c_str(), f);
+        fclose(f);
+    }
+}
+
+void
+check(int errcode,
+      const char* what)
+{
+    if (errcode < 0)
+    {
+        fprintf(stderr, "%s failed: %s\n", what, clarinet_error_name(errcode));
+        exit(EXIT_FAILURE);
+    }
+}
+
+double
+elapsed(bench_clock::time_point start)
+{
+    return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+uint64_t
+elapsed_ns(bench_clock::time_point start)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+}
+
+record&
+latency(record& r,
+        std::vector<uint64_t>& samples)
+{
+    if (samples.empty())
+        return r.field("samples", (uint64_t)0);
+
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&samples](double q)
+    {
+        return samples[std::min(samples.size() - 1, (size_t)(q * (double)samples.size()))];
+    };
+
+    const double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+    return r.field("samples", (uint64_t)samples.size())
+        .field("min_ns", samples.front())
+        .field("mean_ns", sum / (double)samples.size())
+        .field("p50_ns", at(0.50))
+        .field("p99_ns", at(0.99))
+        .field("p999_ns", at(0.999))
+        .field("max_ns", samples.back());
+}
+
+void
+open_loopback(clarinet_socket* sp,
+              int proto,
+              clarinet_endpoint* local)
+{
+    clarinet_socket_init(sp);
+    check(clarinet_socket_open(sp, CLARINET_AF_INET, proto), "clarinet_socket_open");
+
+    const clarinet_endpoint any = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    check(clarinet_socket_bind(sp, &any), "clarinet_socket_bind");
+    check(clarinet_socket_local_endpoint(sp, local), "clarinet_socket_local_endpoint");
+}
+
+size_t
+raise_fd_limit(size_t n)
+{
+#if defined(_WIN32)
+    return n;
+#else
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return 0;
+
+    if (limit.rlim_cur < n)
+    {
+        limit.rlim_cur = (limit.rlim_max == RLIM_INFINITY || limit.rlim_max >= n) ? n : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    return (size_t)limit.rlim_cur;
+#endif
+}
+
+autoload::
+autoload() noexcept
+{
+    clarinet_initialize();
+}
+
+autoload::
+~autoload()
+{
+    clarinet_finalize();
+}
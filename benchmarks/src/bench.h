@@ -0,0 +1,99 @@
+#pragma once
+#ifndef BENCHMARKS_BENCH_H
+#define BENCHMARKS_BENCH_H
+
+#include "clarinet/clarinet.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Benchmarks are plain executables (no framework) that print one JSON object per measurement on stdout so results can
+// be collected and compared between releases. Every record carries the library version and the benchmark name.
+
+typedef std::chrono::steady_clock bench_clock;
+
+struct options
+{
+    double duration = 1.0;          // Seconds each measurement should take
+    size_t iterations = 100000;     // Maximum number of samples of latency measurements
+    std::string output;             // File to append the records to (besides stdout)
+};
+
+options
+parse_options(int argc,
+              char* argv[]);
+
+// Builder of a single line JSON record.
+class record
+{
+private:
+    std::string line;
+
+public:
+    explicit
+    record(const char* benchmark);
+
+    record&
+    field(const char* key,
+          const char* value);
+
+    record&
+    field(const char* key,
+          uint64_t value);
+
+    record&
+    field(const char* key,
+          double value);
+
+    void
+    emit(const options& opts);
+};
+
+// Abort the benchmark if errcode is a clarinet error code.
+void
+check(int errcode,
+      const char* what);
+
+// Seconds elapsed since start.
+double
+elapsed(bench_clock::time_point start);
+
+// Nanoseconds elapsed since start.
+uint64_t
+elapsed_ns(bench_clock::time_point start);
+
+// Add the latency statistics of samples (in nanoseconds) to a record. Samples are sorted in place.
+record&
+latency(record& r,
+        std::vector<uint64_t>& samples);
+
+// Open a socket bound to an ephemeral port of the IPv4 loopback and store the endpoint in local.
+void
+open_loopback(clarinet_socket* sp,
+              int proto,
+              clarinet_endpoint* local);
+
+// Raise the soft limit of open file descriptors as close as possible to n. Returns the resulting limit.
+size_t
+raise_fd_limit(size_t n);
+
+struct autoload
+{
+    autoload() noexcept;
+
+    ~autoload();
+};
+
+#endif // BENCHMARKS_BENCH_H
@@ -0,0 +1,159 @@
+#include "bench.h"
+
+#include <random>
+
+#if defined(_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+// Address parsing throughput: clarinet_addr_from_string() and clarinet_endpoint_from_string() against the system
+// inet_pton() over the same generated inputs. inet_pton() is given the address family upfront which is an advantage
+// over a generic parser, and is skipped for inputs it cannot parse at all (scope ids and endpoints).
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+#define CORPUS_SIZE 1024
+
+struct corpus
+{
+    const char* name;
+    int family;             // AF_UNSPEC if inet_pton() cannot parse the inputs
+    bool endpoint;
+    std::vector<std::string> inputs;
+};
+
+static
+unsigned
+next(std::mt19937& rng,
+     unsigned mask)
+{
+    return (unsigned)rng() & mask;
+}
+
+static
+std::string
+make_ipv4(std::mt19937& rng)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", next(rng, 0xFF), next(rng, 0xFF), next(rng, 0xFF), next(rng, 0xFF));
+    return buf;
+}
+
+static
+std::string
+make_ipv6(std::mt19937& rng)
+{
+    char buf[40];
+    // Compress a run of groups every other address to exercise '::'
+    if (next(rng, 1))
+        snprintf(buf, sizeof(buf), "%x:%x::%x:%x", next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFFFF),
+                 next(rng, 0xFFFF));
+    else
+        snprintf(buf, sizeof(buf), "%x:%x:%x:%x:%x:%x:%x:%x", next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFFFF),
+                 next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFFFF));
+    return buf;
+}
+
+static
+std::vector<corpus>
+make_corpora()
+{
+    std::mt19937 rng(42);
+    std::vector<corpus> corpora = {
+        { "ipv4", AF_INET, false, {}},
+        { "ipv6", AF_INET6, false, {}},
+        { "ipv6_mapped", AF_INET6, false, {}},
+        { "ipv6_scope", AF_UNSPEC, false, {}},
+        { "endpoint_ipv4", AF_UNSPEC, true, {}},
+        { "endpoint_ipv6", AF_UNSPEC, true, {}},
+    };
+
+    for (size_t i = 0; i < CORPUS_SIZE; ++i)
+    {
+        char scoped[40];
+        snprintf(scoped, sizeof(scoped), "fe80::%x:%x%%%u", next(rng, 0xFFFF), next(rng, 0xFFFF), next(rng, 0xFF) + 1);
+
+        const std::string port = std::to_string(next(rng, 0xFFFF));
+        corpora[0].inputs.push_back(make_ipv4(rng));
+        corpora[1].inputs.push_back(make_ipv6(rng));
+        corpora[2].inputs.push_back("::ffff:" + make_ipv4(rng));
+        corpora[3].inputs.push_back(scoped);
+        corpora[4].inputs.push_back(make_ipv4(rng) + ":" + port);
+        corpora[5].inputs.push_back("[" + make_ipv6(rng) + "]:" + port);
+    }
+
+    return corpora;
+}
+
+template<typename F>
+static
+void
+measure(const corpus& c,
+        const char* parser,
+        const options& opts,
+        F parse)
+{
+    uint64_t parses = 0;
+    uint64_t failures = 0;
+    const auto start = bench_clock::now();
+    double seconds = 0;
+    do
+    {
+        for (const auto& input: c.inputs)
+            failures += parse(input) ? 0 : 1;
+
+        parses += c.inputs.size();
+    }
+    while ((seconds = elapsed(start)) < opts.duration);
+
+    record("addr_parse")
+        .field("parser", parser)
+        .field("input", c.name)
+        .field("parses", parses)
+        .field("failures", failures)
+        .field("ns_per_parse", seconds * 1e9 / (double)parses)
+        .field("mparses_per_s", (double)parses / seconds / 1e6)
+        .emit(opts);
+}
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+    const std::vector<corpus> corpora = make_corpora();
+
+    for (const auto& c: corpora)
+    {
+        if (c.endpoint)
+        {
+            measure(c, "clarinet_endpoint_from_string", opts, [](const std::string& input)
+            {
+                clarinet_endpoint endpoint;
+                return clarinet_endpoint_from_string(&endpoint, input.data(), input.size()) == CLARINET_ENONE;
+            });
+            continue;
+        }
+
+        measure(c, "clarinet_addr_from_string", opts, [](const std::string& input)
+        {
+            clarinet_addr addr;
+            return clarinet_addr_from_string(&addr, input.data(), input.size()) == CLARINET_ENONE;
+        });
+
+        if (c.family != AF_UNSPEC)
+        {
+            const int family = c.family;
+            measure(c, "inet_pton", opts, [family](const std::string& input)
+            {
+                struct in6_addr addr;
+                return inet_pton(family, input.c_str(), &addr) == 1;
+            });
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
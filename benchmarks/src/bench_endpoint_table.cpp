@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+
+// Endpoint table lookups: time per clarinet_endpoint_table_find() for keys present (hit) and absent (miss) in tables
+// of increasing size filled with an even mix of IPv4 and IPv6 endpoints. Keys are visited in random order so that,
+// past a certain size, each lookup pays for cache misses as it would when serving datagrams from many sessions.
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const size_t sizes[] = { 1000, 100000, 1000000 };
+
+static
+clarinet_endpoint
+make_endpoint(std::mt19937& rng)
+{
+    const uint32_t n = (uint32_t)rng();
+    const uint16_t port = (uint16_t)(1024 + (rng() % 60000));
+    if (n & 1)
+        return clarinet_make_endpoint(clarinet_make_ipv4(10, (uint8_t)(n >> 24), (uint8_t)(n >> 16), (uint8_t)(n >> 8)),
+                                      port);
+
+    return clarinet_make_endpoint(clarinet_make_ipv6(0x2001, 0xDB8, 0, 0, 0, 0, (uint16_t)(n >> 16), (uint16_t)n, 0),
+                                  port);
+}
+
+static
+void
+measure(const clarinet_endpoint_table& table,
+        const std::vector<clarinet_endpoint>& keys,
+        const char* lookup,
+        const options& opts)
+{
+    uint64_t lookups = 0;
+    uint64_t found = 0;
+    const auto start = bench_clock::now();
+    double seconds = 0;
+    do
+    {
+        for (const auto& key: keys)
+        {
+            void* value;
+            found += clarinet_endpoint_table_find(&table, &key, &value) == CLARINET_ENONE ? 1 : 0;
+        }
+
+        lookups += keys.size();
+    }
+    while ((seconds = elapsed(start)) < opts.duration);
+
+    record("endpoint_table")
+        .field("entries", (uint64_t)table.count)
+        .field("lookup", lookup)
+        .field("lookups", lookups)
+        .field("found", found)
+        .field("ns_per_lookup", seconds * 1e9 / (double)lookups)
+        .emit(opts);
+}
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+
+    for (const size_t size: sizes)
+    {
+        std::mt19937 rng(7);
+        std::vector<uint8_t> buf((size_t)clarinet_endpoint_table_calcsize(size));
+        clarinet_endpoint_table table;
+        clarinet_endpoint_table_init(&table);
+        check(clarinet_endpoint_table_open(&table, buf.data(), buf.size(), size, rng(), CLARINET_ENDPOINT_TABLE_NONE),
+              "clarinet_endpoint_table_open");
+
+        std::vector<clarinet_endpoint> hits;
+        hits.reserve(size);
+        while (hits.size() < size)
+        {
+            const clarinet_endpoint endpoint = make_endpoint(rng);
+            if (clarinet_endpoint_table_insert(&table, &endpoint, nullptr) == CLARINET_ENONE)
+                hits.push_back(endpoint);
+        }
+
+        std::vector<clarinet_endpoint> misses;
+        misses.reserve(size);
+        while (misses.size() < size)
+        {
+            const clarinet_endpoint endpoint = make_endpoint(rng);
+            void* value;
+            if (clarinet_endpoint_table_find(&table, &endpoint, &value) == CLARINET_ENOTFOUND)
+                misses.push_back(endpoint);
+        }
+
+        std::shuffle(hits.begin(), hits.end(), rng);
+        measure(table, hits, "hit", opts);
+        measure(table, misses, "miss", opts);
+
+        clarinet_endpoint_table_close(&table);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+#include "bench.h"
+
+// Poll scaling: latency from sending a datagram to one of N idle UDP sockets until the poll mechanism reports it ready.
+// clarinet_socket_poll() is expected to grow with N since every call scans all targets while clarinet_poller_wait()
+// should remain flat.
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const size_t counts[] = { 1000, 10000 };
+
+// Stride used to pick the next socket so consecutive samples do not hit the same one (prime).
+#define STRIDE 7919
+
+struct fixture
+{
+    std::vector<clarinet_socket> sockets;
+    std::vector<clarinet_endpoint> endpoints;
+    clarinet_socket sender;
+
+    explicit
+    fixture(size_t count)
+        : sockets(count), endpoints(count)
+    {
+        const int32_t nonblock = 1;
+        for (size_t i = 0; i < count; ++i)
+        {
+            open_loopback(&sockets[i], CLARINET_PROTO_UDP, &endpoints[i]);
+            check(clarinet_socket_setopt(&sockets[i], CLARINET_SO_NONBLOCK, &nonblock, sizeof(nonblock)), "setopt");
+        }
+
+        clarinet_endpoint local;
+        open_loopback(&sender, CLARINET_PROTO_UDP, &local);
+    }
+
+    ~fixture()
+    {
+        clarinet_socket_close(&sender);
+        for (auto& socket: sockets)
+            clarinet_socket_close(&socket);
+    }
+
+    void
+    ping(size_t k)
+    {
+        const uint8_t buf[1] = { 0 };
+        check(clarinet_socket_sendto(&sender, buf, sizeof(buf), &endpoints[k]), "clarinet_socket_sendto");
+    }
+
+    void
+    drain(size_t k)
+    {
+        uint8_t buf[16];
+        clarinet_endpoint remote;
+        while (clarinet_socket_recvfrom(&sockets[k], buf, sizeof(buf), &remote) > 0)
+            continue;
+    }
+};
+
+static
+void
+measure_poll(fixture& f,
+             const options& opts)
+{
+    const size_t count = f.sockets.size();
+    std::vector<clarinet_socket_poll_target> targets(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        targets[i].socket = &f.sockets[i];
+        targets[i].events = CLARINET_POLL_RECV;
+    }
+
+    const int size = clarinet_socket_poll_context_calcsize(count);
+    check(size, "clarinet_socket_poll_context_calcsize");
+    std::vector<uint8_t> context((size_t)size);
+
+    std::vector<uint64_t> samples;
+    samples.reserve(opts.iterations);
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < opts.iterations && elapsed(start) < opts.duration; ++i)
+    {
+        const size_t k = (i * STRIDE) % count;
+        const auto t0 = bench_clock::now();
+        f.ping(k);
+
+        uint16_t status = CLARINET_POLL_NONE;
+        while (!(status & CLARINET_POLL_RECV))
+        {
+            check(clarinet_socket_poll(context.data(), targets.data(), count, 100), "clarinet_socket_poll");
+
+            // Finding the ready socket is part of the cost of this API.
+            for (size_t j = 0; j < count; ++j)
+            {
+                uint16_t s;
+                check(clarinet_socket_poll_context_getstatus(context.data(), j, &s), "getstatus");
+                if (j == k)
+                    status = s;
+            }
+        }
+
+        samples.push_back(elapsed_ns(t0));
+        f.drain(k);
+    }
+
+    record r("poll_scaling");
+    r.field("method", "poll").field("sockets", (uint64_t)count);
+    latency(r, samples).emit(opts);
+}
+
+static
+void
+measure_poller(fixture& f,
+               const options& opts)
+{
+    const size_t count = f.sockets.size();
+    clarinet_poller poller;
+    clarinet_poller_init(&poller);
+    const int errcode = clarinet_poller_open(&poller);
+    if (errcode == CLARINET_ENOTSUP)
+    {
+        record("poll_scaling").field("method", "poller").field("sockets", (uint64_t)count)
+            .field("error", clarinet_error_name(errcode)).emit(opts);
+        return;
+    }
+
+    check(errcode, "clarinet_poller_open");
+    for (size_t i = 0; i < count; ++i)
+        check(clarinet_poller_add(&poller, &f.sockets[i], CLARINET_POLL_RECV, (void*)i), "clarinet_poller_add");
+
+    std::vector<uint64_t> samples;
+    samples.reserve(opts.iterations);
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < opts.iterations && elapsed(start) < opts.duration; ++i)
+    {
+        const size_t k = (i * STRIDE) % count;
+        const auto t0 = bench_clock::now();
+        f.ping(k);
+
+        bool ready = false;
+        while (!ready)
+        {
+            clarinet_poller_event events[16];
+            const int n = clarinet_poller_wait(&poller, events, 16, 100);
+            check(n, "clarinet_poller_wait");
+            for (int j = 0; j < n; ++j)
+                ready = ready || ((size_t)events[j].data == k && (events[j].events & CLARINET_POLL_RECV));
+        }
+
+        samples.push_back(elapsed_ns(t0));
+        f.drain(k);
+    }
+
+    clarinet_poller_close(&poller);
+
+    record r("poll_scaling");
+    r.field("method", "poller").field("sockets", (uint64_t)count);
+    latency(r, samples).emit(opts);
+}
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+
+    for (const size_t count: counts)
+    {
+        // Room for the sender and the descriptors the runtime already holds.
+        if (raise_fd_limit(count + 64) < count + 64)
+        {
+            record("poll_scaling").field("sockets", (uint64_t)count).field("error", "file descriptor limit")
+                .emit(opts);
+            continue;
+        }
+
+        fixture f(count);
+        measure_poll(f, opts);
+        measure_poller(f, opts);
+    }
+
+    return EXIT_SUCCESS;
+}
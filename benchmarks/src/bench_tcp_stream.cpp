@@ -0,0 +1,78 @@
+#include "bench.h"
+
+// Loopback TCP bandwidth: one thread streams fixed size chunks while the main thread receives for the requested
+// duration. Only bytes received within the measurement window are counted.
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const size_t chunks[] = { 1024, 16384, 65536 };
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+
+    for (const size_t chunk: chunks)
+    {
+        clarinet_socket listener;
+        clarinet_endpoint target;
+        open_loopback(&listener, CLARINET_PROTO_TCP, &target);
+        check(clarinet_socket_listen(&listener, 1), "clarinet_socket_listen");
+
+        clarinet_socket client;
+        clarinet_socket_init(&client);
+        check(clarinet_socket_open(&client, CLARINET_AF_INET, CLARINET_PROTO_TCP), "clarinet_socket_open");
+        check(clarinet_socket_connect(&client, &target), "clarinet_socket_connect");
+
+        clarinet_socket server;
+        clarinet_socket_init(&server);
+        clarinet_endpoint remote;
+        check(clarinet_socket_accept(&listener, &server, &remote), "clarinet_socket_accept");
+
+        std::atomic<bool> running(true);
+        std::thread producer([&]
+        {
+            std::vector<uint8_t> buf(chunk, 0);
+            while (running.load(std::memory_order_relaxed))
+            {
+                if (clarinet_socket_send(&client, buf.data(), buf.size()) < 0)
+                    break;
+            }
+
+            clarinet_socket_shutdown(&client, CLARINET_SHUTDOWN_SEND);
+        });
+
+        std::vector<uint8_t> buf(65536);
+        uint64_t bytes = 0;
+        const auto start = bench_clock::now();
+        double seconds = 0;
+        while ((seconds = elapsed(start)) < opts.duration)
+        {
+            const int n = clarinet_socket_recv(&server, buf.data(), buf.size());
+            check(n, "clarinet_socket_recv");
+            bytes += (uint64_t)n;
+        }
+
+        // Drain until the producer shuts down so it is never blocked on a full send buffer.
+        running = false;
+        while (clarinet_socket_recv(&server, buf.data(), buf.size()) > 0)
+            continue;
+
+        producer.join();
+
+        record("tcp_stream")
+            .field("chunk", (uint64_t)chunk)
+            .field("seconds", seconds)
+            .field("bytes", bytes)
+            .field("mbps", (double)(bytes * 8) / seconds / 1e6)
+            .emit(opts);
+
+        clarinet_socket_close(&server);
+        clarinet_socket_close(&client);
+        clarinet_socket_close(&listener);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#include "bench.h"
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+// Loopback UDP packets per second: one thread sends as fast as it can while the main thread receives for the
+// requested duration. Loss is expected once the receiver falls behind so both counts are reported.
+
+static const size_t payloads[] = { 16, 64, 256, 1024, 1400 };
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+
+    for (const size_t payload: payloads)
+    {
+        clarinet_socket receiver;
+        clarinet_endpoint target;
+        open_loopback(&receiver, CLARINET_PROTO_UDP, &target);
+
+        clarinet_socket sender;
+        clarinet_endpoint source;
+        open_loopback(&sender, CLARINET_PROTO_UDP, &source);
+
+        const int32_t nonblock = 1;
+        check(clarinet_socket_setopt(&receiver, CLARINET_SO_NONBLOCK, &nonblock, sizeof(nonblock)), "setopt");
+
+        // Best effort. The system may cap the buffer size.
+        const int32_t rcvbuf = 4 * 1024 * 1024;
+        clarinet_socket_setopt(&receiver, CLARINET_SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        std::atomic<bool> running(true);
+        std::atomic<uint64_t> sent(0);
+
+        const auto start = bench_clock::now();
+        std::thread producer([&]
+        {
+            uint8_t buf[1400] = { 0 };
+            uint64_t n = 0;
+            while (running.load(std::memory_order_relaxed))
+            {
+                if (clarinet_socket_sendto(&sender, buf, payload, &target) > 0)
+                    n++;
+            }
+
+            sent = n;
+        });
+
+        uint8_t buf[2048];
+        uint64_t received = 0;
+        uint64_t calls = 0;
+        double seconds = 0;
+        while (true)
+        {
+            clarinet_endpoint remote;
+            if (clarinet_socket_recvfrom(&receiver, buf, sizeof(buf), &remote) > 0)
+                received++;
+
+            // Reading the clock on every call would dominate small payloads.
+            if ((++calls & 0x3FF) == 0 && (seconds = elapsed(start)) >= opts.duration)
+                break;
+        }
+
+        running = false;
+        producer.join();
+
+        record("udp_pps")
+            .field("payload", (uint64_t)payload)
+            .field("seconds", seconds)
+            .field("sent", sent.load())
+            .field("received", received)
+            .field("pps", (double)received / seconds)
+            .field("mbps", (double)(received * payload * 8) / seconds / 1e6)
+            .emit(opts);
+
+        clarinet_socket_close(&sender);
+        clarinet_socket_close(&receiver);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#include "bench.h"
+
+// Loopback UDP round trip time: the main thread sends a datagram and waits for an echo thread to bounce it back. Each
+// round trip is one sample. The distribution is reported because tail latency matters more than the mean.
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const size_t payloads[] = { 64, 1024 };
+
+int
+main(int argc,
+     char* argv[])
+{
+    const options opts = parse_options(argc, argv);
+
+    for (const size_t payload: payloads)
+    {
+        clarinet_socket echo;
+        clarinet_endpoint target;
+        open_loopback(&echo, CLARINET_PROTO_UDP, &target);
+
+        clarinet_socket client;
+        clarinet_endpoint source;
+        open_loopback(&client, CLARINET_PROTO_UDP, &source);
+
+        // Timeouts let the echo thread notice the end of the run and the client survive a lost datagram.
+        const int32_t timeout = 100;
+        check(clarinet_socket_setopt(&echo, CLARINET_SO_RCVTIMEO, &timeout, sizeof(timeout)), "setopt");
+        check(clarinet_socket_setopt(&client, CLARINET_SO_RCVTIMEO, &timeout, sizeof(timeout)), "setopt");
+
+        std::atomic<bool> running(true);
+        std::thread responder([&]
+        {
+            uint8_t buf[2048];
+            while (running.load(std::memory_order_relaxed))
+            {
+                clarinet_endpoint remote;
+                const int n = clarinet_socket_recvfrom(&echo, buf, sizeof(buf), &remote);
+                if (n > 0)
+                    clarinet_socket_sendto(&echo, buf, (size_t)n, &remote);
+            }
+        });
+
+        std::vector<uint64_t> samples;
+        samples.reserve(opts.iterations);
+        uint64_t lost = 0;
+        uint8_t buf[2048] = { 0 };
+        const auto start = bench_clock::now();
+        while (samples.size() < opts.iterations && elapsed(start) < opts.duration)
+        {
+            const auto t0 = bench_clock::now();
+            check(clarinet_socket_sendto(&client, buf, payload, &target), "clarinet_socket_sendto");
+
+            clarinet_endpoint remote;
+            if (clarinet_socket_recvfrom(&client, buf, sizeof(buf), &remote) > 0)
+                samples.push_back(elapsed_ns(t0));
+            else
+                lost++;
+        }
+
+        running = false;
+        responder.join();
+
+        record r("udp_rtt");
+        r.field("payload", (uint64_t)payload).field("lost", lost);
+        latency(r, samples).emit(opts);
+
+        clarinet_socket_close(&client);
+        clarinet_socket_close(&echo);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -426,6 +426,7 @@ clarinet_proto_description(int proto);
 #define CLARINET_FEATURE_LOG        0x04    /**< Log built-in */
 #define CLARINET_FEATURE_IPV6       0x08    /**< Support for IPv6 */
 #define CLARINET_FEATURE_IPV6DUAL   0x10    /**< Support for IPv6 in dual-stack mode */
+#define CLARINET_FEATURE_URING      0x20    /**< Support for io_uring completion engine */
 
 /* endregion */
 
@@ -927,6 +928,65 @@ clarinet_proto_description(int proto);
  */
 #define CLARINET_SO_ERROR           10
 
+/**
+ * Enable/disable zero-copy transmission. @a optval is @c int32_t. Valid values are limited to 0 (false) and non-zero
+ * (true). Only supported by TCP and UDP sockets.
+ *
+ * @details This option only allows the socket to be used with @c clarinet_socket_sendzc(). Other send functions
+ * always copy data. See @c clarinet_socket_sendzc() for more information.
+ *
+ * @note @b LINUX: Requires kernel 4.14 or later for TCP and 5.0 or later for UDP.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_SO_ZEROCOPY        11
+
+/**
+ * Enable/disable kernel receive timestamps. @a optval is @c int32_t. Valid values are limited to 0 (false) and
+ * non-zero (true). Only supported by UDP sockets.
+ *
+ * @details When enabled, the system records the time each datagram reached the host. Use
+ * @c clarinet_socket_recvfromts() to obtain the timestamp of each datagram received. Other receive functions are not
+ * affected.
+ *
+ * @note @b LINUX: Implemented with SO_TIMESTAMPNS so timestamps have nanosecond resolution.
+ *
+ * @note @b BSD/DARWIN: Implemented with SO_TIMESTAMP so timestamps have microsecond resolution.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_SO_TIMESTAMP       12
+
+/**
+ * Get/set the maximum rate at which the system transmits packets of the socket. @a optval is @c uint64_t in bytes per
+ * second. Must be greater than 0. The value @c UINT64_MAX means no limit which is the default.
+ *
+ * @details Packets of the socket are spaced in time so that the rate is not exceeded regardless of how fast they are
+ * sent by the application. This avoids overflowing the small buffers of switches and routers along the path with
+ * bursts that would otherwise be transmitted at the speed of the local link.
+ *
+ * @note @b LINUX: Implemented with SO_MAX_PACING_RATE. UDP sockets are only paced by the @c fq queueing discipline
+ * (e.g. @c tc qdisc replace dev eth0 root fq) and the option is silently ignored otherwise. Rates of 4GB/s or more
+ * require a 64-bit system.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_SO_MAX_PACING_RATE 13
+
+/**
+ * Enable transmit times. @a optval is @c int32_t. The only valid value to set is non-zero (true) because the option
+ * cannot be disabled once it is enabled. Only supported by UDP sockets.
+ *
+ * @details This option only allows the socket to be used with @c clarinet_socket_sendtoat(). Other send functions
+ * are not affected. See @c clarinet_socket_sendtoat() for more information.
+ *
+ * @note @b LINUX: Implemented with SO_TXTIME using @c CLOCK_MONOTONIC as the reference clock. Requires kernel 4.19 or
+ * later.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_SO_TXTIME          14
+
 /**
  * Enable/Disable Dual Stack on an IPV6 socket. @a optval is @c uint32_t. Valid values are limited to 0 (false) and
  * non-zero (true). Only supported by IPv6 sockets.
@@ -995,7 +1055,7 @@ clarinet_proto_description(int proto);
 /**
  * Enable/disable whether data sent by an application on the local computer (not necessarily by the same socket) in a
  * multicast session will be received by a socket joined to the multicast destination group on the loopback interface.
- * @a optval is @c uint32_t. Valid values are limited to the range [1, 255]. Only supported by UDP sockets.
+ * @a optval is @c uint32_t. Valid values are limited to 0 (false) and non-zero (true). Only supported by UDP sockets.
  *
  * @details A value of true causes multicast data sent by an application on the local computer to be delivered to a
  * listening socket on the loopback interface. A value of false prevents multicast data sent by an application on the
@@ -1011,15 +1071,61 @@ clarinet_proto_description(int proto);
 /**
  * Add the socket to the supplied multicast group on the specified interface. @a optval is @c clarinet_mcast_group.
  * This option is write-only. Only supported by UDP sockets.
+ *
+ * @details A group with a source address only receives datagrams sent by that source (source-specific multicast).
+ * Otherwise datagrams from any source are received. The same group may be joined for several sources. An IPv6 socket
+ * can only join IPv6 groups unless the platform supports IPv4 multicast options on IPv6 sockets (e.g. Linux).
+ *
+ * @note @b UNIX: Requires the protocol independent multicast API of RFC3678 (@c MCAST_JOIN_GROUP).
  */
 #define CLARINET_IP_MCAST_JOIN      107
 
 /**
  * Remove the socket from the supplied multicast group on the specified interface. @a optval is @c clarinet_mcast_group.
  * This option is write-only. Only supported by UDP sockets.
+ *
+ * @details The group, interface and source must be the same used to join.
  */
 #define CLARINET_IP_MCAST_LEAVE     108
 
+/**
+ * Interface used to send outgoing @b multicast packets. @a optval is @c uint32_t with the index of the interface or 0
+ * to let the system choose based on the routing table. This option is write-only. Only supported by UDP sockets.
+ *
+ * @note @b LINUX: Applies to IPv4 multicast packets sent by an IPv6 socket as well.
+ *
+ * @note @b BSD/DARWIN: IPv4 requires @c IP_MULTICAST_IFINDEX otherwise @c CLARINET_ENOTSUP is returned.
+ */
+#define CLARINET_IP_MCAST_IF        109
+
+/**
+ * UDP Generic Segmentation Offload (GSO) segment size. @a optval is @c int32_t. Valid values are limited to the range
+ * [0, 65535]. Only supported by UDP sockets.
+ *
+ * @details When non-zero, every buffer passed to a send function is split by the system into consecutive datagrams of
+ * @a optval bytes, except for the last one which may be shorter. A value of 0 disables segmentation. The segment size
+ * can also be specified on a per call basis with @c clarinet_socket_sendsegments().
+ *
+ * @note @b LINUX: Requires kernel 4.18 or later. A single buffer may not exceed 64 segments nor 64KB.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_UDP_SEGMENT        200
+
+/**
+ * Enable/disable UDP Generic Receive Offload (GRO). @a optval is @c int32_t. Valid values are limited to 0 (false)
+ * and non-zero (true). Only supported by UDP sockets.
+ *
+ * @details When enabled, the system may coalesce consecutive datagrams of the same size from the same source into a
+ * single buffer. Use @c clarinet_socket_recvsegments() to obtain the size of the segments in each buffer received. Other
+ * receive functions still work but datagram boundaries are lost.
+ *
+ * @note @b LINUX: Requires kernel 5.0 or later.
+ *
+ * @note Not supported on other platforms.
+ */
+#define CLARINET_UDP_GRO            201
+
 /* endregion */
 
 /* region Socket Shutdown Flags */
@@ -1307,7 +1413,9 @@ CLARINET_EXTERN const clarinet_addr clarinet_addr_broadcast_ipv4;
  * Multicast group representation.
  *
  * @details This structure is used with either IPv6 or IPv4 multicast addresses and is the data type handled by the
- * @c CLARINET_IP_MCAST_JOIN and @c CLARINET_IP_MCAST_LEAVE socket options.
+ * @c CLARINET_IP_MCAST_JOIN and @c CLARINET_IP_MCAST_LEAVE socket options. For source-specific multicast the source
+ * address must be of the same family as the group address. An unspecified or wildcard source address denotes any
+ * source.
  *
  * @c clarinet_iface_getlist() can be used to retrieve a list of network interfaces and obtain the interface index
  * information required for the @c clarinet_mcast_group::iface member.
@@ -1316,6 +1424,7 @@ struct clarinet_mcast_group
 {
     uint32_t iface;         /**< The index of the local interface on which the multicast group should be joined or dropped. */
     clarinet_addr addr;     /**< The address of the multicast group. This may be either an IPv6 or IPv4 multicast address. */
+    clarinet_addr source;   /**< The address of the only source to receive from or unspecified for any source. */
 };
 
 typedef struct clarinet_mcast_group clarinet_mcast_group;
@@ -1391,10 +1500,13 @@ typedef struct clarinet_endpoint clarinet_endpoint;
 /** Returns true if the address is an IPv4 broadcast address. */
 #define clarinet_addr_is_broadcast_ipv4(addr)     (clarinet_addr_is_ipv4(addr) && ((addr)->as.ipv4.u.dword[0] == 0xFFFFFFFF))
 
-#define clarinet_addr_is_multicast_ipv6(addr) \
-  (clarinet_addr_is_ipv6(addr) \
-&& ((addr)->as.ipv6.u.byte[0] == 0xFF) \
-&& ((addr)->as.ipv6.u.byte[1] == 0x00))
+/** Returns true if the address is an IPv4 multicast address (224.0.0.0/4). */
+#define clarinet_addr_is_multicast_ipv4(addr) \
+  (clarinet_addr_is_ipv4(addr) \
+&& (((addr)->as.ipv4.u.byte[0] & 0xF0) == 0xE0))
+
+/** Returns true if the address is an IPv6 multicast address (ff00::/8). */
+#define clarinet_addr_is_multicast_ipv6(addr)     (clarinet_addr_is_ipv6(addr) && ((addr)->as.ipv6.u.byte[0] == 0xFF))
 
 #define clarinet_addr_is_linklocal_ipv6(addr) \
   (clarinet_addr_is_ipv6(addr) \
@@ -1442,6 +1554,14 @@ typedef struct clarinet_endpoint clarinet_endpoint;
  */
 #define clarinet_addr_is_broadcast_ip(addr)       clarinet_addr_is_broadcast_ipv4(addr)
 
+/**
+ * Returns true if the address pointed by addr represents a multicast address in either IPv4 or IPv6. IPv4 multicast
+ * addresses in IPv4MappedToIPv6 format are not considered multicast because they cannot be joined as such.
+ */
+#define clarinet_addr_is_multicast_ip(addr) \
+  (clarinet_addr_is_multicast_ipv4(addr) \
+|| clarinet_addr_is_multicast_ipv6(addr))
+
 /**
  * Returns true if addresses pointed by a and b are equal.
  * If famlily is CLARINET_AF_INET only the last dword is required to be equal.
@@ -1647,447 +1767,4503 @@ clarinet_make_endpoint(clarinet_addr addr,
 
 /* endregion */
 
-/* region Library Initialization (from this point on all macros and functions require library initialization) */
-
-/**
- * Static initialization. Must be called once before any function that depends on the network subsystem. This is the
- * case for all socket and host info functions. Only library and address functions can be safely called before
- * initialization (unless otherwise noted in the function description).
- */
-CLARINET_EXTERN
-int
-clarinet_initialize(void);
-
-/**
- * Static finalization. Must be called once for any previous calls to clarinet_initialize() that was successful.
- * Multiple calls have no effect. In many platforms this is a no-op but is strictly required on Windows to unload the
- * winsock library and release resources.
- */
-CLARINET_EXTERN
-int
-clarinet_finalize(void);
-
-/* endregion */
-
-/* region Socket */
+/* region Endpoint Table */
 
-#if defined(__unix__)
-#define CLARINET_SOCKET_HANDLE_TYPE     int
-#else
-#define CLARINET_SOCKET_HANDLE_TYPE     void*
-#endif
+#define CLARINET_ENDPOINT_TABLE_NONE            0x00        /**< None */
+#define CLARINET_ENDPOINT_TABLE_EQUIVALENT      0x01        /**< IPv4 mapped to IPv6 endpoints match their IPv4 form */
 
-/**
- * Abstract handle used by the underlying platform to identify a socket. Only valid while the socket is open. May be
- * reused after the socket is closed.
- */
-typedef CLARINET_SOCKET_HANDLE_TYPE clarinet_socket_handle;
+#define CLARINET_ENDPOINT_TABLE_CAPACITY_MAX    0x1000000   /**< Maximum number of entries in a table */
 
-struct clarinet_socket
+struct clarinet_endpoint_table
 {
-    uint16_t family;                /**< Address family (read-only) */
-    clarinet_socket_handle handle;  /**< System handle (read-only) */
+    uint8_t* tags;                  /**< Control byte of every slot (private) */
+    void* slots;                    /**< Keys and values of every slot (private) */
+    size_t mask;                    /**< Number of slots minus one (private) */
+    size_t capacity;                /**< Maximum number of entries (read-only) */
+    size_t count;                   /**< Number of entries (read-only) */
+    size_t tombstones;              /**< Number of slots of removed entries not yet reclaimed (private) */
+    uint64_t seed;                  /**< Hash seed (private) */
+    uint32_t flags;                 /**< Combination of CLARINET_ENDPOINT_TABLE_* flags (read-only) */
 };
 
 /**
- * Socket.
+ * Hash table that maps endpoints to user values.
  *
- * @details Must be initialized using @c clarinet_socket_init() before it can be used. Sockets are not movable.
- * Pointers passed to functions must remain valid for the duration of the requested operation. Take care when using
- * stack allocated handles.
+ * @details Endpoints are compared the same way as @c clarinet_endpoint_is_equal() (or
+ * @c clarinet_endpoint_is_equivalent() with @c CLARINET_ENDPOINT_TABLE_EQUIVALENT) so flowinfo, reserved fields and
+ * padding never affect a lookup. The table uses open addressing over a single memory block supplied by the caller
+ * and never allocates memory. A lookup normally reads one cache line of control bytes and one cache line holding the
+ * key and value. Only IPv4 and IPv6 endpoints can be stored. Must be initialized using
+ * @c clarinet_endpoint_table_init() before it can be used. Tables are not thread-safe.
+ *
+ * @note Tables keyed by remote endpoints are exposed to collision attacks unless the seed is random and kept secret.
  */
-typedef struct clarinet_socket clarinet_socket;
-
-struct clarinet_linger
-{
-    uint16_t enabled;
-    uint16_t seconds;
-};
-
-/** Data structure used to get/set the @c CLARINET_SO_LINGER socket option */
-typedef struct clarinet_linger clarinet_linger;
+typedef struct clarinet_endpoint_table clarinet_endpoint_table;
 
 /**
- * Initialize a sp structure
+ * Calculate a seeded hash of an endpoint.
  *
- * @param [in] sp Socket pointer
+ * @param [in] endpoint Endpoint pointer
+ * @param [in] seed Hash seed
+ * @param [in] flags Combination of @c CLARINET_ENDPOINT_TABLE_* flags
  *
- * @details The memory pointed to by @p sp must have been previously allocated.
+ * @return Hash value. Zero if @p endpoint is NULL.
  *
+ * @details Only the members compared by @c clarinet_endpoint_is_equal() are hashed so equal endpoints always have
+ * equal hashes. With @c CLARINET_ENDPOINT_TABLE_EQUIVALENT an IPv4 mapped to IPv6 endpoint hashes as its IPv4 form.
+ * The hash is stable for the same seed across runs and platforms so it can also be used to shard endpoints.
  */
 CLARINET_EXTERN
-void
-clarinet_socket_init(clarinet_socket* sp);
+uint64_t
+clarinet_endpoint_hash(const clarinet_endpoint* endpoint,
+                       uint64_t seed,
+                       uint32_t flags);
 
-/** 
- * Create a new sp.
+/**
+ * Calculate the size in bytes of the memory block required by an endpoint table.
  *
- * @param [in] sp Socket pointer
- * @param [in] family
- * @param [in] proto
+ * @param [in] capacity Maximum number of entries
  *
- * @return @c CLARINET_ENONE on success or one of the following negative error codes:
- * @return @c CLARINET_EINVAL
- * @return @c CLARINET_EAFNOSUPPORT
- * @return @c CLARINET_EPROTONOSUPPORT
- * @return @c CLARINET_ENETDOWN
- * @return @c CLARINET_ELIBACC
+ * @return @c N > 0 Size in bytes of the memory block that must be passed to @c clarinet_endpoint_table_open().
+ * @return @c CLARINET_EINVAL: @p capacity is 0 or greater than @c CLARINET_ENDPOINT_TABLE_CAPACITY_MAX.
  *
- * @details
+ * @details The load factor is kept at or below 7/8 and each slot takes 33 bytes, so a table of 100k entries takes
+ * about 4.2 MiB.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_open(clarinet_socket* sp,
-                     int family,
-                     int proto);
+clarinet_endpoint_table_calcsize(size_t capacity);
 
-/** 
- * Close the sp.
+/**
+ * Initialize an endpoint table structure.
  *
- * @param [in] sp Socket pointer
+ * @param [in] table Table pointer
  *
- * @return @c CLARINET_ENONE on success
- * @return @c CLARINET_EINVAL
- * @return @c CLARINET_EALREADY
- * @return @c CLARINET_EINTR
- * @return @c CLARINET_ENETDOWN
- * @return @c CLARINET_ELIBACC
+ * @details The memory pointed to by @p table must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_endpoint_table_init(clarinet_endpoint_table* table);
+
+/**
+ * Open an endpoint table.
  *
- * @details On success this function reinitializes the sp structure pointed to by @p sp. Otherwise an error code is
- * returned and the memory is left unmodified. It is then up to the the user to call @c clarinet_socket_init() should
- * the same sp be reused. Therefore it is only safe to call @c clarinet_socket_close() successvely with the same
- * sp if a previous closing attempt did not fail. There might be specific situations on certain platforms in which a
- * sp could be safely closed again after a previously failed attempt but in general, unless explicitly stated
- * otherwise, any closing operation is final and should not be re-tried in case of an error. Trying to close the same
- * sp twice like this may lead to a (reused) file descriptor in another thread being closed unintentionally. This
- * might occur because the system can release the descriptor associated with the sp early in a close operation,
- * freeing it for reuse by another thread. Still the steps that might produce an error, such as flushing data, could
- * occur much later in the closing process and eventually result in an error being returned.
+ * @param [in] table Table pointer
+ * @param [in] buf Memory block used to store the entries. Must remain valid until the table is closed.
+ * @param [in] buflen Size in bytes of the memory block. See @c clarinet_endpoint_table_calcsize().
+ * @param [in] capacity Maximum number of entries
+ * @param [in] seed Hash seed
+ * @param [in] flags Combination of @c CLARINET_ENDPOINT_TABLE_* flags
  *
- * @note Behaviour is undefined if the sp pointed by sp is not initialized.
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or already open, @p buf is NULL, @p capacity is 0 or greater than
+ * @c CLARINET_ENDPOINT_TABLE_CAPACITY_MAX, or @p flags is invalid.
+ * @return @c CLARINET_ENOBUFS: @p buflen is too small for @p capacity entries.
+ */
+CLARINET_EXTERN
+int
+clarinet_endpoint_table_open(clarinet_endpoint_table* restrict table,
+                             void* restrict buf,
+                             size_t buflen,
+                             size_t capacity,
+                             uint64_t seed,
+                             uint32_t flags);
+
+/**
+ * Close an endpoint table.
+ *
+ * @param [in] table Table pointer
  *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open.
+ *
+ * @details The memory block passed to @c clarinet_endpoint_table_open() is not touched and can be freed afterwards.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_close(clarinet_socket* sp);
+clarinet_endpoint_table_close(clarinet_endpoint_table* table);
 
+/**
+ * Remove all entries from an endpoint table.
+ *
+ * @param [in] table Table pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open.
+ */
 CLARINET_EXTERN
 int
-clarinet_socket_bind(clarinet_socket* restrict sp,
-                     const clarinet_endpoint* restrict local);
+clarinet_endpoint_table_clear(clarinet_endpoint_table* table);
 
-/** 
- * Get the local endpoint bound to the sp.
+/**
+ * Insert an entry into an endpoint table.
  *
- * @details This is the local address previously passed to clarinet_socket_bind() or implicitly bound by 
- * clarinet_socket_connect(). This is not necessarily the same address used by a remote peer to send this host a packet 
- * because the local host could be behind a NAT and it may not even match the destination address in a received IP 
- * packet because the host can be bound multiple addresses using a wildcard address.
- *clarinet_socket_bind()
+ * @param [in] table Table pointer
+ * @param [in] key Endpoint used as key
+ * @param [in] value User value associated with the key
  *
  * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open, or @p key is NULL.
+ * @return @c CLARINET_EAFNOSUPPORT: @p key is neither an IPv4 nor an IPv6 endpoint.
+ * @return @c CLARINET_EALREADY: There is already an entry for @p key.
+ * @return @c CLARINET_ENOBUFS: The table is full.
  *
- * @return @c CLARINET_EINVAL: @p sp is NULL
- * @return @c CLARINET_EINVAL: @p local is NULL
- * @return @c CLARINET_EINVAL: The sp pointed to by @p sp is invalid
- * @return @c CLARINET_EINVAL: The sp pointed to by @p sp has not been bound to a local endpoint yet. A sp is
- * only bound to a local endpoint after a successful call to @c clarinet_socket_bind() or @c clarinet_socket_connect().
+ * @details Slots left behind by removed entries are reclaimed in place when they start to lengthen lookups, which
+ * costs a pass over the whole table.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_local_endpoint(clarinet_socket* restrict sp,
-                               clarinet_endpoint* restrict local);
+clarinet_endpoint_table_insert(clarinet_endpoint_table* restrict table,
+                               const clarinet_endpoint* restrict key,
+                               void* value);
 
-/** 
- * Get the remote endpoint connected to the sp.
+/**
+ * Find the value associated with an endpoint.
  *
- * @details For TCP sockets, once clarinet_socket_connect() has been performed, either sp can call
- * clarinet_socket_remote_endpoint() to obtain the address of the peer sp.  On the other hand, UDP sockets are
- * connectionless. Calling clarinet_socket_connect() on a UDP sp merely sets the peer address for outgoing datagrams
- * sent with clarinet_socket_send() or clarinet_socket_recv(). The caller of clarinet_socket_connect(2) can use 
- * clarinet_socket_remote_endpoint() to obtain the peer address that it earlier set for the sp.  However, the peer
- * sp is unaware of this information, and calling clarinet_socket_remote_endpoint() on the peer sp will return
- * no useful information (unless a clarinet_socket_connect() call was also executed on the peer).  Note also that the 
- * receiver of a datagram can obtain the address of the sender when using clarinet_socket_recvfrom().
+ * @param [in] table Table pointer
+ * @param [in] key Endpoint to look up
+ * @param [out] value User value associated with the key
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open, or either @p key or @p value is NULL.
+ * @return @c CLARINET_ENOTFOUND: There is no entry for @p key.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_remote_endpoint(clarinet_socket* restrict sp,
-                                clarinet_endpoint* restrict remote);
+clarinet_endpoint_table_find(const clarinet_endpoint_table* restrict table,
+                             const clarinet_endpoint* restrict key,
+                             void** restrict value);
 
+/**
+ * Remove an entry from an endpoint table.
+ *
+ * @param [in] table Table pointer
+ * @param [in] key Endpoint of the entry to remove
+ * @param [out] value User value that was associated with the key (optional)
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open, or @p key is NULL.
+ * @return @c CLARINET_ENOTFOUND: There is no entry for @p key.
+ */
 CLARINET_EXTERN
 int
-clarinet_socket_send(clarinet_socket* restrict sp,
-                     const void* restrict buf,
-                     size_t buflen);
+clarinet_endpoint_table_remove(clarinet_endpoint_table* restrict table,
+                               const clarinet_endpoint* restrict key,
+                               void** restrict value);
 
+/* endregion */
 
-CLARINET_EXTERN
-int
-clarinet_socket_sendto(clarinet_socket* restrict sp,
-                       const void* restrict buf,
-                       size_t buflen,
-                       const clarinet_endpoint* restrict remote);
+/* region Packet Pool */
 
+#define CLARINET_PACKET_POOL_NONE           0x00    /**< None */
+#define CLARINET_PACKET_POOL_HUGEPAGES      0x01    /**< Back slabs with huge pages when available */
 
-CLARINET_EXTERN
-int
-clarinet_socket_recv(clarinet_socket* restrict sp,
-                     void* restrict buf,
-                     size_t buflen);
+#define CLARINET_PACKET_POOL_ALIGNMENT      64      /**< Alignment in bytes of every slab */
+#define CLARINET_PACKET_CACHE_SIZE          32      /**< Maximum number of slabs held by a packet cache */
 
-CLARINET_EXTERN
-int
-clarinet_socket_recvfrom(clarinet_socket* restrict sp,
-                         void* restrict buf,
-                         size_t buflen,
-                         clarinet_endpoint* restrict remote);
+struct clarinet_packet_pool
+{
+    void* base;                     /**< Mapped memory (private) */
+    size_t size;                    /**< Size in bytes of the mapped memory (private) */
+    uint8_t* slabs;                 /**< Address of the first slab (private) */
+    uint32_t* links;                /**< Free list links, one per slab (private) */
+    size_t slabsize;                /**< Usable size in bytes of every slab (read-only) */
+    size_t stride;                  /**< Distance in bytes between consecutive slabs (private) */
+    uint32_t count;                 /**< Number of slabs (read-only) */
+    uint32_t flags;                 /**< Flags in effect which may differ from the flags requested (read-only) */
+    uint64_t head;                  /**< Head of the free list tagged with a generation counter (private) */
+};
 
 /**
- * Set sp option.
+ * Lock-free pool of fixed-size packet buffers (slabs).
  *
- * @details All sp options have a unique @p optname across all protocols. This is safer than allowing independent
- * numbering under each option level (i.e. protocol layer). The alternative of passing an <i>option level</i> as in @c
- * setsockopt(2) may lead to accidental modifications without warning when the user mistakes the protocol level and the
- * wrong level happens to have an option name with the same value
+ * @details All slabs are mapped at once when the pool is opened so acquiring and releasing a slab never allocates
+ * memory. Any thread may acquire or release a slab so a buffer filled by a network thread can be handed over to a
+ * worker thread which in turn releases it when done. Threads that exchange many slabs should each use a
+ * @c clarinet_packet_cache to amortize the cost of the shared free list. Must be initialized using
+ * @c clarinet_packet_pool_init() before it can be used. Pools are not movable.
  *
- * @param [in] sp Socket pointer
- * @param [in] optname
- * @param [in] optval
- * @param [in] optlen
+ * @note @b LINUX: Huge pages are allocated with @c MAP_HUGETLB and require pages to be reserved in advance (see
+ * /proc/sys/vm/nr_hugepages).
  *
- * @return @c CLARINET_ENONE
- * @return @c CLARINET_EINVAL
+ * @note @b WINDOWS: Huge pages are allocated with @c MEM_LARGE_PAGES and require the SeLockMemoryPrivilege.
+ */
+typedef struct clarinet_packet_pool clarinet_packet_pool;
+
+struct clarinet_packet_cache
+{
+    clarinet_packet_pool* pool;                         /**< Pool the cache draws from (read-only) */
+    uint32_t count;                                     /**< Number of slabs held (read-only) */
+    uint32_t slabs[CLARINET_PACKET_CACHE_SIZE];         /**< Indexes of the slabs held (private) */
+};
+
+/**
+ * Thread-local front-end of a packet pool.
  *
- * @details
+ * @details A cache holds a small number of slabs that can be acquired and released without touching the shared free
+ * list. Slabs are exchanged with the pool in batches when the cache runs empty or full. Caches are not thread-safe and
+ * are meant to be owned by a single thread. A slab acquired from one cache may be released to any other cache of the
+ * same pool (or directly to the pool). Slabs held by a cache are only returned to the pool by
+ * @c clarinet_packet_cache_flush().
+ */
+typedef struct clarinet_packet_cache clarinet_packet_cache;
+
+/**
+ * Initialize a packet pool structure.
  *
- * @note
+ * @param [in] pool Pool pointer
  *
+ * @details The memory pointed to by @p pool must have been previously allocated.
  */
 CLARINET_EXTERN
-int
-clarinet_socket_setopt(clarinet_socket* restrict sp,
-                       int optname,
-                       const void* restrict optval,
-                       size_t optlen);
+void
+clarinet_packet_pool_init(clarinet_packet_pool* pool);
 
 /**
- * Get sp option.
+ * Open a packet pool.
  *
- * @param [in] sp
- * @param [in] optname
- * @param [in, out] optval
+ * @param [in] pool Pool pointer
+ * @param [in] slabsize Size in bytes of each slab. Rounded up to a multiple of @c CLARINET_PACKET_POOL_ALIGNMENT.
+ * @param [in] count Number of slabs.
+ * @param [in] flags Combination of @c CLARINET_PACKET_POOL_* flags.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pool is NULL or already open, @p slabsize is 0 or greater than INT_MAX, @p count is 0
+ * or greater than INT_MAX, or @p flags is invalid.
+ * @return @c CLARINET_ENOMEM: Not enough memory.
+ * @return @c CLARINET_ENOTSUP: Lock-free operations are not supported by the platform.
+ *
+ * @details When @c CLARINET_PACKET_POOL_HUGEPAGES is requested but huge pages are not available the pool falls back
+ * to regular pages and the flag is cleared from the @c flags member of the pool.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_pool_open(clarinet_packet_pool* pool,
+                          size_t slabsize,
+                          uint32_t count,
+                          uint32_t flags);
+
+/**
+ * Close a packet pool.
+ *
+ * @param [in] pool Pool pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pool is NULL or not open.
+ *
+ * @details All slabs are released at once regardless of their owners so no slab (and no cache of this pool) may be
+ * used after the pool is closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_pool_close(clarinet_packet_pool* pool);
+
+/**
+ * Acquire a slab from the shared free list of a packet pool.
+ *
+ * @param [in] pool Pool pointer
+ * @param [out] buf Address of the slab acquired. The slab is @c slabsize bytes long.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pool is NULL or not open, or @p buf is NULL.
+ * @return @c CLARINET_ENOBUFS: There are no free slabs.
+ *
+ * @details Thread-safe.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_pool_acquire(clarinet_packet_pool* restrict pool,
+                             void** restrict buf);
+
+/**
+ * Release a slab to the shared free list of a packet pool.
+ *
+ * @param [in] pool Pool pointer
+ * @param [in] buf Address of a slab previously acquired from the same pool.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pool is NULL or not open, or @p buf is not the address of a slab of the pool.
+ *
+ * @details Thread-safe. Behaviour is undefined if the slab is released more than once.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_pool_release(clarinet_packet_pool* restrict pool,
+                             void* restrict buf);
+
+/**
+ * Initialize a packet cache structure.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] pool Pool pointer
+ *
+ * @details The memory pointed to by @p cache must have been previously allocated. The cache starts empty.
+ */
+CLARINET_EXTERN
+void
+clarinet_packet_cache_init(clarinet_packet_cache* restrict cache,
+                           clarinet_packet_pool* restrict pool);
+
+/**
+ * Acquire a slab from a packet cache.
+ *
+ * @param [in] cache Cache pointer
+ * @param [out] buf Address of the slab acquired. The slab is @c slabsize bytes long.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or its pool is not open, or @p buf is NULL.
+ * @return @c CLARINET_ENOBUFS: There are no free slabs.
+ *
+ * @details When the cache is empty up to half of its capacity is refilled from the pool.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_cache_acquire(clarinet_packet_cache* restrict cache,
+                              void** restrict buf);
+
+/**
+ * Release a slab to a packet cache.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] buf Address of a slab previously acquired from the same pool (through any cache).
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or its pool is not open, or @p buf is not the address of a slab of the
+ * pool.
+ *
+ * @details When the cache is full half of its capacity is returned to the pool with a single atomic operation.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_cache_release(clarinet_packet_cache* restrict cache,
+                              void* restrict buf);
+
+/**
+ * Return all slabs held by a packet cache to its pool.
+ *
+ * @param [in] cache Cache pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or its pool is not open.
+ *
+ * @details Must be called before the thread owning the cache exits otherwise the slabs held are lost until the pool is
+ * closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_packet_cache_flush(clarinet_packet_cache* cache);
+
+/* endregion */
+
+/* region Log */
+
+#define CLARINET_LOG_LEVEL_TRACE            0       /**< Fine-grained tracing of internal operations */
+#define CLARINET_LOG_LEVEL_DEBUG            1       /**< Diagnostics useful while debugging */
+#define CLARINET_LOG_LEVEL_INFO             2       /**< Notable but expected events */
+#define CLARINET_LOG_LEVEL_WARN             3       /**< Unexpected events the library can recover from */
+#define CLARINET_LOG_LEVEL_ERROR            4       /**< Failures */
+#define CLARINET_LOG_LEVEL_NONE             5       /**< Nothing is logged */
+
+#define CLARINET_LOG_ARGS                   4       /**< Number of arguments carried by every record */
+#define CLARINET_LOG_MESSAGE_SIZE           256     /**< Size in bytes of the buffer used to format a record */
+#define CLARINET_LOG_CAPACITY_MAX           65536   /**< Maximum number of records per ring */
+
+#define CLARINET_LOG_EVENTS(E) \
+    E(CLARINET_LOG_EVENT_USER,                0, "%lld %lld %lld %lld") \
+    E(CLARINET_LOG_EVENT_DROPPED,             1, "%lld records dropped") \
+    E(CLARINET_LOG_EVENT_SOCKET_OPEN,        16, "socket %lld opened (family %lld, protocol %lld)") \
+    E(CLARINET_LOG_EVENT_SOCKET_CLOSE,       17, "socket %lld closed") \
+    E(CLARINET_LOG_EVENT_SOCKET_SEND,        18, "socket %lld failed to send (error %lld)") \
+    E(CLARINET_LOG_EVENT_SOCKET_RECV,        19, "socket %lld failed to receive (error %lld)") \
+    E(CLARINET_LOG_EVENT_DTLC_CONNECT,       32, "dtlc connection %lld established") \
+    E(CLARINET_LOG_EVENT_DTLC_DISCONNECT,    33, "dtlc connection %lld terminated (error %lld)") \
+    E(CLARINET_LOG_EVENT_GDTP_RETRANSMIT,    48, "gdtp connection %lld retransmitted message %lld of channel %lld " \
+                                                 "(transmission %lld)") \
+    E(CLARINET_LOG_EVENT_ENET_DISCONNECT,    64, "enet peer %lld timed out") \
+    E(CLARINET_LOG_EVENT_ENET_RETRANSMIT,    65, "enet peer %lld retransmitted a command (transmission %lld)") \
+    E(CLARINET_LOG_EVENT_ENET_UNSUPPORTED,   66, "enet peer %lld sent unsupported command %lld") \
+    E(CLARINET_LOG_EVENT_ENET_COMPRESSED,    67, "enet dropped a compressed datagram for peer id %lld") \
+
+/**
+ * Events that can be recorded by the library. Each event is associated with a format string that receives all
+ * @c CLARINET_LOG_ARGS record arguments as @c long @c long in order.
+ */
+enum clarinet_log_event
+{
+    CLARINET_LOG_EVENTS(CLARINET_DECLARE_ENUM_ITEM)
+};
+
+struct clarinet_log_record
+{
+    uint64_t timestamp;                 /**< Monotonic time in nanoseconds when the record was written (read-only) */
+    int32_t level;                      /**< Log level (@c CLARINET_LOG_LEVEL_*) (read-only) */
+    int32_t event;                      /**< Event code (@c CLARINET_LOG_EVENT_*) (read-only) */
+    int64_t args[CLARINET_LOG_ARGS];    /**< Event arguments (read-only) */
+};
+
+/**
+ * Fixed-size binary log record.
+ *
+ * @details Records are written without any formatting so that writing one costs no more than a clock read and a few
+ * stores. Records are only formatted when drained.
+ */
+typedef struct clarinet_log_record clarinet_log_record;
+
+/**
+ * Function called to deliver a drained record.
+ *
+ * @param [in] context User context passed to @c clarinet_log_setsink().
+ * @param [in] record Record drained.
+ * @param [in] message Null-terminated message produced by @c clarinet_log_format() for @p record.
+ */
+typedef void (*clarinet_log_sink)(void* context,
+                                  const clarinet_log_record* record,
+                                  const char* message);
+
+struct clarinet_log_ring
+{
+    clarinet_log_record* records;   /**< Record storage (private) */
+    uint64_t head;                  /**< Number of records written (private) */
+    uint64_t tail;                  /**< Number of records drained (private) */
+    uint64_t dropped;               /**< Number of records dropped because the ring was full (private) */
+    uint32_t owner;                 /**< Non-zero while the ring is attached to a thread (private) */
+};
+
+/**
+ * Single-producer single-consumer ring of log records.
+ *
+ * @details Each thread that writes a record is attached to a ring of its own on the first write so writers never
+ * contend with each other. A ring is released when its thread calls @c clarinet_log_detach().
+ */
+typedef struct clarinet_log_ring clarinet_log_ring;
+
+struct clarinet_log
+{
+    clarinet_log_ring* rings;       /**< Rings available to writer threads (private) */
+    size_t count;                   /**< Number of rings (read-only) */
+    uint32_t capacity;              /**< Number of records per ring (read-only) */
+    uint32_t epoch;                 /**< Identifies the log among all logs ever opened (private) */
+    int32_t level;                  /**< Minimum level of the records written (read-only) */
+    uint32_t draining;              /**< Non-zero while a thread is draining the log (private) */
+    clarinet_log_sink sink;         /**< Function called for every drained record (private) */
+    void* context;                  /**< User context passed to the sink (private) */
+};
+
+/**
+ * Asynchronous log.
+ *
+ * @details Library functions write fixed-size binary records into per-thread lock-free rings and never format, lock or
+ * allocate. The application drains the rings from a thread of its choice with @c clarinet_log_drain() which formats
+ * every record and passes it to the installed sink. Records from the same thread are drained in order but records from
+ * different threads are not ordered with respect to each other (use the timestamp). Only one log can be open at a time.
+ * Must be initialized using @c clarinet_log_init() before it can be used. Logs are not movable.
+ *
+ * @note Records are only written by library builds with @c CLARINET_FEATURE_LOG.
+ */
+typedef struct clarinet_log clarinet_log;
+
+/**
+ * Initialize a log structure.
+ *
+ * @param [in] log Log pointer
+ *
+ * @details The memory pointed to by @p log must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_log_init(clarinet_log* log);
+
+/**
+ * Open a log and make it the destination of all records written by the library.
+ *
+ * @param [in] log Log pointer
+ * @param [in] rings Array of @p count rings. Must remain valid until the log is closed.
+ * @param [in] count Number of rings which is the maximum number of threads that can write records at the same time.
+ * @param [in] records Array of @p count * @p capacity records. Must remain valid until the log is closed.
+ * @param [in] capacity Number of records per ring. Must be a power of 2 not greater than
+ * @c CLARINET_LOG_CAPACITY_MAX.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p log is NULL or already open, @p rings or @p records is NULL, @p count is 0 or greater
+ * than INT_MAX, or @p capacity is invalid.
+ * @return @c CLARINET_EALREADY: Another log is open.
+ * @return @c CLARINET_ENOTSUP: Log is not supported by the library.
+ *
+ * @details The log starts with level @c CLARINET_LOG_LEVEL_INFO and no sink.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_open(clarinet_log* restrict log,
+                  clarinet_log_ring* restrict rings,
+                  size_t count,
+                  clarinet_log_record* restrict records,
+                  uint32_t capacity);
+
+/**
+ * Close a log.
+ *
+ * @param [in] log Log pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p log is NULL or not open.
+ *
+ * @details Records not yet drained are discarded. No thread may be writing records or draining the log when it is
+ * closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_close(clarinet_log* log);
+
+/**
+ * Install the sink of a log.
+ *
+ * @param [in] log Log pointer
+ * @param [in] sink Function called for every drained record. May be NULL to discard drained records.
+ * @param [in] context User context passed to @p sink.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p log is NULL or not open.
+ *
+ * @details Must not be called while the log is being drained.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_setsink(clarinet_log* log,
+                     clarinet_log_sink sink,
+                     void* context);
+
+/**
+ * Set the minimum level of the records written to a log.
+ *
+ * @param [in] log Log pointer
+ * @param [in] level Log level (@c CLARINET_LOG_LEVEL_*). @c CLARINET_LOG_LEVEL_NONE disables the log.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p log is NULL or not open, or @p level is invalid.
+ *
+ * @details Thread-safe. Records below the level are rejected by writers before a ring is touched.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_setlevel(clarinet_log* log,
+                      int level);
+
+/**
+ * Write a record to the open log.
+ *
+ * @param [in] level Log level (@c CLARINET_LOG_LEVEL_*) other than @c CLARINET_LOG_LEVEL_NONE.
+ * @param [in] event Event code. Applications should use @c CLARINET_LOG_EVENT_USER or codes not used by the library.
+ * @param [in] a First argument.
+ * @param [in] b Second argument.
+ * @param [in] c Third argument.
+ * @param [in] d Fourth argument.
+ *
+ * @return @c CLARINET_ENONE: Success. The record may have been filtered out by the log level.
+ * @return @c CLARINET_EINVAL: @p level is invalid.
+ * @return @c CLARINET_ENOTREADY: No log is open.
+ * @return @c CLARINET_ENOBUFS: The ring of the calling thread is full (the record is counted as dropped and reported by
+ * the next drain) or there are no rings left for the thread.
+ * @return @c CLARINET_ENOTSUP: Log is not supported by the library.
+ *
+ * @details Thread-safe and lock-free. The calling thread is attached to a free ring on its first write.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_write(int level,
+                   int event,
+                   int64_t a,
+                   int64_t b,
+                   int64_t c,
+                   int64_t d);
+
+/**
+ * Release the ring attached to the calling thread.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_ENOTFOUND: The calling thread is not attached to a ring of the open log.
+ * @return @c CLARINET_ENOTSUP: Log is not supported by the library.
+ *
+ * @details Should be called by every thread that wrote records before it exits otherwise the ring remains unavailable
+ * to other threads until the log is closed. Records already written are still drained.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_detach(void);
+
+/**
+ * Drain records from a log.
+ *
+ * @param [in] log Log pointer
+ * @param [in] max Maximum number of records to drain.
+ *
+ * @return Number of records drained (which may be 0) on success or a negative error code on failure.
+ * @return @c CLARINET_EINVAL: @p log is NULL or not open, or @p max is 0 or greater than INT_MAX.
+ * @return @c CLARINET_EINPROGRESS: Another thread is draining the log.
+ * @return @c CLARINET_ENOTSUP: Log is not supported by the library.
+ *
+ * @details Every record drained is formatted and passed to the sink. Records dropped by a ring are reported with a
+ * synthesized @c CLARINET_LOG_EVENT_DROPPED record which also counts towards @p max. Meant to be called periodically
+ * from a background thread so formatting never happens on an I/O thread.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_drain(clarinet_log* log,
+                   size_t max);
+
+/**
+ * Format the message of a log record.
+ *
+ * @param [out] dst Destination buffer. Should be at least @c CLARINET_LOG_MESSAGE_SIZE bytes long.
+ * @param [in] dstlen Size in bytes of @p dst.
+ * @param [in] record Record to format.
+ *
+ * @return Length of the message (excluding the null terminator) on success or a negative error code on failure.
+ * @return @c CLARINET_EINVAL: @p dst or @p record is NULL, or @p dstlen is 0 or greater than INT_MAX.
+ * @return @c CLARINET_ENOBUFS: @p dstlen is not enough for the message which was truncated.
+ *
+ * @details Records of unknown events are formatted with the event code followed by all arguments.
+ */
+CLARINET_EXTERN
+int
+clarinet_log_format(char* restrict dst,
+                    size_t dstlen,
+                    const clarinet_log_record* restrict record);
+
+/* endregion */
+
+/* region Timer Wheel */
+
+#define CLARINET_TIMER_WHEEL_LEVELS         4       /**< Number of levels of a timer wheel */
+#define CLARINET_TIMER_WHEEL_SLOTS          64      /**< Number of slots per level of a timer wheel */
+
+struct clarinet_timer
+{
+    struct clarinet_timer* next;    /**< Next timer in the same slot (private) */
+    struct clarinet_timer** pprev;  /**< Link pointing to this timer or NULL when not scheduled (private) */
+    uint64_t expiry;                /**< Expiry time in milliseconds (read-only) */
+    void* data;                     /**< User data */
+};
+
+/**
+ * Timer that can be scheduled on a timer wheel.
+ *
+ * @details Timers are provided by the caller and are usually embedded in a connection or peer structure so a wheel
+ * never allocates memory. Must be initialized using @c clarinet_timer_init() before it can be used. Timers are not
+ * movable while scheduled.
+ */
+typedef struct clarinet_timer clarinet_timer;
+
+struct clarinet_timer_wheel
+{
+    clarinet_timer* slots[CLARINET_TIMER_WHEEL_LEVELS][CLARINET_TIMER_WHEEL_SLOTS]; /**< Timer lists (private) */
+    uint64_t occupied[CLARINET_TIMER_WHEEL_LEVELS]; /**< Bitmap of the slots that are not empty (private) */
+    clarinet_timer* due;            /**< Expired timers not yet returned (private) */
+    clarinet_timer** due_tail;      /**< Link at the end of the list of expired timers (private) */
+    uint64_t tick;                  /**< Last tick processed (private) */
+    uint32_t resolution;            /**< Milliseconds per tick (read-only) */
+    size_t count;                   /**< Number of timers scheduled or expired but not returned (read-only) */
+};
+
+/**
+ * Hierarchical timing wheel.
+ *
+ * @details Scheduling and cancelling a timer are O(1) regardless of the number of timers. Each level has
+ * @c CLARINET_TIMER_WHEEL_SLOTS slots and every slot of a level spans all the slots of the level below so 4 levels of
+ * 64 slots cover 2^24 ticks. Timers further in the future are parked in the last level and moved down as time
+ * advances. Times are expressed in milliseconds of any monotonic clock (e.g. @c clarinet_time_now()) and rounded up to
+ * a whole tick so a timer never expires early. Timers that expire at the same tick are returned in no particular
+ * order. Must be initialized using @c clarinet_timer_wheel_init() before it can be used. Wheels are not thread-safe
+ * and are not movable.
+ */
+typedef struct clarinet_timer_wheel clarinet_timer_wheel;
+
+/**
+ * Obtain the time of a monotonic clock.
+ *
+ * @return Time in milliseconds since an arbitrary point in the past.
+ *
+ * @details Not affected by changes of the system time.
+ *
+ * @note @b WINDOWS: Based on @c timeGetTime which wraps around every 49.7 days. Wrap arounds are only detected if the
+ * function is called at least once in that period.
+ */
+CLARINET_EXTERN
+uint64_t
+clarinet_time_now(void);
+
+/**
+ * Obtain the time of a monotonic clock in microseconds.
+ *
+ * @return Time in microseconds since an arbitrary point in the past.
+ *
+ * @details Same clock as @c clarinet_time_now() with a higher resolution where available. This is the reference
+ * clock of the transmit times passed to @c clarinet_socket_sendtoat().
+ *
+ * @note @b WINDOWS: Based on @c QueryPerformanceCounter so it is not related to @c clarinet_time_now().
+ */
+CLARINET_EXTERN
+uint64_t
+clarinet_time_now_us(void);
+
+/**
+ * Initialize a timer structure.
+ *
+ * @param [in] timer Timer pointer
+ *
+ * @details The memory pointed to by @p timer must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_timer_init(clarinet_timer* timer);
+
+/** Returns true if the timer pointed to by @p timer is scheduled on a timer wheel. */
+#define clarinet_timer_is_scheduled(timer)  ((timer)->pprev != NULL)
+
+/**
+ * Initialize a timer wheel structure.
+ *
+ * @param [in] wheel Wheel pointer
+ *
+ * @details The memory pointed to by @p wheel must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_timer_wheel_init(clarinet_timer_wheel* wheel);
+
+/**
+ * Open a timer wheel.
+ *
+ * @param [in] wheel Wheel pointer
+ * @param [in] resolution Milliseconds per tick. Must be greater than 0.
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p wheel is NULL or already open, or @p resolution is 0.
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_wheel_open(clarinet_timer_wheel* wheel,
+                          uint32_t resolution,
+                          uint64_t now);
+
+/**
+ * Close a timer wheel.
+ *
+ * @param [in] wheel Wheel pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p wheel is NULL or not open.
+ *
+ * @details All timers still scheduled are cancelled.
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_wheel_close(clarinet_timer_wheel* wheel);
+
+/**
+ * Schedule a timer.
+ *
+ * @param [in] wheel Wheel pointer
+ * @param [in] timer Timer pointer
+ * @param [in] expiry Expiry time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p wheel is NULL or not open, or @p timer is NULL.
+ *
+ * @details A timer that is already scheduled is rescheduled. It must not be scheduled on another wheel. A timer with an
+ * expiry time in the past is returned by the next call to @c clarinet_timer_wheel_advance().
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_schedule(clarinet_timer_wheel* restrict wheel,
+                        clarinet_timer* restrict timer,
+                        uint64_t expiry);
+
+/**
+ * Cancel a timer.
+ *
+ * @param [in] wheel Wheel pointer
+ * @param [in] timer Timer pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p wheel is NULL or not open, or @p timer is NULL.
+ * @return @c CLARINET_ENOTFOUND: @p timer is not scheduled.
+ *
+ * @details The timer must not be scheduled on another wheel.
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_cancel(clarinet_timer_wheel* restrict wheel,
+                      clarinet_timer* restrict timer);
+
+/**
+ * Advance a timer wheel and collect expired timers.
+ *
+ * @param [in] wheel Wheel pointer
+ * @param [in] now Current time in milliseconds.
+ * @param [out] expired Array of timers that expired.
+ * @param [in] count Number of elements in @p expired.
+ *
+ * @return Number of timers stored in @p expired (which may be 0) on success or a negative error code on failure.
+ * @return @c CLARINET_EINVAL: @p wheel is NULL or not open, @p expired is NULL, or @p count is 0 or greater than
+ * INT_MAX.
+ *
+ * @details Expired timers are no longer scheduled and may be rescheduled right away. When more than @p count timers
+ * expire the remaining ones are returned by the next call. Intervals without timers are skipped so the cost depends on
+ * the number of timers that expire or move between levels and not on the time elapsed. Going back in time is ignored.
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_wheel_advance(clarinet_timer_wheel* restrict wheel,
+                             uint64_t now,
+                             clarinet_timer** restrict expired,
+                             size_t count);
+
+/**
+ * Calculate how long an event loop may wait before the timer wheel must be advanced.
+ *
+ * @param [in] wheel Wheel pointer
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return Number of milliseconds suitable as the timeout of @c clarinet_poller_wait() or @c clarinet_socket_poll().
+ * @return 0 if there are expired timers not yet returned.
+ * @return -1 if there are no timers scheduled (or @p wheel is NULL or not open).
+ *
+ * @details The timeout never extends past the next expiry. It may be shorter when timers scheduled far in the future
+ * have to move down a level first in which case advancing the wheel returns no timers and the next timeout is exact.
+ */
+CLARINET_EXTERN
+int
+clarinet_timer_wheel_timeout(const clarinet_timer_wheel* wheel,
+                             uint64_t now);
+
+/* endregion */
+
+/* region Congestion Control */
+
+#define CLARINET_CC_STATE_SIZE              32      /**< Number of 64-bit words of state reserved for an algorithm */
+
+struct clarinet_cc;
+
+struct clarinet_cc_algorithm
+{
+    const char* name;   /**< Short name of the algorithm */
+
+    /** Called when the controller is opened. Sets the initial congestion window and resets the state. Optional. */
+    void (*on_init)(struct clarinet_cc* cc,
+                    uint64_t now);
+
+    /** Called when @p bytes previously sent are acknowledged. */
+    void (*on_ack)(struct clarinet_cc* cc,
+                   size_t bytes,
+                   uint64_t now);
+
+    /** Called when @p bytes previously sent are declared lost. */
+    void (*on_loss)(struct clarinet_cc* cc,
+                    size_t bytes,
+                    uint64_t now);
+
+    /** Called with a new round-trip time sample in microseconds after the common estimates have been updated. */
+    void (*on_rtt_sample)(struct clarinet_cc* cc,
+                          uint32_t rtt,
+                          uint64_t now);
+
+    /** Returns the rate in bytes per second at which packets should be sent or 0 to disable pacing. */
+    uint64_t (*pacing_rate)(const struct clarinet_cc* cc);
+};
+
+/**
+ * Congestion control algorithm.
+ *
+ * @details An algorithm is a table of callbacks invoked by a congestion controller. Callbacks are free to change the
+ * congestion window and may keep their state in the private state of the controller or, for user-defined algorithms
+ * that need more space, in memory pointed to by the user data of the controller.
+ */
+typedef struct clarinet_cc_algorithm clarinet_cc_algorithm;
+
+struct clarinet_cc
+{
+    const clarinet_cc_algorithm* algorithm; /**< Algorithm or NULL when not open (read-only) */
+    void* data;                     /**< User data */
+    uint64_t cwnd;                  /**< Congestion window in bytes (read-only) */
+    uint64_t inflight;              /**< Bytes sent but neither acknowledged nor declared lost (read-only) */
+    uint64_t delivered;             /**< Total bytes acknowledged (read-only) */
+    uint64_t lost;                  /**< Total bytes declared lost (read-only) */
+    uint64_t pacing_rate;           /**< Pacing rate in bytes per second or 0 if not paced (read-only) */
+    uint64_t next_send;             /**< Earliest time in microseconds the next packet may be sent (read-only) */
+    uint32_t srtt;                  /**< Smoothed round-trip time in microseconds or 0 if unknown (read-only) */
+    uint32_t min_rtt;               /**< Minimum round-trip time in microseconds or 0 if unknown (read-only) */
+    uint32_t mss;                   /**< Maximum segment size in bytes (read-only) */
+    uint64_t state[CLARINET_CC_STATE_SIZE]; /**< Algorithm state (private) */
+};
+
+/**
+ * Congestion controller.
+ *
+ * @details A congestion controller decides how many bytes may be in flight (the congestion window) and how fast they
+ * may be sent (the pacing rate) based on the acknowledgements, losses and round-trip time samples reported by a
+ * reliable protocol. It does not send anything on its own. Every packet subject to congestion control must be reported
+ * with @c clarinet_cc_on_send() and later with either @c clarinet_cc_on_ack() or @c clarinet_cc_on_loss(). Traffic
+ * that must not wait for bulk transfers (e.g. gameplay updates) should simply bypass the controller. Times are
+ * expressed in microseconds of any monotonic clock. Must be initialized using @c clarinet_cc_init() before it can be
+ * used. Controllers are not thread-safe.
+ */
+typedef struct clarinet_cc clarinet_cc;
+
+/**
+ * Obtain a BBR-like congestion control algorithm.
+ *
+ * @return Algorithm pointer
+ *
+ * @details A model-based algorithm that estimates the bottleneck bandwidth as the maximum delivery rate of the last 10
+ * rounds and the propagation delay as the minimum round-trip time of the last 10 seconds. Packets are paced at the
+ * estimated bandwidth with a short probing phase every 8 rounds so a bulk transfer saturates the link while keeping
+ * the bottleneck queue (and therefore the latency of any other traffic through it) close to empty. Random losses are
+ * ignored but a loss rate above 2% while probing caps the amount of data in flight so shallow buffers are not flooded.
+ */
+CLARINET_EXTERN
+const clarinet_cc_algorithm*
+clarinet_cc_bbr(void);
+
+/**
+ * Obtain a CUBIC congestion control algorithm.
+ *
+ * @return Algorithm pointer
+ *
+ * @details A loss-based algorithm that grows the congestion window along a cubic function of the time since the last
+ * reduction and never slower than NewReno would. The window is reduced by 30% at most once per round-trip time when
+ * packets are lost. A conservative alternative for paths that are shared with other loss-based flows. Tends to fill
+ * the bottleneck queue.
+ */
+CLARINET_EXTERN
+const clarinet_cc_algorithm*
+clarinet_cc_cubic(void);
+
+/**
+ * Initialize a congestion controller structure.
+ *
+ * @param [in] cc Controller pointer
+ *
+ * @details The memory pointed to by @p cc must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_cc_init(clarinet_cc* cc);
+
+/**
+ * Open a congestion controller.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] algorithm Algorithm pointer (e.g. @c clarinet_cc_bbr())
+ * @param [in] mss Maximum segment size in bytes. Must be greater than 0.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or already open, @p algorithm is NULL or lacks a mandatory callback, or
+ * @p mss is 0.
+ *
+ * @details The initial congestion window is 10 segments unless changed by the algorithm.
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_open(clarinet_cc* restrict cc,
+                 const clarinet_cc_algorithm* restrict algorithm,
+                 uint32_t mss,
+                 uint64_t now);
+
+/**
+ * Close a congestion controller.
+ *
+ * @param [in] cc Controller pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_close(clarinet_cc* cc);
+
+/**
+ * Check whether a packet may be sent.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] bytes Size of the packet in bytes.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open.
+ * @return @c CLARINET_EAGAIN: The packet does not fit in the congestion window or the pacing rate does not allow a
+ * packet to be sent before @c next_send.
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_can_send(const clarinet_cc* cc,
+                     size_t bytes,
+                     uint64_t now);
+
+/**
+ * Report that a packet was sent.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] bytes Size of the packet in bytes.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open.
+ *
+ * @details Updates the bytes in flight and the earliest time the next packet may be sent according to the pacing rate.
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_on_send(clarinet_cc* cc,
+                    size_t bytes,
+                    uint64_t now);
+
+/**
+ * Report that bytes previously sent were acknowledged.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] bytes Number of bytes acknowledged.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open.
+ *
+ * @details The round-trip time sample of the acknowledgement, if any, should be reported first with
+ * @c clarinet_cc_on_rtt_sample().
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_on_ack(clarinet_cc* cc,
+                   size_t bytes,
+                   uint64_t now);
+
+/**
+ * Report that bytes previously sent were lost.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] bytes Number of bytes lost.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open.
+ *
+ * @details Bytes retransmitted afterwards must be reported again with @c clarinet_cc_on_send().
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_on_loss(clarinet_cc* cc,
+                    size_t bytes,
+                    uint64_t now);
+
+/**
+ * Report a round-trip time sample.
+ *
+ * @param [in] cc Controller pointer
+ * @param [in] rtt Round-trip time in microseconds. Must be greater than 0.
+ * @param [in] now Current time in microseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cc is NULL or not open, or @p rtt is 0.
+ *
+ * @details Samples should only be taken from packets that were not retransmitted. The smoothed round-trip time is
+ * updated as in RFC 6298.
+ */
+CLARINET_EXTERN
+int
+clarinet_cc_on_rtt_sample(clarinet_cc* cc,
+                          uint32_t rtt,
+                          uint64_t now);
+
+/* endregion */
+
+/* region Library Initialization (from this point on all macros and functions require library initialization) */
+
+/**
+ * Static initialization. Must be called once before any function that depends on the network subsystem. This is the
+ * case for all socket and host info functions. Only library and address functions can be safely called before
+ * initialization (unless otherwise noted in the function description).
+ */
+CLARINET_EXTERN
+int
+clarinet_initialize(void);
+
+/**
+ * Static finalization. Must be called once for any previous calls to clarinet_initialize() that was successful.
+ * Multiple calls have no effect. In many platforms this is a no-op but is strictly required on Windows to unload the
+ * winsock library and release resources.
+ */
+CLARINET_EXTERN
+int
+clarinet_finalize(void);
+
+/* endregion */
+
+/* region Socket */
+
+#if defined(__unix__)
+#define CLARINET_SOCKET_HANDLE_TYPE     int
+#else
+#define CLARINET_SOCKET_HANDLE_TYPE     void*
+#endif
+
+/**
+ * Abstract handle used by the underlying platform to identify a socket. Only valid while the socket is open. May be
+ * reused after the socket is closed.
+ */
+typedef CLARINET_SOCKET_HANDLE_TYPE clarinet_socket_handle;
+
+struct clarinet_socket
+{
+    uint16_t family;                /**< Address family (read-only) */
+    clarinet_socket_handle handle;  /**< System handle (read-only) */
+    struct clarinet_socket_stats* stats; /**< I/O counters attached by clarinet_socket_setstats() (private) */
+};
+
+/**
+ * Socket.
+ *
+ * @details Must be initialized using @c clarinet_socket_init() before it can be used. Sockets are not movable.
+ * Pointers passed to functions must remain valid for the duration of the requested operation. Take care when using
+ * stack allocated handles.
+ */
+typedef struct clarinet_socket clarinet_socket;
+
+struct clarinet_linger
+{
+    uint16_t enabled;
+    uint16_t seconds;
+};
+
+/** Data structure used to get/set the @c CLARINET_SO_LINGER socket option */
+typedef struct clarinet_linger clarinet_linger;
+
+/**
+ * Initialize a sp structure
+ *
+ * @param [in] sp Socket pointer
+ *
+ * @details The memory pointed to by @p sp must have been previously allocated.
+ *
+ */
+CLARINET_EXTERN
+void
+clarinet_socket_init(clarinet_socket* sp);
+
+/** 
+ * Create a new sp.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] family
+ * @param [in] proto
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EAFNOSUPPORT
+ * @return @c CLARINET_EPROTONOSUPPORT
+ * @return @c CLARINET_ENETDOWN
+ * @return @c CLARINET_ELIBACC
+ *
+ * @details
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_open(clarinet_socket* sp,
+                     int family,
+                     int proto);
+
+/** 
+ * Close the sp.
+ *
+ * @param [in] sp Socket pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EALREADY
+ * @return @c CLARINET_EINTR
+ * @return @c CLARINET_ENETDOWN
+ * @return @c CLARINET_ELIBACC
+ *
+ * @details On success this function reinitializes the sp structure pointed to by @p sp. Otherwise an error code is
+ * returned and the memory is left unmodified. It is then up to the the user to call @c clarinet_socket_init() should
+ * the same sp be reused. Therefore it is only safe to call @c clarinet_socket_close() successvely with the same
+ * sp if a previous closing attempt did not fail. There might be specific situations on certain platforms in which a
+ * sp could be safely closed again after a previously failed attempt but in general, unless explicitly stated
+ * otherwise, any closing operation is final and should not be re-tried in case of an error. Trying to close the same
+ * sp twice like this may lead to a (reused) file descriptor in another thread being closed unintentionally. This
+ * might occur because the system can release the descriptor associated with the sp early in a close operation,
+ * freeing it for reuse by another thread. Still the steps that might produce an error, such as flushing data, could
+ * occur much later in the closing process and eventually result in an error being returned.
+ *
+ * @note Behaviour is undefined if the sp pointed by sp is not initialized.
+ *
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_close(clarinet_socket* sp);
+
+CLARINET_EXTERN
+int
+clarinet_socket_bind(clarinet_socket* restrict sp,
+                     const clarinet_endpoint* restrict local);
+
+/** 
+ * Get the local endpoint bound to the sp.
+ *
+ * @details This is the local address previously passed to clarinet_socket_bind() or implicitly bound by 
+ * clarinet_socket_connect(). This is not necessarily the same address used by a remote peer to send this host a packet 
+ * because the local host could be behind a NAT and it may not even match the destination address in a received IP 
+ * packet because the host can be bound multiple addresses using a wildcard address.
+ *clarinet_socket_bind()
+ *
+ * @return @c CLARINET_ENONE: Success
+ *
+ * @return @c CLARINET_EINVAL: @p sp is NULL
+ * @return @c CLARINET_EINVAL: @p local is NULL
+ * @return @c CLARINET_EINVAL: The sp pointed to by @p sp is invalid
+ * @return @c CLARINET_EINVAL: The sp pointed to by @p sp has not been bound to a local endpoint yet. A sp is
+ * only bound to a local endpoint after a successful call to @c clarinet_socket_bind() or @c clarinet_socket_connect().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_local_endpoint(clarinet_socket* restrict sp,
+                               clarinet_endpoint* restrict local);
+
+/** 
+ * Get the remote endpoint connected to the sp.
+ *
+ * @details For TCP sockets, once clarinet_socket_connect() has been performed, either sp can call
+ * clarinet_socket_remote_endpoint() to obtain the address of the peer sp.  On the other hand, UDP sockets are
+ * connectionless. Calling clarinet_socket_connect() on a UDP sp merely sets the peer address for outgoing datagrams
+ * sent with clarinet_socket_send() or clarinet_socket_recv(). The caller of clarinet_socket_connect(2) can use 
+ * clarinet_socket_remote_endpoint() to obtain the peer address that it earlier set for the sp.  However, the peer
+ * sp is unaware of this information, and calling clarinet_socket_remote_endpoint() on the peer sp will return
+ * no useful information (unless a clarinet_socket_connect() call was also executed on the peer).  Note also that the 
+ * receiver of a datagram can obtain the address of the sender when using clarinet_socket_recvfrom().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_remote_endpoint(clarinet_socket* restrict sp,
+                                clarinet_endpoint* restrict remote);
+
+CLARINET_EXTERN
+int
+clarinet_socket_send(clarinet_socket* restrict sp,
+                     const void* restrict buf,
+                     size_t buflen);
+
+
+CLARINET_EXTERN
+int
+clarinet_socket_sendto(clarinet_socket* restrict sp,
+                       const void* restrict buf,
+                       size_t buflen,
+                       const clarinet_endpoint* restrict remote);
+
+
+CLARINET_EXTERN
+int
+clarinet_socket_recv(clarinet_socket* restrict sp,
+                     void* restrict buf,
+                     size_t buflen);
+
+CLARINET_EXTERN
+int
+clarinet_socket_recvfrom(clarinet_socket* restrict sp,
+                         void* restrict buf,
+                         size_t buflen,
+                         clarinet_endpoint* restrict remote);
+
+/**
+ * Receive a datagram and the time it reached the host.
+ *
+ * @param [in] sp Socket pointer
+ * @param [out] buf Buffer to store the data received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [out] timestamp Time the datagram was received by the system in nanoseconds since the Unix epoch.
+ * @param [out] remote Source endpoint
+ *
+ * @return @c N >= 0 Number of bytes received.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: Receive timestamps are not supported by the platform.
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom().
+ *
+ * @details Timestamps are only recorded if @c CLARINET_SO_TIMESTAMP is enabled, otherwise this function behaves
+ * exactly like @c clarinet_socket_recvfrom() and @p timestamp is set to zero. Timestamps are taken from the system
+ * real-time clock so they are not monotonic and can only be compared with the current time of the same clock (e.g.
+ * obtained with @c clock_gettime(CLOCK_REALTIME) or @c timespec_get()). The difference between the current time and
+ * the timestamp of a datagram is how long it waited in the socket buffer.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for a valid socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_recvfromts(clarinet_socket* restrict sp,
+                           void* restrict buf,
+                           size_t buflen,
+                           uint64_t* restrict timestamp,
+                           clarinet_endpoint* restrict remote);
+
+/** Maximum number of buffers accepted by a single scatter/gather operation. */
+#define CLARINET_IOVEC_MAX  64
+
+struct clarinet_iovec
+{
+    void* base;                     /**< Buffer address */
+    size_t len;                     /**< Size in bytes of the memory pointed to by @c base */
+};
+
+/**
+ * Data structure used to describe one of the buffers in a scatter/gather operation.
+ *
+ * @note Not binary compatible with @c struct iovec nor @c WSABUF. Buffers are translated into the platform
+ * representation on every call.
+ */
+typedef struct clarinet_iovec clarinet_iovec;
+
+/**
+ * Send data gathered from multiple buffers on a connected socket.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] iov Array of buffers to send in order. Buffers of zero length are allowed.
+ * @param [in] iovcnt Number of elements in the @p iov array. Must not exceed @c CLARINET_IOVEC_MAX.
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL: @p sp is NULL, @p iov is NULL, @p iovcnt is 0 or greater than @c CLARINET_IOVEC_MAX,
+ * a buffer of non-zero length is NULL or the total length of all buffers is greater than INT_MAX.
+ * @return Any error code that could be returned by @c clarinet_socket_send().
+ *
+ * @details For datagram sockets all buffers are sent as a single datagram. Unlike @c clarinet_socket_send() this
+ * function returns the number of bytes sent which for stream sockets may be less than the total length of all buffers.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt);
+
+/**
+ * Send data gathered from multiple buffers to a specific destination.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] iov Array of buffers to send in order. Buffers of zero length are allowed.
+ * @param [in] iovcnt Number of elements in the @p iov array. Must not exceed @c CLARINET_IOVEC_MAX.
+ * @param [in] remote Destination endpoint
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_sendto().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendtov(clarinet_socket* restrict sp,
+                        const clarinet_iovec* restrict iov,
+                        size_t iovcnt,
+                        const clarinet_endpoint* restrict remote);
+
+/**
+ * Receive data scattered into multiple buffers.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] iov Array of buffers to fill in order.
+ * @param [in] iovcnt Number of elements in the @p iov array. Must not exceed @c CLARINET_IOVEC_MAX.
+ *
+ * @return @c N >= 0 Number of bytes received.
+ * @return @c CLARINET_EINVAL: @p sp is NULL, @p iov is NULL, @p iovcnt is 0 or greater than @c CLARINET_IOVEC_MAX,
+ * a buffer of non-zero length is NULL or the total length of all buffers is 0 or greater than INT_MAX.
+ * @return @c CLARINET_EMSGSIZE: The datagram received was larger than the total length of all buffers and has been
+ * truncated.
+ * @return Any error code that could be returned by @c clarinet_socket_recv().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_recvv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt);
+
+/**
+ * Receive data scattered into multiple buffers and the source endpoint.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] iov Array of buffers to fill in order.
+ * @param [in] iovcnt Number of elements in the @p iov array. Must not exceed @c CLARINET_IOVEC_MAX.
+ * @param [out] remote Source endpoint
+ *
+ * @return @c N >= 0 Number of bytes received.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EMSGSIZE: The datagram received was larger than the total length of all buffers and has been
+ * truncated. The source endpoint is still stored in @p remote.
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_recvfromv(clarinet_socket* restrict sp,
+                          const clarinet_iovec* restrict iov,
+                          size_t iovcnt,
+                          clarinet_endpoint* restrict remote);
+
+/**
+ * Send a datagram to be transmitted at a specific time.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] buf Buffer containing the data to send
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [in] remote Destination endpoint
+ * @param [in] txtime Earliest time the datagram may be transmitted in microseconds of @c clarinet_time_now_us().
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL: Invalid argument or @c CLARINET_SO_TXTIME is not enabled.
+ * @return @c CLARINET_ENOTSUP: Transmit times are not supported by the platform.
+ * @return Any error code that could be returned by @c clarinet_socket_sendto().
+ *
+ * @details The datagram is queued immediately and the function returns without waiting so a whole burst can be
+ * handed to the system at once with increasing transmit times to be spaced out by the system without any user-space
+ * timer. Transmit times in the past are sent as soon as possible. Requires @c CLARINET_SO_TXTIME to be enabled. See
+ * @c clarinet_pacer for a portable alternative.
+ *
+ * @note @b LINUX: Implemented with SCM_TXTIME. Transmit times are only honoured by the @c fq and @c etf queueing
+ * disciplines and are silently ignored by others in which case the datagram is sent immediately. The @c fq queueing
+ * discipline drops datagrams with transmit times beyond its horizon (10 seconds by default).
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendtoat(clarinet_socket* restrict sp,
+                         const void* restrict buf,
+                         size_t buflen,
+                         const clarinet_endpoint* restrict remote,
+                         uint64_t txtime);
+
+/**
+ * Send a buffer as multiple datagrams of the same size with a single call.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] buf Buffer containing all segments back to back
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [in] segsize Size in bytes of each datagram. The last datagram may be shorter.
+ * @param [in] remote Destination endpoint
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: Segmentation offload is not supported by the platform.
+ * @return Any error code that could be returned by @c clarinet_socket_sendto().
+ *
+ * @details This is equivalent to setting @c CLARINET_UDP_SEGMENT for a single send operation. The whole buffer
+ * traverses the network stack once and is only split into datagrams at the lowest possible layer (ideally by the
+ * network device) which greatly reduces the cost of sending a burst of datagrams to the same destination.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for a valid socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendsegments(clarinet_socket* restrict sp,
+                             const void* restrict buf,
+                             size_t buflen,
+                             size_t segsize,
+                             const clarinet_endpoint* restrict remote);
+
+/**
+ * Receive a buffer that may contain multiple datagrams of the same size coalesced by the system.
+ *
+ * @param [in] sp Socket pointer
+ * @param [out] buf Buffer to store the data received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [out] segsize Size in bytes of each datagram in the buffer. The last datagram may be shorter.
+ * @param [out] remote Source endpoint
+ *
+ * @return @c N >= 0 Number of bytes received.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: Receive offload is not supported by the platform.
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom().
+ *
+ * @details Datagrams are only coalesced if @c CLARINET_UDP_GRO is enabled, otherwise this function behaves exactly
+ * like @c clarinet_socket_recvfrom() and @p segsize is set to the number of bytes received. The buffer should be large
+ * enough to hold a coalesced buffer (64KB) or datagrams may be reported truncated with @c CLARINET_EMSGSIZE.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for a valid socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_recvsegments(clarinet_socket* restrict sp,
+                             void* restrict buf,
+                             size_t buflen,
+                             size_t* restrict segsize,
+                             clarinet_endpoint* restrict remote);
+
+/**
+ * Minimum size in bytes of a buffer to be sent without copying by @c clarinet_socket_sendzc(). Smaller buffers are
+ * copied because pinning pages and processing the completion notification costs more than the copy itself.
+ */
+#define CLARINET_ZEROCOPY_THRESHOLD     16384
+
+struct clarinet_zerocopy_range
+{
+    uint32_t first;                 /**< Identifier of the first zero-copy send completed */
+    uint32_t last;                  /**< Identifier of the last zero-copy send completed (inclusive) */
+    uint32_t copied;                /**< Non-zero if the system had to copy the data after all */
+};
+
+/** Data structure used to report a contiguous range of zero-copy sends whose buffers can be reused. */
+typedef struct clarinet_zerocopy_range clarinet_zerocopy_range;
+
+/**
+ * Send a buffer without copying its contents to the system.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] buf Buffer with the data to send
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [in] remote Destination endpoint or NULL if the socket is connected.
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: Zero-copy transmission is not supported by the platform.
+ * @return @c CLARINET_ENOBUFS: The socket has reached its limit of pages pinned. Reap completions and try again.
+ * @return Any error code that could be returned by @c clarinet_socket_send() or @c clarinet_socket_sendto().
+ *
+ * @details The system keeps a reference to the pages of @p buf instead of copying them so the buffer must not be
+ * modified nor released until a completion for the send is reaped by @c clarinet_socket_zerocopy_reap(). Each
+ * successful call with @p buflen of at least @c CLARINET_ZEROCOPY_THRESHOLD bytes is assigned a sequential identifier
+ * starting at 0 (wrapping around at UINT32_MAX) in the order the calls were made. Calls with smaller buffers copy data
+ * as usual so their buffers can be reused immediately and they are not assigned an identifier. The socket must have
+ * @c CLARINET_SO_ZEROCOPY enabled.
+ *
+ * @note Zero-copy is generally only effective for large TCP transfers or UDP datagrams sent with segmentation offload
+ * (@c CLARINET_UDP_SEGMENT). Data sent to a loopback destination is always copied.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendzc(clarinet_socket* restrict sp,
+                       const void* restrict buf,
+                       size_t buflen,
+                       const clarinet_endpoint* restrict remote);
+
+/**
+ * Reap completion notifications of zero-copy sends.
+ *
+ * @param [in] sp Socket pointer
+ * @param [out] ranges Array to store the ranges of identifiers completed.
+ * @param [in] count Number of elements in the @p ranges array.
+ *
+ * @return @c N >= 0 Number of ranges stored in @p ranges. Zero indicates there are no notifications pending.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: Zero-copy transmission is not supported by the platform.
+ *
+ * @details This function never blocks. Pending notifications are signaled by @c CLARINET_POLL_ERROR so a socket can
+ * be polled for completions. Buffers of every send in a range reported can be reused. Notifications are queued
+ * together with other asynchronous errors (e.g. ICMP errors when enabled) which are discarded.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_zerocopy_reap(clarinet_socket* restrict sp,
+                              clarinet_zerocopy_range* restrict ranges,
+                              size_t count);
+
+/** Maximum number of messages transferred per system call by batch operations when natively supported. */
+#define CLARINET_SOCKET_MESSAGE_BATCH_SIZE  64
+
+struct clarinet_socket_message
+{
+    void* buf;                      /**< Message buffer */
+    size_t buflen;                  /**< Size in bytes of the memory pointed to by @c buf */
+    clarinet_endpoint remote;       /**< Destination endpoint when sending or source endpoint when receiving */
+    int result;                     /**< Number of bytes transferred or a negative error code (output) */
+};
+
+/** Data structure used to describe a single datagram in a batch operation. */
+typedef struct clarinet_socket_message clarinet_socket_message;
+
+/**
+ * Send multiple datagrams with a single call.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in, out] msgs Array of messages to send. The @c remote member of each message must be a valid destination.
+ * @param [in] count Number of elements in the @p msgs array.
+ *
+ * @return @c N > 0 Number of messages sent. The @c result member of the first @a N messages is updated with the number
+ * of bytes sent for each message.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_sendto() if the first message fails.
+ *
+ * @details Messages are sent in order and the operation stops at the first message that fails. The @c result member
+ * of a message that follows a failure is not modified. The caller should inspect the return value and retry the
+ * remaining messages as needed.
+ *
+ * @note @b LINUX: Messages are sent using @c sendmmsg(2) in batches of up to @c CLARINET_SOCKET_MESSAGE_BATCH_SIZE
+ * messages per system call. Other platforms fall back to one @c sendto(2) call per message.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_sendmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count);
+
+/**
+ * Receive multiple datagrams with a single call.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in, out] msgs Array of messages to be filled. Each message must provide a valid buffer.
+ * @param [in] count Number of elements in the @p msgs array.
+ *
+ * @return @c N > 0 Number of messages received. The @c result and @c remote members of the first @a N messages are
+ * updated with the number of bytes received and the source endpoint respectively.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom() if no message could be received.
+ *
+ * @details Blocks according to the socket mode only until the first datagram is available. Remaining messages are
+ * filled with datagrams that are already queued and the function returns as soon as the queue is exhausted. A
+ * datagram larger than its message buffer is truncated and reported individually by setting the @c result member of
+ * the corresponding message to @c CLARINET_EMSGSIZE just like @c clarinet_socket_recvfrom() would, but it still counts
+ * as a received message. The @c remote member of a truncated message is still valid.
+ *
+ * @note @b LINUX: Messages are received using @c recvmmsg(2) in batches of up to
+ * @c CLARINET_SOCKET_MESSAGE_BATCH_SIZE messages per system call. Other platforms fall back to one receive call per
+ * message.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_recvmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count);
+
+/**
+ * Set sp option.
+ *
+ * @details All sp options have a unique @p optname across all protocols. This is safer than allowing independent
+ * numbering under each option level (i.e. protocol layer). The alternative of passing an <i>option level</i> as in @c
+ * setsockopt(2) may lead to accidental modifications without warning when the user mistakes the protocol level and the
+ * wrong level happens to have an option name with the same value
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] optname
+ * @param [in] optval
+ * @param [in] optlen
+ *
+ * @return @c CLARINET_ENONE
+ * @return @c CLARINET_EINVAL
+ *
+ * @details
+ *
+ * @note
+ *
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_setopt(clarinet_socket* restrict sp,
+                       int optname,
+                       const void* restrict optval,
+                       size_t optlen);
+
+/**
+ * Get sp option.
+ *
+ * @param [in] sp
+ * @param [in] optname
+ * @param [in, out] optval
  * @param [in, out] optlen
  *
- * @return
+ * @return
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_getopt(clarinet_socket* restrict sp,
+                       int optname,
+                       void* restrict optval,
+                       size_t* restrict optlen);
+
+#define CLARINET_SOCKET_STATS_ERRORS    64  /**< Number of error codes counted individually by socket statistics */
+
+struct clarinet_socket_stats
+{
+    uint64_t syscalls;              /**< System calls issued to send or receive data */
+    uint64_t packets_out;           /**< Datagrams sent (or successful writes on a stream socket) */
+    uint64_t bytes_out;             /**< Bytes sent */
+    uint64_t packets_in;            /**< Datagrams received (or successful reads on a stream socket) */
+    uint64_t bytes_in;              /**< Bytes received */
+    uint64_t again;                 /**< Operations that could not be completed immediately (CLARINET_EAGAIN) */
+    uint64_t truncated;             /**< Datagrams received truncated (CLARINET_EMSGSIZE) */
+    uint64_t errors;                /**< Operations that failed with any other error */
+    uint64_t errors_by_code[CLARINET_SOCKET_STATS_ERRORS]; /**< Failures indexed by the negated error code */
+};
+
+/**
+ * Socket I/O counters.
+ *
+ * @details Counters are only updated by the send and receive functions of a socket. Operations submitted through a
+ * completion ring are not counted. Errors caused by invalid arguments are not counted either because they never reach
+ * the system. A datagram discarded because it was too large for the buffer is counted as truncated and not as an
+ * error. Errors with codes beyond @c CLARINET_SOCKET_STATS_ERRORS are only counted in @c errors.
+ */
+typedef struct clarinet_socket_stats clarinet_socket_stats;
+
+/**
+ * Attach a block of I/O counters to a socket.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] stats Counters to update. May be NULL to detach the counters currently attached.
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: @p sp is NULL.
+ * @return @c CLARINET_ENOTSUP: The library was built without @c CLARINET_ENABLE_PROFILE.
+ *
+ * @details The memory pointed to by @p stats is provided by the caller and must remain valid while it is attached. It
+ * is not reset so counters may be shared by multiple sockets or accumulated over several sockets in sequence. Counters
+ * are updated with relaxed atomic operations so a socket may be used by several threads at the same time. The counters
+ * are detached when the socket is closed. Without profile support the send and receive functions carry no
+ * instrumentation at all.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_setstats(clarinet_socket* restrict sp,
+                         clarinet_socket_stats* restrict stats);
+
+/**
+ * Take a snapshot of the I/O counters attached to a socket.
+ *
+ * @param [in] sp Socket pointer
+ * @param [out] stats Snapshot of the counters.
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: @p sp or @p stats is NULL.
+ * @return @c CLARINET_ENOTFOUND: No counters are attached to the socket.
+ * @return @c CLARINET_ENOTSUP: The library was built without @c CLARINET_ENABLE_PROFILE.
+ *
+ * @details Each counter is read atomically but the snapshot as a whole is not consistent if the socket is in use by
+ * other threads. Counters are monotonic so the difference between two snapshots is the activity in between.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_getstats(const clarinet_socket* restrict sp,
+                         clarinet_socket_stats* restrict stats);
+
+/**
+ * Connects the sp to a remote host.
+ *
+ * @details // TODO: document non-blocking connect(2) and SO_ERROR detection.
+//      In the case of a non-blocking socket, connect(2) may return -1/EINPROGRESS or -1/EWOUDLBLOCK. In this case, the
+//     * only way to determine when the connection process is complete is by calling select(2) or poll(2) and check for
+//     * writeability. But this check is ambiguous. The socket will indicate that it is ready to write once the connection
+//     * process is complete regardless of the outcome. The connection might as well have failed. In this case, a
+//     * subsequent call to @c send(2) will fail but this means the user can only determine the error condition much later
+//     * and on many occasions the application needs to receive some data before it can have anything to send. As an
+//     * alternative, one could call getsockopt(2) passing SO_ERROR and check if the connection process ended with a
+//     * non-zero error code. The caveat is that most Unix platforms will fetch AND RESET the socket error code with
+//     * getsockopt(2) as expected but the value will remain "dirty" if getsockopt(2) is not called even after other
+//     * successful calls to the socket. According to POSIX the value of SO_ERROR is only defined immediately after a
+//     * socket call fails. Besides, SO_ERROR is only used to report asynchronous errors that are the result of events
+//     * within the network stack and not synchronous errors that are the result of a blocking call (send/recv/connect).
+//     * Synchronous results are reported via errno. Calling getsockopt(2) with SO_ERROR after a blocking library call is
+//     * undefined behaviour while finding the non-blocking connect(2) result via select(2) is an example of discovering
+//     * when an asynchronous result is ready to be retrieved via SO_ERROR. In some systems, trying to fetch and reset
+//
+ *
+ * @param [in] sp
+ * @param [in] remote
+ *
+ * @return
+ *
+ *
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_connect(clarinet_socket* restrict sp,
+                        const clarinet_endpoint* restrict remote);
+
+/**
+ * Listen for connections on a sp.
+ *
+ * @param [in] sp Socket pointer
+ * @param [in] backlog Maximum length for the queue of pending connections. Must be greater than or equal to zero.
+ * Values between 0 and 5 should work in all platforms. Values greater than 5 may not be supported on platforms
+ * with particular resource constraints.
+ *
+ * @return @c CLARINET_ENONE: Success
+ *
+ * @return @c CLARINET_EINVAL: @p sp is NULL.
+ * @return @c CLARINET_EINVAL: The sp pointed by @p sp is invalid. The sp must be open and bound to a local
+ * endpoint.
+ * @return @c CLARINET_EINVAL: @p backlog is out of range.
+ *
+ * @return @c CLARINET_EPROTONOSUPPORT: Operation is not supported by the sp protocol.
+ *
+ * @details This function will fail if the sp is not from a compatible protocol. Currently the only compatible
+ * protocol is @c CLARINET_PROTO_TCP. The value provided by @p backlog is just a hint and the system is free to adjust
+ * or ignore it. Calling @c clarinet_socket_listen() multiple times on a listen sp with possibly a different
+ * @p backlog value is not recommended. It should not fail but the behaviour is platform dependent and can vary
+ * considerably. Setting the @p backlog parameter to 0 in a subsequent call to @c clarinet_Socket_listen() on a
+ * listening sp is not considered a proper reset, especially if there are connections in the queue.
+ *
+ * @note @b WINDOWS: The socket is considered invalid if not explicitly bound to a local endpoint first. The value of
+ * @p backlog is clamped to the interval [200, 65535]. Subsequent calls to @c clarinet_socket_listen() on the same
+ * listening sp with a valid @p backlog will ALWAYS succeed but the new @p backlog will be ignored by the system.
+ *
+ * @note @b LINUX: If the sp is not explicitly bound to a local endpoint, the system will implicitly assign a port
+ * and default binding like it does when one calls @c clarinet_socket_connect() without a previous call to
+ * @c clarinet_socket_bind(). The behavior of the @p backlog argument on TCP sockets changed with kernel 2.2. Now it
+ * specifies the queue length for completely established sockets waiting to be accepted, instead of the number of
+ * incomplete connection requests. The maximum length of the queue for incomplete sockets can be set using
+ * /proc/sys/net/ipv4/tcp_max_syn_backlog. When syncookies are enabled (net.ipv4.tcp_syncookies=1) there is no logical
+ * maximum length and this setting is ignored. See <a href="https://man7.org/linux/man-pages/man7/tcp.7.html">tcp(7)</a>
+ * for more information. If @p backlog is greater than the value in /proc/sys/net/core/somaxconn, then it is silently
+ * capped to that value. Since Linux 5.4, the default value in this file is 4096; in earlier kernels, the default value
+ * is 128. In kernels before 2.4.25, this limit was a hard coded constant, @c SOMAXCONN = 128. Subsequent calls to
+ * @c clarinet_socket_listen() on the listening sp will adjust the backlog queue length using the new @p backlog
+ * value, but only for future connection requests. It does not discard any pending connections already in the queue.
+ *
+ * @note @b BSD/DARWIN: If the sp is not explicitly bound to a local endpoint, the system will implicitly assign a
+ * port and default binding like it does when one calls @c clarinet_socket_connect() without a previous call to
+ * @c clarinet_socket_bind(). The real maximum queue length will be 1.5 times more than the value specified by
+ * @p backlog. Any subsequent call to @c clarinet_socket_listen() on the listening sp allows the caller to change
+ * the maximum queue length using a new @p backlog argument. If a connection request arrives with the queue full, the
+ * client may receive an error with an indication of @c CLARINET_ECONNREFUSED, or, in the case of TCP, the connection
+ * will be silently dropped. Current queue lengths of listening sockets can be queried using @c netstat(1) command. Note
+ * that before FreeBSD 4.5 and the introduction of the syncache, @p backlog also determined the length of the incomplete
+ * connection queue, which held TCP sockets in the process of completing TCP's 3-way handshake. These incomplete
+ * connections are now held entirely in the syncache, which is unaffected by queue lengths. Inflated backlog values to
+ * help handle denial of service attacks are no longer necessary. The @c sysctl(3) MIB variable
+ * @c kern.ipc.soacceptqueue specifies a hard limit on backlog; if a value greater than kern.ipc.soacceptqueue or less
+ * than zero is specified, @p backlog is silently forced to @c kern.ipc.soacceptqueue. If the listen queue overflows,
+ * the kernel will emit a @c LOG_DEBUG syslog message. The @c sysctl(3) MIB variable kern.ipc.sooverinterval specifies a
+ * per-sp limit on how often the kernel will emit these messages.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_listen(clarinet_socket* sp,
+                       int backlog);
+
+/**
+ *
+ * @param [in] ssp Server socket pointer
+ * @param [in] csp Client socket pointer
+ * @param [out] remote Remote end point of the client socket
+ * @return
+ *
+ * @note A failure to obtain the remote address of the connected socket is not considered an error because in theory a
+ * platform might not be able to provide that information immediately and would require an explicit call to
+ * @c clarinet_socket_remote_endpoint() for that purpose. There is currently no supported platform to which this is the
+ * case.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_accept(clarinet_socket* restrict ssp,
+                       clarinet_socket* restrict csp,
+                       clarinet_endpoint* restrict remote);
+
+/**
+ *
+ * @param [in] sp
+ * @param [in] flags
+ *
+ * @return @c CLARINET_ENONE
+ * @return @c CLARINET_ENOTCONN: The socket pointed to by @c sp is not connected.
+ *
+ * @details Once the shutdown function is called to disable send, receive, or both, there is no method to re-enable that
+ * capability for the existing sp connection.
+ *
+ * @note @b WINDOWS: A UDP socket can be shutdown even when not connected so @c CLARINET_ENOTCONN will only be returned
+ * for TCP sockets.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_shutdown(clarinet_socket* restrict sp,
+                         int flags);
+
+
+struct clarinet_socket_poll_target
+{
+    clarinet_socket* socket;    /**< Socket to poll. */
+    uint16_t events;            /**< Socket Event flags to poll. */
+};
+
+typedef struct clarinet_socket_poll_target clarinet_socket_poll_target;
+
+/**
+ * Calculates the size in bytes required for a @c clarinet_socket_poll_list to accomodate the number of items
+ * indicated by @p count.
+ *
+ * @param [in] count Number of items in the list
+ *
+ * @return @c N > 0 Size in bytes of the memory block that must be allocated for the @c clarinet_socket_poll_list.
+ * @return @c CLARINET_EINVAL
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_poll_context_calcsize(size_t count);
+
+/**
+ * Retrieve a specific socket poll status.
+ *
+ * @param [in] context Buffer used in a previous call to @c clarinet_socket_poll().
+ * @param [in] index Index of the status to retrieve.
+ * @param [out] status Status report of the target.
+ *
+ * @return @c CLARINET_ENONE
+ * @return @c CLARINET_EINVAL
+ *
+ * @details It's guaranteed that the index @a i of every result is the same of it's corresponding target in the array
+ * passed to @c clarinet_socket_poll().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_poll_context_getstatus(const void* restrict context,
+                                       size_t index,
+                                       uint16_t* restrict status);
+
+/**
+ * Determines the status of one or more sockets.
+ *
+ * @param [in] context Buffer used to store the operation results.
+ * @param [in] targets Array of sockets and the corresponding events to report.
+ * @param [in] count Number of elements in the @c targets array.
+ * @param [in] timeout Number of milliseconds that the function should block waiting for an event on any target.
+ *
+ * @return @c CLARINET_ENONE
+ * @return @c CLARINET_EINVAL
+ *
+ * @details On success the function @c clarinet_socket_poll_context_getstatus() can be used to fetch the status of a
+ * specific target. The caller is responsible for allocating the memory pointed to by @c context which is where the operation
+ * results are stored. The function @c clarinet_socket_poll_context_calcsize() can be used to determine the required
+ * size in bytes according to the number of targets.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_poll(void* restrict context,
+                     const clarinet_socket_poll_target* restrict targets,
+                     size_t count,
+                     int timeout);
+
+/* endregion */
+
+/* region Poller */
+
+struct clarinet_poller
+{
+    clarinet_socket_handle handle;  /**< System handle (read-only) */
+};
+
+/**
+ * Persistent set of sockets monitored for events.
+ *
+ * @details Unlike @c clarinet_socket_poll() which requires the whole set of targets to be passed (and scanned) on every
+ * call, a poller keeps the set of sockets registered in the system so that the cost of a wait operation is proportional
+ * to the number of sockets ready and not to the number of sockets monitored. Must be initialized using
+ * @c clarinet_poller_init() before it can be used. Pollers are not movable.
+ *
+ * @note @b LINUX: Implemented with epoll(7).
+ *
+ * @note @b WINDOWS: Not supported. @c clarinet_poller_open() always returns @c CLARINET_ENOTSUP so every other
+ * function fails the validation of the poller. Use @c clarinet_socket_poll() instead.
+ *
+ * @note Not supported on other platforms.
+ */
+typedef struct clarinet_poller clarinet_poller;
+
+struct clarinet_poller_event
+{
+    void* data;                 /**< User data associated with the socket when it was added to the poller. */
+    uint16_t events;            /**< Socket Event flags reported. */
+};
+
+/** Data structure used to report a socket event from a poller. */
+typedef struct clarinet_poller_event clarinet_poller_event;
+
+/**
+ * Initialize a poller structure.
+ *
+ * @param [in] pp Poller pointer
+ *
+ * @details The memory pointed to by @p pp must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_poller_init(clarinet_poller* pp);
+
+/**
+ * Create a new poller.
+ *
+ * @param [in] pp Poller pointer
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: @p pp is NULL or already open.
+ * @return @c CLARINET_ENOTSUP: The platform does not support pollers.
+ * @return @c CLARINET_EMFILE
+ * @return @c CLARINET_ENOMEM
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_open(clarinet_poller* pp);
+
+/**
+ * Close the poller.
+ *
+ * @param [in] pp Poller pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ *
+ * @details Sockets registered in the poller are not affected. On success this function reinitializes the structure
+ * pointed to by @p pp.
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_close(clarinet_poller* pp);
+
+/**
+ * Register a socket in the poller.
+ *
+ * @param [in] pp Poller pointer
+ * @param [in] sp Socket pointer
+ * @param [in] events Socket Event flags to monitor.
+ * @param [in] data User data reported with each event of this socket.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EALREADY: The socket is already registered in the poller.
+ * @return @c CLARINET_ENOMEM
+ *
+ * @details @c CLARINET_POLL_ERROR and @c CLARINET_POLL_SHUTDOWN are always reported and do not have to be requested.
+ * A socket is automatically removed from the poller when it is closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_add(clarinet_poller* restrict pp,
+                    clarinet_socket* restrict sp,
+                    uint16_t events,
+                    void* data);
+
+/**
+ * Modify the events monitored and the user data of a socket registered in the poller.
+ *
+ * @param [in] pp Poller pointer
+ * @param [in] sp Socket pointer
+ * @param [in] events Socket Event flags to monitor.
+ * @param [in] data User data reported with each event of this socket.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTFOUND: The socket is not registered in the poller.
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_modify(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp,
+                       uint16_t events,
+                       void* data);
+
+/**
+ * Unregister a socket from the poller.
+ *
+ * @param [in] pp Poller pointer
+ * @param [in] sp Socket pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTFOUND: The socket is not registered in the poller.
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_remove(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp);
+
+/**
+ * Wait for events on the sockets registered in the poller.
+ *
+ * @param [in] pp Poller pointer
+ * @param [out] events Array to store the events reported.
+ * @param [in] count Number of elements in the @p events array.
+ * @param [in] timeout Number of milliseconds that the function should block waiting for an event. A negative value
+ * means an infinite timeout and zero returns immediately.
+ *
+ * @return @c N >= 0 Number of events stored in @p events. Zero indicates the timeout expired.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EINTR
+ *
+ * @details Only sockets with pending events are reported. Sockets are monitored in level-triggered mode so an event
+ * is reported again by a subsequent wait if the condition persists.
+ */
+CLARINET_EXTERN
+int
+clarinet_poller_wait(clarinet_poller* restrict pp,
+                     clarinet_poller_event* restrict events,
+                     size_t count,
+                     int timeout);
+
+/* endregion */
+
+/* region Socket Group */
+
+#define CLARINET_SOCKET_GROUP_NONE          0x00    /**< Let the system distribute datagrams among the sockets */
+#define CLARINET_SOCKET_GROUP_STEER_HASH    0x01    /**< Steer datagrams by the source address and port */
+#define CLARINET_SOCKET_GROUP_STEER_CPU     0x02    /**< Steer datagrams by the CPU that received them */
+
+#define CLARINET_SOCKET_GROUP_MAX           256     /**< Maximum number of sockets in a group */
+
+struct clarinet_socket_group
+{
+    clarinet_socket* sockets;       /**< Sockets of the group, one per shard (read-only) */
+    size_t count;                   /**< Number of sockets (read-only) */
+    clarinet_endpoint local;        /**< Local endpoint shared by all sockets (read-only) */
+    uint32_t flags;                 /**< Combination of CLARINET_SOCKET_GROUP_* flags (read-only) */
+};
+
+/**
+ * Group of UDP sockets bound to the same local endpoint.
+ *
+ * @details A socket group lets a server receive on the same port from several threads without sharing a socket, a
+ * lock or a queue. Each socket is a shard that is expected to be served by a single worker thread. The system
+ * distributes incoming datagrams among the sockets. By default the socket chosen for a datagram is a function of the
+ * 4-tuple and the number of sockets in the group. A steering flag attaches a program that selects the shard instead.
+ * Sockets are opened with default options. Any option that does not have to be set before binding can be changed
+ * afterwards on each socket individually. Must be initialized using @c clarinet_socket_group_init() before it can be
+ * used. Socket groups are not movable.
+ *
+ * @note @b LINUX: Requires SO_REUSEPORT (Linux >= 3.9). Steering flags require SO_ATTACH_REUSEPORT_CBPF
+ * (Linux >= 4.5).
+ *
+ * @note @b BSD: Requires SO_REUSEPORT_LB (FreeBSD >= 12). Steering flags are not supported.
+ *
+ * @note @b DARWIN: Sockets can be opened but the system does not distribute unicast datagrams among them so only one
+ * socket of the group receives.
+ *
+ * @note Not supported on other platforms.
+ */
+typedef struct clarinet_socket_group clarinet_socket_group;
+
+/**
+ * Initialize a socket group structure.
+ *
+ * @param [in] group Socket group pointer
+ *
+ * @details The memory pointed to by @p group must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_socket_group_init(clarinet_socket_group* group);
+
+/**
+ * Open and bind a group of UDP sockets.
+ *
+ * @param [in] group Socket group pointer
+ * @param [in] sockets Array of sockets to open. Must remain valid until the group is closed.
+ * @param [in] count Number of elements in the @p sockets array.
+ * @param [in] local Local endpoint to bind. If the port is zero all sockets are bound to the same ephemeral port.
+ * @param [in] flags Combination of @c CLARINET_SOCKET_GROUP_* flags
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: An argument is invalid, @p count is greater than @c CLARINET_SOCKET_GROUP_MAX, more than
+ * one steering flag was passed or @p group is already open.
+ * @return @c CLARINET_ENOTSUP: The platform does not support socket groups or the requested steering.
+ * @return @c CLARINET_EADDRINUSE: The local endpoint is in use by a socket that does not belong to the group.
+ *
+ * @details The elements of @p sockets must have been initialized and are opened in order. The socket at index @a i
+ * is always the shard @a i. On failure every socket opened is closed again.
+ *
+ * With @c CLARINET_SOCKET_GROUP_STEER_HASH a datagram is delivered to the shard given by a hash of its source address
+ * and port. The same client always lands on the same shard regardless of the network adapter configuration. With
+ * @c CLARINET_SOCKET_GROUP_STEER_CPU a datagram is delivered to the shard @a i such that @a i is the index of the CPU
+ * that received it modulo @p count. This is most effective when the number of shards matches the number of receive
+ * queues and each worker pins itself with @c clarinet_socket_group_pin().
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_group_open(clarinet_socket_group* restrict group,
+                           clarinet_socket* restrict sockets,
+                           size_t count,
+                           const clarinet_endpoint* restrict local,
+                           uint32_t flags);
+
+/**
+ * Close every socket of the group.
+ *
+ * @param [in] group Socket group pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL: @p group is NULL or not open.
+ *
+ * @details Workers must have stopped using the sockets before this function is called. On success this function
+ * reinitializes the structure pointed to by @p group.
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_group_close(clarinet_socket_group* group);
+
+/**
+ * Pin the calling thread to the CPU of a shard.
+ *
+ * @param [in] group Socket group pointer
+ * @param [in] shard Index of the shard served by the calling thread.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL: @p group is NULL or not open or @p shard is not less than the number of sockets.
+ * @return @c CLARINET_ENOTSUP: The platform does not support thread affinity.
+ *
+ * @details The library does not create threads so each worker is expected to call this function once before it starts
+ * to serve its shard. The CPU is the first one the calling thread is allowed to run on whose number modulo the number
+ * of sockets is @p shard, which is the CPU that @c CLARINET_SOCKET_GROUP_STEER_CPU delivers to the shard. If no allowed
+ * CPU maps to the shard the CPU is the @a n-th allowed one where @a n is @p shard modulo the number of allowed CPUs. A
+ * thread pinned by a previous call is only allowed to run on one CPU so it cannot be pinned to a different one.
+ *
+ * @note @b LINUX: Implemented with sched_setaffinity(2).
+ */
+CLARINET_EXTERN
+int
+clarinet_socket_group_pin(const clarinet_socket_group* group,
+                          size_t shard);
+
+/* endregion */
+
+/* region Multicast Fanout */
+
+#define CLARINET_MCAST_FANOUT_NONE          0x00    /**< Datagrams are only delivered to other hosts */
+#define CLARINET_MCAST_FANOUT_LOOP          0x01    /**< Datagrams are also delivered to members on the local host */
+
+struct clarinet_mcast_fanout
+{
+    clarinet_socket* socket;        /**< Socket used to publish (read-only) */
+    clarinet_endpoint group;        /**< Multicast group and port datagrams are sent to (read-only) */
+    uint32_t iface;                 /**< Index of the interface used to send or 0 if chosen by the system (read-only) */
+    uint32_t flags;                 /**< Combination of CLARINET_MCAST_FANOUT_* flags (read-only) */
+};
+
+/**
+ * Publisher of a multicast stream.
+ *
+ * @details A fanout replicates a stream (e.g. spectator or world state updates) to every subscriber with a single send
+ * per datagram instead of one unicast send per subscriber. Subscribers receive the stream on a UDP socket bound to the
+ * port of the group and joined to it with @c CLARINET_IP_MCAST_JOIN. The network replicates the datagrams so the cost
+ * for the publisher does not depend on the number of subscribers. Multicast is normally confined to a local network
+ * (e.g. a LAN party, a data center or a host running several game instances). The socket is provided by the caller and
+ * may be used for other traffic as well. Must be initialized using @c clarinet_mcast_fanout_init() before it can be
+ * used.
+ */
+typedef struct clarinet_mcast_fanout clarinet_mcast_fanout;
+
+/**
+ * Initialize a multicast fanout structure.
+ *
+ * @param [in] fanout Fanout pointer
+ *
+ * @details The memory pointed to by @p fanout must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_mcast_fanout_init(clarinet_mcast_fanout* fanout);
+
+/**
+ * Open a multicast fanout.
+ *
+ * @param [in] fanout Fanout pointer
+ * @param [in] sp Open UDP socket of the same family as the group. Must remain valid until the fanout is closed.
+ * @param [in] group Multicast group address and port.
+ * @param [in] iface Index of the interface used to send or 0 to let the system choose based on the routing table.
+ * @param [in] ttl Time-To-Live (IPv4) or Hop Limit (IPv6) of the datagrams sent. Use 1 to stay in the local network.
+ * @param [in] flags Combination of @c CLARINET_MCAST_FANOUT_* flags
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: An argument is invalid, @p group is not a multicast address or its port is zero, the
+ * family of @p sp differs from the family of @p group or @p fanout is already open.
+ * @return @c CLARINET_ENOTSUP: The platform cannot select the interface by index.
+ * @return Any error code that could be returned by @c clarinet_socket_setopt().
+ *
+ * @details The socket options @c CLARINET_IP_MCAST_TTL, @c CLARINET_IP_MCAST_LOOP and @c CLARINET_IP_MCAST_IF (unless
+ * @p iface is zero) are set on @p sp.
+ */
+CLARINET_EXTERN
+int
+clarinet_mcast_fanout_open(clarinet_mcast_fanout* restrict fanout,
+                           clarinet_socket* restrict sp,
+                           const clarinet_endpoint* restrict group,
+                           uint32_t iface,
+                           uint8_t ttl,
+                           uint32_t flags);
+
+/**
+ * Close a multicast fanout.
+ *
+ * @param [in] fanout Fanout pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL: @p fanout is NULL or not open.
+ *
+ * @details The socket is not closed. On success this function reinitializes the structure pointed to by @p fanout.
+ */
+CLARINET_EXTERN
+int
+clarinet_mcast_fanout_close(clarinet_mcast_fanout* fanout);
+
+/**
+ * Send a datagram to every subscriber of a multicast fanout.
+ *
+ * @param [in] fanout Fanout pointer
+ * @param [in] buf Datagram
+ * @param [in] buflen Size in bytes of the datagram
+ *
+ * @return Number of bytes sent or a negative error code.
+ * @return @c CLARINET_EINVAL: @p fanout is NULL or not open, or any error code that could be returned by
+ * @c clarinet_socket_sendto().
+ */
+CLARINET_EXTERN
+int
+clarinet_mcast_fanout_send(clarinet_mcast_fanout* restrict fanout,
+                           const void* restrict buf,
+                           size_t buflen);
+
+/**
+ * Send a datagram gathered from multiple buffers to every subscriber of a multicast fanout.
+ *
+ * @param [in] fanout Fanout pointer
+ * @param [in] iov Array of buffers
+ * @param [in] iovcnt Number of elements in the @p iov array.
+ *
+ * @return Number of bytes sent or a negative error code.
+ * @return @c CLARINET_EINVAL: @p fanout is NULL or not open, or any error code that could be returned by
+ * @c clarinet_socket_sendtov().
+ *
+ * @details Useful to prepend a per-stream header to a payload shared with other streams without copying.
+ */
+CLARINET_EXTERN
+int
+clarinet_mcast_fanout_sendv(clarinet_mcast_fanout* restrict fanout,
+                            const clarinet_iovec* restrict iov,
+                            size_t iovcnt);
+
+/* endregion */
+
+/* region Path MTU Prober */
+
+#define CLARINET_PMTU_PROBES_MAX            3       /**< Probes of a size lost before the size is considered too big */
+#define CLARINET_PMTU_RAISE_TIMEOUT         600000  /**< Time in milliseconds until a larger size is searched again */
+
+#define CLARINET_PMTU_STATE_CLOSED          0       /**< Prober is not open */
+#define CLARINET_PMTU_STATE_BASE            1       /**< Confirming the base size after a black hole was detected */
+#define CLARINET_PMTU_STATE_SEARCHING       2       /**< Searching for the largest size that reaches the peer */
+#define CLARINET_PMTU_STATE_COMPLETE        3       /**< Search is complete until the raise timeout expires */
+#define CLARINET_PMTU_STATE_ERROR           4       /**< Not even the base size reaches the peer */
+
+struct clarinet_pmtu_prober
+{
+    uint32_t state;                 /**< State (@c CLARINET_PMTU_STATE_*) (read-only) */
+    uint32_t base;                  /**< Smallest size assumed to reach the peer (read-only) */
+    uint32_t max;                   /**< Largest size searched (read-only) */
+    uint32_t pmtu;                  /**< Largest size confirmed to reach the peer (read-only) */
+    uint32_t probe;                 /**< Size of the probe in flight or 0 if none (read-only) */
+    uint32_t timeout;               /**< Time in milliseconds until a probe in flight is declared lost (read-only) */
+    uint32_t high;                  /**< Largest size not known to be too big (private) */
+    uint32_t hint;                  /**< Size to probe before searching or 0 if none (private) */
+    uint32_t count;                 /**< Number of probes of the current size sent (private) */
+    uint32_t losses;                /**< Consecutive losses of datagrams larger than the base size (private) */
+    uint32_t backoff;               /**< Number of black holes detected since the last raise (private) */
+    uint32_t rffu CLARINET_UNUSED;
+    uint64_t deadline;              /**< Time the probe in flight is declared lost (private) */
+    uint64_t next;                  /**< Earliest time the next probe may be sent (private) */
+};
+
+/**
+ * Datagram packetization layer path MTU prober.
+ *
+ * @details A prober discovers the largest UDP payload that reaches a peer along the lines of RFC 8899 (DPLPMTUD). It
+ * does not rely on ICMP messages which are often filtered. Instead it sends probe datagrams padded to a candidate
+ * size with the DF bit set and waits for the peer to acknowledge them. The search tries a hint (e.g. a cached result)
+ * or the maximum size first because most paths support the MTU of the local interface, then falls back to a binary
+ * search. A size is considered too big when @c CLARINET_PMTU_PROBES_MAX probes of that size are lost or the socket
+ * rejects it. The search is repeated after @c CLARINET_PMTU_RAISE_TIMEOUT in case the path changed.
+ *
+ * Regular datagrams must never be larger than @c pmtu. Repeated losses of datagrams larger than the base size reported
+ * with @c clarinet_pmtu_prober_on_loss() are taken as a black hole. The prober then falls back to the base size, which
+ * is confirmed with a probe, and searches again after a delay that doubles with every black hole.
+ *
+ * The prober does not acknowledge probes. The application protocol must identify probes (e.g. by a message type in
+ * the payload that precedes the padding) and have the peer acknowledge them. Sizes are UDP payload sizes in bytes.
+ * Times are in milliseconds of any monotonic clock (e.g. @c clarinet_time_now()). Must be initialized using
+ * @c clarinet_pmtu_prober_init() before it can be used. Probers are not thread-safe.
+ */
+typedef struct clarinet_pmtu_prober clarinet_pmtu_prober;
+
+/**
+ * Initialize a path MTU prober structure.
+ *
+ * @param [in] prober Prober pointer
+ *
+ * @details The memory pointed to by @p prober must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_pmtu_prober_init(clarinet_pmtu_prober* prober);
+
+/**
+ * Open a path MTU prober and start searching.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] base Smallest size assumed to reach the peer. Used until a larger size is confirmed. Common choices are
+ * 1232 for IPv6 paths (1280 - 48 bytes of headers) and 548 for IPv4 paths (576 - 28 bytes of headers).
+ * @param [in] max Largest size to search. Usually the MTU of the local interface minus the IP and UDP headers (e.g.
+ * 1472 for IPv4 over Ethernet).
+ * @param [in] hint Size to confirm before searching (e.g. obtained from a @c clarinet_pmtu_cache) or 0 if none.
+ * @param [in] timeout Time in milliseconds until a probe in flight is declared lost. Should be larger than the
+ * round-trip time.
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p prober is NULL or already open, @p base is 0, @p max is less than @p base or greater
+ * than 65507, @p hint is not 0 and outside [@p base, @p max], or @p timeout is 0.
+ *
+ * @details When a hint is confirmed the search completes immediately on the assumption that larger sizes have been
+ * found too big before. Otherwise the maximum size is tried first.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_open(clarinet_pmtu_prober* prober,
+                          uint32_t base,
+                          uint32_t max,
+                          uint32_t hint,
+                          uint32_t timeout,
+                          uint64_t now);
+
+/**
+ * Close a path MTU prober.
+ *
+ * @param [in] prober Prober pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p prober is NULL or not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_close(clarinet_pmtu_prober* prober);
+
+/**
+ * Check whether a probe must be sent.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] now Current time in milliseconds.
+ * @param [out] size Size of the probe to send.
+ *
+ * @return @c CLARINET_ENONE: A probe of @p size bytes must be sent now.
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p prober is not open.
+ * @return @c CLARINET_EAGAIN: No probe must be sent yet.
+ *
+ * @details Also declares the probe in flight lost when its timeout expires. Every successful call accounts for one
+ * probe so the probe should be sent right away (e.g. with @c clarinet_pmtu_prober_sendto()). Use
+ * @c clarinet_pmtu_prober_timeout() to know when to call again.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_poll(clarinet_pmtu_prober* restrict prober,
+                          uint64_t now,
+                          uint32_t* restrict size);
+
+/**
+ * Send the probe in flight padded with zeros.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] sp Socket pointer. Should have @c CLARINET_IP_MTU_DISCOVER set to @c CLARINET_PMTUD_PROBE so the probe
+ * is sent with the DF bit set regardless of the path MTU estimated by the system.
+ * @param [in] buf Payload that identifies the probe. May be NULL if @p buflen is 0.
+ * @param [in] buflen Size of @p buf in bytes. Must not exceed the size of the probe.
+ * @param [in] dst Destination endpoint
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c N >= 0 Number of bytes sent which is always the size of the probe.
+ * @return @c CLARINET_EINVAL: An argument is invalid, @p prober is not open or there is no probe in flight.
+ * @return @c CLARINET_EMSGSIZE: The probe is larger than the local interface allows. The size is considered too big
+ * and the search moves on.
+ * @return Any error code that could be returned by @c clarinet_socket_sendtov().
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_sendto(clarinet_pmtu_prober* restrict prober,
+                            clarinet_socket* restrict sp,
+                            const void* restrict buf,
+                            size_t buflen,
+                            const clarinet_endpoint* restrict dst,
+                            uint64_t now);
+
+/**
+ * Report that a datagram reached the peer.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] size Size of the datagram acknowledged.
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p prober is NULL or not open.
+ *
+ * @details An acknowledgement of the size of the probe in flight confirms the size. Acknowledgements of regular
+ * datagrams larger than the base size reset the black hole detection.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_on_ack(clarinet_pmtu_prober* prober,
+                            uint32_t size,
+                            uint64_t now);
+
+/**
+ * Report that a regular datagram was lost.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] size Size of the datagram lost.
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p prober is NULL or not open.
+ *
+ * @details Lost probes must not be reported since they are detected by the prober itself.
+ * @c CLARINET_PMTU_PROBES_MAX consecutive losses of datagrams larger than the base size are taken as a black hole.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_on_loss(clarinet_pmtu_prober* prober,
+                             uint32_t size,
+                             uint64_t now);
+
+/**
+ * Report a packet too big indication.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] size Largest size indicated to reach the peer (e.g. @c CLARINET_IP_MTU minus the IP and UDP headers).
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p prober is NULL or not open.
+ *
+ * @details Indications are not authenticated so they only ever lower the sizes searched and never below the base
+ * size. Indications not below the size of the probe in flight (or the size confirmed if there is none) are ignored. A
+ * probe in flight larger than the size indicated is considered too big right away.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_on_ptb(clarinet_pmtu_prober* prober,
+                            uint32_t size,
+                            uint64_t now);
+
+/**
+ * Calculate how long an event loop may wait before the prober must be polled again.
+ *
+ * @param [in] prober Prober pointer
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return Number of milliseconds suitable as the timeout of @c clarinet_poller_wait() or @c clarinet_socket_poll().
+ * @return 0 if the prober must be polled now.
+ * @return -1 if @p prober is NULL or not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_prober_timeout(const clarinet_pmtu_prober* prober,
+                             uint64_t now);
+
+struct clarinet_pmtu_cache_entry
+{
+    clarinet_addr addr;             /**< Destination address (private) */
+    uint32_t pmtu;                  /**< Size confirmed or 0 if the entry is empty (private) */
+    uint32_t rffu CLARINET_UNUSED;
+    uint64_t expiry;                /**< Time the entry expires (private) */
+};
+
+/** Entry of a path MTU cache. */
+typedef struct clarinet_pmtu_cache_entry clarinet_pmtu_cache_entry;
+
+struct clarinet_pmtu_cache
+{
+    clarinet_pmtu_cache_entry* entries; /**< Entries (private) */
+    uint32_t capacity;              /**< Number of entries (read-only) */
+    uint32_t lifetime;              /**< Time in milliseconds an entry remains valid (read-only) */
+    uint64_t seed;                  /**< Hash seed (private) */
+};
+
+/**
+ * Cache of path MTU search results per destination address.
+ *
+ * @details Lets a new prober for a known destination confirm the previous result with a single probe instead of
+ * searching again. IPv4 mapped to IPv6 addresses share the entry of their IPv4 form. The cache is direct-mapped over
+ * an array supplied by the caller so a new entry simply replaces whatever entry has the same hash slot. Must be
+ * initialized using @c clarinet_pmtu_cache_init() before it can be used. Caches are not thread-safe.
+ */
+typedef struct clarinet_pmtu_cache clarinet_pmtu_cache;
+
+/**
+ * Initialize a path MTU cache structure.
+ *
+ * @param [in] cache Cache pointer
+ *
+ * @details The memory pointed to by @p cache must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_pmtu_cache_init(clarinet_pmtu_cache* cache);
+
+/**
+ * Open a path MTU cache.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] entries Array of @p capacity entries. Must remain valid until the cache is closed.
+ * @param [in] capacity Number of entries. Must be a power of 2.
+ * @param [in] lifetime Time in milliseconds an entry remains valid. Should not exceed
+ * @c CLARINET_PMTU_RAISE_TIMEOUT.
+ * @param [in] seed Hash seed
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or already open, @p entries is NULL, @p capacity is invalid or
+ * @p lifetime is 0.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_cache_open(clarinet_pmtu_cache* restrict cache,
+                         clarinet_pmtu_cache_entry* restrict entries,
+                         uint32_t capacity,
+                         uint32_t lifetime,
+                         uint64_t seed);
+
+/**
+ * Close a path MTU cache.
+ *
+ * @param [in] cache Cache pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_cache_close(clarinet_pmtu_cache* cache);
+
+/**
+ * Store the path MTU of a destination.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] addr Destination address
+ * @param [in] pmtu Size confirmed (e.g. @c clarinet_pmtu_prober::pmtu once the search is complete).
+ * @param [in] now Current time in milliseconds.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid, @p pmtu is 0, @p addr is not an IPv4 or IPv6 address or
+ * @p cache is not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_cache_store(clarinet_pmtu_cache* restrict cache,
+                          const clarinet_addr* restrict addr,
+                          uint32_t pmtu,
+                          uint64_t now);
+
+/**
+ * Look up the path MTU of a destination.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] addr Destination address
+ * @param [in] now Current time in milliseconds.
+ * @param [out] pmtu Size stored.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p cache is not open.
+ * @return @c CLARINET_ENOTFOUND: There is no valid entry for @p addr.
+ */
+CLARINET_EXTERN
+int
+clarinet_pmtu_cache_lookup(const clarinet_pmtu_cache* restrict cache,
+                           const clarinet_addr* restrict addr,
+                           uint64_t now,
+                           uint32_t* restrict pmtu);
+
+/* endregion */
+
+/* region Pacer */
+
+#define CLARINET_PACER_HORIZON              1000000 /**< Time in microseconds a datagram may be scheduled in advance */
+
+#define CLARINET_PACER_USERSPACE            0x01    /**< Do not use transmit times even if supported */
+#define CLARINET_PACER_TXTIME               0x02    /**< Datagrams are paced by the system (read-only) */
+
+struct clarinet_pacer
+{
+    clarinet_socket* socket;        /**< Socket or NULL when not open (read-only) */
+    uint64_t rate;                  /**< Rate in bytes per second or 0 if not paced (read-only) */
+    uint64_t next;                  /**< Earliest time in microseconds to transmit the next datagram (read-only) */
+    uint32_t flags;                 /**< Flags (@c CLARINET_PACER_*) (read-only) */
+    uint32_t rffu CLARINET_UNUSED;
+};
+
+/**
+ * Datagram pacer.
+ *
+ * @details A pacer spreads the datagrams sent through it evenly in time according to a rate so that a burst produced
+ * at once (e.g. the snapshots of a simulation tick) does not overflow the buffers of switches and routers along the
+ * path. When the platform supports transmit times the socket is set up with @c CLARINET_SO_TXTIME and each datagram
+ * is handed to the system immediately with a transmit time up to @c CLARINET_PACER_HORIZON in advance. Otherwise, or
+ * if @c CLARINET_PACER_USERSPACE is requested, the pacer falls back to user-space pacing where the caller must wait
+ * for @c clarinet_pacer_timeout() between datagrams. The flag @c CLARINET_PACER_TXTIME tells which mode is in use.
+ *
+ * The pacer does not own the socket which must remain open while the pacer is open. Times are in microseconds of
+ * @c clarinet_time_now_us(). Must be initialized using @c clarinet_pacer_init() before it can be used. Pacers are not
+ * thread-safe.
+ */
+typedef struct clarinet_pacer clarinet_pacer;
+
+/**
+ * Initialize a pacer structure.
+ *
+ * @param [in] pacer Pacer pointer
+ *
+ * @details The memory pointed to by @p pacer must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_pacer_init(clarinet_pacer* pacer);
+
+/**
+ * Open a pacer on top of a UDP socket.
+ *
+ * @param [in] pacer Pacer pointer
+ * @param [in] sp Socket pointer
+ * @param [in] rate Rate in bytes per second or 0 to send datagrams without pacing.
+ * @param [in] flags Either 0 or @c CLARINET_PACER_USERSPACE.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pacer is NULL or already open, @p sp is NULL or @p flags is invalid.
+ *
+ * @details Enables @c CLARINET_SO_TXTIME on the socket unless @c CLARINET_PACER_USERSPACE is requested. Failure to
+ * enable the option is not an error and only makes the pacer fall back to user-space pacing.
+ */
+CLARINET_EXTERN
+int
+clarinet_pacer_open(clarinet_pacer* restrict pacer,
+                    clarinet_socket* restrict sp,
+                    uint64_t rate,
+                    uint32_t flags);
+
+/**
+ * Close a pacer.
+ *
+ * @param [in] pacer Pacer pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pacer is NULL or not open.
+ *
+ * @details The socket is not affected. Datagrams already handed to the system are still transmitted at their
+ * transmit times.
+ */
+CLARINET_EXTERN
+int
+clarinet_pacer_close(clarinet_pacer* pacer);
+
+/**
+ * Change the rate of a pacer.
+ *
+ * @param [in] pacer Pacer pointer
+ * @param [in] rate Rate in bytes per second or 0 to send datagrams without pacing.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p pacer is NULL or not open.
+ *
+ * @details Takes effect from the next datagram on. Suitable to follow the pacing rate of a congestion controller
+ * (@c clarinet_cc).
+ */
+CLARINET_EXTERN
+int
+clarinet_pacer_setrate(clarinet_pacer* pacer,
+                       uint64_t rate);
+
+/**
+ * Send a datagram through a pacer.
+ *
+ * @param [in] pacer Pacer pointer
+ * @param [in] buf Buffer containing the data to send
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [in] remote Destination endpoint
+ * @param [in] now Current time in microseconds of @c clarinet_time_now_us().
+ *
+ * @return @c N >= 0 Number of bytes sent.
+ * @return @c CLARINET_EINVAL: @p pacer is NULL or not open.
+ * @return @c CLARINET_EAGAIN: The rate does not allow the datagram to be sent yet. Retry after
+ * @c clarinet_pacer_timeout().
+ * @return Any error code that could be returned by @c clarinet_socket_sendto().
+ *
+ * @details The datagram is scheduled at the later of @p now and the time the previous datagram finished according to
+ * the rate so idle periods do not accumulate credit for a later burst. A datagram that fails to be sent does not
+ * consume any time.
+ */
+CLARINET_EXTERN
+int
+clarinet_pacer_sendto(clarinet_pacer* restrict pacer,
+                      const void* restrict buf,
+                      size_t buflen,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now);
+
+/**
+ * Obtain the time until the next datagram may be sent through a pacer.
+ *
+ * @param [in] pacer Pacer pointer
+ * @param [in] now Current time in microseconds of @c clarinet_time_now_us().
+ *
+ * @return Time in microseconds until @c clarinet_pacer_sendto() accepts a datagram, 0 if it does already or -1 if
+ * @p pacer is NULL or not open.
+ */
+CLARINET_EXTERN
+int
+clarinet_pacer_timeout(const clarinet_pacer* pacer,
+                       uint64_t now);
+
+/* endregion */
+
+/* region Completion Ring */
+
+#define CLARINET_URING_GROUPS_MAX           8       /**< Maximum number of provided buffer groups per ring */
+
+/**
+ * Number of bytes at the start of every provided buffer reserved for the system to store the datagram metadata
+ * (including the source address) of a multishot receive. Data is stored right after.
+ */
+#define CLARINET_URING_BUFFER_OVERHEAD      64
+
+#define CLARINET_URING_COMPLETION_NONE      0x00    /**< None */
+#define CLARINET_URING_COMPLETION_MORE      0x01    /**< The operation remains armed and will produce more completions */
+#define CLARINET_URING_COMPLETION_BUFFER    0x02    /**< Data is stored in a provided buffer that must be released */
+
+struct clarinet_uring
+{
+    clarinet_socket_handle handle;  /**< System handle (read-only) */
+    void* context;                  /**< Implementation context (private) */
+};
+
+/**
+ * Completion based engine for socket I/O.
+ *
+ * @details A completion ring allows socket operations to be queued on caller-owned buffers and their results to be
+ * reaped in batches so that many operations can be performed with a single system call. Buffers, endpoints and sockets
+ * passed to an operation must remain valid and must not be modified until the completion of that operation is
+ * reaped. Must be initialized using @c clarinet_uring_init() before it can be used. Rings are not movable and not
+ * thread-safe.
+ *
+ * @note @b LINUX: Implemented with io_uring(7) and requires kernel 5.6 or newer. Availability is probed at run-time
+ * when the ring is opened so callers should fall back to the regular socket functions (or a @c clarinet_poller) if
+ * @c clarinet_uring_open() returns @c CLARINET_ENOTSUP.
+ *
+ * @note @b WINDOWS: Not supported. @c clarinet_uring_open() always returns @c CLARINET_ENOTSUP so every other
+ * function fails the validation of the ring.
+ *
+ * @note Not supported on other platforms.
+ */
+typedef struct clarinet_uring clarinet_uring;
+
+struct clarinet_uring_completion
+{
+    void* data;                 /**< User data associated with the operation when it was queued. */
+    int result;                 /**< Result of the operation with the same semantics of the equivalent socket function. */
+    uint16_t flags;             /**< Completion flags. */
+    uint16_t buffer;            /**< Identifier of the provided buffer. Only valid with CLARINET_URING_COMPLETION_BUFFER. */
+    void* buf;                  /**< Data stored in the provided buffer. Only valid with CLARINET_URING_COMPLETION_BUFFER. */
+    clarinet_endpoint remote;   /**< Source endpoint. Only valid with CLARINET_URING_COMPLETION_BUFFER. */
+};
+
+/** Data structure used to report the completion of an operation queued in a completion ring. */
+typedef struct clarinet_uring_completion clarinet_uring_completion;
+
+/**
+ * Initialize a completion ring structure.
+ *
+ * @param [in] ur Ring pointer
+ *
+ * @details The memory pointed to by @p ur must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_uring_init(clarinet_uring* ur);
+
+/**
+ * Create a new completion ring.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] entries Maximum number of operations that may be queued before a submission. It is rounded up to the
+ * next power of 2. The ring accepts up to twice as many operations in-flight.
+ *
+ * @return @c CLARINET_ENONE on success or one of the following negative error codes:
+ * @return @c CLARINET_EINVAL: @p ur is NULL, already open or @p entries is zero or greater than 4096.
+ * @return @c CLARINET_ENOTSUP: The library was built without io_uring support, the system does not support io_uring
+ * or one of the required operations is not supported by the running kernel.
+ * @return @c CLARINET_EMFILE
+ * @return @c CLARINET_ENOMEM
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_open(clarinet_uring* ur,
+                    uint32_t entries);
+
+/**
+ * Close the completion ring.
+ *
+ * @param [in] ur Ring pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ *
+ * @details Operations still in-flight are cancelled and their completions discarded. This function only returns after
+ * the system has released every in-flight operation so buffers may be safely reused. Sockets accepted by a discarded
+ * completion are closed. On success this function reinitializes the structure pointed to by @p ur.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_close(clarinet_uring* ur);
+
+/**
+ * Queue a receive operation on a connected socket.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [out] buf Buffer to store the data received.
+ * @param [in] buflen Length of @p buf in bytes.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the same that would be returned by @c clarinet_socket_recv().
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_recv(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    void* restrict buf,
+                    size_t buflen,
+                    void* data);
+
+/**
+ * Queue a receive operation that also reports the source endpoint.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [out] buf Buffer to store the data received.
+ * @param [in] buflen Length of @p buf in bytes.
+ * @param [out] remote Endpoint to store the source address and port on completion.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the same that would be returned by @c clarinet_socket_recvfrom()
+ * including @c CLARINET_EMSGSIZE for truncated datagrams.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_recvfrom(clarinet_uring* restrict ur,
+                        clarinet_socket* restrict sp,
+                        void* restrict buf,
+                        size_t buflen,
+                        clarinet_endpoint* restrict remote,
+                        void* data);
+
+/**
+ * Queue a send operation on a connected socket.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [in] buf Buffer with the data to send.
+ * @param [in] buflen Length of @p buf in bytes.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the number of bytes sent or a negative error code that would be
+ * returned by @c clarinet_socket_send().
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_send(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    const void* restrict buf,
+                    size_t buflen,
+                    void* data);
+
+/**
+ * Queue a send operation to a specific destination.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [in] buf Buffer with the data to send.
+ * @param [in] buflen Length of @p buf in bytes.
+ * @param [in] remote Destination endpoint. It is copied so it does not have to remain valid after this call.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EAFNOSUPPORT: The family of @p remote is not supported.
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the same that would be returned by @c clarinet_socket_sendto().
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_sendto(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp,
+                      const void* restrict buf,
+                      size_t buflen,
+                      const clarinet_endpoint* restrict remote,
+                      void* data);
+
+/**
+ * Queue an accept operation on a listening socket.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] ssp Server socket pointer
+ * @param [out] csp Client socket pointer to store the accepted connection. Must be initialized and not open.
+ * @param [out] remote Endpoint to store the client address and port on completion.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the same that would be returned by @c clarinet_socket_accept(). The
+ * client socket is only modified by a successful completion.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_accept(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict ssp,
+                      clarinet_socket* restrict csp,
+                      clarinet_endpoint* restrict remote,
+                      void* data);
+
+/**
+ * Queue a connect operation.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [in] remote Destination endpoint. It is copied so it does not have to remain valid after this call.
+ * @param [in] data User data reported with the completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EAFNOSUPPORT: The family of @p remote is not supported.
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details The result reported on completion is the same that would be returned by @c clarinet_socket_connect() on a
+ * blocking socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_connect(clarinet_uring* restrict ur,
+                       clarinet_socket* restrict sp,
+                       const clarinet_endpoint* restrict remote,
+                       void* data);
+
+/**
+ * Register a group of buffers that the system can select from to store data received by a multishot operation.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] group Group identifier. Must be less than @c CLARINET_URING_GROUPS_MAX.
+ * @param [in] buf Memory to be split in @p count buffers of @p bufsize bytes.
+ * @param [in] bufsize Size of each buffer in bytes. Must be greater than @c CLARINET_URING_BUFFER_OVERHEAD.
+ * @param [in] count Number of buffers. Must be a power of 2 no greater than 32768.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EALREADY: The group is already registered.
+ * @return @c CLARINET_ENOTSUP: The system does not support provided buffer rings.
+ * @return @c CLARINET_ENOMEM
+ *
+ * @details Buffers are identified by their index in @p buf and are all initially available. Once the system selects a
+ * buffer it is only made available again by @c clarinet_uring_release(). The memory pointed to by @p buf must remain
+ * valid until the ring is closed. Groups are unregistered when the ring is closed.
+ *
+ * @note @b LINUX: Requires kernel 5.19 or newer.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_provide(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       void* restrict buf,
+                       size_t bufsize,
+                       uint16_t count);
+
+/**
+ * Return a provided buffer to its group so the system can select it again.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] group Group identifier.
+ * @param [in] buffer Buffer identifier reported by a completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL: An argument is invalid or the buffer is not held by the caller (e.g. it was already
+ * released).
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_release(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       uint16_t buffer);
+
+/**
+ * Queue a multishot receive operation that stores every datagram received in a buffer selected from a group.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ * @param [in] group Group of provided buffers.
+ * @param [in] data User data reported with every completion.
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: The library was built without multishot support.
+ * @return @c CLARINET_ENOBUFS: Too many operations in-flight. Reap completions and try again.
+ *
+ * @details A single operation produces one completion per datagram with the flags @c CLARINET_URING_COMPLETION_MORE
+ * and @c CLARINET_URING_COMPLETION_BUFFER, the number of bytes received as result plus the buffer identifier, the
+ * data and the source endpoint. A datagram larger than @c bufsize - @c CLARINET_URING_BUFFER_OVERHEAD is reported
+ * with @c CLARINET_EMSGSIZE but the buffer still has to be released. The operation terminates with a completion
+ * without @c CLARINET_URING_COMPLETION_MORE, normally reporting @c CLARINET_ENOBUFS if all buffers of the group are
+ * in use, in which case it must be queued again after buffers are released. The system also terminates the operation
+ * when the completion queue is full, in which case the last completion may carry a datagram.
+ *
+ * @note @b LINUX: Requires kernel 6.0 or newer. On older kernels the first completion reports @c CLARINET_EINVAL.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_recvfrom_multishot(clarinet_uring* restrict ur,
+                                  clarinet_socket* restrict sp,
+                                  uint16_t group,
+                                  void* data);
+
+/**
+ * Cancel all operations in-flight on a socket.
+ *
+ * @param [in] ur Ring pointer
+ * @param [in] sp Socket pointer
+ *
+ * @return @c CLARINET_ENONE on success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTSUP: The library was built without multishot support.
+ * @return @c CLARINET_ENOBUFS: Too many operations queued. Submit or reap completions and try again.
+ *
+ * @details Cancellation is asynchronous. Each operation cancelled still produces a final completion reporting
+ * @c CLARINET_EINTR (or its result if it completed in the meantime). This is the only way to terminate a multishot
+ * operation short of closing the ring.
+ *
+ * @note @b LINUX: Requires kernel 5.19 or newer.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_cancel(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp);
+
+/**
+ * Submit all queued operations to the system.
+ *
+ * @param [in] ur Ring pointer
+ *
+ * @return @c N >= 0 Number of operations submitted.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EINTR
+ * @return @c CLARINET_ENOMEM
+ * @return @c CLARINET_EAGAIN: The completion queue overflowed and the system does not accept new operations until
+ * completions are reaped with @c clarinet_uring_wait().
+ *
+ * @details Calling this function is optional since @c clarinet_uring_wait() also submits pending operations but it
+ * may be used to start operations early.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_submit(clarinet_uring* ur);
+
+/**
+ * Submit queued operations and wait for completions.
+ *
+ * @param [in] ur Ring pointer
+ * @param [out] completions Array to store the completions reaped.
+ * @param [in] count Number of elements in the @p completions array.
+ * @param [in] timeout Number of milliseconds that the function should block waiting for a completion. A negative value
+ * means an infinite timeout and zero returns immediately.
+ *
+ * @return @c N >= 0 Number of completions stored in @p completions. Zero indicates the timeout expired.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_EINTR
+ *
+ * @details Completions are reported in the order they are produced by the system which is not necessarily the order
+ * in which operations were queued. At most @p count completions are reaped per call and the remaining are kept for
+ * the next. Returns immediately if there are no operations in-flight regardless of @p timeout.
+ */
+CLARINET_EXTERN
+int
+clarinet_uring_wait(clarinet_uring* restrict ur,
+                    clarinet_uring_completion* restrict completions,
+                    size_t count,
+                    int timeout);
+
+/* endregion */
+
+/* region DTLC */
+
+#define CLARINET_DTLC_SECRET_SIZE           16      /**< Size in bytes of the secret used to sign handshake cookies */
+#define CLARINET_DTLC_CAPACITY_MAX          65536   /**< Maximum number of connections per endpoint */
+#define CLARINET_DTLC_HEADER_SIZE           5       /**< Size in bytes of the header prepended to every datagram */
+#define CLARINET_DTLC_BUFFER_MIN            16      /**< Minimum size in bytes of a receive buffer */
+
+#define CLARINET_DTLC_NONE                  0x00    /**< None */
+#define CLARINET_DTLC_LISTEN                0x01    /**< Accept incoming connections */
+
+#define CLARINET_DTLC_EVENT_NONE            0       /**< No event. A control datagram was consumed or discarded. */
+#define CLARINET_DTLC_EVENT_CONNECT         1       /**< A connection was established */
+#define CLARINET_DTLC_EVENT_DISCONNECT      2       /**< A connection was terminated */
+#define CLARINET_DTLC_EVENT_DATA            3       /**< Data was received on a connection */
+
+#define CLARINET_DTLC_STATE_FREE            0       /**< Connection slot is free */
+#define CLARINET_DTLC_STATE_HELLO           1       /**< Waiting for a cookie from the remote peer */
+#define CLARINET_DTLC_STATE_COOKIE          2       /**< Waiting for the remote peer to accept the cookie */
+#define CLARINET_DTLC_STATE_CONNECTED       3       /**< Connection established */
+
+struct clarinet_dtlc_config
+{
+    uint8_t secret[CLARINET_DTLC_SECRET_SIZE];  /**< Key used to sign handshake cookies. Should be random. */
+    uint32_t keepalive;                         /**< Milliseconds of send inactivity before a keepalive is sent */
+    uint32_t timeout;                           /**< Milliseconds of receive inactivity before a connection is lost */
+    uint32_t flags;                             /**< Combination of @c CLARINET_DTLC_* flags */
+};
+
+/** Data structure used to configure a DTLC endpoint. */
+typedef struct clarinet_dtlc_config clarinet_dtlc_config;
+
+struct clarinet_dtlc_connection
+{
+    clarinet_endpoint remote;       /**< Remote endpoint (read-only) */
+    uint64_t last_recv;             /**< Time of the last datagram received in milliseconds (read-only) */
+    uint64_t last_send;             /**< Time of the last datagram sent in milliseconds (read-only) */
+    void* data;                     /**< User data */
+    uint32_t local_id;              /**< Local connection identifier (read-only) */
+    uint32_t remote_id;             /**< Remote connection identifier (read-only) */
+    uint64_t cookie;                /**< Handshake cookie (private) */
+    uint32_t timestamp;             /**< Handshake cookie timestamp (private) */
+    uint32_t bucket;                /**< Hash bucket (private) */
+    uint32_t next;                  /**< Next slot in a hash chain or in the free list (private) */
+    uint32_t active_prev;           /**< Previous slot in the list of slots in use (private) */
+    uint32_t active_next;           /**< Next slot in the list of slots in use (private) */
+    uint16_t generation;            /**< Slot generation (private) */
+    uint8_t state;                  /**< Connection state (read-only) */
+    uint8_t rffu CLARINET_UNUSED;
+};
+
+/**
+ * Virtual connection of a DTLC endpoint.
+ *
+ * @details Connection slots are provided by the caller when the endpoint is opened. A connection is identified by a
+ * 32-bit identifier that combines the index of its slot (low 16 bits) with a generation counter (high 16 bits) so stale
+ * identifiers of previous connections that used the same slot are rejected.
+ */
+typedef struct clarinet_dtlc_connection clarinet_dtlc_connection;
+
+/** Returns the index of the connection slot identified by the connection identifier @p id. */
+#define clarinet_dtlc_slot(id)              ((uint32_t)(id) & 0xFFFF)
+
+struct clarinet_dtlc_event
+{
+    uint32_t id;                    /**< Local identifier of the connection */
+    uint16_t type;                  /**< Event type (@c CLARINET_DTLC_EVENT_*) */
+    int result;                     /**< Number of bytes received for DATA or the reason (error code) for DISCONNECT */
+};
+
+/** Data structure used to report an event of a DTLC endpoint. */
+typedef struct clarinet_dtlc_event clarinet_dtlc_event;
+
+struct clarinet_dtlc
+{
+    clarinet_socket* socket;                /**< Underlying UDP socket (read-only) */
+    clarinet_dtlc_connection* connections;  /**< Connection slots (read-only) */
+    uint32_t capacity;                      /**< Number of connection slots (read-only) */
+    uint32_t count;                         /**< Number of connection slots in use (read-only) */
+    uint32_t free;                          /**< Head of the free list (private) */
+    uint32_t active;                        /**< Head of the list of slots in use (private) */
+    clarinet_dtlc_config config;            /**< Configuration (read-only) */
+};
+
+/**
+ * Datagram Transport Layer Connectivity endpoint.
+ *
+ * @details DTLC is a lightweight connection layer over UDP. A single UDP socket serves many virtual connections. Every
+ * datagram carries the identifier the receiver assigned to the connection so demultiplexing is a direct lookup of the
+ * connection slot regardless of the number of connections. Connections are established with a stateless cookie
+ * handshake so no state is allocated for a remote peer until it proves it can receive datagrams at its source address:
+ *
+ * @code
+ *      client                      server
+ *      HELLO(client id)    ---->
+ *                          <----   COOKIE(timestamp, cookie)
+ *      CONNECT(cookie)     ---->
+ *                          <----   ACCEPT(server id)
+ * @endcode
+ *
+ * HELLO is padded to the size of COOKIE so the handshake cannot be used for amplification. Established connections
+ * exchange keepalives when idle and are dropped after a timeout without any datagram received.
+ *
+ * The endpoint does not keep time. Every function that may send or expire a connection takes the current time in
+ * milliseconds from an arbitrary monotonic clock chosen by the caller. The endpoint does not own the socket either so
+ * it can be polled by the caller (e.g. with a @c clarinet_poller) and must be closed after the endpoint.
+ *
+ * Endpoints are not movable and not thread-safe.
+ *
+ * @note A datagram must come from the same remote endpoint that established the connection to be accepted. NAT
+ * rebinding causes the connection to time out.
+ */
+typedef struct clarinet_dtlc clarinet_dtlc;
+
+/**
+ * Initialize a DTLC endpoint structure.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ *
+ * @details The memory pointed to by @p dp must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_dtlc_init(clarinet_dtlc* dp);
+
+/**
+ * Open a DTLC endpoint.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] sp Open UDP socket. Should be non-blocking.
+ * @param [in] connections Array of connection slots
+ * @param [in] capacity Number of elements in the @p connections array. Must not exceed @c CLARINET_DTLC_CAPACITY_MAX.
+ * @param [in] config Configuration. Copied into the endpoint.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: Any argument is NULL or invalid, or the endpoint is already open.
+ *
+ * @details The socket and the array of connection slots must remain valid until the endpoint is closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_open(clarinet_dtlc* restrict dp,
+                   clarinet_socket* restrict sp,
+                   clarinet_dtlc_connection* restrict connections,
+                   uint32_t capacity,
+                   const clarinet_dtlc_config* restrict config);
+
+/**
+ * Close a DTLC endpoint.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p dp is NULL or not open.
+ *
+ * @details Established connections are dropped without notice to the remote peers. Call
+ * @c clarinet_dtlc_disconnect() first for a graceful termination. The socket is not closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_close(clarinet_dtlc* dp);
+
+/**
+ * Start a connection to a remote DTLC endpoint.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] remote Remote endpoint
+ * @param [in] now Current time in milliseconds
+ * @param [out] id Local identifier assigned to the connection
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: There are no free connection slots.
+ * @return Any error code that could be returned by @c clarinet_socket_sendto().
+ *
+ * @details The handshake completes asynchronously. A @c CLARINET_DTLC_EVENT_CONNECT event is reported by
+ * @c clarinet_dtlc_recv() once the connection is established or a @c CLARINET_DTLC_EVENT_DISCONNECT event is reported
+ * if the remote peer refuses the connection or the handshake times out.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_connect(clarinet_dtlc* restrict dp,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now,
+                      uint32_t* restrict id);
+
+/**
+ * Terminate a connection.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] id Local identifier of the connection
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p dp is NULL or not open.
+ * @return @c CLARINET_ENOTCONN: @p id does not identify a connection.
+ *
+ * @details The remote peer is notified on a best effort basis. The connection slot is released immediately and no
+ * event is reported for this connection.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_disconnect(clarinet_dtlc* dp,
+                         uint32_t id,
+                         uint64_t now);
+
+/**
+ * Get a connection.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] id Local identifier of the connection
+ *
+ * @return Pointer to the connection slot or NULL if @p id does not identify a connection.
+ */
+CLARINET_EXTERN
+clarinet_dtlc_connection*
+clarinet_dtlc_connection_find(clarinet_dtlc* dp,
+                              uint32_t id);
+
+/**
+ * Send data on an established connection.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] id Local identifier of the connection
+ * @param [in] buf Data to send
+ * @param [in] buflen Size in bytes of the data pointed to by @p buf
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of bytes of data sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify an established connection.
+ * @return Any error code that could be returned by @c clarinet_socket_sendtov().
+ *
+ * @details The header is gathered with the data so the data is not copied.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_send(clarinet_dtlc* restrict dp,
+                   uint32_t id,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now);
+
+/**
+ * Send data gathered from multiple buffers on an established connection.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [in] id Local identifier of the connection
+ * @param [in] iov Array of buffers with the data to send
+ * @param [in] iovcnt Number of elements in the @p iov array. Must be less than @c CLARINET_IOVEC_MAX.
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of bytes of data sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify an established connection.
+ * @return Any error code that could be returned by @c clarinet_socket_sendtov().
+ *
+ * @details Allows protocols layered on DTLC to prepend their own header without copying the data.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_sendv(clarinet_dtlc* restrict dp,
+                    uint32_t id,
+                    const clarinet_iovec* restrict iov,
+                    size_t iovcnt,
+                    uint64_t now);
+
+/**
+ * Receive and process a single datagram.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [out] buf Buffer to store the data received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf. Must be at least @c CLARINET_DTLC_BUFFER_MIN.
+ * @param [out] event Event produced by the datagram
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c CLARINET_ENONE: A datagram was processed. Check @p event for the outcome.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_recvfromv(). In particular @c CLARINET_EAGAIN
+ * when the socket is non-blocking and there are no more datagrams to receive.
+ *
+ * @details Handshake, keepalive and invalid datagrams produce a @c CLARINET_DTLC_EVENT_NONE event so this function
+ * should be called until it returns @c CLARINET_EAGAIN. Data is only stored in @p buf for
+ * @c CLARINET_DTLC_EVENT_DATA events and the header is never copied into it.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_recv(clarinet_dtlc* restrict dp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_dtlc_event* restrict event,
+                   uint64_t now);
+
+/**
+ * Perform periodic work: retransmit handshakes, send keepalives and expire connections.
+ *
+ * @param [in] dp DTLC endpoint pointer
+ * @param [out] events Array to store the disconnect events of expired connections
+ * @param [in] count Number of elements in the @p events array
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of events stored in @p events.
+ * @return @c CLARINET_EINVAL
+ *
+ * @details Should be called at least as often as the keepalive interval. When @p events is full the remaining
+ * expired connections are reported in subsequent calls. Only connection slots in use are visited so the cost of an
+ * update is proportional to the number of connections rather than the capacity.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtlc_update(clarinet_dtlc* restrict dp,
+                     clarinet_dtlc_event* restrict events,
+                     size_t count,
+                     uint64_t now);
+
+/* endregion */
+
+/* region GDTP */
+
+#define CLARINET_GDTP_CHANNEL_MAX           8       /**< Maximum number of channels per connection */
+#define CLARINET_GDTP_WINDOW                32      /**< Maximum number of reliable messages in flight per connection */
+#define CLARINET_GDTP_HEADER_SIZE           11      /**< Size in bytes of the header prepended to every message */
+
+#define CLARINET_GDTP_UNRELIABLE            0       /**< Messages may be lost, duplicated or reordered */
+#define CLARINET_GDTP_SEQUENCED             1       /**< Messages may be lost but never arrive after a newer message */
+#define CLARINET_GDTP_RELIABLE              2       /**< Messages are delivered exactly once in any order */
+#define CLARINET_GDTP_ORDERED               3       /**< Messages are delivered exactly once in the order sent */
+
+#define CLARINET_GDTP_EVENT_NONE            CLARINET_DTLC_EVENT_NONE        /**< No event */
+#define CLARINET_GDTP_EVENT_CONNECT         CLARINET_DTLC_EVENT_CONNECT     /**< A connection was established */
+#define CLARINET_GDTP_EVENT_DISCONNECT      CLARINET_DTLC_EVENT_DISCONNECT  /**< A connection was terminated */
+#define CLARINET_GDTP_EVENT_DATA            CLARINET_DTLC_EVENT_DATA        /**< A message was received */
+
+struct clarinet_gdtp_config
+{
+    uint8_t channels[CLARINET_GDTP_CHANNEL_MAX];    /**< Delivery guarantee of each channel (@c CLARINET_GDTP_*) */
+    uint32_t nchannels;                             /**< Number of channels in use */
+    uint32_t mtu;                                   /**< Maximum size in bytes of a message */
+    uint32_t rto;                                   /**< Minimum milliseconds before a reliable message is resent */
+    uint32_t ack_delay;                             /**< Milliseconds an ack may wait for data to piggyback on */
+};
+
+/** Data structure used to configure a GDTP endpoint. */
+typedef struct clarinet_gdtp_config clarinet_gdtp_config;
+
+struct clarinet_gdtp_message
+{
+    void* buf;                      /**< Slab of the packet pool holding the payload or NULL if unused (private) */
+    uint64_t sent;                  /**< Time of the last transmission in milliseconds (private) */
+    uint16_t seq;                   /**< Packet sequence number of the last transmission (private) */
+    uint16_t msgseq;                /**< Message sequence number in the channel (private) */
+    uint16_t len;                   /**< Size in bytes of the payload (private) */
+    uint8_t channel;                /**< Channel index (private) */
+    uint8_t transmissions;          /**< Number of transmissions (private) */
+};
+
+/** Reliable message waiting for an ack or for delivery in order. */
+typedef struct clarinet_gdtp_message clarinet_gdtp_message;
+
+struct clarinet_gdtp_channel
+{
+    uint64_t recv_bits;             /**< Messages received before @c recv_seq (private) */
+    uint16_t send_seq;              /**< Sequence number of the next message sent (private) */
+    uint16_t recv_seq;              /**< Last message received or next message expected if ordered (private) */
+    uint8_t rffu[4] CLARINET_UNUSED;
+};
+
+/** Sequencing state of a channel. */
+typedef struct clarinet_gdtp_channel clarinet_gdtp_channel;
+
+struct clarinet_gdtp_connection
+{
+    clarinet_gdtp_message sendq[CLARINET_GDTP_WINDOW];      /**< Reliable messages waiting for an ack (private) */
+    clarinet_gdtp_message recvq[CLARINET_GDTP_WINDOW];      /**< Ordered messages received early (private) */
+    clarinet_gdtp_channel channels[CLARINET_GDTP_CHANNEL_MAX];
+    uint64_t ack_time;              /**< Time the oldest packet not yet acknowledged was received (private) */
+    uint64_t retransmissions;       /**< Number of reliable messages resent (read-only) */
+    uint32_t id;                    /**< Local identifier of the DTLC connection or 0 if unused (read-only) */
+    uint32_t rtt;                   /**< Smoothed round trip time in milliseconds or 0 if unknown (read-only) */
+    uint32_t inflight;              /**< Number of reliable messages waiting for an ack (read-only) */
+    uint32_t recv_bits;             /**< Packets received before @c remote_seq (private) */
+    uint16_t local_seq;             /**< Sequence number of the next packet sent (private) */
+    uint16_t remote_seq;            /**< Most recent sequence number received (private) */
+    uint8_t ack_pending;            /**< Packets were received since acks were last sent (private) */
+    uint8_t rffu[3] CLARINET_UNUSED;
+};
+
+/**
+ * Per-connection state of a GDTP endpoint.
+ *
+ * @details An array of connections with as many elements as the DTLC endpoint has connection slots is provided by the
+ * caller when the GDTP endpoint is opened. The state of a connection is in the element with the same index as its
+ * DTLC connection slot.
+ */
+typedef struct clarinet_gdtp_connection clarinet_gdtp_connection;
+
+struct clarinet_gdtp_event
+{
+    uint32_t id;                    /**< Local identifier of the connection */
+    uint16_t type;                  /**< Event type (@c CLARINET_GDTP_EVENT_*) */
+    uint8_t channel;                /**< Channel the message was received on for DATA */
+    uint8_t rffu CLARINET_UNUSED;
+    int result;                     /**< Number of bytes received for DATA or the reason (error code) for DISCONNECT */
+};
+
+/** Data structure used to report an event of a GDTP endpoint. */
+typedef struct clarinet_gdtp_event clarinet_gdtp_event;
+
+struct clarinet_gdtp
+{
+    clarinet_dtlc* dtlc;                    /**< Underlying DTLC endpoint (read-only) */
+    clarinet_gdtp_connection* connections;  /**< Connection state (read-only) */
+    clarinet_packet_pool* pool;             /**< Pool for payloads of reliable messages (read-only) */
+    uint32_t backlog;                       /**< Slot plus one of a connection with messages to deliver (private) */
+    clarinet_gdtp_config config;            /**< Configuration (read-only) */
+};
+
+/**
+ * Game Data Transport Protocol endpoint.
+ *
+ * @details GDTP multiplexes up to @c CLARINET_GDTP_CHANNEL_MAX channels over the connections of a DTLC endpoint. Each
+ * channel has its own delivery guarantee so latency-sensitive state updates and reliable events can share the same
+ * connection without head-of-line blocking between them: a lost message only delays later messages of the same
+ * ordered channel.
+ *
+ * Every datagram carries its own packet sequence number plus the most recent sequence number received from the remote
+ * peer and a 32-bit bitfield acknowledging the 32 packets before it:
+ *
+ * @code
+ *      seq:16 | ack:16 | ack bits:32 | channel:8 | message seq:16 | payload
+ * @endcode
+ *
+ * Acks are thus piggybacked on regular traffic and each one is repeated in up to 33 datagrams so the loss of a few
+ * datagrams loses no acks. A datagram with only acks is sent when there is nothing to send for @c ack_delay
+ * milliseconds. Reliable messages are kept in slabs of a @c clarinet_packet_pool until acknowledged and resent after
+ * the larger of @c rto and twice the smoothed round trip time. Reliable ordered messages that arrive early are kept in
+ * slabs of the same pool until they can be delivered.
+ *
+ * Connections must be established and terminated through the GDTP endpoint. The DTLC endpoint may not be used
+ * directly while the GDTP endpoint is open.
+ *
+ * Endpoints are not movable and not thread-safe.
+ */
+typedef struct clarinet_gdtp clarinet_gdtp;
+
+/**
+ * Initialize a GDTP endpoint structure.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ *
+ * @details The memory pointed to by @p gp must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_gdtp_init(clarinet_gdtp* gp);
+
+/**
+ * Open a GDTP endpoint.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [in] dp Open DTLC endpoint
+ * @param [in] connections Array of connection states with as many elements as @p dp has connection slots
+ * @param [in] pool Open packet pool with slabs of at least @c mtu bytes
+ * @param [in] config Configuration. Copied into the endpoint.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: Any argument is NULL or invalid, or the endpoint is already open.
+ *
+ * @details The DTLC endpoint, the array of connections and the pool must remain valid until the endpoint is closed.
+ * The pool may be shared with other endpoints.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_open(clarinet_gdtp* restrict gp,
+                   clarinet_dtlc* restrict dp,
+                   clarinet_gdtp_connection* restrict connections,
+                   clarinet_packet_pool* restrict pool,
+                   const clarinet_gdtp_config* restrict config);
+
+/**
+ * Close a GDTP endpoint.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p gp is NULL or not open.
+ *
+ * @details All slabs held by the endpoint are returned to the pool. The DTLC endpoint is not closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_close(clarinet_gdtp* gp);
+
+/**
+ * Start a connection to a remote GDTP endpoint.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [in] remote Remote endpoint
+ * @param [in] now Current time in milliseconds
+ * @param [out] id Local identifier assigned to the connection
+ *
+ * @return Same as @c clarinet_dtlc_connect().
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_connect(clarinet_gdtp* restrict gp,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now,
+                      uint32_t* restrict id);
+
+/**
+ * Terminate a connection.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [in] id Local identifier of the connection
+ * @param [in] now Current time in milliseconds
+ *
+ * @return Same as @c clarinet_dtlc_disconnect().
+ *
+ * @details Reliable messages not yet acknowledged are discarded.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_disconnect(clarinet_gdtp* gp,
+                         uint32_t id,
+                         uint64_t now);
+
+/**
+ * Send a message on a channel of an established connection.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [in] id Local identifier of the connection
+ * @param [in] channel Channel index
+ * @param [in] buf Message to send
+ * @param [in] buflen Size in bytes of the message. Must not exceed the configured @c mtu.
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of bytes of the message sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify an established connection.
+ * @return @c CLARINET_EAGAIN: The channel is reliable and @c CLARINET_GDTP_WINDOW messages are waiting for an ack.
+ * @return @c CLARINET_ENOBUFS: The channel is reliable and the pool has no free slabs.
+ * @return Any error code that could be returned by @c clarinet_dtlc_sendv() if the channel is unreliable.
+ *
+ * @details A reliable message is copied into a slab of the pool before it is sent so it is accepted even if the
+ * socket cannot send at the moment. It will be resent later. Unreliable messages are not copied.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_send(clarinet_gdtp* restrict gp,
+                   uint32_t id,
+                   uint8_t channel,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now);
+
+/**
+ * Receive and process a single datagram.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [out] buf Buffer to store the message received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf. Must be at least the configured @c mtu plus
+ * @c CLARINET_GDTP_HEADER_SIZE.
+ * @param [out] event Event produced by the datagram
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c CLARINET_ENONE: A datagram was processed. Check @p event for the outcome.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_dtlc_recv(). In particular @c CLARINET_EAGAIN when the
+ * socket is non-blocking and there are no more datagrams to receive.
+ *
+ * @details Should be called until it returns @c CLARINET_EAGAIN. When a missing ordered message arrives the messages
+ * received after it are returned by subsequent calls before another datagram is read from the socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_recv(clarinet_gdtp* restrict gp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_gdtp_event* restrict event,
+                   uint64_t now);
+
+/**
+ * Perform periodic work: resend reliable messages, send pending acks and keepalives, and expire connections.
+ *
+ * @param [in] gp GDTP endpoint pointer
+ * @param [out] events Array to store the disconnect events of expired connections
+ * @param [in] count Number of elements in the @p events array
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of events stored in @p events.
+ * @return @c CLARINET_EINVAL
+ *
+ * @details Should be called at least every @c ack_delay milliseconds.
+ */
+CLARINET_EXTERN
+int
+clarinet_gdtp_update(clarinet_gdtp* restrict gp,
+                     clarinet_gdtp_event* restrict events,
+                     size_t count,
+                     uint64_t now);
+
+/* endregion */
+
+/* region DTLS */
+
+#define CLARINET_DTLS_CAPACITY_MAX          65536   /**< Maximum number of sessions per endpoint */
+#define CLARINET_DTLS_PENDING_DEFAULT       4       /**< Default maximum number of handshakes per source address */
+
+#define CLARINET_DTLS_EVENT_NONE            0       /**< No event. A handshake or invalid datagram was consumed. */
+#define CLARINET_DTLS_EVENT_CONNECT         1       /**< A session was established */
+#define CLARINET_DTLS_EVENT_DISCONNECT      2       /**< A session was terminated */
+#define CLARINET_DTLS_EVENT_DATA            3       /**< Data was received on a session */
+
+struct clarinet_dtls_cache
+{
+    void* context;                  /**< Implementation context (private) */
+};
+
+/**
+ * Session resumption cache shared by DTLS endpoints.
+ *
+ * @details Holds the sessions of recently connected clients and the keys used to protect session tickets so a client
+ * that reconnects to any endpoint using the same cache can resume its session with an abbreviated handshake that
+ * skips all asymmetric cryptography. Must be initialized using @c clarinet_dtls_cache_init() before it can be used.
+ *
+ * @note A cache may only be shared between endpoints used by different threads if MbedTLS was built with
+ * @c MBEDTLS_THREADING_C.
+ */
+typedef struct clarinet_dtls_cache clarinet_dtls_cache;
+
+struct clarinet_dtls_config
+{
+    const uint8_t* cert;            /**< Certificate chain in PEM (including the terminating null) or DER format */
+    size_t certlen;                 /**< Size in bytes of the memory pointed to by @c cert */
+    const uint8_t* key;             /**< Private key in PEM (including the terminating null) or DER format */
+    size_t keylen;                  /**< Size in bytes of the memory pointed to by @c key */
+    clarinet_dtls_cache* cache;     /**< Session resumption cache or NULL to disable resumption */
+    uint32_t capacity;              /**< Maximum number of sessions */
+    uint32_t retry_min;             /**< Initial handshake retransmission timeout in milliseconds */
+    uint32_t retry_max;             /**< Maximum handshake retransmission timeout in milliseconds */
+    uint32_t timeout;               /**< Milliseconds of receive inactivity before a session is dropped */
+    uint32_t pending;               /**< Maximum number of handshakes per source address or 0 for the default */
+};
+
+/** Data structure used to configure a DTLS endpoint. */
+typedef struct clarinet_dtls_config clarinet_dtls_config;
+
+struct clarinet_dtls_event
+{
+    uint32_t id;                    /**< Local identifier of the session */
+    uint16_t type;                  /**< Event type (@c CLARINET_DTLS_EVENT_*) */
+    int result;                     /**< Number of bytes received for DATA or the reason (error code) for DISCONNECT */
+};
+
+/** Data structure used to report an event of a DTLS endpoint. */
+typedef struct clarinet_dtls_event clarinet_dtls_event;
+
+struct clarinet_dtls
+{
+    clarinet_socket* socket;        /**< Underlying UDP socket (read-only) */
+    void* context;                  /**< Implementation context (private) */
+    uint32_t count;                 /**< Number of sessions established or in handshake (read-only) */
+    uint64_t handshakes;            /**< Number of handshakes completed (read-only) */
+    uint64_t resumptions;           /**< Number of handshakes completed that resumed a session (read-only) */
+};
+
+/**
+ * DTLS 1.2 server endpoint.
+ *
+ * @details A DTLS endpoint serves many clients on a single UDP socket. Datagrams are demultiplexed by source endpoint.
+ * Clients must answer a HelloVerifyRequest cookie before any per-client state is allocated so spoofed handshakes cost
+ * a single stateless reply. Sessions can be resumed through a shared @c clarinet_dtls_cache (by session id or session
+ * ticket) in which case the handshake requires no asymmetric cryptography. The ratio between @c resumptions and
+ * @c handshakes measures the resumption hit rate.
+ *
+ * A session only takes a slot once the client returned a valid cookie, which proves it can receive datagrams at its
+ * source address. A host can still open handshakes from many ports so the number of sessions in handshake per source
+ * address is limited by @c clarinet_dtls_config.pending. Handshakes beyond the limit are ignored until one of the
+ * pending handshakes completes or expires.
+ *
+ * Like @c clarinet_dtlc, the endpoint does not keep time. Functions that may send or expire a session take the current
+ * time in milliseconds from an arbitrary monotonic clock chosen by the caller. The endpoint does not own the socket
+ * which must be closed after the endpoint. Endpoints are not movable and not thread-safe.
+ *
+ * @note Implemented with MbedTLS. Returns @c CLARINET_ENOTSUP if the library was built without it.
+ */
+typedef struct clarinet_dtls clarinet_dtls;
+
+/**
+ * Initialize a DTLS session cache structure.
+ *
+ * @param [in] cache Cache pointer
+ *
+ * @details The memory pointed to by @p cache must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_dtls_cache_init(clarinet_dtls_cache* cache);
+
+/**
+ * Open a DTLS session cache.
+ *
+ * @param [in] cache Cache pointer
+ * @param [in] entries Maximum number of sessions cached
+ * @param [in] lifetime Seconds a cached session (or ticket) remains valid for resumption
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or already open, or @p entries or @p lifetime is 0.
+ * @return @c CLARINET_ENOMEM: Not enough memory.
+ * @return @c CLARINET_ENOTSUP: DTLS is not supported.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_cache_open(clarinet_dtls_cache* cache,
+                         uint32_t entries,
+                         uint32_t lifetime);
+
+/**
+ * Close a DTLS session cache.
+ *
+ * @param [in] cache Cache pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p cache is NULL or not open.
+ *
+ * @details All endpoints using the cache must be closed first.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_cache_close(clarinet_dtls_cache* cache);
+
+/**
+ * Initialize a DTLS endpoint structure.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ *
+ * @details The memory pointed to by @p dp must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_dtls_init(clarinet_dtls* dp);
+
+/**
+ * Open a DTLS endpoint.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [in] sp Open UDP socket. Should be non-blocking.
+ * @param [in] config Configuration. The certificate and key are parsed and need not remain valid after the call.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: Any argument is NULL or invalid, the endpoint is already open or the certificate or key
+ * cannot be parsed.
+ * @return @c CLARINET_ENOMEM: Not enough memory.
+ * @return @c CLARINET_ENOTSUP: DTLS is not supported.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_open(clarinet_dtls* restrict dp,
+                   clarinet_socket* restrict sp,
+                   const clarinet_dtls_config* restrict config);
+
+/**
+ * Close a DTLS endpoint.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p dp is NULL or not open.
+ *
+ * @details Sessions are dropped without notice to the clients. Call @c clarinet_dtls_disconnect() first for a graceful
+ * termination. The socket is not closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_close(clarinet_dtls* dp);
+
+/**
+ * Terminate a session.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [in] id Local identifier of the session
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p dp is NULL or not open.
+ * @return @c CLARINET_ENOTCONN: @p id does not identify a session.
+ *
+ * @details A close notification is sent on a best effort basis. No event is reported for this session.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_disconnect(clarinet_dtls* dp,
+                         uint32_t id,
+                         uint64_t now);
+
+/**
+ * Get the remote endpoint of a session.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [in] id Local identifier of the session
+ * @param [out] remote Remote endpoint
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify a session.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_remote_endpoint(clarinet_dtls* restrict dp,
+                              uint32_t id,
+                              clarinet_endpoint* restrict remote);
+
+/**
+ * Send data on an established session.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [in] id Local identifier of the session
+ * @param [in] buf Data to send
+ * @param [in] buflen Size in bytes of the data pointed to by @p buf
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of bytes of data sent.
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify an established session.
+ * @return @c CLARINET_EMSGSIZE: @p buflen exceeds the maximum record size.
+ * @return @c CLARINET_EAGAIN: The socket cannot send without blocking.
+ * @return @c CLARINET_EPROTO: Any other failure.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_send(clarinet_dtls* restrict dp,
+                   uint32_t id,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now);
+
+/**
+ * Receive and process a single datagram.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [out] buf Buffer to store the decrypted data received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [out] event Event produced by the datagram
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c CLARINET_ENONE: A datagram was processed. Check @p event for the outcome.
+ * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom(). In particular @c CLARINET_EAGAIN
+ * when the socket is non-blocking and there are no more datagrams to receive.
+ *
+ * @details Should be called until it returns @c CLARINET_EAGAIN. A datagram may carry more than one record in which
+ * case the following records are returned by subsequent calls before another datagram is read from the socket.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_recv(clarinet_dtls* restrict dp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_dtls_event* restrict event,
+                   uint64_t now);
+
+/**
+ * Perform periodic work: retransmit handshake flights and expire sessions.
+ *
+ * @param [in] dp DTLS endpoint pointer
+ * @param [out] events Array to store the disconnect events of expired sessions
+ * @param [in] count Number of elements in the @p events array
+ * @param [in] now Current time in milliseconds
+ *
+ * @return @c N >= 0 Number of events stored in @p events.
+ * @return @c CLARINET_EINVAL
+ *
+ * @details When @p events is full the remaining sessions are visited by subsequent calls, which resume where the
+ * previous call stopped. Only session slots in use are visited so the cost of an update is proportional to the number
+ * of sessions rather than the capacity.
+ */
+CLARINET_EXTERN
+int
+clarinet_dtls_update(clarinet_dtls* restrict dp,
+                     clarinet_dtls_event* restrict events,
+                     size_t count,
+                     uint64_t now);
+
+/* endregion */
+
+/* region ENet */
+
+#define CLARINET_ENET_CAPACITY_MAX          4095    /**< Maximum number of peers (ENet peer ids have 12 bits) */
+#define CLARINET_ENET_CHANNEL_MAX           16      /**< Maximum number of channels per peer */
+#define CLARINET_ENET_WINDOW                64      /**< Maximum number of reliable commands in flight per peer */
+#define CLARINET_ENET_MTU_MIN               576     /**< Minimum MTU accepted by ENet */
+#define CLARINET_ENET_MTU_MAX               4096    /**< Maximum MTU accepted by ENet */
+#define CLARINET_ENET_MTU_DEFAULT           1392    /**< Default MTU of ENet */
+
+#define CLARINET_ENET_NONE                  0x00    /**< None */
+#define CLARINET_ENET_LISTEN                0x01    /**< Accept incoming connections */
+
+#define CLARINET_ENET_UNRELIABLE            0x00    /**< Send unreliable (but sequenced) */
+#define CLARINET_ENET_RELIABLE              0x01    /**< Send reliable and ordered (ENET_PACKET_FLAG_RELIABLE) */
+#define CLARINET_ENET_UNSEQUENCED           0x02    /**< Send unsequenced (ENET_PACKET_FLAG_UNSEQUENCED) */
+
+#define CLARINET_ENET_EVENT_NONE            0       /**< No event */
+#define CLARINET_ENET_EVENT_CONNECT         1       /**< A peer connected */
+#define CLARINET_ENET_EVENT_DISCONNECT      2       /**< A peer disconnected */
+#define CLARINET_ENET_EVENT_DATA            3       /**< A message was received from a peer */
+
+#define CLARINET_ENET_STATE_FREE            0       /**< Peer slot is free */
+#define CLARINET_ENET_STATE_CONNECTING      1       /**< Waiting for the remote host to verify the connection */
+#define CLARINET_ENET_STATE_ACKNOWLEDGING   2       /**< Waiting for the remote host to acknowledge the verification */
+#define CLARINET_ENET_STATE_CONNECTED       3       /**< Connection established */
+
+struct clarinet_enet_config
+{
+    uint32_t mtu;                   /**< Maximum size in bytes of a datagram (@c CLARINET_ENET_MTU_MIN to MAX) */
+    uint32_t channels;              /**< Maximum number of channels of a peer (1 to @c CLARINET_ENET_CHANNEL_MAX) */
+    uint32_t rto;                   /**< Minimum milliseconds before a reliable command is resent */
+    uint32_t ping;                  /**< Milliseconds of send inactivity before a ping is sent */
+    uint32_t timeout;               /**< Milliseconds of receive inactivity before a peer is lost */
+    uint32_t flags;                 /**< Combination of @c CLARINET_ENET_* host flags */
+};
+
+/** Data structure used to configure an ENet host. */
+typedef struct clarinet_enet_config clarinet_enet_config;
+
+struct clarinet_enet_command
+{
+    void* buf;                      /**< Slab of the packet pool holding the command or NULL if unused (private) */
+    uint64_t sent;                  /**< Time of the last transmission in milliseconds (private) */
+    uint32_t offset;                /**< Offset of a fragment in its message (private) */
+    uint32_t total;                 /**< Size in bytes of the message of a fragment (private) */
+    uint16_t len;                   /**< Size in bytes of the data in the slab (private) */
+    uint16_t rsn;                   /**< Reliable sequence number (private) */
+    uint16_t count;                 /**< Number of fragments of the message of a fragment (private) */
+    uint8_t channel;                /**< Channel identifier (private) */
+    uint8_t command;                /**< Command number (private) */
+    uint8_t transmissions;          /**< Number of transmissions (private) */
+    uint8_t rffu[7] CLARINET_UNUSED;
+};
+
+/** Reliable command waiting for an acknowledgement or for delivery in order. */
+typedef struct clarinet_enet_command clarinet_enet_command;
+
+struct clarinet_enet_ack
+{
+    uint16_t rsn;                   /**< Reliable sequence number acknowledged (private) */
+    uint16_t sent_time;             /**< Sent time of the datagram that carried the command (private) */
+    uint8_t channel;                /**< Channel identifier (private) */
+    uint8_t rffu CLARINET_UNUSED;
+};
+
+/** Acknowledgement waiting to be sent. */
+typedef struct clarinet_enet_ack clarinet_enet_ack;
+
+struct clarinet_enet_channel
+{
+    uint16_t outgoing_reliable;     /**< Last reliable sequence number sent (private) */
+    uint16_t outgoing_unreliable;   /**< Last unreliable sequence number sent (private) */
+    uint16_t incoming_reliable;     /**< Last reliable sequence number delivered (private) */
+    uint16_t incoming_unreliable;   /**< Last unreliable sequence number delivered (private) */
+};
+
+/** Sequencing state of a channel. */
+typedef struct clarinet_enet_channel clarinet_enet_channel;
+
+struct clarinet_enet_peer
+{
+    clarinet_enet_command sendq[CLARINET_ENET_WINDOW];      /**< Reliable commands waiting for an ack (private) */
+    clarinet_enet_command recvq[CLARINET_ENET_WINDOW];      /**< Reliable commands received early (private) */
+    clarinet_enet_ack acks[CLARINET_ENET_WINDOW];           /**< Acks waiting to be sent (private) */
+    clarinet_enet_channel channels[CLARINET_ENET_CHANNEL_MAX];
+    uint32_t unsequenced_window[32];                        /**< Unsequenced groups received (private) */
+    clarinet_endpoint remote;       /**< Remote endpoint (read-only) */
+    uint64_t last_recv;             /**< Time of the last datagram received in milliseconds (read-only) */
+    uint64_t last_send;             /**< Time of the last datagram sent in milliseconds (read-only) */
+    uint64_t retransmissions;       /**< Number of reliable commands resent (read-only) */
+    uint32_t id;                    /**< Local peer identifier (read-only) */
+    uint32_t connect_id;            /**< Connection identifier chosen by the connecting side (read-only) */
+    uint32_t data;                  /**< Data sent by the remote host with its connection request (read-only) */
+    uint32_t mtu;                   /**< Negotiated MTU (read-only) */
+    uint32_t rtt;                   /**< Smoothed round trip time in milliseconds or 0 if unknown (read-only) */
+    uint32_t inflight;              /**< Number of reliable commands waiting for an ack (read-only) */
+    uint32_t held;                  /**< Number of reliable commands received early (private) */
+    uint32_t nacks;                 /**< Number of acks waiting to be sent (private) */
+    uint32_t bucket;                /**< Hash bucket (private) */
+    uint32_t next;                  /**< Next slot in a hash chain or in the free list (private) */
+    uint32_t active_prev;           /**< Previous slot in the list of slots in use (private) */
+    uint32_t active_next;           /**< Next slot in the list of slots in use (private) */
+    uint16_t outgoing_peer_id;      /**< Peer id assigned by the remote host (private) */
+    uint16_t outgoing_reliable;     /**< Last reliable sequence number sent on the system channel (private) */
+    uint16_t outgoing_unsequenced;  /**< Last unsequenced group sent (private) */
+    uint16_t incoming_unsequenced;  /**< Base of the window of unsequenced groups received (private) */
+    uint16_t generation;            /**< Slot generation (private) */
+    uint8_t incoming_session;       /**< Session id expected from the remote host (private) */
+    uint8_t outgoing_session;       /**< Session id sent to the remote host (private) */
+    uint8_t channel_count;          /**< Number of channels negotiated (read-only) */
+    uint8_t state;                  /**< Peer state (read-only) */
+    uint8_t rffu[2] CLARINET_UNUSED;
+};
+
+/**
+ * Peer of an ENet host.
+ *
+ * @details Peer slots are provided by the caller when the host is opened. A peer is identified by a 32-bit identifier
+ * that combines the index of its slot (low 16 bits), which is also the peer id seen by the remote host, with a
+ * generation counter so stale identifiers are rejected.
+ */
+typedef struct clarinet_enet_peer clarinet_enet_peer;
+
+struct clarinet_enet_event
+{
+    uint32_t id;                    /**< Local identifier of the peer */
+    uint16_t type;                  /**< Event type (@c CLARINET_ENET_EVENT_*) */
+    uint8_t channel;                /**< Channel the message was received on for DATA */
+    uint8_t rffu CLARINET_UNUSED;
+    int result;                     /**< Size of the message for DATA or the reason (error code) for DISCONNECT */
+    uint32_t data;                  /**< Data sent by the remote host for CONNECT and DISCONNECT */
+};
+
+/** Data structure used to report an event of an ENet host. */
+typedef struct clarinet_enet_event clarinet_enet_event;
+
+struct clarinet_enet
+{
+    clarinet_socket* socket;        /**< Underlying UDP socket (read-only) */
+    clarinet_enet_peer* peers;      /**< Peer slots (read-only) */
+    clarinet_packet_pool* pool;     /**< Pool for reliable commands and received datagrams (read-only) */
+    uint8_t* rx;                    /**< Slab holding the datagram being processed (private) */
+    clarinet_endpoint rxremote;     /**< Source of the datagram being processed (private) */
+    uint64_t seed;                  /**< Seed of connection identifiers (private) */
+    uint64_t secret;                /**< Seed of the hash of connection identifiers and endpoints (private) */
+    uint32_t capacity;              /**< Number of peer slots (read-only) */
+    uint32_t count;                 /**< Number of peer slots in use (read-only) */
+    uint32_t free;                  /**< Head of the free list (private) */
+    uint32_t active;                /**< Head of the list of slots in use (private) */
+    uint32_t rxoff;                 /**< Offset of the next command in the datagram being processed (private) */
+    uint32_t rxlen;                 /**< Size in bytes of the datagram being processed (private) */
+    uint32_t rxpeer;                /**< Slot plus one of the peer of the datagram being processed (private) */
+    uint32_t backlog;               /**< Slot plus one of a peer with messages ready for delivery (private) */
+    uint16_t rxtime;                /**< Sent time of the datagram being processed (private) */
+    uint8_t rxtimed;                /**< The datagram being processed has a sent time (private) */
+    uint8_t rffu CLARINET_UNUSED;
+    clarinet_enet_config config;    /**< Configuration (read-only) */
+};
+
+/**
+ * ENet host.
+ *
+ * @details Wire-compatible implementation of the ENet 1.3 protocol (http://enet.bespin.org) over a @c clarinet_socket.
+ * Hosts exchange connection handshakes, acknowledgements, pings and reliable, unreliable, unsequenced and fragmented
+ * messages with upstream ENet hosts. Reliable commands are kept in slabs of a @c clarinet_packet_pool until
+ * acknowledged and commands received out of order are kept in the same pool until they can be delivered, so the pool
+ * must have slabs of at least @c mtu bytes. Unreliable messages are sent straight from the caller's buffer.
+ *
+ * Limitations with respect to upstream ENet: checksums are not supported, bandwidth limits and packet throttling are
+ * acknowledged but ignored, unreliable messages larger than a datagram are not sent and reliable messages may have at
+ * most @c CLARINET_ENET_WINDOW fragments. Unreliable commands that arrive ahead of the reliable command they follow are
+ * discarded rather than held.
+ *
+ * Compressed datagrams and unreliable fragments are rejected. Upstream ENet only produces them when the remote host
+ * enables a compressor (@c enet_host_compress) or sends packets with @c ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT; by
+ * default it sends unreliable packets larger than a datagram as reliable fragments, which are supported. A rejected
+ * unreliable fragment is never acknowledged, the rest of the datagram is still processed and the rejection is logged
+ * as @c CLARINET_LOG_EVENT_ENET_UNSUPPORTED. A rejected compressed datagram is dropped as a whole and logged as
+ * @c CLARINET_LOG_EVENT_ENET_COMPRESSED. Reliable commands in compressed datagrams are never acknowledged so a peer
+ * that compresses eventually times out.
+ *
+ * Like @c clarinet_dtlc, the host does not keep time. Functions that may send or expire a peer take the current time
+ * in milliseconds from an arbitrary monotonic clock chosen by the caller. The host does not own the socket which must
+ * be closed after the host. Hosts are not movable and not thread-safe.
  */
-CLARINET_EXTERN
-int
-clarinet_socket_getopt(clarinet_socket* restrict sp,
-                       int optname,
-                       void* restrict optval,
-                       size_t* restrict optlen);
+typedef struct clarinet_enet clarinet_enet;
 
 /**
- * Connects the sp to a remote host.
+ * Initialize an ENet host structure.
  *
- * @details // TODO: document non-blocking connect(2) and SO_ERROR detection.
-//      In the case of a non-blocking socket, connect(2) may return -1/EINPROGRESS or -1/EWOUDLBLOCK. In this case, the
-//     * only way to determine when the connection process is complete is by calling select(2) or poll(2) and check for
-//     * writeability. But this check is ambiguous. The socket will indicate that it is ready to write once the connection
-//     * process is complete regardless of the outcome. The connection might as well have failed. In this case, a
-//     * subsequent call to @c send(2) will fail but this means the user can only determine the error condition much later
-//     * and on many occasions the application needs to receive some data before it can have anything to send. As an
-//     * alternative, one could call getsockopt(2) passing SO_ERROR and check if the connection process ended with a
-//     * non-zero error code. The caveat is that most Unix platforms will fetch AND RESET the socket error code with
-//     * getsockopt(2) as expected but the value will remain "dirty" if getsockopt(2) is not called even after other
-//     * successful calls to the socket. According to POSIX the value of SO_ERROR is only defined immediately after a
-//     * socket call fails. Besides, SO_ERROR is only used to report asynchronous errors that are the result of events
-//     * within the network stack and not synchronous errors that are the result of a blocking call (send/recv/connect).
-//     * Synchronous results are reported via errno. Calling getsockopt(2) with SO_ERROR after a blocking library call is
-//     * undefined behaviour while finding the non-blocking connect(2) result via select(2) is an example of discovering
-//     * when an asynchronous result is ready to be retrieved via SO_ERROR. In some systems, trying to fetch and reset
-//
+ * @param [in] ep ENet host pointer
  *
- * @param [in] sp
- * @param [in] remote
+ * @details The memory pointed to by @p ep must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_enet_init(clarinet_enet* ep);
+
+/**
+ * Open an ENet host.
  *
- * @return
+ * @param [in] ep ENet host pointer
+ * @param [in] sp Open UDP socket. Should be non-blocking.
+ * @param [in] peers Array of peer slots
+ * @param [in] capacity Number of elements in the @p peers array. Must not exceed @c CLARINET_ENET_CAPACITY_MAX.
+ * @param [in] pool Open packet pool with slabs of at least @c mtu bytes
+ * @param [in] config Configuration. Copied into the host.
  *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: Any argument is NULL or invalid, or the host is already open.
+ * @return @c CLARINET_ENOBUFS: The pool has no free slabs.
  *
+ * @details The socket, the array of peer slots and the pool must remain valid until the host is closed.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_connect(clarinet_socket* restrict sp,
-                        const clarinet_endpoint* restrict remote);
+clarinet_enet_open(clarinet_enet* restrict ep,
+                   clarinet_socket* restrict sp,
+                   clarinet_enet_peer* restrict peers,
+                   uint32_t capacity,
+                   clarinet_packet_pool* restrict pool,
+                   const clarinet_enet_config* restrict config);
 
 /**
- * Listen for connections on a sp.
+ * Close an ENet host.
  *
- * @param [in] sp Socket pointer
- * @param [in] backlog Maximum length for the queue of pending connections. Must be greater than or equal to zero.
- * Values between 0 and 5 should work in all platforms. Values greater than 5 may not be supported on platforms
- * with particular resource constraints.
+ * @param [in] ep ENet host pointer
  *
  * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p ep is NULL or not open.
  *
- * @return @c CLARINET_EINVAL: @p sp is NULL.
- * @return @c CLARINET_EINVAL: The sp pointed by @p sp is invalid. The sp must be open and bound to a local
- * endpoint.
- * @return @c CLARINET_EINVAL: @p backlog is out of range.
- *
- * @return @c CLARINET_EPROTONOSUPPORT: Operation is not supported by the sp protocol.
- *
- * @details This function will fail if the sp is not from a compatible protocol. Currently the only compatible
- * protocol is @c CLARINET_PROTO_TCP. The value provided by @p backlog is just a hint and the system is free to adjust
- * or ignore it. Calling @c clarinet_socket_listen() multiple times on a listen sp with possibly a different
- * @p backlog value is not recommended. It should not fail but the behaviour is platform dependent and can vary
- * considerably. Setting the @p backlog parameter to 0 in a subsequent call to @c clarinet_Socket_listen() on a
- * listening sp is not considered a proper reset, especially if there are connections in the queue.
- *
- * @note @b WINDOWS: The socket is considered invalid if not explicitly bound to a local endpoint first. The value of
- * @p backlog is clamped to the interval [200, 65535]. Subsequent calls to @c clarinet_socket_listen() on the same
- * listening sp with a valid @p backlog will ALWAYS succeed but the new @p backlog will be ignored by the system.
- *
- * @note @b LINUX: If the sp is not explicitly bound to a local endpoint, the system will implicitly assign a port
- * and default binding like it does when one calls @c clarinet_socket_connect() without a previous call to
- * @c clarinet_socket_bind(). The behavior of the @p backlog argument on TCP sockets changed with kernel 2.2. Now it
- * specifies the queue length for completely established sockets waiting to be accepted, instead of the number of
- * incomplete connection requests. The maximum length of the queue for incomplete sockets can be set using
- * /proc/sys/net/ipv4/tcp_max_syn_backlog. When syncookies are enabled (net.ipv4.tcp_syncookies=1) there is no logical
- * maximum length and this setting is ignored. See <a href="https://man7.org/linux/man-pages/man7/tcp.7.html">tcp(7)</a>
- * for more information. If @p backlog is greater than the value in /proc/sys/net/core/somaxconn, then it is silently
- * capped to that value. Since Linux 5.4, the default value in this file is 4096; in earlier kernels, the default value
- * is 128. In kernels before 2.4.25, this limit was a hard coded constant, @c SOMAXCONN = 128. Subsequent calls to
- * @c clarinet_socket_listen() on the listening sp will adjust the backlog queue length using the new @p backlog
- * value, but only for future connection requests. It does not discard any pending connections already in the queue.
- *
- * @note @b BSD/DARWIN: If the sp is not explicitly bound to a local endpoint, the system will implicitly assign a
- * port and default binding like it does when one calls @c clarinet_socket_connect() without a previous call to
- * @c clarinet_socket_bind(). The real maximum queue length will be 1.5 times more than the value specified by
- * @p backlog. Any subsequent call to @c clarinet_socket_listen() on the listening sp allows the caller to change
- * the maximum queue length using a new @p backlog argument. If a connection request arrives with the queue full, the
- * client may receive an error with an indication of @c CLARINET_ECONNREFUSED, or, in the case of TCP, the connection
- * will be silently dropped. Current queue lengths of listening sockets can be queried using @c netstat(1) command. Note
- * that before FreeBSD 4.5 and the introduction of the syncache, @p backlog also determined the length of the incomplete
- * connection queue, which held TCP sockets in the process of completing TCP's 3-way handshake. These incomplete
- * connections are now held entirely in the syncache, which is unaffected by queue lengths. Inflated backlog values to
- * help handle denial of service attacks are no longer necessary. The @c sysctl(3) MIB variable
- * @c kern.ipc.soacceptqueue specifies a hard limit on backlog; if a value greater than kern.ipc.soacceptqueue or less
- * than zero is specified, @p backlog is silently forced to @c kern.ipc.soacceptqueue. If the listen queue overflows,
- * the kernel will emit a @c LOG_DEBUG syslog message. The @c sysctl(3) MIB variable kern.ipc.sooverinterval specifies a
- * per-sp limit on how often the kernel will emit these messages.
+ * @details Peers are dropped without notice. All slabs held by the host are returned to the pool. The socket is not
+ * closed.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_listen(clarinet_socket* sp,
-                       int backlog);
+clarinet_enet_close(clarinet_enet* ep);
 
 /**
+ * Start a connection to a remote ENet host.
  *
- * @param [in] ssp Server socket pointer
- * @param [in] csp Client socket pointer
- * @param [out] remote Remote end point of the client socket
- * @return
+ * @param [in] ep ENet host pointer
+ * @param [in] remote Remote endpoint
+ * @param [in] channels Number of channels requested
+ * @param [in] data Data sent to the remote host with the connection request
+ * @param [in] now Current time in milliseconds
+ * @param [out] id Local identifier assigned to the peer
  *
- * @note A failure to obtain the remote address of the connected socket is not considered an error because in theory a
- * platform might not be able to provide that information immediately and would require an explicit call to
- * @c clarinet_socket_remote_endpoint() for that purpose. There is currently no supported platform to which this is the
- * case.
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOBUFS: There are no free peer slots or the pool has no free slabs.
+ * @return Any error code that could be returned by @c clarinet_socket_sendtov().
+ *
+ * @details The handshake completes asynchronously. A @c CLARINET_ENET_EVENT_CONNECT event is reported by
+ * @c clarinet_enet_recv() once the connection is verified.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_accept(clarinet_socket* restrict ssp,
-                       clarinet_socket* restrict csp,
-                       clarinet_endpoint* restrict remote);
+clarinet_enet_connect(clarinet_enet* restrict ep,
+                      const clarinet_endpoint* restrict remote,
+                      uint32_t channels,
+                      uint32_t data,
+                      uint64_t now,
+                      uint32_t* restrict id);
 
 /**
+ * Disconnect a peer immediately.
  *
- * @param [in] sp
- * @param [in] flags
- *
- * @return @c CLARINET_ENONE
- * @return @c CLARINET_ENOTCONN: The socket pointed to by @c sp is not connected.
+ * @param [in] ep ENet host pointer
+ * @param [in] id Local identifier of the peer
+ * @param [in] data Data sent to the remote host with the disconnection
+ * @param [in] now Current time in milliseconds
  *
- * @details Once the shutdown function is called to disable send, receive, or both, there is no method to re-enable that
- * capability for the existing sp connection.
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p ep is NULL or not open.
+ * @return @c CLARINET_ENOTCONN: @p id does not identify a peer.
  *
- * @note @b WINDOWS: A UDP socket can be shutdown even when not connected so @c CLARINET_ENOTCONN will only be returned
- * for TCP sockets.
+ * @details Equivalent to @c enet_peer_disconnect_now(). The disconnection is sent once, unreliably. No event is
+ * reported for this peer.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_shutdown(clarinet_socket* restrict sp,
-                         int flags);
-
-
-struct clarinet_socket_poll_target
-{
-    clarinet_socket* socket;    /**< Socket to poll. */
-    uint16_t events;            /**< Socket Event flags to poll. */
-};
+clarinet_enet_disconnect(clarinet_enet* ep,
+                         uint32_t id,
+                         uint32_t data,
+                         uint64_t now);
 
-typedef struct clarinet_socket_poll_target clarinet_socket_poll_target;
+/**
+ * Get a peer.
+ *
+ * @param [in] ep ENet host pointer
+ * @param [in] id Local identifier of the peer
+ *
+ * @return Pointer to the peer slot or NULL if @p id does not identify a peer.
+ */
+CLARINET_EXTERN
+clarinet_enet_peer*
+clarinet_enet_peer_find(clarinet_enet* ep,
+                        uint32_t id);
 
 /**
- * Calculates the size in bytes required for a @c clarinet_socket_poll_list to accomodate the number of items
- * indicated by @p count.
+ * Send a message to a connected peer.
  *
- * @param [in] count Number of items in the list
+ * @param [in] ep ENet host pointer
+ * @param [in] id Local identifier of the peer
+ * @param [in] channel Channel identifier
+ * @param [in] buf Message to send
+ * @param [in] buflen Size in bytes of the message
+ * @param [in] flags One of @c CLARINET_ENET_UNRELIABLE, @c CLARINET_ENET_RELIABLE or @c CLARINET_ENET_UNSEQUENCED
+ * @param [in] now Current time in milliseconds
  *
- * @return @c N > 0 Size in bytes of the memory block that must be allocated for the @c clarinet_socket_poll_list.
+ * @return @c N >= 0 Number of bytes of the message sent.
  * @return @c CLARINET_EINVAL
+ * @return @c CLARINET_ENOTCONN: @p id does not identify a connected peer.
+ * @return @c CLARINET_EMSGSIZE: The message is unreliable and does not fit in a datagram or is reliable and needs
+ * more than @c CLARINET_ENET_WINDOW fragments.
+ * @return @c CLARINET_EAGAIN: Too many reliable commands are waiting for an ack.
+ * @return @c CLARINET_ENOBUFS: The pool has no free slabs.
+ * @return Any error code that could be returned by @c clarinet_socket_sendtov() if the message is unreliable.
+ *
+ * @details Reliable messages larger than a datagram are fragmented. Reliable commands are copied into slabs of the
+ * pool before they are sent so they are accepted even if the socket cannot send at the moment.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_poll_context_calcsize(size_t count);
+clarinet_enet_send(clarinet_enet* restrict ep,
+                   uint32_t id,
+                   uint8_t channel,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint32_t flags,
+                   uint64_t now);
 
 /**
- * Retrieve a specific socket poll status.
+ * Receive and process commands.
  *
- * @param [in] context Buffer used in a previous call to @c clarinet_socket_poll().
- * @param [in] index Index of the status to retrieve.
- * @param [out] status Status report of the target.
+ * @param [in] ep ENet host pointer
+ * @param [out] buf Buffer to store the message received
+ * @param [in] buflen Size in bytes of the buffer pointed to by @p buf
+ * @param [out] event Event produced
+ * @param [in] now Current time in milliseconds
  *
- * @return @c CLARINET_ENONE
+ * @return @c CLARINET_ENONE: Commands were processed. Check @p event for the outcome.
  * @return @c CLARINET_EINVAL
+ * @return Any error code that could be returned by @c clarinet_socket_recvfrom(). In particular @c CLARINET_EAGAIN
+ * when the socket is non-blocking and there are no more datagrams to receive.
  *
- * @details It's guaranteed that the index @a i of every result is the same of it's corresponding target in the array
- * passed to @c clarinet_socket_poll().
+ * @details Should be called until it returns @c CLARINET_EAGAIN. A datagram may carry many commands so commands are
+ * processed until one produces an event and the remaining ones are processed by subsequent calls before another
+ * datagram is read from the socket. A message larger than @p buflen is truncated and reported with a result of
+ * @c CLARINET_EMSGSIZE. Acknowledgements are sent with the next datagram to the peer or by @c clarinet_enet_update().
  */
 CLARINET_EXTERN
 int
-clarinet_socket_poll_context_getstatus(const void* restrict context,
-                                       size_t index,
-                                       uint16_t* restrict status);
+clarinet_enet_recv(clarinet_enet* restrict ep,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_enet_event* restrict event,
+                   uint64_t now);
 
 /**
- * Determines the status of one or more sockets.
+ * Perform periodic work: send pending acks and pings, resend reliable commands and expire peers.
  *
- * @param [in] context Buffer used to store the operation results.
- * @param [in] targets Array of sockets and the corresponding events to report.
- * @param [in] count Number of elements in the @c targets array.
- * @param [in] timeout Number of milliseconds that the function should block waiting for an event on any target.
+ * @param [in] ep ENet host pointer
+ * @param [out] events Array to store the disconnect events of expired peers
+ * @param [in] count Number of elements in the @p events array
+ * @param [in] now Current time in milliseconds
  *
- * @return @c CLARINET_ENONE
+ * @return @c N >= 0 Number of events stored in @p events.
  * @return @c CLARINET_EINVAL
  *
- * @details On success the function @c clarinet_socket_poll_context_getstatus() can be used to fetch the status of a
- * specific target. The caller is responsible for allocating the memory pointed to by @c context which is where the operation
- * results are stored. The function @c clarinet_socket_poll_context_calcsize() can be used to determine the required
- * size in bytes according to the number of targets.
+ * @details Should be called after every batch of calls to @c clarinet_enet_recv() so acknowledgements are not
+ * delayed. Only peer slots in use are visited so the cost of an update is proportional to the number of peers rather
+ * than the capacity.
  */
 CLARINET_EXTERN
 int
-clarinet_socket_poll(void* restrict context,
-                     const clarinet_socket_poll_target* restrict targets,
+clarinet_enet_update(clarinet_enet* restrict ep,
+                     clarinet_enet_event* restrict events,
                      size_t count,
-                     int timeout);
+                     uint64_t now);
 
 /* endregion */
 
 /* region Interface */
 
+/** Maximum length of an interface name including the terminating null character. */
+#define CLARINET_IFACE_NAME_MAX             16
+
 struct clarinet_iface
 {
     uint32_t index;          /* Interface index */
@@ -2095,9 +6271,9 @@ struct clarinet_iface
     /**
      * Interface address. It may be contain a link, inet or inet6 address.
      *
-     * @note Link addresses contain the  of the interface. For example, on an Ethernet
-     * network this would be an Ethernet hardware address of 6 bytes. Other link layers may provide MAC addresses of
-     * different lengths.
+     * @note Link addresses contain the hardware address of the interface. For example, on an Ethernet network this
+     * would be an Ethernet hardware address of 6 bytes. Other link layers may provide MAC addresses of different
+     * lengths.
      */
     clarinet_addr addr;
 
@@ -2106,22 +6282,271 @@ struct clarinet_iface
 
 typedef struct clarinet_iface clarinet_iface;
 
+/**
+ * Get the list of interface addresses.
+ *
+ * @param [in] list Array that receives the addresses
+ * @param [in,out] len On input the number of elements in @p list. On output the number of addresses stored or, if
+ * @p list is too small, the number of elements required.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p list or @p len is NULL.
+ * @return @c CLARINET_ENOBUFS: @p list is too small. The contents of @p list are undefined.
+ * @return @c CLARINET_ENOTSUP: The operation is not supported by the platform.
+ * @return @c CLARINET_ESYS: Unexpected system error.
+ *
+ * @details The list contains the hardware address of every interface that has one as a @c CLARINET_AF_LINK entry and
+ * every IPv4 and IPv6 address. Each call queries the system so applications that need frequent lookups should keep a
+ * @c clarinet_iface_table instead.
+ *
+ * @note @b LINUX: Addresses are obtained over rtnetlink. IPv6 addresses still undergoing duplicate address detection
+ * are not listed.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for valid arguments.
+ */
 CLARINET_EXTERN
 int
 clarinet_iface_getlist(clarinet_iface* restrict list,
                        size_t* len);
 
+/**
+ * Get the index of an interface given its name.
+ *
+ * @param [in] name Null-terminated interface name
+ * @param [out] index Interface index
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p name or @p index is NULL.
+ * @return @c CLARINET_ENOTFOUND: No interface with such a name.
+ * @return @c CLARINET_ENOTSUP: The operation is not supported by the platform.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for valid arguments.
+ */
 CLARINET_EXTERN
 int
 clarinet_iface_getindex(const char* name,
                         uint32_t* index);
 
+/**
+ * Get the name of an interface given its index.
+ *
+ * @param [in] index Interface index
+ * @param [out] name Buffer that receives the null-terminated interface name
+ * @param [in] len Size of @p name in bytes. @c CLARINET_IFACE_NAME_MAX is always enough.
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p name is NULL.
+ * @return @c CLARINET_ENOTFOUND: No interface with such an index.
+ * @return @c CLARINET_ENOBUFS: @p name is too small.
+ * @return @c CLARINET_ENOTSUP: The operation is not supported by the platform.
+ *
+ * @note @b WINDOWS: Not supported. Always returns @c CLARINET_ENOTSUP for valid arguments.
+ */
 CLARINET_EXTERN
 int
 clarinet_iface_getname(uint32_t index,
                        char* name,
                        size_t len);
 
+#define CLARINET_IFACE_LINK_UP              0x01    /**< Interface is administratively up */
+#define CLARINET_IFACE_LINK_RUNNING         0x02    /**< Interface has a carrier and is operational */
+#define CLARINET_IFACE_LINK_LOOPBACK        0x04    /**< Interface is a loopback */
+#define CLARINET_IFACE_LINK_MULTICAST       0x08    /**< Interface supports multicast */
+
+struct clarinet_iface_link
+{
+    uint32_t index;                         /**< Interface index */
+    uint32_t flags;                         /**< Combination of CLARINET_IFACE_LINK_* flags */
+    uint32_t mtu;                           /**< Maximum transmission unit in bytes */
+    char name[CLARINET_IFACE_NAME_MAX];     /**< Null-terminated interface name */
+    clarinet_addr addr;                     /**< Hardware address or @c clarinet_addr_none if there is none */
+};
+
+/** Link information of a network interface. */
+typedef struct clarinet_iface_link clarinet_iface_link;
+
+#define CLARINET_IFACE_EVENT_LINK_NEW       1   /**< Link was added or its information changed */
+#define CLARINET_IFACE_EVENT_LINK_DEL       2   /**< Link was removed along with all its addresses */
+#define CLARINET_IFACE_EVENT_ADDR_NEW       3   /**< Address was added */
+#define CLARINET_IFACE_EVENT_ADDR_DEL       4   /**< Address was removed */
+#define CLARINET_IFACE_EVENT_RESYNC         5   /**< Notifications were lost and the table was reloaded */
+
+struct clarinet_iface_event
+{
+    uint32_t type;                          /**< Event type (@c CLARINET_IFACE_EVENT_*) */
+
+    /**
+     * Interface affected. Link events only carry the interface index and hardware address. Address events carry the
+     * interface index, address and netmask. Resync events carry nothing.
+     */
+    clarinet_iface iface;
+};
+
+/** Change reported by @c clarinet_iface_table_update(). */
+typedef struct clarinet_iface_event clarinet_iface_event;
+
+struct clarinet_iface_table
+{
+    clarinet_iface_link* links;     /**< Links of all interfaces (read-only) */
+    clarinet_iface* addrs;          /**< IPv4 and IPv6 addresses of all interfaces (read-only) */
+    uint32_t nlinks;                /**< Number of links in use (read-only) */
+    uint32_t maxlinks;              /**< Capacity of the array of links (read-only) */
+    uint32_t naddrs;                /**< Number of addresses in use (read-only) */
+    uint32_t maxaddrs;              /**< Capacity of the array of addresses (read-only) */
+    uint64_t version;               /**< Incremented whenever the contents of the table change (read-only) */
+    size_t offset;                  /**< Bytes of the next notification datagram already applied (private) */
+    clarinet_socket socket;         /**< Notification socket that may be added to a poller (read-only) */
+};
+
+/**
+ * In-process snapshot of the network interfaces of the system.
+ *
+ * @details A table is loaded once when opened and then kept current by applying change notifications from the system
+ * with @c clarinet_iface_table_update(). Lookups only read the snapshot so they never make system calls which makes
+ * them cheap enough to choose a source address for every datagram sent. The notification socket becomes readable when
+ * changes are pending so it can be added to a poller with @c CLARINET_POLL_RECV to drive the updates. Arrays are
+ * provided by the caller and the table never allocates. Must be initialized using @c clarinet_iface_table_init()
+ * before it can be used. Tables are not thread-safe and not movable.
+ *
+ * @note @b LINUX: The snapshot and notifications are obtained over rtnetlink.
+ *
+ * @note @b WINDOWS: Not supported. @c clarinet_iface_table_open() always returns @c CLARINET_ENOTSUP so every other
+ * table function fails the validation of the table.
+ *
+ * @note Not supported on other platforms.
+ */
+typedef struct clarinet_iface_table clarinet_iface_table;
+
+/**
+ * Initialize an interface table structure.
+ *
+ * @param [in] table Table pointer
+ *
+ * @details The memory pointed to by @p table must have been previously allocated.
+ */
+CLARINET_EXTERN
+void
+clarinet_iface_table_init(clarinet_iface_table* table);
+
+/**
+ * Open an interface table, subscribe to interface changes and load the current state of the system.
+ *
+ * @param [in] table Table pointer
+ * @param [in] links Array of @p maxlinks links. Must remain valid until the table is closed.
+ * @param [in] maxlinks Maximum number of interfaces
+ * @param [in] addrs Array of @p maxaddrs addresses. Must remain valid until the table is closed.
+ * @param [in] maxaddrs Maximum number of IPv4 and IPv6 addresses of all interfaces combined
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p table is already open.
+ * @return @c CLARINET_ENOBUFS: The system has more interfaces or addresses than the table can hold.
+ * @return @c CLARINET_ENOTSUP: The platform does not support interface tables.
+ * @return @c CLARINET_ESYS: Unexpected system error.
+ *
+ * @details The subscription is made before the state is loaded so no change can be missed in between.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_open(clarinet_iface_table* restrict table,
+                          clarinet_iface_link* restrict links,
+                          uint32_t maxlinks,
+                          clarinet_iface* restrict addrs,
+                          uint32_t maxaddrs);
+
+/**
+ * Close an interface table.
+ *
+ * @param [in] table Table pointer
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: @p table is NULL or not open.
+ *
+ * @details The notification socket must be removed from any poller before the table is closed.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_close(clarinet_iface_table* table);
+
+/**
+ * Apply pending change notifications to an interface table without blocking.
+ *
+ * @param [in] table Table pointer
+ * @param [out] events Array that receives the changes applied in the order they happened
+ * @param [in] count Maximum number of events to return
+ *
+ * @return Number of events stored in @p events (zero if there were no pending changes) or one of the following
+ * negative error codes:
+ * @return @c CLARINET_EINVAL: An argument is invalid, @p count is 0 or greater than INT_MAX, or @p table is not open.
+ * @return @c CLARINET_ENOBUFS: A change could not be applied because the table is full. The table remains consistent
+ * with the system except for the change that was dropped.
+ * @return @c CLARINET_ESYS: Unexpected system error.
+ *
+ * @details Notifications that do not fit in @p events remain pending for the next call. If the system drops
+ * notifications (e.g. because they were not consumed fast enough) the table is reloaded and a single
+ * @c CLARINET_IFACE_EVENT_RESYNC is reported instead of the changes that were missed.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_update(clarinet_iface_table* restrict table,
+                            clarinet_iface_event* restrict events,
+                            size_t count);
+
+/**
+ * Get the link information of an interface from a table.
+ *
+ * @param [in] table Table pointer
+ * @param [in] index Interface index
+ * @param [out] link Link information
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p table is not open.
+ * @return @c CLARINET_ENOTFOUND: No interface with such an index.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_getlink(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             clarinet_iface_link* restrict link);
+
+/**
+ * Get the index of an interface given its name from a table.
+ *
+ * @param [in] table Table pointer
+ * @param [in] name Null-terminated interface name
+ * @param [out] index Interface index
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p table is not open.
+ * @return @c CLARINET_ENOTFOUND: No interface with such a name.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_getindex(const clarinet_iface_table* restrict table,
+                              const char* restrict name,
+                              uint32_t* restrict index);
+
+/**
+ * Get a source address of an interface from a table.
+ *
+ * @param [in] table Table pointer
+ * @param [in] index Interface index
+ * @param [in] family Address family (@c CLARINET_AF_INET or @c CLARINET_AF_INET6)
+ * @param [out] addr Source address
+ *
+ * @return @c CLARINET_ENONE: Success
+ * @return @c CLARINET_EINVAL: An argument is invalid or @p table is not open.
+ * @return @c CLARINET_ENOTFOUND: The interface has no address of the requested family.
+ *
+ * @details The first address of the family assigned to the interface is returned except that IPv6 addresses of
+ * global scope are preferred over link-local ones. Link-local addresses carry the interface index as scope id.
+ */
+CLARINET_EXTERN
+int
+clarinet_iface_table_getaddr(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             int family,
+                             clarinet_addr* restrict addr);
+
 /* endregion */
 
 /* @formatter:off */
@@ -129,8 +129,8 @@ clarinet_get_features(void)
     features |= CLARINET_FEATURE_DEBUG;
     #endif
 
-    #if CLARINET_ENABLE_PROFILER
-    features |= CLARINET_FEATURE_PROFILER;
+    #if CLARINET_ENABLE_PROFILE
+    features |= CLARINET_FEATURE_PROFILE;
     #endif
 
     #if CLARINET_ENABLE_LOG
@@ -145,6 +145,10 @@ clarinet_get_features(void)
     features |= CLARINET_FEATURE_IPV6DUAL;
     #endif
 
+    #if CLARINET_ENABLE_URING
+    features |= CLARINET_FEATURE_URING;
+    #endif
+
     return features;
 }
 
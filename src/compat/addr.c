@@ -4,7 +4,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
-#include <ctype.h>
 #include <assert.h>
 
 CLARINET_INLINE
@@ -56,8 +55,39 @@ clarinet_addr_ipv6_from_inet6(union clarinet_ipv6_octets* restrict dst,
     memcpy(dst, src, min(sizeof(struct in6_addr), sizeof(union clarinet_ipv6_octets)));
 }
 
+/**
+ * Hexadecimal value of every character or 0xFF if the character is not a hex digit. A single table lookup is cheaper
+ * than searching digit strings and, unlike the ctype functions, is neither locale dependent nor undefined for negative
+ * chars.
+ */
+static const uint8_t clarinet_xdigit_values[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* 0-9 */
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* A-F */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* a-f */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
 #endif /* CLARINET_ENABLE_IPV6 */
 
+CLARINET_STATIC_INLINE
+int
+clarinet_isdigit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
 static
 int
 clarinet_decode_port(const char* restrict src,
@@ -72,7 +102,7 @@ clarinet_decode_port(const char* restrict src,
     while (i < len)
     {
         const char c = src[i++];
-        if (!isdigit(c))
+        if (!clarinet_isdigit(c))
             return CLARINET_EINVAL;
 
         if (hasdigits)
@@ -95,6 +125,8 @@ clarinet_decode_port(const char* restrict src,
     return port;
 }
 
+#if CLARINET_ENABLE_IPV6
+
 static
 int
 clarinet_decode_scope_id(uint32_t* scope_id,
@@ -110,7 +142,7 @@ clarinet_decode_scope_id(uint32_t* scope_id,
     while (i < len)
     {
         const char c = src[i++];
-        if (!isdigit(c))
+        if (!clarinet_isdigit(c))
             return CLARINET_EINVAL;
 
         if (hasdigits)
@@ -139,6 +171,8 @@ clarinet_decode_scope_id(uint32_t* scope_id,
     return CLARINET_ENONE;
 }
 
+#endif /* CLARINET_ENABLE_IPV6 */
+
 
 #define INADDRSZ 4
 
@@ -173,7 +207,7 @@ clarinet_pton4(struct in_addr* restrict addr,
     while (i < srclen)
     {
         const char c = src[i++];
-        if (isdigit(c))
+        if (clarinet_isdigit(c))
         {
             uint8_t acc = addrptr[octet];
             if (hasdigits)
@@ -226,10 +260,6 @@ clarinet_pton6(struct in6_addr* restrict addr,
     assert(src);
     assert(srclen >= 2);
 
-    static const char xdigits_l[] = "0123456789abcdef";
-    static const char xdigits_u[] = "0123456789ABCDEF";
-
-
     uint8_t tmp[IN6ADDRSZ] = { 0 };
     uint8_t* tp = (uint8_t*)tmp;
     uint8_t* endp = tp + sizeof(tmp);
@@ -247,15 +277,11 @@ clarinet_pton6(struct in6_addr* restrict addr,
     while (i < srclen)
     {
         const char c = src[i++];
-        const char* xdigits;
-        const char* cp;
-        if ((cp = strchr((xdigits = xdigits_l), c)) == NULL)
-            cp = strchr((xdigits = xdigits_u), c);
-
-        if (cp)
+        const uint8_t x = clarinet_xdigit_values[(unsigned char)c];
+        if (x != 0xFF)
         {
             val <<= 4;
-            val = val | (uint32_t)(cp - xdigits);
+            val = val | x;
             if (++seen_xdigits > 4)
                 return CLARINET_EINVAL;
             continue;
@@ -374,24 +400,18 @@ clarinet_addr_ipv6_from_string(clarinet_addr* restrict dst,
     if (src[srclen - 1] == '%')
         return CLARINET_EINVAL;
 
-    /* Parse scope id first */
-    size_t i = 0;
-    while (i < srclen)
-    {
-        if (src[i++] == '%')
-            break;
-    }
-
+    /* Parse scope id first. memchr is normally vectorized by the C runtime. */
+    const char* sep = memchr(src, '%', srclen);
+    const size_t i = sep ? (size_t)(sep - src) : srclen;
     if (i < 2) /* minimum ipv6 with scope id is ::%0 */
         return CLARINET_EINVAL;
 
     uint32_t scope_id = 0;
-    if (i < srclen)
+    if (sep)
     {
-        int errcode = clarinet_decode_scope_id(&scope_id, &src[i], srclen - i);
+        int errcode = clarinet_decode_scope_id(&scope_id, sep + 1, srclen - i - 1);
         if (errcode != CLARINET_ENONE)
             return errcode;
-        --i;
     }
 
     /* Parse inet6 address */
@@ -488,13 +508,21 @@ clarinet_addr_from_string(clarinet_addr* restrict dst,
 {
     if (dst && src && srclen > 0)
     {
-        /* There is no way of knowing if src is an ipv4 or ipv6 upfront so we must try one conversion then the other. */
-        int errcode = clarinet_addr_ipv4_from_string(dst, src, srclen);
+        /*
+         * The first character that is not a decimal digit tells the families apart so that src is parsed only once.
+         * A valid ipv4 must have a '.' there while a valid ipv6 must have either a ':' or a hex letter. An ipv4
+         * embedded in an ipv6 always comes after a ':'.
+         */
+        size_t i = 0;
+        while (i < srclen && clarinet_isdigit(src[i]))
+            i++;
+
+        if (i < srclen && src[i] == '.')
+            return clarinet_addr_ipv4_from_string(dst, src, srclen);
+
         #if CLARINET_ENABLE_IPV6
-        if (errcode != CLARINET_ENONE)
-            errcode = clarinet_addr_ipv6_from_string(dst, src, srclen);
+        return clarinet_addr_ipv6_from_string(dst, src, srclen);
         #endif /* CLARINET_ENABLE_IPV6 */
-        return errcode;
     }
 
     return CLARINET_EINVAL;
@@ -560,24 +588,18 @@ clarinet_endpoint_from_string(clarinet_endpoint* restrict dst,
     {
         const char first = src[0];
         const char last = src[srclen - 1];
-        if (isdigit(first) && isdigit(last)) /* either ipv4 or invalid */
+        if (clarinet_isdigit(first) && clarinet_isdigit(last)) /* either ipv4 or invalid */
         {
-            size_t i = 0;
-            while (i < srclen) /* consume the address part until a ':' is found */
-            {
-                const char c = src[i];
-                if (c == ':')
-                    break;
-                /*
-                 * using 15 explicitly here instead of INET_ADDRSTRLEN-1 because some systems define INET_ADDRSTRLEN
-                 * as 22 or more instead of 16 to account for the port number (eg.: windows)
-                 */
-                if (i >= 15 || (c != '.' && !isdigit(c))) /* not a valid ipv4 endpoint */
-                    return CLARINET_EINVAL;
-
-                i++;
-            }
+            /*
+             * Find the ':' that ends the address part. Invalid characters before it are rejected by the address parser.
+             * Using 15 explicitly here instead of INET_ADDRSTRLEN-1 because some systems define INET_ADDRSTRLEN as 22
+             * or more instead of 16 to account for the port number (eg.: windows)
+             */
+            const char* sep = memchr(src, ':', min(srclen, 15 + 1));
+            if (!sep) /* not a valid ipv4 endpoint */
+                return CLARINET_EINVAL;
 
+            const size_t i = (size_t)(sep - src);
             const size_t n = srclen - i;
             if (n < 2) /* not enough for a valid port number */
                 return CLARINET_EINVAL;
@@ -600,24 +622,18 @@ clarinet_endpoint_from_string(clarinet_endpoint* restrict dst,
         }
 
         #if CLARINET_ENABLE_IPV6
-        if (first == '[' && isdigit(last)) /* either ipv6 or invalid */
+        if (first == '[' && clarinet_isdigit(last)) /* either ipv6 or invalid */
         {
-            size_t i = 1;     /* consume '[' */
-            while (i < srclen) /* consume the address part until a ']' is found */
-            {
-                const char c = src[i];
-                if (c == ']')
-                    break;
-                /*
-                 * using 56 explicitly here instead of INET6_ADDRSTRLEN-1 most systems don't account for the scope id
-                 * and may even reserve space for the port instead (e.g.: windows)
-                 */
-                if (i >= 56 || (c != '.' && c != ':' && c != '%' && !isxdigit(c))) /* not a valid ipv6 endpoint */
-                    return CLARINET_EINVAL;
-
-                i++;
-            }
+            /*
+             * Find the ']' that ends the address part. Invalid characters before it are rejected by the address parser.
+             * Using 56 explicitly here instead of INET6_ADDRSTRLEN-1 most systems don't account for the scope id and
+             * may even reserve space for the port instead (e.g.: windows)
+             */
+            const char* sep = memchr(src + 1, ']', min(srclen, 56 + 1) - 1);
+            if (!sep) /* not a valid ipv6 endpoint */
+                return CLARINET_EINVAL;
 
+            const size_t i = (size_t)(sep - src);
             const size_t n = srclen - i;
             if (n < 3 || src[i + 1] != ':') /* not enough for a valid port number or separator mismatch */
                 return CLARINET_EINVAL;
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef COMPAT_BYTES_H
+#define COMPAT_BYTES_H
+
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+/*
+ * Unaligned access to integers in network byte order (big-endian) as used by the wire formats of the protocols. Bytes
+ * are assembled one at a time so the result does not depend on the alignment or the byte order of the host.
+ */
+
+/** Read a 16-bit integer in network byte order from @p p. */
+CLARINET_STATIC_INLINE
+uint16_t
+clarinet_get16(const uint8_t* p)
+{
+    return (uint16_t)(((uint32_t)p[0] << 8) | (uint32_t)p[1]);
+}
+
+/** Write the 16-bit integer @p v in network byte order to @p p. */
+CLARINET_STATIC_INLINE
+void
+clarinet_put16(uint8_t* p,
+               uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+/** Read a 32-bit integer in network byte order from @p p. */
+CLARINET_STATIC_INLINE
+uint32_t
+clarinet_get32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/** Write the 32-bit integer @p v in network byte order to @p p. */
+CLARINET_STATIC_INLINE
+void
+clarinet_put32(uint8_t* p,
+               uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/** Read a 64-bit integer in network byte order from @p p. */
+CLARINET_STATIC_INLINE
+uint64_t
+clarinet_get64(const uint8_t* p)
+{
+    return ((uint64_t)clarinet_get32(p) << 32) | (uint64_t)clarinet_get32(p + 4);
+}
+
+/** Write the 64-bit integer @p v in network byte order to @p p. */
+CLARINET_STATIC_INLINE
+void
+clarinet_put64(uint8_t* p,
+               uint64_t v)
+{
+    clarinet_put32(p, (uint32_t)(v >> 32));
+    clarinet_put32(p + 4, (uint32_t)v);
+}
+
+#endif /* COMPAT_BYTES_H */
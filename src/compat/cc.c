@@ -0,0 +1,646 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+#define CC_USEC                 1000000u    /* microseconds per second */
+#define CC_INITIAL_WINDOW       10          /* initial congestion window in segments */
+
+/** Returns true (non-zero) if the controller pointed to by @p cc is open. */
+#define clarinet_cc_is_open(cc) ((cc)->algorithm != NULL)
+
+/* Gains are fixed point values with 8 fractional bits. */
+#define BBR_SCALE               8
+#define BBR_UNIT                (1u << BBR_SCALE)
+#define BBR_HIGH_GAIN           739u        /* 2/ln(2) which doubles the delivery rate every round */
+#define BBR_DRAIN_GAIN          88u         /* ln(2)/2 which drains the queue created in startup in one round */
+#define BBR_CWND_GAIN           512u        /* 2 so delayed and aggregated acknowledgements do not stall the sender */
+#define BBR_CYCLE_LENGTH        8
+#define BBR_BW_ROUNDS           10          /* length of the bandwidth filter in rounds */
+#define BBR_MIN_RTT_WINDOW      10000000u   /* length of the round-trip time filter in microseconds */
+#define BBR_PROBE_RTT_TIME      200000u     /* minimum time spent with a minimal window in microseconds */
+#define BBR_MIN_WINDOW          4           /* minimum congestion window in segments */
+#define BBR_FULL_BW_ROUNDS      3           /* rounds without 25% of growth after which the pipe is deemed full */
+#define BBR_LOSS_THRESHOLD      50          /* a round is lossy when more than 1/50 (2%) of its bytes are lost */
+#define BBR_LOSS_MIN            8           /* ... and at least this many segments so small rounds are not too noisy */
+
+enum bbr_mode
+{
+    BBR_STARTUP,
+    BBR_DRAIN,
+    BBR_PROBE_BW,
+    BBR_PROBE_RTT
+};
+
+struct bbr
+{
+    uint64_t bw[BBR_BW_ROUNDS];     /* delivery rate of the last rounds in bytes per second */
+    uint64_t round_start;           /* time at which the current round started */
+    uint64_t round_delivered;       /* delivered bytes when the current round started */
+    uint64_t round_lost;            /* lost bytes when the current round started */
+    uint64_t round_count;
+    uint64_t full_bw;               /* bandwidth estimate at the last time it grew by 25% */
+    uint64_t min_rtt_stamp;         /* time at which the minimum round-trip time was last refreshed */
+    uint64_t probe_rtt_done;        /* time at which probe rtt ends or 0 if the window is still draining */
+    uint64_t cycle_stamp;           /* time at which the current gain cycle phase started */
+    uint64_t inflight_hi;           /* upper bound of the bytes in flight after excessive loss */
+    uint64_t prior_cwnd;            /* congestion window saved when entering probe rtt */
+    uint32_t min_rtt;               /* minimum round-trip time of the filter window or 0 if unknown */
+    uint32_t mode;
+    uint32_t pacing_gain;
+    uint32_t cwnd_gain;
+    uint32_t full_bw_count;
+    uint32_t full_bw_reached;
+    uint32_t cycle_index;
+};
+
+/* Pacing gains of the phases of a bandwidth probing cycle: probe, drain the probe, then cruise. */
+static const uint32_t bbr_cycle_gain[BBR_CYCLE_LENGTH] = {
+    BBR_UNIT * 5 / 4, BBR_UNIT * 3 / 4, BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT
+};
+
+/** Helper to obtain the maximum bandwidth of the filter window in bytes per second. */
+CLARINET_STATIC_INLINE
+uint64_t
+bbr_bw(const struct bbr* bbr)
+{
+    uint64_t max = 0;
+    for (size_t i = 0; i < BBR_BW_ROUNDS; ++i)
+    {
+        if (bbr->bw[i] > max)
+            max = bbr->bw[i];
+    }
+
+    return max;
+}
+
+/** Helper to estimate the bandwidth-delay product in bytes. Returns 0 if there is no estimate yet. */
+CLARINET_STATIC_INLINE
+uint64_t
+bbr_bdp(const struct bbr* bbr)
+{
+    return bbr_bw(bbr) * bbr->min_rtt / CC_USEC;
+}
+
+static
+void
+bbr_enter_probe_bw(struct bbr* bbr,
+                   uint64_t now)
+{
+    bbr->mode = BBR_PROBE_BW;
+    bbr->cwnd_gain = BBR_CWND_GAIN;
+    /* Start in a cruising phase that depends on the round count so that flows sharing a bottleneck probe at
+     * different times. Never start in the phase that drains the probe as there is nothing to drain. */
+    bbr->cycle_index = (uint32_t)(2 + bbr->round_count % (BBR_CYCLE_LENGTH - 2));
+    bbr->pacing_gain = bbr_cycle_gain[bbr->cycle_index];
+    bbr->cycle_stamp = now;
+}
+
+/** Helper to close a round and take a delivery rate sample once at least one minimum round-trip time has elapsed. */
+static
+void
+bbr_update_round(clarinet_cc* cc,
+                 struct bbr* bbr,
+                 uint64_t now)
+{
+    const uint64_t elapsed = now - bbr->round_start;
+    if (bbr->min_rtt == 0 || elapsed < bbr->min_rtt || elapsed == 0)
+        return;
+
+    /* The minimal window of probe rtt limits the delivery rate so its rounds would only flush the bandwidth filter. */
+    if (bbr->mode == BBR_PROBE_RTT)
+    {
+        bbr->round_start = now;
+        bbr->round_delivered = cc->delivered;
+        bbr->round_lost = cc->lost;
+        return;
+    }
+
+    const uint64_t delivered = cc->delivered - bbr->round_delivered;
+    const uint64_t lost = cc->lost - bbr->round_lost;
+    const uint64_t bw = delivered * CC_USEC / elapsed;
+    bbr->bw[bbr->round_count % BBR_BW_ROUNDS] = bw;
+
+    /* Losses above the threshold while probing for more bandwidth mean that the path cannot hold the current window
+     * so the data in flight is capped to a bit less than that. Random losses while cruising are ignored and rounds
+     * below the threshold slowly raise the cap again. */
+    const uint64_t min_window = (uint64_t)BBR_MIN_WINDOW * cc->mss;
+    const int lossy = (lost * BBR_LOSS_THRESHOLD > delivered + lost && lost >= (uint64_t)BBR_LOSS_MIN * cc->mss);
+    if (lossy && bbr->pacing_gain > BBR_UNIT)
+    {
+        const uint64_t cap = cc->cwnd - cc->cwnd / 8;
+        bbr->inflight_hi = (cap > min_window) ? cap : min_window;
+        if (!bbr->full_bw_reached)
+        {
+            bbr->full_bw_reached = 1;
+            bbr->mode = BBR_DRAIN;
+            bbr->pacing_gain = BBR_DRAIN_GAIN;
+            bbr->cwnd_gain = BBR_HIGH_GAIN;
+        }
+    }
+    else if (!lossy && bbr->inflight_hi != UINT64_MAX)
+    {
+        const uint64_t step = (bbr->inflight_hi / 16 > cc->mss) ? bbr->inflight_hi / 16 : cc->mss;
+        bbr->inflight_hi = (bbr->inflight_hi < UINT64_MAX - step) ? bbr->inflight_hi + step : UINT64_MAX;
+    }
+
+    /* The pipe is full when the bandwidth estimate stops growing even though startup doubles the sending rate. */
+    if (!bbr->full_bw_reached)
+    {
+        const uint64_t max = bbr_bw(bbr);
+        if (max >= bbr->full_bw + bbr->full_bw / 4)
+        {
+            bbr->full_bw = max;
+            bbr->full_bw_count = 0;
+        }
+        else if (++bbr->full_bw_count >= BBR_FULL_BW_ROUNDS)
+        {
+            bbr->full_bw_reached = 1;
+            bbr->mode = BBR_DRAIN;
+            bbr->pacing_gain = BBR_DRAIN_GAIN;
+            bbr->cwnd_gain = BBR_HIGH_GAIN;
+        }
+    }
+
+    bbr->round_count++;
+    bbr->round_start = now;
+    bbr->round_delivered = cc->delivered;
+    bbr->round_lost = cc->lost;
+}
+
+static
+void
+bbr_update_mode(clarinet_cc* cc,
+                struct bbr* bbr,
+                uint64_t now)
+{
+    switch (bbr->mode)
+    {
+        case BBR_DRAIN:
+            if (cc->inflight <= bbr_bdp(bbr))
+                bbr_enter_probe_bw(bbr, now);
+            break;
+        case BBR_PROBE_BW:
+            /* Each phase lasts one minimum round-trip time but draining ends as soon as the queue created by the probe
+             * is gone. */
+            if (now - bbr->cycle_stamp > bbr->min_rtt
+                || (bbr->pacing_gain < BBR_UNIT && cc->inflight <= bbr_bdp(bbr)))
+            {
+                bbr->cycle_index = (bbr->cycle_index + 1) % BBR_CYCLE_LENGTH;
+                bbr->pacing_gain = bbr_cycle_gain[bbr->cycle_index];
+                bbr->cycle_stamp = now;
+            }
+            break;
+        case BBR_PROBE_RTT:
+            if (bbr->probe_rtt_done == 0 && cc->inflight <= (uint64_t)BBR_MIN_WINDOW * cc->mss)
+            {
+                const uint64_t duration = (bbr->min_rtt > BBR_PROBE_RTT_TIME) ? bbr->min_rtt : BBR_PROBE_RTT_TIME;
+                bbr->probe_rtt_done = now + duration;
+            }
+            else if (bbr->probe_rtt_done != 0 && now >= bbr->probe_rtt_done)
+            {
+                bbr->min_rtt_stamp = now;
+                if (bbr->prior_cwnd > cc->cwnd)
+                    cc->cwnd = bbr->prior_cwnd;
+
+                if (bbr->full_bw_reached)
+                {
+                    bbr_enter_probe_bw(bbr, now);
+                }
+                else
+                {
+                    bbr->mode = BBR_STARTUP;
+                    bbr->pacing_gain = BBR_HIGH_GAIN;
+                    bbr->cwnd_gain = BBR_HIGH_GAIN;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static
+void
+bbr_on_init(clarinet_cc* cc,
+            uint64_t now)
+{
+    struct bbr* bbr = (struct bbr*)cc->state;
+    memset(bbr, 0, sizeof(struct bbr));
+    bbr->mode = BBR_STARTUP;
+    bbr->pacing_gain = BBR_HIGH_GAIN;
+    bbr->cwnd_gain = BBR_HIGH_GAIN;
+    bbr->inflight_hi = UINT64_MAX;
+    bbr->round_start = now;
+    bbr->min_rtt_stamp = now;
+}
+
+static
+void
+bbr_on_ack(clarinet_cc* cc,
+           size_t bytes,
+           uint64_t now)
+{
+    struct bbr* bbr = (struct bbr*)cc->state;
+    bbr_update_round(cc, bbr, now);
+    bbr_update_mode(cc, bbr, now);
+
+    const uint64_t min_window = (uint64_t)BBR_MIN_WINDOW * cc->mss;
+    const uint64_t bdp = bbr_bdp(bbr);
+    uint64_t target = (bdp > 0) ? bdp * bbr->cwnd_gain / BBR_UNIT + 3 * (uint64_t)cc->mss
+                                : (uint64_t)CC_INITIAL_WINDOW * cc->mss;
+    if (target > bbr->inflight_hi)
+        target = bbr->inflight_hi;
+
+    /* Grow by the bytes acknowledged until the target is reached but only shrink towards it once the pipe is full so a
+     * poor early estimate does not stall startup. */
+    uint64_t cwnd = cc->cwnd;
+    if (bbr->full_bw_reached)
+        cwnd = (cwnd + bytes < target) ? cwnd + bytes : target;
+    else if (cwnd < target || cc->delivered < (uint64_t)CC_INITIAL_WINDOW * cc->mss)
+        cwnd += bytes;
+
+    if (cwnd > bbr->inflight_hi)
+        cwnd = bbr->inflight_hi;
+
+    if (cwnd < min_window)
+        cwnd = min_window;
+
+    if (bbr->mode == BBR_PROBE_RTT)
+        cwnd = min_window;
+
+    cc->cwnd = cwnd;
+}
+
+static
+void
+bbr_on_loss(clarinet_cc* cc,
+            size_t bytes,
+            uint64_t now)
+{
+    (void)bytes;
+
+    /* Losses are accounted per round. */
+    struct bbr* bbr = (struct bbr*)cc->state;
+    bbr_update_round(cc, bbr, now);
+}
+
+static
+void
+bbr_on_rtt_sample(clarinet_cc* cc,
+                  uint32_t rtt,
+                  uint64_t now)
+{
+    struct bbr* bbr = (struct bbr*)cc->state;
+    const int expired = (now - bbr->min_rtt_stamp > BBR_MIN_RTT_WINDOW);
+    if (bbr->min_rtt == 0 || rtt <= bbr->min_rtt || expired)
+    {
+        bbr->min_rtt = rtt;
+        bbr->min_rtt_stamp = now;
+    }
+
+    /* An estimate that has not been refreshed in a while may be stale (e.g. a route change) so the queue is drained
+     * to observe the propagation delay again. */
+    if (expired && bbr->mode != BBR_PROBE_RTT)
+    {
+        bbr->mode = BBR_PROBE_RTT;
+        bbr->pacing_gain = BBR_UNIT;
+        bbr->cwnd_gain = BBR_UNIT;
+        bbr->prior_cwnd = cc->cwnd;
+        bbr->probe_rtt_done = 0;
+        cc->cwnd = (uint64_t)BBR_MIN_WINDOW * cc->mss;
+    }
+}
+
+static
+uint64_t
+bbr_pacing_rate(const clarinet_cc* cc)
+{
+    const struct bbr* bbr = (const struct bbr*)cc->state;
+    const uint64_t bw = bbr_bw(bbr);
+    if (bw > 0)
+        return bw * bbr->pacing_gain / BBR_UNIT;
+
+    /* Before the first sample the initial window is paced over the round-trip time (or 1ms if unknown). */
+    const uint64_t rtt = cc->srtt ? cc->srtt : 1000u;
+    return cc->cwnd * CC_USEC / rtt * bbr->pacing_gain / BBR_UNIT;
+}
+
+#define CUBIC_C                 0.4         /* scaling constant in segments per second cubed */
+#define CUBIC_BETA              0.7         /* multiplicative decrease factor */
+#define CUBIC_MIN_WINDOW        2           /* minimum congestion window in segments */
+
+struct cubic
+{
+    uint64_t ssthresh;              /* slow start threshold in bytes */
+    uint64_t w_max;                 /* window before the last reduction in bytes */
+    uint64_t origin;                /* window at which the cubic function plateaus in bytes */
+    uint64_t epoch_start;           /* time at which the current congestion avoidance epoch started or 0 */
+    uint64_t recovery_end;          /* time until which further losses belong to the same congestion event */
+    double k;                       /* time in seconds the cubic function takes to reach the origin */
+    double w_est;                   /* window NewReno would have in bytes */
+};
+
+/** Helper to compute a cube root using Newton's method which avoids a dependency on libm. */
+static
+double
+cubic_cbrt(double x)
+{
+    if (x <= 0.0)
+        return 0.0;
+
+    double y = (x > 1.0) ? x / 3.0 : 1.0;
+    for (int i = 0; i < 64; ++i)
+    {
+        const double next = (2.0 * y + x / (y * y)) / 3.0;
+        if (next >= y * (1.0 - 1e-12) && next <= y * (1.0 + 1e-12))
+            return next;
+        y = next;
+    }
+
+    return y;
+}
+
+static
+void
+cubic_on_init(clarinet_cc* cc,
+              uint64_t now)
+{
+    (void)now;
+
+    struct cubic* cubic = (struct cubic*)cc->state;
+    memset(cubic, 0, sizeof(struct cubic));
+    cubic->ssthresh = UINT64_MAX;
+}
+
+static
+void
+cubic_on_ack(clarinet_cc* cc,
+             size_t bytes,
+             uint64_t now)
+{
+    struct cubic* cubic = (struct cubic*)cc->state;
+
+    /* The window does not grow while the congestion event is being recovered from. */
+    if (now < cubic->recovery_end)
+        return;
+
+    if (cc->cwnd < cubic->ssthresh)
+    {
+        cc->cwnd += bytes;
+        return;
+    }
+
+    const double mss = (double)cc->mss;
+    const double cwnd = (double)cc->cwnd;
+    if (cubic->epoch_start == 0)
+    {
+        cubic->epoch_start = now;
+        cubic->w_est = cwnd;
+        if (cc->cwnd < cubic->w_max)
+        {
+            cubic->k = cubic_cbrt((double)(cubic->w_max - cc->cwnd) / mss / CUBIC_C);
+            cubic->origin = cubic->w_max;
+        }
+        else
+        {
+            cubic->k = 0.0;
+            cubic->origin = cc->cwnd;
+        }
+    }
+
+    /* Aim for the window the cubic function reaches one round-trip time from now but never grow more than 50% per
+     * round-trip time nor slower than NewReno. */
+    const double t = (double)(now - cubic->epoch_start + cc->srtt) / CC_USEC - cubic->k;
+    double target = (double)cubic->origin + CUBIC_C * t * t * t * mss;
+    if (target > 1.5 * cwnd)
+        target = 1.5 * cwnd;
+
+    cubic->w_est += 3.0 * (1.0 - CUBIC_BETA) / (1.0 + CUBIC_BETA) * (double)bytes * mss / cwnd;
+    if (cubic->w_est > target)
+        target = cubic->w_est;
+
+    if (target > cwnd)
+        cc->cwnd += (uint64_t)((target - cwnd) * (double)bytes / cwnd);
+}
+
+static
+void
+cubic_on_loss(clarinet_cc* cc,
+              size_t bytes,
+              uint64_t now)
+{
+    (void)bytes;
+
+    struct cubic* cubic = (struct cubic*)cc->state;
+    if (now < cubic->recovery_end)
+        return;
+
+    /* Fast convergence: release bandwidth faster if the window keeps being reduced before reaching the last maximum. */
+    const uint64_t w_max = cc->cwnd;
+    if (w_max < cubic->w_max)
+        cubic->w_max = (uint64_t)((double)w_max * (1.0 + CUBIC_BETA) / 2.0);
+    else
+        cubic->w_max = w_max;
+
+    const uint64_t min_window = (uint64_t)CUBIC_MIN_WINDOW * cc->mss;
+    const uint64_t cwnd = (uint64_t)((double)cc->cwnd * CUBIC_BETA);
+    cc->cwnd = (cwnd > min_window) ? cwnd : min_window;
+    cubic->ssthresh = cc->cwnd;
+    cubic->epoch_start = 0;
+    cubic->recovery_end = now + cc->srtt;
+}
+
+static
+void
+cubic_on_rtt_sample(clarinet_cc* cc,
+                    uint32_t rtt,
+                    uint64_t now)
+{
+    (void)cc;
+    (void)rtt;
+    (void)now;
+}
+
+static
+uint64_t
+cubic_pacing_rate(const clarinet_cc* cc)
+{
+    if (cc->srtt == 0)
+        return 0;
+
+    /* Pace a bit faster than the window would be delivered in one round-trip time so the window remains the limit. */
+    const struct cubic* cubic = (const struct cubic*)cc->state;
+    const uint64_t rate = cc->cwnd * CC_USEC / cc->srtt;
+    return (cc->cwnd < cubic->ssthresh) ? rate * 2 : rate + rate / 5;
+}
+
+/** Helper to refresh the pacing rate after the state of the algorithm changed. */
+CLARINET_STATIC_INLINE
+void
+cc_update(clarinet_cc* cc)
+{
+    cc->pacing_rate = cc->algorithm->pacing_rate(cc);
+}
+
+/* endregion */
+
+/* region Congestion Control */
+
+const clarinet_cc_algorithm*
+clarinet_cc_bbr(void)
+{
+    static const clarinet_cc_algorithm bbr = {
+        "bbr", bbr_on_init, bbr_on_ack, bbr_on_loss, bbr_on_rtt_sample, bbr_pacing_rate
+    };
+
+    return &bbr;
+}
+
+const clarinet_cc_algorithm*
+clarinet_cc_cubic(void)
+{
+    static const clarinet_cc_algorithm cubic = {
+        "cubic", cubic_on_init, cubic_on_ack, cubic_on_loss, cubic_on_rtt_sample, cubic_pacing_rate
+    };
+
+    return &cubic;
+}
+
+void
+clarinet_cc_init(clarinet_cc* cc)
+{
+    memset(cc, 0, sizeof(clarinet_cc));
+}
+
+int
+clarinet_cc_open(clarinet_cc* restrict cc,
+                 const clarinet_cc_algorithm* restrict algorithm,
+                 uint32_t mss,
+                 uint64_t now)
+{
+    if (!cc || clarinet_cc_is_open(cc) || !algorithm || mss == 0)
+        return CLARINET_EINVAL;
+
+    if (!algorithm->on_ack || !algorithm->on_loss || !algorithm->on_rtt_sample || !algorithm->pacing_rate)
+        return CLARINET_EINVAL;
+
+    void* data = cc->data;
+    clarinet_cc_init(cc);
+    cc->algorithm = algorithm;
+    cc->data = data;
+    cc->mss = mss;
+    cc->cwnd = (uint64_t)CC_INITIAL_WINDOW * mss;
+    cc->next_send = now;
+
+    if (algorithm->on_init)
+        algorithm->on_init(cc, now);
+
+    cc_update(cc);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_close(clarinet_cc* cc)
+{
+    if (!cc || !clarinet_cc_is_open(cc))
+        return CLARINET_EINVAL;
+
+    void* data = cc->data;
+    clarinet_cc_init(cc);
+    cc->data = data;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_can_send(const clarinet_cc* cc,
+                     size_t bytes,
+                     uint64_t now)
+{
+    if (!cc || !clarinet_cc_is_open(cc))
+        return CLARINET_EINVAL;
+
+    if (cc->inflight + bytes > cc->cwnd || now < cc->next_send)
+        return CLARINET_EAGAIN;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_on_send(clarinet_cc* cc,
+                    size_t bytes,
+                    uint64_t now)
+{
+    if (!cc || !clarinet_cc_is_open(cc))
+        return CLARINET_EINVAL;
+
+    cc->inflight += bytes;
+
+    /* Time not used while idle is not credited otherwise a burst would follow every pause. */
+    if (cc->pacing_rate > 0)
+    {
+        const uint64_t start = (cc->next_send > now) ? cc->next_send : now;
+        cc->next_send = start + (uint64_t)bytes * CC_USEC / cc->pacing_rate;
+    }
+    else
+    {
+        cc->next_send = now;
+    }
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_on_ack(clarinet_cc* cc,
+                   size_t bytes,
+                   uint64_t now)
+{
+    if (!cc || !clarinet_cc_is_open(cc))
+        return CLARINET_EINVAL;
+
+    cc->inflight = (cc->inflight > bytes) ? cc->inflight - bytes : 0;
+    cc->delivered += bytes;
+    cc->algorithm->on_ack(cc, bytes, now);
+    cc_update(cc);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_on_loss(clarinet_cc* cc,
+                    size_t bytes,
+                    uint64_t now)
+{
+    if (!cc || !clarinet_cc_is_open(cc))
+        return CLARINET_EINVAL;
+
+    cc->inflight = (cc->inflight > bytes) ? cc->inflight - bytes : 0;
+    cc->lost += bytes;
+    cc->algorithm->on_loss(cc, bytes, now);
+    cc_update(cc);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_cc_on_rtt_sample(clarinet_cc* cc,
+                          uint32_t rtt,
+                          uint64_t now)
+{
+    if (!cc || !clarinet_cc_is_open(cc) || rtt == 0)
+        return CLARINET_EINVAL;
+
+    cc->srtt = cc->srtt ? (uint32_t)(((uint64_t)cc->srtt * 7 + rtt) / 8) : rtt;
+    if (cc->min_rtt == 0 || rtt < cc->min_rtt)
+        cc->min_rtt = rtt;
+
+    cc->algorithm->on_rtt_sample(cc, rtt, now);
+    cc_update(cc);
+
+    return CLARINET_ENONE;
+}
+
+/* endregion */
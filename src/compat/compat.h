@@ -21,6 +21,11 @@
     #include "config.h"
 #endif
 
+/* GNU extensions must be requested before any system header is included. */
+#if (HAVE_RECVMMSG || HAVE_SENDMMSG || HAVE_SCHED_SETAFFINITY) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
 /* Use UNICODE variants of the WINAPI. This is important because the ANSI version of some functions have limitations.
  * For example, GetAddrInfoExW can perform asynchronously but GetAddrInfoExA cannot.
  */
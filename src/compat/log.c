@@ -0,0 +1,512 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/log.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+/* region Helpers */
+
+#if CLARINET_ENABLE_LOG
+
+#if defined(_MSC_VER)
+#define CLARINET_THREAD_LOCAL __declspec(thread)
+#else
+#define CLARINET_THREAD_LOCAL __thread
+#endif
+
+int32_t clarinet_log_threshold = CLARINET_LOG_LEVEL_NONE;
+
+/** Log currently open. Written by open/close and read by every writer. */
+static clarinet_log* log_active;
+
+/** Last epoch assigned to a log. Epochs let writers detect that their ring belongs to a log that was closed. */
+static uint32_t log_epoch;
+
+/** Ring attached to the calling thread and the epoch of the log it belongs to. */
+static CLARINET_THREAD_LOCAL clarinet_log_ring* log_ring;
+static CLARINET_THREAD_LOCAL uint32_t log_ring_epoch;
+
+#if defined(_WIN32)
+/** Frequency of the performance counter, which is fixed at system boot. */
+static LARGE_INTEGER log_frequency;
+#endif
+
+CLARINET_STATIC_INLINE
+uint64_t
+log_load_acquire(const uint64_t* p)
+{
+    #if defined(_MSC_VER)
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+    #else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+void
+log_store_release(uint64_t* p,
+                  uint64_t value)
+{
+    #if defined(_MSC_VER)
+    InterlockedExchange64((volatile LONG64*)p, (LONG64)value);
+    #else
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+uint64_t
+log_exchange(uint64_t* p,
+             uint64_t value)
+{
+    #if defined(_MSC_VER)
+    return (uint64_t)InterlockedExchange64((volatile LONG64*)p, (LONG64)value);
+    #else
+    return __atomic_exchange_n(p, value, __ATOMIC_RELAXED);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+void
+log_add(uint64_t* p,
+        uint64_t n)
+{
+    #if defined(_MSC_VER)
+    InterlockedExchangeAdd64((volatile LONG64*)p, (LONG64)n);
+    #else
+    __atomic_fetch_add(p, n, __ATOMIC_RELAXED);
+    #endif
+}
+
+/** Helper to atomically set the flag pointed to by @p p if it is clear. Returns non-zero on success. */
+CLARINET_STATIC_INLINE
+int
+log_acquire_flag(uint32_t* p)
+{
+    #if defined(_MSC_VER)
+    return InterlockedCompareExchange((volatile LONG*)p, 1, 0) == 0;
+    #else
+    uint32_t expected = 0;
+    return __atomic_compare_exchange_n(p, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+void
+log_release_flag(uint32_t* p)
+{
+    #if defined(_MSC_VER)
+    InterlockedExchange((volatile LONG*)p, 0);
+    #else
+    __atomic_store_n(p, 0, __ATOMIC_RELEASE);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+void
+log_set_threshold(int32_t level)
+{
+    #if defined(_MSC_VER)
+    InterlockedExchange((volatile LONG*)&clarinet_log_threshold, level);
+    #else
+    __atomic_store_n(&clarinet_log_threshold, level, __ATOMIC_RELAXED);
+    #endif
+}
+
+CLARINET_STATIC_INLINE
+clarinet_log*
+log_get_active(void)
+{
+    #if defined(_MSC_VER)
+    return (clarinet_log*)InterlockedCompareExchangePointer((PVOID volatile*)&log_active, NULL, NULL);
+    #else
+    return __atomic_load_n(&log_active, __ATOMIC_ACQUIRE);
+    #endif
+}
+
+/** Helper to replace the active log by @p desired if it is @p expected. Returns non-zero on success. */
+CLARINET_STATIC_INLINE
+int
+log_swap_active(clarinet_log* expected,
+                clarinet_log* desired)
+{
+    #if defined(_MSC_VER)
+    return InterlockedCompareExchangePointer((PVOID volatile*)&log_active, desired, expected) == expected;
+    #else
+    return __atomic_compare_exchange_n(&log_active, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    #endif
+}
+
+/** Helper to read a monotonic clock in nanoseconds. */
+CLARINET_STATIC_INLINE
+uint64_t
+log_now(void)
+{
+    #if defined(_WIN32)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+    const uint64_t frequency = (uint64_t)log_frequency.QuadPart;
+    return (ticks / frequency) * 1000000000u + ((ticks % frequency) * 1000000000u) / frequency;
+    #else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    #endif
+}
+
+/** Helper to attach the calling thread to a free ring of @p log. Returns NULL if all rings are taken. */
+static
+clarinet_log_ring*
+log_attach(clarinet_log* log)
+{
+    for (size_t i = 0; i < log->count; ++i)
+    {
+        clarinet_log_ring* ring = &log->rings[i];
+        if (log_acquire_flag(&ring->owner))
+        {
+            log_ring = ring;
+            log_ring_epoch = log->epoch;
+            return ring;
+        }
+    }
+
+    return NULL;
+}
+
+/** Helper to format a record and pass it to the sink of @p log. */
+static
+void
+log_deliver(const clarinet_log* restrict log,
+            const clarinet_log_record* restrict record,
+            char* restrict message)
+{
+    if (log->sink)
+    {
+        clarinet_log_format(message, CLARINET_LOG_MESSAGE_SIZE, record); /* a truncated message is still delivered */
+        log->sink(log->context, record, message);
+    }
+}
+
+#endif /* CLARINET_ENABLE_LOG */
+
+#define CLARINET_DECLARE_ENUM_FORMAT(e, v, s) case (e): return (s);
+
+/** Helper to obtain the format string of an event. Returns NULL if the event is unknown. */
+static
+const char*
+log_event_format(int event)
+{
+    switch (event)
+    {
+        CLARINET_LOG_EVENTS(CLARINET_DECLARE_ENUM_FORMAT)
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * Expands the event format @p format into @p dst substituting each @c %lld with the next argument in @p args and each
+ * @c %% with a single percent sign. The format is never handed to the printf family so it does not have to be a string
+ * literal. Returns the length of the expanded message like @c snprintf, even if it was truncated to fit @p dstlen.
+ */
+static
+size_t
+log_expand(char* restrict dst,
+           size_t dstlen,
+           const char* restrict format,
+           const long long* restrict args)
+{
+    size_t n = 0;
+    size_t i = 0;
+    while (*format)
+    {
+        char number[24];
+        const char* chunk = format;
+        size_t len = 1;
+        if (format[0] == '%' && format[1] == '%')
+        {
+            format += 2;
+        }
+        else if (strncmp(format, "%lld", 4) == 0 && i < CLARINET_LOG_ARGS)
+        {
+            const int written = snprintf(number, sizeof(number), "%lld", args[i++]);
+            chunk = number;
+            len = written > 0 ? (size_t)written : 0;
+            format += 4;
+        }
+        else
+        {
+            format++;
+        }
+
+        if (n < dstlen)
+            memcpy(dst + n, chunk, (dstlen - n) > len ? len : dstlen - n);
+        n += len;
+    }
+
+    dst[n < dstlen ? n : dstlen - 1] = '\0';
+    return n;
+}
+
+/* endregion */
+
+/* region Log */
+
+void
+clarinet_log_init(clarinet_log* log)
+{
+    memset(log, 0, sizeof(clarinet_log));
+}
+
+int
+clarinet_log_open(clarinet_log* restrict log,
+                  clarinet_log_ring* restrict rings,
+                  size_t count,
+                  clarinet_log_record* restrict records,
+                  uint32_t capacity)
+{
+    if (!log || log->rings || !rings || count == 0 || count > INT_MAX || !records)
+        return CLARINET_EINVAL;
+
+    if (capacity == 0 || capacity > CLARINET_LOG_CAPACITY_MAX || (capacity & (capacity - 1)) != 0)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_LOG
+    for (size_t i = 0; i < count; ++i)
+    {
+        memset(&rings[i], 0, sizeof(clarinet_log_ring));
+        rings[i].records = &records[i * capacity];
+    }
+
+    #if defined(_WIN32)
+    QueryPerformanceFrequency(&log_frequency);
+    #endif
+
+    log->rings = rings;
+    log->count = count;
+    log->capacity = capacity;
+    log->level = CLARINET_LOG_LEVEL_INFO;
+    log->draining = 0;
+    log->sink = NULL;
+    log->context = NULL;
+    #if defined(_MSC_VER)
+    log->epoch = (uint32_t)InterlockedIncrement((volatile LONG*)&log_epoch);
+    #else
+    log->epoch = __atomic_add_fetch(&log_epoch, 1, __ATOMIC_RELAXED);
+    #endif
+
+    if (!log_swap_active(NULL, log))
+    {
+        clarinet_log_init(log);
+        return CLARINET_EALREADY;
+    }
+
+    log_set_threshold(log->level);
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_log_close(clarinet_log* log)
+{
+    if (!log || !log->rings)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_LOG
+    if (log_swap_active(log, NULL))
+        log_set_threshold(CLARINET_LOG_LEVEL_NONE);
+    #endif
+
+    clarinet_log_init(log);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_log_setsink(clarinet_log* log,
+                     clarinet_log_sink sink,
+                     void* context)
+{
+    if (!log || !log->rings)
+        return CLARINET_EINVAL;
+
+    log->sink = sink;
+    log->context = context;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_log_setlevel(clarinet_log* log,
+                      int level)
+{
+    if (!log || !log->rings || level < CLARINET_LOG_LEVEL_TRACE || level > CLARINET_LOG_LEVEL_NONE)
+        return CLARINET_EINVAL;
+
+    log->level = level;
+
+    #if CLARINET_ENABLE_LOG
+    if (log_get_active() == log)
+        log_set_threshold(level);
+    #endif
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_log_write(int level,
+                   int event,
+                   int64_t a,
+                   int64_t b,
+                   int64_t c,
+                   int64_t d)
+{
+    if (level < CLARINET_LOG_LEVEL_TRACE || level >= CLARINET_LOG_LEVEL_NONE)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_LOG
+    clarinet_log* log = log_get_active();
+    if (!log)
+        return CLARINET_ENOTREADY;
+
+    if (!clarinet_log_enabled(level))
+        return CLARINET_ENONE;
+
+    clarinet_log_ring* ring = log_ring;
+    if (!ring || log_ring_epoch != log->epoch)
+    {
+        ring = log_attach(log);
+        if (!ring)
+            return CLARINET_ENOBUFS;
+    }
+
+    /* Only this thread writes the head so it can be read without ordering. The tail is acquired so the consumer is
+     * done with a record before it is overwritten. */
+    const uint64_t head = ring->head;
+    if (head - log_load_acquire(&ring->tail) >= log->capacity)
+    {
+        log_add(&ring->dropped, 1);
+        return CLARINET_ENOBUFS;
+    }
+
+    clarinet_log_record* record = &ring->records[head & (log->capacity - 1)];
+    record->timestamp = log_now();
+    record->level = level;
+    record->event = event;
+    record->args[0] = a;
+    record->args[1] = b;
+    record->args[2] = c;
+    record->args[3] = d;
+
+    log_store_release(&ring->head, head + 1);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(event);
+    CLARINET_IGNORE_PARAM(a);
+    CLARINET_IGNORE_PARAM(b);
+    CLARINET_IGNORE_PARAM(c);
+    CLARINET_IGNORE_PARAM(d);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_log_detach(void)
+{
+    #if CLARINET_ENABLE_LOG
+    const clarinet_log* log = log_get_active();
+    if (!log || !log_ring || log_ring_epoch != log->epoch)
+        return CLARINET_ENOTFOUND;
+
+    log_release_flag(&log_ring->owner);
+    log_ring = NULL;
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_log_drain(clarinet_log* log,
+                   size_t max)
+{
+    if (!log || !log->rings || max == 0 || max > INT_MAX)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_LOG
+    if (!log_acquire_flag(&log->draining))
+        return CLARINET_EINPROGRESS;
+
+    char message[CLARINET_LOG_MESSAGE_SIZE];
+    const uint64_t mask = log->capacity - 1;
+    size_t n = 0;
+    for (size_t i = 0; i < log->count && n < max; ++i)
+    {
+        clarinet_log_ring* ring = &log->rings[i];
+
+        const uint64_t dropped = log_exchange(&ring->dropped, 0);
+        if (dropped > 0)
+        {
+            clarinet_log_record record;
+            memset(&record, 0, sizeof(record));
+            record.timestamp = log_now();
+            record.level = CLARINET_LOG_LEVEL_WARN;
+            record.event = CLARINET_LOG_EVENT_DROPPED;
+            record.args[0] = (int64_t)dropped;
+            log_deliver(log, &record, message);
+            n++;
+        }
+
+        /* Only this thread writes the tail. The head is acquired so records are complete before they are read. The
+         * tail is released once per ring so the producer does not contend on it for every record. */
+        uint64_t tail = ring->tail;
+        const uint64_t head = log_load_acquire(&ring->head);
+        for (; tail != head && n < max; ++tail, ++n)
+            log_deliver(log, &ring->records[tail & mask], message);
+
+        log_store_release(&ring->tail, tail);
+    }
+
+    log_release_flag(&log->draining);
+    return (int)n;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_log_format(char* restrict dst,
+                    size_t dstlen,
+                    const clarinet_log_record* restrict record)
+{
+    if (!dst || dstlen == 0 || dstlen > INT_MAX || !record)
+        return CLARINET_EINVAL;
+
+    long long args[CLARINET_LOG_ARGS];
+    for (size_t i = 0; i < CLARINET_LOG_ARGS; ++i)
+        args[i] = (long long)record->args[i];
+
+    const char* format = log_event_format(record->event);
+    if (format)
+    {
+        const size_t n = log_expand(dst, dstlen, format, args);
+        return (n < dstlen) ? (int)n : CLARINET_ENOBUFS;
+    }
+
+    const int n = snprintf(dst, dstlen, "event %d: %lld %lld %lld %lld", record->event, args[0], args[1], args[2],
+                           args[3]);
+    if (n < 0)
+        return CLARINET_ESYS;
+
+    return ((size_t)n < dstlen) ? n : CLARINET_ENOBUFS;
+}
+
+/* endregion */
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef COMPAT_LOG_H
+#define COMPAT_LOG_H
+
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+/*
+ * Internal log instrumentation. Without CLARINET_ENABLE_LOG the macro expands to nothing so that call sites need no
+ * conditional compilation.
+ */
+
+#if CLARINET_ENABLE_LOG
+
+/** Minimum level of the records accepted by the open log or @c CLARINET_LOG_LEVEL_NONE when no log is open. */
+extern int32_t clarinet_log_threshold;
+
+/** Returns non-zero if a record of level @p level would be accepted by the open log. */
+CLARINET_STATIC_INLINE
+int
+clarinet_log_enabled(int level)
+{
+    #if defined(_MSC_VER)
+    return level >= *(volatile int32_t*)&clarinet_log_threshold;
+    #else
+    return level >= __atomic_load_n(&clarinet_log_threshold, __ATOMIC_RELAXED);
+    #endif
+}
+
+/** Write a record if its level is accepted by the open log. Arguments are only evaluated when they are written. */
+#define clarinet_log(level, event, a, b, c, d) \
+    (clarinet_log_enabled(level) \
+        ? (void)clarinet_log_write((level), (event), (int64_t)(a), (int64_t)(b), (int64_t)(c), (int64_t)(d)) \
+        : (void)0)
+
+#else /* !CLARINET_ENABLE_LOG */
+
+#define clarinet_log(level, event, a, b, c, d) ((void)0)
+
+#endif /* CLARINET_ENABLE_LOG */
+
+#endif /* COMPAT_LOG_H */
@@ -0,0 +1,95 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+/** Returns true (non-zero) if the fanout pointed to by @p f is open. */
+#define clarinet_mcast_fanout_is_open(f) ((f)->socket != NULL)
+
+/* endregion */
+
+/* region Multicast Fanout */
+
+void
+clarinet_mcast_fanout_init(clarinet_mcast_fanout* fanout)
+{
+    memset(fanout, 0, sizeof(clarinet_mcast_fanout));
+}
+
+int
+clarinet_mcast_fanout_open(clarinet_mcast_fanout* restrict fanout,
+                           clarinet_socket* restrict sp,
+                           const clarinet_endpoint* restrict group,
+                           uint32_t iface,
+                           uint8_t ttl,
+                           uint32_t flags)
+{
+    if (!fanout || clarinet_mcast_fanout_is_open(fanout) || !sp || !group
+        || (flags & ~(uint32_t)CLARINET_MCAST_FANOUT_LOOP))
+        return CLARINET_EINVAL;
+
+    if (!clarinet_addr_is_multicast_ip(&group->addr) || group->port == 0 || sp->family != group->addr.family)
+        return CLARINET_EINVAL;
+
+    const uint32_t hops = ttl;
+    int errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_TTL, &hops, sizeof(hops));
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    const uint32_t loop = (flags & CLARINET_MCAST_FANOUT_LOOP) ? 1 : 0;
+    errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_LOOP, &loop, sizeof(loop));
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    /* Leave the choice to the routing table unless an interface is requested so platforms that cannot select an IPv4
+     * interface by index still work by default. */
+    if (iface != 0)
+    {
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_IF, &iface, sizeof(iface));
+        if (errcode != CLARINET_ENONE)
+            return errcode;
+    }
+
+    fanout->socket = sp;
+    fanout->group = *group;
+    fanout->iface = iface;
+    fanout->flags = flags;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_mcast_fanout_close(clarinet_mcast_fanout* fanout)
+{
+    if (!fanout || !clarinet_mcast_fanout_is_open(fanout))
+        return CLARINET_EINVAL;
+
+    clarinet_mcast_fanout_init(fanout);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_mcast_fanout_send(clarinet_mcast_fanout* restrict fanout,
+                           const void* restrict buf,
+                           size_t buflen)
+{
+    if (!fanout || !clarinet_mcast_fanout_is_open(fanout))
+        return CLARINET_EINVAL;
+
+    return clarinet_socket_sendto(fanout->socket, buf, buflen, &fanout->group);
+}
+
+int
+clarinet_mcast_fanout_sendv(clarinet_mcast_fanout* restrict fanout,
+                            const clarinet_iovec* restrict iov,
+                            size_t iovcnt)
+{
+    if (!fanout || !clarinet_mcast_fanout_is_open(fanout))
+        return CLARINET_EINVAL;
+
+    return clarinet_socket_sendtov(fanout->socket, iov, iovcnt, &fanout->group);
+}
+
+/* endregion */
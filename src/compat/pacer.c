@@ -0,0 +1,137 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+#include <limits.h>
+
+/* region Helpers */
+
+/** Returns true (non-zero) if the pacer pointed to by @p p is open. */
+#define clarinet_pacer_is_open(p) ((p)->socket != NULL)
+
+/** Returns the time in microseconds that @p bytes take to be transmitted at @p rate (non-zero) bytes per second. */
+CLARINET_STATIC_INLINE
+uint64_t
+pacer_duration(uint64_t rate,
+               size_t bytes)
+{
+    /* Rounded up without adding to the dividend which could overflow with very large rates */
+    const uint64_t scaled = (uint64_t)bytes * 1000000;
+    return scaled / rate + (scaled % rate != 0);
+}
+
+/** Returns the earliest time the pacer pointed to by @p pacer accepts a datagram. */
+CLARINET_STATIC_INLINE
+uint64_t
+pacer_ready(const clarinet_pacer* pacer)
+{
+    /* Datagrams with transmit times may be handed to the system up to the horizon in advance. */
+    if (pacer->flags & CLARINET_PACER_TXTIME)
+        return pacer->next > CLARINET_PACER_HORIZON ? pacer->next - CLARINET_PACER_HORIZON : 0;
+
+    return pacer->next;
+}
+
+/* endregion */
+
+/* region Pacer */
+
+void
+clarinet_pacer_init(clarinet_pacer* pacer)
+{
+    memset(pacer, 0, sizeof(clarinet_pacer));
+}
+
+int
+clarinet_pacer_open(clarinet_pacer* restrict pacer,
+                    clarinet_socket* restrict sp,
+                    uint64_t rate,
+                    uint32_t flags)
+{
+    if (!pacer || clarinet_pacer_is_open(pacer) || !sp || (flags & ~(uint32_t)CLARINET_PACER_USERSPACE))
+        return CLARINET_EINVAL;
+
+    if (!(flags & CLARINET_PACER_USERSPACE))
+    {
+        /* Any failure just means the system cannot pace this socket so the pacer does it in user space. */
+        const int32_t enabled = 1;
+        if (clarinet_socket_setopt(sp, CLARINET_SO_TXTIME, &enabled, sizeof(enabled)) == CLARINET_ENONE)
+            flags |= CLARINET_PACER_TXTIME;
+    }
+
+    pacer->socket = sp;
+    pacer->rate = rate;
+    pacer->next = 0;
+    pacer->flags = flags;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pacer_close(clarinet_pacer* pacer)
+{
+    if (!pacer || !clarinet_pacer_is_open(pacer))
+        return CLARINET_EINVAL;
+
+    clarinet_pacer_init(pacer);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pacer_setrate(clarinet_pacer* pacer,
+                       uint64_t rate)
+{
+    if (!pacer || !clarinet_pacer_is_open(pacer))
+        return CLARINET_EINVAL;
+
+    pacer->rate = rate;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pacer_sendto(clarinet_pacer* restrict pacer,
+                      const void* restrict buf,
+                      size_t buflen,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now)
+{
+    if (!pacer || !clarinet_pacer_is_open(pacer))
+        return CLARINET_EINVAL;
+
+    if (pacer->rate == 0)
+        return clarinet_socket_sendto(pacer->socket, buf, buflen, remote);
+
+    if (pacer_ready(pacer) > now)
+        return CLARINET_EAGAIN;
+
+    /* An idle pacer starts over from the current time so it never sends a burst to catch up. */
+    const uint64_t start = pacer->next > now ? pacer->next : now;
+
+    const int n = (pacer->flags & CLARINET_PACER_TXTIME)
+                  ? clarinet_socket_sendtoat(pacer->socket, buf, buflen, remote, start)
+                  : clarinet_socket_sendto(pacer->socket, buf, buflen, remote);
+    if (n < 0)
+        return n;
+
+    pacer->next = start + pacer_duration(pacer->rate, (size_t)n);
+    return n;
+}
+
+int
+clarinet_pacer_timeout(const clarinet_pacer* pacer,
+                       uint64_t now)
+{
+    if (!pacer || !clarinet_pacer_is_open(pacer))
+        return -1;
+
+    if (pacer->rate == 0)
+        return 0;
+
+    const uint64_t ready = pacer_ready(pacer);
+    if (ready <= now)
+        return 0;
+
+    return ready - now > INT_MAX ? INT_MAX : (int)(ready - now);
+}
+
+/* endregion */
@@ -0,0 +1,454 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+#include <limits.h>
+
+/* region Helpers */
+
+/** Largest UDP payload that fits in an IPv4 datagram. */
+#define PMTU_SIZE_MAX       65507
+
+/** Block of zeros used to pad probes. Probes of any size fit in CLARINET_IOVEC_MAX - 1 blocks. */
+#define PMTU_PADDING_SIZE   2048
+
+/** Maximum number of times the delay after a black hole is doubled. */
+#define PMTU_BACKOFF_MAX    16
+
+/** Returns true (non-zero) if the prober pointed to by @p p is open. */
+#define clarinet_pmtu_prober_is_open(p) ((p)->state != CLARINET_PMTU_STATE_CLOSED)
+
+/** Returns true (non-zero) if the cache pointed to by @p c is open. */
+#define clarinet_pmtu_cache_is_open(c) ((c)->entries != NULL)
+
+static const uint8_t pmtu_padding[PMTU_PADDING_SIZE];
+
+/** Helper to calculate the delay before searching again after a black hole. */
+CLARINET_STATIC_INLINE
+uint64_t
+pmtu_backoff_delay(const clarinet_pmtu_prober* prober)
+{
+    const uint64_t delay = (uint64_t)prober->timeout << prober->backoff;
+    return delay < CLARINET_PMTU_RAISE_TIMEOUT ? delay : CLARINET_PMTU_RAISE_TIMEOUT;
+}
+
+/** Helper to start a new search for a size larger than the one confirmed. */
+CLARINET_STATIC_INLINE
+void
+pmtu_search(clarinet_pmtu_prober* prober,
+            uint32_t hint,
+            uint64_t next)
+{
+    prober->state = CLARINET_PMTU_STATE_SEARCHING;
+    prober->high = prober->max;
+    prober->hint = hint;
+    prober->count = 0;
+    prober->next = next;
+}
+
+/** Helper to choose the size of the next probe. Returns 0 if the search is complete. */
+static
+uint32_t
+pmtu_candidate(clarinet_pmtu_prober* prober)
+{
+    if (prober->state != CLARINET_PMTU_STATE_SEARCHING)
+        return prober->base;
+
+    /* A hint that is no longer above the size confirmed or below the limit of the search is useless. */
+    if (prober->hint > prober->pmtu && prober->hint <= prober->high)
+        return prober->hint;
+
+    prober->hint = 0;
+    if (prober->high <= prober->pmtu)
+        return 0;
+
+    return prober->pmtu + (prober->high - prober->pmtu + 1) / 2;
+}
+
+/** Helper to complete the search if there is no size left to probe. */
+CLARINET_STATIC_INLINE
+void
+pmtu_settle(clarinet_pmtu_prober* prober,
+            uint64_t now)
+{
+    if (pmtu_candidate(prober) == 0)
+    {
+        prober->state = CLARINET_PMTU_STATE_COMPLETE;
+        prober->next = now + CLARINET_PMTU_RAISE_TIMEOUT;
+    }
+}
+
+/** Helper to handle a size confirmed by the acknowledgement of a probe. */
+static
+void
+pmtu_confirm(clarinet_pmtu_prober* prober,
+             uint32_t size,
+             uint64_t now)
+{
+    prober->probe = 0;
+    prober->count = 0;
+    prober->losses = 0;
+
+    if (prober->state != CLARINET_PMTU_STATE_SEARCHING)
+    {
+        /* The base size works again. Larger sizes are only searched after a delay because the black hole may still be
+         * there. */
+        prober->pmtu = prober->base;
+        pmtu_search(prober, 0, now + pmtu_backoff_delay(prober));
+        return;
+    }
+
+    /* A confirmed hint completes the search because larger sizes are assumed to have been found too big before. */
+    prober->pmtu = size;
+    if (size == prober->hint)
+    {
+        prober->high = size;
+        prober->hint = 0;
+    }
+
+    prober->next = now;
+    pmtu_settle(prober, now);
+}
+
+/** Helper to handle a size considered too big. */
+static
+void
+pmtu_reject(clarinet_pmtu_prober* prober,
+            uint32_t size,
+            uint64_t now)
+{
+    prober->probe = 0;
+    prober->count = 0;
+
+    if (prober->state != CLARINET_PMTU_STATE_SEARCHING)
+    {
+        prober->state = CLARINET_PMTU_STATE_ERROR;
+        prober->next = now + pmtu_backoff_delay(prober);
+        return;
+    }
+
+    if (size == prober->hint)
+        prober->hint = 0;
+
+    if (size - 1 < prober->high)
+        prober->high = size - 1;
+
+    prober->next = now;
+    pmtu_settle(prober, now);
+}
+
+/** Helper to find the entry of an address. IPv4 mapped to IPv6 addresses hash as their IPv4 form. */
+CLARINET_STATIC_INLINE
+clarinet_pmtu_cache_entry*
+pmtu_cache_slot(const clarinet_pmtu_cache* restrict cache,
+                const clarinet_addr* restrict addr)
+{
+    clarinet_endpoint endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.addr = *addr;
+    const uint64_t hash = clarinet_endpoint_hash(&endpoint, cache->seed, CLARINET_ENDPOINT_TABLE_EQUIVALENT);
+    return &cache->entries[hash & (cache->capacity - 1)];
+}
+
+/* endregion */
+
+/* region Path MTU Prober */
+
+void
+clarinet_pmtu_prober_init(clarinet_pmtu_prober* prober)
+{
+    memset(prober, 0, sizeof(clarinet_pmtu_prober));
+}
+
+int
+clarinet_pmtu_prober_open(clarinet_pmtu_prober* prober,
+                          uint32_t base,
+                          uint32_t max,
+                          uint32_t hint,
+                          uint32_t timeout,
+                          uint64_t now)
+{
+    if (!prober || clarinet_pmtu_prober_is_open(prober) || base == 0 || max < base || max > PMTU_SIZE_MAX)
+        return CLARINET_EINVAL;
+
+    if ((hint != 0 && (hint < base || hint > max)) || timeout == 0)
+        return CLARINET_EINVAL;
+
+    clarinet_pmtu_prober_init(prober);
+    prober->base = base;
+    prober->max = max;
+    prober->pmtu = base;
+    prober->timeout = timeout;
+    pmtu_search(prober, hint ? hint : max, now);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_close(clarinet_pmtu_prober* prober)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober))
+        return CLARINET_EINVAL;
+
+    clarinet_pmtu_prober_init(prober);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_poll(clarinet_pmtu_prober* restrict prober,
+                          uint64_t now,
+                          uint32_t* restrict size)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober) || !size)
+        return CLARINET_EINVAL;
+
+    if (prober->probe)
+    {
+        if (now < prober->deadline)
+            return CLARINET_EAGAIN;
+
+        /* The probe is lost. Retry the same size until it has been lost too many times. */
+        const uint32_t lost = prober->probe;
+        prober->probe = 0;
+        if (prober->count >= CLARINET_PMTU_PROBES_MAX)
+            pmtu_reject(prober, lost, now);
+    }
+
+    if (now < prober->next)
+        return CLARINET_EAGAIN;
+
+    /* The raise timeout expired without black holes so the path is given the benefit of the doubt again. */
+    if (prober->state == CLARINET_PMTU_STATE_COMPLETE)
+    {
+        prober->backoff = 0;
+        pmtu_search(prober, prober->max, now);
+    }
+
+    const uint32_t candidate = pmtu_candidate(prober);
+    if (candidate == 0)
+    {
+        pmtu_settle(prober, now);
+        return CLARINET_EAGAIN;
+    }
+
+    prober->count++;
+    prober->probe = candidate;
+    prober->deadline = now + prober->timeout;
+    *size = candidate;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_sendto(clarinet_pmtu_prober* restrict prober,
+                            clarinet_socket* restrict sp,
+                            const void* restrict buf,
+                            size_t buflen,
+                            const clarinet_endpoint* restrict dst,
+                            uint64_t now)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober) || prober->probe == 0 || !sp || !dst)
+        return CLARINET_EINVAL;
+
+    if ((!buf && buflen > 0) || buflen > prober->probe)
+        return CLARINET_EINVAL;
+
+    clarinet_iovec iov[CLARINET_IOVEC_MAX];
+    size_t iovcnt = 0;
+    if (buflen > 0)
+    {
+        iov[iovcnt].base = (void*)buf;
+        iov[iovcnt].len = buflen;
+        iovcnt++;
+    }
+
+    for (size_t padding = prober->probe - buflen; padding > 0; iovcnt++)
+    {
+        iov[iovcnt].base = (void*)pmtu_padding;
+        iov[iovcnt].len = padding < PMTU_PADDING_SIZE ? padding : PMTU_PADDING_SIZE;
+        padding -= iov[iovcnt].len;
+    }
+
+    const int result = clarinet_socket_sendtov(sp, iov, iovcnt, dst);
+    if (result == CLARINET_EMSGSIZE)
+        pmtu_reject(prober, prober->probe, now);
+
+    return result;
+}
+
+int
+clarinet_pmtu_prober_on_ack(clarinet_pmtu_prober* prober,
+                            uint32_t size,
+                            uint64_t now)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober))
+        return CLARINET_EINVAL;
+
+    if (size > prober->base)
+        prober->losses = 0;
+
+    if (prober->probe != 0 && size == prober->probe)
+        pmtu_confirm(prober, size, now);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_on_loss(clarinet_pmtu_prober* prober,
+                             uint32_t size,
+                             uint64_t now)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober))
+        return CLARINET_EINVAL;
+
+    /* Only datagrams that depend on a size confirmed by a search count. Losses are otherwise left to congestion
+     * control. */
+    if (size <= prober->base || size > prober->pmtu)
+        return CLARINET_ENONE;
+
+    if (prober->state != CLARINET_PMTU_STATE_SEARCHING && prober->state != CLARINET_PMTU_STATE_COMPLETE)
+        return CLARINET_ENONE;
+
+    if (++prober->losses < CLARINET_PMTU_PROBES_MAX)
+        return CLARINET_ENONE;
+
+    /* Black hole. Fall back to the base size and confirm it before searching again. */
+    if (prober->backoff < PMTU_BACKOFF_MAX)
+        prober->backoff++;
+
+    prober->state = CLARINET_PMTU_STATE_BASE;
+    prober->pmtu = prober->base;
+    prober->probe = 0;
+    prober->hint = 0;
+    prober->count = 0;
+    prober->losses = 0;
+    prober->next = now;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_on_ptb(clarinet_pmtu_prober* prober,
+                            uint32_t size,
+                            uint64_t now)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober))
+        return CLARINET_EINVAL;
+
+    if (size >= (prober->probe ? prober->probe : prober->pmtu))
+        return CLARINET_ENONE;
+
+    if (size < prober->base)
+        size = prober->base;
+
+    if (prober->pmtu > size)
+        prober->pmtu = size;
+
+    if (prober->high > size)
+        prober->high = size;
+
+    if (prober->probe > size)
+        pmtu_reject(prober, prober->probe, now);
+    else if (prober->state == CLARINET_PMTU_STATE_SEARCHING && prober->probe == 0)
+        pmtu_settle(prober, now);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_prober_timeout(const clarinet_pmtu_prober* prober,
+                             uint64_t now)
+{
+    if (!prober || !clarinet_pmtu_prober_is_open(prober))
+        return -1;
+
+    const uint64_t deadline = prober->probe ? prober->deadline : prober->next;
+    if (deadline <= now)
+        return 0;
+
+    return (deadline - now > INT_MAX) ? INT_MAX : (int)(deadline - now);
+}
+
+/* endregion */
+
+/* region Path MTU Cache */
+
+void
+clarinet_pmtu_cache_init(clarinet_pmtu_cache* cache)
+{
+    memset(cache, 0, sizeof(clarinet_pmtu_cache));
+}
+
+int
+clarinet_pmtu_cache_open(clarinet_pmtu_cache* restrict cache,
+                         clarinet_pmtu_cache_entry* restrict entries,
+                         uint32_t capacity,
+                         uint32_t lifetime,
+                         uint64_t seed)
+{
+    if (!cache || clarinet_pmtu_cache_is_open(cache) || !entries || lifetime == 0)
+        return CLARINET_EINVAL;
+
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return CLARINET_EINVAL;
+
+    memset(entries, 0, capacity * sizeof(clarinet_pmtu_cache_entry));
+    cache->entries = entries;
+    cache->capacity = capacity;
+    cache->lifetime = lifetime;
+    cache->seed = seed;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_cache_close(clarinet_pmtu_cache* cache)
+{
+    if (!cache || !clarinet_pmtu_cache_is_open(cache))
+        return CLARINET_EINVAL;
+
+    clarinet_pmtu_cache_init(cache);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_cache_store(clarinet_pmtu_cache* restrict cache,
+                          const clarinet_addr* restrict addr,
+                          uint32_t pmtu,
+                          uint64_t now)
+{
+    if (!cache || !clarinet_pmtu_cache_is_open(cache) || !addr || pmtu == 0)
+        return CLARINET_EINVAL;
+
+    if (addr->family != CLARINET_AF_INET && addr->family != CLARINET_AF_INET6)
+        return CLARINET_EINVAL;
+
+    clarinet_pmtu_cache_entry* entry = pmtu_cache_slot(cache, addr);
+    entry->addr = *addr;
+    entry->pmtu = pmtu;
+    entry->expiry = now + cache->lifetime;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_pmtu_cache_lookup(const clarinet_pmtu_cache* restrict cache,
+                           const clarinet_addr* restrict addr,
+                           uint64_t now,
+                           uint32_t* restrict pmtu)
+{
+    if (!cache || !clarinet_pmtu_cache_is_open(cache) || !addr || !pmtu)
+        return CLARINET_EINVAL;
+
+    if (addr->family != CLARINET_AF_INET && addr->family != CLARINET_AF_INET6)
+        return CLARINET_ENOTFOUND;
+
+    const clarinet_pmtu_cache_entry* entry = pmtu_cache_slot(cache, addr);
+    if (entry->pmtu == 0 || now >= entry->expiry || !clarinet_addr_is_equivalent(&entry->addr, addr))
+        return CLARINET_ENOTFOUND;
+
+    *pmtu = entry->pmtu;
+    return CLARINET_ENONE;
+}
+
+/* endregion */
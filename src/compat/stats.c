@@ -0,0 +1,53 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/stats.h"
+
+/* region Socket Statistics */
+
+int
+clarinet_socket_setstats(clarinet_socket* restrict sp,
+                         clarinet_socket_stats* restrict stats)
+{
+    if (!sp)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_PROFILE
+    sp->stats = stats;
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(stats);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_socket_getstats(const clarinet_socket* restrict sp,
+                         clarinet_socket_stats* restrict stats)
+{
+    if (!sp || !stats)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_PROFILE
+    const clarinet_socket_stats* src = sp->stats;
+    if (!src)
+        return CLARINET_ENOTFOUND;
+
+    stats->syscalls = clarinet_stats_load(&src->syscalls);
+    stats->packets_out = clarinet_stats_load(&src->packets_out);
+    stats->bytes_out = clarinet_stats_load(&src->bytes_out);
+    stats->packets_in = clarinet_stats_load(&src->packets_in);
+    stats->bytes_in = clarinet_stats_load(&src->bytes_in);
+    stats->again = clarinet_stats_load(&src->again);
+    stats->truncated = clarinet_stats_load(&src->truncated);
+    stats->errors = clarinet_stats_load(&src->errors);
+    for (size_t i = 0; i < CLARINET_SOCKET_STATS_ERRORS; ++i)
+        stats->errors_by_code[i] = clarinet_stats_load(&src->errors_by_code[i]);
+
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/* endregion */
@@ -0,0 +1,169 @@
+#pragma once
+#ifndef COMPAT_STATS_H
+#define COMPAT_STATS_H
+
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/log.h"
+
+/*
+ * Socket I/O instrumentation. Without CLARINET_ENABLE_PROFILE and CLARINET_ENABLE_LOG every macro expands to nothing or
+ * to its result argument so that send and receive functions carry no instrumentation at all.
+ */
+
+#if CLARINET_ENABLE_LOG
+
+/** Log the failure of an operation of the socket pointed to by @p sp as @p event. Returns @p result. */
+CLARINET_STATIC_INLINE
+int
+clarinet_socket_log_result(const clarinet_socket* sp,
+                           int result,
+                           int event)
+{
+    if (result < 0 && result != CLARINET_EAGAIN)
+        clarinet_log(CLARINET_LOG_LEVEL_DEBUG, event, (intptr_t)sp->handle, result, 0, 0);
+
+    return result;
+}
+
+#define clarinet_socket_log_out(sp, result) clarinet_socket_log_result((sp), (result), CLARINET_LOG_EVENT_SOCKET_SEND)
+#define clarinet_socket_log_in(sp, result)  clarinet_socket_log_result((sp), (result), CLARINET_LOG_EVENT_SOCKET_RECV)
+
+#else
+
+#define clarinet_socket_log_out(sp, result)                     (result)
+#define clarinet_socket_log_in(sp, result)                      (result)
+
+#endif /* CLARINET_ENABLE_LOG */
+
+#if CLARINET_ENABLE_PROFILE
+
+/** Atomically add @p n to the counter pointed to by @p counter with no ordering constraints. */
+CLARINET_STATIC_INLINE
+void
+clarinet_stats_add(uint64_t* counter,
+                   uint64_t n)
+{
+    #if defined(_MSC_VER)
+    InterlockedExchangeAdd64((volatile LONG64*)counter, (LONG64)n);
+    #else
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+    #endif
+}
+
+/** Atomically read the counter pointed to by @p counter with no ordering constraints. */
+CLARINET_STATIC_INLINE
+uint64_t
+clarinet_stats_load(const uint64_t* counter)
+{
+    #if defined(_MSC_VER)
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)counter, 0, 0);
+    #else
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+    #endif
+}
+
+/** Record a failed operation. Does not count CLARINET_EMSGSIZE as a truncation because that only applies to input. */
+CLARINET_STATIC_INLINE
+void
+clarinet_stats_fail(clarinet_socket_stats* stats,
+                    int errcode)
+{
+    if (errcode == CLARINET_EAGAIN)
+    {
+        clarinet_stats_add(&stats->again, 1);
+        return;
+    }
+
+    clarinet_stats_add(&stats->errors, 1);
+    if (-errcode < CLARINET_SOCKET_STATS_ERRORS)
+        clarinet_stats_add(&stats->errors_by_code[-errcode], 1);
+}
+
+/** Record a system call issued by the socket pointed to by @p sp. */
+CLARINET_STATIC_INLINE
+void
+clarinet_socket_stats_syscall(const clarinet_socket* sp)
+{
+    if (sp->stats)
+        clarinet_stats_add(&sp->stats->syscalls, 1);
+}
+
+/**
+ * Record the outcome of sending @p packets datagrams with a total of @p result bytes or a negative error code. Returns
+ * @p result.
+ */
+CLARINET_STATIC_INLINE
+int
+clarinet_socket_stats_out(const clarinet_socket* sp,
+                          int result,
+                          size_t packets)
+{
+    clarinet_socket_stats* stats = sp->stats;
+    if (stats)
+    {
+        if (result >= 0)
+        {
+            clarinet_stats_add(&stats->packets_out, packets);
+            clarinet_stats_add(&stats->bytes_out, (uint64_t)result);
+        }
+        else
+        {
+            clarinet_stats_fail(stats, result);
+        }
+    }
+
+    return clarinet_socket_log_out(sp, result);
+}
+
+/**
+ * Record the outcome of receiving @p packets datagrams with a total of @p result bytes or a negative error code.
+ * Returns @p result.
+ */
+CLARINET_STATIC_INLINE
+int
+clarinet_socket_stats_in(const clarinet_socket* sp,
+                         int result,
+                         size_t packets)
+{
+    clarinet_socket_stats* stats = sp->stats;
+    if (stats)
+    {
+        if (result >= 0)
+        {
+            clarinet_stats_add(&stats->packets_in, packets);
+            clarinet_stats_add(&stats->bytes_in, (uint64_t)result);
+        }
+        else if (result == CLARINET_EMSGSIZE)
+        {
+            clarinet_stats_add(&stats->truncated, 1);
+        }
+        else
+        {
+            clarinet_stats_fail(stats, result);
+        }
+    }
+
+    return clarinet_socket_log_in(sp, result);
+}
+
+/** Record a single system call that sent @p packets datagrams. Returns @p result. */
+#define clarinet_socket_stats_sent(sp, result, packets) \
+    (clarinet_socket_stats_syscall(sp), clarinet_socket_stats_out((sp), (result), (packets)))
+
+/** Record a single system call that received @p packets datagrams. Returns @p result. */
+#define clarinet_socket_stats_received(sp, result, packets) \
+    (clarinet_socket_stats_syscall(sp), clarinet_socket_stats_in((sp), (result), (packets)))
+
+#else
+
+#define clarinet_socket_stats_syscall(sp)                       ((void)0)
+#define clarinet_socket_stats_out(sp, result, packets)          clarinet_socket_log_out((sp), (result))
+#define clarinet_socket_stats_in(sp, result, packets)           clarinet_socket_log_in((sp), (result))
+#define clarinet_socket_stats_sent(sp, result, packets)         clarinet_socket_log_out((sp), (result))
+#define clarinet_socket_stats_received(sp, result, packets)     clarinet_socket_log_in((sp), (result))
+
+#endif /* CLARINET_ENABLE_PROFILE */
+
+#endif /* COMPAT_STATS_H */
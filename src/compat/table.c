@@ -0,0 +1,474 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+
+/* region Helpers */
+
+/**
+ * Slots are organized in groups of 8 and each slot has a control byte (tag) that is either EMPTY, DELETED or holds the
+ * lowest 7 bits of the hash of the key stored in the slot. Tags are kept in a separate array so probing a group costs a
+ * single 64-bit load that is compared against the wanted tag in parallel (SWAR). Keys are only compared on a tag match.
+ * Bit patterns are chosen so that EMPTY and DELETED have the most significant bit set while FULL tags do not, EMPTY has
+ * bit 1 clear and DELETED has bit 0 clear.
+ */
+#define TABLE_EMPTY         0x80
+#define TABLE_DELETED       0xFE
+#define TABLE_GROUP         8
+#define TABLE_LSB           UINT64_C(0x0101010101010101)
+#define TABLE_MSB           UINT64_C(0x8080808080808080)
+
+/** Slots are aligned to a cache line so that a slot never straddles two of them. */
+#define TABLE_ALIGNMENT     64
+
+/** Returns true (non-zero) if the table pointed to by @p t is open. */
+#define clarinet_endpoint_table_is_open(t) ((t)->tags != NULL)
+
+/**
+ * Canonical form of an endpoint. Contains only the members that identify an endpoint (the same ones compared by
+ * @c clarinet_endpoint_is_equal()) so there is no padding, reserved field or flowinfo to hash or compare.
+ */
+struct table_key
+{
+    uint64_t w[3];
+};
+
+struct table_slot
+{
+    struct table_key key;
+    void* value;
+};
+
+CLARINET_STATIC_INLINE
+void
+table_key_from_endpoint(struct table_key* restrict key,
+                        const clarinet_endpoint* restrict endpoint,
+                        uint32_t flags)
+{
+    const clarinet_addr* addr = &endpoint->addr;
+    uint16_t family = addr->family;
+    uint32_t scope_id = 0;
+    uint32_t d[4] = { 0 };
+    if (clarinet_addr_is_ipv6(addr))
+    {
+        if ((flags & CLARINET_ENDPOINT_TABLE_EQUIVALENT) && clarinet_addr_is_ipv4mapped(addr))
+        {
+            /* Same canonical form as the ipv4 address so both hash and compare equal. */
+            family = CLARINET_AF_INET;
+            d[3] = addr->as.ipv6.u.dword[3];
+        }
+        else
+        {
+            scope_id = addr->as.ipv6.scope_id;
+            memcpy(d, addr->as.ipv6.u.dword, sizeof(d));
+        }
+    }
+    else if (clarinet_addr_is_ipv4(addr))
+    {
+        d[3] = addr->as.ipv6.u.dword[3];
+    }
+    else if (clarinet_addr_is_mac(addr))
+    {
+        d[2] = addr->as.ipv6.u.dword[2];
+        d[3] = addr->as.ipv6.u.dword[3];
+    }
+
+    key->w[0] = (uint64_t)family | ((uint64_t)endpoint->port << 16) | ((uint64_t)scope_id << 32);
+    key->w[1] = (uint64_t)d[0] | ((uint64_t)d[1] << 32);
+    key->w[2] = (uint64_t)d[2] | ((uint64_t)d[3] << 32);
+}
+
+CLARINET_STATIC_INLINE
+uint64_t
+table_rotl(uint64_t x,
+           int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+/** Seeded hash of a canonical key. One multiply-rotate round per word (as in xxHash64) and a murmur3 finalizer. */
+CLARINET_STATIC_INLINE
+uint64_t
+table_key_hash(const struct table_key* key,
+               uint64_t seed)
+{
+    uint64_t h = seed ^ UINT64_C(0x27D4EB2F165667C5);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        h ^= table_rotl(key->w[i] * UINT64_C(0xC2B2AE3D27D4EB4F), 31) * UINT64_C(0x9E3779B185EBCA87);
+        h = table_rotl(h, 27) * UINT64_C(0x9E3779B185EBCA87) + UINT64_C(0x85EBCA77C2B2AE63);
+    }
+
+    h ^= h >> 33;
+    h *= UINT64_C(0xFF51AFD7ED558CCD);
+    h ^= h >> 33;
+    h *= UINT64_C(0xC4CEB9FE1A85EC53);
+    h ^= h >> 33;
+    return h;
+}
+
+CLARINET_STATIC_INLINE
+int
+table_key_is_equal(const struct table_key* a,
+                   const struct table_key* b)
+{
+    return ((a->w[0] ^ b->w[0]) | (a->w[1] ^ b->w[1]) | (a->w[2] ^ b->w[2])) == 0;
+}
+
+/** Loads the tags of a group. Assembled byte by byte so tag i is always byte i regardless of the host byte order. */
+CLARINET_STATIC_INLINE
+uint64_t
+table_group_load(const uint8_t* tags)
+{
+    uint64_t g = 0;
+    for (size_t i = 0; i < TABLE_GROUP; ++i)
+        g |= (uint64_t)tags[i] << (i * 8);
+    return g;
+}
+
+/** Converts a mask with the most significant bit of each byte set into an 8-bit mask with bit i for byte i. */
+CLARINET_STATIC_INLINE
+int
+table_group_bits(uint64_t m)
+{
+    return (int)(((m >> 7) * UINT64_C(0x0102040810204080)) >> 56);
+}
+
+/** Returns the bits of the slots in the group whose tag may be @p tag. False positives are possible but rare. */
+CLARINET_STATIC_INLINE
+int
+table_group_match(uint64_t g,
+                  uint8_t tag)
+{
+    const uint64_t x = g ^ (TABLE_LSB * tag);
+    return table_group_bits((x - TABLE_LSB) & ~x & TABLE_MSB);
+}
+
+CLARINET_STATIC_INLINE
+int
+table_group_match_empty(uint64_t g)
+{
+    return table_group_bits(g & (~g << 6) & TABLE_MSB);
+}
+
+CLARINET_STATIC_INLINE
+int
+table_group_match_empty_or_deleted(uint64_t g)
+{
+    return table_group_bits(g & ~(g << 7) & TABLE_MSB);
+}
+
+/** Number of slots required for @p capacity entries keeping the load factor at or below 7/8. */
+CLARINET_STATIC_INLINE
+size_t
+table_slots(size_t capacity)
+{
+    const size_t n = capacity + (capacity + 6) / 7;
+    size_t slots = TABLE_GROUP;
+    while (slots < n)
+        slots <<= 1;
+    return slots;
+}
+
+CLARINET_STATIC_INLINE
+size_t
+table_limit(const clarinet_endpoint_table* table)
+{
+    const size_t slots = table->mask + 1;
+    return slots - slots / 8;
+}
+
+/**
+ * Groups are visited in triangular order (g, g+1, g+3, g+6, ...) which covers every group when the number of groups is
+ * a power of 2. The probe sequence starts at the group picked by the high bits of the hash.
+ */
+CLARINET_STATIC_INLINE
+size_t
+table_probe_start(const clarinet_endpoint_table* table,
+                  uint64_t hash)
+{
+    return (size_t)(hash >> 7) & (table->mask / TABLE_GROUP);
+}
+
+/** Index of the first EMPTY or DELETED slot in the probe sequence of @p hash. The table must not be full. */
+static
+size_t
+table_find_free(const clarinet_endpoint_table* table,
+                uint64_t hash)
+{
+    const size_t gmask = table->mask / TABLE_GROUP;
+    size_t g = table_probe_start(table, hash);
+    for (size_t step = 1;; ++step)
+    {
+        const int bits = table_group_match_empty_or_deleted(table_group_load(&table->tags[g * TABLE_GROUP]));
+        if (bits)
+            return g * TABLE_GROUP + (size_t)(ffs(bits) - 1);
+
+        g = (g + step) & gmask;
+    }
+}
+
+/** Index of the slot holding @p key or @c SIZE_MAX if not found. */
+static
+size_t
+table_find(const clarinet_endpoint_table* table,
+           const struct table_key* key,
+           uint64_t hash)
+{
+    const struct table_slot* slots = (const struct table_slot*)table->slots;
+    const uint8_t tag = (uint8_t)(hash & 0x7F);
+    const size_t gmask = table->mask / TABLE_GROUP;
+    size_t g = table_probe_start(table, hash);
+    for (size_t step = 1; step <= gmask + 1; ++step)
+    {
+        const uint64_t group = table_group_load(&table->tags[g * TABLE_GROUP]);
+        int bits = table_group_match(group, tag);
+        while (bits)
+        {
+            const size_t i = g * TABLE_GROUP + (size_t)(ffs(bits) - 1);
+            if (table->tags[i] == tag && table_key_is_equal(&slots[i].key, key))
+                return i;
+
+            bits &= bits - 1;
+        }
+
+        /* A group with an EMPTY slot ends every probe sequence that reaches it. */
+        if (table_group_match_empty(group))
+            break;
+
+        g = (g + step) & gmask;
+    }
+
+    return SIZE_MAX;
+}
+
+/**
+ * Reclaims all DELETED slots in place. Every FULL slot is temporarily marked DELETED and DELETED slots are marked
+ * EMPTY. Then each entry still marked DELETED is either kept where it is, if no free slot comes before its group in its
+ * probe sequence, moved to a free slot or swapped with another entry not yet reinserted (which is then processed in
+ * turn).
+ */
+static
+void
+table_rehash(clarinet_endpoint_table* table)
+{
+    struct table_slot* slots = (struct table_slot*)table->slots;
+    const size_t nslots = table->mask + 1;
+    for (size_t i = 0; i < nslots; ++i)
+        table->tags[i] = (table->tags[i] & 0x80) ? TABLE_EMPTY : TABLE_DELETED;
+
+    for (size_t i = 0; i < nslots; ++i)
+    {
+        if (table->tags[i] != TABLE_DELETED)
+            continue;
+
+        const uint64_t hash = table_key_hash(&slots[i].key, table->seed);
+        const uint8_t tag = (uint8_t)(hash & 0x7F);
+        const size_t j = table_find_free(table, hash);
+        if (j / TABLE_GROUP == i / TABLE_GROUP)
+        {
+            table->tags[i] = tag;
+            continue;
+        }
+
+        if (table->tags[j] == TABLE_EMPTY)
+        {
+            slots[j] = slots[i];
+            table->tags[j] = tag;
+            table->tags[i] = TABLE_EMPTY;
+            continue;
+        }
+
+        /* Slot j holds an entry yet to be reinserted so swap and process slot i again. */
+        const struct table_slot tmp = slots[j];
+        slots[j] = slots[i];
+        slots[i] = tmp;
+        table->tags[j] = tag;
+        --i;
+    }
+
+    table->tombstones = 0;
+}
+
+/* endregion */
+
+uint64_t
+clarinet_endpoint_hash(const clarinet_endpoint* endpoint,
+                       uint64_t seed,
+                       uint32_t flags)
+{
+    if (!endpoint)
+        return 0;
+
+    struct table_key key;
+    table_key_from_endpoint(&key, endpoint, flags);
+    return table_key_hash(&key, seed);
+}
+
+int
+clarinet_endpoint_table_calcsize(size_t capacity)
+{
+    if (capacity == 0 || capacity > CLARINET_ENDPOINT_TABLE_CAPACITY_MAX)
+        return CLARINET_EINVAL;
+
+    const size_t slots = table_slots(capacity);
+    const size_t size = slots * sizeof(struct table_slot) + slots + (TABLE_ALIGNMENT - 1);
+    assert(size <= INT_MAX);
+    return (int)size;
+}
+
+void
+clarinet_endpoint_table_init(clarinet_endpoint_table* table)
+{
+    if (table)
+        memset(table, 0, sizeof(clarinet_endpoint_table));
+}
+
+int
+clarinet_endpoint_table_open(clarinet_endpoint_table* restrict table,
+                             void* restrict buf,
+                             size_t buflen,
+                             size_t capacity,
+                             uint64_t seed,
+                             uint32_t flags)
+{
+    if (!table || clarinet_endpoint_table_is_open(table) || !buf
+        || (flags & ~(uint32_t)CLARINET_ENDPOINT_TABLE_EQUIVALENT))
+        return CLARINET_EINVAL;
+
+    const int size = clarinet_endpoint_table_calcsize(capacity);
+    if (size < 0)
+        return size;
+
+    if (buflen < (size_t)size)
+        return CLARINET_ENOBUFS;
+
+    const size_t slots = table_slots(capacity);
+    const uintptr_t base = ((uintptr_t)buf + (TABLE_ALIGNMENT - 1)) & ~(uintptr_t)(TABLE_ALIGNMENT - 1);
+    table->slots = (void*)base;
+    table->tags = (uint8_t*)base + slots * sizeof(struct table_slot);
+    memset(table->tags, TABLE_EMPTY, slots);
+    table->mask = slots - 1;
+    table->capacity = capacity;
+    table->count = 0;
+    table->tombstones = 0;
+    table->seed = seed;
+    table->flags = flags;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_endpoint_table_close(clarinet_endpoint_table* table)
+{
+    if (!table || !clarinet_endpoint_table_is_open(table))
+        return CLARINET_EINVAL;
+
+    memset(table, 0, sizeof(clarinet_endpoint_table));
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_endpoint_table_clear(clarinet_endpoint_table* table)
+{
+    if (!table || !clarinet_endpoint_table_is_open(table))
+        return CLARINET_EINVAL;
+
+    memset(table->tags, TABLE_EMPTY, table->mask + 1);
+    table->count = 0;
+    table->tombstones = 0;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_endpoint_table_insert(clarinet_endpoint_table* restrict table,
+                               const clarinet_endpoint* restrict key,
+                               void* value)
+{
+    if (!table || !clarinet_endpoint_table_is_open(table) || !key)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_addr_is_ipv4(&key->addr) && !clarinet_addr_is_ipv6(&key->addr))
+        return CLARINET_EAFNOSUPPORT;
+
+    struct table_key k;
+    table_key_from_endpoint(&k, key, table->flags);
+    const uint64_t hash = table_key_hash(&k, table->seed);
+    if (table_find(table, &k, hash) != SIZE_MAX)
+        return CLARINET_EALREADY;
+
+    if (table->count == table->capacity)
+        return CLARINET_ENOBUFS;
+
+    size_t i = table_find_free(table, hash);
+    if (table->tags[i] == TABLE_EMPTY && table->count + table->tombstones >= table_limit(table))
+    {
+        table_rehash(table);
+        i = table_find_free(table, hash);
+    }
+
+    if (table->tags[i] == TABLE_DELETED)
+        table->tombstones--;
+
+    struct table_slot* slots = (struct table_slot*)table->slots;
+    slots[i].key = k;
+    slots[i].value = value;
+    table->tags[i] = (uint8_t)(hash & 0x7F);
+    table->count++;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_endpoint_table_find(const clarinet_endpoint_table* restrict table,
+                             const clarinet_endpoint* restrict key,
+                             void** restrict value)
+{
+    if (!table || !clarinet_endpoint_table_is_open(table) || !key || !value)
+        return CLARINET_EINVAL;
+
+    struct table_key k;
+    table_key_from_endpoint(&k, key, table->flags);
+    const size_t i = table_find(table, &k, table_key_hash(&k, table->seed));
+    if (i == SIZE_MAX)
+        return CLARINET_ENOTFOUND;
+
+    *value = ((const struct table_slot*)table->slots)[i].value;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_endpoint_table_remove(clarinet_endpoint_table* restrict table,
+                               const clarinet_endpoint* restrict key,
+                               void** restrict value)
+{
+    if (!table || !clarinet_endpoint_table_is_open(table) || !key)
+        return CLARINET_EINVAL;
+
+    struct table_key k;
+    table_key_from_endpoint(&k, key, table->flags);
+    const size_t i = table_find(table, &k, table_key_hash(&k, table->seed));
+    if (i == SIZE_MAX)
+        return CLARINET_ENOTFOUND;
+
+    if (value)
+        *value = ((const struct table_slot*)table->slots)[i].value;
+
+    /*
+     * A probe sequence only continues past a group with no EMPTY slot so if this group has one no lookup ever needs to
+     * skip over slot i and it can be marked EMPTY right away.
+     */
+    const size_t g = i & ~(size_t)(TABLE_GROUP - 1);
+    if (table_group_match_empty(table_group_load(&table->tags[g])))
+    {
+        table->tags[i] = TABLE_EMPTY;
+    }
+    else
+    {
+        table->tags[i] = TABLE_DELETED;
+        table->tombstones++;
+    }
+
+    table->count--;
+    return CLARINET_ENONE;
+}
@@ -0,0 +1,340 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+#include <limits.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* region Helpers */
+
+/**
+ * Level L holds timers that expire in less than 64^(L+1) ticks. Each slot of level L spans 64^L ticks so a timer is
+ * placed in the slot of its expiry tick shifted right by 6*L bits. Slots of level L > 0 are cascaded (their timers
+ * re-inserted) when the tick crosses into the span of the slot which happens every 64^L ticks. Timers beyond the span
+ * of the wheel are parked in the last slot they can reach and cascaded until their expiry fits.
+ */
+#define WHEEL_BITS          6
+#define WHEEL_MASK          (CLARINET_TIMER_WHEEL_SLOTS - 1)
+#define WHEEL_SPAN          ((uint64_t)1 << (WHEEL_BITS * CLARINET_TIMER_WHEEL_LEVELS))
+
+/** Returns true (non-zero) if the wheel pointed to by @p w is open. */
+#define clarinet_timer_wheel_is_open(w) ((w)->resolution != 0)
+
+/** Helper to count the trailing zero bits of a non-zero value. */
+CLARINET_STATIC_INLINE
+unsigned
+wheel_ctz(uint64_t x)
+{
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (unsigned)index;
+    #else
+    return (unsigned)__builtin_ctzll(x);
+    #endif
+}
+
+/** Helper to convert a time in milliseconds to a tick rounding up so a timer never expires early. */
+CLARINET_STATIC_INLINE
+uint64_t
+wheel_tick(const clarinet_timer_wheel* wheel,
+           uint64_t time)
+{
+    return time / wheel->resolution + (time % wheel->resolution != 0);
+}
+
+/** Helper to append a timer to the list of expired timers. */
+CLARINET_STATIC_INLINE
+void
+wheel_expire(clarinet_timer_wheel* restrict wheel,
+             clarinet_timer* restrict timer)
+{
+    timer->next = NULL;
+    timer->pprev = wheel->due_tail;
+    *wheel->due_tail = timer;
+    wheel->due_tail = &timer->next;
+}
+
+/** Helper to place a timer in the slot that corresponds to its expiry or in the list of expired timers. */
+static
+void
+wheel_insert(clarinet_timer_wheel* restrict wheel,
+             clarinet_timer* restrict timer)
+{
+    uint64_t tick = wheel_tick(wheel, timer->expiry);
+    if (tick <= wheel->tick)
+    {
+        wheel_expire(wheel, timer);
+        return;
+    }
+
+    uint64_t delta = tick - wheel->tick;
+    if (delta >= WHEEL_SPAN)
+    {
+        delta = WHEEL_SPAN - 1;
+        tick = wheel->tick + delta;
+    }
+
+    unsigned level = 0;
+    while (delta >> (WHEEL_BITS * (level + 1)))
+        level++;
+
+    const unsigned slot = (unsigned)(tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    clarinet_timer** head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (timer->next)
+        timer->next->pprev = &timer->next;
+    timer->pprev = head;
+    *head = timer;
+    wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+/** Helper to remove a timer from whatever list it is in. */
+static
+void
+wheel_remove(clarinet_timer_wheel* restrict wheel,
+             clarinet_timer* restrict timer)
+{
+    clarinet_timer** pprev = timer->pprev;
+    *pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = pprev;
+    else if (wheel->due_tail == &timer->next)
+        wheel->due_tail = pprev;
+
+    /* A link inside the slot array is the head of a slot which is now empty if there is no next timer. */
+    const uintptr_t first = (uintptr_t)&wheel->slots[0][0];
+    const uintptr_t link = (uintptr_t)pprev;
+    if (!timer->next && link >= first && link < first + sizeof(wheel->slots))
+    {
+        const size_t index = (link - first) / sizeof(clarinet_timer*);
+        wheel->occupied[index / CLARINET_TIMER_WHEEL_SLOTS] &= ~((uint64_t)1 << (index % CLARINET_TIMER_WHEEL_SLOTS));
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/** Helper to detach all timers of a slot. Returns the first timer of the detached list. */
+CLARINET_STATIC_INLINE
+clarinet_timer*
+wheel_take(clarinet_timer_wheel* wheel,
+           unsigned level,
+           unsigned slot)
+{
+    clarinet_timer* list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+    return list;
+}
+
+/**
+ * Helper to find the next tick at which a slot has to be processed either because its timers expire (level 0) or
+ * because they have to be cascaded (other levels). Returns UINT64_MAX if all slots are empty.
+ */
+static
+uint64_t
+wheel_next(const clarinet_timer_wheel* wheel)
+{
+    uint64_t next = UINT64_MAX;
+    for (unsigned level = 0; level < CLARINET_TIMER_WHEEL_LEVELS; ++level)
+    {
+        const uint64_t bits = wheel->occupied[level];
+        if (!bits)
+            continue;
+
+        /* Rotate the bitmap so that bit 0 is the slot right after the current one. */
+        const unsigned shift = WHEEL_BITS * level;
+        const uint64_t span = wheel->tick >> shift;
+        const unsigned r = (unsigned)(span + 1) & WHEEL_MASK;
+        const uint64_t rotated = r ? (bits >> r) | (bits << (CLARINET_TIMER_WHEEL_SLOTS - r)) : bits;
+        const uint64_t at = (span + wheel_ctz(rotated) + 1) << shift;
+        if (at < next)
+            next = at;
+    }
+
+    return next;
+}
+
+/** Helper to process the tick following the current one. */
+static
+void
+wheel_step(clarinet_timer_wheel* wheel)
+{
+    const uint64_t tick = ++wheel->tick;
+
+    for (unsigned level = 1; level < CLARINET_TIMER_WHEEL_LEVELS; ++level)
+    {
+        const unsigned shift = WHEEL_BITS * level;
+        if (tick & (((uint64_t)1 << shift) - 1))
+            break;
+
+        clarinet_timer* timer = wheel_take(wheel, level, (unsigned)(tick >> shift) & WHEEL_MASK);
+        while (timer)
+        {
+            clarinet_timer* next = timer->next;
+            wheel_insert(wheel, timer);
+            timer = next;
+        }
+    }
+
+    clarinet_timer* timer = wheel_take(wheel, 0, (unsigned)tick & WHEEL_MASK);
+    while (timer)
+    {
+        clarinet_timer* next = timer->next;
+        wheel_expire(wheel, timer);
+        timer = next;
+    }
+}
+
+/* endregion */
+
+/* region Timer Wheel */
+
+void
+clarinet_timer_init(clarinet_timer* timer)
+{
+    memset(timer, 0, sizeof(clarinet_timer));
+}
+
+void
+clarinet_timer_wheel_init(clarinet_timer_wheel* wheel)
+{
+    memset(wheel, 0, sizeof(clarinet_timer_wheel));
+}
+
+int
+clarinet_timer_wheel_open(clarinet_timer_wheel* wheel,
+                          uint32_t resolution,
+                          uint64_t now)
+{
+    if (!wheel || clarinet_timer_wheel_is_open(wheel) || resolution == 0)
+        return CLARINET_EINVAL;
+
+    clarinet_timer_wheel_init(wheel);
+    wheel->due_tail = &wheel->due;
+    wheel->resolution = resolution;
+    wheel->tick = now / resolution;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_timer_wheel_close(clarinet_timer_wheel* wheel)
+{
+    if (!wheel || !clarinet_timer_wheel_is_open(wheel))
+        return CLARINET_EINVAL;
+
+    for (unsigned level = 0; level < CLARINET_TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (unsigned slot = 0; wheel->occupied[level] && slot < CLARINET_TIMER_WHEEL_SLOTS; ++slot)
+        {
+            while (wheel->slots[level][slot])
+                wheel_remove(wheel, wheel->slots[level][slot]);
+        }
+    }
+
+    while (wheel->due)
+        wheel_remove(wheel, wheel->due);
+
+    clarinet_timer_wheel_init(wheel);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_timer_schedule(clarinet_timer_wheel* restrict wheel,
+                        clarinet_timer* restrict timer,
+                        uint64_t expiry)
+{
+    if (!wheel || !clarinet_timer_wheel_is_open(wheel) || !timer)
+        return CLARINET_EINVAL;
+
+    if (clarinet_timer_is_scheduled(timer))
+        wheel_remove(wheel, timer);
+    else
+        wheel->count++;
+
+    timer->expiry = expiry;
+    wheel_insert(wheel, timer);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_timer_cancel(clarinet_timer_wheel* restrict wheel,
+                      clarinet_timer* restrict timer)
+{
+    if (!wheel || !clarinet_timer_wheel_is_open(wheel) || !timer)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_timer_is_scheduled(timer))
+        return CLARINET_ENOTFOUND;
+
+    wheel_remove(wheel, timer);
+    wheel->count--;
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_timer_wheel_advance(clarinet_timer_wheel* restrict wheel,
+                             uint64_t now,
+                             clarinet_timer** restrict expired,
+                             size_t count)
+{
+    if (!wheel || !clarinet_timer_wheel_is_open(wheel) || !expired || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    /* Jump over ticks in which no slot has to be processed. */
+    const uint64_t target = now / wheel->resolution;
+    while (wheel->tick < target)
+    {
+        const uint64_t next = wheel_next(wheel);
+        if (next > target)
+        {
+            wheel->tick = target;
+            break;
+        }
+
+        wheel->tick = next - 1;
+        wheel_step(wheel);
+    }
+
+    size_t n = 0;
+    while (n < count && wheel->due)
+    {
+        clarinet_timer* timer = wheel->due;
+        wheel_remove(wheel, timer);
+        expired[n++] = timer;
+    }
+
+    wheel->count -= n;
+    return (int)n;
+}
+
+int
+clarinet_timer_wheel_timeout(const clarinet_timer_wheel* wheel,
+                             uint64_t now)
+{
+    if (!wheel || !clarinet_timer_wheel_is_open(wheel))
+        return -1;
+
+    if (wheel->due)
+        return 0;
+
+    const uint64_t next = wheel_next(wheel);
+    if (next == UINT64_MAX)
+        return -1;
+
+    /* The deadline of the last tick a 64-bit time in milliseconds can represent saturates. */
+    const uint64_t deadline = (next <= UINT64_MAX / wheel->resolution) ? next * wheel->resolution : UINT64_MAX;
+    if (deadline <= now)
+        return 0;
+
+    return (deadline - now > INT_MAX) ? INT_MAX : (int)(deadline - now);
+}
+
+/* endregion */
@@ -0,0 +1,57 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <time.h>
+
+#if !HAVE_CLOCK_GETTIME && defined(__APPLE__)
+#include <mach/mach_time.h>
+#elif !HAVE_CLOCK_GETTIME
+#include <sys/time.h>
+#endif
+
+/* region Clock */
+
+uint64_t
+clarinet_time_now(void)
+{
+    #if HAVE_CLOCK_GETTIME
+    /* CLOCK_MONOTONIC does not count the time the system is suspended on Linux/Android but it does on iOS/macOS. Either
+     * way it never goes backwards which is all timers need. */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+    #elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return mach_absolute_time() * timebase.numer / timebase.denom / 1000000;
+    #else
+    /* Last resort. Not monotonic if the system time changes. */
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000 + (uint64_t)tv.tv_usec / 1000;
+    #endif
+}
+
+uint64_t
+clarinet_time_now_us(void)
+{
+    #if HAVE_CLOCK_GETTIME
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+    #elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return mach_absolute_time() * timebase.numer / timebase.denom / 1000;
+    #else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + (uint64_t)tv.tv_usec;
+    #endif
+}
+
+/* endregion */
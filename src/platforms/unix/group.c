@@ -0,0 +1,237 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/error.h"
+
+#include <string.h>
+#include <sys/socket.h>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+#if HAVE_SCHED_SETAFFINITY
+#include <sched.h>
+#endif
+
+/* region Helpers */
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+
+/**
+ * Helper to attach a classic BPF program to the reuseport group of the socket pointed to by @p sp. The value returned
+ * by the program is the index of the socket in the reuseport group, which is the order in which sockets were bound.
+ * Both programs end with a modulo so the index is always valid.
+ *
+ * The hash program reads the source address and port from the network header because the packet data seen by the
+ * program starts at the UDP payload. The UDP header of an IPv4 packet follows the options so its offset is taken from
+ * the IHL field. IPv6 extension headers are not followed as UDP normally comes right after the fixed header.
+ */
+static
+int
+socket_group_attach(clarinet_socket* sp,
+                    size_t count,
+                    uint32_t flags)
+{
+    struct sock_filter hash[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, (uint32_t)SKF_NET_OFF),              /* A = version/IHL */
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 4),                                 /* A = version */
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 4, 0, 6),                           /* if (A != 4) goto ipv6 */
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint32_t)SKF_NET_OFF + 12),         /* A = ipv4 source address */
+        BPF_STMT(BPF_ST, 0),                                                    /* M[0] = A */
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, (uint32_t)SKF_NET_OFF),             /* X = IHL * 4 */
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, (uint32_t)SKF_NET_OFF),              /* A = source port */
+        BPF_STMT(BPF_LDX | BPF_MEM, 0),                                         /* X = M[0] */
+        BPF_JUMP(BPF_JMP | BPF_JA, 3, 0, 0),                                    /* goto mix */
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint32_t)SKF_NET_OFF + 20),         /* ipv6: A = source address[3] */
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),                                        /* X = A */
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, (uint32_t)SKF_NET_OFF + 40),         /* A = source port */
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                                 /* mix: A ^= X */
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1u),                       /* A *= golden ratio */
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),                                /* A >>= 16 */
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (uint32_t)count),                   /* A %= count */
+        BPF_STMT(BPF_RET | BPF_A, 0)                                            /* return A */
+    };
+
+    struct sock_filter cpu[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU)), /* A = current CPU */
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (uint32_t)count),                   /* A %= count */
+        BPF_STMT(BPF_RET | BPF_A, 0)                                            /* return A */
+    };
+
+    struct sock_fprog prog;
+    if (flags & CLARINET_SOCKET_GROUP_STEER_HASH)
+    {
+        prog.len = (unsigned short)(sizeof(hash) / sizeof(hash[0]));
+        prog.filter = hash;
+    }
+    else
+    {
+        prog.len = (unsigned short)(sizeof(cpu) / sizeof(cpu[0]));
+        prog.filter = cpu;
+    }
+
+    if (setsockopt(sp->handle, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == SOCKET_ERROR)
+    {
+        const int err = clarinet_get_sockapi_error();
+        return (err == ENOPROTOOPT) ? CLARINET_ENOTSUP : clarinet_error_from_sockapi_error(err);
+    }
+
+    return CLARINET_ENONE;
+}
+
+#endif /* defined(SO_ATTACH_REUSEPORT_CBPF) */
+
+/** Helper to close the first @p count sockets of an array. */
+static
+void
+socket_group_close_all(clarinet_socket* sockets,
+                       size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        clarinet_socket_close(&sockets[i]); /* there's nothing we can do (or the user) if close fails here... */
+        clarinet_socket_init(&sockets[i]);
+    }
+}
+
+/* endregion */
+
+/* region Socket Group */
+
+void
+clarinet_socket_group_init(clarinet_socket_group* group)
+{
+    memset(group, 0, sizeof(clarinet_socket_group));
+}
+
+int
+clarinet_socket_group_open(clarinet_socket_group* restrict group,
+                           clarinet_socket* restrict sockets,
+                           size_t count,
+                           const clarinet_endpoint* restrict local,
+                           uint32_t flags)
+{
+    static const uint32_t steering = CLARINET_SOCKET_GROUP_STEER_HASH | CLARINET_SOCKET_GROUP_STEER_CPU;
+
+    if (!group || group->sockets || !sockets || count == 0 || count > CLARINET_SOCKET_GROUP_MAX || !local)
+        return CLARINET_EINVAL;
+
+    if ((flags & ~steering) || (flags & steering) == steering)
+        return CLARINET_EINVAL;
+
+    #if HAVE_SO_REUSEPORT
+    #if !defined(SO_ATTACH_REUSEPORT_CBPF)
+    if (flags & steering)
+        return CLARINET_ENOTSUP;
+    #endif
+
+    clarinet_endpoint bound = *local;
+    for (size_t i = 0; i < count; ++i)
+    {
+        int errcode = clarinet_socket_open(&sockets[i], local->addr.family, CLARINET_PROTO_UDP);
+        if (errcode != CLARINET_ENONE)
+        {
+            socket_group_close_all(sockets, i);
+            return errcode;
+        }
+
+        static const int32_t on = 1;
+        errcode = clarinet_socket_setopt(&sockets[i], CLARINET_SO_REUSEADDR, &on, sizeof(on));
+        if (errcode == CLARINET_ENONE)
+            errcode = clarinet_socket_bind(&sockets[i], &bound);
+
+        /* The first bind resolves an ephemeral port so the remaining sockets must be bound to the same port. */
+        if (errcode == CLARINET_ENONE && i == 0)
+            errcode = clarinet_socket_local_endpoint(&sockets[i], &bound);
+
+        if (errcode != CLARINET_ENONE)
+        {
+            socket_group_close_all(sockets, i + 1);
+            return errcode;
+        }
+    }
+
+    #if defined(SO_ATTACH_REUSEPORT_CBPF)
+    /* The program belongs to the reuseport group so it can be attached through any of the sockets once all are bound.
+     * Binding first guarantees that the socket at index i is the i-th socket of the reuseport group. */
+    if (flags & steering)
+    {
+        const int errcode = socket_group_attach(&sockets[0], count, flags);
+        if (errcode != CLARINET_ENONE)
+        {
+            socket_group_close_all(sockets, count);
+            return errcode;
+        }
+    }
+    #endif
+
+    group->sockets = sockets;
+    group->count = count;
+    group->local = bound;
+    group->flags = flags;
+
+    return CLARINET_ENONE;
+    #else /* !HAVE_SO_REUSEPORT */
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_socket_group_close(clarinet_socket_group* group)
+{
+    if (!group || !group->sockets)
+        return CLARINET_EINVAL;
+
+    socket_group_close_all(group->sockets, group->count);
+    clarinet_socket_group_init(group);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_socket_group_pin(const clarinet_socket_group* group,
+                          size_t shard)
+{
+    if (!group || !group->sockets || shard >= group->count)
+        return CLARINET_EINVAL;
+
+    #if HAVE_SCHED_SETAFFINITY
+    /* Pid 0 denotes the calling thread. */
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    const int ncpus = CPU_COUNT(&allowed);
+    if (ncpus <= 0)
+        return CLARINET_ESYS;
+
+    /* CPU steering delivers a packet processed on CPU c to shard c modulo count so the thread is pinned to the first
+     * allowed CPU that maps to its shard. Only when no allowed CPU does is the shard spread over the allowed ones. */
+    size_t cpu = shard;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))
+        cpu += group->count;
+
+    if (cpu >= CPU_SETSIZE)
+    {
+        size_t n = shard % (size_t)ncpus;
+        for (cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed) && n-- == 0)
+                break;
+        }
+    }
+
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    CPU_SET(cpu, &pinned);
+    if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/* endregion */
@@ -0,0 +1,905 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/addr.h"
+#include "compat/error.h"
+
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <net/if.h>
+
+#if defined(__linux__)
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#else
+#include <ifaddrs.h>
+#if defined(AF_LINK)
+#include <net/if_dl.h>
+#endif
+#endif
+
+/* region Helpers */
+
+/** Returns true (non-zero) if the table pointed to by @p t is open. */
+#define clarinet_iface_table_is_open(t) ((t)->links != NULL)
+
+/** Helper to find a link by index. Returns the position of the link or -1 if not found. */
+static
+int
+iface_table_find_link(const clarinet_iface_table* table,
+                      uint32_t index)
+{
+    for (uint32_t i = 0; i < table->nlinks; ++i)
+    {
+        if (table->links[i].index == index)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+#if defined(__linux__)
+
+/** Buffer size recommended by the kernel for netlink messages. Dumps are delivered in multiple datagrams this size. */
+#define IFACE_NL_BUFSIZE    8192
+
+/** Multicast groups of rtnetlink that report link and address changes. */
+#define IFACE_NL_GROUPS     (RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR)
+
+/** Number of times a dump interrupted by concurrent changes is retried. */
+#define IFACE_NL_RETRIES    8
+
+/** Internal result of a dump that was interrupted by concurrent changes and must be restarted. */
+#define IFACE_NL_EINTR      1
+
+/** Helper to compare addresses ignoring the IPv6 flow info and scope id. */
+CLARINET_STATIC_INLINE
+int
+iface_addr_equal(const clarinet_addr* a,
+                 const clarinet_addr* b)
+{
+    if (a->family != b->family)
+        return 0;
+
+    if (a->family == CLARINET_AF_INET)
+        return a->as.ipv4.u.dword[0] == b->as.ipv4.u.dword[0];
+
+    return memcmp(a->as.ipv6.u.byte, b->as.ipv6.u.byte, sizeof(a->as.ipv6.u.byte)) == 0;
+}
+
+/** Helper to find an address of an interface. Returns the position of the address or -1 if not found. */
+static
+int
+iface_table_find_addr(const clarinet_iface_table* restrict table,
+                      uint32_t index,
+                      const clarinet_addr* restrict addr)
+{
+    for (uint32_t i = 0; i < table->naddrs; ++i)
+    {
+        if (table->addrs[i].index == index && iface_addr_equal(&table->addrs[i].addr, addr))
+            return (int)i;
+    }
+
+    return -1;
+}
+
+/** Helper to remove an address from a table preserving the order of the remaining addresses. */
+CLARINET_STATIC_INLINE
+void
+iface_table_remove_addr(clarinet_iface_table* table,
+                        uint32_t pos)
+{
+    table->naddrs--;
+    memmove(&table->addrs[pos], &table->addrs[pos + 1], (table->naddrs - pos) * sizeof(clarinet_iface));
+}
+
+/** Buffer aligned for netlink messages. */
+union iface_nl_buffer
+{
+    struct nlmsghdr h;
+    uint8_t bytes[IFACE_NL_BUFSIZE];
+};
+
+/** Function called for each message of a dump. Returns CLARINET_ENONE to continue or an error code to abort. */
+typedef int (*iface_nl_handler)(void* context,
+                                const struct nlmsghdr* h);
+
+/** Return non-zero (true) if error code is EWOULDBLOCK or EAGAIN, otherwise 0. */
+CLARINET_STATIC_INLINE
+int
+again(int e)
+{
+    #if HAVE_EAGAIN_EQUAL_TO_EWOULDBLOCK
+    return (e == EWOULDBLOCK);
+    #else
+    return (e == EWOULDBLOCK) || (e == EAGAIN);
+    #endif /* HAVE_EAGAIN_EQUAL_TO_EWOULDBLOCK */
+}
+
+/** Helper to open a netlink route socket subscribed to @p groups. Returns the socket or -1 on error. */
+static
+int
+iface_nl_socket(uint32_t groups,
+                int nonblock)
+{
+    const int sockfd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | (nonblock ? SOCK_NONBLOCK : 0), NETLINK_ROUTE);
+    if (sockfd < 0)
+        return -1;
+
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = groups;
+    if (bind(sockfd, (struct sockaddr*)&sa, sizeof(sa)) < 0)
+    {
+        const int err = errno;
+        close(sockfd);
+        errno = err;
+        return -1;
+    }
+
+    return sockfd;
+}
+
+/** Helper to receive a datagram from the kernel. Datagrams from other processes are discarded. */
+static
+ssize_t
+iface_nl_recv(int sockfd,
+              union iface_nl_buffer* buf,
+              int flags)
+{
+    while (1)
+    {
+        struct sockaddr_nl sa;
+        socklen_t salen = sizeof(sa);
+        const ssize_t n = recvfrom(sockfd, buf->bytes, sizeof(buf->bytes), flags, (struct sockaddr*)&sa, &salen);
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n >= 0 && sa.nl_pid != 0)
+        {
+            /* A peeked datagram stays queued until it is received without MSG_PEEK. */
+            if (flags & MSG_PEEK)
+                recv(sockfd, buf->bytes, 0, flags & ~MSG_PEEK);
+            continue;
+        }
+
+        return n;
+    }
+}
+
+/** Helper to request a dump of all links or addresses and pass each message received to @p handler. */
+static
+int
+iface_nl_dump(uint16_t type,
+              iface_nl_handler handler,
+              void* context)
+{
+    const int sockfd = iface_nl_socket(0, 0);
+    if (sockfd < 0)
+        return clarinet_error_from_sockapi_error(errno);
+
+    struct
+    {
+        struct nlmsghdr h;
+        union
+        {
+            struct ifinfomsg link;
+            struct ifaddrmsg addr;
+        } u;
+    } req;
+
+    memset(&req, 0, sizeof(req));
+    req.h.nlmsg_len = NLMSG_LENGTH(type == RTM_GETLINK ? sizeof(req.u.link) : sizeof(req.u.addr));
+    req.h.nlmsg_type = type;
+    req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.h.nlmsg_seq = 1;
+
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+
+    int errcode = CLARINET_ENONE;
+    if (sendto(sockfd, &req, req.h.nlmsg_len, 0, (struct sockaddr*)&sa, sizeof(sa)) < 0)
+    {
+        errcode = clarinet_error_from_sockapi_error(errno);
+        close(sockfd);
+        return errcode;
+    }
+
+    union iface_nl_buffer buf;
+    int interrupted = 0;
+    int done = 0;
+    while (!done && errcode == CLARINET_ENONE)
+    {
+        const ssize_t n = iface_nl_recv(sockfd, &buf, 0);
+        if (n < 0)
+        {
+            errcode = clarinet_error_from_sockapi_error(errno);
+            break;
+        }
+
+        size_t len = (size_t)n;
+        for (const struct nlmsghdr* h = &buf.h; NLMSG_OK(h, len); h = NLMSG_NEXT(h, len))
+        {
+            if (h->nlmsg_seq != req.h.nlmsg_seq)
+                continue;
+
+            if (h->nlmsg_flags & NLM_F_DUMP_INTR)
+                interrupted = 1;
+
+            if (h->nlmsg_type == NLMSG_DONE)
+            {
+                done = 1;
+                break;
+            }
+
+            if (h->nlmsg_type == NLMSG_ERROR)
+            {
+                const struct nlmsgerr* err = (const struct nlmsgerr*)NLMSG_DATA(h);
+                errcode = (h->nlmsg_len >= NLMSG_LENGTH(sizeof(*err)) && err->error < 0)
+                          ? clarinet_error_from_sockapi_error(-err->error)
+                          : CLARINET_ESYS;
+                break;
+            }
+
+            errcode = handler(context, h);
+            if (errcode != CLARINET_ENONE)
+                break;
+        }
+    }
+
+    close(sockfd);
+
+    if (errcode == CLARINET_ENONE && interrupted)
+        return IFACE_NL_EINTR;
+
+    return errcode;
+}
+
+/** Helper to translate the flags of a link message. */
+CLARINET_STATIC_INLINE
+uint32_t
+iface_link_flags(unsigned int flags)
+{
+    uint32_t result = 0;
+    if (flags & IFF_UP)
+        result |= CLARINET_IFACE_LINK_UP;
+    if (flags & IFF_RUNNING)
+        result |= CLARINET_IFACE_LINK_RUNNING;
+    if (flags & IFF_LOOPBACK)
+        result |= CLARINET_IFACE_LINK_LOOPBACK;
+    if (flags & IFF_MULTICAST)
+        result |= CLARINET_IFACE_LINK_MULTICAST;
+    return result;
+}
+
+/** Helper to parse a link message. Returns non-zero (true) if the message describes a network interface. */
+static
+int
+iface_parse_link(const struct nlmsghdr* restrict h,
+                 clarinet_iface_link* restrict link)
+{
+    if (h->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg)))
+        return 0;
+
+    /* Bridge ports are reported a second time with family AF_BRIDGE. */
+    const struct ifinfomsg* ifi = (const struct ifinfomsg*)NLMSG_DATA(h);
+    if (ifi->ifi_family == AF_BRIDGE || ifi->ifi_index <= 0)
+        return 0;
+
+    memset(link, 0, sizeof(clarinet_iface_link));
+    link->index = (uint32_t)ifi->ifi_index;
+    link->flags = iface_link_flags(ifi->ifi_flags);
+    link->addr = clarinet_addr_none;
+
+    size_t len = h->nlmsg_len - NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    for (const struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+    {
+        const size_t size = RTA_PAYLOAD(rta);
+        switch (rta->rta_type)
+        {
+            case IFLA_IFNAME:
+                memcpy(link->name, RTA_DATA(rta), size < sizeof(link->name) ? size : sizeof(link->name) - 1);
+                link->name[sizeof(link->name) - 1] = '\0';
+                break;
+            case IFLA_MTU:
+                if (size >= sizeof(uint32_t))
+                    memcpy(&link->mtu, RTA_DATA(rta), sizeof(uint32_t));
+                break;
+            case IFLA_ADDRESS:
+                /* Octets are aligned to the right. */
+                if (size > 0 && size <= sizeof(link->addr.as.mac.u.byte))
+                {
+                    link->addr.family = CLARINET_AF_LINK;
+                    link->addr.as.mac.length = (uint32_t)size;
+                    memcpy(&link->addr.as.mac.u.byte[sizeof(link->addr.as.mac.u.byte) - size], RTA_DATA(rta), size);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Helper to parse an address message. Returns 1 if the message describes a usable IPv4 or IPv6 address, -1 if it
+ * describes an address that is not usable yet (e.g. an IPv6 address undergoing duplicate address detection) and 0 if
+ * it must be ignored.
+ */
+static
+int
+iface_parse_addr(const struct nlmsghdr* restrict h,
+                 clarinet_iface* restrict iface)
+{
+    if (h->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifaddrmsg)))
+        return 0;
+
+    const struct ifaddrmsg* ifa = (const struct ifaddrmsg*)NLMSG_DATA(h);
+    size_t size;
+    if (ifa->ifa_family == AF_INET)
+        size = sizeof(iface->addr.as.ipv4.u.byte);
+    else if (ifa->ifa_family == AF_INET6)
+        size = sizeof(iface->addr.as.ipv6.u.byte);
+    else
+        return 0;
+
+    if (ifa->ifa_prefixlen > size * 8)
+        return 0;
+
+    /* IFA_LOCAL is the local address of point-to-point interfaces where IFA_ADDRESS is the address of the peer. */
+    const void* local = NULL;
+    const void* address = NULL;
+    uint32_t flags = ifa->ifa_flags;
+    size_t len = h->nlmsg_len - NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+    for (const struct rtattr* rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+    {
+        const size_t payload = RTA_PAYLOAD(rta);
+        if (rta->rta_type == IFA_LOCAL && payload == size)
+            local = RTA_DATA(rta);
+        else if (rta->rta_type == IFA_ADDRESS && payload == size)
+            address = RTA_DATA(rta);
+        #if defined(IFA_FLAGS)
+        else if (rta->rta_type == IFA_FLAGS && payload >= sizeof(uint32_t))
+            memcpy(&flags, RTA_DATA(rta), sizeof(uint32_t));
+        #endif
+    }
+
+    if (!local)
+        local = address;
+
+    if (!local)
+        return 0;
+
+    memset(iface, 0, sizeof(clarinet_iface));
+    iface->index = ifa->ifa_index;
+
+    uint8_t* addr;
+    uint8_t* mask;
+    if (ifa->ifa_family == AF_INET)
+    {
+        iface->addr.family = CLARINET_AF_INET;
+        iface->netmask.family = CLARINET_AF_INET;
+        addr = iface->addr.as.ipv4.u.byte;
+        mask = iface->netmask.as.ipv4.u.byte;
+    }
+    else
+    {
+        iface->addr.family = CLARINET_AF_INET6;
+        iface->netmask.family = CLARINET_AF_INET6;
+        addr = iface->addr.as.ipv6.u.byte;
+        mask = iface->netmask.as.ipv6.u.byte;
+    }
+
+    memcpy(addr, local, size);
+    for (size_t i = 0; i < ifa->ifa_prefixlen; ++i)
+        mask[i / 8] |= (uint8_t)(0x80 >> (i % 8));
+
+    if (iface->addr.family == CLARINET_AF_INET6 && clarinet_addr_is_linklocal_ipv6(&iface->addr))
+        iface->addr.as.ipv6.scope_id = iface->index;
+
+    return (flags & (IFA_F_TENTATIVE | IFA_F_DADFAILED)) ? -1 : 1;
+}
+
+/**
+ * Helper to apply a link or address message to a table. Returns 1 if the table changed and @p event describes the
+ * change, 0 if the table did not change or CLARINET_ENOBUFS if the table is full.
+ */
+static
+int
+iface_table_apply(clarinet_iface_table* restrict table,
+                  const struct nlmsghdr* restrict h,
+                  clarinet_iface_event* restrict event)
+{
+    memset(event, 0, sizeof(clarinet_iface_event));
+
+    switch (h->nlmsg_type)
+    {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+        {
+            clarinet_iface_link link;
+            if (!iface_parse_link(h, &link))
+                return 0;
+
+            const int pos = iface_table_find_link(table, link.index);
+            if (h->nlmsg_type == RTM_NEWLINK)
+            {
+                /* Wireless drivers in particular report the same link state over and over. */
+                if (pos >= 0 && memcmp(&table->links[pos], &link, sizeof(clarinet_iface_link)) == 0)
+                    return 0;
+
+                if (pos < 0 && table->nlinks == table->maxlinks)
+                    return CLARINET_ENOBUFS;
+
+                table->links[pos < 0 ? table->nlinks++ : (uint32_t)pos] = link;
+                event->type = CLARINET_IFACE_EVENT_LINK_NEW;
+            }
+            else
+            {
+                if (pos < 0)
+                    return 0;
+
+                table->nlinks--;
+                memmove(&table->links[pos], &table->links[pos + 1],
+                        (table->nlinks - (uint32_t)pos) * sizeof(clarinet_iface_link));
+
+                /* Addresses are normally removed before the link but the order is not guaranteed. */
+                for (uint32_t i = table->naddrs; i > 0; --i)
+                {
+                    if (table->addrs[i - 1].index == link.index)
+                        iface_table_remove_addr(table, i - 1);
+                }
+
+                event->type = CLARINET_IFACE_EVENT_LINK_DEL;
+            }
+
+            event->iface.index = link.index;
+            event->iface.addr = link.addr;
+            event->iface.netmask = clarinet_addr_none;
+            break;
+        }
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+        {
+            clarinet_iface iface;
+            const int usable = iface_parse_addr(h, &iface);
+            if (!usable)
+                return 0;
+
+            /* An address that becomes unusable again (e.g. restarting duplicate address detection) is removed. */
+            const int pos = iface_table_find_addr(table, iface.index, &iface.addr);
+            if (h->nlmsg_type == RTM_NEWADDR && usable > 0)
+            {
+                if (pos >= 0 && memcmp(&table->addrs[pos], &iface, sizeof(clarinet_iface)) == 0)
+                    return 0;
+
+                if (pos < 0 && table->naddrs == table->maxaddrs)
+                    return CLARINET_ENOBUFS;
+
+                table->addrs[pos < 0 ? table->naddrs++ : (uint32_t)pos] = iface;
+                event->type = CLARINET_IFACE_EVENT_ADDR_NEW;
+            }
+            else
+            {
+                if (pos < 0)
+                    return 0;
+
+                iface_table_remove_addr(table, (uint32_t)pos);
+                event->type = CLARINET_IFACE_EVENT_ADDR_DEL;
+            }
+
+            event->iface = iface;
+            break;
+        }
+        default:
+            return 0;
+    }
+
+    table->version++;
+    return 1;
+}
+
+/** Dump handler that applies every message to a table. */
+static
+int
+iface_table_load_handler(void* context,
+                         const struct nlmsghdr* h)
+{
+    clarinet_iface_event event;
+    const int result = iface_table_apply((clarinet_iface_table*)context, h, &event);
+    return result < 0 ? result : CLARINET_ENONE;
+}
+
+/** Helper to reload the entire contents of a table. */
+static
+int
+iface_table_load(clarinet_iface_table* table)
+{
+    for (int retries = 0; retries < IFACE_NL_RETRIES; ++retries)
+    {
+        table->nlinks = 0;
+        table->naddrs = 0;
+        table->version++;
+
+        int errcode = iface_nl_dump(RTM_GETLINK, iface_table_load_handler, table);
+        if (errcode == CLARINET_ENONE)
+            errcode = iface_nl_dump(RTM_GETADDR, iface_table_load_handler, table);
+
+        if (errcode != IFACE_NL_EINTR)
+            return errcode;
+    }
+
+    return CLARINET_ESYS;
+}
+
+/** State of clarinet_iface_getlist() while dumping. */
+struct iface_list
+{
+    clarinet_iface* list;
+    size_t capacity;
+    size_t count;
+};
+
+/** Dump handler that appends hardware and IP addresses to a list. */
+static
+int
+iface_list_handler(void* context,
+                   const struct nlmsghdr* h)
+{
+    struct iface_list* state = (struct iface_list*)context;
+
+    clarinet_iface iface;
+    if (h->nlmsg_type == RTM_NEWLINK)
+    {
+        clarinet_iface_link link;
+        if (!iface_parse_link(h, &link) || link.addr.family == CLARINET_AF_UNSPEC)
+            return CLARINET_ENONE;
+
+        iface.index = link.index;
+        iface.addr = link.addr;
+        iface.netmask = clarinet_addr_none;
+    }
+    else if (h->nlmsg_type != RTM_NEWADDR || iface_parse_addr(h, &iface) <= 0)
+    {
+        return CLARINET_ENONE;
+    }
+
+    if (state->count < state->capacity)
+        state->list[state->count] = iface;
+
+    state->count++;
+    return CLARINET_ENONE;
+}
+
+#endif /* defined(__linux__) */
+
+/* endregion */
+
+/* region Interface */
+
+int
+clarinet_iface_getlist(clarinet_iface* restrict list,
+                       size_t* len)
+{
+    if (!list || !len)
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__)
+    struct iface_list state = { list, *len, 0 };
+    int errcode = IFACE_NL_EINTR;
+    for (int retries = 0; errcode == IFACE_NL_EINTR && retries < IFACE_NL_RETRIES; ++retries)
+    {
+        state.count = 0;
+        errcode = iface_nl_dump(RTM_GETLINK, iface_list_handler, &state);
+        if (errcode == CLARINET_ENONE)
+            errcode = iface_nl_dump(RTM_GETADDR, iface_list_handler, &state);
+    }
+
+    if (errcode != CLARINET_ENONE)
+        return errcode == IFACE_NL_EINTR ? CLARINET_ESYS : errcode;
+
+    const int result = (state.count > *len) ? CLARINET_ENOBUFS : CLARINET_ENONE;
+    *len = state.count;
+    return result;
+    #else
+    struct ifaddrs* ifap;
+    if (getifaddrs(&ifap) < 0)
+        return clarinet_error_from_sockapi_error(errno);
+
+    size_t count = 0;
+    for (const struct ifaddrs* ifa = ifap; ifa; ifa = ifa->ifa_next)
+    {
+        if (!ifa->ifa_addr)
+            continue;
+
+        clarinet_iface iface;
+        memset(&iface, 0, sizeof(clarinet_iface));
+        iface.index = if_nametoindex(ifa->ifa_name);
+
+        const int family = ifa->ifa_addr->sa_family;
+        if (family == AF_INET || family == AF_INET6)
+        {
+            const socklen_t salen = (family == AF_INET) ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+            struct sockaddr_storage ss;
+            clarinet_endpoint endpoint;
+
+            memset(&ss, 0, sizeof(ss));
+            memcpy(&ss, ifa->ifa_addr, salen);
+            if (clarinet_endpoint_from_sockaddr(&endpoint, &ss) != CLARINET_ENONE)
+                continue;
+
+            iface.addr = endpoint.addr;
+            if (ifa->ifa_netmask)
+            {
+                memset(&ss, 0, sizeof(ss));
+                memcpy(&ss, ifa->ifa_netmask, salen);
+                ss.ss_family = (sa_family_t)family;
+                if (clarinet_endpoint_from_sockaddr(&endpoint, &ss) == CLARINET_ENONE)
+                    iface.netmask = endpoint.addr;
+            }
+        }
+        #if defined(AF_LINK)
+        else if (family == AF_LINK)
+        {
+            const struct sockaddr_dl* sdl = (const struct sockaddr_dl*)ifa->ifa_addr;
+            if (sdl->sdl_alen == 0 || sdl->sdl_alen > sizeof(iface.addr.as.mac.u.byte))
+                continue;
+
+            iface.addr.family = CLARINET_AF_LINK;
+            iface.addr.as.mac.length = sdl->sdl_alen;
+            memcpy(&iface.addr.as.mac.u.byte[sizeof(iface.addr.as.mac.u.byte) - sdl->sdl_alen], LLADDR(sdl),
+                   sdl->sdl_alen);
+        }
+        #endif
+        else
+        {
+            continue;
+        }
+
+        if (count < *len)
+            list[count] = iface;
+
+        count++;
+    }
+
+    freeifaddrs(ifap);
+
+    const int result = (count > *len) ? CLARINET_ENOBUFS : CLARINET_ENONE;
+    *len = count;
+    return result;
+    #endif
+}
+
+int
+clarinet_iface_getindex(const char* name,
+                        uint32_t* index)
+{
+    if (!name || !index)
+        return CLARINET_EINVAL;
+
+    const unsigned int result = if_nametoindex(name);
+    if (result == 0)
+        return CLARINET_ENOTFOUND;
+
+    *index = result;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_iface_getname(uint32_t index,
+                       char* name,
+                       size_t len)
+{
+    if (!name)
+        return CLARINET_EINVAL;
+
+    char buf[IF_NAMESIZE > CLARINET_IFACE_NAME_MAX ? IF_NAMESIZE : CLARINET_IFACE_NAME_MAX];
+    if (index == 0 || !if_indextoname(index, buf))
+        return CLARINET_ENOTFOUND;
+
+    const size_t n = strlen(buf);
+    if (n >= len)
+        return CLARINET_ENOBUFS;
+
+    memcpy(name, buf, n + 1);
+    return CLARINET_ENONE;
+}
+
+void
+clarinet_iface_table_init(clarinet_iface_table* table)
+{
+    memset(table, 0, sizeof(clarinet_iface_table));
+}
+
+int
+clarinet_iface_table_open(clarinet_iface_table* restrict table,
+                          clarinet_iface_link* restrict links,
+                          uint32_t maxlinks,
+                          clarinet_iface* restrict addrs,
+                          uint32_t maxaddrs)
+{
+    if (!table || clarinet_iface_table_is_open(table) || !links || maxlinks == 0 || !addrs || maxaddrs == 0)
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__)
+    /* Subscribe before loading so changes made during the load are queued and applied by the next update. Applying a
+     * change that is already reflected in the table has no effect. */
+    const int sockfd = iface_nl_socket(IFACE_NL_GROUPS, 1);
+    if (sockfd < 0)
+        return clarinet_error_from_sockapi_error(errno);
+
+    clarinet_iface_table_init(table);
+    table->links = links;
+    table->maxlinks = maxlinks;
+    table->addrs = addrs;
+    table->maxaddrs = maxaddrs;
+
+    const int errcode = iface_table_load(table);
+    if (errcode != CLARINET_ENONE)
+    {
+        close(sockfd);
+        clarinet_iface_table_init(table);
+        return errcode;
+    }
+
+    table->socket.family = CLARINET_AF_LINK;
+    table->socket.handle = sockfd;
+
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_iface_table_close(clarinet_iface_table* table)
+{
+    if (!table || !clarinet_iface_table_is_open(table))
+        return CLARINET_EINVAL;
+
+    close(table->socket.handle);
+    clarinet_iface_table_init(table);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_iface_table_update(clarinet_iface_table* restrict table,
+                            clarinet_iface_event* restrict events,
+                            size_t count)
+{
+    if (!table || !clarinet_iface_table_is_open(table) || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__)
+    /* A datagram may carry several messages so it is only peeked and the number of bytes already applied is kept in
+     * the table. The datagram is dequeued once all its messages have been applied which means messages that do not fit
+     * in the events array are resumed by the next call instead of being lost. */
+    union iface_nl_buffer buf;
+    size_t n = 0;
+    while (n < count)
+    {
+        const ssize_t r = iface_nl_recv(table->socket.handle, &buf, MSG_DONTWAIT | MSG_PEEK);
+        if (r < 0)
+        {
+            if (again(errno))
+                break;
+
+            if (errno != ENOBUFS)
+                return clarinet_error_from_sockapi_error(errno);
+
+            /* The socket buffer overflowed and notifications were lost. */
+            const int errcode = iface_table_load(table);
+            if (errcode != CLARINET_ENONE)
+                return errcode;
+
+            memset(&events[n], 0, sizeof(clarinet_iface_event));
+            events[n].type = CLARINET_IFACE_EVENT_RESYNC;
+            n++;
+            continue;
+        }
+
+        size_t len = (size_t)r > table->offset ? (size_t)r - table->offset : 0;
+        const struct nlmsghdr* h = (const struct nlmsghdr*)(buf.bytes + table->offset);
+        for (; NLMSG_OK(h, len) && n < count; h = NLMSG_NEXT(h, len))
+        {
+            /* Every message is applied at most once so it is skipped even if it fails. */
+            table->offset += NLMSG_ALIGN(h->nlmsg_len);
+
+            const int result = iface_table_apply(table, h, &events[n]);
+            if (result < 0)
+                return result;
+
+            n += (size_t)result;
+        }
+
+        if (NLMSG_OK(h, len))
+            break;
+
+        table->offset = 0;
+        recv(table->socket.handle, buf.bytes, 0, MSG_DONTWAIT);
+    }
+
+    return (int)n;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_iface_table_getlink(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             clarinet_iface_link* restrict link)
+{
+    if (!table || !clarinet_iface_table_is_open(table) || !link)
+        return CLARINET_EINVAL;
+
+    const int pos = iface_table_find_link(table, index);
+    if (pos < 0)
+        return CLARINET_ENOTFOUND;
+
+    *link = table->links[pos];
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_iface_table_getindex(const clarinet_iface_table* restrict table,
+                              const char* restrict name,
+                              uint32_t* restrict index)
+{
+    if (!table || !clarinet_iface_table_is_open(table) || !name || !index)
+        return CLARINET_EINVAL;
+
+    for (uint32_t i = 0; i < table->nlinks; ++i)
+    {
+        if (strncmp(table->links[i].name, name, CLARINET_IFACE_NAME_MAX) == 0)
+        {
+            *index = table->links[i].index;
+            return CLARINET_ENONE;
+        }
+    }
+
+    return CLARINET_ENOTFOUND;
+}
+
+int
+clarinet_iface_table_getaddr(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             int family,
+                             clarinet_addr* restrict addr)
+{
+    if (!table || !clarinet_iface_table_is_open(table) || !addr)
+        return CLARINET_EINVAL;
+
+    if (family != CLARINET_AF_INET && family != CLARINET_AF_INET6)
+        return CLARINET_EINVAL;
+
+    const clarinet_addr* linklocal = NULL;
+    for (uint32_t i = 0; i < table->naddrs; ++i)
+    {
+        const clarinet_iface* iface = &table->addrs[i];
+        if (iface->index != index || iface->addr.family != family)
+            continue;
+
+        if (family == CLARINET_AF_INET6 && clarinet_addr_is_linklocal_ipv6(&iface->addr))
+        {
+            if (!linklocal)
+                linklocal = &iface->addr;
+            continue;
+        }
+
+        *addr = iface->addr;
+        return CLARINET_ENONE;
+    }
+
+    if (!linklocal)
+        return CLARINET_ENOTFOUND;
+
+    *addr = *linklocal;
+    return CLARINET_ENONE;
+}
+
+/* endregion */
@@ -0,0 +1,233 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/error.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+/* region Helpers */
+
+/**
+ * Returns true (non-zero) if the handle of the poller/socket pointed to by @p p is valid. All negative descriptors are
+ * invalid and values 0, 1 and 2 are reserved for stdin, stdout and stderr respectively so valid descriptors start at 3.
+ */
+#define clarinet_handle_is_valid(p)     ((p)->handle > 2)
+
+#if defined(__linux__)
+
+/** Helper to translate socket event flags into epoll(7) events. */
+CLARINET_STATIC_INLINE
+uint32_t
+epoll_events_to_native(uint16_t events)
+{
+    /* EPOLLERR and EPOLLHUP are always reported and do not need to be requested. */
+    uint32_t result = EPOLLRDHUP;
+    if (events & CLARINET_POLL_RECV)
+        result |= EPOLLIN;
+    if (events & CLARINET_POLL_SEND)
+        result |= EPOLLOUT;
+
+    return result;
+}
+
+/** Helper to translate epoll(7) events into socket event flags. */
+CLARINET_STATIC_INLINE
+uint16_t
+epoll_events_from_native(uint32_t events)
+{
+    uint16_t result = CLARINET_POLL_NONE;
+    if (events & EPOLLERR)
+        result |= CLARINET_POLL_ERROR;
+    if (events & (EPOLLHUP | EPOLLRDHUP))
+        result |= CLARINET_POLL_SHUTDOWN;
+    if (events & EPOLLIN)
+        result |= CLARINET_POLL_RECV;
+    if (events & EPOLLOUT)
+        result |= CLARINET_POLL_SEND;
+
+    return result;
+}
+
+/** Helper to register, modify or unregister a socket. */
+CLARINET_STATIC_INLINE
+int
+epoll_control(clarinet_poller* restrict pp,
+              clarinet_socket* restrict sp,
+              int op,
+              uint16_t events,
+              void* data)
+{
+    if (!pp || !clarinet_handle_is_valid(pp))
+        return CLARINET_EINVAL;
+
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = epoll_events_to_native(events);
+    ev.data.ptr = data;
+
+    if (epoll_ctl(pp->handle, op, sp->handle, &ev) == SOCKET_ERROR)
+    {
+        const int err = clarinet_get_sockapi_error();
+        switch (err)
+        {
+            case EEXIST:
+                return CLARINET_EALREADY;
+            case ENOENT:
+                return CLARINET_ENOTFOUND;
+            case EPERM: /* the target file does not support epoll (e.g. regular files) */
+                return CLARINET_EINVAL;
+            default:
+                return clarinet_error_from_sockapi_error(err);
+        }
+    }
+
+    return CLARINET_ENONE;
+}
+
+#endif /* defined(__linux__) */
+
+/* endregion */
+
+/* region Poller */
+
+void
+clarinet_poller_init(clarinet_poller* pp)
+{
+    memset(pp, 0, sizeof(clarinet_poller));
+}
+
+int
+clarinet_poller_open(clarinet_poller* pp)
+{
+    if (!pp || clarinet_handle_is_valid(pp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__)
+    const int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    pp->handle = fd;
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_poller_close(clarinet_poller* pp)
+{
+    if (!pp || !clarinet_handle_is_valid(pp))
+        return CLARINET_EINVAL;
+
+    if (close(pp->handle) == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    clarinet_poller_init(pp);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_poller_add(clarinet_poller* restrict pp,
+                    clarinet_socket* restrict sp,
+                    uint16_t events,
+                    void* data)
+{
+    #if defined(__linux__)
+    return epoll_control(pp, sp, EPOLL_CTL_ADD, events, data);
+    #else
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_poller_modify(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp,
+                       uint16_t events,
+                       void* data)
+{
+    #if defined(__linux__)
+    return epoll_control(pp, sp, EPOLL_CTL_MOD, events, data);
+    #else
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_poller_remove(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp)
+{
+    #if defined(__linux__)
+    /* Linux before 2.6.9 required a non-NULL event pointer even for EPOLL_CTL_DEL so we always pass one. */
+    return epoll_control(pp, sp, EPOLL_CTL_DEL, CLARINET_POLL_NONE, NULL);
+    #else
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_poller_wait(clarinet_poller* restrict pp,
+                     clarinet_poller_event* restrict events,
+                     size_t count,
+                     int timeout)
+{
+    if (!pp || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(pp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__)
+    /* Events are collected in a fixed size buffer and translated in chunks so no allocation is required. Only the
+     * first chunk may block. */
+    struct epoll_event ev[64];
+    size_t total = 0;
+    do
+    {
+        const int maxevents = (int)min(count - total, sizeof(ev) / sizeof(ev[0]));
+        const int n = epoll_wait(pp->handle, ev, maxevents, (total == 0) ? timeout : 0);
+        if (n < 0)
+        {
+            if (total > 0)
+                break;
+
+            return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            events[total + (size_t)i].data = ev[i].data.ptr;
+            events[total + (size_t)i].events = epoll_events_from_native(ev[i].events);
+        }
+
+        total += (size_t)n;
+        if (n < maxevents)
+            break;
+    } while (total < count);
+
+    return (int)total;
+    #else
+    CLARINET_IGNORE_PARAM(timeout);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/* endregion */
@@ -3,6 +3,8 @@
 
 #include "compat/addr.h"
 #include "compat/error.h"
+#include "compat/log.h"
+#include "compat/stats.h"
 
 #include <string.h>
 #include <unistd.h>
@@ -10,6 +12,13 @@
 #include <fcntl.h>
 #include <poll.h>
 
+#if defined(__linux__)
+#include <netinet/udp.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <time.h>
+#endif
+
 /* region Library Initialization */
 
 int
@@ -40,6 +49,49 @@ again(int e)
     #endif /* HAVE_EAGAIN_EQUAL_TO_EWOULDBLOCK */
 }
 
+/** Helper to translate socket event flags into poll(2) events. */
+CLARINET_STATIC_INLINE
+short
+poll_events_to_native(uint16_t events)
+{
+    short result = 0;
+    if (events & CLARINET_POLL_RECV)
+        result |= POLLIN;
+    if (events & CLARINET_POLL_SEND)
+        result |= POLLOUT;
+
+    #if defined(POLLRDHUP)
+    /* CLARINET_POLL_SHUTDOWN is always reported regardless of the events requested. */
+    result |= POLLRDHUP;
+    #endif
+
+    return result;
+}
+
+/** Helper to translate poll(2) revents into socket event flags. */
+CLARINET_STATIC_INLINE
+uint16_t
+poll_events_from_native(short revents)
+{
+    uint16_t result = CLARINET_POLL_NONE;
+    if (revents & POLLNVAL)
+        result |= CLARINET_POLL_INVALID;
+    if (revents & POLLERR)
+        result |= CLARINET_POLL_ERROR;
+    if (revents & POLLHUP)
+        result |= CLARINET_POLL_SHUTDOWN;
+    #if defined(POLLRDHUP)
+    if (revents & POLLRDHUP)
+        result |= CLARINET_POLL_SHUTDOWN;
+    #endif
+    if (revents & POLLIN)
+        result |= CLARINET_POLL_RECV;
+    if (revents & POLLOUT)
+        result |= CLARINET_POLL_SEND;
+
+    return result;
+}
+
 /** Helper for setting the socket blocking value.*/
 CLARINET_STATIC_INLINE
 int
@@ -58,6 +110,214 @@ setnonblock(int sockfd,
     return fcntl(sockfd, F_SETFL, flags);
 }
 
+/**
+ * Native option and control message used to implement CLARINET_SO_TIMESTAMP. SO_TIMESTAMPNS reports a struct timespec
+ * while SO_TIMESTAMP reports a struct timeval so nanosecond resolution is used when available.
+ */
+#if defined(SO_TIMESTAMPNS) && defined(SCM_TIMESTAMPNS)
+#define CLARINET_SOCKET_TIMESTAMP               SO_TIMESTAMPNS
+#define CLARINET_SOCKET_SCM_TIMESTAMP           SCM_TIMESTAMPNS
+#define CLARINET_SOCKET_TIMESTAMP_NS            1
+#elif defined(SO_TIMESTAMP) && defined(SCM_TIMESTAMP)
+#define CLARINET_SOCKET_TIMESTAMP               SO_TIMESTAMP
+#define CLARINET_SOCKET_SCM_TIMESTAMP           SCM_TIMESTAMP
+#define CLARINET_SOCKET_TIMESTAMP_NS            0
+#endif
+
+/**
+ * Native option and control message used to implement CLARINET_SO_TXTIME. The reference clock must be the clock of
+ * clarinet_time_now_us() so transmit times can be converted by a simple change of units.
+ */
+#if defined(__linux__) && defined(SO_TXTIME) && defined(SCM_TXTIME)
+#define CLARINET_SOCKET_TXTIME                  SO_TXTIME
+#define CLARINET_SOCKET_SCM_TXTIME              SCM_TXTIME
+#define CLARINET_SOCKET_TXTIME_CLOCK            CLOCK_MONOTONIC
+#endif
+
+/**
+ * Helper to translate the outcome of a successful recvmsg(2) into the number of bytes received. Returns a negative
+ * error code if the source address is invalid or the datagram was truncated. The source endpoint is always decoded
+ * first so it remains valid even when the datagram is reported truncated.
+ */
+CLARINET_STATIC_INLINE
+int
+recvmsg_result(const struct msghdr* msg,
+               size_t n,
+               size_t buflen,
+               clarinet_endpoint* remote)
+{
+    /* Sanity: improbable but possible if the system disagrees on the size of the sockaddr (then something is off)  */
+    if (msg->msg_namelen > sizeof(struct sockaddr_storage))
+        return CLARINET_EADDRNOTAVAIL;
+
+    const int errcode = clarinet_endpoint_from_sockaddr(remote, (const struct sockaddr_storage*)msg->msg_name);
+    if (errcode != CLARINET_ENONE)
+        return CLARINET_EADDRNOTAVAIL;
+
+    if (msg->msg_flags & MSG_TRUNC)
+        return CLARINET_EMSGSIZE;
+
+    /* Sanity: for platforms that may return the datagram size instead of implmenting MSG_TRUNC properly  */
+    if (n > buflen)
+        return CLARINET_EMSGSIZE;
+
+    return (int)n;
+}
+
+#if defined(CLARINET_SOCKET_TIMESTAMP)
+/**
+ * Helper to decode the receive timestamp of a datagram from the control messages of a successful recvmsg(2). Returns
+ * the number of nanoseconds since the Unix epoch or 0 if the message carries no timestamp.
+ */
+CLARINET_STATIC_INLINE
+uint64_t
+recvmsg_timestamp(struct msghdr* msg)
+{
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == CLARINET_SOCKET_SCM_TIMESTAMP)
+        {
+            #if CLARINET_SOCKET_TIMESTAMP_NS
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+            #else
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            return (uint64_t)tv.tv_sec * 1000000000u + (uint64_t)tv.tv_usec * 1000u;
+            #endif
+        }
+    }
+
+    return 0;
+}
+#endif /* defined(CLARINET_SOCKET_TIMESTAMP) */
+
+/**
+ * Helper to translate an array of scatter/gather buffers into an array of @c struct @c iovec. Returns the total length
+ * in bytes of all buffers or @c CLARINET_EINVAL if a buffer of non-zero length is NULL or the total length is greater
+ * than INT_MAX.
+ */
+CLARINET_STATIC_INLINE
+int
+iovec_to_native(struct iovec* restrict dst,
+                const clarinet_iovec* restrict src,
+                size_t count)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((!src[i].base && src[i].len > 0) || src[i].len > INT_MAX - total)
+            return CLARINET_EINVAL;
+
+        dst[i].iov_base = src[i].base;
+        dst[i].iov_len = src[i].len;
+        total += src[i].len;
+    }
+
+    return (int)total;
+}
+
+/**
+ * Helper to join or leave a multicast group. The protocol independent API of RFC3678 is used because it takes an
+ * interface index for both IPv4 and IPv6 and supports source-specific groups. The option level follows the family of
+ * the group so an IPv6 socket may join IPv4 groups on platforms that accept IPv4 options on IPv6 sockets.
+ */
+static
+int
+socket_mcast_membership(int sockfd,
+                        int family,
+                        const clarinet_mcast_group* mgroup,
+                        int join)
+{
+    int level;
+    if (clarinet_addr_is_multicast_ipv4(&mgroup->addr))
+        level = IPPROTO_IP;
+    #if CLARINET_ENABLE_IPV6
+    else if (clarinet_addr_is_multicast_ipv6(&mgroup->addr) && family == CLARINET_AF_INET6)
+        level = IPPROTO_IPV6;
+    #endif
+    else
+        return CLARINET_EINVAL;
+
+    (void)family;
+
+    const int any = clarinet_addr_is_unspec(&mgroup->source) || clarinet_addr_is_any_ip(&mgroup->source);
+    if (!any && mgroup->source.family != mgroup->addr.family)
+        return CLARINET_EINVAL;
+
+    #if defined(MCAST_JOIN_GROUP) && defined(MCAST_JOIN_SOURCE_GROUP)
+    clarinet_endpoint endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.addr = mgroup->addr;
+    if (any)
+    {
+        struct group_req req;
+        memset(&req, 0, sizeof(req));
+        req.gr_interface = mgroup->iface;
+        const int errcode = clarinet_endpoint_to_sockaddr(&req.gr_group, NULL, &endpoint);
+        if (errcode != CLARINET_ENONE)
+            return errcode;
+
+        const int optname = join ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP;
+        if (setsockopt(sockfd, level, optname, &req, sizeof(req)) == SOCKET_ERROR)
+            return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+        return CLARINET_ENONE;
+    }
+
+    struct group_source_req req;
+    memset(&req, 0, sizeof(req));
+    req.gsr_interface = mgroup->iface;
+    int errcode = clarinet_endpoint_to_sockaddr(&req.gsr_group, NULL, &endpoint);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    endpoint.addr = mgroup->source;
+    errcode = clarinet_endpoint_to_sockaddr(&req.gsr_source, NULL, &endpoint);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    const int optname = join ? MCAST_JOIN_SOURCE_GROUP : MCAST_LEAVE_SOURCE_GROUP;
+    if (setsockopt(sockfd, level, optname, &req, sizeof(req)) == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    return CLARINET_ENONE;
+    #else /* !(defined(MCAST_JOIN_GROUP) && defined(MCAST_JOIN_SOURCE_GROUP)) */
+    (void)sockfd;
+    (void)level;
+    (void)join;
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/** Helper to select the interface used to send IPv4 multicast packets by index. */
+static
+int
+socket_mcast_interface_ipv4(int sockfd,
+                            uint32_t index)
+{
+    #if defined(__linux__)
+    struct ip_mreqn mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_ifindex = (int)index;
+    if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)) == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    return CLARINET_ENONE;
+    #elif defined(IP_MULTICAST_IFINDEX)
+    const unsigned int ifindex = index;
+    if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_IFINDEX, &ifindex, sizeof(ifindex)) == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    return CLARINET_ENONE;
+    #else
+    (void)sockfd;
+    (void)index;
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
 /* endregion */
 
 /* region Socket */
@@ -172,6 +432,7 @@ clarinet_socket_open(clarinet_socket* sp,
     sp->family = (uint16_t)family;
     sp->handle = sockfd;
 
+    clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_SOCKET_OPEN, sockfd, family, proto, 0);
     return CLARINET_ENONE;
 }
 
@@ -229,6 +490,7 @@ clarinet_socket_close(clarinet_socket* sp)
         }
     }
 
+    clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_SOCKET_CLOSE, sockfd, 0, 0, 0);
     clarinet_socket_init(sp);
 
     return CLARINET_ENONE;
@@ -336,9 +598,11 @@ clarinet_socket_send(clarinet_socket* restrict sp,
     #else
     const int flags = 0;
     #endif
-    if (send(sockfd, buf, buflen, flags) == SOCKET_ERROR)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    const ssize_t n = send(sockfd, buf, buflen, flags);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
+    (void)clarinet_socket_stats_sent(sp, (int)n, 1);
     return CLARINET_ENONE;
 }
 
@@ -374,9 +638,9 @@ clarinet_socket_sendto(clarinet_socket* restrict sp,
 
     const ssize_t n = sendto(sockfd, buf, buflen, flags, (struct sockaddr*)&ss, sslen);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
-    return (int)n;
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
 }
 
 int
@@ -394,9 +658,9 @@ clarinet_socket_recv(clarinet_socket* restrict sp,
 
     const ssize_t n = recv(sockfd, buf, buflen, 0);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
-    return (int)n;
+    return clarinet_socket_stats_received(sp, (int)n, 1);
 }
 
 int
@@ -440,164 +704,881 @@ clarinet_socket_recvfrom(clarinet_socket* restrict sp,
 
     const ssize_t n = recvmsg(sockfd, &msg, 0);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
-
-    if (msg.msg_flags & MSG_TRUNC)
-        return CLARINET_EMSGSIZE;
-
-    /* Sanity: for platforms that may return the datagram size instead of implmenting MSG_TRUNC properly  */
-    if ((size_t)n > buflen)
-        return CLARINET_EMSGSIZE;
-
-    /* Sanity: improbable but possible if the system disagrees on the size of the sockaddr (then something is off)  */
-    if (msg.msg_namelen > sizeof(ss))
-        return CLARINET_EADDRNOTAVAIL;
-
-    const int errcode = clarinet_endpoint_from_sockaddr(remote, &ss);
-    if (errcode != CLARINET_ENONE)
-        return CLARINET_EADDRNOTAVAIL;
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
     assert(n >= 0);
-    return (int)n;
+    return clarinet_socket_stats_received(sp, recvmsg_result(&msg, (size_t)n, buflen, remote), 1);
 }
 
 int
-clarinet_socket_setopt(clarinet_socket* restrict sp,
-                       int optname,
-                       const void* restrict optval,
-                       size_t optlen)
+clarinet_socket_recvfromts(clarinet_socket* restrict sp,
+                           void* restrict buf,
+                           size_t buflen,
+                           uint64_t* restrict timestamp,
+                           clarinet_endpoint* restrict remote)
 {
-    if (!sp || sp->family == CLARINET_AF_UNSPEC || !optval || optlen > INT_MAX)
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX || !timestamp || !remote)
         return CLARINET_EINVAL;
 
     if (!clarinet_socket_handle_is_valid(sp))
         return CLARINET_EINVAL;
 
+    #if defined(CLARINET_SOCKET_TIMESTAMP)
     const int sockfd = clarinet_socket_handle(sp);
 
-    switch (optname)
+    struct sockaddr_storage ss;
+
+    /* The control buffer must be suitably aligned for a struct cmsghdr and large enough for either a struct timespec
+     * or a struct timeval. */
+    union
     {
-        case CLARINET_SO_NONBLOCK:
-            if (optlen == sizeof(int32_t))
-            {
-                const int val = *(const int32_t*)optval ? 1 : 0;
-                if (setnonblock(sockfd, val) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        char buf[CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(struct timeval))];
+        struct cmsghdr align;
+    } control;
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_REUSEADDR:
-            if (optlen == sizeof(int32_t))
-            {
-                const int val = *(const int32_t*)optval ? 1 : 0;
-                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    struct iovec iov;
+    struct msghdr msg;
 
-                #if defined(SO_REUSEPORT_LB)
-                /* Some BSD systems support a special reuse port mode that promotes load balancing between connections */
-                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT_LB, &val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
-                #elif defined(SO_REUSEPORT)
-                /* SO_REUSEPORT is only supported on Linux >= 3.9 but also promotes load balancing on UDP - may be
-                 * present on some patched 2.6 kernels (e.g. REHL 2.6.32) */
-                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
-                #endif /* defined(SO_REUSEPORT) */
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    msg.msg_flags = 0;
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sizeof(ss);
 
-                #if defined(SO_EXCLBIND)
-                /* Solaris supports SO_EXCLBIND similarly to SO_EXCLUSIVEADDRUSE on Windows */
-                if (setsockopt(sockfd, SOL_SOCKET, SO_EXCLBIND, &val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
-                #endif /* defined(SO_EXCLBIND) */
+    iov.iov_base = buf;
+    iov.iov_len = buflen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_SNDBUF:
-            if (optlen == sizeof(int32_t))
-            {
-                #if defined(__linux__)
-                /* Linux doubles the buffer size passed to setsockopt(2), so we half it here to more closely match
-                 * how bufffer sizes are set in other platforms. The effect is that odd numbers are rounded down
-                 * to the closest even number. */
-                const int val = (int)clamp(*(const int32_t*)optval, 0, INT_MAX) >> 1;
-                #else
-                const int val = (int)clamp(*(const int32_t*)optval, INT_MIN, INT_MAX);
-                #endif /* defined(__linux__) */
-                if (setsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    const ssize_t n = recvmsg(sockfd, &msg, 0);
+    if (n < 0)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_RCVBUF:
-            if (optlen == sizeof(int32_t))
-            {
-                /* Linux doubles the buffer size passed to setsockopt, so we half it here to more closely match
-                 * how bufffer sizes are set in other platforms. The effect is that odd numbers are rounded down
-                 * to the closest even number. */
-                #if defined(__linux__)
-                const int val = (int)clamp(*(const int32_t*)optval, 0, INT_MAX) >> 1;
-                #else
-                const int val = (int)clamp(*(const int32_t*)optval, INT_MIN, INT_MAX);
-                #endif /* defined(__linux__) */
-                if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    assert(n >= 0);
+    const int result = clarinet_socket_stats_received(sp, recvmsg_result(&msg, (size_t)n, buflen, remote), 1);
+    if (result < 0)
+        return result;
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_SNDTIMEO:
-            if (optlen == sizeof(int32_t))
-            {
-                struct timeval val;
-                ms2tv(&val, (int)clamp(*(const int32_t*)optval, 0, INT_MAX));
-                if (setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    *timestamp = recvmsg_timestamp(&msg);
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_RCVTIMEO:
-            if (optlen == sizeof(int32_t))
-            {
-                struct timeval val;
-                ms2tv(&val, (int)clamp(*(const int32_t*)optval, 0, INT_MAX));
-                if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    return result;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif /* defined(CLARINET_SOCKET_TIMESTAMP) */
+}
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_KEEPALIVE:
-            if (optlen == sizeof(int32_t))
-            {
-                int val = 0;
-                socklen_t len = sizeof(val);
+int
+clarinet_socket_sendv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX)
+        return CLARINET_EINVAL;
 
-                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_STREAM);
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
 
-                val = *(const int32_t*)optval ? 1 : 0;
-                if (setsockopt(sockfd, SOL_SOCKET, SO_KEEPALIVE, &val, sizeof(val)) == SOCKET_ERROR)
-                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    const int sockfd = clarinet_socket_handle(sp);
 
-                return CLARINET_ENONE;
-            }
-            break;
-        case CLARINET_SO_LINGER:
-            if (optlen == sizeof(clarinet_linger))
-            {
-                int val = 0;
-                socklen_t len = sizeof(val);
+    struct iovec buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total < 0)
+        return total;
 
-                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_STREAM);
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = buffers;
+    msg.msg_iovlen = iovcnt;
 
-                const clarinet_linger* optret = (const clarinet_linger*)optval;
-                struct linger linger;
-                linger.l_onoff = optret->enabled;
-                linger.l_linger = optret->seconds;
-                if (setsockopt(sockfd, SOL_SOCKET, SO_LINGER, (const void*)&linger, sizeof(linger)) == SOCKET_ERROR)
+    #if defined(__linux__)
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    const ssize_t n = sendmsg(sockfd, &msg, flags);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_sendtov(clarinet_socket* restrict sp,
+                        const clarinet_iovec* restrict iov,
+                        size_t iovcnt,
+                        const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct iovec buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total < 0)
+        return total;
+
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sslen;
+    msg.msg_iov = buffers;
+    msg.msg_iovlen = iovcnt;
+
+    #if defined(__linux__)
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    const ssize_t n = sendmsg(sockfd, &msg, flags);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_recvv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct iovec buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total <= 0)
+        return CLARINET_EINVAL;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = buffers;
+    msg.msg_iovlen = iovcnt;
+
+    const ssize_t n = recvmsg(sockfd, &msg, 0);
+    if (n < 0)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    /* Same truncation checks as recvmsg_result() but there is no source address to decode. */
+    if ((msg.msg_flags & MSG_TRUNC) || (size_t)n > (size_t)total)
+        return clarinet_socket_stats_received(sp, CLARINET_EMSGSIZE, 0);
+
+    return clarinet_socket_stats_received(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_recvfromv(clarinet_socket* restrict sp,
+                          const clarinet_iovec* restrict iov,
+                          size_t iovcnt,
+                          clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct iovec buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total <= 0)
+        return CLARINET_EINVAL;
+
+    struct sockaddr_storage ss;
+    struct msghdr msg;
+
+    msg.msg_control = NULL;
+    msg.msg_controllen = 0;
+    msg.msg_flags = 0;
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sizeof(ss);
+    msg.msg_iov = buffers;
+    msg.msg_iovlen = iovcnt;
+
+    const ssize_t n = recvmsg(sockfd, &msg, 0);
+    if (n < 0)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    assert(n >= 0);
+    return clarinet_socket_stats_received(sp, recvmsg_result(&msg, (size_t)n, (size_t)total, remote), 1);
+}
+
+int
+clarinet_socket_sendtoat(clarinet_socket* restrict sp,
+                         const void* restrict buf,
+                         size_t buflen,
+                         const clarinet_endpoint* restrict remote,
+                         uint64_t txtime)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if defined(CLARINET_SOCKET_TXTIME)
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    /* The control buffer must be suitably aligned for a struct cmsghdr */
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(uint64_t))];
+        struct cmsghdr align;
+    } control;
+
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov;
+    struct msghdr msg;
+
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    msg.msg_flags = 0;
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sslen;
+
+    iov.iov_base = (void*)buf;
+    iov.iov_len = buflen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = CLARINET_SOCKET_SCM_TXTIME;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+
+    /* The system expects nanoseconds of the reference clock */
+    const uint64_t val = txtime * 1000;
+    memcpy(CMSG_DATA(cmsg), &val, sizeof(val));
+
+    const ssize_t n = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+    #else
+    CLARINET_IGNORE_PARAM(txtime);
+    return CLARINET_ENOTSUP;
+    #endif /* defined(CLARINET_SOCKET_TXTIME) */
+}
+
+int
+clarinet_socket_sendsegments(clarinet_socket* restrict sp,
+                             const void* restrict buf,
+                             size_t buflen,
+                             size_t segsize,
+                             const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX
+        || segsize == 0 || segsize > UINT16_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__) && defined(UDP_SEGMENT)
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    /* The control buffer must be suitably aligned for a struct cmsghdr */
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } control;
+
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov;
+    struct msghdr msg;
+
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    msg.msg_flags = 0;
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sslen;
+
+    iov.iov_base = (void*)buf;
+    iov.iov_len = buflen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+    const uint16_t val = (uint16_t)segsize;
+    memcpy(CMSG_DATA(cmsg), &val, sizeof(val));
+
+    const ssize_t n = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, ((size_t)n + segsize - 1) / segsize);
+    #else
+    return CLARINET_ENOTSUP;
+    #endif /* defined(__linux__) && defined(UDP_SEGMENT) */
+}
+
+int
+clarinet_socket_recvsegments(clarinet_socket* restrict sp,
+                             void* restrict buf,
+                             size_t buflen,
+                             size_t* restrict segsize,
+                             clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX || !segsize || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__) && defined(UDP_GRO)
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct sockaddr_storage ss;
+
+    /* The control buffer must be suitably aligned for a struct cmsghdr */
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+
+    struct iovec iov;
+    struct msghdr msg;
+
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    msg.msg_flags = 0;
+    msg.msg_name = (struct sockaddr*)&ss;
+    msg.msg_namelen = sizeof(ss);
+
+    iov.iov_base = buf;
+    iov.iov_len = buflen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    const ssize_t n = recvmsg(sockfd, &msg, 0);
+    if (n < 0)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    assert(n >= 0);
+    const int result = recvmsg_result(&msg, (size_t)n, buflen, remote);
+    if (result < 0)
+        return clarinet_socket_stats_received(sp, result, 0);
+
+    /* Datagrams that were not coalesced carry no control message in which case there is a single segment. */
+    *segsize = (size_t)n;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+        {
+            int val;
+            memcpy(&val, CMSG_DATA(cmsg), sizeof(val));
+            if (val > 0)
+                *segsize = (size_t)val;
+            break;
+        }
+    }
+
+    return clarinet_socket_stats_received(sp, result, (n > 0) ? ((size_t)n + *segsize - 1) / *segsize : 1);
+    #else
+    return CLARINET_ENOTSUP;
+    #endif /* defined(__linux__) && defined(UDP_GRO) */
+}
+
+int
+clarinet_socket_sendzc(clarinet_socket* restrict sp,
+                       const void* restrict buf,
+                       size_t buflen,
+                       const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    const int sockfd = clarinet_socket_handle(sp);
+
+    struct sockaddr_storage ss;
+    socklen_t sslen = 0;
+    if (remote)
+    {
+        const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+        if (errcode != CLARINET_ENONE)
+            return errcode;
+    }
+
+    /* See clarinet_socket_send() for MSG_NOSIGNAL. Small buffers are copied since pinning pages and processing the
+     * completion notification costs more than the copy. */
+    int flags = MSG_NOSIGNAL;
+    if (buflen >= CLARINET_ZEROCOPY_THRESHOLD)
+        flags |= MSG_ZEROCOPY;
+
+    const ssize_t n = sendto(sockfd, buf, buflen, flags, remote ? (struct sockaddr*)&ss : NULL, sslen);
+    if (n < 0)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+    #else
+    CLARINET_IGNORE_PARAM(remote);
+    return CLARINET_ENOTSUP;
+    #endif /* defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) */
+}
+
+int
+clarinet_socket_zerocopy_reap(clarinet_socket* restrict sp,
+                              clarinet_zerocopy_range* restrict ranges,
+                              size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !ranges || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    const int sockfd = clarinet_socket_handle(sp);
+
+    /* Each read from the error queue returns a single notification. The control buffer must be suitably aligned for a
+     * struct cmsghdr and large enough for the offender address that may follow an ICMP error. */
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_storage))];
+        struct cmsghdr align;
+    } control;
+
+    size_t total = 0;
+    while (total < count)
+    {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        if (recvmsg(sockfd, &msg, MSG_ERRQUEUE) == SOCKET_ERROR)
+        {
+            const int err = clarinet_get_sockapi_error();
+            if (again(err) || total > 0)
+                break;
+
+            return clarinet_error_from_sockapi_error(err);
+        }
+
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+                  || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+                continue;
+
+            struct sock_extended_err serr;
+            memcpy(&serr, CMSG_DATA(cmsg), sizeof(serr));
+            if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+
+            ranges[total].first = serr.ee_info;
+            ranges[total].last = serr.ee_data;
+            ranges[total].copied = (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) ? 1 : 0;
+            total++;
+        }
+    }
+
+    return (int)total;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif /* defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) */
+}
+
+int
+clarinet_socket_sendmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !msgs || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((!msgs[i].buf && msgs[i].buflen > 0) || msgs[i].buflen > INT_MAX)
+            return CLARINET_EINVAL;
+    }
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    #if defined(__linux__)
+    /**
+     * @c MSG_NOSIGNAL (since Linux 2.2) Requests not to send @c SIGPIPE on errors on stream oriented sockets when the
+     * other end breaks the connection. The @c EPIPE error is still returned.
+     */
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    size_t sent = 0;
+
+    #if HAVE_SENDMMSG
+    struct mmsghdr msgvec[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+    struct iovec iov[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+    struct sockaddr_storage ss[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+
+    while (sent < count)
+    {
+        const size_t batch = min(count - sent, CLARINET_SOCKET_MESSAGE_BATCH_SIZE);
+
+        /* An invalid endpoint interrupts the batch so that all messages before it are still sent in order. */
+        int errcode = CLARINET_ENONE;
+        size_t prepared = 0;
+        for (; prepared < batch; ++prepared)
+        {
+            clarinet_socket_message* m = &msgs[sent + prepared];
+            socklen_t sslen;
+            errcode = clarinet_endpoint_to_sockaddr(&ss[prepared], &sslen, &m->remote);
+            if (errcode != CLARINET_ENONE)
+                break;
+
+            iov[prepared].iov_base = m->buf;
+            iov[prepared].iov_len = m->buflen;
+
+            memset(&msgvec[prepared], 0, sizeof(struct mmsghdr));
+            msgvec[prepared].msg_hdr.msg_name = (struct sockaddr*)&ss[prepared];
+            msgvec[prepared].msg_hdr.msg_namelen = sslen;
+            msgvec[prepared].msg_hdr.msg_iov = &iov[prepared];
+            msgvec[prepared].msg_hdr.msg_iovlen = 1;
+        }
+
+        if (prepared > 0)
+        {
+            const int n = sendmmsg(sockfd, msgvec, (unsigned int)prepared, flags);
+            clarinet_socket_stats_syscall(sp);
+            if (n < 0)
+            {
+                const int err = clarinet_socket_stats_out(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+                if (sent > 0)
+                    break;
+
+                return err;
+            }
+
+            for (size_t i = 0; i < (size_t)n; ++i)
+                msgs[sent + i].result = clarinet_socket_stats_out(sp, (int)msgvec[i].msg_len, 1);
+
+            sent += (size_t)n;
+            if ((size_t)n < prepared)
+                break;
+        }
+
+        if (errcode != CLARINET_ENONE)
+            return sent > 0 ? (int)sent : errcode;
+    }
+    #else
+    for (; sent < count; ++sent)
+    {
+        clarinet_socket_message* m = &msgs[sent];
+
+        struct sockaddr_storage ss;
+        socklen_t sslen;
+        const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, &m->remote);
+        if (errcode != CLARINET_ENONE)
+            return sent > 0 ? (int)sent : errcode;
+
+        const ssize_t n = sendto(sockfd, m->buf, m->buflen, flags, (struct sockaddr*)&ss, sslen);
+        if (n < 0)
+        {
+            const int err = clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+            if (sent > 0)
+                break;
+
+            return err;
+        }
+
+        m->result = clarinet_socket_stats_sent(sp, (int)n, 1);
+    }
+    #endif /* HAVE_SENDMMSG */
+
+    assert(sent > 0 && sent <= INT_MAX);
+    return (int)sent;
+}
+
+int
+clarinet_socket_recvmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !msgs || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!msgs[i].buf || msgs[i].buflen == 0 || msgs[i].buflen > INT_MAX)
+            return CLARINET_EINVAL;
+    }
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    size_t received = 0;
+
+    #if HAVE_RECVMMSG
+    struct mmsghdr msgvec[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+    struct iovec iov[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+    struct sockaddr_storage ss[CLARINET_SOCKET_MESSAGE_BATCH_SIZE];
+
+    while (received < count)
+    {
+        const size_t batch = min(count - received, CLARINET_SOCKET_MESSAGE_BATCH_SIZE);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            clarinet_socket_message* m = &msgs[received + i];
+
+            iov[i].iov_base = m->buf;
+            iov[i].iov_len = m->buflen;
+
+            memset(&msgvec[i], 0, sizeof(struct mmsghdr));
+            msgvec[i].msg_hdr.msg_name = (struct sockaddr*)&ss[i];
+            msgvec[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+            msgvec[i].msg_hdr.msg_iov = &iov[i];
+            msgvec[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        /* Only the first datagram may block (according to the socket mode). Subsequent batches just drain what is
+         * already queued. */
+        const int flags = (received == 0) ? MSG_WAITFORONE : MSG_DONTWAIT;
+        const int n = recvmmsg(sockfd, msgvec, (unsigned int)batch, flags, NULL);
+        clarinet_socket_stats_syscall(sp);
+        if (n < 0)
+        {
+            const int err = clarinet_socket_stats_in(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+            if (received > 0)
+                break;
+
+            return err;
+        }
+
+        for (size_t i = 0; i < (size_t)n; ++i)
+        {
+            clarinet_socket_message* m = &msgs[received + i];
+            m->result = clarinet_socket_stats_in(sp, recvmsg_result(&msgvec[i].msg_hdr, msgvec[i].msg_len, m->buflen,
+                                                                    &m->remote), 1);
+        }
+
+        received += (size_t)n;
+        if ((size_t)n < batch)
+            break;
+    }
+    #else
+    for (; received < count; ++received)
+    {
+        clarinet_socket_message* m = &msgs[received];
+
+        struct sockaddr_storage ss;
+        struct iovec iov;
+        struct msghdr msg;
+
+        msg.msg_control = NULL;
+        msg.msg_controllen = 0;
+        msg.msg_flags = 0;
+        msg.msg_name = (struct sockaddr*)&ss;
+        msg.msg_namelen = sizeof(ss);
+
+        iov.iov_base = m->buf;
+        iov.iov_len = m->buflen;
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        /* Only the first datagram may block (according to the socket mode). */
+        const ssize_t n = recvmsg(sockfd, &msg, (received == 0) ? 0 : MSG_DONTWAIT);
+        if (n < 0)
+        {
+            const int err = clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+            if (received > 0)
+                break;
+
+            return err;
+        }
+
+        m->result = clarinet_socket_stats_received(sp, recvmsg_result(&msg, (size_t)n, m->buflen, &m->remote), 1);
+    }
+    #endif /* HAVE_RECVMMSG */
+
+    assert(received > 0 && received <= INT_MAX);
+    return (int)received;
+}
+
+int
+clarinet_socket_setopt(clarinet_socket* restrict sp,
+                       int optname,
+                       const void* restrict optval,
+                       size_t optlen)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !optval || optlen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const int sockfd = clarinet_socket_handle(sp);
+
+    switch (optname)
+    {
+        case CLARINET_SO_NONBLOCK:
+            if (optlen == sizeof(int32_t))
+            {
+                const int val = *(const int32_t*)optval ? 1 : 0;
+                if (setnonblock(sockfd, val) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_REUSEADDR:
+            if (optlen == sizeof(int32_t))
+            {
+                const int val = *(const int32_t*)optval ? 1 : 0;
+                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                #if defined(SO_REUSEPORT_LB)
+                /* Some BSD systems support a special reuse port mode that promotes load balancing between connections */
+                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT_LB, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                #elif defined(SO_REUSEPORT)
+                /* SO_REUSEPORT is only supported on Linux >= 3.9 but also promotes load balancing on UDP - may be
+                 * present on some patched 2.6 kernels (e.g. REHL 2.6.32) */
+                if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                #endif /* defined(SO_REUSEPORT) */
+
+                #if defined(SO_EXCLBIND)
+                /* Solaris supports SO_EXCLBIND similarly to SO_EXCLUSIVEADDRUSE on Windows */
+                if (setsockopt(sockfd, SOL_SOCKET, SO_EXCLBIND, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                #endif /* defined(SO_EXCLBIND) */
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_SNDBUF:
+            if (optlen == sizeof(int32_t))
+            {
+                #if defined(__linux__)
+                /* Linux doubles the buffer size passed to setsockopt(2), so we half it here to more closely match
+                 * how bufffer sizes are set in other platforms. The effect is that odd numbers are rounded down
+                 * to the closest even number. */
+                const int val = (int)clamp(*(const int32_t*)optval, 0, INT_MAX) >> 1;
+                #else
+                const int val = (int)clamp(*(const int32_t*)optval, INT_MIN, INT_MAX);
+                #endif /* defined(__linux__) */
+                if (setsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_RCVBUF:
+            if (optlen == sizeof(int32_t))
+            {
+                /* Linux doubles the buffer size passed to setsockopt, so we half it here to more closely match
+                 * how bufffer sizes are set in other platforms. The effect is that odd numbers are rounded down
+                 * to the closest even number. */
+                #if defined(__linux__)
+                const int val = (int)clamp(*(const int32_t*)optval, 0, INT_MAX) >> 1;
+                #else
+                const int val = (int)clamp(*(const int32_t*)optval, INT_MIN, INT_MAX);
+                #endif /* defined(__linux__) */
+                if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_SNDTIMEO:
+            if (optlen == sizeof(int32_t))
+            {
+                struct timeval val;
+                ms2tv(&val, (int)clamp(*(const int32_t*)optval, 0, INT_MAX));
+                if (setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_RCVTIMEO:
+            if (optlen == sizeof(int32_t))
+            {
+                struct timeval val;
+                ms2tv(&val, (int)clamp(*(const int32_t*)optval, 0, INT_MAX));
+                if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const void*)&val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_KEEPALIVE:
+            if (optlen == sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_STREAM);
+
+                val = *(const int32_t*)optval ? 1 : 0;
+                if (setsockopt(sockfd, SOL_SOCKET, SO_KEEPALIVE, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_SO_LINGER:
+            if (optlen == sizeof(clarinet_linger))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_STREAM);
+
+                const clarinet_linger* optret = (const clarinet_linger*)optval;
+                struct linger linger;
+                linger.l_onoff = optret->enabled;
+                linger.l_linger = optret->seconds;
+                if (setsockopt(sockfd, SOL_SOCKET, SO_LINGER, (const void*)&linger, sizeof(linger)) == SOCKET_ERROR)
                     return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
                 return CLARINET_ENONE;
@@ -626,6 +1607,81 @@ clarinet_socket_setopt(clarinet_socket* restrict sp,
                 return CLARINET_ENONE;
             }
             break;
+        case CLARINET_SO_ZEROCOPY:
+            #if defined(__linux__) && defined(SO_ZEROCOPY)
+            if (optlen == sizeof(int32_t))
+            {
+                int val = *(const int32_t*)optval ? 1 : 0;
+                if (setsockopt(sockfd, SOL_SOCKET, SO_ZEROCOPY, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(SO_ZEROCOPY) */
+            break;
+        case CLARINET_SO_TIMESTAMP:
+            #if defined(CLARINET_SOCKET_TIMESTAMP)
+            if (optlen == sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                val = *(const int32_t*)optval ? 1 : 0;
+                if (setsockopt(sockfd, SOL_SOCKET, CLARINET_SOCKET_TIMESTAMP, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(CLARINET_SOCKET_TIMESTAMP) */
+            break;
+        case CLARINET_SO_MAX_PACING_RATE:
+            #if defined(__linux__) && defined(SO_MAX_PACING_RATE)
+            if (optlen == sizeof(uint64_t))
+            {
+                const uint64_t rate = *(const uint64_t*)optval;
+                if (rate == 0)
+                    return CLARINET_EINVAL;
+
+                /* The native option takes a 32-bit value where ~0U means unlimited. Larger rates require the wider
+                 * form accepted by 64-bit systems. */
+                if (rate < UINT32_MAX || rate == UINT64_MAX)
+                {
+                    const uint32_t val = (uint32_t)rate;
+                    if (setsockopt(sockfd, SOL_SOCKET, SO_MAX_PACING_RATE, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                }
+                else
+                {
+                    const unsigned long val = rate < ULONG_MAX ? (unsigned long)rate : ULONG_MAX - 1;
+                    if (setsockopt(sockfd, SOL_SOCKET, SO_MAX_PACING_RATE, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                }
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(SO_MAX_PACING_RATE) */
+            break;
+        case CLARINET_SO_TXTIME:
+            #if defined(CLARINET_SOCKET_TXTIME)
+            if (optlen == sizeof(int32_t) && *(const int32_t*)optval)
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                struct sock_txtime txtime;
+                memset(&txtime, 0, sizeof(txtime));
+                txtime.clockid = CLARINET_SOCKET_TXTIME_CLOCK;
+                if (setsockopt(sockfd, SOL_SOCKET, CLARINET_SOCKET_TXTIME, &txtime, sizeof(txtime)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(CLARINET_SOCKET_TXTIME) */
+            break;
         case CLARINET_IP_V6ONLY:
             #if CLARINET_ENABLE_IPV6
             if (optlen == sizeof(int32_t))
@@ -642,103 +1698,249 @@ clarinet_socket_setopt(clarinet_socket* restrict sp,
             }
             #endif /* CLARINET_ENABLE_IPV6 */
             break;
-        case CLARINET_IP_TTL:
-            if (optlen == sizeof(int32_t))
+        case CLARINET_IP_TTL:
+            if (optlen == sizeof(int32_t))
+            {
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    const int val = *(const int32_t*)optval;
+                    if (setsockopt(sockfd, IPPROTO_IP, IP_TTL, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    const int val = *(const int32_t*)optval;
+                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_UNICAST_HOPS, &val, sizeof(val)) == SOCKET_ERROR) /* curiously IPV6_HOPLIMIT corresponds to IP_RECV_TTL not IP_TTL */
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_IP_MTU_DISCOVER:
+            if (optlen == sizeof(int32_t))
+            {
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    int val;
+                    switch (*(const int32_t*)optval)
+                    {
+                        case CLARINET_PMTUD_UNSPEC:
+                            val = IP_PMTUDISC_WANT;
+                            break;
+                        case CLARINET_PMTUD_ON:
+                            val = IP_PMTUDISC_DO;
+                            break;
+                        case CLARINET_PMTUD_OFF:
+                            #if defined(__linux__) && defined(IP_PMTUDISC_OMIT)
+                            val = IP_PMTUDISC_OMIT;
+                            #elif defined(__linux__) && defined(IP_PMTUDISC_INTERFACE)
+                            val = IP_PMTUDISC_INTERAFCE;
+                            #else
+                            val = IP_PMTUDISC_DONT;
+                            #endif
+                            break;
+                        case CLARINET_PMTUD_PROBE:
+                            val = IP_PMTUDISC_PROBE;
+                            break;
+                        default:
+                            return CLARINET_EINVAL;
+                    }
+
+                    if (setsockopt(sockfd, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    int val;
+                    switch (*(const int32_t*)optval)
+                    {
+                        case CLARINET_PMTUD_UNSPEC:
+                            val = IPV6_PMTUDISC_WANT;
+                            break;
+                        case CLARINET_PMTUD_ON:
+                            val = IPV6_PMTUDISC_DO;
+                            break;
+                        case CLARINET_PMTUD_OFF:
+                            #if defined(__linux__) && defined(IPV6_PMTUDISC_OMIT)
+                            val = IPV6_PMTUDISC_OMIT;
+                            #else
+                            val = IPV6_PMTUDISC_DONT;
+                            #endif
+                            break;
+                        case CLARINET_PMTUD_PROBE:
+                            val = IPV6_PMTUDISC_PROBE;
+                            break;
+                        default:
+                            return CLARINET_EINVAL;
+                    }
+
+                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_IP_BROADCAST:
+            if (optlen == sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                val = *(const int32_t*)optval ? 1 : 0;
+                if (setsockopt(sockfd, SOL_SOCKET, SO_BROADCAST, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                return CLARINET_ENONE;
+            }
+            break;
+        case CLARINET_IP_MCAST_TTL:
+            if (optlen == sizeof(uint32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const uint32_t ttl = *(const uint32_t*)optval;
+                if (ttl > UINT8_MAX)
+                    return CLARINET_EINVAL;
+
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    /* BSD systems only accept an unsigned char */
+                    const unsigned char ttl8 = (unsigned char)ttl;
+                    if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl8, sizeof(ttl8)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    val = (int)ttl;
+                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &val, sizeof(val)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_IP_MCAST_LOOP:
+            if (optlen == sizeof(uint32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    /* BSD systems only accept an unsigned char */
+                    const unsigned char loop = *(const uint32_t*)optval ? 1 : 0;
+                    if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    const unsigned int loop = *(const uint32_t*)optval ? 1 : 0;
+                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop)) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_IP_MCAST_JOIN:
+        case CLARINET_IP_MCAST_LEAVE:
+            if (optlen == sizeof(clarinet_mcast_group))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const clarinet_mcast_group* mgroup = (const clarinet_mcast_group*)optval;
+                return socket_mcast_membership(sockfd, sp->family, mgroup, optname == CLARINET_IP_MCAST_JOIN);
+            }
+            break;
+        case CLARINET_IP_MCAST_IF:
+            if (optlen == sizeof(uint32_t))
             {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const uint32_t index = *(const uint32_t*)optval;
                 const int family = sp->family;
                 if (family == CLARINET_AF_INET)
-                {
-                    const int val = *(const int32_t*)optval;
-                    if (setsockopt(sockfd, IPPROTO_IP, IP_TTL, &val, sizeof(val)) == SOCKET_ERROR)
-                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
-
-                    return CLARINET_ENONE;
-                }
+                    return socket_mcast_interface_ipv4(sockfd, index);
 
                 #if CLARINET_ENABLE_IPV6
                 if (family == CLARINET_AF_INET6)
                 {
-                    const int val = *(const int32_t*)optval;
-                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_UNICAST_HOPS, &val, sizeof(val)) == SOCKET_ERROR) /* curiously IPV6_HOPLIMIT corresponds to IP_RECV_TTL not IP_TTL */
+                    const unsigned int ifindex = index;
+                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_IF, &ifindex, sizeof(ifindex)) == SOCKET_ERROR)
                         return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
+                    #if defined(__linux__)
+                    /* Linux accepts IPv4 options on IPv6 sockets where they govern packets sent to IPv4-mapped
+                     * addresses. */
+                    return socket_mcast_interface_ipv4(sockfd, index);
+                    #else
                     return CLARINET_ENONE;
+                    #endif
                 }
                 #endif /* CLARINET_ENABLE_IPV6 */
             }
             break;
-        case CLARINET_IP_MTU_DISCOVER:
+        case CLARINET_UDP_SEGMENT:
+            #if defined(__linux__) && defined(UDP_SEGMENT)
             if (optlen == sizeof(int32_t))
             {
-                const int family = sp->family;
-                if (family == CLARINET_AF_INET)
-                {
-                    int val;
-                    switch (*(const int32_t*)optval)
-                    {
-                        case CLARINET_PMTUD_UNSPEC:
-                            val = IP_PMTUDISC_WANT;
-                            break;
-                        case CLARINET_PMTUD_ON:
-                            val = IP_PMTUDISC_DO;
-                            break;
-                        case CLARINET_PMTUD_OFF:
-                            #if defined(__linux__) && defined(IP_PMTUDISC_OMIT)
-                            val = IP_PMTUDISC_OMIT;
-                            #elif defined(__linux__) && defined(IP_PMTUDISC_INTERFACE)
-                            val = IP_PMTUDISC_INTERAFCE;
-                            #else
-                            val = IP_PMTUDISC_DONT;
-                            #endif
-                            break;
-                        case CLARINET_PMTUD_PROBE:
-                            val = IP_PMTUDISC_PROBE;
-                            break;
-                        default:
-                            return CLARINET_EINVAL;
-                    }
-
-                    if (setsockopt(sockfd, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val)) == SOCKET_ERROR)
-                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                int val = 0;
+                socklen_t len = sizeof(val);
 
-                    return CLARINET_ENONE;
-                }
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
 
-                #if CLARINET_ENABLE_IPV6
-                if (family == CLARINET_AF_INET6)
-                {
-                    int val;
-                    switch (*(const int32_t*)optval)
-                    {
-                        case CLARINET_PMTUD_UNSPEC:
-                            val = IPV6_PMTUDISC_WANT;
-                            break;
-                        case CLARINET_PMTUD_ON:
-                            val = IPV6_PMTUDISC_DO;
-                            break;
-                        case CLARINET_PMTUD_OFF:
-                            #if defined(__linux__) && defined(IPV6_PMTUDISC_OMIT)
-                            val = IPV6_PMTUDISC_OMIT;
-                            #else
-                            val = IPV6_PMTUDISC_DONT;
-                            #endif
-                            break;
-                        case CLARINET_PMTUD_PROBE:
-                            val = IPV6_PMTUDISC_PROBE;
-                            break;
-                        default:
-                            return CLARINET_EINVAL;
-                    }
+                val = *(const int32_t*)optval;
+                if (val < 0 || val > UINT16_MAX)
+                    return CLARINET_EINVAL;
 
-                    if (setsockopt(sockfd, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &val, sizeof(val)) == SOCKET_ERROR)
-                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+                if (setsockopt(sockfd, SOL_UDP, UDP_SEGMENT, &val, sizeof(val)) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
-                    return CLARINET_ENONE;
-                }
-                #endif /* CLARINET_ENABLE_IPV6 */
+                return CLARINET_ENONE;
             }
+            #endif /* defined(__linux__) && defined(UDP_SEGMENT) */
             break;
-        case CLARINET_IP_BROADCAST:
+        case CLARINET_UDP_GRO:
+            #if defined(__linux__) && defined(UDP_GRO)
             if (optlen == sizeof(int32_t))
             {
                 int val = 0;
@@ -747,11 +1949,12 @@ clarinet_socket_setopt(clarinet_socket* restrict sp,
                 CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
 
                 val = *(const int32_t*)optval ? 1 : 0;
-                if (setsockopt(sockfd, SOL_SOCKET, SO_BROADCAST, &val, sizeof(val)) == SOCKET_ERROR)
+                if (setsockopt(sockfd, SOL_UDP, UDP_GRO, &val, sizeof(val)) == SOCKET_ERROR)
                     return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
                 return CLARINET_ENONE;
             }
+            #endif /* defined(__linux__) && defined(UDP_GRO) */
             break;
         default:
             break;
@@ -943,6 +2146,105 @@ clarinet_socket_getopt(clarinet_socket* restrict sp,
                 return CLARINET_ENONE;
             }
             break;
+        case CLARINET_SO_ZEROCOPY:
+            #if defined(__linux__) && defined(SO_ZEROCOPY)
+            if (*optlen >= sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+                if (getsockopt(sockfd, SOL_SOCKET, SO_ZEROCOPY, &val, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                if (len != sizeof(val)) /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(int32_t*)optval = (int32_t)val;
+                *optlen = sizeof(int32_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(SO_ZEROCOPY) */
+            break;
+        case CLARINET_SO_TIMESTAMP:
+            #if defined(CLARINET_SOCKET_TIMESTAMP)
+            if (*optlen >= sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                if (getsockopt(sockfd, SOL_SOCKET, CLARINET_SOCKET_TIMESTAMP, &val, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                if (len != sizeof(val)) /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(int32_t*)optval = (int32_t)(val ? 1 : 0);
+                *optlen = sizeof(int32_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(CLARINET_SOCKET_TIMESTAMP) */
+            break;
+        case CLARINET_SO_MAX_PACING_RATE:
+            #if defined(__linux__) && defined(SO_MAX_PACING_RATE)
+            if (*optlen >= sizeof(uint64_t))
+            {
+                /* 64-bit systems report the wider form when there is room for it. */
+                union
+                {
+                    uint32_t u32;
+                    unsigned long ul;
+                } val;
+
+                memset(&val, 0, sizeof(val));
+                socklen_t len = sizeof(val);
+                if (getsockopt(sockfd, SOL_SOCKET, SO_MAX_PACING_RATE, &val, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                uint64_t rate;
+                if (len == sizeof(val.ul))
+                    rate = val.ul == ULONG_MAX ? UINT64_MAX : (uint64_t)val.ul;
+                else if (len == sizeof(val.u32))
+                    rate = val.u32 == UINT32_MAX ? UINT64_MAX : (uint64_t)val.u32;
+                else /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(uint64_t*)optval = rate;
+                *optlen = sizeof(uint64_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(SO_MAX_PACING_RATE) */
+            break;
+        case CLARINET_SO_TXTIME:
+            #if defined(CLARINET_SOCKET_TXTIME)
+            if (*optlen >= sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                /* The system does not report whether transmit times are enabled, only the reference clock which is
+                 * CLOCK_REALTIME (0) by default and can only have been changed by enabling the option. */
+                struct sock_txtime txtime;
+                memset(&txtime, 0, sizeof(txtime));
+                len = sizeof(txtime);
+                if (getsockopt(sockfd, SOL_SOCKET, CLARINET_SOCKET_TXTIME, &txtime, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                if (len != sizeof(txtime)) /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(int32_t*)optval = (int32_t)(txtime.clockid == CLARINET_SOCKET_TXTIME_CLOCK ? 1 : 0);
+                *optlen = sizeof(int32_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(CLARINET_SOCKET_TXTIME) */
+            break;
         case CLARINET_IP_V6ONLY:
             #if CLARINET_ENABLE_IPV6
             if (*optlen >= sizeof(int32_t))
@@ -1145,6 +2447,137 @@ clarinet_socket_getopt(clarinet_socket* restrict sp,
                 return CLARINET_ENONE;
             }
             break;
+        case CLARINET_IP_MCAST_TTL:
+            if (*optlen >= sizeof(uint32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    unsigned char ttl = 0;
+                    len = sizeof(ttl);
+                    if (getsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, &len) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    if (len != sizeof(ttl)) /* sanity check */
+                        return CLARINET_ESYS;
+
+                    *(uint32_t*)optval = (uint32_t)ttl;
+                    *optlen = sizeof(uint32_t);
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    len = sizeof(val);
+                    if (getsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &val, &len) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    if (len != sizeof(val)) /* sanity check */
+                        return CLARINET_ESYS;
+
+                    *(uint32_t*)optval = (uint32_t)val;
+                    *optlen = sizeof(uint32_t);
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_IP_MCAST_LOOP:
+            if (*optlen >= sizeof(uint32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                const int family = sp->family;
+                if (family == CLARINET_AF_INET)
+                {
+                    unsigned char loop = 0;
+                    len = sizeof(loop);
+                    if (getsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, &len) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    if (len != sizeof(loop)) /* sanity check */
+                        return CLARINET_ESYS;
+
+                    *(uint32_t*)optval = loop ? 1 : 0;
+                    *optlen = sizeof(uint32_t);
+
+                    return CLARINET_ENONE;
+                }
+
+                #if CLARINET_ENABLE_IPV6
+                if (family == CLARINET_AF_INET6)
+                {
+                    unsigned int loop = 0;
+                    len = sizeof(loop);
+                    if (getsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, &len) == SOCKET_ERROR)
+                        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                    if (len != sizeof(loop)) /* sanity check */
+                        return CLARINET_ESYS;
+
+                    *(uint32_t*)optval = loop ? 1 : 0;
+                    *optlen = sizeof(uint32_t);
+
+                    return CLARINET_ENONE;
+                }
+                #endif /* CLARINET_ENABLE_IPV6 */
+            }
+            break;
+        case CLARINET_UDP_SEGMENT:
+            #if defined(__linux__) && defined(UDP_SEGMENT)
+            if (*optlen >= sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                if (getsockopt(sockfd, SOL_UDP, UDP_SEGMENT, &val, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                if (len != sizeof(val)) /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(int32_t*)optval = (int32_t)val;
+                *optlen = sizeof(int32_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(UDP_SEGMENT) */
+            break;
+        case CLARINET_UDP_GRO:
+            #if defined(__linux__) && defined(UDP_GRO)
+            if (*optlen >= sizeof(int32_t))
+            {
+                int val = 0;
+                socklen_t len = sizeof(val);
+
+                CLARINET_SOCKET_CHECK_TYPE(sockfd, val, len, SOCK_DGRAM);
+
+                if (getsockopt(sockfd, SOL_UDP, UDP_GRO, &val, &len) == SOCKET_ERROR)
+                    return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+                if (len != sizeof(val)) /* sanity check */
+                    return CLARINET_ESYS;
+
+                *(int32_t*)optval = (int32_t)val;
+                *optlen = sizeof(int32_t);
+
+                return CLARINET_ENONE;
+            }
+            #endif /* defined(__linux__) && defined(UDP_GRO) */
+            break;
         default:
             break;
     }
@@ -1292,8 +2725,8 @@ clarinet_socket_poll_context_getstatus(const void* restrict context,
     if (!context || index >= INT_MAX || !status)
         return CLARINET_EINVAL;
 
-    const struct pollfd* pfd = (struct pollfd*)context;
-    *status = (uint16_t)pfd[index].revents;
+    const struct pollfd* pfd = (const struct pollfd*)context;
+    *status = poll_events_from_native(pfd[index].revents);
 
     return CLARINET_ENONE;
 }
@@ -1307,9 +2740,39 @@ clarinet_socket_poll(void* restrict context,
     if (!context || !targets || count == 0 || count > INT_MAX)
         return CLARINET_EINVAL;
 
-    if (poll((struct pollfd*)context, (nfds_t)count, timeout) == SOCKET_ERROR)
+    struct pollfd* pfd = (struct pollfd*)context;
+
+    /* Targets without a valid socket are ignored by poll(2) (negative descriptor) and reported invalid afterwards. */
+    size_t invalid = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const clarinet_socket* sp = targets[i].socket;
+        if (sp && sp->family != CLARINET_AF_UNSPEC && clarinet_socket_handle_is_valid(sp))
+        {
+            pfd[i].fd = clarinet_socket_handle(sp);
+            pfd[i].events = poll_events_to_native(targets[i].events);
+        }
+        else
+        {
+            pfd[i].fd = -1;
+            pfd[i].events = 0;
+            invalid++;
+        }
+        pfd[i].revents = 0;
+    }
+
+    if (poll(pfd, (nfds_t)count, timeout) == SOCKET_ERROR)
         return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
+    for (size_t i = 0; invalid > 0 && i < count; ++i)
+    {
+        if (pfd[i].fd < 0)
+        {
+            pfd[i].revents = POLLNVAL;
+            invalid--;
+        }
+    }
+
     return CLARINET_ENONE;
 }
 
@@ -0,0 +1,1256 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/addr.h"
+#include "compat/error.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#if CLARINET_ENABLE_URING
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+/* region Helpers */
+
+/**
+ * Returns true (non-zero) if the handle of the ring/socket pointed to by @p p is valid. All negative descriptors are
+ * invalid and values 0, 1 and 2 are reserved for stdin, stdout and stderr respectively so valid descriptors start at 3.
+ */
+#define clarinet_handle_is_valid(p)     ((p)->handle > 2)
+
+#if CLARINET_ENABLE_URING
+
+/* Older C libraries may not define the io_uring system call numbers. These are the same on every architecture except
+ * alpha. */
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup             425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter             426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register          427
+#endif
+
+/** Maximum number of submission entries accepted by clarinet_uring_open() */
+#define URING_ENTRIES_MAX               4096
+
+/** User data of internal operations whose completions are discarded */
+#define URING_IGNORE                    UINT64_MAX
+
+/** Marks the end of the list of free slots */
+#define URING_SLOT_NONE                 UINT32_MAX
+
+/* Set by the system when completions could not be posted because the completion queue was full (Linux 5.8) */
+#ifndef IORING_SQ_CQ_OVERFLOW
+#define IORING_SQ_CQ_OVERFLOW           (1U << 1)
+#endif
+
+/* Multishot receive operations (Linux 6.0) and cancellation by descriptor (Linux 5.19) depend on newer kernel headers */
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_ASYNC_CANCEL_FD)
+#define URING_MULTISHOT                 1
+#endif
+
+/**
+ * State of an operation in-flight. Every operation gets a slot identified by its index which is also used as the
+ * user_data of the corresponding submission entry. Slots hold everything the system may access after an operation is
+ * queued so that callers do not have to keep message headers and socket addresses alive.
+ */
+struct uring_slot
+{
+    struct msghdr msg;
+    struct iovec iov;
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    void* data;
+    clarinet_endpoint* remote;
+    clarinet_socket* csp;
+    uint32_t next;
+    uint16_t family;
+    uint16_t group;             /* buffer group of a multishot operation */
+    uint8_t opcode;             /* IORING_OP_NOP is never used so zero indicates a free slot */
+    uint8_t multishot;
+};
+
+#if URING_MULTISHOT
+/**
+ * Group of provided buffers. The ring tail is only written by us so it is also the source of truth. The ownership map
+ * follows the buffer ring in the same mapping and has one bit per buffer that is set while the buffer is held by the
+ * caller.
+ */
+struct uring_group
+{
+    struct io_uring_buf_ring* br;   /* NULL if the group is not registered */
+    uint8_t* base;
+    uint8_t* owned;
+    size_t size;
+    uint32_t bufsize;
+    uint16_t count;
+};
+#endif
+
+struct uring_context
+{
+    /* Submission queue */
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_flags;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    struct io_uring_sqe* sqes;
+
+    /* Completion queue */
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+
+    /* Mappings */
+    void* sq_ring;
+    void* cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    size_t size;
+
+    #if URING_MULTISHOT
+    /* Provided buffers */
+    struct uring_group groups[CLARINET_URING_GROUPS_MAX];
+    #endif
+
+    /* Operations */
+    unsigned pending;           /* queued but not submitted yet */
+    unsigned inflight;          /* slots in use */
+    uint32_t free;
+    struct uring_slot slots[];
+};
+
+CLARINET_STATIC_INLINE
+int
+uring_setup(unsigned entries,
+            struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+CLARINET_STATIC_INLINE
+int
+uring_enter(int fd,
+            unsigned to_submit,
+            unsigned min_complete,
+            unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+CLARINET_STATIC_INLINE
+int
+uring_register(int fd,
+               unsigned opcode,
+               void* arg,
+               unsigned nargs)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nargs);
+}
+
+/**
+ * Helper to check that the running kernel supports every operation used. IORING_REGISTER_PROBE is only available since
+ * Linux 5.6 which is also when IORING_OP_SEND and IORING_OP_RECV were introduced so older kernels fail the probe.
+ */
+static
+int
+uring_probe(int fd)
+{
+    static const uint8_t required[] = {
+        IORING_OP_SENDMSG,
+        IORING_OP_RECVMSG,
+        IORING_OP_ACCEPT,
+        IORING_OP_ASYNC_CANCEL,
+        IORING_OP_CONNECT,
+        IORING_OP_SEND,
+        IORING_OP_RECV
+    };
+
+    /* struct io_uring_probe ends in a flexible array so reserve storage for the maximum number of operations */
+    union
+    {
+        struct io_uring_probe probe;
+        uint8_t storage[sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op)];
+    } u;
+    memset(&u, 0, sizeof(u));
+
+    if (uring_register(fd, IORING_REGISTER_PROBE, &u.probe, 256) == SOCKET_ERROR)
+        return CLARINET_ENOTSUP;
+
+    for (size_t i = 0; i < sizeof(required) / sizeof(required[0]); ++i)
+    {
+        const uint8_t op = required[i];
+        if (op >= u.probe.ops_len || !(u.probe.ops[op].flags & IO_URING_OP_SUPPORTED))
+            return CLARINET_ENOTSUP;
+    }
+
+    return CLARINET_ENONE;
+}
+
+/** Helper to release the ring mappings of a context. */
+static
+void
+uring_unmap(struct uring_context* ctx)
+{
+    if (ctx->sqes)
+        munmap(ctx->sqes, ctx->sqes_size);
+
+    if (ctx->cq_ring && ctx->cq_ring != ctx->sq_ring)
+        munmap(ctx->cq_ring, ctx->cq_ring_size);
+
+    if (ctx->sq_ring)
+        munmap(ctx->sq_ring, ctx->sq_ring_size);
+}
+
+/** Helper to map the submission and completion queues of a ring into the context. */
+static
+int
+uring_map(struct uring_context* ctx,
+          int fd,
+          const struct io_uring_params* params)
+{
+    ctx->sq_ring_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+    ctx->cq_ring_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    ctx->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+
+    /* Since Linux 5.4 both queues can be mapped at once. */
+    const int single = (params->features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single)
+    {
+        ctx->sq_ring_size = max(ctx->sq_ring_size, ctx->cq_ring_size);
+        ctx->cq_ring_size = ctx->sq_ring_size;
+    }
+
+    void* p = mmap(NULL, ctx->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (p == MAP_FAILED)
+        return CLARINET_ENOMEM;
+
+    ctx->sq_ring = p;
+
+    if (single)
+    {
+        ctx->cq_ring = ctx->sq_ring;
+    }
+    else
+    {
+        p = mmap(NULL, ctx->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (p == MAP_FAILED)
+        {
+            uring_unmap(ctx);
+            return CLARINET_ENOMEM;
+        }
+
+        ctx->cq_ring = p;
+    }
+
+    p = mmap(NULL, ctx->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (p == MAP_FAILED)
+    {
+        uring_unmap(ctx);
+        return CLARINET_ENOMEM;
+    }
+
+    ctx->sqes = p;
+
+    uint8_t* sq = ctx->sq_ring;
+    ctx->sq_head = (unsigned*)(sq + params->sq_off.head);
+    ctx->sq_tail = (unsigned*)(sq + params->sq_off.tail);
+    ctx->sq_flags = (unsigned*)(sq + params->sq_off.flags);
+    ctx->sq_array = (unsigned*)(sq + params->sq_off.array);
+    ctx->sq_mask = *(unsigned*)(sq + params->sq_off.ring_mask);
+    ctx->sq_entries = *(unsigned*)(sq + params->sq_off.ring_entries);
+
+    uint8_t* cq = ctx->cq_ring;
+    ctx->cq_head = (unsigned*)(cq + params->cq_off.head);
+    ctx->cq_tail = (unsigned*)(cq + params->cq_off.tail);
+    ctx->cq_mask = *(unsigned*)(cq + params->cq_off.ring_mask);
+    ctx->cqes = (struct io_uring_cqe*)(cq + params->cq_off.cqes);
+
+    return CLARINET_ENONE;
+}
+
+/**
+ * Helper to move completions that overflowed the completion queue into it. The system keeps completions it could not
+ * post in a backlog and only moves them when the ring is entered to get events with room in the queue.
+ */
+CLARINET_STATIC_INLINE
+void
+uring_flush(struct uring_context* ctx,
+            int fd)
+{
+    if (__atomic_load_n(ctx->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW)
+        uring_enter(fd, 0, 0, IORING_ENTER_GETEVENTS);
+}
+
+/** Helper to submit all queued operations. Returns the number of operations submitted or a negative error code. */
+static
+int
+uring_submit(struct uring_context* ctx,
+             int fd)
+{
+    int total = 0;
+    int flushed = 0;
+    while (ctx->pending > 0)
+    {
+        const int n = uring_enter(fd, ctx->pending, 0, 0);
+        if (n < 0)
+        {
+            const int err = clarinet_get_sockapi_error();
+
+            /* Older kernels refuse new operations while completions are in the overflow backlog. Flushing only helps if
+             * the completion queue has room, otherwise the caller has to reap completions first. */
+            if (err == EBUSY && !flushed)
+            {
+                flushed = 1;
+                uring_enter(fd, 0, 0, IORING_ENTER_GETEVENTS);
+                continue;
+            }
+
+            if (total > 0)
+                break;
+
+            return (err == EBUSY) ? CLARINET_EAGAIN : clarinet_error_from_sockapi_error(err);
+        }
+
+        if (n == 0)
+            break;
+
+        ctx->pending -= (unsigned)n;
+        total += n;
+    }
+
+    return total;
+}
+
+/**
+ * Helper to make sure a submission entry is available. The submission queue is only consumed by the system when the
+ * ring is entered so pending operations are submitted if the queue is full.
+ */
+static
+int
+uring_reserve(struct uring_context* ctx,
+              int fd)
+{
+    if (*ctx->sq_tail - __atomic_load_n(ctx->sq_head, __ATOMIC_ACQUIRE) < ctx->sq_entries)
+        return CLARINET_ENONE;
+
+    const int errcode = uring_submit(ctx, fd);
+    if (errcode < 0)
+        return errcode;
+
+    if (*ctx->sq_tail - __atomic_load_n(ctx->sq_head, __ATOMIC_ACQUIRE) >= ctx->sq_entries)
+        return CLARINET_ENOBUFS;
+
+    return CLARINET_ENONE;
+}
+
+/** Helper to get the next submission entry cleared. Only valid after a successful uring_reserve(). */
+CLARINET_STATIC_INLINE
+struct io_uring_sqe*
+uring_sqe(struct uring_context* ctx,
+          uint8_t opcode,
+          int fd,
+          uint64_t user_data)
+{
+    struct io_uring_sqe* sqe = &ctx->sqes[*ctx->sq_tail & ctx->sq_mask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = user_data;
+    return sqe;
+}
+
+/** Helper to reserve a slot and a submission entry for a new operation. */
+static
+int
+uring_acquire(struct uring_context* ctx,
+              int fd,
+              uint8_t opcode,
+              int sockfd,
+              void* data,
+              struct uring_slot** slotp,
+              struct io_uring_sqe** sqep)
+{
+    if (ctx->free == URING_SLOT_NONE)
+        return CLARINET_ENOBUFS;
+
+    const int errcode = uring_reserve(ctx, fd);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    const uint32_t index = ctx->free;
+    struct uring_slot* slot = &ctx->slots[index];
+    ctx->free = slot->next;
+    ctx->inflight++;
+
+    slot->opcode = opcode;
+    slot->multishot = 0;
+    slot->data = data;
+    slot->remote = NULL;
+    slot->csp = NULL;
+
+    struct io_uring_sqe* sqe = uring_sqe(ctx, opcode, sockfd, index);
+
+    *slotp = slot;
+    *sqep = sqe;
+    return CLARINET_ENONE;
+}
+
+/** Helper to publish the submission entry last acquired so it is picked up by the next submission. */
+CLARINET_STATIC_INLINE
+void
+uring_commit(struct uring_context* ctx)
+{
+    const unsigned tail = *ctx->sq_tail;
+    const unsigned index = tail & ctx->sq_mask;
+    ctx->sq_array[index] = index;
+    __atomic_store_n(ctx->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ctx->pending++;
+}
+
+/** Helper to return a slot to the list of free slots. */
+CLARINET_STATIC_INLINE
+void
+uring_release(struct uring_context* ctx,
+              uint32_t index)
+{
+    struct uring_slot* slot = &ctx->slots[index];
+    slot->opcode = IORING_OP_NOP;
+    slot->next = ctx->free;
+    ctx->free = index;
+    ctx->inflight--;
+}
+
+/** Helper to translate the error of a completion entry. */
+CLARINET_STATIC_INLINE
+int
+uring_error(const struct uring_slot* slot,
+            int res)
+{
+    /* Operations cancelled by clarinet_uring_cancel() */
+    if (res == -ECANCELED)
+        return CLARINET_EINTR;
+
+    /* See clarinet_socket_accept() */
+    if (slot->opcode == IORING_OP_ACCEPT && res == -EOPNOTSUPP)
+        return CLARINET_EPROTONOSUPPORT;
+
+    return clarinet_error_from_sockapi_error(-res);
+}
+
+/**
+ * Helper to translate the result of a completion entry into the result of the equivalent socket function. The remote
+ * endpoint of a receive operation is always decoded first so it remains valid even when the datagram is reported
+ * truncated.
+ */
+static
+int
+uring_result(struct uring_slot* slot,
+             int res)
+{
+    if (res < 0)
+        return uring_error(slot, res);
+
+    switch (slot->opcode) // NOLINT(hicpp-multiway-paths-covered)
+    {
+        case IORING_OP_RECVMSG:
+        {
+            /* Sanity: improbable but possible if the system disagrees on the size of the sockaddr */
+            if (slot->msg.msg_namelen > sizeof(struct sockaddr_storage))
+                return CLARINET_EADDRNOTAVAIL;
+
+            if (clarinet_endpoint_from_sockaddr(slot->remote, &slot->ss) != CLARINET_ENONE)
+                return CLARINET_EADDRNOTAVAIL;
+
+            if ((slot->msg.msg_flags & MSG_TRUNC) || (size_t)res > slot->iov.iov_len)
+                return CLARINET_EMSGSIZE;
+
+            return res;
+        }
+        case IORING_OP_ACCEPT:
+        {
+            slot->csp->family = slot->family;
+            slot->csp->handle = res;
+            if (clarinet_endpoint_from_sockaddr(slot->remote, &slot->ss) != CLARINET_ENONE)
+            {
+                memset(slot->remote, 0, sizeof(clarinet_endpoint));
+                return CLARINET_EADDRNOTAVAIL;
+            }
+
+            return CLARINET_ENONE;
+        }
+        case IORING_OP_CONNECT:
+            return CLARINET_ENONE;
+        default:
+            return res;
+    }
+}
+
+#if URING_MULTISHOT
+
+/**
+ * Space reserved for the source address in a provided buffer. A multishot receive stores a struct io_uring_recvmsg_out
+ * followed by the source address at the start of the buffer so the data always begins at
+ * CLARINET_URING_BUFFER_OVERHEAD.
+ */
+#define URING_NAMELEN   (CLARINET_URING_BUFFER_OVERHEAD - sizeof(struct io_uring_recvmsg_out))
+
+/** Helper to make a provided buffer available to the system. */
+CLARINET_STATIC_INLINE
+void
+uring_group_push(struct uring_group* g,
+                 uint16_t buffer)
+{
+    const uint16_t tail = g->br->tail;
+    struct io_uring_buf* b = &g->br->bufs[tail & (g->count - 1)];
+    b->addr = (uint64_t)(uintptr_t)(g->base + (size_t)buffer * g->bufsize);
+    b->len = g->bufsize;
+    b->bid = buffer;
+    __atomic_store_n(&g->br->tail, (uint16_t)(tail + 1), __ATOMIC_RELEASE);
+}
+
+/** Helper to translate a completion entry of a multishot receive. */
+static
+void
+uring_result_multishot(struct uring_context* ctx,
+                       const struct uring_slot* slot,
+                       const struct io_uring_cqe* cqe,
+                       clarinet_uring_completion* completion)
+{
+    if (cqe->flags & IORING_CQE_F_MORE)
+        completion->flags |= CLARINET_URING_COMPLETION_MORE;
+
+    if (!(cqe->flags & IORING_CQE_F_BUFFER))
+    {
+        completion->result = (cqe->res < 0) ? uring_error(slot, cqe->res) : cqe->res;
+        return;
+    }
+
+    struct uring_group* g = &ctx->groups[slot->group];
+    const uint16_t buffer = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+    uint8_t* p = g->base + (size_t)buffer * g->bufsize;
+    g->owned[buffer >> 3] |= (uint8_t)(1u << (buffer & 7));
+
+    completion->flags |= CLARINET_URING_COMPLETION_BUFFER;
+    completion->buffer = buffer;
+    completion->buf = p + CLARINET_URING_BUFFER_OVERHEAD;
+
+    if (cqe->res < 0)
+    {
+        completion->result = uring_error(slot, cqe->res);
+        return;
+    }
+
+    /* Buffers are not necessarily aligned so the metadata is copied out before it is accessed */
+    struct io_uring_recvmsg_out out;
+    memcpy(&out, p, sizeof(out));
+
+    struct sockaddr_storage ss;
+    memset(&ss, 0, sizeof(ss));
+    if (out.namelen > URING_NAMELEN)
+    {
+        completion->result = CLARINET_EADDRNOTAVAIL;
+        return;
+    }
+
+    memcpy(&ss, p + sizeof(out), out.namelen);
+    if (clarinet_endpoint_from_sockaddr(&completion->remote, &ss) != CLARINET_ENONE)
+        completion->result = CLARINET_EADDRNOTAVAIL;
+    else if (out.flags & MSG_TRUNC)
+        completion->result = CLARINET_EMSGSIZE;
+    else
+        completion->result = (int)out.payloadlen;
+}
+
+/** Helper to unregister every group of provided buffers. */
+static
+void
+uring_ungroup(struct uring_context* ctx,
+              int fd)
+{
+    for (uint16_t i = 0; i < CLARINET_URING_GROUPS_MAX; ++i)
+    {
+        struct uring_group* g = &ctx->groups[i];
+        if (!g->br)
+            continue;
+
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.bgid = i;
+        uring_register(fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        munmap(g->br, g->size);
+        memset(g, 0, sizeof(struct uring_group));
+    }
+}
+
+#endif /* URING_MULTISHOT */
+
+/** Helper to reap up to @p count completions. */
+static
+size_t
+uring_reap(struct uring_context* ctx,
+           clarinet_uring_completion* restrict completions,
+           size_t count)
+{
+    unsigned head = *ctx->cq_head;
+    const unsigned tail = __atomic_load_n(ctx->cq_tail, __ATOMIC_ACQUIRE);
+
+    size_t n = 0;
+    while (head != tail && n < count)
+    {
+        const struct io_uring_cqe* cqe = &ctx->cqes[head & ctx->cq_mask];
+        head++;
+
+        if (cqe->user_data == URING_IGNORE)
+            continue;
+
+        const uint32_t index = (uint32_t)cqe->user_data;
+        struct uring_slot* slot = &ctx->slots[index];
+        clarinet_uring_completion* completion = &completions[n];
+        completion->data = slot->data;
+        completion->flags = CLARINET_URING_COMPLETION_NONE;
+        completion->buffer = 0;
+        completion->buf = NULL;
+
+        #if URING_MULTISHOT
+        if (slot->multishot)
+            uring_result_multishot(ctx, slot, cqe, completion);
+        else
+            completion->result = uring_result(slot, cqe->res);
+        #else
+        completion->result = uring_result(slot, cqe->res);
+        #endif
+
+        /* A multishot operation only releases its slot with the last completion */
+        if (!(completion->flags & CLARINET_URING_COMPLETION_MORE))
+            uring_release(ctx, index);
+
+        n++;
+    }
+
+    __atomic_store_n(ctx->cq_head, head, __ATOMIC_RELEASE);
+    return n;
+}
+
+/**
+ * Helper to cancel every operation in-flight and wait until the system releases them. Completions are discarded but
+ * sockets accepted in the meantime must be closed or they would leak.
+ */
+static
+void
+uring_drain(struct uring_context* ctx,
+            int fd)
+{
+    const uint32_t capacity = (uint32_t)((ctx->size - sizeof(struct uring_context)) / sizeof(struct uring_slot));
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        if (ctx->slots[i].opcode == IORING_OP_NOP)
+            continue;
+
+        if (uring_reserve(ctx, fd) != CLARINET_ENONE)
+            return;
+
+        struct io_uring_sqe* sqe = uring_sqe(ctx, IORING_OP_ASYNC_CANCEL, -1, URING_IGNORE);
+        sqe->addr = i;
+        uring_commit(ctx);
+    }
+
+    while (ctx->inflight > 0)
+    {
+        const int n = uring_enter(fd, ctx->pending, 1, IORING_ENTER_GETEVENTS);
+        if (n < 0)
+        {
+            if (clarinet_get_sockapi_error() == EINTR)
+                continue;
+
+            return;
+        }
+
+        ctx->pending -= (unsigned)n;
+
+        unsigned head = *ctx->cq_head;
+        const unsigned tail = __atomic_load_n(ctx->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            const struct io_uring_cqe* cqe = &ctx->cqes[head & ctx->cq_mask];
+            head++;
+
+            if (cqe->user_data == URING_IGNORE)
+                continue;
+
+            #if URING_MULTISHOT
+            if (cqe->flags & IORING_CQE_F_MORE)
+                continue;
+            #endif
+
+            const uint32_t index = (uint32_t)cqe->user_data;
+            if (ctx->slots[index].opcode == IORING_OP_ACCEPT && cqe->res >= 0)
+                close(cqe->res);
+
+            uring_release(ctx, index);
+        }
+
+        __atomic_store_n(ctx->cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+#endif /* CLARINET_ENABLE_URING */
+
+/* endregion */
+
+/* region Completion Ring */
+
+void
+clarinet_uring_init(clarinet_uring* ur)
+{
+    memset(ur, 0, sizeof(clarinet_uring));
+}
+
+int
+clarinet_uring_open(clarinet_uring* ur,
+                    uint32_t entries)
+{
+    if (!ur || clarinet_handle_is_valid(ur) || entries == 0)
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    if (entries > URING_ENTRIES_MAX)
+        return CLARINET_EINVAL;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    const int fd = uring_setup(entries, &params);
+    if (fd == SOCKET_ERROR)
+    {
+        const int err = clarinet_get_sockapi_error();
+        /* ENOSYS: the kernel was built without io_uring; EPERM: io_uring was disabled by the administrator
+         * (kernel.io_uring_disabled) or a seccomp filter. Either way the caller must fall back. */
+        return (err == ENOSYS || err == EPERM) ? CLARINET_ENOTSUP : clarinet_error_from_sockapi_error(err);
+    }
+
+    int errcode = uring_probe(fd);
+    if (errcode != CLARINET_ENONE)
+    {
+        close(fd);
+        return errcode;
+    }
+
+    /* The library does not allocate from the heap so the context is kept in an anonymous mapping. There is one slot
+     * per completion entry which bounds the number of operations in-flight. A multishot receive may still post any
+     * number of completions so the completion queue can overflow in which case the system keeps the excess in a
+     * backlog that is flushed by uring_flush() and uring_submit(). */
+    const size_t size = sizeof(struct uring_context) + params.cq_entries * sizeof(struct uring_slot);
+    struct uring_context* ctx = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ctx == MAP_FAILED)
+    {
+        close(fd);
+        return CLARINET_ENOMEM;
+    }
+
+    ctx->size = size;
+    errcode = uring_map(ctx, fd, &params);
+    if (errcode != CLARINET_ENONE)
+    {
+        munmap(ctx, size);
+        close(fd);
+        return errcode;
+    }
+
+    for (uint32_t i = 0; i < params.cq_entries; ++i)
+        ctx->slots[i].next = i + 1;
+
+    ctx->slots[params.cq_entries - 1].next = URING_SLOT_NONE;
+    ctx->free = 0;
+
+    ur->handle = fd;
+    ur->context = ctx;
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_close(clarinet_uring* ur)
+{
+    if (!ur || !clarinet_handle_is_valid(ur))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    uring_drain(ctx, ur->handle);
+    #if URING_MULTISHOT
+    uring_ungroup(ctx, ur->handle);
+    #endif
+    uring_unmap(ctx);
+    munmap(ctx, ctx->size);
+    #endif
+
+    if (close(ur->handle) == SOCKET_ERROR)
+        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+    clarinet_uring_init(ur);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_uring_recv(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    void* restrict buf,
+                    size_t buflen,
+                    void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    const int errcode = uring_acquire(ctx, ur->handle, IORING_OP_RECV, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)buflen;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_recvfrom(clarinet_uring* restrict ur,
+                        clarinet_socket* restrict sp,
+                        void* restrict buf,
+                        size_t buflen,
+                        clarinet_endpoint* restrict remote,
+                        void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    const int errcode = uring_acquire(ctx, ur->handle, IORING_OP_RECVMSG, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    slot->remote = remote;
+    slot->iov.iov_base = buf;
+    slot->iov.iov_len = buflen;
+    memset(&slot->msg, 0, sizeof(struct msghdr));
+    slot->msg.msg_name = &slot->ss;
+    slot->msg.msg_namelen = sizeof(struct sockaddr_storage);
+    slot->msg.msg_iov = &slot->iov;
+    slot->msg.msg_iovlen = 1;
+
+    sqe->addr = (uint64_t)(uintptr_t)&slot->msg;
+    sqe->len = 1;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_send(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    const void* restrict buf,
+                    size_t buflen,
+                    void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    const int errcode = uring_acquire(ctx, ur->handle, IORING_OP_SEND, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)buflen;
+    /* See clarinet_socket_send() */
+    sqe->msg_flags = MSG_NOSIGNAL;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_sendto(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp,
+                      const void* restrict buf,
+                      size_t buflen,
+                      const clarinet_endpoint* restrict remote,
+                      void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    errcode = uring_acquire(ctx, ur->handle, IORING_OP_SENDMSG, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    memcpy(&slot->ss, &ss, sslen);
+    slot->iov.iov_base = (void*)buf;
+    slot->iov.iov_len = buflen;
+    memset(&slot->msg, 0, sizeof(struct msghdr));
+    slot->msg.msg_name = &slot->ss;
+    slot->msg.msg_namelen = sslen;
+    slot->msg.msg_iov = &slot->iov;
+    slot->msg.msg_iovlen = 1;
+
+    sqe->addr = (uint64_t)(uintptr_t)&slot->msg;
+    sqe->len = 1;
+    /* See clarinet_socket_sendto() */
+    sqe->msg_flags = MSG_NOSIGNAL;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_accept(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict ssp,
+                      clarinet_socket* restrict csp,
+                      clarinet_endpoint* restrict remote,
+                      void* data)
+{
+    if (!ur || !ssp || ssp->family == CLARINET_AF_UNSPEC || !csp || csp->family != CLARINET_AF_UNSPEC || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(ssp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    const int errcode = uring_acquire(ctx, ur->handle, IORING_OP_ACCEPT, ssp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    slot->family = ssp->family;
+    slot->csp = csp;
+    slot->remote = remote;
+    slot->sslen = sizeof(struct sockaddr_storage);
+
+    sqe->addr = (uint64_t)(uintptr_t)&slot->ss;
+    sqe->addr2 = (uint64_t)(uintptr_t)&slot->sslen;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_connect(clarinet_uring* restrict ur,
+                       clarinet_socket* restrict sp,
+                       const clarinet_endpoint* restrict remote,
+                       void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    struct uring_context* ctx = ur->context;
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    errcode = uring_acquire(ctx, ur->handle, IORING_OP_CONNECT, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    memcpy(&slot->ss, &ss, sslen);
+
+    sqe->addr = (uint64_t)(uintptr_t)&slot->ss;
+    /* IORING_OP_CONNECT takes the address length in the offset field */
+    sqe->off = sslen;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_provide(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       void* restrict buf,
+                       size_t bufsize,
+                       uint16_t count)
+{
+    if (!ur || group >= CLARINET_URING_GROUPS_MAX || !buf || bufsize <= CLARINET_URING_BUFFER_OVERHEAD)
+        return CLARINET_EINVAL;
+
+    if (bufsize > UINT32_MAX || count == 0 || count > 32768 || (count & (count - 1)) != 0)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur))
+        return CLARINET_EINVAL;
+
+    #if URING_MULTISHOT
+    struct uring_context* ctx = ur->context;
+    struct uring_group* g = &ctx->groups[group];
+    if (g->br)
+        return CLARINET_EALREADY;
+
+    /* The buffer ring must be page aligned so it gets its own anonymous mapping followed by the ownership map */
+    const size_t size = count * sizeof(struct io_uring_buf) + (count + 7u) / 8u;
+    struct io_uring_buf_ring* br = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br == MAP_FAILED)
+        return CLARINET_ENOMEM;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)br;
+    reg.ring_entries = count;
+    reg.bgid = group;
+
+    if (uring_register(ur->handle, IORING_REGISTER_PBUF_RING, &reg, 1) == SOCKET_ERROR)
+    {
+        const int err = clarinet_get_sockapi_error();
+        munmap(br, size);
+        /* Arguments are known to be valid so EINVAL means the kernel does not support buffer rings (before 5.19) */
+        return (err == EINVAL) ? CLARINET_ENOTSUP : clarinet_error_from_sockapi_error(err);
+    }
+
+    g->br = br;
+    g->base = buf;
+    g->owned = (uint8_t*)br + count * sizeof(struct io_uring_buf);
+    g->size = size;
+    g->bufsize = (uint32_t)bufsize;
+    g->count = count;
+
+    for (uint32_t i = 0; i < count; ++i)
+        uring_group_push(g, (uint16_t)i);
+
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_release(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       uint16_t buffer)
+{
+    if (!ur || group >= CLARINET_URING_GROUPS_MAX || !clarinet_handle_is_valid(ur))
+        return CLARINET_EINVAL;
+
+    #if URING_MULTISHOT
+    struct uring_context* ctx = ur->context;
+    struct uring_group* g = &ctx->groups[group];
+    if (!g->br || buffer >= g->count)
+        return CLARINET_EINVAL;
+
+    /* Pushing a buffer the system already owns would corrupt the buffer ring */
+    const uint8_t bit = (uint8_t)(1u << (buffer & 7));
+    if (!(g->owned[buffer >> 3] & bit))
+        return CLARINET_EINVAL;
+
+    g->owned[buffer >> 3] &= (uint8_t)~bit;
+    uring_group_push(g, buffer);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(buffer);
+    return CLARINET_EINVAL;
+    #endif
+}
+
+int
+clarinet_uring_recvfrom_multishot(clarinet_uring* restrict ur,
+                                  clarinet_socket* restrict sp,
+                                  uint16_t group,
+                                  void* data)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC || group >= CLARINET_URING_GROUPS_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if URING_MULTISHOT
+    struct uring_context* ctx = ur->context;
+    if (!ctx->groups[group].br)
+        return CLARINET_EINVAL;
+
+    struct uring_slot* slot;
+    struct io_uring_sqe* sqe;
+    const int errcode = uring_acquire(ctx, ur->handle, IORING_OP_RECVMSG, sp->handle, data, &slot, &sqe);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    slot->multishot = 1;
+    slot->group = group;
+    /* The message header is only used by the system to determine the layout of the provided buffers */
+    memset(&slot->msg, 0, sizeof(struct msghdr));
+    slot->msg.msg_namelen = URING_NAMELEN;
+
+    sqe->addr = (uint64_t)(uintptr_t)&slot->msg;
+    sqe->len = 1;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = group;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_cancel(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp)
+{
+    if (!ur || !sp || sp->family == CLARINET_AF_UNSPEC)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur) || !clarinet_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    #if URING_MULTISHOT
+    struct uring_context* ctx = ur->context;
+    const int errcode = uring_reserve(ctx, ur->handle);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    struct io_uring_sqe* sqe = uring_sqe(ctx, IORING_OP_ASYNC_CANCEL, sp->handle, URING_IGNORE);
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    uring_commit(ctx);
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_submit(clarinet_uring* ur)
+{
+    if (!ur || !clarinet_handle_is_valid(ur))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    return uring_submit(ur->context, ur->handle);
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_uring_wait(clarinet_uring* restrict ur,
+                    clarinet_uring_completion* restrict completions,
+                    size_t count,
+                    int timeout)
+{
+    if (!ur || !completions || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_handle_is_valid(ur))
+        return CLARINET_EINVAL;
+
+    #if CLARINET_ENABLE_URING
+    struct uring_context* ctx = ur->context;
+    if (ctx->pending > 0)
+    {
+        /* A full completion queue is not an error here since reaping is what makes room for more */
+        const int errcode = uring_submit(ctx, ur->handle);
+        if (errcode < 0 && errcode != CLARINET_EAGAIN)
+            return errcode;
+    }
+
+    size_t n = uring_reap(ctx, completions, count);
+    if (n < count)
+    {
+        uring_flush(ctx, ur->handle);
+        n += uring_reap(ctx, completions + n, count - n);
+    }
+    if (n == 0 && timeout != 0 && ctx->inflight > 0)
+    {
+        /* The ring descriptor becomes readable when the completion queue is not empty. Polling it (instead of
+         * entering the ring with IORING_ENTER_GETEVENTS) supports a timeout on every kernel version. */
+        struct pollfd pfd;
+        pfd.fd = ur->handle;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, timeout) == SOCKET_ERROR)
+            return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+
+        n = uring_reap(ctx, completions, count);
+        if (n < count)
+        {
+            uring_flush(ctx, ur->handle);
+            n += uring_reap(ctx, completions + n, count - n);
+        }
+    }
+
+    return (int)n;
+    #else
+    CLARINET_IGNORE_PARAM(timeout);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/* endregion */
@@ -0,0 +1,53 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <timeapi.h>
+
+/* region Clock */
+
+/** Last value of timeGetTime in the low 32 bits and the number of times it wrapped around in the high 32 bits. */
+static volatile LONG64 clock_last;
+
+uint64_t
+clarinet_time_now(void)
+{
+    /* timeGetTime only has 32 bits so wrap arounds are counted whenever the value returned is less than the last one
+     * observed. The last value is swapped atomically so concurrent callers agree on the number of wrap arounds. */
+    LONG64 last = InterlockedCompareExchange64(&clock_last, 0, 0);
+    while (1)
+    {
+        const DWORD now = timeGetTime();
+        uint64_t wraps = (uint64_t)last >> 32;
+        if (now < (DWORD)(last & UINT32_MAX))
+            wraps++;
+
+        const LONG64 next = (LONG64)((wraps << 32) | now);
+        if (next == last)
+            return (uint64_t)next;
+
+        const LONG64 prev = InterlockedCompareExchange64(&clock_last, next, last);
+        if (prev == last)
+            return (uint64_t)next;
+
+        last = prev;
+    }
+}
+
+uint64_t
+clarinet_time_now_us(void)
+{
+    /* The frequency is fixed at boot so it is safe to cache. Concurrent callers may query it more than once. */
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    /* Split the conversion to avoid overflowing the product of the counter by one million */
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+    const uint64_t freq = (uint64_t)frequency.QuadPart;
+    return (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
+}
+
+/* endregion */
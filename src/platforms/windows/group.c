@@ -0,0 +1,51 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Socket Group */
+
+/* Windows accepts multiple sockets bound to the same endpoint with SO_REUSEADDR but delivers unicast datagrams to only
+ * one of them so there is no way to distribute datagrams among a group. */
+
+void
+clarinet_socket_group_init(clarinet_socket_group* group)
+{
+    memset(group, 0, sizeof(clarinet_socket_group));
+}
+
+int
+clarinet_socket_group_open(clarinet_socket_group* restrict group,
+                           clarinet_socket* restrict sockets,
+                           size_t count,
+                           const clarinet_endpoint* restrict local,
+                           uint32_t flags)
+{
+    static const uint32_t steering = CLARINET_SOCKET_GROUP_STEER_HASH | CLARINET_SOCKET_GROUP_STEER_CPU;
+
+    if (!group || group->sockets || !sockets || count == 0 || count > CLARINET_SOCKET_GROUP_MAX || !local)
+        return CLARINET_EINVAL;
+
+    if ((flags & ~steering) || (flags & steering) == steering)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_group_close(clarinet_socket_group* group)
+{
+    CLARINET_IGNORE_PARAM(group);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_socket_group_pin(const clarinet_socket_group* group,
+                          size_t shard)
+{
+    CLARINET_IGNORE_PARAM(group);
+    CLARINET_IGNORE_PARAM(shard);
+    return CLARINET_EINVAL;
+}
+
+/* endregion */
@@ -0,0 +1,118 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Interface */
+
+/* Interfaces are not supported on Windows. GetAdaptersAddresses() and NotifyIpInterfaceChange() are the closest
+ * equivalents but require linking with iphlpapi. A table can never be opened which means every other table function
+ * fails the validation of the table. */
+
+int
+clarinet_iface_getlist(clarinet_iface* restrict list,
+                       size_t* len)
+{
+    if (!list || !len)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_iface_getindex(const char* name,
+                        uint32_t* index)
+{
+    if (!name || !index)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_iface_getname(uint32_t index,
+                       char* name,
+                       size_t len)
+{
+    CLARINET_IGNORE_PARAM(index);
+    CLARINET_IGNORE_PARAM(len);
+
+    if (!name)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+void
+clarinet_iface_table_init(clarinet_iface_table* table)
+{
+    memset(table, 0, sizeof(clarinet_iface_table));
+}
+
+int
+clarinet_iface_table_open(clarinet_iface_table* restrict table,
+                          clarinet_iface_link* restrict links,
+                          uint32_t maxlinks,
+                          clarinet_iface* restrict addrs,
+                          uint32_t maxaddrs)
+{
+    if (!table || table->links || !links || maxlinks == 0 || !addrs || maxaddrs == 0)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_iface_table_close(clarinet_iface_table* table)
+{
+    CLARINET_IGNORE_PARAM(table);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_iface_table_update(clarinet_iface_table* restrict table,
+                            clarinet_iface_event* restrict events,
+                            size_t count)
+{
+    CLARINET_IGNORE_PARAM(table);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(count);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_iface_table_getlink(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             clarinet_iface_link* restrict link)
+{
+    CLARINET_IGNORE_PARAM(table);
+    CLARINET_IGNORE_PARAM(index);
+    CLARINET_IGNORE_PARAM(link);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_iface_table_getindex(const clarinet_iface_table* restrict table,
+                              const char* restrict name,
+                              uint32_t* restrict index)
+{
+    CLARINET_IGNORE_PARAM(table);
+    CLARINET_IGNORE_PARAM(name);
+    CLARINET_IGNORE_PARAM(index);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_iface_table_getaddr(const clarinet_iface_table* restrict table,
+                             uint32_t index,
+                             int family,
+                             clarinet_addr* restrict addr)
+{
+    CLARINET_IGNORE_PARAM(table);
+    CLARINET_IGNORE_PARAM(index);
+    CLARINET_IGNORE_PARAM(family);
+    CLARINET_IGNORE_PARAM(addr);
+    return CLARINET_EINVAL;
+}
+
+/* endregion */
@@ -0,0 +1,81 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Poller */
+
+/* Pollers are not supported on Windows so clarinet_socket_poll() is the only option. A poller can never be opened
+ * which means every other function fails the validation of the poller. */
+
+void
+clarinet_poller_init(clarinet_poller* pp)
+{
+    memset(pp, 0, sizeof(clarinet_poller));
+}
+
+int
+clarinet_poller_open(clarinet_poller* pp)
+{
+    if (!pp || pp->handle)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_poller_close(clarinet_poller* pp)
+{
+    CLARINET_IGNORE_PARAM(pp);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_poller_add(clarinet_poller* restrict pp,
+                    clarinet_socket* restrict sp,
+                    uint16_t events,
+                    void* data)
+{
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_poller_modify(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp,
+                       uint16_t events,
+                       void* data)
+{
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_poller_remove(clarinet_poller* restrict pp,
+                       clarinet_socket* restrict sp)
+{
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(sp);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_poller_wait(clarinet_poller* restrict pp,
+                     clarinet_poller_event* restrict events,
+                     size_t count,
+                     int timeout)
+{
+    CLARINET_IGNORE_PARAM(pp);
+    CLARINET_IGNORE_PARAM(events);
+    CLARINET_IGNORE_PARAM(count);
+    CLARINET_IGNORE_PARAM(timeout);
+    return CLARINET_EINVAL;
+}
+
+/* endregion */
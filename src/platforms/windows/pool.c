@@ -0,0 +1,300 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+/**
+ * The head of the free list packs the index of the first free slab plus one (so zero means empty) in the low 32 bits
+ * and a generation counter in the high 32 bits. The counter is incremented on every update so a thread that was
+ * preempted between reading the head and swapping it cannot succeed if the same slab was popped and pushed back in the
+ * meantime (ABA problem). Links hold the index of the next free slab plus one.
+ */
+#define POOL_HEAD_TOP(h)                ((uint32_t)((h) & UINT32_MAX))
+#define POOL_HEAD_TAG(h)                ((uint32_t)((h) >> 32))
+#define POOL_HEAD(tag, top)             (((uint64_t)(tag) << 32) | (uint64_t)(top))
+
+/** Returns true (non-zero) if the pool pointed to by @p p is open. */
+#define clarinet_packet_pool_is_open(p) ((p)->base != NULL)
+
+/** Helper to round up @p n to the next multiple of @p m which must be a power of 2. */
+CLARINET_STATIC_INLINE
+size_t
+pool_align(size_t n,
+           size_t m)
+{
+    return (n + (m - 1)) & ~(m - 1);
+}
+
+/** Helper to find the index of the slab at @p buf. Returns @c CLARINET_EINVAL if @p buf is not a slab of the pool. */
+CLARINET_STATIC_INLINE
+int
+pool_index(const clarinet_packet_pool* restrict pool,
+           const void* restrict buf,
+           uint32_t* restrict index)
+{
+    const uint8_t* p = (const uint8_t*)buf;
+    if (!p || p < pool->slabs)
+        return CLARINET_EINVAL;
+
+    const size_t offset = (size_t)(p - pool->slabs);
+    if (offset % pool->stride != 0 || offset / pool->stride >= pool->count)
+        return CLARINET_EINVAL;
+
+    *index = (uint32_t)(offset / pool->stride);
+    return CLARINET_ENONE;
+}
+
+/** Helper to push a chain of slabs already linked from @p first to @p last onto the free list. */
+CLARINET_STATIC_INLINE
+void
+pool_push(clarinet_packet_pool* pool,
+          uint32_t first,
+          uint32_t last)
+{
+    volatile LONG64* target = (volatile LONG64*)&pool->head;
+    LONG64 head;
+    LONG64 prev = *target;
+    do
+    {
+        head = prev;
+        ((volatile uint32_t*)pool->links)[last] = POOL_HEAD_TOP((uint64_t)head);
+        const uint64_t next = POOL_HEAD(POOL_HEAD_TAG((uint64_t)head) + 1, first + 1);
+        prev = InterlockedCompareExchange64(target, (LONG64)next, head);
+    } while (prev != head);
+}
+
+/** Helper to pop a single slab from the free list. */
+CLARINET_STATIC_INLINE
+int
+pool_pop(clarinet_packet_pool* restrict pool,
+         uint32_t* restrict index)
+{
+    volatile LONG64* target = (volatile LONG64*)&pool->head;
+    LONG64 head;
+    LONG64 prev = *target;
+    uint32_t top;
+    do
+    {
+        head = prev;
+        top = POOL_HEAD_TOP((uint64_t)head);
+        if (top == 0)
+            return CLARINET_ENOBUFS;
+
+        /* The link may be overwritten concurrently if the slab is popped (and pushed) by another thread but then the
+         * generation of the head changes and the exchange fails. */
+        const uint32_t link = ((volatile uint32_t*)pool->links)[top - 1];
+        const uint64_t next = POOL_HEAD(POOL_HEAD_TAG((uint64_t)head) + 1, link);
+        prev = InterlockedCompareExchange64(target, (LONG64)next, head);
+    } while (prev != head);
+
+    *index = top - 1;
+    return CLARINET_ENONE;
+}
+
+/** Helper to push the slabs in @p slabs as a single chain onto the free list. */
+CLARINET_STATIC_INLINE
+void
+pool_push_many(clarinet_packet_pool* restrict pool,
+               const uint32_t* restrict slabs,
+               uint32_t count)
+{
+    for (uint32_t i = 1; i < count; ++i)
+        ((volatile uint32_t*)pool->links)[slabs[i - 1]] = slabs[i] + 1;
+
+    pool_push(pool, slabs[0], slabs[count - 1]);
+}
+
+/**
+ * Helper to map the memory of a pool. Large pages are attempted first if requested. They can only be allocated if the
+ * process holds the SeLockMemoryPrivilege (which must be explicitly enabled) otherwise VirtualAlloc fails.
+ */
+CLARINET_STATIC_INLINE
+void*
+pool_map(size_t* restrict size,
+         uint32_t* restrict flags)
+{
+    if (*flags & CLARINET_PACKET_POOL_HUGEPAGES)
+    {
+        const size_t minimum = GetLargePageMinimum();
+        if (minimum > 0)
+        {
+            const size_t lsize = pool_align(*size, minimum);
+            void* p = VirtualAlloc(NULL, lsize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p)
+            {
+                *size = lsize;
+                return p;
+            }
+        }
+    }
+
+    *flags &= ~(uint32_t)CLARINET_PACKET_POOL_HUGEPAGES;
+    return VirtualAlloc(NULL, *size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+/* endregion */
+
+/* region Packet Pool */
+
+void
+clarinet_packet_pool_init(clarinet_packet_pool* pool)
+{
+    memset(pool, 0, sizeof(clarinet_packet_pool));
+}
+
+int
+clarinet_packet_pool_open(clarinet_packet_pool* pool,
+                          size_t slabsize,
+                          uint32_t count,
+                          uint32_t flags)
+{
+    if (!pool || clarinet_packet_pool_is_open(pool) || slabsize == 0 || slabsize > INT_MAX
+        || count == 0 || count > INT_MAX || (flags & ~(uint32_t)CLARINET_PACKET_POOL_HUGEPAGES))
+        return CLARINET_EINVAL;
+
+    const size_t stride = pool_align(slabsize, CLARINET_PACKET_POOL_ALIGNMENT);
+    const size_t linksize = pool_align(count * sizeof(uint32_t), CLARINET_PACKET_POOL_ALIGNMENT);
+    if (count > (SIZE_MAX - linksize) / stride)
+        return CLARINET_ENOMEM;
+
+    size_t size = linksize + count * stride;
+    void* base = pool_map(&size, &flags);
+    if (!base)
+        return CLARINET_ENOMEM;
+
+    pool->base = base;
+    pool->size = size;
+    pool->links = (uint32_t*)base;
+    pool->slabs = (uint8_t*)base + linksize;
+    pool->slabsize = slabsize;
+    pool->stride = stride;
+    pool->count = count;
+    pool->flags = flags;
+
+    /* Initially all slabs are free and linked in order. */
+    for (uint32_t i = 0; i < count - 1; ++i)
+        pool->links[i] = i + 2;
+    pool->links[count - 1] = 0;
+
+    InterlockedExchange64((volatile LONG64*)&pool->head, (LONG64)POOL_HEAD(0, 1));
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_packet_pool_close(clarinet_packet_pool* pool)
+{
+    if (!pool || !clarinet_packet_pool_is_open(pool))
+        return CLARINET_EINVAL;
+
+    VirtualFree(pool->base, 0, MEM_RELEASE);
+    clarinet_packet_pool_init(pool);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_packet_pool_acquire(clarinet_packet_pool* restrict pool,
+                             void** restrict buf)
+{
+    if (!pool || !clarinet_packet_pool_is_open(pool) || !buf)
+        return CLARINET_EINVAL;
+
+    uint32_t index;
+    const int errcode = pool_pop(pool, &index);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    *buf = pool->slabs + (size_t)index * pool->stride;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_packet_pool_release(clarinet_packet_pool* restrict pool,
+                             void* restrict buf)
+{
+    if (!pool || !clarinet_packet_pool_is_open(pool))
+        return CLARINET_EINVAL;
+
+    uint32_t index;
+    const int errcode = pool_index(pool, buf, &index);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    pool_push_many(pool, &index, 1);
+    return CLARINET_ENONE;
+}
+
+void
+clarinet_packet_cache_init(clarinet_packet_cache* restrict cache,
+                           clarinet_packet_pool* restrict pool)
+{
+    memset(cache, 0, sizeof(clarinet_packet_cache));
+    cache->pool = pool;
+}
+
+int
+clarinet_packet_cache_acquire(clarinet_packet_cache* restrict cache,
+                              void** restrict buf)
+{
+    if (!cache || !cache->pool || !clarinet_packet_pool_is_open(cache->pool) || !buf)
+        return CLARINET_EINVAL;
+
+    clarinet_packet_pool* pool = cache->pool;
+    if (cache->count == 0)
+    {
+        while (cache->count < CLARINET_PACKET_CACHE_SIZE / 2)
+        {
+            if (pool_pop(pool, &cache->slabs[cache->count]) != CLARINET_ENONE)
+                break;
+
+            cache->count++;
+        }
+
+        if (cache->count == 0)
+            return CLARINET_ENOBUFS;
+    }
+
+    cache->count--;
+    *buf = pool->slabs + (size_t)cache->slabs[cache->count] * pool->stride;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_packet_cache_release(clarinet_packet_cache* restrict cache,
+                              void* restrict buf)
+{
+    if (!cache || !cache->pool || !clarinet_packet_pool_is_open(cache->pool))
+        return CLARINET_EINVAL;
+
+    uint32_t index;
+    const int errcode = pool_index(cache->pool, buf, &index);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    if (cache->count == CLARINET_PACKET_CACHE_SIZE)
+    {
+        cache->count -= CLARINET_PACKET_CACHE_SIZE / 2;
+        pool_push_many(cache->pool, &cache->slabs[cache->count], CLARINET_PACKET_CACHE_SIZE / 2);
+    }
+
+    cache->slabs[cache->count++] = index;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_packet_cache_flush(clarinet_packet_cache* cache)
+{
+    if (!cache || !cache->pool || !clarinet_packet_pool_is_open(cache->pool))
+        return CLARINET_EINVAL;
+
+    if (cache->count > 0)
+    {
+        pool_push_many(cache->pool, cache->slabs, cache->count);
+        cache->count = 0;
+    }
+
+    return CLARINET_ENONE;
+}
+
+/* endregion */
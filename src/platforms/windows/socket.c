@@ -3,6 +3,8 @@
 
 #include "compat/addr.h"
 #include "compat/error.h"
+#include "compat/log.h"
+#include "compat/stats.h"
 
 #include <synchapi.h>
 #include <assert.h>
@@ -124,6 +126,65 @@ setnonblock(SOCKET sockfd,
     return ioctlsocket(sockfd, FIONBIO, &value);
 }
 
+/** Helper to translate socket event flags into WSAPoll events. */
+CLARINET_STATIC_INLINE
+short
+poll_events_to_native(uint16_t events)
+{
+    short result = 0;
+    if (events & CLARINET_POLL_RECV)
+        result |= POLLRDNORM;
+    if (events & CLARINET_POLL_SEND)
+        result |= POLLWRNORM;
+
+    return result;
+}
+
+/** Helper to translate WSAPoll revents into socket event flags. */
+CLARINET_STATIC_INLINE
+uint16_t
+poll_events_from_native(short revents)
+{
+    uint16_t result = CLARINET_POLL_NONE;
+    if (revents & POLLNVAL)
+        result |= CLARINET_POLL_INVALID;
+    if (revents & POLLERR)
+        result |= CLARINET_POLL_ERROR;
+    if (revents & POLLHUP)
+        result |= CLARINET_POLL_SHUTDOWN;
+    if (revents & POLLRDNORM)
+        result |= CLARINET_POLL_RECV;
+    if (revents & POLLWRNORM)
+        result |= CLARINET_POLL_SEND;
+
+    return result;
+}
+
+/**
+ * Helper to translate an array of scatter/gather buffers into an array of @c WSABUF. Returns the total length in bytes
+ * of all buffers or @c CLARINET_EINVAL if a buffer of non-zero length is NULL or the total length is greater than
+ * INT_MAX.
+ */
+CLARINET_STATIC_INLINE
+int
+iovec_to_native(WSABUF* restrict dst,
+                const clarinet_iovec* restrict src,
+                size_t count)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((!src[i].base && src[i].len > 0) || src[i].len > INT_MAX - total)
+            return CLARINET_EINVAL;
+
+        dst[i].buf = (CHAR*)src[i].base;
+        dst[i].len = (ULONG)src[i].len;
+        total += src[i].len;
+    }
+
+    return (int)total;
+}
+
 /* endregion */
 
 /* region Socket */
@@ -245,6 +306,7 @@ clarinet_socket_open(clarinet_socket* sp,
     sp->family = (uint16_t)family;
     sp->handle = (void*)sockfd;
 
+    clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_SOCKET_OPEN, sockfd, family, proto, 0);
     return CLARINET_ENONE;
 }
 
@@ -301,6 +363,7 @@ clarinet_socket_close(clarinet_socket* sp)
                 }
                 else
                 {
+                    clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_SOCKET_CLOSE, sockfd, 0, 0, 0);
                     clarinet_socket_init(sp);
                     return CLARINET_ENONE;
                 }
@@ -313,6 +376,7 @@ clarinet_socket_close(clarinet_socket* sp)
         return clarinet_error_from_sockapi_error(err);
     }
 
+    clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_SOCKET_CLOSE, sockfd, 0, 0, 0);
     clarinet_socket_init(sp);
     return CLARINET_ENONE;
 }
@@ -418,9 +482,11 @@ clarinet_socket_send(clarinet_socket* restrict sp,
 
     const SOCKET sockfd = clarinet_socket_handle(sp);
 
-    if (send(sockfd, buf, (int)buflen, 0) == SOCKET_ERROR)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+    const int n = send(sockfd, buf, (int)buflen, 0);
+    if (n == SOCKET_ERROR)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
+    (void)clarinet_socket_stats_sent(sp, n, 1);
     return CLARINET_ENONE;
 }
 
@@ -446,9 +512,9 @@ clarinet_socket_sendto(clarinet_socket* restrict sp,
 
     const int n = sendto(sockfd, buf, (int)buflen, 0, (struct sockaddr*)&ss, sslen);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
-    return (int)n;
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
 }
 
 int
@@ -466,9 +532,9 @@ clarinet_socket_recv(clarinet_socket* restrict sp,
 
     const int n = recv(sockfd, buf, (int)buflen, 0);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
-    return (int)n;
+    return clarinet_socket_stats_received(sp, (int)n, 1);
 }
 
 int
@@ -489,18 +555,361 @@ clarinet_socket_recvfrom(clarinet_socket* restrict sp,
     int sslen = sizeof(ss);
     const int n = recvfrom(sockfd, buf, (int)buflen, 0, (struct sockaddr*)&ss, &sslen);
     if (n < 0)
-        return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
 
     /* Sanity: improbable but possible */
     if (sslen > sizeof(ss))
-        return CLARINET_EADDRNOTAVAIL;
+        return clarinet_socket_stats_received(sp, CLARINET_EADDRNOTAVAIL, 0);
 
     const int errcode = clarinet_endpoint_from_sockaddr(remote, &ss);
     if (errcode != CLARINET_ENONE)
-        return CLARINET_EADDRNOTAVAIL;
+        return clarinet_socket_stats_received(sp, CLARINET_EADDRNOTAVAIL, 0);
 
     assert(n >= 0);
-    return (int)n;
+    return clarinet_socket_stats_received(sp, n, 1);
+}
+
+int
+clarinet_socket_sendv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    WSABUF buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total < 0)
+        return total;
+
+    DWORD n = 0;
+    if (WSASend(sockfd, buffers, (DWORD)iovcnt, &n, 0, NULL, NULL) == SOCKET_ERROR)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_sendtov(clarinet_socket* restrict sp,
+                        const clarinet_iovec* restrict iov,
+                        size_t iovcnt,
+                        const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    WSABUF buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total < 0)
+        return total;
+
+    struct sockaddr_storage ss = { 0 };
+    socklen_t sslen = 0;
+    const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, remote);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    DWORD n = 0;
+    if (WSASendTo(sockfd, buffers, (DWORD)iovcnt, &n, 0, (struct sockaddr*)&ss, sslen, NULL, NULL) == SOCKET_ERROR)
+        return clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_sent(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_recvv(clarinet_socket* restrict sp,
+                      const clarinet_iovec* restrict iov,
+                      size_t iovcnt)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    WSABUF buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total <= 0)
+        return CLARINET_EINVAL;
+
+    /* A truncated datagram fails with WSAEMSGSIZE which is already translated into CLARINET_EMSGSIZE. */
+    DWORD n = 0;
+    DWORD flags = 0;
+    if (WSARecv(sockfd, buffers, (DWORD)iovcnt, &n, &flags, NULL, NULL) == SOCKET_ERROR)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    return clarinet_socket_stats_received(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_recvfromv(clarinet_socket* restrict sp,
+                          const clarinet_iovec* restrict iov,
+                          size_t iovcnt,
+                          clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !iov || iovcnt == 0 || iovcnt > CLARINET_IOVEC_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    WSABUF buffers[CLARINET_IOVEC_MAX];
+    const int total = iovec_to_native(buffers, iov, iovcnt);
+    if (total <= 0)
+        return CLARINET_EINVAL;
+
+    struct sockaddr_storage ss;
+    int sslen = sizeof(ss);
+    DWORD n = 0;
+    DWORD flags = 0;
+    const int result = WSARecvFrom(sockfd, buffers, (DWORD)iovcnt, &n, &flags, (struct sockaddr*)&ss, &sslen, NULL, NULL);
+    if (result == SOCKET_ERROR)
+        return clarinet_socket_stats_received(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+
+    /* Sanity: improbable but possible */
+    if (sslen > sizeof(ss))
+        return clarinet_socket_stats_received(sp, CLARINET_EADDRNOTAVAIL, 0);
+
+    const int errcode = clarinet_endpoint_from_sockaddr(remote, &ss);
+    if (errcode != CLARINET_ENONE)
+        return clarinet_socket_stats_received(sp, CLARINET_EADDRNOTAVAIL, 0);
+
+    return clarinet_socket_stats_received(sp, (int)n, 1);
+}
+
+int
+clarinet_socket_sendtoat(clarinet_socket* restrict sp,
+                         const void* restrict buf,
+                         size_t buflen,
+                         const clarinet_endpoint* restrict remote,
+                         uint64_t txtime)
+{
+    CLARINET_IGNORE_PARAM(txtime);
+
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    /* Windows has no equivalent of SO_TXTIME. The closest is the QoS2 API (QOSSetFlow with QOSSetOutgoingRate)
+     * which paces a whole flow and is covered by clarinet_pacer in user space. */
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_sendsegments(clarinet_socket* restrict sp,
+                             const void* restrict buf,
+                             size_t buflen,
+                             size_t segsize,
+                             const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX
+        || segsize == 0 || segsize > UINT16_MAX || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    /* Not supported. UDP_SEND_MSG_SIZE (Windows 10 2004) is the closest equivalent of Linux UDP_SEGMENT. */
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_recvfromts(clarinet_socket* restrict sp,
+                           void* restrict buf,
+                           size_t buflen,
+                           uint64_t* restrict timestamp,
+                           clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX || !timestamp || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    /* Not supported. SIO_TIMESTAMPING (Windows 10 20H1) is the closest equivalent and reports receive timestamps in a
+     * SO_TIMESTAMP control message through WSARecvMsg. */
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_recvsegments(clarinet_socket* restrict sp,
+                             void* restrict buf,
+                             size_t buflen,
+                             size_t* restrict segsize,
+                             clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !buf || buflen == 0 || buflen > INT_MAX || !segsize || !remote)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    /* Not supported. UDP_RECV_MAX_COALESCED_SIZE (Windows 10 2004) is the closest equivalent of Linux UDP_GRO. */
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_sendzc(clarinet_socket* restrict sp,
+                       const void* restrict buf,
+                       size_t buflen,
+                       const clarinet_endpoint* restrict remote)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || (!buf && buflen > 0) || buflen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    /* Winsock has no equivalent of MSG_ZEROCOPY for regular sockets. Registered I/O (RIO) is the closest option. */
+    CLARINET_IGNORE_PARAM(remote);
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_zerocopy_reap(clarinet_socket* restrict sp,
+                              clarinet_zerocopy_range* restrict ranges,
+                              size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !ranges || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_socket_sendmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !msgs || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((!msgs[i].buf && msgs[i].buflen > 0) || msgs[i].buflen > INT_MAX)
+            return CLARINET_EINVAL;
+    }
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    /* Winsock has no equivalent to sendmmsg(2) so we just send one message at a time. */
+    size_t sent = 0;
+    for (; sent < count; ++sent)
+    {
+        clarinet_socket_message* m = &msgs[sent];
+
+        struct sockaddr_storage ss = { 0 };
+        socklen_t sslen = 0;
+        const int errcode = clarinet_endpoint_to_sockaddr(&ss, &sslen, &m->remote);
+        if (errcode != CLARINET_ENONE)
+            return sent > 0 ? (int)sent : errcode;
+
+        const int n = sendto(sockfd, m->buf, (int)m->buflen, 0, (struct sockaddr*)&ss, sslen);
+        if (n < 0)
+        {
+            const int err = clarinet_socket_stats_sent(sp, clarinet_error_from_sockapi_error(clarinet_get_sockapi_error()), 0);
+            if (sent > 0)
+                break;
+
+            return err;
+        }
+
+        m->result = clarinet_socket_stats_sent(sp, n, 1);
+    }
+
+    assert(sent > 0 && sent <= INT_MAX);
+    return (int)sent;
+}
+
+int
+clarinet_socket_recvmany(clarinet_socket* restrict sp,
+                         clarinet_socket_message* restrict msgs,
+                         size_t count)
+{
+    if (!sp || sp->family == CLARINET_AF_UNSPEC || !msgs || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!msgs[i].buf || msgs[i].buflen == 0 || msgs[i].buflen > INT_MAX)
+            return CLARINET_EINVAL;
+    }
+
+    if (!clarinet_socket_handle_is_valid(sp))
+        return CLARINET_EINVAL;
+
+    const SOCKET sockfd = clarinet_socket_handle(sp);
+
+    /* Winsock has no equivalent to recvmmsg(2) or MSG_DONTWAIT so we receive one message at a time and check if there
+     * is more data pending before each subsequent call to avoid blocking after the first datagram. */
+    size_t received = 0;
+    for (; received < count; ++received)
+    {
+        clarinet_socket_message* m = &msgs[received];
+
+        if (received > 0)
+        {
+            u_long pending = 0;
+            clarinet_socket_stats_syscall(sp);
+            if (ioctlsocket(sockfd, FIONREAD, &pending) == SOCKET_ERROR || pending == 0)
+                break;
+        }
+
+        struct sockaddr_storage ss;
+        int sslen = sizeof(ss);
+        const int n = recvfrom(sockfd, m->buf, (int)m->buflen, 0, (struct sockaddr*)&ss, &sslen);
+        clarinet_socket_stats_syscall(sp);
+        if (n < 0)
+        {
+            const int err = clarinet_get_sockapi_error();
+            if (err == WSAEMSGSIZE)
+            {
+                /* Truncated datagrams still count as received and the source address is valid. */
+                m->result = (sslen > sizeof(ss) || clarinet_endpoint_from_sockaddr(&m->remote, &ss) != CLARINET_ENONE)
+                            ? CLARINET_EADDRNOTAVAIL
+                            : CLARINET_EMSGSIZE;
+                (void)clarinet_socket_stats_in(sp, m->result, 0);
+                continue;
+            }
+
+            const int errcode = clarinet_socket_stats_in(sp, clarinet_error_from_sockapi_error(err), 0);
+            if (received > 0)
+                break;
+
+            return errcode;
+        }
+
+        /* Sanity: improbable but possible */
+        if (sslen > sizeof(ss) || clarinet_endpoint_from_sockaddr(&m->remote, &ss) != CLARINET_ENONE)
+            m->result = clarinet_socket_stats_in(sp, CLARINET_EADDRNOTAVAIL, 0);
+        else
+            m->result = clarinet_socket_stats_in(sp, n, 1);
+    }
+
+    assert(received > 0 && received <= INT_MAX);
+    return (int)received;
 }
 
 int
@@ -1271,8 +1680,8 @@ clarinet_socket_poll_context_getstatus(const void* context,
     if (!context || index >= INT_MAX || !status)
         return CLARINET_EINVAL;
 
-    const struct pollfd* pfd = (struct pollfd*)context;
-    *status = (uint16_t)pfd[index].revents;
+    const struct pollfd* pfd = (const struct pollfd*)context;
+    *status = poll_events_from_native(pfd[index].revents);
 
     return CLARINET_ENONE;
 }
@@ -1286,9 +1695,39 @@ clarinet_socket_poll(void* restrict context,
     if (!context || !targets || count == 0 || count > INT_MAX)
         return CLARINET_EINVAL;
 
-    if (WSAPoll((struct pollfd*)context, (ULONG)count, timeout) == SOCKET_ERROR)
+    struct pollfd* pfd = (struct pollfd*)context;
+
+    /* Targets without a valid socket are ignored by WSAPoll (INVALID_SOCKET) and reported invalid afterwards. */
+    size_t invalid = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const clarinet_socket* sp = targets[i].socket;
+        if (sp && sp->family != CLARINET_AF_UNSPEC && clarinet_socket_handle_is_valid(sp))
+        {
+            pfd[i].fd = clarinet_socket_handle(sp);
+            pfd[i].events = poll_events_to_native(targets[i].events);
+        }
+        else
+        {
+            pfd[i].fd = INVALID_SOCKET;
+            pfd[i].events = 0;
+            invalid++;
+        }
+        pfd[i].revents = 0;
+    }
+
+    if (WSAPoll(pfd, (ULONG)count, timeout) == SOCKET_ERROR)
         return clarinet_error_from_sockapi_error(clarinet_get_sockapi_error());
 
+    for (size_t i = 0; invalid > 0 && i < count; ++i)
+    {
+        if (pfd[i].fd == INVALID_SOCKET)
+        {
+            pfd[i].revents = POLLNVAL;
+            invalid--;
+        }
+    }
+
     return CLARINET_ENONE;
 }
 
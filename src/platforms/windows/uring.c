@@ -0,0 +1,194 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+/* region Completion Ring */
+
+/* Completion rings are not supported on Windows. Registered I/O (RIO) is the closest equivalent for datagram sockets.
+ * A ring can never be opened which means every other function fails the validation of the ring. */
+
+void
+clarinet_uring_init(clarinet_uring* ur)
+{
+    memset(ur, 0, sizeof(clarinet_uring));
+}
+
+int
+clarinet_uring_open(clarinet_uring* ur,
+                    uint32_t entries)
+{
+    if (!ur || ur->handle || entries == 0)
+        return CLARINET_EINVAL;
+
+    return CLARINET_ENOTSUP;
+}
+
+int
+clarinet_uring_close(clarinet_uring* ur)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_recv(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    void* restrict buf,
+                    size_t buflen,
+                    void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(buf);
+    CLARINET_IGNORE_PARAM(buflen);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_recvfrom(clarinet_uring* restrict ur,
+                        clarinet_socket* restrict sp,
+                        void* restrict buf,
+                        size_t buflen,
+                        clarinet_endpoint* restrict remote,
+                        void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(buf);
+    CLARINET_IGNORE_PARAM(buflen);
+    CLARINET_IGNORE_PARAM(remote);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_send(clarinet_uring* restrict ur,
+                    clarinet_socket* restrict sp,
+                    const void* restrict buf,
+                    size_t buflen,
+                    void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(buf);
+    CLARINET_IGNORE_PARAM(buflen);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_sendto(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp,
+                      const void* restrict buf,
+                      size_t buflen,
+                      const clarinet_endpoint* restrict remote,
+                      void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(buf);
+    CLARINET_IGNORE_PARAM(buflen);
+    CLARINET_IGNORE_PARAM(remote);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_accept(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict ssp,
+                      clarinet_socket* restrict csp,
+                      clarinet_endpoint* restrict remote,
+                      void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(ssp);
+    CLARINET_IGNORE_PARAM(csp);
+    CLARINET_IGNORE_PARAM(remote);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_connect(clarinet_uring* restrict ur,
+                       clarinet_socket* restrict sp,
+                       const clarinet_endpoint* restrict remote,
+                       void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(remote);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_provide(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       void* restrict buf,
+                       size_t bufsize,
+                       uint16_t count)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(group);
+    CLARINET_IGNORE_PARAM(buf);
+    CLARINET_IGNORE_PARAM(bufsize);
+    CLARINET_IGNORE_PARAM(count);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_release(clarinet_uring* restrict ur,
+                       uint16_t group,
+                       uint16_t buffer)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(group);
+    CLARINET_IGNORE_PARAM(buffer);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_recvfrom_multishot(clarinet_uring* restrict ur,
+                                  clarinet_socket* restrict sp,
+                                  uint16_t group,
+                                  void* data)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    CLARINET_IGNORE_PARAM(group);
+    CLARINET_IGNORE_PARAM(data);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_cancel(clarinet_uring* restrict ur,
+                      clarinet_socket* restrict sp)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(sp);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_submit(clarinet_uring* ur)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    return CLARINET_EINVAL;
+}
+
+int
+clarinet_uring_wait(clarinet_uring* restrict ur,
+                    clarinet_uring_completion* restrict completions,
+                    size_t count,
+                    int timeout)
+{
+    CLARINET_IGNORE_PARAM(ur);
+    CLARINET_IGNORE_PARAM(completions);
+    CLARINET_IGNORE_PARAM(count);
+    CLARINET_IGNORE_PARAM(timeout);
+    return CLARINET_EINVAL;
+}
+
+/* endregion */
@@ -1 +1,712 @@
-#include "compat/compat.h"
\ No newline at end of file
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/log.h"
+#include "compat/bytes.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+/**
+ * Wire format (all integers in network byte order):
+ *
+ *      header      version:4 type:4 | destination id:32
+ *      HELLO       header(0) | source id:32 | padding:64
+ *      COOKIE      header(source id) | timestamp:32 | cookie:64
+ *      CONNECT     header(0) | source id:32 | timestamp:32 | cookie:64
+ *      ACCEPT      header(source id) | server id:32
+ *      DATA        header(remote id) | payload
+ *      KEEPALIVE   header(remote id)
+ *      CLOSE       header(remote id)
+ *
+ * The cookie is a keyed hash (SipHash-2-4) of the client endpoint, the client connection id and a timestamp in seconds
+ * so the server can validate a CONNECT without having stored anything for the HELLO.
+ */
+#define DTLC_VERSION                1
+#define DTLC_TYPE_HELLO             1
+#define DTLC_TYPE_COOKIE            2
+#define DTLC_TYPE_CONNECT           3
+#define DTLC_TYPE_ACCEPT            4
+#define DTLC_TYPE_DATA              5
+#define DTLC_TYPE_KEEPALIVE         6
+#define DTLC_TYPE_CLOSE             7
+
+#define DTLC_HELLO_SIZE             (CLARINET_DTLC_HEADER_SIZE + 12)
+#define DTLC_COOKIE_SIZE            (CLARINET_DTLC_HEADER_SIZE + 12)
+#define DTLC_CONNECT_SIZE           (CLARINET_DTLC_HEADER_SIZE + 16)
+#define DTLC_ACCEPT_SIZE            (CLARINET_DTLC_HEADER_SIZE + 4)
+
+#define DTLC_COOKIE_LIFETIME        10      /**< Seconds a cookie remains valid */
+#define DTLC_HANDSHAKE_RETRY        250     /**< Milliseconds between handshake retransmissions */
+
+#define DTLC_SLOT_BITS              16
+
+/** Returns true (non-zero) if the DTLC endpoint pointed to by @p d is open. */
+#define clarinet_dtlc_is_open(d)    ((d)->connections != NULL)
+
+#define DTLC_ROTL(x, b)             (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define DTLC_SIPROUND(v0, v1, v2, v3) \
+do { \
+    v0 += v1; v1 = DTLC_ROTL(v1, 13); v1 ^= v0; v0 = DTLC_ROTL(v0, 32); \
+    v2 += v3; v3 = DTLC_ROTL(v3, 16); v3 ^= v2; \
+    v0 += v3; v3 = DTLC_ROTL(v3, 21); v3 ^= v0; \
+    v2 += v1; v1 = DTLC_ROTL(v1, 17); v1 ^= v2; v2 = DTLC_ROTL(v2, 32); \
+} while (0)
+
+CLARINET_STATIC_INLINE
+uint64_t
+dtlc_get64le(const uint8_t* p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24)
+           | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/** SipHash-2-4 (https://131002.net/siphash/) of @p inlen bytes at @p in with a 128-bit @p key. */
+static
+uint64_t
+dtlc_siphash(const uint8_t* restrict key,
+             const uint8_t* restrict in,
+             size_t inlen)
+{
+    const uint64_t k0 = dtlc_get64le(key);
+    const uint64_t k1 = dtlc_get64le(key + 8);
+    uint64_t v0 = UINT64_C(0x736f6d6570736575) ^ k0;
+    uint64_t v1 = UINT64_C(0x646f72616e646f6d) ^ k1;
+    uint64_t v2 = UINT64_C(0x6c7967656e657261) ^ k0;
+    uint64_t v3 = UINT64_C(0x7465646279746573) ^ k1;
+
+    const uint8_t* end = in + (inlen - (inlen % 8));
+    for (; in != end; in += 8)
+    {
+        const uint64_t m = dtlc_get64le(in);
+        v3 ^= m;
+        DTLC_SIPROUND(v0, v1, v2, v3);
+        DTLC_SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t b = ((uint64_t)inlen) << 56;
+    for (size_t i = 0; i < inlen % 8; ++i)
+        b |= ((uint64_t)in[i]) << (8 * i);
+
+    v3 ^= b;
+    DTLC_SIPROUND(v0, v1, v2, v3);
+    DTLC_SIPROUND(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    DTLC_SIPROUND(v0, v1, v2, v3);
+    DTLC_SIPROUND(v0, v1, v2, v3);
+    DTLC_SIPROUND(v0, v1, v2, v3);
+    DTLC_SIPROUND(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/**
+ * Helper to compute a keyed hash of a remote endpoint, a remote connection id and a timestamp. Only the significant
+ * bytes of the address are hashed so endpoints that compare equal always produce the same hash.
+ */
+static
+uint64_t
+dtlc_hash(const clarinet_dtlc* restrict dp,
+          const clarinet_endpoint* restrict remote,
+          uint32_t id,
+          uint32_t timestamp)
+{
+    uint8_t key[32];
+    size_t n = 0;
+
+    key[n++] = (uint8_t)(remote->addr.family >> 8);
+    key[n++] = (uint8_t)remote->addr.family;
+    key[n++] = (uint8_t)(remote->port >> 8);
+    key[n++] = (uint8_t)remote->port;
+    clarinet_put32(&key[n], id);
+    n += 4;
+    clarinet_put32(&key[n], timestamp);
+    n += 4;
+    if (clarinet_addr_is_ipv6(&remote->addr))
+    {
+        memcpy(&key[n], remote->addr.as.ipv6.u.byte, 16);
+        n += 16;
+        clarinet_put32(&key[n], remote->addr.as.ipv6.scope_id);
+        n += 4;
+    }
+    else
+    {
+        memcpy(&key[n], &remote->addr.as.ipv6.u.dword[3], 4);
+        n += 4;
+    }
+
+    return dtlc_siphash(dp->config.secret, key, n);
+}
+
+/** Helper to compute the milliseconds elapsed since @p then. Returns 0 if the clock went backwards. */
+CLARINET_STATIC_INLINE
+uint64_t
+dtlc_elapsed(uint64_t now,
+             uint64_t then)
+{
+    return (now > then) ? now - then : 0;
+}
+
+/** Helper to find the hash bucket of the connection established by a remote peer with the connection id @p id. */
+CLARINET_STATIC_INLINE
+clarinet_dtlc_connection*
+dtlc_bucket(clarinet_dtlc* restrict dp,
+            const clarinet_endpoint* restrict remote,
+            uint32_t id)
+{
+    return &dp->connections[dtlc_hash(dp, remote, id, 0) % dp->capacity];
+}
+
+/** Helper to find a connection accepted from a remote peer. Returns NULL if not found. */
+static
+clarinet_dtlc_connection*
+dtlc_lookup(clarinet_dtlc* restrict dp,
+            const clarinet_endpoint* restrict remote,
+            uint32_t id)
+{
+    uint32_t next = dtlc_bucket(dp, remote, id)->bucket;
+    while (next != 0)
+    {
+        clarinet_dtlc_connection* c = &dp->connections[next - 1];
+        if (c->remote_id == id && clarinet_endpoint_is_equal(&c->remote, remote))
+            return c;
+
+        next = c->next;
+    }
+
+    return NULL;
+}
+
+/** Helper to remove a connection from its hash chain if it is in one. */
+static
+void
+dtlc_unlink(clarinet_dtlc* restrict dp,
+            clarinet_dtlc_connection* restrict c)
+{
+    const uint32_t index = (uint32_t)(c - dp->connections) + 1;
+    uint32_t* link = &dtlc_bucket(dp, &c->remote, c->remote_id)->bucket;
+    while (*link != 0)
+    {
+        if (*link == index)
+        {
+            *link = c->next;
+            return;
+        }
+
+        link = &dp->connections[*link - 1].next;
+    }
+}
+
+/** Helper to move a connection slot from the free list to the list of slots in use. Returns NULL if there are none. */
+static
+clarinet_dtlc_connection*
+dtlc_acquire(clarinet_dtlc* restrict dp,
+             const clarinet_endpoint* restrict remote,
+             uint64_t now)
+{
+    if (dp->free == 0)
+        return NULL;
+
+    const uint32_t slot = dp->free - 1;
+    clarinet_dtlc_connection* c = &dp->connections[slot];
+    dp->free = c->next;
+    dp->count++;
+
+    c->active_prev = 0;
+    c->active_next = dp->active;
+    if (dp->active != 0)
+        dp->connections[dp->active - 1].active_prev = slot + 1;
+    dp->active = slot + 1;
+
+    c->remote = *remote;
+    c->last_recv = now;
+    c->last_send = now;
+    c->data = NULL;
+    c->local_id = ((uint32_t)c->generation << DTLC_SLOT_BITS) | slot;
+    c->remote_id = 0;
+    c->cookie = 0;
+    c->timestamp = 0;
+    c->next = 0;
+    return c;
+}
+
+/** Helper to return a connection slot to the free list. The generation is advanced so the old id becomes stale. */
+static
+void
+dtlc_release(clarinet_dtlc* restrict dp,
+             clarinet_dtlc_connection* restrict c)
+{
+    if (c->state == CLARINET_DTLC_STATE_CONNECTED)
+        dtlc_unlink(dp, c);
+
+    if (c->active_prev != 0)
+        dp->connections[c->active_prev - 1].active_next = c->active_next;
+    else
+        dp->active = c->active_next;
+
+    if (c->active_next != 0)
+        dp->connections[c->active_next - 1].active_prev = c->active_prev;
+
+    c->active_prev = 0;
+    c->active_next = 0;
+    c->generation++;
+    if (c->generation == 0)
+        c->generation = 1;
+
+    c->state = CLARINET_DTLC_STATE_FREE;
+    c->local_id = 0;
+    c->next = dp->free;
+    dp->free = (uint32_t)(c - dp->connections) + 1;
+    dp->count--;
+}
+
+/** Helper to send a control datagram. */
+static
+int
+dtlc_send_control(clarinet_dtlc* restrict dp,
+                  const clarinet_endpoint* restrict remote,
+                  uint8_t type,
+                  uint32_t dst,
+                  const uint8_t* restrict payload,
+                  size_t len)
+{
+    uint8_t packet[DTLC_CONNECT_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = (uint8_t)((DTLC_VERSION << 4) | type);
+    clarinet_put32(&packet[1], dst);
+    if (len > 0)
+        memcpy(&packet[CLARINET_DTLC_HEADER_SIZE], payload, len);
+
+    /* HELLO is padded to the size of COOKIE so the server never sends more than it receives. */
+    const size_t size = (type == DTLC_TYPE_HELLO) ? DTLC_HELLO_SIZE : CLARINET_DTLC_HEADER_SIZE + len;
+    const int n = clarinet_socket_sendto(dp->socket, packet, size, remote);
+    return (n < 0) ? n : CLARINET_ENONE;
+}
+
+/** Helper to send the handshake datagram that corresponds to the state of a connection. */
+static
+int
+dtlc_send_handshake(clarinet_dtlc* restrict dp,
+                    clarinet_dtlc_connection* restrict c,
+                    uint64_t now)
+{
+    uint8_t payload[16];
+    clarinet_put32(&payload[0], c->local_id);
+    c->last_send = now;
+    if (c->state == CLARINET_DTLC_STATE_HELLO)
+        return dtlc_send_control(dp, &c->remote, DTLC_TYPE_HELLO, 0, payload, 4);
+
+    clarinet_put32(&payload[4], c->timestamp);
+    clarinet_put64(&payload[8], c->cookie);
+    return dtlc_send_control(dp, &c->remote, DTLC_TYPE_CONNECT, 0, payload, 16);
+}
+
+/** Helper to find a connection by local id that also matches the remote endpoint. */
+CLARINET_STATIC_INLINE
+clarinet_dtlc_connection*
+dtlc_demux(clarinet_dtlc* restrict dp,
+           uint32_t id,
+           const clarinet_endpoint* restrict remote)
+{
+    clarinet_dtlc_connection* c = clarinet_dtlc_connection_find(dp, id);
+    return (c && clarinet_endpoint_is_equal(&c->remote, remote)) ? c : NULL;
+}
+
+/** Helper to process a CONNECT. Returns true (non-zero) if a new connection was established. */
+static
+int
+dtlc_accept(clarinet_dtlc* restrict dp,
+            const clarinet_endpoint* restrict remote,
+            const uint8_t* restrict p,
+            uint64_t now,
+            clarinet_dtlc_event* restrict event)
+{
+    const uint32_t id = clarinet_get32(&p[0]);
+    const uint32_t timestamp = clarinet_get32(&p[4]);
+    const uint64_t cookie = clarinet_get64(&p[8]);
+
+    const uint64_t seconds = now / 1000;
+    if (id == 0 || timestamp > seconds || seconds - timestamp > DTLC_COOKIE_LIFETIME)
+        return 0;
+
+    if (dtlc_hash(dp, remote, id, timestamp) != cookie)
+        return 0;
+
+    uint8_t payload[4];
+
+    /* The client retransmits CONNECT until it receives an ACCEPT so the connection may already exist. */
+    clarinet_dtlc_connection* c = dtlc_lookup(dp, remote, id);
+    if (c)
+    {
+        c->last_recv = now;
+        c->last_send = now;
+        clarinet_put32(payload, c->local_id);
+        dtlc_send_control(dp, remote, DTLC_TYPE_ACCEPT, id, payload, sizeof(payload));
+        return 0;
+    }
+
+    c = dtlc_acquire(dp, remote, now);
+    if (!c)
+    {
+        dtlc_send_control(dp, remote, DTLC_TYPE_CLOSE, id, NULL, 0);
+        return 0;
+    }
+
+    c->remote_id = id;
+    c->state = CLARINET_DTLC_STATE_CONNECTED;
+
+    clarinet_dtlc_connection* bucket = dtlc_bucket(dp, remote, id);
+    c->next = bucket->bucket;
+    bucket->bucket = (uint32_t)(c - dp->connections) + 1;
+
+    clarinet_put32(payload, c->local_id);
+    dtlc_send_control(dp, remote, DTLC_TYPE_ACCEPT, id, payload, sizeof(payload));
+
+    event->type = CLARINET_DTLC_EVENT_CONNECT;
+    event->id = c->local_id;
+    clarinet_log(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_DTLC_CONNECT, c->local_id, 0, 0, 0);
+    return 1;
+}
+
+/* endregion */
+
+/* region DTLC */
+
+void
+clarinet_dtlc_init(clarinet_dtlc* dp)
+{
+    memset(dp, 0, sizeof(clarinet_dtlc));
+}
+
+int
+clarinet_dtlc_open(clarinet_dtlc* restrict dp,
+                   clarinet_socket* restrict sp,
+                   clarinet_dtlc_connection* restrict connections,
+                   uint32_t capacity,
+                   const clarinet_dtlc_config* restrict config)
+{
+    if (!dp || clarinet_dtlc_is_open(dp) || !sp || !connections || capacity == 0
+        || capacity > CLARINET_DTLC_CAPACITY_MAX || !config)
+        return CLARINET_EINVAL;
+
+    if (config->keepalive == 0 || config->timeout <= config->keepalive
+        || (config->flags & ~(uint32_t)CLARINET_DTLC_LISTEN))
+        return CLARINET_EINVAL;
+
+    memset(connections, 0, capacity * sizeof(clarinet_dtlc_connection));
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        connections[i].generation = 1;
+        connections[i].next = (i + 1 < capacity) ? i + 2 : 0;
+    }
+
+    dp->socket = sp;
+    dp->connections = connections;
+    dp->capacity = capacity;
+    dp->count = 0;
+    dp->free = 1;
+    dp->active = 0;
+    dp->config = *config;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_dtlc_close(clarinet_dtlc* dp)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp))
+        return CLARINET_EINVAL;
+
+    clarinet_dtlc_init(dp);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_dtlc_connect(clarinet_dtlc* restrict dp,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now,
+                      uint32_t* restrict id)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp) || !remote || !id)
+        return CLARINET_EINVAL;
+
+    clarinet_dtlc_connection* c = dtlc_acquire(dp, remote, now);
+    if (!c)
+        return CLARINET_ENOBUFS;
+
+    c->state = CLARINET_DTLC_STATE_HELLO;
+    const int errcode = dtlc_send_handshake(dp, c, now);
+    if (errcode != CLARINET_ENONE)
+    {
+        dtlc_release(dp, c);
+        return errcode;
+    }
+
+    *id = c->local_id;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_dtlc_disconnect(clarinet_dtlc* dp,
+                         uint32_t id,
+                         uint64_t now)
+{
+    CLARINET_IGNORE_PARAM(now);
+
+    if (!dp || !clarinet_dtlc_is_open(dp))
+        return CLARINET_EINVAL;
+
+    clarinet_dtlc_connection* c = clarinet_dtlc_connection_find(dp, id);
+    if (!c)
+        return CLARINET_ENOTCONN;
+
+    if (c->state == CLARINET_DTLC_STATE_CONNECTED)
+        dtlc_send_control(dp, &c->remote, DTLC_TYPE_CLOSE, c->remote_id, NULL, 0);
+
+    dtlc_release(dp, c);
+    return CLARINET_ENONE;
+}
+
+clarinet_dtlc_connection*
+clarinet_dtlc_connection_find(clarinet_dtlc* dp,
+                              uint32_t id)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp))
+        return NULL;
+
+    const uint32_t slot = clarinet_dtlc_slot(id);
+    if (slot >= dp->capacity)
+        return NULL;
+
+    clarinet_dtlc_connection* c = &dp->connections[slot];
+    return (c->state != CLARINET_DTLC_STATE_FREE && c->local_id == id) ? c : NULL;
+}
+
+int
+clarinet_dtlc_send(clarinet_dtlc* restrict dp,
+                   uint32_t id,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now)
+{
+    if (!buf && buflen > 0)
+        return CLARINET_EINVAL;
+
+    const clarinet_iovec iov = { (void*)buf, buflen };
+    return clarinet_dtlc_sendv(dp, id, &iov, 1, now);
+}
+
+int
+clarinet_dtlc_sendv(clarinet_dtlc* restrict dp,
+                    uint32_t id,
+                    const clarinet_iovec* restrict iov,
+                    size_t iovcnt,
+                    uint64_t now)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp) || (!iov && iovcnt > 0) || iovcnt >= CLARINET_IOVEC_MAX)
+        return CLARINET_EINVAL;
+
+    size_t buflen = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+    {
+        if ((!iov[i].base && iov[i].len > 0) || iov[i].len > INT_MAX - CLARINET_DTLC_HEADER_SIZE - buflen)
+            return CLARINET_EINVAL;
+
+        buflen += iov[i].len;
+    }
+
+    clarinet_dtlc_connection* c = clarinet_dtlc_connection_find(dp, id);
+    if (!c || c->state != CLARINET_DTLC_STATE_CONNECTED)
+        return CLARINET_ENOTCONN;
+
+    uint8_t header[CLARINET_DTLC_HEADER_SIZE];
+    header[0] = (DTLC_VERSION << 4) | DTLC_TYPE_DATA;
+    clarinet_put32(&header[1], c->remote_id);
+
+    clarinet_iovec vec[CLARINET_IOVEC_MAX];
+    vec[0].base = header;
+    vec[0].len = sizeof(header);
+    for (size_t i = 0; i < iovcnt; ++i)
+        vec[i + 1] = iov[i];
+
+    const int n = clarinet_socket_sendtov(dp->socket, vec, iovcnt + 1, &c->remote);
+    if (n < 0)
+        return n;
+
+    c->last_send = now;
+    return n - CLARINET_DTLC_HEADER_SIZE;
+}
+
+int
+clarinet_dtlc_recv(clarinet_dtlc* restrict dp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_dtlc_event* restrict event,
+                   uint64_t now)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp) || !buf || buflen < CLARINET_DTLC_BUFFER_MIN || !event)
+        return CLARINET_EINVAL;
+
+    event->id = 0;
+    event->type = CLARINET_DTLC_EVENT_NONE;
+    event->result = 0;
+
+    /* The header is scattered into a separate buffer so the payload lands in the caller's buffer without a copy.
+     * Control datagrams are parsed straight from the caller's buffer. */
+    uint8_t header[CLARINET_DTLC_HEADER_SIZE];
+    const clarinet_iovec iov[2] = {
+        { header, sizeof(header) },
+        { buf, buflen }
+    };
+
+    clarinet_endpoint remote;
+    const int n = clarinet_socket_recvfromv(dp->socket, iov, 2, &remote);
+    if (n < 0)
+        return n;
+
+    if (n < CLARINET_DTLC_HEADER_SIZE || (header[0] >> 4) != DTLC_VERSION)
+        return CLARINET_ENONE;
+
+    const uint8_t type = header[0] & 0x0F;
+    const uint32_t dst = clarinet_get32(&header[1]);
+    const uint8_t* p = (const uint8_t*)buf;
+    const size_t len = (size_t)n - CLARINET_DTLC_HEADER_SIZE;
+
+    if (dst == 0)
+    {
+        if (!(dp->config.flags & CLARINET_DTLC_LISTEN))
+            return CLARINET_ENONE;
+
+        if (type == DTLC_TYPE_HELLO && (size_t)n >= DTLC_HELLO_SIZE)
+        {
+            const uint32_t id = clarinet_get32(&p[0]);
+            if (id == 0)
+                return CLARINET_ENONE;
+
+            const uint32_t timestamp = (uint32_t)(now / 1000);
+            uint8_t payload[12];
+            clarinet_put32(&payload[0], timestamp);
+            clarinet_put64(&payload[4], dtlc_hash(dp, &remote, id, timestamp));
+            dtlc_send_control(dp, &remote, DTLC_TYPE_COOKIE, id, payload, sizeof(payload));
+        }
+        else if (type == DTLC_TYPE_CONNECT && (size_t)n >= DTLC_CONNECT_SIZE)
+        {
+            dtlc_accept(dp, &remote, p, now, event);
+        }
+
+        return CLARINET_ENONE;
+    }
+
+    clarinet_dtlc_connection* c = dtlc_demux(dp, dst, &remote);
+    if (!c)
+        return CLARINET_ENONE;
+
+    switch (type)
+    {
+        case DTLC_TYPE_DATA:
+            if (c->state != CLARINET_DTLC_STATE_CONNECTED)
+                break;
+
+            c->last_recv = now;
+            event->type = CLARINET_DTLC_EVENT_DATA;
+            event->id = c->local_id;
+            event->result = (int)len;
+            break;
+        case DTLC_TYPE_KEEPALIVE:
+            if (c->state == CLARINET_DTLC_STATE_CONNECTED)
+                c->last_recv = now;
+            break;
+        case DTLC_TYPE_COOKIE:
+            if (c->state != CLARINET_DTLC_STATE_HELLO || (size_t)n < DTLC_COOKIE_SIZE)
+                break;
+
+            c->timestamp = clarinet_get32(&p[0]);
+            c->cookie = clarinet_get64(&p[4]);
+            c->state = CLARINET_DTLC_STATE_COOKIE;
+            dtlc_send_handshake(dp, c, now);
+            break;
+        case DTLC_TYPE_ACCEPT:
+            if ((size_t)n < DTLC_ACCEPT_SIZE || clarinet_get32(&p[0]) == 0)
+                break;
+
+            if (c->state == CLARINET_DTLC_STATE_COOKIE)
+            {
+                c->remote_id = clarinet_get32(&p[0]);
+                c->state = CLARINET_DTLC_STATE_CONNECTED;
+                c->last_recv = now;
+                event->type = CLARINET_DTLC_EVENT_CONNECT;
+                event->id = c->local_id;
+                clarinet_log(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_DTLC_CONNECT, c->local_id, 0, 0, 0);
+            }
+            break;
+        case DTLC_TYPE_CLOSE:
+            event->type = CLARINET_DTLC_EVENT_DISCONNECT;
+            event->id = c->local_id;
+            event->result = (c->state == CLARINET_DTLC_STATE_CONNECTED) ? CLARINET_ECONNRESET : CLARINET_ECONNREFUSED;
+            clarinet_log(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_DTLC_DISCONNECT, c->local_id, event->result, 0, 0);
+            dtlc_release(dp, c);
+            break;
+        default:
+            break;
+    }
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_dtlc_update(clarinet_dtlc* restrict dp,
+                     clarinet_dtlc_event* restrict events,
+                     size_t count,
+                     uint64_t now)
+{
+    if (!dp || !clarinet_dtlc_is_open(dp) || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    /* Only slots in use are visited so the cost of an update does not depend on the capacity. The next slot is read
+     * before the current one is processed because a connection that times out is released. */
+    size_t n = 0;
+    uint32_t next = dp->active;
+    while (next != 0)
+    {
+        clarinet_dtlc_connection* c = &dp->connections[next - 1];
+        next = c->active_next;
+
+        if (dtlc_elapsed(now, c->last_recv) >= dp->config.timeout)
+        {
+            if (n == count)
+                break;
+
+            if (c->state == CLARINET_DTLC_STATE_CONNECTED)
+                dtlc_send_control(dp, &c->remote, DTLC_TYPE_CLOSE, c->remote_id, NULL, 0);
+
+            events[n].type = CLARINET_DTLC_EVENT_DISCONNECT;
+            events[n].id = c->local_id;
+            events[n].result = CLARINET_ECONNTIMEOUT;
+            n++;
+
+            clarinet_log(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_DTLC_DISCONNECT, c->local_id,
+                         CLARINET_ECONNTIMEOUT, 0, 0);
+
+            dtlc_release(dp, c);
+        }
+        else if (c->state == CLARINET_DTLC_STATE_CONNECTED)
+        {
+            if (dtlc_elapsed(now, c->last_send) >= dp->config.keepalive)
+            {
+                c->last_send = now;
+                dtlc_send_control(dp, &c->remote, DTLC_TYPE_KEEPALIVE, c->remote_id, NULL, 0);
+            }
+        }
+        else if (dtlc_elapsed(now, c->last_send) >= DTLC_HANDSHAKE_RETRY)
+        {
+            dtlc_send_handshake(dp, c, now);
+        }
+    }
+
+    return (int)n;
+}
+
+/* endregion */
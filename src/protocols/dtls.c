@@ -1 +1,1059 @@
-#include "compat/compat.h"
\ No newline at end of file
+#include "compat/compat.h"
+#include "compat/bytes.h"
+#include "clarinet/clarinet.h"
+
+#include <string.h>
+
+#if HAVE_MBEDTLS
+#include "mbedtls/version.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cookie.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/platform.h"
+
+/* A DTLS server requires a few optional MbedTLS modules that are enabled in the default configuration. */
+#if defined(MBEDTLS_SSL_PROTO_DTLS) && defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_COOKIE_C) \
+ && defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY) && defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C) \
+ && defined(MBEDTLS_X509_CRT_PARSE_C)
+#define DTLS_SUPPORTED  1
+#endif
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+#define DTLS_CACHE      1
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+#define DTLS_TICKETS    1
+#endif
+
+#endif /* HAVE_MBEDTLS */
+
+#if DTLS_SUPPORTED
+
+/* region Helpers */
+
+#define DTLS_STATE_FREE             0
+#define DTLS_STATE_HANDSHAKE        1
+#define DTLS_STATE_CONNECTED        2
+
+#define DTLS_SLOT_BITS              16
+#define DTLS_SLOT_MASK              ((1u << DTLS_SLOT_BITS) - 1)
+
+/** Largest datagram that can be received. */
+#define DTLS_DATAGRAM_MAX           65536
+
+/** Personalization string for the random generators. */
+#define DTLS_PERSONALIZATION        "clarinet-dtls"
+
+/** Size of the header of a DTLS record and content type of a ChangeCipherSpec record (RFC 6347). */
+#define DTLS_RECORD_HEADER_SIZE     13
+#define DTLS_RECORD_CCS             20
+
+/** Records written by an ssl context since the last reset of the flags. */
+#define DTLS_SENT_FLIGHT            0x01    /**< Any datagram */
+#define DTLS_SENT_CCS               0x02    /**< A datagram with a ChangeCipherSpec record */
+
+struct dtls_cache_context
+{
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    #if DTLS_CACHE
+    mbedtls_ssl_cache_context cache;
+    #endif
+    #if DTLS_TICKETS
+    mbedtls_ssl_ticket_context ticket;
+    #endif
+};
+
+/**
+ * Session state. The ssl context is allocated separately so it never moves when a session is promoted from the
+ * listening slot to a regular slot.
+ */
+struct dtls_session
+{
+    mbedtls_ssl_context* ssl;
+    clarinet_endpoint remote;
+    uint64_t last_recv;
+    uint64_t timer_int;         /**< Absolute time of the intermediate delay (ms) */
+    uint64_t timer_fin;         /**< Absolute time of the final delay (ms) or 0 if the timer is cancelled */
+    const uint8_t* in;          /**< Datagram waiting to be consumed by the ssl context */
+    size_t inlen;
+    uint32_t id;
+    uint32_t next;              /**< Next slot in a hash chain or in the free list */
+    uint32_t active_prev;       /**< Previous slot in the list of slots in use */
+    uint32_t active_next;       /**< Next slot in the list of slots in use */
+    uint16_t generation;
+    uint8_t state;
+    uint8_t resumed;            /**< The handshake in progress resumes a previous session */
+};
+
+struct dtls_context
+{
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_ssl_config conf;
+    mbedtls_x509_crt cert;
+    mbedtls_pk_context key;
+    mbedtls_ssl_cookie_ctx cookie;
+    clarinet_dtls* dp;
+    struct dtls_cache_context* cache;
+    struct dtls_session* current;   /**< Session the ssl callbacks operate on */
+    struct dtls_session* backlog;   /**< Session with decrypted records pending */
+    struct dtls_session listener;   /**< Session used for the stateless cookie exchange with new clients */
+    uint64_t now;
+    uint32_t timeout;
+    uint32_t capacity;
+    uint32_t free;
+    uint32_t active;                /**< Head of the list of slots in use */
+    uint32_t cursor;                /**< Slot in use where the next update starts or 0 to start at the head */
+    uint32_t pending_max;
+    uint8_t sent;                   /**< Records written by the ssl callbacks (DTLS_SENT_*) */
+    uint32_t* buckets;
+    uint32_t* pending;              /**< Number of sessions in handshake per source address hash */
+    struct dtls_session* sessions;
+    uint8_t rx[DTLS_DATAGRAM_MAX];
+};
+
+/** Helper to serialize the significant bytes of an endpoint. Used as client transport id and hash key. */
+CLARINET_STATIC_INLINE
+size_t
+dtls_endpoint_key(const clarinet_endpoint* restrict endpoint,
+                  uint8_t* restrict key)
+{
+    size_t n = 0;
+    key[n++] = (uint8_t)(endpoint->addr.family >> 8);
+    key[n++] = (uint8_t)endpoint->addr.family;
+    key[n++] = (uint8_t)(endpoint->port >> 8);
+    key[n++] = (uint8_t)endpoint->port;
+    if (clarinet_addr_is_ipv6(&endpoint->addr))
+    {
+        memcpy(&key[n], endpoint->addr.as.ipv6.u.byte, 16);
+        n += 16;
+        memcpy(&key[n], &endpoint->addr.as.ipv6.scope_id, 4);
+        n += 4;
+    }
+    else
+    {
+        memcpy(&key[n], &endpoint->addr.as.ipv6.u.dword[3], 4);
+        n += 4;
+    }
+
+    return n;
+}
+
+/** Helper to hash @p n bytes of a key (FNV-1a). */
+CLARINET_STATIC_INLINE
+uint32_t
+dtls_hash(const uint8_t* key,
+          size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i)
+        h = (h ^ key[i]) * 16777619u;
+
+    return h;
+}
+
+/** Helper to find the hash bucket of an endpoint. */
+CLARINET_STATIC_INLINE
+uint32_t*
+dtls_bucket(struct dtls_context* restrict ctx,
+            const clarinet_endpoint* restrict endpoint)
+{
+    uint8_t key[32];
+    const size_t n = dtls_endpoint_key(endpoint, key);
+    return &ctx->buckets[dtls_hash(key, n) % ctx->capacity];
+}
+
+/**
+ * Helper to find the counter of sessions in handshake of the source address of an endpoint. The port is left out so a
+ * single host cannot take over the session table by opening handshakes from many ports. Addresses that collide share
+ * a counter which can only make the limit stricter.
+ */
+CLARINET_STATIC_INLINE
+uint32_t*
+dtls_pending(struct dtls_context* restrict ctx,
+             const clarinet_endpoint* restrict endpoint)
+{
+    const clarinet_endpoint source = clarinet_make_endpoint(endpoint->addr, 0);
+    uint8_t key[32];
+    const size_t n = dtls_endpoint_key(&source, key);
+    return &ctx->pending[dtls_hash(key, n) % ctx->capacity];
+}
+
+/** Helper to change the state of a session keeping the number of sessions in handshake per source address. */
+CLARINET_STATIC_INLINE
+void
+dtls_transition(struct dtls_context* restrict ctx,
+                struct dtls_session* restrict s,
+                uint8_t state)
+{
+    if (s->state == DTLS_STATE_HANDSHAKE)
+        (*dtls_pending(ctx, &s->remote))--;
+
+    if (state == DTLS_STATE_HANDSHAKE)
+        (*dtls_pending(ctx, &s->remote))++;
+
+    s->state = state;
+}
+
+/**
+ * Helper to check that a call to mbedtls_ssl_handshake() that returned @p ret accepted the ClientHello, which only
+ * happens after the client returned a valid cookie. The server then writes its first flight and waits for the client.
+ * A datagram that is not a valid ClientHello is silently discarded by MbedTLS without writing anything and a
+ * ClientHello without a valid cookie fails with MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED. Relies on the return code and
+ * the datagrams written only so the private handshake state of the ssl context is never read.
+ */
+CLARINET_STATIC_INLINE
+int
+dtls_hello_accepted(const struct dtls_context* ctx,
+                    int ret)
+{
+    return (ret == 0 || ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+           && (ctx->sent & DTLS_SENT_FLIGHT);
+}
+
+/**
+ * Helper to check if a handshake that just accepted the ClientHello resumes a session. The abbreviated handshake sends
+ * the ServerHello, ChangeCipherSpec and Finished in a single flight while the first flight of a full handshake has no
+ * ChangeCipherSpec.
+ */
+CLARINET_STATIC_INLINE
+int
+dtls_hello_resumed(const struct dtls_context* ctx)
+{
+    return (ctx->sent & DTLS_SENT_CCS) != 0;
+}
+
+/** Helper to find the flags of the records in a datagram written by an ssl context. */
+static
+uint8_t
+dtls_records(const uint8_t* buf,
+             size_t len)
+{
+    uint8_t sent = DTLS_SENT_FLIGHT;
+    size_t offset = 0;
+    while (offset + DTLS_RECORD_HEADER_SIZE <= len)
+    {
+        if (buf[offset] == DTLS_RECORD_CCS)
+            sent |= DTLS_SENT_CCS;
+
+        offset += DTLS_RECORD_HEADER_SIZE + clarinet_get16(&buf[offset + DTLS_RECORD_HEADER_SIZE - 2]);
+    }
+
+    return sent;
+}
+
+static
+struct dtls_session*
+dtls_lookup(struct dtls_context* restrict ctx,
+            const clarinet_endpoint* restrict remote)
+{
+    uint32_t next = *dtls_bucket(ctx, remote);
+    while (next != 0)
+    {
+        struct dtls_session* s = &ctx->sessions[next - 1];
+        if (clarinet_endpoint_is_equal(&s->remote, remote))
+            return s;
+
+        next = s->next;
+    }
+
+    return NULL;
+}
+
+static
+struct dtls_session*
+dtls_find(struct dtls_context* ctx,
+          uint32_t id)
+{
+    const uint32_t slot = id & DTLS_SLOT_MASK;
+    if (slot >= ctx->capacity)
+        return NULL;
+
+    struct dtls_session* s = &ctx->sessions[slot];
+    return (s->state != DTLS_STATE_FREE && s->id == id) ? s : NULL;
+}
+
+/** Helper to translate an MbedTLS error raised by a read or write into an error code. */
+CLARINET_STATIC_INLINE
+int
+dtls_error(int ret)
+{
+    switch (ret)
+    {
+        case MBEDTLS_ERR_SSL_WANT_READ:
+        case MBEDTLS_ERR_SSL_WANT_WRITE:
+            return CLARINET_EAGAIN;
+        case MBEDTLS_ERR_SSL_BAD_INPUT_DATA:
+            return CLARINET_EMSGSIZE;
+        case MBEDTLS_ERR_SSL_TIMEOUT:
+            return CLARINET_ECONNTIMEOUT;
+        case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
+            return CLARINET_ECONNRESET;
+        default:
+            return CLARINET_EPROTO;
+    }
+}
+
+/* region Callbacks */
+
+static
+int
+dtls_bio_send(void* p,
+              const unsigned char* buf,
+              size_t len)
+{
+    struct dtls_context* ctx = (struct dtls_context*)p;
+    ctx->sent |= dtls_records(buf, len);
+
+    const int n = clarinet_socket_sendto(ctx->dp->socket, buf, len, &ctx->current->remote);
+    if (n >= 0)
+        return n;
+
+    return (n == CLARINET_EAGAIN) ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+}
+
+static
+int
+dtls_bio_recv(void* p,
+              unsigned char* buf,
+              size_t len)
+{
+    struct dtls_context* ctx = (struct dtls_context*)p;
+    struct dtls_session* s = ctx->current;
+    if (!s->in)
+        return MBEDTLS_ERR_SSL_WANT_READ;
+
+    const uint8_t* in = s->in;
+    const size_t inlen = s->inlen;
+    s->in = NULL;
+    s->inlen = 0;
+
+    /* A datagram larger than the input buffer of the ssl context cannot contain a valid record. */
+    if (inlen > len)
+        return MBEDTLS_ERR_SSL_WANT_READ;
+
+    memcpy(buf, in, inlen);
+    return (int)inlen;
+}
+
+static
+void
+dtls_timer_set(void* p,
+               uint32_t int_ms,
+               uint32_t fin_ms)
+{
+    struct dtls_context* ctx = (struct dtls_context*)p;
+    struct dtls_session* s = ctx->current;
+    if (fin_ms == 0)
+    {
+        s->timer_fin = 0;
+        return;
+    }
+
+    s->timer_int = ctx->now + int_ms;
+    s->timer_fin = ctx->now + fin_ms;
+}
+
+static
+int
+dtls_timer_get(void* p)
+{
+    struct dtls_context* ctx = (struct dtls_context*)p;
+    const struct dtls_session* s = ctx->current;
+    if (s->timer_fin == 0)
+        return -1;
+
+    if (ctx->now >= s->timer_fin)
+        return 2;
+
+    return (ctx->now >= s->timer_int) ? 1 : 0;
+}
+
+/* endregion */
+
+/** Helper to allocate and set up the ssl context of a session. */
+static
+int
+dtls_session_setup(struct dtls_context* restrict ctx,
+                   struct dtls_session* restrict s)
+{
+    mbedtls_ssl_context* ssl = mbedtls_calloc(1, sizeof(mbedtls_ssl_context));
+    if (!ssl)
+        return CLARINET_ENOMEM;
+
+    mbedtls_ssl_init(ssl);
+    if (mbedtls_ssl_setup(ssl, &ctx->conf) != 0)
+    {
+        mbedtls_ssl_free(ssl);
+        mbedtls_free(ssl);
+        return CLARINET_ENOMEM;
+    }
+
+    ctx->current = s;
+    s->ssl = ssl;
+    s->timer_fin = 0;
+    mbedtls_ssl_set_bio(ssl, ctx, dtls_bio_send, dtls_bio_recv, NULL);
+    mbedtls_ssl_set_timer_cb(ssl, ctx, dtls_timer_set, dtls_timer_get);
+    return CLARINET_ENONE;
+}
+
+/** Helper to release the ssl context of a session. */
+static
+void
+dtls_session_free(struct dtls_session* s)
+{
+    if (s->ssl)
+    {
+        mbedtls_ssl_free(s->ssl);
+        mbedtls_free(s->ssl);
+        s->ssl = NULL;
+    }
+}
+
+/** Helper to return a session slot to the free list. The generation is advanced so the old id becomes stale. */
+static
+void
+dtls_release(struct dtls_context* restrict ctx,
+             struct dtls_session* restrict s)
+{
+    const uint32_t index = (uint32_t)(s - ctx->sessions) + 1;
+    uint32_t* link = dtls_bucket(ctx, &s->remote);
+    while (*link != 0)
+    {
+        if (*link == index)
+        {
+            *link = s->next;
+            break;
+        }
+
+        link = &ctx->sessions[*link - 1].next;
+    }
+
+    if (ctx->backlog == s)
+        ctx->backlog = NULL;
+
+    if (ctx->cursor == index)
+        ctx->cursor = s->active_next;
+
+    if (s->active_prev != 0)
+        ctx->sessions[s->active_prev - 1].active_next = s->active_next;
+    else
+        ctx->active = s->active_next;
+
+    if (s->active_next != 0)
+        ctx->sessions[s->active_next - 1].active_prev = s->active_prev;
+
+    s->active_prev = 0;
+    s->active_next = 0;
+
+    dtls_session_free(s);
+    dtls_transition(ctx, s, DTLS_STATE_FREE);
+
+    s->generation++;
+    if (s->generation == 0)
+        s->generation = 1;
+
+    s->id = 0;
+    s->in = NULL;
+    s->next = ctx->free;
+    ctx->free = index;
+    ctx->dp->count--;
+}
+
+/** Helper to report a completed handshake. */
+static
+void
+dtls_connected(struct dtls_context* restrict ctx,
+               struct dtls_session* restrict s,
+               clarinet_dtls_event* restrict event)
+{
+    dtls_transition(ctx, s, DTLS_STATE_CONNECTED);
+    ctx->dp->handshakes++;
+    if (s->resumed)
+        ctx->dp->resumptions++;
+
+    event->type = CLARINET_DTLS_EVENT_CONNECT;
+    event->id = s->id;
+}
+
+/** Helper to advance the handshake of a session. */
+static
+void
+dtls_handshake(struct dtls_context* restrict ctx,
+               struct dtls_session* restrict s,
+               clarinet_dtls_event* restrict event)
+{
+    ctx->current = s;
+    const int ret = mbedtls_ssl_handshake(s->ssl);
+    if (ret == 0)
+    {
+        dtls_connected(ctx, s, event);
+    }
+    else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        event->type = CLARINET_DTLS_EVENT_DISCONNECT;
+        event->id = s->id;
+        event->result = (ret == MBEDTLS_ERR_SSL_TIMEOUT) ? CLARINET_ECONNTIMEOUT : CLARINET_EPROTO;
+        dtls_release(ctx, s);
+    }
+}
+
+/** Helper to read a record from an established session. */
+static
+void
+dtls_read(struct dtls_context* restrict ctx,
+          struct dtls_session* restrict s,
+          void* restrict buf,
+          size_t buflen,
+          clarinet_dtls_event* restrict event)
+{
+    ctx->current = s;
+    const int ret = mbedtls_ssl_read(s->ssl, buf, buflen);
+    if (ret > 0)
+    {
+        event->type = CLARINET_DTLS_EVENT_DATA;
+        event->id = s->id;
+        event->result = ret;
+
+        /* More records from the same datagram are returned by the next call */
+        if (mbedtls_ssl_check_pending(s->ssl))
+            ctx->backlog = s;
+
+        return;
+    }
+
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        return;
+
+    event->type = CLARINET_DTLS_EVENT_DISCONNECT;
+    event->id = s->id;
+    event->result = (ret == 0) ? CLARINET_ECONNRESET : dtls_error(ret);
+
+    if (ret == MBEDTLS_ERR_SSL_CLIENT_RECONNECT)
+    {
+        /* The client started a new handshake from the same endpoint and passed the cookie exchange. The session is
+         * reported lost and the slot continues with a new id. */
+        event->result = CLARINET_ECONNRESET;
+        s->generation++;
+        if (s->generation == 0)
+            s->generation = 1;
+
+        s->id = ((uint32_t)s->generation << DTLS_SLOT_BITS) | (uint32_t)(s - ctx->sessions);
+
+        /* The handshake counts against the limit of the source address like one that starts from the listener. */
+        if (*dtls_pending(ctx, &s->remote) < ctx->pending_max)
+        {
+            dtls_transition(ctx, s, DTLS_STATE_HANDSHAKE);
+            ctx->sent = 0;
+            const int hs = mbedtls_ssl_handshake(s->ssl);
+            if (hs != 0 && dtls_hello_accepted(ctx, hs))
+            {
+                s->resumed = (uint8_t)dtls_hello_resumed(ctx);
+                return;
+            }
+        }
+    }
+
+    dtls_release(ctx, s);
+}
+
+/** Helper to process a datagram from an unknown endpoint with the listening session. */
+static
+void
+dtls_listen(struct dtls_context* restrict ctx,
+            const clarinet_endpoint* restrict remote,
+            size_t n,
+            clarinet_dtls_event* restrict event)
+{
+    /* No point in answering a client that cannot be served. */
+    if (ctx->free == 0 || *dtls_pending(ctx, remote) >= ctx->pending_max)
+        return;
+
+    struct dtls_session* listener = &ctx->listener;
+    if (!listener->ssl && dtls_session_setup(ctx, listener) != CLARINET_ENONE)
+        return;
+
+    ctx->current = listener;
+    listener->remote = *remote;
+    listener->in = ctx->rx;
+    listener->inlen = n;
+    listener->last_recv = ctx->now;
+
+    uint8_t key[32];
+    const size_t keylen = dtls_endpoint_key(remote, key);
+    ctx->sent = 0;
+    int ret = mbedtls_ssl_set_client_transport_id(listener->ssl, key, keylen);
+    if (ret == 0)
+        ret = mbedtls_ssl_handshake(listener->ssl);
+
+    /* Only a ClientHello with a valid cookie moves the handshake past the ClientHello. Anything else, including
+     * MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED after a cookie was sent and datagrams that MbedTLS silently discards,
+     * leaves nothing behind about the client. */
+    if (!dtls_hello_accepted(ctx, ret))
+    {
+        listener->in = NULL;
+        mbedtls_ssl_session_reset(listener->ssl);
+        return;
+    }
+
+    /* The client returned a valid cookie so the handshake moves to a session slot. */
+    const uint32_t slot = ctx->free - 1;
+    struct dtls_session* s = &ctx->sessions[slot];
+    ctx->free = s->next;
+
+    const uint16_t generation = s->generation;
+    *s = *listener;
+    s->generation = generation;
+    s->id = ((uint32_t)generation << DTLS_SLOT_BITS) | slot;
+    s->state = DTLS_STATE_FREE;
+    s->resumed = (uint8_t)dtls_hello_resumed(ctx);
+    s->in = NULL;
+    dtls_transition(ctx, s, DTLS_STATE_HANDSHAKE);
+
+    uint32_t* bucket = dtls_bucket(ctx, remote);
+    s->next = *bucket;
+    *bucket = slot + 1;
+
+    s->active_prev = 0;
+    s->active_next = ctx->active;
+    if (ctx->active != 0)
+        ctx->sessions[ctx->active - 1].active_prev = slot + 1;
+    ctx->active = slot + 1;
+    ctx->dp->count++;
+
+    listener->ssl = NULL;
+    ctx->current = s;
+
+    if (ret == 0)
+        dtls_connected(ctx, s, event);
+}
+
+static
+void
+dtls_context_free(struct dtls_context* ctx)
+{
+    for (uint32_t i = 0; i < ctx->capacity; ++i)
+        dtls_session_free(&ctx->sessions[i]);
+
+    dtls_session_free(&ctx->listener);
+    mbedtls_ssl_cookie_free(&ctx->cookie);
+    mbedtls_ssl_config_free(&ctx->conf);
+    mbedtls_pk_free(&ctx->key);
+    mbedtls_x509_crt_free(&ctx->cert);
+    mbedtls_ctr_drbg_free(&ctx->drbg);
+    mbedtls_entropy_free(&ctx->entropy);
+    mbedtls_free(ctx);
+}
+
+/* endregion */
+
+#endif /* DTLS_SUPPORTED */
+
+/* region DTLS */
+
+void
+clarinet_dtls_cache_init(clarinet_dtls_cache* cache)
+{
+    memset(cache, 0, sizeof(clarinet_dtls_cache));
+}
+
+int
+clarinet_dtls_cache_open(clarinet_dtls_cache* cache,
+                         uint32_t entries,
+                         uint32_t lifetime)
+{
+    if (!cache || cache->context || entries == 0 || entries > INT_MAX || lifetime == 0 || lifetime > INT_MAX)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED && (DTLS_CACHE || DTLS_TICKETS)
+    struct dtls_cache_context* ctx = mbedtls_calloc(1, sizeof(struct dtls_cache_context));
+    if (!ctx)
+        return CLARINET_ENOMEM;
+
+    mbedtls_entropy_init(&ctx->entropy);
+    mbedtls_ctr_drbg_init(&ctx->drbg);
+    int ret = mbedtls_ctr_drbg_seed(&ctx->drbg, mbedtls_entropy_func, &ctx->entropy,
+                                    (const unsigned char*)DTLS_PERSONALIZATION, sizeof(DTLS_PERSONALIZATION) - 1);
+
+    #if DTLS_CACHE
+    mbedtls_ssl_cache_init(&ctx->cache);
+    mbedtls_ssl_cache_set_max_entries(&ctx->cache, (int)entries);
+    mbedtls_ssl_cache_set_timeout(&ctx->cache, (int)lifetime);
+    #endif
+
+    #if DTLS_TICKETS
+    mbedtls_ssl_ticket_init(&ctx->ticket);
+    if (ret == 0)
+        ret = mbedtls_ssl_ticket_setup(&ctx->ticket, mbedtls_ctr_drbg_random, &ctx->drbg, MBEDTLS_CIPHER_AES_256_GCM,
+                                       lifetime);
+    #endif
+
+    if (ret != 0)
+    {
+        cache->context = ctx;
+        clarinet_dtls_cache_close(cache);
+        return CLARINET_ESYS;
+    }
+
+    cache->context = ctx;
+    return CLARINET_ENONE;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_cache_close(clarinet_dtls_cache* cache)
+{
+    if (!cache || !cache->context)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED && (DTLS_CACHE || DTLS_TICKETS)
+    struct dtls_cache_context* ctx = (struct dtls_cache_context*)cache->context;
+    #if DTLS_TICKETS
+    mbedtls_ssl_ticket_free(&ctx->ticket);
+    #endif
+    #if DTLS_CACHE
+    mbedtls_ssl_cache_free(&ctx->cache);
+    #endif
+    mbedtls_ctr_drbg_free(&ctx->drbg);
+    mbedtls_entropy_free(&ctx->entropy);
+    mbedtls_free(ctx);
+    #endif
+
+    clarinet_dtls_cache_init(cache);
+    return CLARINET_ENONE;
+}
+
+void
+clarinet_dtls_init(clarinet_dtls* dp)
+{
+    memset(dp, 0, sizeof(clarinet_dtls));
+}
+
+int
+clarinet_dtls_open(clarinet_dtls* restrict dp,
+                   clarinet_socket* restrict sp,
+                   const clarinet_dtls_config* restrict config)
+{
+    if (!dp || dp->context || !sp || !config)
+        return CLARINET_EINVAL;
+
+    if (!config->cert || config->certlen == 0 || !config->key || config->keylen == 0
+        || config->capacity == 0 || config->capacity > CLARINET_DTLS_CAPACITY_MAX
+        || config->retry_min == 0 || config->retry_max < config->retry_min || config->timeout == 0
+        || (config->cache && !config->cache->context))
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    const size_t size = sizeof(struct dtls_context)
+                        + config->capacity * sizeof(struct dtls_session)
+                        + config->capacity * sizeof(uint32_t) * 2;
+
+    struct dtls_context* ctx = mbedtls_calloc(1, size);
+    if (!ctx)
+        return CLARINET_ENOMEM;
+
+    ctx->sessions = (struct dtls_session*)(ctx + 1);
+    ctx->buckets = (uint32_t*)(ctx->sessions + config->capacity);
+    ctx->pending = ctx->buckets + config->capacity;
+    ctx->pending_max = config->pending ? config->pending : CLARINET_DTLS_PENDING_DEFAULT;
+    ctx->capacity = config->capacity;
+    ctx->timeout = config->timeout;
+    ctx->cache = config->cache ? (struct dtls_cache_context*)config->cache->context : NULL;
+    ctx->dp = dp;
+
+    for (uint32_t i = 0; i < ctx->capacity; ++i)
+    {
+        ctx->sessions[i].generation = 1;
+        ctx->sessions[i].next = (i + 1 < ctx->capacity) ? i + 2 : 0;
+    }
+    ctx->free = 1;
+
+    mbedtls_entropy_init(&ctx->entropy);
+    mbedtls_ctr_drbg_init(&ctx->drbg);
+    mbedtls_ssl_config_init(&ctx->conf);
+    mbedtls_x509_crt_init(&ctx->cert);
+    mbedtls_pk_init(&ctx->key);
+    mbedtls_ssl_cookie_init(&ctx->cookie);
+
+    int errcode = CLARINET_ENONE;
+    if (mbedtls_ctr_drbg_seed(&ctx->drbg, mbedtls_entropy_func, &ctx->entropy,
+                              (const unsigned char*)DTLS_PERSONALIZATION, sizeof(DTLS_PERSONALIZATION) - 1) != 0)
+    {
+        errcode = CLARINET_ESYS;
+        goto failure;
+    }
+
+    #if MBEDTLS_VERSION_MAJOR >= 3
+    const int keyret = mbedtls_pk_parse_key(&ctx->key, config->key, config->keylen, NULL, 0,
+                                            mbedtls_ctr_drbg_random, &ctx->drbg);
+    #else
+    const int keyret = mbedtls_pk_parse_key(&ctx->key, config->key, config->keylen, NULL, 0);
+    #endif
+    if (mbedtls_x509_crt_parse(&ctx->cert, config->cert, config->certlen) != 0 || keyret != 0)
+    {
+        errcode = CLARINET_EINVAL;
+        goto failure;
+    }
+
+    if (mbedtls_ssl_config_defaults(&ctx->conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0
+        || mbedtls_ssl_conf_own_cert(&ctx->conf, &ctx->cert, &ctx->key) != 0
+        || mbedtls_ssl_cookie_setup(&ctx->cookie, mbedtls_ctr_drbg_random, &ctx->drbg) != 0)
+    {
+        errcode = CLARINET_ENOMEM;
+        goto failure;
+    }
+
+    mbedtls_ssl_conf_rng(&ctx->conf, mbedtls_ctr_drbg_random, &ctx->drbg);
+    mbedtls_ssl_conf_handshake_timeout(&ctx->conf, config->retry_min, config->retry_max);
+    mbedtls_ssl_conf_dtls_cookies(&ctx->conf, mbedtls_ssl_cookie_write, mbedtls_ssl_cookie_check, &ctx->cookie);
+
+    if (ctx->cache)
+    {
+        #if DTLS_CACHE
+        mbedtls_ssl_conf_session_cache(&ctx->conf, &ctx->cache->cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+        #endif
+        #if DTLS_TICKETS
+        mbedtls_ssl_conf_session_tickets_cb(&ctx->conf, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse,
+                                            &ctx->cache->ticket);
+        #endif
+    }
+
+    dp->socket = sp;
+    dp->context = ctx;
+    dp->count = 0;
+    dp->handshakes = 0;
+    dp->resumptions = 0;
+    return CLARINET_ENONE;
+
+failure:
+    dtls_context_free(ctx);
+    return errcode;
+    #else
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_close(clarinet_dtls* dp)
+{
+    if (!dp || !dp->context)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    dtls_context_free((struct dtls_context*)dp->context);
+    #endif
+
+    clarinet_dtls_init(dp);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_dtls_disconnect(clarinet_dtls* dp,
+                         uint32_t id,
+                         uint64_t now)
+{
+    if (!dp || !dp->context)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    struct dtls_context* ctx = (struct dtls_context*)dp->context;
+    ctx->now = now;
+
+    struct dtls_session* s = dtls_find(ctx, id);
+    if (!s)
+        return CLARINET_ENOTCONN;
+
+    ctx->current = s;
+    if (s->state == DTLS_STATE_CONNECTED)
+        mbedtls_ssl_close_notify(s->ssl);
+
+    dtls_release(ctx, s);
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(id);
+    CLARINET_IGNORE_PARAM(now);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_remote_endpoint(clarinet_dtls* restrict dp,
+                              uint32_t id,
+                              clarinet_endpoint* restrict remote)
+{
+    if (!dp || !dp->context || !remote)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    const struct dtls_session* s = dtls_find((struct dtls_context*)dp->context, id);
+    if (!s)
+        return CLARINET_ENOTCONN;
+
+    *remote = s->remote;
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(id);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_send(clarinet_dtls* restrict dp,
+                   uint32_t id,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now)
+{
+    if (!dp || !dp->context || !buf || buflen == 0 || buflen > INT_MAX)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    struct dtls_context* ctx = (struct dtls_context*)dp->context;
+    ctx->now = now;
+
+    struct dtls_session* s = dtls_find(ctx, id);
+    if (!s || s->state != DTLS_STATE_CONNECTED)
+        return CLARINET_ENOTCONN;
+
+    ctx->current = s;
+    const int ret = mbedtls_ssl_write(s->ssl, (const unsigned char*)buf, buflen);
+    return (ret >= 0) ? ret : dtls_error(ret);
+    #else
+    CLARINET_IGNORE_PARAM(id);
+    CLARINET_IGNORE_PARAM(now);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_recv(clarinet_dtls* restrict dp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_dtls_event* restrict event,
+                   uint64_t now)
+{
+    if (!dp || !dp->context || !buf || buflen == 0 || buflen > INT_MAX || !event)
+        return CLARINET_EINVAL;
+
+    event->id = 0;
+    event->type = CLARINET_DTLS_EVENT_NONE;
+    event->result = 0;
+
+    #if DTLS_SUPPORTED
+    struct dtls_context* ctx = (struct dtls_context*)dp->context;
+    ctx->now = now;
+
+    /* Records left from a previous datagram are returned before another datagram is read. */
+    if (ctx->backlog)
+    {
+        struct dtls_session* s = ctx->backlog;
+        ctx->backlog = NULL;
+        dtls_read(ctx, s, buf, buflen, event);
+        return CLARINET_ENONE;
+    }
+
+    clarinet_endpoint remote;
+    const int n = clarinet_socket_recvfrom(dp->socket, ctx->rx, sizeof(ctx->rx), &remote);
+    if (n < 0)
+        return n;
+
+    struct dtls_session* s = dtls_lookup(ctx, &remote);
+    if (!s)
+    {
+        dtls_listen(ctx, &remote, (size_t)n, event);
+        return CLARINET_ENONE;
+    }
+
+    s->in = ctx->rx;
+    s->inlen = (size_t)n;
+    s->last_recv = now;
+    if (s->state == DTLS_STATE_HANDSHAKE)
+        dtls_handshake(ctx, s, event);
+    else
+        dtls_read(ctx, s, buf, buflen, event);
+
+    return CLARINET_ENONE;
+    #else
+    CLARINET_IGNORE_PARAM(now);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+int
+clarinet_dtls_update(clarinet_dtls* restrict dp,
+                     clarinet_dtls_event* restrict events,
+                     size_t count,
+                     uint64_t now)
+{
+    if (!dp || !dp->context || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    #if DTLS_SUPPORTED
+    struct dtls_context* ctx = (struct dtls_context*)dp->context;
+    ctx->now = now;
+
+    /* Only slots in use are visited so the cost of an update does not depend on the capacity. When the events run out
+     * the next update resumes where this one stopped so every session is eventually visited. The list is walked as a
+     * ring from the cursor and the next slot is read before the current one is processed because a session that
+     * times out is released. */
+    size_t n = 0;
+    uint32_t remaining = dp->count;
+    uint32_t next = ctx->cursor;
+    while (remaining > 0 && n < count)
+    {
+        if (next == 0)
+            next = ctx->active;
+
+        if (next == 0)
+            break;
+
+        struct dtls_session* s = &ctx->sessions[next - 1];
+        next = s->active_next;
+        remaining--;
+
+        clarinet_dtls_event* event = &events[n];
+        event->id = 0;
+        event->type = CLARINET_DTLS_EVENT_NONE;
+        event->result = 0;
+
+        if (now >= s->last_recv + ctx->timeout)
+        {
+            ctx->current = s;
+            if (s->state == DTLS_STATE_CONNECTED)
+                mbedtls_ssl_close_notify(s->ssl);
+
+            event->type = CLARINET_DTLS_EVENT_DISCONNECT;
+            event->id = s->id;
+            event->result = CLARINET_ECONNTIMEOUT;
+            dtls_release(ctx, s);
+        }
+        else if (s->state == DTLS_STATE_HANDSHAKE && s->timer_fin != 0 && now >= s->timer_int)
+        {
+            /* Retransmits the last flight or fails with MBEDTLS_ERR_SSL_TIMEOUT after the maximum timeout. */
+            dtls_handshake(ctx, s, event);
+        }
+
+        if (event->type != CLARINET_DTLS_EVENT_NONE)
+            n++;
+    }
+
+    ctx->cursor = next;
+    return (int)n;
+    #else
+    CLARINET_IGNORE_PARAM(now);
+    return CLARINET_ENOTSUP;
+    #endif
+}
+
+/* endregion */
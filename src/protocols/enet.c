@@ -0,0 +1,1420 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/log.h"
+#include "compat/bytes.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+/**
+ * Wire format of ENet 1.3 (enet/protocol.h). All integers are in network byte order. A datagram starts with a protocol
+ * header followed by one or more commands:
+ *
+ *      peer id:16 [| sent time:16] | command header | command fields [| payload] | command header | ...
+ *
+ * The high bits of the peer id carry the header flags and the session id. The sent time is only present when the
+ * SENT_TIME flag is set, which is the case for datagrams carrying reliable commands. Every command starts with:
+ *
+ *      command:8 | channel id:8 | reliable sequence number:16
+ *
+ * where the high bits of the command carry the ACKNOWLEDGE and UNSEQUENCED flags.
+ */
+#define ENET_CMD_NONE                       0
+#define ENET_CMD_ACKNOWLEDGE                1
+#define ENET_CMD_CONNECT                    2
+#define ENET_CMD_VERIFY_CONNECT             3
+#define ENET_CMD_DISCONNECT                 4
+#define ENET_CMD_PING                       5
+#define ENET_CMD_SEND_RELIABLE              6
+#define ENET_CMD_SEND_UNRELIABLE            7
+#define ENET_CMD_SEND_FRAGMENT              8
+#define ENET_CMD_SEND_UNSEQUENCED           9
+#define ENET_CMD_BANDWIDTH_LIMIT            10
+#define ENET_CMD_THROTTLE_CONFIGURE         11
+#define ENET_CMD_SEND_UNRELIABLE_FRAGMENT   12
+#define ENET_CMD_COUNT                      13
+#define ENET_CMD_MASK                       0x0F
+
+#define ENET_FLAG_ACKNOWLEDGE               0x80
+#define ENET_FLAG_UNSEQUENCED               0x40
+
+#define ENET_HEADER_FLAG_COMPRESSED         0x4000
+#define ENET_HEADER_FLAG_SENT_TIME          0x8000
+#define ENET_HEADER_FLAG_MASK               (ENET_HEADER_FLAG_COMPRESSED | ENET_HEADER_FLAG_SENT_TIME)
+#define ENET_HEADER_SESSION_MASK            0x3000
+#define ENET_HEADER_SESSION_SHIFT           12
+#define ENET_HEADER_SIZE                    4
+#define ENET_HEADER_SIZE_MIN                2
+
+#define ENET_PEER_ID_MAX                    0xFFF
+#define ENET_SYSTEM_CHANNEL                 0xFF
+#define ENET_SESSION_NONE                   0xFF
+#define ENET_CHANNEL_COUNT_MAX              255
+
+#define ENET_WINDOW_SIZE_MIN                4096
+#define ENET_WINDOW_SIZE_MAX                65536
+
+#define ENET_THROTTLE_INTERVAL              5000
+#define ENET_THROTTLE_ACCELERATION          2
+#define ENET_THROTTLE_DECELERATION          2
+
+#define ENET_UNSEQUENCED_WINDOW_SIZE        1024
+#define ENET_UNSEQUENCED_FREE_WINDOWS       32
+
+#define ENET_ACK_SIZE                       8
+#define ENET_CONNECT_SIZE                   48
+#define ENET_VERIFY_CONNECT_SIZE            44
+#define ENET_DISCONNECT_SIZE                8
+#define ENET_PING_SIZE                      4
+#define ENET_SEND_RELIABLE_SIZE             6
+#define ENET_SEND_UNRELIABLE_SIZE           8
+#define ENET_SEND_FRAGMENT_SIZE             24
+#define ENET_SEND_UNSEQUENCED_SIZE          8
+
+/** Maximum exponent of the retransmission backoff. */
+#define ENET_BACKOFF_MAX                    4
+
+/** Size in bytes of every command indexed by command number (sizeof of the ENetProtocol* structures). */
+static const uint8_t enet_command_sizes[ENET_CMD_COUNT] = {
+    0,                              /* NONE */
+    ENET_ACK_SIZE,                  /* ACKNOWLEDGE */
+    ENET_CONNECT_SIZE,              /* CONNECT */
+    ENET_VERIFY_CONNECT_SIZE,       /* VERIFY_CONNECT */
+    ENET_DISCONNECT_SIZE,           /* DISCONNECT */
+    ENET_PING_SIZE,                 /* PING */
+    ENET_SEND_RELIABLE_SIZE,        /* SEND_RELIABLE */
+    ENET_SEND_UNRELIABLE_SIZE,      /* SEND_UNRELIABLE */
+    ENET_SEND_FRAGMENT_SIZE,        /* SEND_FRAGMENT */
+    ENET_SEND_UNSEQUENCED_SIZE,     /* SEND_UNSEQUENCED */
+    12,                             /* BANDWIDTH_LIMIT */
+    16,                             /* THROTTLE_CONFIGURE */
+    ENET_SEND_FRAGMENT_SIZE         /* SEND_UNRELIABLE_FRAGMENT */
+};
+
+/** Outcome of processing a command. */
+#define ENET_PROCESS_ACK                    0   /**< Processed. Acknowledge if requested. */
+#define ENET_PROCESS_NOACK                  1   /**< Processed or dropped. Do not acknowledge. */
+#define ENET_PROCESS_ABORT                  2   /**< Malformed or unexpected. Drop the rest of the datagram. */
+
+/** Returns true (non-zero) if the ENet host pointed to by @p e is open. */
+#define clarinet_enet_is_open(e)            ((e)->peers != NULL)
+
+/** Helper to write a command header. */
+CLARINET_STATIC_INLINE
+void
+enet_put_command(uint8_t* p,
+                 uint8_t command,
+                 uint8_t channel,
+                 uint16_t rsn)
+{
+    p[0] = command;
+    p[1] = channel;
+    clarinet_put16(&p[2], rsn);
+}
+
+/** Returns true (non-zero) if sequence number @p a is more recent than @p b accounting for wrap around. */
+CLARINET_STATIC_INLINE
+int
+enet_seq_gt(uint16_t a,
+            uint16_t b)
+{
+    const uint16_t d = (uint16_t)(a - b);
+    return d != 0 && d < 0x8000;
+}
+
+/** Helper to compute the milliseconds elapsed since @p then. Returns 0 if the clock went backwards. */
+CLARINET_STATIC_INLINE
+uint64_t
+enet_elapsed(uint64_t now,
+             uint64_t then)
+{
+    return (now > then) ? now - then : 0;
+}
+
+CLARINET_STATIC_INLINE
+uint32_t
+enet_clamp(uint32_t v,
+           uint32_t lo,
+           uint32_t hi)
+{
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+/** Helper to advance a session id the way upstream ENet does so it never matches @p current. */
+CLARINET_STATIC_INLINE
+uint8_t
+enet_next_session(uint8_t requested,
+                  uint8_t current)
+{
+    const uint8_t mask = ENET_HEADER_SESSION_MASK >> ENET_HEADER_SESSION_SHIFT;
+    uint8_t session = (uint8_t)(((requested == ENET_SESSION_NONE ? current : requested) + 1) & mask);
+    if (session == current)
+        session = (uint8_t)((session + 1) & mask);
+
+    return session;
+}
+
+/** Helper to produce a connection identifier (splitmix64). Not meant to be unpredictable, only distinct. */
+static
+uint32_t
+enet_random(clarinet_enet* ep,
+            uint64_t now)
+{
+    uint64_t z = (ep->seed += UINT64_C(0x9E3779B97F4A7C15)) ^ now;
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return (uint32_t)(z ^ (z >> 31));
+}
+
+/** Helper to find a peer in use. Returns NULL if not found. */
+static
+clarinet_enet_peer*
+enet_find(clarinet_enet* ep,
+          uint32_t id)
+{
+    const uint32_t slot = id & 0xFFFF;
+    if (slot >= ep->capacity)
+        return NULL;
+
+    clarinet_enet_peer* p = &ep->peers[slot];
+    return (p->state != CLARINET_ENET_STATE_FREE && p->id == id) ? p : NULL;
+}
+
+/** Helper to find the hash bucket of the peers connected by a remote host with the connection id @p connect_id. */
+CLARINET_STATIC_INLINE
+clarinet_enet_peer*
+enet_bucket(clarinet_enet* restrict ep,
+            const clarinet_endpoint* restrict remote,
+            uint32_t connect_id)
+{
+    return &ep->peers[clarinet_endpoint_hash(remote, ep->secret ^ connect_id, 0) % ep->capacity];
+}
+
+/** Helper to find a peer in use by its connection id and remote endpoint. Returns NULL if not found. */
+static
+const clarinet_enet_peer*
+enet_lookup(clarinet_enet* restrict ep,
+            const clarinet_endpoint* restrict remote,
+            uint32_t connect_id)
+{
+    uint32_t next = enet_bucket(ep, remote, connect_id)->bucket;
+    while (next != 0)
+    {
+        const clarinet_enet_peer* p = &ep->peers[next - 1];
+        if (p->connect_id == connect_id && clarinet_endpoint_is_equal(&p->remote, remote))
+            return p;
+
+        next = p->next;
+    }
+
+    return NULL;
+}
+
+/** Helper to remove a peer from its hash chain. */
+static
+void
+enet_unlink(clarinet_enet* restrict ep,
+            const clarinet_enet_peer* restrict p)
+{
+    const uint32_t index = (p->id & 0xFFFF) + 1;
+    uint32_t* link = &enet_bucket(ep, &p->remote, p->connect_id)->bucket;
+    while (*link != 0)
+    {
+        if (*link == index)
+        {
+            *link = p->next;
+            return;
+        }
+
+        link = &ep->peers[*link - 1].next;
+    }
+}
+
+/**
+ * Helper to move a peer slot for @p remote from the free list to the list of slots in use. The peer is also added to
+ * the hash chain of @p connect_id and @p remote. Returns NULL if there are no free slots.
+ */
+static
+clarinet_enet_peer*
+enet_acquire(clarinet_enet* restrict ep,
+             const clarinet_endpoint* restrict remote,
+             uint32_t connect_id,
+             uint8_t state,
+             uint64_t now)
+{
+    if (ep->free == 0)
+        return NULL;
+
+    const uint32_t slot = ep->free - 1;
+    clarinet_enet_peer* p = &ep->peers[slot];
+    ep->free = p->next;
+
+    /* Session ids survive the slot so a new connection never reuses the session of the previous one. The bucket is
+     * the head of a hash chain that belongs to the slot regardless of the peer. */
+    const uint16_t generation = p->generation;
+    const uint8_t incoming_session = p->incoming_session;
+    const uint8_t outgoing_session = p->outgoing_session;
+    const uint32_t bucket = p->bucket;
+
+    memset(p, 0, sizeof(clarinet_enet_peer));
+    p->generation = generation;
+    p->incoming_session = incoming_session;
+    p->outgoing_session = outgoing_session;
+    p->bucket = bucket;
+    p->id = ((uint32_t)generation << 16) | slot;
+    p->remote = *remote;
+    p->connect_id = connect_id;
+    p->last_recv = now;
+    p->last_send = now;
+    p->mtu = ep->config.mtu;
+    p->outgoing_peer_id = ENET_PEER_ID_MAX;
+    p->state = state;
+    ep->count++;
+
+    p->active_next = ep->active;
+    if (ep->active != 0)
+        ep->peers[ep->active - 1].active_prev = slot + 1;
+    ep->active = slot + 1;
+
+    clarinet_enet_peer* head = enet_bucket(ep, remote, connect_id);
+    p->next = head->bucket;
+    head->bucket = slot + 1;
+    return p;
+}
+
+/** Helper to return all slabs held by a peer to the pool and free its slot. */
+static
+void
+enet_release(clarinet_enet* restrict ep,
+             clarinet_enet_peer* restrict p)
+{
+    for (size_t i = 0; i < CLARINET_ENET_WINDOW; ++i)
+    {
+        if (p->sendq[i].buf)
+            clarinet_packet_pool_release(ep->pool, p->sendq[i].buf);
+
+        if (p->recvq[i].buf)
+            clarinet_packet_pool_release(ep->pool, p->recvq[i].buf);
+
+        p->sendq[i].buf = NULL;
+        p->recvq[i].buf = NULL;
+    }
+
+    const uint32_t slot = p->id & 0xFFFF;
+    if (ep->backlog == slot + 1)
+        ep->backlog = 0;
+
+    /* Commands left in the datagram being processed are for a peer that no longer exists. */
+    if (ep->rxpeer == slot + 1)
+    {
+        ep->rxpeer = 0;
+        ep->rxlen = 0;
+    }
+
+    enet_unlink(ep, p);
+
+    if (p->active_prev != 0)
+        ep->peers[p->active_prev - 1].active_next = p->active_next;
+    else
+        ep->active = p->active_next;
+
+    if (p->active_next != 0)
+        ep->peers[p->active_next - 1].active_prev = p->active_prev;
+
+    p->active_prev = 0;
+    p->active_next = 0;
+    p->generation = (uint16_t)((p->generation == UINT16_MAX) ? 1 : p->generation + 1);
+    p->state = CLARINET_ENET_STATE_FREE;
+    p->inflight = 0;
+    p->held = 0;
+    p->nacks = 0;
+    p->next = ep->free;
+    ep->free = slot + 1;
+    ep->count--;
+}
+
+/**
+ * Helper to send a datagram to a peer with as many pending acks as fit followed by an optional command and payload.
+ * Returns the number of bytes sent or an error code. Acks are only discarded if the datagram is sent.
+ */
+static
+int
+enet_transmit(clarinet_enet* restrict ep,
+              clarinet_enet_peer* restrict p,
+              const void* restrict command,
+              size_t commandlen,
+              const void* restrict payload,
+              size_t len,
+              int timed,
+              uint64_t now)
+{
+    uint8_t head[ENET_HEADER_SIZE + CLARINET_ENET_WINDOW * ENET_ACK_SIZE];
+
+    uint16_t peer_id = p->outgoing_peer_id;
+    if (peer_id < ENET_PEER_ID_MAX)
+        peer_id |= (uint16_t)(p->outgoing_session << ENET_HEADER_SESSION_SHIFT);
+
+    size_t n = ENET_HEADER_SIZE_MIN;
+    if (timed)
+    {
+        peer_id |= ENET_HEADER_FLAG_SENT_TIME;
+        clarinet_put16(&head[2], (uint16_t)now);
+        n = ENET_HEADER_SIZE;
+    }
+    clarinet_put16(&head[0], peer_id);
+
+    uint32_t nacks = 0;
+    while (nacks < p->nacks && n + commandlen + len + ENET_ACK_SIZE <= p->mtu)
+    {
+        const clarinet_enet_ack* a = &p->acks[nacks++];
+        enet_put_command(&head[n], ENET_CMD_ACKNOWLEDGE, a->channel, a->rsn);
+        clarinet_put16(&head[n + 4], a->rsn);
+        clarinet_put16(&head[n + 6], a->sent_time);
+        n += ENET_ACK_SIZE;
+    }
+
+    const clarinet_iovec iov[3] = {
+        { head, n },
+        { (void*)command, commandlen },
+        { (void*)payload, len }
+    };
+
+    const int errcode = clarinet_socket_sendtov(ep->socket, iov, 3, &p->remote);
+    if (errcode < 0)
+        return errcode;
+
+    p->nacks -= nacks;
+    if (p->nacks > 0)
+        memmove(&p->acks[0], &p->acks[nacks], p->nacks * sizeof(clarinet_enet_ack));
+
+    p->last_send = now;
+    return errcode;
+}
+
+/** Helper to send the pending acks of a peer. */
+static
+void
+enet_flush_acks(clarinet_enet* restrict ep,
+                clarinet_enet_peer* restrict p,
+                uint64_t now)
+{
+    while (p->nacks > 0)
+    {
+        if (enet_transmit(ep, p, NULL, 0, NULL, 0, 0, now) < 0)
+            break;
+    }
+}
+
+/** Helper to record the ack of a reliable command in the datagram being processed. */
+static
+void
+enet_queue_ack(clarinet_enet* restrict ep,
+               clarinet_enet_peer* restrict p,
+               const uint8_t* restrict c,
+               uint64_t now)
+{
+    if (p->nacks == CLARINET_ENET_WINDOW)
+        enet_flush_acks(ep, p, now);
+
+    if (p->nacks < CLARINET_ENET_WINDOW)
+    {
+        clarinet_enet_ack* a = &p->acks[p->nacks++];
+        a->rsn = clarinet_get16(&c[2]);
+        a->sent_time = ep->rxtime;
+        a->channel = c[1];
+    }
+}
+
+/** Helper to take a free entry of a queue. Returns NULL if the queue is full. */
+static
+clarinet_enet_command*
+enet_slot(clarinet_enet_command* q)
+{
+    for (size_t i = 0; i < CLARINET_ENET_WINDOW; ++i)
+    {
+        if (!q[i].buf)
+            return &q[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Helper to keep a reliable command built in @p slab until it is acknowledged and send it. The slab is owned by the
+ * peer afterwards even if the transmission fails, in which case the command is resent by clarinet_enet_update().
+ */
+static
+void
+enet_send_reliable(clarinet_enet* restrict ep,
+                   clarinet_enet_peer* restrict p,
+                   void* restrict slab,
+                   size_t len,
+                   uint64_t now)
+{
+    const uint8_t* c = (const uint8_t*)slab;
+    clarinet_enet_command* m = enet_slot(p->sendq);
+    m->buf = slab;
+    m->sent = now;
+    m->len = (uint16_t)len;
+    m->rsn = clarinet_get16(&c[2]);
+    m->channel = c[1];
+    m->command = (uint8_t)(c[0] & ENET_CMD_MASK);
+    m->transmissions = 1;
+    p->inflight++;
+
+    enet_transmit(ep, p, slab, len, NULL, 0, 1, now);
+}
+
+/** Helper to build and send a reliable command of the system channel. */
+static
+int
+enet_send_system(clarinet_enet* restrict ep,
+                 clarinet_enet_peer* restrict p,
+                 const uint8_t* restrict command,
+                 size_t len,
+                 uint64_t now)
+{
+    if (p->inflight == CLARINET_ENET_WINDOW)
+        return CLARINET_EAGAIN;
+
+    void* slab;
+    const int errcode = clarinet_packet_pool_acquire(ep->pool, &slab);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    memcpy(slab, command, len);
+    clarinet_put16((uint8_t*)slab + 2, ++p->outgoing_reliable);
+    enet_send_reliable(ep, p, slab, len, now);
+    return CLARINET_ENONE;
+}
+
+/** Helper to remove a reliable command acknowledged by the remote host. Returns its command number or NONE. */
+static
+uint8_t
+enet_remove_sent(clarinet_enet* restrict ep,
+                 clarinet_enet_peer* restrict p,
+                 uint8_t channel,
+                 uint16_t rsn,
+                 uint64_t now)
+{
+    for (size_t i = 0; i < CLARINET_ENET_WINDOW && p->inflight > 0; ++i)
+    {
+        clarinet_enet_command* m = &p->sendq[i];
+        if (!m->buf || m->channel != channel || m->rsn != rsn)
+            continue;
+
+        /* Samples from retransmitted commands are ambiguous (Karn's algorithm). */
+        if (m->transmissions == 1)
+        {
+            const uint32_t sample = (uint32_t)enet_elapsed(now, m->sent);
+            p->rtt = (p->rtt == 0) ? sample : (7 * p->rtt + sample) / 8;
+        }
+
+        const uint8_t command = m->command;
+        clarinet_packet_pool_release(ep->pool, m->buf);
+        m->buf = NULL;
+        p->inflight--;
+        return command;
+    }
+
+    return ENET_CMD_NONE;
+}
+
+/** Helper to fill an event. */
+CLARINET_STATIC_INLINE
+void
+enet_event(clarinet_enet_event* event,
+           uint32_t id,
+           uint16_t type,
+           uint8_t channel,
+           int result,
+           uint32_t data)
+{
+    event->id = id;
+    event->type = type;
+    event->channel = channel;
+    event->result = result;
+    event->data = data;
+}
+
+/** Helper to copy a message into the caller's buffer. Returns the size of the message or CLARINET_EMSGSIZE. */
+CLARINET_STATIC_INLINE
+int
+enet_deliver(void* restrict buf,
+             size_t buflen,
+             const void* restrict payload,
+             size_t len)
+{
+    if (len > buflen)
+    {
+        memcpy(buf, payload, buflen);
+        return CLARINET_EMSGSIZE;
+    }
+
+    memcpy(buf, payload, len);
+    return (int)len;
+}
+
+/** Helper to find a reliable command held for delivery. Returns NULL if not found. */
+static
+clarinet_enet_command*
+enet_held(clarinet_enet_peer* p,
+          uint8_t channel,
+          uint16_t rsn)
+{
+    if (p->held == 0)
+        return NULL;
+
+    for (size_t i = 0; i < CLARINET_ENET_WINDOW; ++i)
+    {
+        clarinet_enet_command* m = &p->recvq[i];
+        if (m->buf && m->channel == channel && m->rsn == rsn)
+            return m;
+    }
+
+    return NULL;
+}
+
+/** Helper to return a held command to the pool. */
+CLARINET_STATIC_INLINE
+void
+enet_unhold(clarinet_enet* restrict ep,
+            clarinet_enet_peer* restrict p,
+            clarinet_enet_command* restrict m)
+{
+    clarinet_packet_pool_release(ep->pool, m->buf);
+    m->buf = NULL;
+    p->held--;
+}
+
+/**
+ * Helper to deliver the next reliable message held by the backlog peer. Fragmented messages are delivered once all
+ * their fragments are held. Returns false (zero) if none is ready.
+ */
+static
+int
+enet_drain(clarinet_enet* restrict ep,
+           void* restrict buf,
+           size_t buflen,
+           clarinet_enet_event* restrict event)
+{
+    clarinet_enet_peer* p = &ep->peers[ep->backlog - 1];
+    for (uint8_t channel = 0; channel < p->channel_count && p->held > 0; ++channel)
+    {
+        clarinet_enet_channel* ch = &p->channels[channel];
+        const uint16_t next = (uint16_t)(ch->incoming_reliable + 1);
+        clarinet_enet_command* m = enet_held(p, channel, next);
+        if (!m)
+            continue;
+
+        if (m->command == ENET_CMD_SEND_RELIABLE)
+        {
+            enet_event(event, p->id, CLARINET_ENET_EVENT_DATA, channel, enet_deliver(buf, buflen, m->buf, m->len), 0);
+            enet_unhold(ep, p, m);
+            ch->incoming_reliable = next;
+            ch->incoming_unreliable = 0;
+            return 1;
+        }
+
+        /* Fragments are held in sequence starting at the first one so all must be present. */
+        const uint16_t count = m->count;
+        const uint32_t total = m->total;
+        uint16_t i = 1;
+        while (i < count)
+        {
+            const clarinet_enet_command* f = enet_held(p, channel, (uint16_t)(next + i));
+            if (!f || f->count != count || f->total != total)
+                break;
+
+            i++;
+        }
+
+        if (i < count)
+            continue;
+
+        int result = (total > buflen || total > INT_MAX) ? CLARINET_EMSGSIZE : (int)total;
+        for (i = 0; i < count; ++i)
+        {
+            clarinet_enet_command* f = enet_held(p, channel, (uint16_t)(next + i));
+            if (f->offset < buflen)
+            {
+                const size_t room = buflen - f->offset;
+                memcpy((uint8_t*)buf + f->offset, f->buf, (f->len < room) ? f->len : room);
+            }
+
+            enet_unhold(ep, p, f);
+        }
+
+        enet_event(event, p->id, CLARINET_ENET_EVENT_DATA, channel, result, 0);
+        ch->incoming_reliable = (uint16_t)(next + count - 1);
+        ch->incoming_unreliable = 0;
+        return 1;
+    }
+
+    ep->backlog = 0;
+    return 0;
+}
+
+/** Helper to process a CONNECT command from an unknown host. */
+static
+int
+enet_process_connect(clarinet_enet* restrict ep,
+                     const uint8_t* restrict c,
+                     uint64_t now)
+{
+    if (!(ep->config.flags & CLARINET_ENET_LISTEN))
+        return ENET_PROCESS_ABORT;
+
+    const uint32_t channels = clarinet_get32(&c[16]);
+    const uint32_t connect_id = clarinet_get32(&c[40]);
+    if (channels == 0 || channels > ENET_CHANNEL_COUNT_MAX)
+        return ENET_PROCESS_ABORT;
+
+    /* A retransmitted request is ignored. The verification is resent by clarinet_enet_update() if it was lost. */
+    if (enet_lookup(ep, &ep->rxremote, connect_id))
+        return ENET_PROCESS_ABORT;
+
+    clarinet_enet_peer* p = enet_acquire(ep, &ep->rxremote, connect_id, CLARINET_ENET_STATE_ACKNOWLEDGING, now);
+    if (!p)
+        return ENET_PROCESS_ABORT;
+
+    p->outgoing_peer_id = clarinet_get16(&c[4]);
+    p->data = clarinet_get32(&c[44]);
+    p->channel_count = (uint8_t)((channels < ep->config.channels) ? channels : ep->config.channels);
+
+    const uint32_t mtu = enet_clamp(clarinet_get32(&c[8]), CLARINET_ENET_MTU_MIN, CLARINET_ENET_MTU_MAX);
+    p->mtu = (mtu < ep->config.mtu) ? mtu : ep->config.mtu;
+
+    const uint8_t incoming_session = enet_next_session(c[6], p->outgoing_session);
+    const uint8_t outgoing_session = enet_next_session(c[7], p->incoming_session);
+    p->outgoing_session = incoming_session;
+    p->incoming_session = outgoing_session;
+
+    ep->rxpeer = (p->id & 0xFFFF) + 1;
+    if ((c[0] & ENET_FLAG_ACKNOWLEDGE) && ep->rxtimed)
+        enet_queue_ack(ep, p, c, now);
+
+    uint8_t verify[ENET_VERIFY_CONNECT_SIZE];
+    enet_put_command(verify, ENET_CMD_VERIFY_CONNECT | ENET_FLAG_ACKNOWLEDGE, ENET_SYSTEM_CHANNEL, 0);
+    clarinet_put16(&verify[4], (uint16_t)(p->id & 0xFFFF));
+    verify[6] = incoming_session;
+    verify[7] = outgoing_session;
+    clarinet_put32(&verify[8], p->mtu);
+    clarinet_put32(&verify[12], enet_clamp(clarinet_get32(&c[12]), ENET_WINDOW_SIZE_MIN, ENET_WINDOW_SIZE_MAX));
+    clarinet_put32(&verify[16], p->channel_count);
+    clarinet_put32(&verify[20], 0);
+    clarinet_put32(&verify[24], 0);
+    memcpy(&verify[28], &c[28], 12);
+    clarinet_put32(&verify[40], connect_id);
+
+    if (enet_send_system(ep, p, verify, sizeof(verify), now) != CLARINET_ENONE)
+        enet_release(ep, p);
+
+    return ENET_PROCESS_NOACK;
+}
+
+/** Helper to process a VERIFY_CONNECT command. */
+static
+int
+enet_process_verify(clarinet_enet* restrict ep,
+                    clarinet_enet_peer* restrict p,
+                    const uint8_t* restrict c,
+                    clarinet_enet_event* restrict event,
+                    uint64_t now)
+{
+    if (p->state != CLARINET_ENET_STATE_CONNECTING)
+        return ENET_PROCESS_ACK;
+
+    const uint32_t channels = clarinet_get32(&c[16]);
+    if (channels == 0 || channels > ENET_CHANNEL_COUNT_MAX || clarinet_get32(&c[28]) != ENET_THROTTLE_INTERVAL
+        || clarinet_get32(&c[32]) != ENET_THROTTLE_ACCELERATION || clarinet_get32(&c[36]) != ENET_THROTTLE_DECELERATION
+        || clarinet_get32(&c[40]) != p->connect_id)
+    {
+        enet_event(event, p->id, CLARINET_ENET_EVENT_DISCONNECT, 0, CLARINET_ECONNREFUSED, 0);
+        enet_release(ep, p);
+        return ENET_PROCESS_NOACK;
+    }
+
+    for (size_t i = 0; i < CLARINET_ENET_WINDOW; ++i)
+    {
+        const clarinet_enet_command* m = &p->sendq[i];
+        if (m->buf && m->command == ENET_CMD_CONNECT)
+        {
+            enet_remove_sent(ep, p, m->channel, m->rsn, now);
+            break;
+        }
+    }
+
+    if (channels < p->channel_count)
+        p->channel_count = (uint8_t)channels;
+
+    const uint32_t mtu = enet_clamp(clarinet_get32(&c[8]), CLARINET_ENET_MTU_MIN, CLARINET_ENET_MTU_MAX);
+    if (mtu < p->mtu)
+        p->mtu = mtu;
+
+    p->outgoing_peer_id = clarinet_get16(&c[4]);
+    p->incoming_session = c[6];
+    p->outgoing_session = c[7];
+    p->state = CLARINET_ENET_STATE_CONNECTED;
+    enet_event(event, p->id, CLARINET_ENET_EVENT_CONNECT, 0, 0, 0);
+    return ENET_PROCESS_ACK;
+}
+
+/** Helper to process a DISCONNECT command. */
+static
+int
+enet_process_disconnect(clarinet_enet* restrict ep,
+                        clarinet_enet_peer* restrict p,
+                        const uint8_t* restrict c,
+                        clarinet_enet_event* restrict event,
+                        uint64_t now)
+{
+    /* The ack is sent right away because the peer is gone afterwards. */
+    if ((c[0] & ENET_FLAG_ACKNOWLEDGE) && ep->rxtimed)
+    {
+        enet_queue_ack(ep, p, c, now);
+        enet_flush_acks(ep, p, now);
+    }
+
+    /* Upstream ENet does not report connections that were never acknowledged. */
+    if (p->state != CLARINET_ENET_STATE_ACKNOWLEDGING)
+    {
+        const int reason = (p->state == CLARINET_ENET_STATE_CONNECTED) ? CLARINET_ECONNRESET : CLARINET_ECONNREFUSED;
+        enet_event(event, p->id, CLARINET_ENET_EVENT_DISCONNECT, 0, reason, clarinet_get32(&c[4]));
+    }
+
+    enet_release(ep, p);
+    return ENET_PROCESS_NOACK;
+}
+
+/** Helper to process a SEND_RELIABLE or SEND_FRAGMENT command with @p len bytes of payload. */
+static
+int
+enet_process_reliable(clarinet_enet* restrict ep,
+                      clarinet_enet_peer* restrict p,
+                      const uint8_t* restrict c,
+                      size_t len,
+                      void* restrict buf,
+                      size_t buflen,
+                      clarinet_enet_event* restrict event)
+{
+    const uint8_t command = (uint8_t)(c[0] & ENET_CMD_MASK);
+    const uint8_t channel = c[1];
+    const uint16_t rsn = clarinet_get16(&c[2]);
+    clarinet_enet_channel* ch = &p->channels[channel];
+
+    const uint16_t d = (uint16_t)(rsn - ch->incoming_reliable);
+    if (d == 0 || d >= 0x8000)
+        return ENET_PROCESS_ACK;
+
+    if (d > CLARINET_ENET_WINDOW)
+        return ENET_PROCESS_NOACK;
+
+    if (command == ENET_CMD_SEND_RELIABLE && d == 1)
+    {
+        enet_event(event, p->id, CLARINET_ENET_EVENT_DATA, channel, enet_deliver(buf, buflen, &c[6], len), 0);
+        ch->incoming_reliable = rsn;
+        ch->incoming_unreliable = 0;
+        if (p->held > 0)
+            ep->backlog = (p->id & 0xFFFF) + 1;
+
+        return ENET_PROCESS_ACK;
+    }
+
+    uint16_t count = 0;
+    uint32_t total = 0;
+    uint32_t offset = 0;
+    size_t header = ENET_SEND_RELIABLE_SIZE;
+    if (command == ENET_CMD_SEND_FRAGMENT)
+    {
+        const uint32_t fragments = clarinet_get32(&c[8]);
+        const uint32_t number = clarinet_get32(&c[12]);
+        total = clarinet_get32(&c[16]);
+        offset = clarinet_get32(&c[20]);
+        if (fragments == 0 || fragments > CLARINET_ENET_WINDOW || number >= fragments
+            || (uint16_t)(rsn - clarinet_get16(&c[4])) != number || offset > total || len > total - offset)
+            return ENET_PROCESS_ABORT;
+
+        count = (uint16_t)fragments;
+        header = ENET_SEND_FRAGMENT_SIZE;
+    }
+
+    if (enet_held(p, channel, rsn))
+        return ENET_PROCESS_ACK;
+
+    clarinet_enet_command* m = enet_slot(p->recvq);
+    if (!m || clarinet_packet_pool_acquire(ep->pool, &m->buf) != CLARINET_ENONE)
+        return ENET_PROCESS_NOACK;
+
+    memcpy(m->buf, &c[header], len);
+    m->len = (uint16_t)len;
+    m->rsn = rsn;
+    m->count = count;
+    m->total = total;
+    m->offset = offset;
+    m->channel = channel;
+    m->command = command;
+    p->held++;
+
+    ep->backlog = (p->id & 0xFFFF) + 1;
+    return ENET_PROCESS_ACK;
+}
+
+/** Helper to process a SEND_UNSEQUENCED command. Returns true (non-zero) if the group was not seen before. */
+static
+int
+enet_unsequenced(clarinet_enet_peer* p,
+                 uint16_t group)
+{
+    const uint32_t index = group % ENET_UNSEQUENCED_WINDOW_SIZE;
+    uint32_t g = group;
+    if (g < p->incoming_unsequenced)
+        g += 0x10000;
+
+    if (g >= (uint32_t)p->incoming_unsequenced + ENET_UNSEQUENCED_FREE_WINDOWS * ENET_UNSEQUENCED_WINDOW_SIZE)
+        return 0;
+
+    g &= 0xFFFF;
+    if (g - index != p->incoming_unsequenced)
+    {
+        p->incoming_unsequenced = (uint16_t)(g - index);
+        memset(p->unsequenced_window, 0, sizeof(p->unsequenced_window));
+    }
+    else if (p->unsequenced_window[index / 32] & (UINT32_C(1) << (index % 32)))
+    {
+        return 0;
+    }
+
+    p->unsequenced_window[index / 32] |= UINT32_C(1) << (index % 32);
+    return 1;
+}
+
+/** Helper to process the next command of the datagram being processed. */
+static
+void
+enet_process(clarinet_enet* restrict ep,
+             void* restrict buf,
+             size_t buflen,
+             clarinet_enet_event* restrict event,
+             uint64_t now)
+{
+    if (ep->rxlen - ep->rxoff < ENET_PING_SIZE)
+    {
+        ep->rxlen = 0;
+        return;
+    }
+
+    const uint8_t* c = &ep->rx[ep->rxoff];
+    const size_t remaining = ep->rxlen - ep->rxoff;
+    const uint8_t command = (uint8_t)(c[0] & ENET_CMD_MASK);
+    if (command == ENET_CMD_NONE || command >= ENET_CMD_COUNT || remaining < enet_command_sizes[command])
+    {
+        ep->rxlen = 0;
+        return;
+    }
+
+    size_t len = 0;
+    switch (command)
+    {
+        case ENET_CMD_SEND_RELIABLE:
+            len = clarinet_get16(&c[4]);
+            break;
+        case ENET_CMD_SEND_UNRELIABLE:
+        case ENET_CMD_SEND_UNSEQUENCED:
+        case ENET_CMD_SEND_FRAGMENT:
+        case ENET_CMD_SEND_UNRELIABLE_FRAGMENT:
+            len = clarinet_get16(&c[6]);
+            break;
+        default:
+            break;
+    }
+
+    const size_t size = enet_command_sizes[command] + len;
+    clarinet_enet_peer* p = (ep->rxpeer != 0) ? &ep->peers[ep->rxpeer - 1] : NULL;
+    if (size > remaining || (!p && command != ENET_CMD_CONNECT) || (p && command == ENET_CMD_CONNECT))
+    {
+        ep->rxlen = 0;
+        return;
+    }
+
+    ep->rxoff += (uint32_t)size;
+
+    int outcome = ENET_PROCESS_ACK;
+    if (command >= ENET_CMD_SEND_RELIABLE && command <= ENET_CMD_SEND_UNRELIABLE_FRAGMENT
+        && command != ENET_CMD_BANDWIDTH_LIMIT && command != ENET_CMD_THROTTLE_CONFIGURE
+        && (c[1] >= p->channel_count || p->state != CLARINET_ENET_STATE_CONNECTED))
+    {
+        outcome = ENET_PROCESS_ABORT;
+    }
+    else
+    {
+        switch (command)
+        {
+            case ENET_CMD_ACKNOWLEDGE:
+            {
+                outcome = ENET_PROCESS_NOACK;
+                const uint8_t acked = enet_remove_sent(ep, p, c[1], clarinet_get16(&c[4]), now);
+                if (p->state == CLARINET_ENET_STATE_ACKNOWLEDGING && acked == ENET_CMD_VERIFY_CONNECT)
+                {
+                    p->state = CLARINET_ENET_STATE_CONNECTED;
+                    enet_event(event, p->id, CLARINET_ENET_EVENT_CONNECT, 0, 0, p->data);
+                }
+                break;
+            }
+            case ENET_CMD_CONNECT:
+                outcome = enet_process_connect(ep, c, now);
+                break;
+            case ENET_CMD_VERIFY_CONNECT:
+                outcome = enet_process_verify(ep, p, c, event, now);
+                break;
+            case ENET_CMD_DISCONNECT:
+                outcome = enet_process_disconnect(ep, p, c, event, now);
+                break;
+            case ENET_CMD_SEND_RELIABLE:
+            case ENET_CMD_SEND_FRAGMENT:
+                outcome = enet_process_reliable(ep, p, c, len, buf, buflen, event);
+                break;
+            case ENET_CMD_SEND_UNRELIABLE:
+            {
+                /* Sequenced behind the last reliable command of the channel. Early ones are dropped. */
+                clarinet_enet_channel* ch = &p->channels[c[1]];
+                const uint16_t useq = clarinet_get16(&c[4]);
+                if (clarinet_get16(&c[2]) == ch->incoming_reliable && enet_seq_gt(useq, ch->incoming_unreliable))
+                {
+                    ch->incoming_unreliable = useq;
+                    const int result = enet_deliver(buf, buflen, &c[ENET_SEND_UNRELIABLE_SIZE], len);
+                    enet_event(event, p->id, CLARINET_ENET_EVENT_DATA, c[1], result, 0);
+                }
+                break;
+            }
+            case ENET_CMD_SEND_UNSEQUENCED:
+                if (enet_unsequenced(p, clarinet_get16(&c[4])))
+                {
+                    const int result = enet_deliver(buf, buflen, &c[ENET_SEND_UNSEQUENCED_SIZE], len);
+                    enet_event(event, p->id, CLARINET_ENET_EVENT_DATA, c[1], result, 0);
+                }
+                break;
+            case ENET_CMD_SEND_UNRELIABLE_FRAGMENT:
+                /* Unreliable fragments are not reassembled. Rejected without an ack so the sender never takes the
+                 * message as delivered. */
+                outcome = ENET_PROCESS_NOACK;
+                clarinet_log(CLARINET_LOG_LEVEL_WARN, CLARINET_LOG_EVENT_ENET_UNSUPPORTED, p->id, command, 0, 0);
+                break;
+            default:
+                /* PING, BANDWIDTH_LIMIT and THROTTLE_CONFIGURE only need an ack if any. */
+                break;
+        }
+    }
+
+    if (outcome == ENET_PROCESS_ABORT)
+        ep->rxlen = 0;
+    else if (outcome == ENET_PROCESS_ACK && (c[0] & ENET_FLAG_ACKNOWLEDGE) && ep->rxtimed && ep->rxpeer != 0)
+        enet_queue_ack(ep, &ep->peers[ep->rxpeer - 1], c, now);
+}
+
+/** Helper to validate the protocol header of a datagram of @p n bytes received in the rx slab. */
+static
+void
+enet_accept(clarinet_enet* ep,
+            size_t n,
+            uint64_t now)
+{
+    ep->rxoff = 0;
+    ep->rxlen = 0;
+    ep->rxpeer = 0;
+    if (n < ENET_HEADER_SIZE_MIN)
+        return;
+
+    const uint16_t header = clarinet_get16(&ep->rx[0]);
+    const uint16_t flags = header & ENET_HEADER_FLAG_MASK;
+    const uint8_t session = (uint8_t)((header & ENET_HEADER_SESSION_MASK) >> ENET_HEADER_SESSION_SHIFT);
+    const uint16_t peer_id = header & (uint16_t)~(ENET_HEADER_FLAG_MASK | ENET_HEADER_SESSION_MASK);
+    const size_t size = (flags & ENET_HEADER_FLAG_SENT_TIME) ? ENET_HEADER_SIZE : ENET_HEADER_SIZE_MIN;
+
+    if (n < size)
+        return;
+
+    /* Compressed datagrams cannot be decoded. */
+    if (flags & ENET_HEADER_FLAG_COMPRESSED)
+    {
+        clarinet_log(CLARINET_LOG_LEVEL_WARN, CLARINET_LOG_EVENT_ENET_COMPRESSED, peer_id, 0, 0, 0);
+        return;
+    }
+
+    if (peer_id != ENET_PEER_ID_MAX)
+    {
+        if (peer_id >= ep->capacity)
+            return;
+
+        clarinet_enet_peer* p = &ep->peers[peer_id];
+        if (p->state == CLARINET_ENET_STATE_FREE || !clarinet_endpoint_is_equal(&p->remote, &ep->rxremote)
+            || (p->outgoing_peer_id < ENET_PEER_ID_MAX && session != p->incoming_session))
+            return;
+
+        p->last_recv = now;
+        ep->rxpeer = (uint32_t)peer_id + 1;
+    }
+
+    ep->rxtimed = (flags & ENET_HEADER_FLAG_SENT_TIME) != 0;
+    ep->rxtime = ep->rxtimed ? clarinet_get16(&ep->rx[2]) : 0;
+    ep->rxoff = (uint32_t)size;
+    ep->rxlen = (uint32_t)n;
+}
+
+/* endregion */
+
+/* region ENet */
+
+void
+clarinet_enet_init(clarinet_enet* ep)
+{
+    memset(ep, 0, sizeof(clarinet_enet));
+}
+
+int
+clarinet_enet_open(clarinet_enet* restrict ep,
+                   clarinet_socket* restrict sp,
+                   clarinet_enet_peer* restrict peers,
+                   uint32_t capacity,
+                   clarinet_packet_pool* restrict pool,
+                   const clarinet_enet_config* restrict config)
+{
+    if (!ep || clarinet_enet_is_open(ep) || !sp || !peers || capacity == 0 || capacity > CLARINET_ENET_CAPACITY_MAX
+        || !pool || !pool->base || !config)
+        return CLARINET_EINVAL;
+
+    if (config->mtu < CLARINET_ENET_MTU_MIN || config->mtu > CLARINET_ENET_MTU_MAX || config->mtu > pool->slabsize
+        || config->channels == 0 || config->channels > CLARINET_ENET_CHANNEL_MAX || config->rto == 0
+        || config->ping == 0 || config->timeout <= config->ping || (config->flags & ~(uint32_t)CLARINET_ENET_LISTEN))
+        return CLARINET_EINVAL;
+
+    void* rx;
+    const int errcode = clarinet_packet_pool_acquire(pool, &rx);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    memset(peers, 0, capacity * sizeof(clarinet_enet_peer));
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        peers[i].generation = 1;
+        peers[i].incoming_session = ENET_SESSION_NONE;
+        peers[i].outgoing_session = ENET_SESSION_NONE;
+        peers[i].next = (i + 1 < capacity) ? i + 2 : 0;
+    }
+
+    ep->socket = sp;
+    ep->peers = peers;
+    ep->pool = pool;
+    ep->rx = (uint8_t*)rx;
+    ep->seed = (uint64_t)(uintptr_t)ep ^ ((uint64_t)(uintptr_t)sp << 32);
+    ep->secret = ((uint64_t)enet_random(ep, capacity) << 32) | enet_random(ep, (uint64_t)(uintptr_t)peers);
+    ep->capacity = capacity;
+    ep->count = 0;
+    ep->free = 1;
+    ep->active = 0;
+    ep->rxoff = 0;
+    ep->rxlen = 0;
+    ep->rxpeer = 0;
+    ep->backlog = 0;
+    ep->config = *config;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_enet_close(clarinet_enet* ep)
+{
+    if (!ep || !clarinet_enet_is_open(ep))
+        return CLARINET_EINVAL;
+
+    while (ep->active != 0)
+        enet_release(ep, &ep->peers[ep->active - 1]);
+
+    clarinet_packet_pool_release(ep->pool, ep->rx);
+    clarinet_enet_init(ep);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_enet_connect(clarinet_enet* restrict ep,
+                      const clarinet_endpoint* restrict remote,
+                      uint32_t channels,
+                      uint32_t data,
+                      uint64_t now,
+                      uint32_t* restrict id)
+{
+    if (!ep || !clarinet_enet_is_open(ep) || !remote || channels == 0 || channels > ep->config.channels || !id)
+        return CLARINET_EINVAL;
+
+    clarinet_enet_peer* p = enet_acquire(ep, remote, enet_random(ep, now), CLARINET_ENET_STATE_CONNECTING, now);
+    if (!p)
+        return CLARINET_ENOBUFS;
+
+    p->channel_count = (uint8_t)channels;
+
+    uint8_t connect[ENET_CONNECT_SIZE];
+    enet_put_command(connect, ENET_CMD_CONNECT | ENET_FLAG_ACKNOWLEDGE, ENET_SYSTEM_CHANNEL, 0);
+    clarinet_put16(&connect[4], (uint16_t)(p->id & 0xFFFF));
+    connect[6] = p->incoming_session;
+    connect[7] = p->outgoing_session;
+    clarinet_put32(&connect[8], p->mtu);
+    clarinet_put32(&connect[12], ENET_WINDOW_SIZE_MAX);
+    clarinet_put32(&connect[16], channels);
+    clarinet_put32(&connect[20], 0);
+    clarinet_put32(&connect[24], 0);
+    clarinet_put32(&connect[28], ENET_THROTTLE_INTERVAL);
+    clarinet_put32(&connect[32], ENET_THROTTLE_ACCELERATION);
+    clarinet_put32(&connect[36], ENET_THROTTLE_DECELERATION);
+    clarinet_put32(&connect[40], p->connect_id);
+    clarinet_put32(&connect[44], data);
+
+    const int errcode = enet_send_system(ep, p, connect, sizeof(connect), now);
+    if (errcode != CLARINET_ENONE)
+    {
+        enet_release(ep, p);
+        return errcode;
+    }
+
+    *id = p->id;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_enet_disconnect(clarinet_enet* ep,
+                         uint32_t id,
+                         uint32_t data,
+                         uint64_t now)
+{
+    if (!ep || !clarinet_enet_is_open(ep))
+        return CLARINET_EINVAL;
+
+    clarinet_enet_peer* p = enet_find(ep, id);
+    if (!p)
+        return CLARINET_ENOTCONN;
+
+    /* Best effort. A lost disconnection makes the remote host time out. */
+    if (p->state != CLARINET_ENET_STATE_CONNECTING)
+    {
+        uint8_t disconnect[ENET_DISCONNECT_SIZE];
+        enet_put_command(disconnect, ENET_CMD_DISCONNECT | ENET_FLAG_UNSEQUENCED, ENET_SYSTEM_CHANNEL,
+                         ++p->outgoing_reliable);
+        clarinet_put32(&disconnect[4], data);
+        enet_transmit(ep, p, disconnect, sizeof(disconnect), NULL, 0, 0, now);
+    }
+
+    enet_release(ep, p);
+    return CLARINET_ENONE;
+}
+
+clarinet_enet_peer*
+clarinet_enet_peer_find(clarinet_enet* ep,
+                        uint32_t id)
+{
+    if (!ep || !clarinet_enet_is_open(ep))
+        return NULL;
+
+    return enet_find(ep, id);
+}
+
+int
+clarinet_enet_send(clarinet_enet* restrict ep,
+                   uint32_t id,
+                   uint8_t channel,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint32_t flags,
+                   uint64_t now)
+{
+    if (!ep || !clarinet_enet_is_open(ep) || !buf || buflen == 0 || buflen > INT_MAX
+        || flags > CLARINET_ENET_UNSEQUENCED)
+        return CLARINET_EINVAL;
+
+    clarinet_enet_peer* p = enet_find(ep, id);
+    if (!p || p->state != CLARINET_ENET_STATE_CONNECTED)
+        return CLARINET_ENOTCONN;
+
+    if (channel >= p->channel_count)
+        return CLARINET_EINVAL;
+
+    clarinet_enet_channel* ch = &p->channels[channel];
+    uint8_t command[ENET_SEND_FRAGMENT_SIZE];
+
+    if (flags != CLARINET_ENET_RELIABLE)
+    {
+        if (buflen > p->mtu - ENET_HEADER_SIZE - ENET_SEND_UNRELIABLE_SIZE)
+            return CLARINET_EMSGSIZE;
+
+        if (flags == CLARINET_ENET_UNSEQUENCED)
+        {
+            enet_put_command(command, ENET_CMD_SEND_UNSEQUENCED | ENET_FLAG_UNSEQUENCED, channel, 0);
+            clarinet_put16(&command[4], ++p->outgoing_unsequenced);
+        }
+        else
+        {
+            enet_put_command(command, ENET_CMD_SEND_UNRELIABLE, channel, ch->outgoing_reliable);
+            clarinet_put16(&command[4], ++ch->outgoing_unreliable);
+        }
+        clarinet_put16(&command[6], (uint16_t)buflen);
+
+        const int n = enet_transmit(ep, p, command, ENET_SEND_UNRELIABLE_SIZE, buf, buflen, 0, now);
+        return (n < 0) ? n : (int)buflen;
+    }
+
+    /* Reliable messages that do not fit in a datagram are split in fragments of equal size but the last. */
+    const size_t single = p->mtu - ENET_HEADER_SIZE - ENET_SEND_RELIABLE_SIZE;
+    const size_t fragment = p->mtu - ENET_HEADER_SIZE - ENET_SEND_FRAGMENT_SIZE;
+    const size_t count = (buflen <= single) ? 1 : (buflen + fragment - 1) / fragment;
+    if (count > CLARINET_ENET_WINDOW)
+        return CLARINET_EMSGSIZE;
+
+    if (count > CLARINET_ENET_WINDOW - p->inflight)
+        return CLARINET_EAGAIN;
+
+    /* All slabs are taken up front so a message is never sent partially. */
+    void* slabs[CLARINET_ENET_WINDOW];
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int errcode = clarinet_packet_pool_acquire(ep->pool, &slabs[i]);
+        if (errcode != CLARINET_ENONE)
+        {
+            while (i > 0)
+                clarinet_packet_pool_release(ep->pool, slabs[--i]);
+
+            return errcode;
+        }
+    }
+
+    ch->outgoing_unreliable = 0;
+    if (count == 1)
+    {
+        uint8_t* slab = (uint8_t*)slabs[0];
+        enet_put_command(slab, ENET_CMD_SEND_RELIABLE | ENET_FLAG_ACKNOWLEDGE, channel, ++ch->outgoing_reliable);
+        clarinet_put16(&slab[4], (uint16_t)buflen);
+        memcpy(&slab[ENET_SEND_RELIABLE_SIZE], buf, buflen);
+        enet_send_reliable(ep, p, slab, ENET_SEND_RELIABLE_SIZE + buflen, now);
+        return (int)buflen;
+    }
+
+    const uint16_t start = (uint16_t)(ch->outgoing_reliable + 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t offset = i * fragment;
+        const size_t len = (buflen - offset < fragment) ? buflen - offset : fragment;
+        uint8_t* slab = (uint8_t*)slabs[i];
+        enet_put_command(slab, ENET_CMD_SEND_FRAGMENT | ENET_FLAG_ACKNOWLEDGE, channel, ++ch->outgoing_reliable);
+        clarinet_put16(&slab[4], start);
+        clarinet_put16(&slab[6], (uint16_t)len);
+        clarinet_put32(&slab[8], (uint32_t)count);
+        clarinet_put32(&slab[12], (uint32_t)i);
+        clarinet_put32(&slab[16], (uint32_t)buflen);
+        clarinet_put32(&slab[20], (uint32_t)offset);
+        memcpy(&slab[ENET_SEND_FRAGMENT_SIZE], (const uint8_t*)buf + offset, len);
+        enet_send_reliable(ep, p, slab, ENET_SEND_FRAGMENT_SIZE + len, now);
+    }
+
+    return (int)buflen;
+}
+
+int
+clarinet_enet_recv(clarinet_enet* restrict ep,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_enet_event* restrict event,
+                   uint64_t now)
+{
+    if (!ep || !clarinet_enet_is_open(ep) || !buf || buflen == 0 || buflen > INT_MAX || !event)
+        return CLARINET_EINVAL;
+
+    enet_event(event, 0, CLARINET_ENET_EVENT_NONE, 0, 0, 0);
+
+    /* Reliable messages that were waiting for a missing one are delivered before more commands are processed. */
+    if (ep->backlog != 0 && enet_drain(ep, buf, buflen, event))
+        return CLARINET_ENONE;
+
+    if (ep->rxoff >= ep->rxlen)
+    {
+        const int n = clarinet_socket_recvfrom(ep->socket, ep->rx, ep->config.mtu, &ep->rxremote);
+        if (n < 0)
+            return (n == CLARINET_EMSGSIZE) ? CLARINET_ENONE : n;
+
+        enet_accept(ep, (size_t)n, now);
+    }
+
+    while (ep->rxoff < ep->rxlen && event->type == CLARINET_ENET_EVENT_NONE)
+        enet_process(ep, buf, buflen, event, now);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_enet_update(clarinet_enet* restrict ep,
+                     clarinet_enet_event* restrict events,
+                     size_t count,
+                     uint64_t now)
+{
+    if (!ep || !clarinet_enet_is_open(ep) || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    /* Only slots in use are visited so the cost of an update does not depend on the capacity. The next slot is read
+     * before the current one is processed because a peer that times out is released. */
+    size_t n = 0;
+    uint32_t next = ep->active;
+    while (next != 0)
+    {
+        clarinet_enet_peer* p = &ep->peers[next - 1];
+        next = p->active_next;
+
+        if (enet_elapsed(now, p->last_recv) >= ep->config.timeout)
+        {
+            if (p->state == CLARINET_ENET_STATE_ACKNOWLEDGING)
+            {
+                enet_release(ep, p);
+                continue;
+            }
+
+            if (n == count)
+                continue;
+
+            enet_event(&events[n++], p->id, CLARINET_ENET_EVENT_DISCONNECT, 0, CLARINET_ECONNTIMEOUT, 0);
+            clarinet_log(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_ENET_DISCONNECT, p->id, 0, 0, 0);
+            enet_release(ep, p);
+            continue;
+        }
+
+        const uint64_t rto = (2 * (uint64_t)p->rtt > ep->config.rto) ? 2 * (uint64_t)p->rtt : ep->config.rto;
+        for (size_t i = 0; i < CLARINET_ENET_WINDOW && p->inflight > 0; ++i)
+        {
+            clarinet_enet_command* m = &p->sendq[i];
+            if (!m->buf)
+                continue;
+
+            const unsigned retries = m->transmissions - 1u;
+            const unsigned backoff = (retries < ENET_BACKOFF_MAX) ? retries : ENET_BACKOFF_MAX;
+            if (enet_elapsed(now, m->sent) < (rto << backoff))
+                continue;
+
+            m->sent = now;
+            if (m->transmissions < UINT8_MAX)
+                m->transmissions++;
+
+            p->retransmissions++;
+            clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_ENET_RETRANSMIT, p->id, m->transmissions, 0, 0);
+            enet_transmit(ep, p, m->buf, m->len, NULL, 0, 1, now);
+        }
+
+        if (p->state == CLARINET_ENET_STATE_CONNECTED && p->inflight == 0
+            && enet_elapsed(now, p->last_send) >= ep->config.ping)
+        {
+            uint8_t ping[ENET_PING_SIZE];
+            enet_put_command(ping, ENET_CMD_PING | ENET_FLAG_ACKNOWLEDGE, ENET_SYSTEM_CHANNEL, 0);
+            enet_send_system(ep, p, ping, sizeof(ping), now);
+        }
+
+        enet_flush_acks(ep, p, now);
+    }
+
+    return (int)n;
+}
+
+/* endregion */
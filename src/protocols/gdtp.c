@@ -0,0 +1,623 @@
+#include "compat/compat.h"
+#include "clarinet/clarinet.h"
+
+#include "compat/log.h"
+#include "compat/bytes.h"
+
+#include <string.h>
+
+/* region Helpers */
+
+/**
+ * Wire format (all integers in network byte order) following the DTLC header:
+ *
+ *      seq:16 | ack:16 | ack bits:32 | channel:8 | message seq:16 | payload
+ *
+ * Bit N of the ack bits acknowledges packet (ack - N - 1). Datagrams sent on the ack channel carry no payload and are
+ * not acknowledged themselves.
+ */
+#define GDTP_CHANNEL_ACK            0xFF
+#define GDTP_ACK_BITS               32
+
+/** Maximum exponent of the retransmission backoff. */
+#define GDTP_BACKOFF_MAX            4
+
+/** Maximum number of DTLC events collected at once by clarinet_gdtp_update(). */
+#define GDTP_UPDATE_BATCH           16
+
+/** Returns true (non-zero) if the GDTP endpoint pointed to by @p g is open. */
+#define clarinet_gdtp_is_open(g)    ((g)->connections != NULL)
+
+/** Returns true (non-zero) if sequence number @p a is more recent than @p b accounting for wrap around. */
+CLARINET_STATIC_INLINE
+int
+gdtp_seq_gt(uint16_t a,
+            uint16_t b)
+{
+    const uint16_t d = (uint16_t)(a - b);
+    return d != 0 && d < 0x8000;
+}
+
+/** Helper to compute the milliseconds elapsed since @p then. Returns 0 if the clock went backwards. */
+CLARINET_STATIC_INLINE
+uint64_t
+gdtp_elapsed(uint64_t now,
+             uint64_t then)
+{
+    return (now > then) ? now - then : 0;
+}
+
+/** Helper to find the state of an established connection. Returns NULL if not found. */
+static
+clarinet_gdtp_connection*
+gdtp_find(clarinet_gdtp* gp,
+          uint32_t id)
+{
+    const clarinet_dtlc_connection* c = clarinet_dtlc_connection_find(gp->dtlc, id);
+    if (!c || c->state != CLARINET_DTLC_STATE_CONNECTED)
+        return NULL;
+
+    clarinet_gdtp_connection* gc = &gp->connections[clarinet_dtlc_slot(id)];
+    return (gc->id == id) ? gc : NULL;
+}
+
+/** Helper to return all slabs held by a connection to the pool and reset its state for the connection @p id. */
+static
+void
+gdtp_reset(clarinet_gdtp* gp,
+           uint32_t slot,
+           uint32_t id)
+{
+    clarinet_gdtp_connection* gc = &gp->connections[slot];
+    for (size_t i = 0; i < CLARINET_GDTP_WINDOW; ++i)
+    {
+        if (gc->sendq[i].buf)
+            clarinet_packet_pool_release(gp->pool, gc->sendq[i].buf);
+
+        if (gc->recvq[i].buf)
+            clarinet_packet_pool_release(gp->pool, gc->recvq[i].buf);
+    }
+
+    memset(gc, 0, sizeof(clarinet_gdtp_connection));
+    gc->id = id;
+    gc->remote_seq = UINT16_MAX;
+    for (size_t i = 0; i < CLARINET_GDTP_CHANNEL_MAX; ++i)
+    {
+        gc->channels[i].recv_seq = (gp->config.channels[i] == CLARINET_GDTP_ORDERED) ? 0 : UINT16_MAX;
+        gc->channels[i].recv_bits = UINT64_MAX;
+    }
+
+    if (gp->backlog == slot + 1)
+        gp->backlog = 0;
+}
+
+/**
+ * Helper to send a datagram with the current acks. The packet sequence number used is stored in @p seq if not NULL.
+ * Returns the number of bytes of payload sent or an error code.
+ */
+static
+int
+gdtp_transmit(clarinet_gdtp* restrict gp,
+              clarinet_gdtp_connection* restrict gc,
+              uint8_t channel,
+              uint16_t msgseq,
+              const void* restrict payload,
+              size_t len,
+              uint64_t now,
+              uint16_t* restrict seq)
+{
+    const uint16_t s = gc->local_seq++;
+    if (seq)
+        *seq = s;
+
+    uint8_t header[CLARINET_GDTP_HEADER_SIZE];
+    clarinet_put16(&header[0], s);
+    clarinet_put16(&header[2], gc->remote_seq);
+    clarinet_put32(&header[4], gc->recv_bits);
+    header[8] = channel;
+    clarinet_put16(&header[9], msgseq);
+
+    const clarinet_iovec iov[2] = {
+        { header, sizeof(header) },
+        { (void*)payload, len }
+    };
+
+    const int n = clarinet_dtlc_sendv(gp->dtlc, gc->id, iov, 2, now);
+    if (n < 0)
+        return n;
+
+    gc->ack_pending = 0;
+    return n - CLARINET_GDTP_HEADER_SIZE;
+}
+
+/** Helper to release the reliable messages acknowledged by a datagram and update the round trip time. */
+static
+void
+gdtp_process_acks(clarinet_gdtp* restrict gp,
+                  clarinet_gdtp_connection* restrict gc,
+                  uint16_t ack,
+                  uint32_t bits,
+                  uint64_t now)
+{
+    for (size_t i = 0; i < CLARINET_GDTP_WINDOW && gc->inflight > 0; ++i)
+    {
+        clarinet_gdtp_message* m = &gc->sendq[i];
+        if (!m->buf)
+            continue;
+
+        const uint16_t d = (uint16_t)(ack - m->seq);
+        if (d > GDTP_ACK_BITS || (d > 0 && !(bits & (UINT32_C(1) << (d - 1)))))
+            continue;
+
+        /* Samples from retransmitted messages are ambiguous (Karn's algorithm). */
+        if (m->transmissions == 1)
+        {
+            const uint32_t sample = (uint32_t)gdtp_elapsed(now, m->sent);
+            gc->rtt = (gc->rtt == 0) ? sample : (7 * gc->rtt + sample) / 8;
+        }
+
+        clarinet_packet_pool_release(gp->pool, m->buf);
+        m->buf = NULL;
+        gc->inflight--;
+    }
+}
+
+/** Helper to record a packet received so it is acknowledged by the next datagram sent. */
+static
+void
+gdtp_record(clarinet_gdtp_connection* gc,
+            uint16_t seq,
+            uint64_t now)
+{
+    if (gdtp_seq_gt(seq, gc->remote_seq))
+    {
+        const uint16_t d = (uint16_t)(seq - gc->remote_seq);
+        gc->recv_bits = (d >= GDTP_ACK_BITS) ? 0 : gc->recv_bits << d;
+        if (d <= GDTP_ACK_BITS)
+            gc->recv_bits |= UINT32_C(1) << (d - 1);
+
+        gc->remote_seq = seq;
+    }
+    else
+    {
+        const uint16_t d = (uint16_t)(gc->remote_seq - seq);
+        if (d > 0 && d <= GDTP_ACK_BITS)
+            gc->recv_bits |= UINT32_C(1) << (d - 1);
+    }
+
+    if (!gc->ack_pending)
+    {
+        gc->ack_pending = 1;
+        gc->ack_time = now;
+    }
+}
+
+/** Helper to detect duplicates in a reliable unordered channel. Returns true (non-zero) if the message is new. */
+static
+int
+gdtp_dedup(clarinet_gdtp_channel* ch,
+           uint16_t msgseq)
+{
+    if (gdtp_seq_gt(msgseq, ch->recv_seq))
+    {
+        const uint16_t d = (uint16_t)(msgseq - ch->recv_seq);
+        ch->recv_bits = (d >= 64) ? 0 : ch->recv_bits << d;
+        if (d <= 64)
+            ch->recv_bits |= UINT64_C(1) << (d - 1);
+
+        ch->recv_seq = msgseq;
+        return 1;
+    }
+
+    const uint16_t d = (uint16_t)(ch->recv_seq - msgseq);
+    if (d == 0 || d > 64 || (ch->recv_bits & (UINT64_C(1) << (d - 1))))
+        return 0;
+
+    ch->recv_bits |= UINT64_C(1) << (d - 1);
+    return 1;
+}
+
+/**
+ * Helper to keep an ordered message that arrived before the messages preceding it. Returns false (zero) if the message
+ * cannot be kept in which case the datagram must not be acknowledged so it is resent.
+ */
+static
+int
+gdtp_hold(clarinet_gdtp* restrict gp,
+          clarinet_gdtp_connection* restrict gc,
+          uint8_t channel,
+          uint16_t msgseq,
+          const uint8_t* restrict payload,
+          size_t len)
+{
+    if ((uint16_t)(msgseq - gc->channels[channel].recv_seq) >= CLARINET_GDTP_WINDOW)
+        return 0;
+
+    clarinet_gdtp_message* slot = NULL;
+    for (size_t i = 0; i < CLARINET_GDTP_WINDOW; ++i)
+    {
+        clarinet_gdtp_message* m = &gc->recvq[i];
+        if (!m->buf)
+        {
+            if (!slot)
+                slot = m;
+        }
+        else if (m->channel == channel && m->msgseq == msgseq)
+        {
+            return 1;
+        }
+    }
+
+    if (!slot || clarinet_packet_pool_acquire(gp->pool, &slot->buf) != CLARINET_ENONE)
+        return 0;
+
+    memcpy(slot->buf, payload, len);
+    slot->channel = channel;
+    slot->msgseq = msgseq;
+    slot->len = (uint16_t)len;
+    return 1;
+}
+
+/** Helper to deliver the next ordered message held by the backlog connection. Returns false (zero) if none is ready. */
+static
+int
+gdtp_drain(clarinet_gdtp* restrict gp,
+           void* restrict buf,
+           clarinet_gdtp_event* restrict event)
+{
+    clarinet_gdtp_connection* gc = &gp->connections[gp->backlog - 1];
+    for (size_t i = 0; i < CLARINET_GDTP_WINDOW; ++i)
+    {
+        clarinet_gdtp_message* m = &gc->recvq[i];
+        if (!m->buf || m->msgseq != gc->channels[m->channel].recv_seq)
+            continue;
+
+        memcpy(buf, m->buf, m->len);
+        event->type = CLARINET_GDTP_EVENT_DATA;
+        event->id = gc->id;
+        event->channel = m->channel;
+        event->result = m->len;
+
+        gc->channels[m->channel].recv_seq++;
+        clarinet_packet_pool_release(gp->pool, m->buf);
+        m->buf = NULL;
+        return 1;
+    }
+
+    gp->backlog = 0;
+    return 0;
+}
+
+/** Helper to process the payload of a DTLC datagram received in @p buf. */
+static
+void
+gdtp_process(clarinet_gdtp* restrict gp,
+             uint32_t slot,
+             uint8_t* restrict buf,
+             size_t n,
+             clarinet_gdtp_event* restrict event,
+             uint64_t now)
+{
+    if (n < CLARINET_GDTP_HEADER_SIZE)
+        return;
+
+    clarinet_gdtp_connection* gc = &gp->connections[slot];
+    const uint16_t seq = clarinet_get16(&buf[0]);
+    const uint8_t channel = buf[8];
+    const uint16_t msgseq = clarinet_get16(&buf[9]);
+    const size_t len = n - CLARINET_GDTP_HEADER_SIZE;
+
+    gdtp_process_acks(gp, gc, clarinet_get16(&buf[2]), clarinet_get32(&buf[4]), now);
+
+    if (channel >= gp->config.nchannels || len > gp->config.mtu)
+        return;
+
+    int deliver = 0;
+    clarinet_gdtp_channel* ch = &gc->channels[channel];
+    switch (gp->config.channels[channel])
+    {
+        case CLARINET_GDTP_SEQUENCED:
+            deliver = gdtp_seq_gt(msgseq, ch->recv_seq);
+            if (deliver)
+                ch->recv_seq = msgseq;
+            break;
+        case CLARINET_GDTP_RELIABLE:
+            deliver = gdtp_dedup(ch, msgseq);
+            break;
+        case CLARINET_GDTP_ORDERED:
+            if (msgseq == ch->recv_seq)
+            {
+                deliver = 1;
+                ch->recv_seq++;
+                gp->backlog = slot + 1;
+            }
+            else if (gdtp_seq_gt(msgseq, ch->recv_seq)
+                     && !gdtp_hold(gp, gc, channel, msgseq, &buf[CLARINET_GDTP_HEADER_SIZE], len))
+            {
+                return;
+            }
+            break;
+        default:
+            deliver = 1;
+            break;
+    }
+
+    gdtp_record(gc, seq, now);
+
+    if (deliver)
+    {
+        memmove(buf, &buf[CLARINET_GDTP_HEADER_SIZE], len);
+        event->type = CLARINET_GDTP_EVENT_DATA;
+        event->id = gc->id;
+        event->channel = channel;
+        event->result = (int)len;
+    }
+}
+
+/* endregion */
+
+/* region GDTP */
+
+void
+clarinet_gdtp_init(clarinet_gdtp* gp)
+{
+    memset(gp, 0, sizeof(clarinet_gdtp));
+}
+
+int
+clarinet_gdtp_open(clarinet_gdtp* restrict gp,
+                   clarinet_dtlc* restrict dp,
+                   clarinet_gdtp_connection* restrict connections,
+                   clarinet_packet_pool* restrict pool,
+                   const clarinet_gdtp_config* restrict config)
+{
+    if (!gp || clarinet_gdtp_is_open(gp) || !dp || !dp->connections || !connections || !pool || !pool->base || !config)
+        return CLARINET_EINVAL;
+
+    if (config->nchannels == 0 || config->nchannels > CLARINET_GDTP_CHANNEL_MAX || config->mtu == 0
+        || config->mtu > UINT16_MAX || config->mtu > pool->slabsize || config->rto == 0)
+        return CLARINET_EINVAL;
+
+    for (uint32_t i = 0; i < config->nchannels; ++i)
+    {
+        if (config->channels[i] > CLARINET_GDTP_ORDERED)
+            return CLARINET_EINVAL;
+    }
+
+    memset(connections, 0, dp->capacity * sizeof(clarinet_gdtp_connection));
+
+    gp->dtlc = dp;
+    gp->connections = connections;
+    gp->pool = pool;
+    gp->backlog = 0;
+    gp->config = *config;
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_gdtp_close(clarinet_gdtp* gp)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp))
+        return CLARINET_EINVAL;
+
+    for (uint32_t i = 0; i < gp->dtlc->capacity; ++i)
+    {
+        if (gp->connections[i].id != 0)
+            gdtp_reset(gp, i, 0);
+    }
+
+    clarinet_gdtp_init(gp);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_gdtp_connect(clarinet_gdtp* restrict gp,
+                      const clarinet_endpoint* restrict remote,
+                      uint64_t now,
+                      uint32_t* restrict id)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp) || !id)
+        return CLARINET_EINVAL;
+
+    const int errcode = clarinet_dtlc_connect(gp->dtlc, remote, now, id);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    gdtp_reset(gp, clarinet_dtlc_slot(*id), *id);
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_gdtp_disconnect(clarinet_gdtp* gp,
+                         uint32_t id,
+                         uint64_t now)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp))
+        return CLARINET_EINVAL;
+
+    const int errcode = clarinet_dtlc_disconnect(gp->dtlc, id, now);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    const uint32_t slot = clarinet_dtlc_slot(id);
+    if (gp->connections[slot].id == id)
+        gdtp_reset(gp, slot, 0);
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_gdtp_send(clarinet_gdtp* restrict gp,
+                   uint32_t id,
+                   uint8_t channel,
+                   const void* restrict buf,
+                   size_t buflen,
+                   uint64_t now)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp) || channel >= gp->config.nchannels || !buf || buflen == 0
+        || buflen > gp->config.mtu)
+        return CLARINET_EINVAL;
+
+    clarinet_gdtp_connection* gc = gdtp_find(gp, id);
+    if (!gc)
+        return CLARINET_ENOTCONN;
+
+    clarinet_gdtp_channel* ch = &gc->channels[channel];
+    const uint8_t type = gp->config.channels[channel];
+    if (type == CLARINET_GDTP_RELIABLE || type == CLARINET_GDTP_ORDERED)
+    {
+        if (gc->inflight == CLARINET_GDTP_WINDOW)
+            return CLARINET_EAGAIN;
+
+        clarinet_gdtp_message* m = gc->sendq;
+        while (m->buf)
+            m++;
+
+        const int errcode = clarinet_packet_pool_acquire(gp->pool, &m->buf);
+        if (errcode != CLARINET_ENONE)
+            return errcode;
+
+        memcpy(m->buf, buf, buflen);
+        m->sent = now;
+        m->msgseq = ch->send_seq++;
+        m->len = (uint16_t)buflen;
+        m->channel = channel;
+        m->transmissions = 1;
+        gc->inflight++;
+
+        /* The message is resent if this transmission fails. */
+        gdtp_transmit(gp, gc, channel, m->msgseq, m->buf, buflen, now, &m->seq);
+        return (int)buflen;
+    }
+
+    const uint16_t msgseq = ch->send_seq;
+    if (type == CLARINET_GDTP_SEQUENCED)
+        ch->send_seq++;
+
+    return gdtp_transmit(gp, gc, channel, msgseq, buf, buflen, now, NULL);
+}
+
+int
+clarinet_gdtp_recv(clarinet_gdtp* restrict gp,
+                   void* restrict buf,
+                   size_t buflen,
+                   clarinet_gdtp_event* restrict event,
+                   uint64_t now)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp) || !buf || buflen < gp->config.mtu + CLARINET_GDTP_HEADER_SIZE
+        || buflen > INT_MAX || !event)
+        return CLARINET_EINVAL;
+
+    event->id = 0;
+    event->type = CLARINET_GDTP_EVENT_NONE;
+    event->channel = 0;
+    event->result = 0;
+
+    /* Ordered messages that were waiting for a missing one are delivered before another datagram is read. */
+    if (gp->backlog != 0 && gdtp_drain(gp, buf, event))
+        return CLARINET_ENONE;
+
+    clarinet_dtlc_event e;
+    const int errcode = clarinet_dtlc_recv(gp->dtlc, buf, buflen, &e, now);
+    if (errcode != CLARINET_ENONE)
+        return errcode;
+
+    const uint32_t slot = clarinet_dtlc_slot(e.id);
+    switch (e.type)
+    {
+        case CLARINET_DTLC_EVENT_CONNECT:
+            gdtp_reset(gp, slot, e.id);
+            event->type = CLARINET_GDTP_EVENT_CONNECT;
+            event->id = e.id;
+            break;
+        case CLARINET_DTLC_EVENT_DISCONNECT:
+            if (gp->connections[slot].id == e.id)
+                gdtp_reset(gp, slot, 0);
+
+            event->type = CLARINET_GDTP_EVENT_DISCONNECT;
+            event->id = e.id;
+            event->result = e.result;
+            break;
+        case CLARINET_DTLC_EVENT_DATA:
+            if (gp->connections[slot].id == e.id)
+                gdtp_process(gp, slot, (uint8_t*)buf, (size_t)e.result, event, now);
+            break;
+        default:
+            break;
+    }
+
+    return CLARINET_ENONE;
+}
+
+int
+clarinet_gdtp_update(clarinet_gdtp* restrict gp,
+                     clarinet_gdtp_event* restrict events,
+                     size_t count,
+                     uint64_t now)
+{
+    if (!gp || !clarinet_gdtp_is_open(gp) || !events || count == 0 || count > INT_MAX)
+        return CLARINET_EINVAL;
+
+    size_t n = 0;
+    while (n < count)
+    {
+        clarinet_dtlc_event expired[GDTP_UPDATE_BATCH];
+        const size_t batch = (count - n < GDTP_UPDATE_BATCH) ? count - n : GDTP_UPDATE_BATCH;
+        const int k = clarinet_dtlc_update(gp->dtlc, expired, batch, now);
+        if (k < 0)
+            return k;
+
+        for (int i = 0; i < k; ++i)
+        {
+            const uint32_t slot = clarinet_dtlc_slot(expired[i].id);
+            if (gp->connections[slot].id == expired[i].id)
+                gdtp_reset(gp, slot, 0);
+
+            events[n].id = expired[i].id;
+            events[n].type = CLARINET_GDTP_EVENT_DISCONNECT;
+            events[n].channel = 0;
+            events[n].result = expired[i].result;
+            n++;
+        }
+
+        if ((size_t)k < batch)
+            break;
+    }
+
+    /* Only connections in use can have messages to retransmit so just the DTLC list of slots in use is walked. */
+    for (uint32_t next = gp->dtlc->active; next != 0; next = gp->dtlc->connections[next - 1].active_next)
+    {
+        clarinet_gdtp_connection* gc = &gp->connections[next - 1];
+        if (gc->id == 0 || !gdtp_find(gp, gc->id))
+            continue;
+
+        const uint64_t rto = (2 * (uint64_t)gc->rtt > gp->config.rto) ? 2 * (uint64_t)gc->rtt : gp->config.rto;
+        for (size_t i = 0; i < CLARINET_GDTP_WINDOW && gc->inflight > 0; ++i)
+        {
+            clarinet_gdtp_message* m = &gc->sendq[i];
+            if (!m->buf)
+                continue;
+
+            const unsigned retries = m->transmissions - 1u;
+            const unsigned backoff = (retries < GDTP_BACKOFF_MAX) ? retries : GDTP_BACKOFF_MAX;
+            if (gdtp_elapsed(now, m->sent) < (rto << backoff))
+                continue;
+
+            m->sent = now;
+            if (m->transmissions < UINT8_MAX)
+                m->transmissions++;
+
+            gc->retransmissions++;
+            clarinet_log(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_GDTP_RETRANSMIT, gc->id, m->msgseq, m->channel,
+                         m->transmissions);
+            gdtp_transmit(gp, gc, m->channel, m->msgseq, m->buf, m->len, now, &m->seq);
+        }
+
+        if (gc->ack_pending && gdtp_elapsed(now, gc->ack_time) >= gp->config.ack_delay)
+            gdtp_transmit(gp, gc, GDTP_CHANNEL_ACK, 0, NULL, 0, now, NULL);
+    }
+
+    return (int)n;
+}
+
+/* endregion */
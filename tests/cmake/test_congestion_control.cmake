@@ -0,0 +1,2 @@
+target_test(test_congestion_control)
+target_sources(test_congestion_control PRIVATE src/test_congestion_control.cpp)
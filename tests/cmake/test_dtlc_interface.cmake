@@ -0,0 +1,2 @@
+target_test(test_dtlc_interface)
+target_sources(test_dtlc_interface PRIVATE src/test_dtlc_interface.cpp)
@@ -0,0 +1,8 @@
+target_test(test_dtls_interface)
+target_sources(test_dtls_interface PRIVATE src/test_dtls_interface.cpp)
+
+# The handshake tests drive an MbedTLS client against the endpoint.
+if (HAVE_MBEDTLS)
+    target_link_libraries(test_dtls_interface PRIVATE mbedtls mbedx509 mbedcrypto)
+    target_compile_definitions(test_dtls_interface PRIVATE HAVE_MBEDTLS=1)
+endif ()
@@ -0,0 +1,2 @@
+target_test(test_endpoint_table)
+target_sources(test_endpoint_table PRIVATE src/test_endpoint_table.cpp)
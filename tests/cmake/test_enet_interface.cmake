@@ -0,0 +1,2 @@
+target_test(test_enet_interface)
+target_sources(test_enet_interface PRIVATE src/test_enet_interface.cpp)
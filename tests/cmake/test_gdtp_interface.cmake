@@ -0,0 +1,2 @@
+target_test(test_gdtp_interface)
+target_sources(test_gdtp_interface PRIVATE src/test_gdtp_interface.cpp)
@@ -0,0 +1,2 @@
+target_test(test_iface_interface)
+target_sources(test_iface_interface PRIVATE src/test_iface_interface.cpp)
@@ -0,0 +1,2 @@
+target_test(test_log_interface)
+target_sources(test_log_interface PRIVATE src/test_log_interface.cpp)
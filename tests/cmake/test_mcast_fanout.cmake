@@ -0,0 +1,2 @@
+target_test(test_mcast_fanout)
+target_sources(test_mcast_fanout PRIVATE src/test_mcast_fanout.cpp)
@@ -0,0 +1,2 @@
+target_test(test_pacer)
+target_sources(test_pacer PRIVATE src/test_pacer.cpp)
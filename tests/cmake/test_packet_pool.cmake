@@ -0,0 +1,2 @@
+target_test(test_packet_pool)
+target_sources(test_packet_pool PRIVATE src/test_packet_pool.cpp)
@@ -0,0 +1,2 @@
+target_test(test_pmtu_prober)
+target_sources(test_pmtu_prober PRIVATE src/test_pmtu_prober.cpp)
@@ -0,0 +1,2 @@
+target_test(test_poller_interface)
+target_sources(test_poller_interface PRIVATE src/test_poller_interface.cpp)
@@ -0,0 +1,2 @@
+target_test(test_socket_group)
+target_sources(test_socket_group PRIVATE src/test_socket_group.cpp)
@@ -0,0 +1,2 @@
+target_test(test_timer_wheel)
+target_sources(test_timer_wheel PRIVATE src/test_timer_wheel.cpp)
@@ -0,0 +1,2 @@
+target_test(test_uring_interface)
+target_sources(test_uring_interface PRIVATE src/test_uring_interface.cpp)
@@ -0,0 +1,429 @@
+#include "test.h"
+
+#include <queue>
+#include <random>
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const uint32_t MSS = 1200;
+
+// Emulates a bottleneck link with a drop-tail queue, a fixed round-trip propagation delay and random losses. Every
+// packet is acknowledged individually and losses are detected when the acknowledgement of the packet would have
+// arrived.
+class emulator
+{
+public:
+    struct result
+    {
+        uint64_t delivered; // bytes acknowledged in the measurement interval
+        uint64_t lost;      // bytes lost in the measurement interval
+        uint64_t rtt;       // average round-trip time in microseconds in the measurement interval
+    };
+
+    emulator(uint64_t rate, uint32_t delay, uint64_t buffer, double loss):
+        rate(rate), delay(delay), buffer(buffer), loss(loss), rng(1234)
+    {
+    }
+
+    // Runs a bulk transfer that always has data to send and measures the interval [start, end) in microseconds.
+    result run(clarinet_cc* cc, uint64_t start, uint64_t end)
+    {
+        result r = { 0, 0, 0 };
+        uint64_t samples = 0;
+        uint64_t now = 0;
+        while (now < end)
+        {
+            while (!events.empty() && events.top().time <= now)
+            {
+                const event e = events.top();
+                events.pop();
+                if (e.lost)
+                {
+                    REQUIRE(Error(clarinet_cc_on_loss(cc, e.bytes, now)) == Error(CLARINET_ENONE));
+                    if (now >= start)
+                        r.lost += e.bytes;
+                }
+                else
+                {
+                    const uint32_t rtt = (uint32_t)(now - e.sent);
+                    REQUIRE(Error(clarinet_cc_on_rtt_sample(cc, rtt, now)) == Error(CLARINET_ENONE));
+                    REQUIRE(Error(clarinet_cc_on_ack(cc, e.bytes, now)) == Error(CLARINET_ENONE));
+                    if (now >= start)
+                    {
+                        r.delivered += e.bytes;
+                        r.rtt += now - e.sent;
+                        samples++;
+                    }
+                }
+            }
+
+            while (clarinet_cc_can_send(cc, MSS, now) == CLARINET_ENONE)
+            {
+                REQUIRE(Error(clarinet_cc_on_send(cc, MSS, now)) == Error(CLARINET_ENONE));
+                send(MSS, now);
+            }
+
+            uint64_t next = events.empty() ? end : events.top().time;
+            if (cc->inflight + MSS <= cc->cwnd && cc->next_send > now && cc->next_send < next)
+                next = cc->next_send;
+
+            now = next;
+        }
+
+        if (samples > 0)
+            r.rtt /= samples;
+
+        return r;
+    }
+
+private:
+    struct event
+    {
+        uint64_t time;
+        uint64_t sent;
+        size_t bytes;
+        bool lost;
+
+        bool operator>(const event& other) const
+        {
+            return time > other.time;
+        }
+    };
+
+    void send(size_t bytes, uint64_t now)
+    {
+        const uint64_t idle = (busy > now) ? busy : now;
+        const uint64_t queued = (idle - now) * rate / 1000000;
+        if (queued + bytes > buffer)
+        {
+            events.push({ idle + delay, now, bytes, true });
+            return;
+        }
+
+        busy = idle + bytes * 1000000 / rate;
+        const bool dropped = std::bernoulli_distribution(loss)(rng);
+        events.push({ busy + delay, now, bytes, dropped });
+    }
+
+    uint64_t rate;
+    uint64_t delay;
+    uint64_t buffer;
+    double loss;
+    std::mt19937 rng;
+    uint64_t busy = 0;
+    std::priority_queue<event, std::vector<event>, std::greater<event>> events;
+};
+
+static uint64_t on_init_calls;
+static uint64_t on_ack_calls;
+static uint64_t on_loss_calls;
+static uint64_t on_rtt_sample_calls;
+
+static void custom_on_init(clarinet_cc* cc, uint64_t now)
+{
+    (void)now;
+    cc->cwnd = 2 * cc->mss;
+    on_init_calls++;
+}
+
+static void custom_on_ack(clarinet_cc* cc, size_t bytes, uint64_t now)
+{
+    (void)now;
+    cc->cwnd += bytes;
+    on_ack_calls++;
+}
+
+static void custom_on_loss(clarinet_cc* cc, size_t bytes, uint64_t now)
+{
+    (void)bytes;
+    (void)now;
+    cc->cwnd = cc->mss;
+    on_loss_calls++;
+}
+
+static void custom_on_rtt_sample(clarinet_cc* cc, uint32_t rtt, uint64_t now)
+{
+    (void)cc;
+    (void)rtt;
+    (void)now;
+    on_rtt_sample_calls++;
+}
+
+static uint64_t custom_pacing_rate(const clarinet_cc* cc)
+{
+    return *(const uint64_t*)cc->data;
+}
+
+TEST_CASE("Congestion Control Initialize")
+{
+    clarinet_cc cc;
+    memset(&cc, 0xFF, sizeof(cc));
+    clarinet_cc_init(&cc);
+
+    clarinet_cc expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&cc, &expected, sizeof(cc)) == 0);
+}
+
+TEST_CASE("Congestion Control Open/Close")
+{
+    clarinet_cc cc;
+    clarinet_cc_init(&cc);
+
+    SECTION("With NULL controller")
+    {
+        int errcode = clarinet_cc_open(nullptr, clarinet_cc_bbr(), MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With NULL algorithm")
+    {
+        int errcode = clarinet_cc_open(&cc, nullptr, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With missing callback")
+    {
+        clarinet_cc_algorithm algorithm = *clarinet_cc_cubic();
+        algorithm.pacing_rate = nullptr;
+        int errcode = clarinet_cc_open(&cc, &algorithm, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With zero MSS")
+    {
+        int errcode = clarinet_cc_open(&cc, clarinet_cc_bbr(), 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("When not open")
+    {
+        int errcode = clarinet_cc_close(&cc);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_can_send(&cc, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_on_send(&cc, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_on_ack(&cc, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_on_loss(&cc, MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_on_rtt_sample(&cc, 1000, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("Open twice")
+    {
+        int errcode = clarinet_cc_open(&cc, clarinet_cc_bbr(), MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onexit = finalizer([&]
+        {
+            clarinet_cc_close(&cc);
+        });
+
+        errcode = clarinet_cc_open(&cc, clarinet_cc_cubic(), MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        REQUIRE(cc.algorithm == clarinet_cc_bbr());
+    }
+
+    SECTION("Open and close")
+    {
+        int data = 0;
+        cc.data = &data;
+        int errcode = clarinet_cc_open(&cc, clarinet_cc_cubic(), MSS, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(cc.algorithm == clarinet_cc_cubic());
+        REQUIRE(std::string(cc.algorithm->name) == "cubic");
+        REQUIRE(cc.data == &data);
+        REQUIRE(cc.mss == MSS);
+        REQUIRE(cc.cwnd == 10 * MSS);
+        REQUIRE(cc.inflight == 0);
+
+        errcode = clarinet_cc_on_rtt_sample(&cc, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_cc_close(&cc);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(cc.algorithm == nullptr);
+        REQUIRE(cc.data == &data);
+    }
+}
+
+TEST_CASE("Congestion Control Window")
+{
+    clarinet_cc cc;
+    clarinet_cc_init(&cc);
+    int errcode = clarinet_cc_open(&cc, clarinet_cc_cubic(), MSS, 0);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&]
+    {
+        clarinet_cc_close(&cc);
+    });
+
+    // Not paced before the first round-trip time sample
+    REQUIRE(cc.pacing_rate == 0);
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(Error(clarinet_cc_can_send(&cc, MSS, 0)) == Error(CLARINET_ENONE));
+        REQUIRE(Error(clarinet_cc_on_send(&cc, MSS, 0)) == Error(CLARINET_ENONE));
+    }
+
+    REQUIRE(cc.inflight == 10 * MSS);
+    REQUIRE(Error(clarinet_cc_can_send(&cc, MSS, 0)) == Error(CLARINET_EAGAIN));
+
+    // Slow start grows the window by the bytes acknowledged
+    REQUIRE(Error(clarinet_cc_on_rtt_sample(&cc, 20000, 20000)) == Error(CLARINET_ENONE));
+    REQUIRE(Error(clarinet_cc_on_ack(&cc, MSS, 20000)) == Error(CLARINET_ENONE));
+    REQUIRE(cc.srtt == 20000);
+    REQUIRE(cc.min_rtt == 20000);
+    REQUIRE(cc.inflight == 9 * MSS);
+    REQUIRE(cc.delivered == MSS);
+    REQUIRE(cc.cwnd == 11 * MSS);
+    REQUIRE(cc.pacing_rate > 0);
+
+    // A loss reduces the window once per round-trip time
+    REQUIRE(Error(clarinet_cc_on_loss(&cc, MSS, 20000)) == Error(CLARINET_ENONE));
+    REQUIRE(cc.lost == MSS);
+    REQUIRE(cc.inflight == 8 * MSS);
+    const uint64_t cwnd = cc.cwnd;
+    REQUIRE(cwnd < 11 * MSS);
+    REQUIRE(Error(clarinet_cc_on_loss(&cc, MSS, 20001)) == Error(CLARINET_ENONE));
+    REQUIRE(cc.cwnd == cwnd);
+}
+
+TEST_CASE("Congestion Control Pacing")
+{
+    clarinet_cc cc;
+    clarinet_cc_init(&cc);
+    int errcode = clarinet_cc_open(&cc, clarinet_cc_bbr(), MSS, 1000);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&]
+    {
+        clarinet_cc_close(&cc);
+    });
+
+    REQUIRE(cc.pacing_rate > 0);
+    REQUIRE(Error(clarinet_cc_can_send(&cc, MSS, 1000)) == Error(CLARINET_ENONE));
+    REQUIRE(Error(clarinet_cc_on_send(&cc, MSS, 1000)) == Error(CLARINET_ENONE));
+    REQUIRE(cc.next_send == 1000 + (uint64_t)MSS * 1000000 / cc.pacing_rate);
+    REQUIRE(Error(clarinet_cc_can_send(&cc, MSS, 1000)) == Error(CLARINET_EAGAIN));
+    REQUIRE(Error(clarinet_cc_can_send(&cc, MSS, cc.next_send)) == Error(CLARINET_ENONE));
+
+    // Idle time is not credited
+    const uint64_t now = cc.next_send + 1000000;
+    REQUIRE(Error(clarinet_cc_on_send(&cc, MSS, now)) == Error(CLARINET_ENONE));
+    REQUIRE(cc.next_send == now + (uint64_t)MSS * 1000000 / cc.pacing_rate);
+}
+
+TEST_CASE("Congestion Control Custom Algorithm")
+{
+    on_init_calls = 0;
+    on_ack_calls = 0;
+    on_loss_calls = 0;
+    on_rtt_sample_calls = 0;
+
+    const clarinet_cc_algorithm algorithm = {
+        "custom", custom_on_init, custom_on_ack, custom_on_loss, custom_on_rtt_sample, custom_pacing_rate
+    };
+
+    uint64_t rate = 1000000;
+    clarinet_cc cc;
+    clarinet_cc_init(&cc);
+    cc.data = &rate;
+    int errcode = clarinet_cc_open(&cc, &algorithm, MSS, 0);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&]
+    {
+        clarinet_cc_close(&cc);
+    });
+
+    REQUIRE(on_init_calls == 1);
+    REQUIRE(cc.cwnd == 2 * MSS);
+    REQUIRE(cc.pacing_rate == rate);
+
+    rate = 2000000;
+    REQUIRE(Error(clarinet_cc_on_rtt_sample(&cc, 1000, 0)) == Error(CLARINET_ENONE));
+    REQUIRE(on_rtt_sample_calls == 1);
+    REQUIRE(cc.pacing_rate == rate);
+
+    REQUIRE(Error(clarinet_cc_on_ack(&cc, MSS, 0)) == Error(CLARINET_ENONE));
+    REQUIRE(on_ack_calls == 1);
+    REQUIRE(cc.cwnd == 3 * MSS);
+
+    REQUIRE(Error(clarinet_cc_on_loss(&cc, MSS, 0)) == Error(CLARINET_ENONE));
+    REQUIRE(on_loss_calls == 1);
+    REQUIRE(cc.cwnd == MSS);
+}
+
+TEST_CASE("Congestion Control Emulated Link")
+{
+    // 80 Mbit/s with 20ms of round-trip time has a bandwidth-delay product of 200 KB
+    const uint64_t rate = 10000000;
+    const uint32_t delay = 20000;
+    const uint64_t bdp = rate * delay / 1000000;
+
+    const uint64_t start = 5000000;
+    const uint64_t end = 20000000;
+    const uint64_t capacity = rate * (end - start) / 1000000;
+
+    SECTION("BBR saturates the link without filling a deep buffer")
+    {
+        clarinet_cc cc;
+        clarinet_cc_init(&cc);
+        REQUIRE(Error(clarinet_cc_open(&cc, clarinet_cc_bbr(), MSS, 0)) == Error(CLARINET_ENONE));
+
+        emulator link(rate, delay, 4 * bdp, 0.0);
+        const auto r = link.run(&cc, start, end);
+        REQUIRE(r.delivered >= capacity * 90 / 100);
+        REQUIRE(r.rtt <= delay * 5 / 4);
+        REQUIRE(Error(clarinet_cc_close(&cc)) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("BBR tolerates random losses")
+    {
+        clarinet_cc cc;
+        clarinet_cc_init(&cc);
+        REQUIRE(Error(clarinet_cc_open(&cc, clarinet_cc_bbr(), MSS, 0)) == Error(CLARINET_ENONE));
+
+        emulator link(rate, delay, 4 * bdp, 0.01);
+        const auto r = link.run(&cc, start, end);
+        REQUIRE(r.delivered >= capacity * 85 / 100);
+        REQUIRE(Error(clarinet_cc_close(&cc)) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("BBR does not flood a shallow buffer")
+    {
+        clarinet_cc cc;
+        clarinet_cc_init(&cc);
+        REQUIRE(Error(clarinet_cc_open(&cc, clarinet_cc_bbr(), MSS, 0)) == Error(CLARINET_ENONE));
+
+        emulator link(rate, delay, bdp / 8, 0.0);
+        const auto r = link.run(&cc, start, end);
+        REQUIRE(r.delivered >= capacity * 80 / 100);
+        REQUIRE(r.lost * 20 <= r.delivered);
+        REQUIRE(Error(clarinet_cc_close(&cc)) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("CUBIC saturates the link")
+    {
+        clarinet_cc cc;
+        clarinet_cc_init(&cc);
+        REQUIRE(Error(clarinet_cc_open(&cc, clarinet_cc_cubic(), MSS, 0)) == Error(CLARINET_ENONE));
+
+        emulator link(rate, delay, bdp, 0.0);
+        const auto r = link.run(&cc, start, end);
+        REQUIRE(r.delivered >= capacity * 85 / 100);
+        REQUIRE(r.rtt > delay);
+        REQUIRE(Error(clarinet_cc_close(&cc)) == Error(CLARINET_ENONE));
+    }
+}
@@ -0,0 +1,385 @@
+#include "test.h"
+
+#include <algorithm>
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+struct dtlc_peer
+{
+    clarinet_socket socket;
+    clarinet_endpoint local;
+    clarinet_dtlc dtlc;
+    std::vector<clarinet_dtlc_connection> connections;
+
+    explicit dtlc_peer(uint32_t capacity, uint32_t flags): connections(capacity)
+    {
+        clarinet_socket_init(&socket);
+        int errcode = clarinet_socket_open(&socket, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const int32_t nonblock = 1;
+        errcode = clarinet_socket_setopt(&socket, CLARINET_SO_NONBLOCK, &nonblock, sizeof(nonblock));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const clarinet_endpoint any = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(&socket, &any);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_local_endpoint(&socket, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_dtlc_config config;
+        memset(&config, 0, sizeof(config));
+        memcpy(config.secret, "0123456789ABCDEF", sizeof(config.secret));
+        config.keepalive = 1000;
+        config.timeout = 5000;
+        config.flags = flags;
+
+        clarinet_dtlc_init(&dtlc);
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections.data(), capacity, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    ~dtlc_peer()
+    {
+        clarinet_dtlc_close(&dtlc);
+        clarinet_socket_close(&socket);
+    }
+
+    // Receive until there is nothing left and return the events of interest.
+    std::vector<clarinet_dtlc_event> pump(uint64_t now, std::string* data = nullptr)
+    {
+        std::vector<clarinet_dtlc_event> events;
+        char buf[256];
+        clarinet_dtlc_event event;
+        int errcode;
+        while ((errcode = clarinet_dtlc_recv(&dtlc, buf, sizeof(buf), &event, now)) == CLARINET_ENONE)
+        {
+            if (event.type == CLARINET_DTLC_EVENT_NONE)
+                continue;
+
+            if (event.type == CLARINET_DTLC_EVENT_DATA && data)
+                data->assign(buf, (size_t)event.result);
+
+            events.push_back(event);
+        }
+
+        REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+        return events;
+    }
+};
+
+TEST_CASE("DTLC Initialize")
+{
+    clarinet_dtlc dtlc;
+    memset(&dtlc, 0xFF, sizeof(dtlc));
+    clarinet_dtlc_init(&dtlc);
+
+    clarinet_dtlc expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&dtlc, &expected, sizeof(dtlc)) == 0);
+}
+
+TEST_CASE("DTLC Open/Close")
+{
+    clarinet_socket socket;
+    clarinet_socket_init(&socket);
+
+    clarinet_dtlc_connection connections[4];
+    clarinet_dtlc_config config;
+    memset(&config, 0, sizeof(config));
+    config.keepalive = 1000;
+    config.timeout = 5000;
+
+    clarinet_dtlc dtlc;
+    clarinet_dtlc_init(&dtlc);
+
+    SECTION("With NULL arguments")
+    {
+        int errcode = clarinet_dtlc_open(nullptr, &socket, connections, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_open(&dtlc, nullptr, connections, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_open(&dtlc, &socket, nullptr, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 4, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 0, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections, CLARINET_DTLC_CAPACITY_MAX + 1, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        config.timeout = config.keepalive;
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("SAME endpoint TWICE")
+    {
+        int errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 4, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_dtlc_close(&dtlc);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_dtlc_close(&dtlc);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+}
+
+TEST_CASE("DTLC Connect")
+{
+    uint64_t now = 100000;
+
+    dtlc_peer server(4, CLARINET_DTLC_LISTEN);
+    dtlc_peer client(2, CLARINET_DTLC_NONE);
+
+    uint32_t cid = 0;
+    int errcode = clarinet_dtlc_connect(&client.dtlc, &server.local, now, &cid);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    REQUIRE(cid != 0);
+
+    // HELLO -> COOKIE -> CONNECT -> ACCEPT
+    REQUIRE(server.pump(now).empty());
+    REQUIRE(client.pump(now).empty());
+
+    auto events = server.pump(now);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == CLARINET_DTLC_EVENT_CONNECT);
+    const uint32_t sid = events[0].id;
+    REQUIRE(server.dtlc.count == 1);
+
+    events = client.pump(now);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == CLARINET_DTLC_EVENT_CONNECT);
+    REQUIRE(events[0].id == cid);
+
+    const clarinet_dtlc_connection* connection = clarinet_dtlc_connection_find(&server.dtlc, sid);
+    REQUIRE(connection != nullptr);
+    REQUIRE(connection->state == CLARINET_DTLC_STATE_CONNECTED);
+    REQUIRE(connection->remote_id == cid);
+    REQUIRE(clarinet_endpoint_is_equal(&connection->remote, &client.local));
+
+    SECTION("Send/Recv")
+    {
+        errcode = clarinet_dtlc_send(&client.dtlc, cid, "hello", 5, now);
+        REQUIRE(errcode == 5);
+
+        std::string data;
+        events = server.pump(now, &data);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_DTLC_EVENT_DATA);
+        REQUIRE(events[0].id == sid);
+        REQUIRE(events[0].result == 5);
+        REQUIRE(data == "hello");
+
+        errcode = clarinet_dtlc_send(&server.dtlc, sid, "world", 5, now);
+        REQUIRE(errcode == 5);
+
+        events = client.pump(now, &data);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_DTLC_EVENT_DATA);
+        REQUIRE(data == "world");
+    }
+
+    SECTION("Send/Recv Vector")
+    {
+        char header[] = "hello ";
+        char body[] = "world";
+        const clarinet_iovec iov[2] = {
+            { header, 6 },
+            { body, 5 }
+        };
+
+        errcode = clarinet_dtlc_sendv(&client.dtlc, cid, iov, 2, now);
+        REQUIRE(errcode == 11);
+
+        std::string data;
+        events = server.pump(now, &data);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_DTLC_EVENT_DATA);
+        REQUIRE(data == "hello world");
+
+        errcode = clarinet_dtlc_sendv(&client.dtlc, cid, iov, CLARINET_IOVEC_MAX, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("Keepalive")
+    {
+        clarinet_dtlc_event updates[4];
+
+        now += 1500;
+        errcode = clarinet_dtlc_update(&client.dtlc, updates, 4, now);
+        REQUIRE(errcode == 0);
+
+        REQUIRE(server.pump(now).empty());
+        REQUIRE(connection->last_recv == now);
+    }
+
+    SECTION("Timeout")
+    {
+        clarinet_dtlc_event updates[4];
+
+        now += 6000;
+        errcode = clarinet_dtlc_update(&server.dtlc, updates, 4, now);
+        REQUIRE(errcode == 1);
+        REQUIRE(updates[0].type == CLARINET_DTLC_EVENT_DISCONNECT);
+        REQUIRE(updates[0].id == sid);
+        REQUIRE(Error(updates[0].result) == Error(CLARINET_ECONNTIMEOUT));
+        REQUIRE(server.dtlc.count == 0);
+
+        // The stale identifier is rejected even if the slot is reused.
+        REQUIRE(clarinet_dtlc_connection_find(&server.dtlc, sid) == nullptr);
+        errcode = clarinet_dtlc_send(&server.dtlc, sid, "x", 1, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTCONN));
+
+        events = client.pump(now);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_DTLC_EVENT_DISCONNECT);
+        REQUIRE(Error(events[0].result) == Error(CLARINET_ECONNRESET));
+    }
+
+    SECTION("Disconnect")
+    {
+        errcode = clarinet_dtlc_disconnect(&client.dtlc, cid, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_dtlc_disconnect(&client.dtlc, cid, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTCONN));
+
+        events = server.pump(now);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_DTLC_EVENT_DISCONNECT);
+        REQUIRE(events[0].id == sid);
+        REQUIRE(Error(events[0].result) == Error(CLARINET_ECONNRESET));
+        REQUIRE(server.dtlc.count == 0);
+    }
+}
+
+TEST_CASE("DTLC Connect Refused")
+{
+    const uint64_t now = 100000;
+
+    dtlc_peer server(1, CLARINET_DTLC_LISTEN);
+    dtlc_peer client(2, CLARINET_DTLC_NONE);
+
+    uint32_t first = 0;
+    int errcode = clarinet_dtlc_connect(&client.dtlc, &server.local, now, &first);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    uint32_t second = 0;
+    errcode = clarinet_dtlc_connect(&client.dtlc, &server.local, now, &second);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    uint32_t third = 0;
+    errcode = clarinet_dtlc_connect(&client.dtlc, &server.local, now, &third);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+
+    std::vector<clarinet_dtlc_event> events;
+    for (int i = 0; i < 3; ++i)
+    {
+        server.pump(now);
+        for (const auto& event: client.pump(now))
+            events.push_back(event);
+    }
+
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].type == CLARINET_DTLC_EVENT_CONNECT);
+    REQUIRE(events[0].id == first);
+    REQUIRE(events[1].type == CLARINET_DTLC_EVENT_DISCONNECT);
+    REQUIRE(events[1].id == second);
+    REQUIRE(Error(events[1].result) == Error(CLARINET_ECONNREFUSED));
+}
+
+TEST_CASE("DTLC Update")
+{
+    uint64_t now = 100000;
+
+    // Nobody answers the handshakes so every connection eventually times out.
+    dtlc_peer peer(1, CLARINET_DTLC_NONE);
+    dtlc_peer client(8, CLARINET_DTLC_NONE);
+
+    uint32_t ids[8];
+    for (uint32_t& id: ids)
+    {
+        const int errcode = clarinet_dtlc_connect(&client.dtlc, &peer.local, now, &id);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    // Releasing connections at the head, in the middle and at the tail of the slots in use leaves the rest intact.
+    for (const size_t i: { 0, 3, 4, 7 })
+    {
+        const int errcode = clarinet_dtlc_disconnect(&client.dtlc, ids[i], now);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+    REQUIRE(client.dtlc.count == 4);
+
+    clarinet_dtlc_event updates[8];
+    now += 6000;
+
+    SECTION("Expires every connection in use")
+    {
+        const int n = clarinet_dtlc_update(&client.dtlc, updates, 8, now);
+        REQUIRE(n == 4);
+        REQUIRE(client.dtlc.count == 0);
+
+        std::vector<uint32_t> expired;
+        for (int i = 0; i < n; ++i)
+        {
+            REQUIRE(updates[i].type == CLARINET_DTLC_EVENT_DISCONNECT);
+            REQUIRE(Error(updates[i].result) == Error(CLARINET_ECONNTIMEOUT));
+            expired.push_back(updates[i].id);
+        }
+
+        std::sort(expired.begin(), expired.end());
+        REQUIRE(expired == std::vector<uint32_t>({ ids[1], ids[2], ids[5], ids[6] }));
+    }
+
+    SECTION("Reports the remaining connections in subsequent calls")
+    {
+        int n = clarinet_dtlc_update(&client.dtlc, updates, 3, now);
+        REQUIRE(n == 3);
+        REQUIRE(client.dtlc.count == 1);
+
+        n = clarinet_dtlc_update(&client.dtlc, updates, 3, now);
+        REQUIRE(n == 1);
+        REQUIRE(client.dtlc.count == 0);
+
+        n = clarinet_dtlc_update(&client.dtlc, updates, 3, now);
+        REQUIRE(n == 0);
+    }
+
+    SECTION("Reuses released slots")
+    {
+        for (uint32_t& id: ids)
+        {
+            const int errcode = clarinet_dtlc_connect(&client.dtlc, &peer.local, now, &id);
+            if (errcode == CLARINET_ENOBUFS)
+                break;
+
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+        REQUIRE(client.dtlc.count == 8);
+
+        now += 6000;
+        const int n = clarinet_dtlc_update(&client.dtlc, updates, 8, now);
+        REQUIRE(n == 8);
+        REQUIRE(client.dtlc.count == 0);
+    }
+}
@@ -0,0 +1,317 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Endpoint Table Initialize")
+{
+    clarinet_endpoint_table table;
+    memset(&table, 0xFF, sizeof(table));
+    clarinet_endpoint_table_init(&table);
+
+    clarinet_endpoint_table expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&table, &expected, sizeof(table)) == 0);
+}
+
+TEST_CASE("Endpoint Table Calculate Size")
+{
+    int size = clarinet_endpoint_table_calcsize(0);
+    REQUIRE(Error(size) == Error(CLARINET_EINVAL));
+
+    size = clarinet_endpoint_table_calcsize(CLARINET_ENDPOINT_TABLE_CAPACITY_MAX + 1);
+    REQUIRE(Error(size) == Error(CLARINET_EINVAL));
+
+    size = clarinet_endpoint_table_calcsize(1);
+    REQUIRE(size > 0);
+
+    size = clarinet_endpoint_table_calcsize(CLARINET_ENDPOINT_TABLE_CAPACITY_MAX);
+    REQUIRE(size > 0);
+}
+
+TEST_CASE("Endpoint Table Open/Close")
+{
+    const size_t capacity = 16;
+    std::vector<uint8_t> buf((size_t)clarinet_endpoint_table_calcsize(capacity));
+
+    SECTION("With NULL table")
+    {
+        int errcode = clarinet_endpoint_table_open(nullptr, buf.data(), buf.size(), capacity, 0,
+                                                   CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN table")
+    {
+        clarinet_endpoint_table table;
+        clarinet_endpoint_table_init(&table);
+
+        int errcode = clarinet_endpoint_table_close(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_clear(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_endpoint endpoint = { clarinet_addr_loopback_ipv4, 1234 };
+        errcode = clarinet_endpoint_table_insert(&table, &endpoint, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        void* value = nullptr;
+        errcode = clarinet_endpoint_table_find(&table, &endpoint, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_remove(&table, &endpoint, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        clarinet_endpoint_table table;
+        clarinet_endpoint_table_init(&table);
+
+        int errcode = clarinet_endpoint_table_open(&table, nullptr, buf.size(), capacity, 0,
+                                                   CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), 0, 0, CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0, 0x80);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size() - 1, capacity, 0,
+                                               CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+    }
+
+    SECTION("SAME table TWICE")
+    {
+        clarinet_endpoint_table table;
+        clarinet_endpoint_table_init(&table);
+
+        int errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0,
+                                                   CLARINET_ENDPOINT_TABLE_EQUIVALENT);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(table.capacity == capacity);
+        REQUIRE(table.count == 0);
+        REQUIRE(table.flags == CLARINET_ENDPOINT_TABLE_EQUIVALENT);
+
+        errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0,
+                                               CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_close(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_endpoint_table_close(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+}
+
+TEST_CASE("Endpoint Table Insert/Find/Remove")
+{
+    const size_t capacity = 1000;
+    std::vector<uint8_t> buf((size_t)clarinet_endpoint_table_calcsize(capacity));
+
+    clarinet_endpoint_table table;
+    clarinet_endpoint_table_init(&table);
+    int errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0x5EED,
+                                               CLARINET_ENDPOINT_TABLE_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&table]
+    {
+        clarinet_endpoint_table_close(&table);
+    });
+
+    std::vector<clarinet_endpoint> endpoints(capacity);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        const uint16_t n = (uint16_t)i;
+        if (i % 2)
+            endpoints[i] = clarinet_make_endpoint(clarinet_make_ipv4(10, 0, (uint8_t)(n >> 8), (uint8_t)n), 4000);
+        else
+            endpoints[i] = clarinet_make_endpoint(clarinet_make_ipv6(0xFE80, 0, 0, 0, 0, 0, 0, n, 1), 4000);
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        void* value = nullptr;
+        errcode = clarinet_endpoint_table_insert(&table, nullptr, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_find(&table, nullptr, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_find(&table, &endpoints[0], nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_endpoint_table_remove(&table, nullptr, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_endpoint mac = { clarinet_make_mac(0, 1, 2, 3, 4, 5), 0 };
+        errcode = clarinet_endpoint_table_insert(&table, &mac, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EAFNOSUPPORT));
+    }
+
+    SECTION("Until FULL")
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            errcode = clarinet_endpoint_table_insert(&table, &endpoints[i], &endpoints[i]);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        REQUIRE(table.count == capacity);
+
+        const clarinet_endpoint extra = { clarinet_addr_loopback_ipv4, 1234 };
+        errcode = clarinet_endpoint_table_insert(&table, &extra, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+
+        errcode = clarinet_endpoint_table_insert(&table, &endpoints[0], nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EALREADY));
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            void* value = nullptr;
+            errcode = clarinet_endpoint_table_find(&table, &endpoints[i], &value);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(value == &endpoints[i]);
+        }
+
+        void* value = nullptr;
+        errcode = clarinet_endpoint_table_find(&table, &extra, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_endpoint_table_clear(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(table.count == 0);
+
+        errcode = clarinet_endpoint_table_find(&table, &endpoints[0], &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("Ignoring FLOWINFO and RESERVED fields")
+    {
+        errcode = clarinet_endpoint_table_insert(&table, &endpoints[0], &endpoints[0]);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint key;
+        memnoise(&key, sizeof(key));
+        key.addr.family = endpoints[0].addr.family;
+        key.addr.as.ipv6.u = endpoints[0].addr.as.ipv6.u;
+        key.addr.as.ipv6.scope_id = endpoints[0].addr.as.ipv6.scope_id;
+        key.port = endpoints[0].port;
+
+        void* value = nullptr;
+        errcode = clarinet_endpoint_table_find(&table, &key, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(value == &endpoints[0]);
+        REQUIRE(clarinet_endpoint_hash(&key, 1, 0) == clarinet_endpoint_hash(&endpoints[0], 1, 0));
+
+        key.addr.as.ipv6.scope_id++;
+        errcode = clarinet_endpoint_table_find(&table, &key, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("With CHURN")
+    {
+        // Keep the table almost full while entries come and go so removed slots must be reclaimed.
+        for (size_t i = 0; i < capacity - 1; ++i)
+        {
+            errcode = clarinet_endpoint_table_insert(&table, &endpoints[i], &endpoints[i]);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        size_t spare = capacity - 1;
+        for (size_t round = 0; round < 10 * capacity; ++round)
+        {
+            const size_t victim = (round * 7919) % capacity;
+            if (victim == spare)
+                continue;
+
+            void* value = nullptr;
+            errcode = clarinet_endpoint_table_remove(&table, &endpoints[victim], &value);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(value == &endpoints[victim]);
+
+            errcode = clarinet_endpoint_table_insert(&table, &endpoints[spare], &endpoints[spare]);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            spare = victim;
+        }
+
+        REQUIRE(table.count == capacity - 1);
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            void* value = nullptr;
+            errcode = clarinet_endpoint_table_find(&table, &endpoints[i], &value);
+            if (i == spare)
+            {
+                REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+            }
+            else
+            {
+                REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+                REQUIRE(value == &endpoints[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Endpoint Table Equivalence")
+{
+    const size_t capacity = 16;
+    std::vector<uint8_t> buf((size_t)clarinet_endpoint_table_calcsize(capacity));
+
+    const clarinet_endpoint ipv4 = { clarinet_make_ipv4(192, 168, 0, 1), 5000 };
+    const clarinet_endpoint ipv4mapped = { clarinet_make_ipv6(0, 0, 0, 0, 0, 0xFFFF, 0xC0A8, 0x0001, 0), 5000 };
+    REQUIRE(clarinet_endpoint_is_equivalent(&ipv4, &ipv4mapped));
+
+    clarinet_endpoint_table table;
+    clarinet_endpoint_table_init(&table);
+
+    SECTION("With EQUIVALENT flag")
+    {
+        int errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0,
+                                                   CLARINET_ENDPOINT_TABLE_EQUIVALENT);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_endpoint_table_insert(&table, &ipv4mapped, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        void* value = &table;
+        errcode = clarinet_endpoint_table_find(&table, &ipv4, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(value == nullptr);
+
+        errcode = clarinet_endpoint_table_insert(&table, &ipv4, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EALREADY));
+
+        REQUIRE(clarinet_endpoint_hash(&ipv4, 0, CLARINET_ENDPOINT_TABLE_EQUIVALENT)
+                == clarinet_endpoint_hash(&ipv4mapped, 0, CLARINET_ENDPOINT_TABLE_EQUIVALENT));
+    }
+
+    SECTION("Without EQUIVALENT flag")
+    {
+        int errcode = clarinet_endpoint_table_open(&table, buf.data(), buf.size(), capacity, 0,
+                                                   CLARINET_ENDPOINT_TABLE_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_endpoint_table_insert(&table, &ipv4mapped, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        void* value = nullptr;
+        errcode = clarinet_endpoint_table_find(&table, &ipv4, &value);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_endpoint_table_insert(&table, &ipv4, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(table.count == 2);
+    }
+
+    clarinet_endpoint_table_close(&table);
+}
@@ -0,0 +1,532 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+#define MTU 1392
+
+struct enet_host
+{
+    clarinet_socket socket;
+    clarinet_endpoint local;
+    clarinet_enet enet;
+    std::vector<clarinet_enet_peer> peers;
+
+    explicit enet_host(clarinet_packet_pool* pool, uint32_t capacity, uint32_t flags)
+        : peers(capacity)
+    {
+        clarinet_socket_init(&socket);
+        int errcode = clarinet_socket_open(&socket, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const int32_t nonblock = 1;
+        errcode = clarinet_socket_setopt(&socket, CLARINET_SO_NONBLOCK, &nonblock, sizeof(nonblock));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const clarinet_endpoint any = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(&socket, &any);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_local_endpoint(&socket, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_enet_config config;
+        memset(&config, 0, sizeof(config));
+        config.mtu = MTU;
+        config.channels = 4;
+        config.rto = 100;
+        config.ping = 500;
+        config.timeout = 5000;
+        config.flags = flags;
+
+        clarinet_enet_init(&enet);
+        errcode = clarinet_enet_open(&enet, &socket, peers.data(), capacity, pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    ~enet_host()
+    {
+        clarinet_enet_close(&enet);
+        clarinet_socket_close(&socket);
+    }
+
+    // Receive until there is nothing left, send pending acks and return the events. Messages are appended to data.
+    std::vector<clarinet_enet_event> pump(uint64_t now, std::string* data = nullptr)
+    {
+        std::vector<clarinet_enet_event> events;
+        static char buf[16384];
+        clarinet_enet_event event;
+        int errcode;
+        while ((errcode = clarinet_enet_recv(&enet, buf, sizeof(buf), &event, now)) == CLARINET_ENONE)
+        {
+            if (event.type == CLARINET_ENET_EVENT_NONE)
+                continue;
+
+            if (event.type == CLARINET_ENET_EVENT_DATA && data)
+                data->append(buf, (size_t)event.result);
+
+            events.push_back(event);
+        }
+
+        REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+
+        clarinet_enet_event expired[4];
+        errcode = clarinet_enet_update(&enet, expired, 4, now);
+        REQUIRE(errcode >= 0);
+        for (int i = 0; i < errcode; ++i)
+            events.push_back(expired[i]);
+
+        return events;
+    }
+};
+
+TEST_CASE("ENet Initialize")
+{
+    clarinet_enet enet;
+    memset(&enet, 0xFF, sizeof(enet));
+    clarinet_enet_init(&enet);
+
+    clarinet_enet expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&enet, &expected, sizeof(enet)) == 0);
+}
+
+TEST_CASE("ENet Open/Close")
+{
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+    int errcode = clarinet_packet_pool_open(&pool, MTU, 16, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    clarinet_socket socket;
+    clarinet_socket_init(&socket);
+
+    clarinet_enet_peer peers[4];
+    clarinet_enet_config config;
+    memset(&config, 0, sizeof(config));
+    config.mtu = MTU;
+    config.channels = 2;
+    config.rto = 100;
+    config.ping = 500;
+    config.timeout = 5000;
+
+    clarinet_enet enet;
+    clarinet_enet_init(&enet);
+
+    SECTION("With NULL arguments")
+    {
+        errcode = clarinet_enet_open(nullptr, &socket, peers, 4, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_open(&enet, nullptr, peers, 4, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_open(&enet, &socket, nullptr, 4, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, nullptr, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        errcode = clarinet_enet_open(&enet, &socket, peers, 0, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_open(&enet, &socket, peers, CLARINET_ENET_CAPACITY_MAX + 1, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_enet_config invalid = config;
+        invalid.mtu = CLARINET_ENET_MTU_MIN - 1;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Commands must fit in a slab of the pool.
+        invalid = config;
+        invalid.mtu = MTU + 1;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.channels = 0;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.channels = CLARINET_ENET_CHANNEL_MAX + 1;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.rto = 0;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.timeout = invalid.ping;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.flags = 0x80;
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("SAME host TWICE")
+    {
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_enet_open(&enet, &socket, peers, 4, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_close(&enet);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_enet_close(&enet);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN host")
+    {
+        char buf[16] = { 0 };
+        errcode = clarinet_enet_send(&enet, 1, 0, buf, sizeof(buf), CLARINET_ENET_RELIABLE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_enet_event event;
+        errcode = clarinet_enet_recv(&enet, buf, sizeof(buf), &event, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_update(&enet, &event, 1, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_enet_disconnect(&enet, 1, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(clarinet_enet_peer_find(&enet, 1) == nullptr);
+    }
+}
+
+TEST_CASE("ENet Peers")
+{
+    uint64_t now = 100000;
+
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+    int errcode = clarinet_packet_pool_open(&pool, MTU, 128, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    {
+        enet_host server(&pool, 4, CLARINET_ENET_LISTEN);
+        enet_host client(&pool, 2, CLARINET_ENET_NONE);
+
+        uint32_t cid = 0;
+        errcode = clarinet_enet_connect(&client.enet, &server.local, 3, 42, now, &cid);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        std::vector<clarinet_enet_event> events;
+        std::vector<clarinet_enet_event> cevents;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (const auto& event: server.pump(now))
+                events.push_back(event);
+
+            for (const auto& event: client.pump(now))
+                cevents.push_back(event);
+        }
+
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_ENET_EVENT_CONNECT);
+        REQUIRE(events[0].data == 42);
+        REQUIRE(cevents.size() == 1);
+        REQUIRE(cevents[0].type == CLARINET_ENET_EVENT_CONNECT);
+        REQUIRE(cevents[0].id == cid);
+
+        const uint32_t sid = events[0].id;
+        const clarinet_enet_peer* sender = clarinet_enet_peer_find(&client.enet, cid);
+        const clarinet_enet_peer* receiver = clarinet_enet_peer_find(&server.enet, sid);
+        REQUIRE(sender != nullptr);
+        REQUIRE(receiver != nullptr);
+        REQUIRE(sender->channel_count == 3);
+        REQUIRE(receiver->channel_count == 3);
+        REQUIRE(sender->inflight == 0);
+
+        SECTION("Reliable messages are delivered and released when acknowledged")
+        {
+            errcode = clarinet_enet_send(&client.enet, cid, 1, "hello", 5, CLARINET_ENET_RELIABLE, now);
+            REQUIRE(errcode == 5);
+            REQUIRE(sender->inflight == 1);
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].type == CLARINET_ENET_EVENT_DATA);
+            REQUIRE(events[0].id == sid);
+            REQUIRE(events[0].channel == 1);
+            REQUIRE(data == "hello");
+
+            client.pump(now);
+            REQUIRE(sender->inflight == 0);
+
+            errcode = clarinet_enet_send(&client.enet, cid, 3, "hello", 5, CLARINET_ENET_RELIABLE, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        }
+
+        SECTION("Large reliable messages are fragmented")
+        {
+            std::string message(6000, '\0');
+            for (size_t i = 0; i < message.size(); ++i)
+                message[i] = (char)(i * 7);
+
+            errcode = clarinet_enet_send(&client.enet, cid, 2, message.data(), message.size(), CLARINET_ENET_RELIABLE,
+                                         now);
+            REQUIRE(errcode == (int)message.size());
+            REQUIRE(sender->inflight == 5);
+
+            // Drop the first fragment. The others are held until it is resent.
+            char junk[MTU];
+            clarinet_endpoint remote;
+            errcode = clarinet_socket_recvfrom(&server.socket, junk, sizeof(junk), &remote);
+            REQUIRE(errcode == MTU);
+
+            std::string data;
+            REQUIRE(server.pump(now, &data).empty());
+            REQUIRE(receiver->held == 4);
+
+            client.pump(now);
+            REQUIRE(sender->inflight == 1);
+
+            now += 100;
+            client.pump(now);
+            REQUIRE(sender->retransmissions == 1);
+
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].channel == 2);
+            REQUIRE(data == message);
+            REQUIRE(receiver->held == 0);
+        }
+
+        SECTION("Unreliable messages")
+        {
+            errcode = clarinet_enet_send(&server.enet, sid, 0, "A", 1, CLARINET_ENET_UNRELIABLE, now);
+            REQUIRE(errcode == 1);
+
+            errcode = clarinet_enet_send(&server.enet, sid, 0, "B", 1, CLARINET_ENET_UNSEQUENCED, now);
+            REQUIRE(errcode == 1);
+
+            std::string data;
+            events = client.pump(now, &data);
+            REQUIRE(events.size() == 2);
+            REQUIRE(data == "AB");
+
+            // Unreliable messages are not fragmented.
+            std::string message(MTU, 'x');
+            errcode = clarinet_enet_send(&server.enet, sid, 0, message.data(), message.size(),
+                                         CLARINET_ENET_UNRELIABLE, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_EMSGSIZE));
+        }
+
+        SECTION("Window")
+        {
+            for (int i = 0; i < CLARINET_ENET_WINDOW; ++i)
+            {
+                errcode = clarinet_enet_send(&client.enet, cid, 0, "W", 1, CLARINET_ENET_RELIABLE, now);
+                REQUIRE(errcode == 1);
+            }
+
+            errcode = clarinet_enet_send(&client.enet, cid, 0, "W", 1, CLARINET_ENET_RELIABLE, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+
+            errcode = clarinet_enet_send(&client.enet, cid, 0, "U", 1, CLARINET_ENET_UNRELIABLE, now);
+            REQUIRE(errcode == 1);
+        }
+
+        SECTION("Disconnect")
+        {
+            errcode = clarinet_enet_disconnect(&client.enet, cid, 7, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(clarinet_enet_peer_find(&client.enet, cid) == nullptr);
+
+            errcode = clarinet_enet_send(&client.enet, cid, 0, "A", 1, CLARINET_ENET_RELIABLE, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENOTCONN));
+
+            events = server.pump(now);
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].type == CLARINET_ENET_EVENT_DISCONNECT);
+            REQUIRE(events[0].id == sid);
+            REQUIRE(events[0].data == 7);
+            REQUIRE(server.enet.count == 0);
+
+            // Released slots are reused by new connections.
+            errcode = clarinet_enet_connect(&client.enet, &server.local, 1, 0, now, &cid);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            for (int i = 0; i < 3; ++i)
+            {
+                server.pump(now);
+                client.pump(now);
+            }
+
+            REQUIRE(clarinet_enet_peer_find(&client.enet, cid)->state == CLARINET_ENET_STATE_CONNECTED);
+            REQUIRE(server.enet.count == 1);
+            REQUIRE(client.enet.count == 1);
+        }
+
+        SECTION("Timeout")
+        {
+            now += 5000;
+            events = server.pump(now);
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].type == CLARINET_ENET_EVENT_DISCONNECT);
+            REQUIRE(Error(events[0].result) == Error(CLARINET_ECONNTIMEOUT));
+        }
+    }
+
+    // Every slab must be back in the pool once the hosts are closed.
+    for (uint32_t i = 0; i < pool.count; ++i)
+    {
+        void* buf = nullptr;
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+}
+
+TEST_CASE("ENet Interop")
+{
+    // Datagrams laid out as produced by upstream ENet 1.3 (enet_host_connect() and enet_peer_send() on a fresh host).
+    static const uint8_t connect[] = {
+        0x8F, 0xFF, 0x01, 0x02,                             // peer id 0xFFF | SENT_TIME, sent time
+        0x82, 0xFF, 0x00, 0x01,                             // CONNECT | ACKNOWLEDGE, channel 0xFF, rsn 1
+        0x00, 0x00, 0xFF, 0xFF,                             // outgoing peer id, incoming and outgoing session ids
+        0x00, 0x00, 0x05, 0x70,                             // mtu 1392
+        0x00, 0x01, 0x00, 0x00,                             // window size 65536
+        0x00, 0x00, 0x00, 0x02,                             // channel count
+        0x00, 0x00, 0x00, 0x00,                             // incoming bandwidth
+        0x00, 0x00, 0x00, 0x00,                             // outgoing bandwidth
+        0x00, 0x00, 0x13, 0x88,                             // packet throttle interval
+        0x00, 0x00, 0x00, 0x02,                             // packet throttle acceleration
+        0x00, 0x00, 0x00, 0x02,                             // packet throttle deceleration
+        0x12, 0x34, 0x56, 0x78,                             // connect id
+        0x00, 0x00, 0x00, 0x0A                              // data
+    };
+
+    static const uint8_t verify[] = {
+        0x01, 0xFF, 0x00, 0x01, 0x00, 0x01, 0x01, 0x02,     // ACKNOWLEDGE of the CONNECT echoing its sent time
+        0x83, 0xFF, 0x00, 0x01,                             // VERIFY_CONNECT | ACKNOWLEDGE, channel 0xFF, rsn 1
+        0x00, 0x00, 0x00, 0x00,                             // outgoing peer id, incoming and outgoing session ids
+        0x00, 0x00, 0x05, 0x70,
+        0x00, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x02,
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x13, 0x88,
+        0x00, 0x00, 0x00, 0x02,
+        0x00, 0x00, 0x00, 0x02,
+        0x12, 0x34, 0x56, 0x78
+    };
+
+    uint64_t now = 100000;
+
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+    int errcode = clarinet_packet_pool_open(&pool, MTU, 16, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    enet_host server(&pool, 4, CLARINET_ENET_LISTEN);
+
+    clarinet_socket socket;
+    clarinet_socket_init(&socket);
+    errcode = clarinet_socket_open(&socket, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onclose = finalizer([&socket]
+    {
+        clarinet_socket_close(&socket);
+    });
+
+    const clarinet_endpoint any = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    errcode = clarinet_socket_bind(&socket, &any);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_socket_sendto(&socket, connect, sizeof(connect), &server.local);
+    REQUIRE(errcode == (int)sizeof(connect));
+    REQUIRE(server.pump(now).empty());
+
+    uint8_t reply[MTU];
+    clarinet_endpoint remote;
+    errcode = clarinet_socket_recvfrom(&socket, reply, sizeof(reply), &remote);
+    REQUIRE(errcode == (int)(4 + sizeof(verify)));
+    REQUIRE(reply[0] == 0x80);                              // peer id 0 | session 0 | SENT_TIME
+    REQUIRE(reply[1] == 0x00);
+    REQUIRE(memcmp(&reply[4], verify, sizeof(verify)) == 0);
+
+    // A retransmitted request is found by its connect id and endpoint and ignored.
+    errcode = clarinet_socket_sendto(&socket, connect, sizeof(connect), &server.local);
+    REQUIRE(errcode == (int)sizeof(connect));
+    REQUIRE(server.pump(now).empty());
+    REQUIRE(server.enet.count == 1);
+
+    // ACKNOWLEDGE of the VERIFY_CONNECT without a sent time completes the handshake.
+    const uint8_t ack[] = { 0x00, 0x00, 0x01, 0xFF, 0x00, 0x01, 0x00, 0x01, reply[2], reply[3] };
+    errcode = clarinet_socket_sendto(&socket, ack, sizeof(ack), &server.local);
+    REQUIRE(errcode == (int)sizeof(ack));
+
+    auto events = server.pump(now);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == CLARINET_ENET_EVENT_CONNECT);
+    REQUIRE(events[0].data == 0x0A);
+
+    // Compressed datagrams are dropped as a whole.
+    const uint8_t compressed[] = { 0xC0, 0x00, 0x00, 0x10, 0x86, 0x01, 0x00, 0x01, 0x00, 0x02, 'h', 'i' };
+    errcode = clarinet_socket_sendto(&socket, compressed, sizeof(compressed), &server.local);
+    REQUIRE(errcode == (int)sizeof(compressed));
+    REQUIRE(server.pump(now).empty());
+
+    // Unreliable fragments are rejected without an ack and the rest of the datagram is processed.
+    const uint8_t reliable[] = {
+        0x80, 0x00, 0x00, 0x10,                             // peer id 0 | SENT_TIME, sent time
+        0x8C, 0x01, 0x00, 0x00,                             // SEND_UNRELIABLE_FRAGMENT | ACKNOWLEDGE, channel 1
+        0x00, 0x01, 0x00, 0x01,                             // start sequence number, data length
+        0x00, 0x00, 0x00, 0x02,                             // fragment count
+        0x00, 0x00, 0x00, 0x00,                             // fragment number
+        0x00, 0x00, 0x00, 0x02,                             // total length
+        0x00, 0x00, 0x00, 0x00,                             // fragment offset
+        'x',
+        0x86, 0x01, 0x00, 0x01, 0x00, 0x02, 'h', 'i'        // SEND_RELIABLE | ACKNOWLEDGE, channel 1, rsn 1
+    };
+    errcode = clarinet_socket_sendto(&socket, reliable, sizeof(reliable), &server.local);
+    REQUIRE(errcode == (int)sizeof(reliable));
+
+    std::string data;
+    events = server.pump(now, &data);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == CLARINET_ENET_EVENT_DATA);
+    REQUIRE(events[0].channel == 1);
+    REQUIRE(data == "hi");
+
+    // The ack goes alone so the header has no sent time.
+    static const uint8_t expected[] = { 0x00, 0x00, 0x01, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x10 };
+    errcode = clarinet_socket_recvfrom(&socket, reply, sizeof(reply), &remote);
+    REQUIRE(errcode == (int)sizeof(expected));
+    REQUIRE(memcmp(reply, expected, sizeof(expected)) == 0);
+}
@@ -0,0 +1,410 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+#define CHANNEL_UNRELIABLE  0
+#define CHANNEL_SEQUENCED   1
+#define CHANNEL_RELIABLE    2
+#define CHANNEL_ORDERED     3
+
+struct gdtp_peer
+{
+    clarinet_socket socket;
+    clarinet_endpoint local;
+    clarinet_dtlc dtlc;
+    clarinet_gdtp gdtp;
+    std::vector<clarinet_dtlc_connection> connections;
+    std::vector<clarinet_gdtp_connection> states;
+
+    explicit gdtp_peer(clarinet_packet_pool* pool, uint32_t capacity, uint32_t flags)
+        : connections(capacity), states(capacity)
+    {
+        clarinet_socket_init(&socket);
+        int errcode = clarinet_socket_open(&socket, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const int32_t nonblock = 1;
+        errcode = clarinet_socket_setopt(&socket, CLARINET_SO_NONBLOCK, &nonblock, sizeof(nonblock));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const clarinet_endpoint any = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(&socket, &any);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_local_endpoint(&socket, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_dtlc_config config;
+        memset(&config, 0, sizeof(config));
+        memcpy(config.secret, "0123456789ABCDEF", sizeof(config.secret));
+        config.keepalive = 1000;
+        config.timeout = 5000;
+        config.flags = flags;
+
+        clarinet_dtlc_init(&dtlc);
+        errcode = clarinet_dtlc_open(&dtlc, &socket, connections.data(), capacity, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_gdtp_config gconfig;
+        memset(&gconfig, 0, sizeof(gconfig));
+        gconfig.channels[CHANNEL_UNRELIABLE] = CLARINET_GDTP_UNRELIABLE;
+        gconfig.channels[CHANNEL_SEQUENCED] = CLARINET_GDTP_SEQUENCED;
+        gconfig.channels[CHANNEL_RELIABLE] = CLARINET_GDTP_RELIABLE;
+        gconfig.channels[CHANNEL_ORDERED] = CLARINET_GDTP_ORDERED;
+        gconfig.nchannels = 4;
+        gconfig.mtu = 1200;
+        gconfig.rto = 100;
+        gconfig.ack_delay = 10;
+
+        clarinet_gdtp_init(&gdtp);
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states.data(), pool, &gconfig);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    ~gdtp_peer()
+    {
+        clarinet_gdtp_close(&gdtp);
+        clarinet_dtlc_close(&dtlc);
+        clarinet_socket_close(&socket);
+    }
+
+    // Receive until there is nothing left and return the events of interest. Messages received are appended to data.
+    std::vector<clarinet_gdtp_event> pump(uint64_t now, std::string* data = nullptr)
+    {
+        std::vector<clarinet_gdtp_event> events;
+        char buf[1200 + CLARINET_GDTP_HEADER_SIZE];
+        clarinet_gdtp_event event;
+        int errcode;
+        while ((errcode = clarinet_gdtp_recv(&gdtp, buf, sizeof(buf), &event, now)) == CLARINET_ENONE)
+        {
+            if (event.type == CLARINET_GDTP_EVENT_NONE)
+                continue;
+
+            if (event.type == CLARINET_GDTP_EVENT_DATA && data)
+                data->append(buf, (size_t)event.result);
+
+            events.push_back(event);
+        }
+
+        REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+        return events;
+    }
+
+    // Send a raw GDTP datagram that does not carry any acks.
+    void inject(uint32_t id, uint16_t seq, uint8_t channel, uint16_t msgseq, const char* payload)
+    {
+        uint8_t packet[64] = { 0 };
+        packet[0] = (uint8_t)(seq >> 8);
+        packet[1] = (uint8_t)seq;
+        packet[8] = channel;
+        packet[9] = (uint8_t)(msgseq >> 8);
+        packet[10] = (uint8_t)msgseq;
+        const size_t len = strlen(payload);
+        memcpy(&packet[CLARINET_GDTP_HEADER_SIZE], payload, len);
+        const int errcode = clarinet_dtlc_send(&dtlc, id, packet, CLARINET_GDTP_HEADER_SIZE + len, 0);
+        REQUIRE(errcode == (int)(CLARINET_GDTP_HEADER_SIZE + len));
+    }
+};
+
+TEST_CASE("GDTP Initialize")
+{
+    clarinet_gdtp gdtp;
+    memset(&gdtp, 0xFF, sizeof(gdtp));
+    clarinet_gdtp_init(&gdtp);
+
+    clarinet_gdtp expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&gdtp, &expected, sizeof(gdtp)) == 0);
+}
+
+TEST_CASE("GDTP Open/Close")
+{
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+    int errcode = clarinet_packet_pool_open(&pool, 1200, 16, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    clarinet_socket socket;
+    clarinet_socket_init(&socket);
+
+    clarinet_dtlc_connection connections[4];
+    clarinet_dtlc_config dconfig;
+    memset(&dconfig, 0, sizeof(dconfig));
+    dconfig.keepalive = 1000;
+    dconfig.timeout = 5000;
+
+    clarinet_dtlc dtlc;
+    clarinet_dtlc_init(&dtlc);
+    errcode = clarinet_dtlc_open(&dtlc, &socket, connections, 4, &dconfig);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_gdtp_connection states[4];
+    clarinet_gdtp_config config;
+    memset(&config, 0, sizeof(config));
+    config.channels[0] = CLARINET_GDTP_ORDERED;
+    config.nchannels = 1;
+    config.mtu = 1200;
+    config.rto = 100;
+
+    clarinet_gdtp gdtp;
+    clarinet_gdtp_init(&gdtp);
+
+    SECTION("With NULL arguments")
+    {
+        errcode = clarinet_gdtp_open(nullptr, &dtlc, states, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_open(&gdtp, nullptr, states, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, nullptr, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, nullptr, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        clarinet_gdtp_config invalid = config;
+        invalid.nchannels = 0;
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.nchannels = CLARINET_GDTP_CHANNEL_MAX + 1;
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.channels[0] = CLARINET_GDTP_ORDERED + 1;
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Messages must fit in a slab of the pool.
+        invalid = config;
+        invalid.mtu = 1201;
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        invalid = config;
+        invalid.rto = 0;
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &invalid);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("SAME endpoint TWICE")
+    {
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_gdtp_open(&gdtp, &dtlc, states, &pool, &config);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_gdtp_close(&gdtp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_gdtp_close(&gdtp);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    clarinet_dtlc_close(&dtlc);
+}
+
+TEST_CASE("GDTP Channels")
+{
+    uint64_t now = 100000;
+
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+    int errcode = clarinet_packet_pool_open(&pool, 1200, 64, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    {
+        gdtp_peer server(&pool, 4, CLARINET_DTLC_LISTEN);
+        gdtp_peer client(&pool, 2, CLARINET_DTLC_NONE);
+
+        uint32_t cid = 0;
+        errcode = clarinet_gdtp_connect(&client.gdtp, &server.local, now, &cid);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        std::vector<clarinet_gdtp_event> events;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (const auto& event: server.pump(now))
+                events.push_back(event);
+
+            client.pump(now);
+        }
+
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == CLARINET_GDTP_EVENT_CONNECT);
+        const uint32_t sid = events[0].id;
+        const clarinet_gdtp_connection* sender = &client.states[clarinet_dtlc_slot(cid)];
+
+        SECTION("Reliable messages are released when acknowledged")
+        {
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_ORDERED, "A", 1, now);
+            REQUIRE(errcode == 1);
+            REQUIRE(sender->inflight == 1);
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].type == CLARINET_GDTP_EVENT_DATA);
+            REQUIRE(events[0].id == sid);
+            REQUIRE(events[0].channel == CHANNEL_ORDERED);
+            REQUIRE(data == "A");
+
+            // Nothing to piggyback on so the ack goes alone after the delay.
+            clarinet_gdtp_event updates[4];
+            now += 5;
+            REQUIRE(clarinet_gdtp_update(&server.gdtp, updates, 4, now) == 0);
+            client.pump(now);
+            REQUIRE(sender->inflight == 1);
+
+            now += 10;
+            REQUIRE(clarinet_gdtp_update(&server.gdtp, updates, 4, now) == 0);
+            client.pump(now);
+            REQUIRE(sender->inflight == 0);
+        }
+
+        SECTION("Acks are piggybacked on data")
+        {
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "A", 1, now);
+            REQUIRE(errcode == 1);
+            server.pump(now);
+
+            errcode = clarinet_gdtp_send(&server.gdtp, sid, CHANNEL_UNRELIABLE, "B", 1, now);
+            REQUIRE(errcode == 1);
+
+            std::string data;
+            events = client.pump(now, &data);
+            REQUIRE(events.size() == 1);
+            REQUIRE(data == "B");
+            REQUIRE(sender->inflight == 0);
+        }
+
+        SECTION("Lost reliable messages are resent")
+        {
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "X", 1, now);
+            REQUIRE(errcode == 1);
+
+            // Drop the datagram.
+            char junk[1500];
+            clarinet_endpoint remote;
+            errcode = clarinet_socket_recvfrom(&server.socket, junk, sizeof(junk), &remote);
+            REQUIRE(errcode > 0);
+
+            clarinet_gdtp_event updates[4];
+            now += 50;
+            REQUIRE(clarinet_gdtp_update(&client.gdtp, updates, 4, now) == 0);
+            REQUIRE(server.pump(now).empty());
+
+            now += 50;
+            REQUIRE(clarinet_gdtp_update(&client.gdtp, updates, 4, now) == 0);
+            REQUIRE(sender->retransmissions == 1);
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 1);
+            REQUIRE(data == "X");
+        }
+
+        SECTION("Ordered messages are delivered in order")
+        {
+            client.inject(cid, 100, CHANNEL_ORDERED, 2, "C");
+            client.inject(cid, 101, CHANNEL_ORDERED, 1, "B");
+            client.inject(cid, 102, CHANNEL_ORDERED, 0, "A");
+            client.inject(cid, 103, CHANNEL_ORDERED, 1, "B");
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 3);
+            REQUIRE(data == "ABC");
+        }
+
+        SECTION("Reliable messages are delivered once")
+        {
+            client.inject(cid, 100, CHANNEL_RELIABLE, 7, "B");
+            client.inject(cid, 101, CHANNEL_RELIABLE, 7, "B");
+            client.inject(cid, 102, CHANNEL_RELIABLE, 5, "A");
+            client.inject(cid, 103, CHANNEL_RELIABLE, 5, "A");
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 2);
+            REQUIRE(data == "BA");
+        }
+
+        SECTION("Sequenced messages older than the last delivered are discarded")
+        {
+            client.inject(cid, 100, CHANNEL_SEQUENCED, 9, "B");
+            client.inject(cid, 101, CHANNEL_SEQUENCED, 8, "A");
+            client.inject(cid, 102, CHANNEL_SEQUENCED, 10, "C");
+
+            std::string data;
+            events = server.pump(now, &data);
+            REQUIRE(events.size() == 2);
+            REQUIRE(data == "BC");
+        }
+
+        SECTION("Window")
+        {
+            for (int i = 0; i < CLARINET_GDTP_WINDOW; ++i)
+            {
+                errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "W", 1, now);
+                REQUIRE(errcode == 1);
+            }
+
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "W", 1, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+
+            // Unreliable messages are not limited by the window.
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_UNRELIABLE, "U", 1, now);
+            REQUIRE(errcode == 1);
+        }
+
+        SECTION("Disconnect")
+        {
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "A", 1, now);
+            REQUIRE(errcode == 1);
+
+            errcode = clarinet_gdtp_disconnect(&client.gdtp, cid, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            errcode = clarinet_gdtp_send(&client.gdtp, cid, CHANNEL_RELIABLE, "A", 1, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENOTCONN));
+
+            events = server.pump(now);
+            REQUIRE(events.size() == 2);
+            REQUIRE(events[1].type == CLARINET_GDTP_EVENT_DISCONNECT);
+            REQUIRE(events[1].id == sid);
+        }
+    }
+
+    // Every slab must be back in the pool once the endpoints are closed.
+    for (uint32_t i = 0; i < pool.count; ++i)
+    {
+        void* buf = nullptr;
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+}
@@ -0,0 +1,309 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Interface List")
+{
+    clarinet_iface iface;
+    size_t len = 1;
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_iface_getlist(nullptr, &len);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_getlist(&iface, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("Contains the loopback address")
+    {
+        len = 0;
+        int errcode = clarinet_iface_getlist(&iface, &len);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+        REQUIRE(len > 0);
+
+        std::vector<clarinet_iface> list(len);
+        errcode = clarinet_iface_getlist(list.data(), &len);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(len == list.size());
+
+        uint32_t index = 0;
+        errcode = clarinet_iface_getindex("lo", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        bool found = false;
+        for (const auto& entry: list)
+        {
+            if (entry.index == index && clarinet_addr_is_equal(&entry.addr, &clarinet_addr_loopback_ipv4))
+            {
+                REQUIRE(entry.netmask.family == CLARINET_AF_INET);
+                REQUIRE(entry.netmask.as.ipv4.u.byte[0] == 255);
+                REQUIRE(entry.netmask.as.ipv4.u.byte[1] == 0);
+                found = true;
+            }
+        }
+
+        REQUIRE(found);
+    }
+    #endif
+}
+
+TEST_CASE("Interface Index/Name")
+{
+    char name[CLARINET_IFACE_NAME_MAX];
+    uint32_t index = 0;
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_iface_getindex(nullptr, &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_getindex("lo", nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_getname(1, nullptr, sizeof(name));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("Round trip")
+    {
+        int errcode = clarinet_iface_getindex("lo", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(index > 0);
+
+        errcode = clarinet_iface_getname(index, name, sizeof(name));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(std::string(name) == "lo");
+
+        errcode = clarinet_iface_getname(index, name, 2);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+    }
+
+    SECTION("Unknown interface")
+    {
+        int errcode = clarinet_iface_getindex("clarinet-none", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_iface_getname(0, name, sizeof(name));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+    #endif
+}
+
+TEST_CASE("Interface Table Initialize")
+{
+    clarinet_iface_table table;
+    memset(&table, 0xFF, sizeof(table));
+    clarinet_iface_table_init(&table);
+
+    clarinet_iface_table expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&table, &expected, sizeof(table)) == 0);
+}
+
+TEST_CASE("Interface Table Open/Close")
+{
+    clarinet_iface_table table;
+    clarinet_iface_table_init(&table);
+
+    clarinet_iface_link links[64];
+    clarinet_iface addrs[256];
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_iface_table_open(nullptr, links, 64, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_open(&table, nullptr, 64, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_open(&table, links, 0, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_open(&table, links, 64, nullptr, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_open(&table, links, 64, addrs, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("When not open")
+    {
+        clarinet_iface_event event;
+        clarinet_iface_link link;
+        clarinet_addr addr;
+        uint32_t index;
+
+        int errcode = clarinet_iface_table_close(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_update(&table, &event, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_getlink(&table, 1, &link);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_getindex(&table, "lo", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_getaddr(&table, 1, CLARINET_AF_INET, &addr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("Open twice")
+    {
+        int errcode = clarinet_iface_table_open(&table, links, 64, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onexit = finalizer([&]
+        {
+            clarinet_iface_table_close(&table);
+        });
+
+        errcode = clarinet_iface_table_open(&table, links, 64, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With too many addresses")
+    {
+        size_t len = 0;
+        clarinet_iface iface;
+        clarinet_iface_getlist(&iface, &len);
+        std::vector<clarinet_iface> list(len);
+        REQUIRE(Error(clarinet_iface_getlist(list.data(), &len)) == Error(CLARINET_ENONE));
+
+        uint32_t count = 0;
+        for (const auto& entry: list)
+        {
+            if (entry.addr.family == CLARINET_AF_INET || entry.addr.family == CLARINET_AF_INET6)
+                count++;
+        }
+
+        if (count > 1)
+        {
+            int errcode = clarinet_iface_table_open(&table, links, 64, addrs, count - 1);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+            REQUIRE(table.links == nullptr);
+        }
+    }
+
+    SECTION("Open and close")
+    {
+        int errcode = clarinet_iface_table_open(&table, links, 64, addrs, 256);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(table.nlinks > 0);
+        REQUIRE(table.naddrs > 0);
+        REQUIRE(table.version > 0);
+        REQUIRE(table.socket.family != CLARINET_AF_UNSPEC);
+
+        errcode = clarinet_iface_table_close(&table);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(table.links == nullptr);
+    }
+    #endif
+}
+
+#if defined(__linux__)
+TEST_CASE("Interface Table Lookup")
+{
+    clarinet_iface_table table;
+    clarinet_iface_table_init(&table);
+
+    clarinet_iface_link links[64];
+    clarinet_iface addrs[256];
+    int errcode = clarinet_iface_table_open(&table, links, 64, addrs, 256);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&]
+    {
+        clarinet_iface_table_close(&table);
+    });
+
+    uint32_t expected = 0;
+    REQUIRE(Error(clarinet_iface_getindex("lo", &expected)) == Error(CLARINET_ENONE));
+
+    SECTION("Link")
+    {
+        uint32_t index = 0;
+        errcode = clarinet_iface_table_getindex(&table, "lo", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(index == expected);
+
+        clarinet_iface_link link;
+        errcode = clarinet_iface_table_getlink(&table, index, &link);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(link.index == index);
+        REQUIRE(std::string(link.name) == "lo");
+        REQUIRE((link.flags & CLARINET_IFACE_LINK_LOOPBACK) != 0);
+        REQUIRE((link.flags & CLARINET_IFACE_LINK_UP) != 0);
+        REQUIRE(link.mtu > 0);
+    }
+
+    SECTION("Source address")
+    {
+        clarinet_addr addr;
+        errcode = clarinet_iface_table_getaddr(&table, expected, CLARINET_AF_INET, &addr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_addr_is_equal(&addr, &clarinet_addr_loopback_ipv4));
+
+        errcode = clarinet_iface_table_getaddr(&table, expected, CLARINET_AF_LINK, &addr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("Unknown interface")
+    {
+        uint32_t index = 0;
+        errcode = clarinet_iface_table_getindex(&table, "clarinet-none", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        clarinet_iface_link link;
+        errcode = clarinet_iface_table_getlink(&table, 0, &link);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        clarinet_addr addr;
+        errcode = clarinet_iface_table_getaddr(&table, 0, CLARINET_AF_INET, &addr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("Update")
+    {
+        clarinet_iface_event events[16];
+        errcode = clarinet_iface_table_update(&table, nullptr, 16);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_iface_table_update(&table, events, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // No interface changes are expected while testing but the table must remain consistent if there are any
+        errcode = clarinet_iface_table_update(&table, events, 16);
+        REQUIRE(errcode >= 0);
+        REQUIRE(errcode <= 16);
+
+        uint32_t index = 0;
+        errcode = clarinet_iface_table_getindex(&table, "lo", &index);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(index == expected);
+    }
+
+    SECTION("Poll notification socket")
+    {
+        clarinet_poller poller;
+        clarinet_poller_init(&poller);
+        errcode = clarinet_poller_open(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_poller_add(&poller, &table.socket, CLARINET_POLL_RECV, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_poller_remove(&poller, &table.socket);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        REQUIRE(Error(clarinet_poller_close(&poller)) == Error(CLARINET_ENONE));
+    }
+}
+#endif
@@ -0,0 +1,435 @@
+#include "test.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+struct collector
+{
+    std::vector<clarinet_log_record> records;
+    std::vector<std::string> messages;
+};
+
+static
+void
+collect(void* context,
+        const clarinet_log_record* record,
+        const char* message)
+{
+    auto* c = (collector*)context;
+    c->records.push_back(*record);
+    c->messages.emplace_back(message);
+}
+
+TEST_CASE("Log Initialize")
+{
+    clarinet_log log;
+    memset(&log, 0xFF, sizeof(log));
+    clarinet_log_init(&log);
+
+    clarinet_log expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&log, &expected, sizeof(log)) == 0);
+}
+
+TEST_CASE("Log Format")
+{
+    clarinet_log_record record;
+    memset(&record, 0, sizeof(record));
+    char message[CLARINET_LOG_MESSAGE_SIZE];
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_log_format(nullptr, sizeof(message), &record);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_format(message, 0, &record);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_format(message, sizeof(message), nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("KNOWN event")
+    {
+        record.event = CLARINET_LOG_EVENT_DTLC_DISCONNECT;
+        record.args[0] = 65537;
+        record.args[1] = CLARINET_ECONNTIMEOUT;
+        int n = clarinet_log_format(message, sizeof(message), &record);
+        REQUIRE(std::string(message) == "dtlc connection 65537 terminated (error -32)");
+        REQUIRE(n == (int)strlen(message));
+    }
+
+    SECTION("UNKNOWN event")
+    {
+        record.event = 9999;
+        record.args[0] = 1;
+        record.args[3] = -4;
+        int n = clarinet_log_format(message, sizeof(message), &record);
+        REQUIRE(std::string(message) == "event 9999: 1 0 0 -4");
+        REQUIRE(n == (int)strlen(message));
+    }
+
+    SECTION("With SHORT buffer")
+    {
+        record.event = CLARINET_LOG_EVENT_SOCKET_CLOSE;
+        record.args[0] = 3;
+        int errcode = clarinet_log_format(message, 7, &record);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+        REQUIRE(std::string(message) == "socket");
+    }
+}
+
+TEST_CASE("Log Open/Close")
+{
+    clarinet_log_ring rings[2];
+    clarinet_log_record records[2 * 8];
+
+    SECTION("With NULL log")
+    {
+        int errcode = clarinet_log_open(nullptr, rings, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_drain(nullptr, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        clarinet_log log;
+        clarinet_log_init(&log);
+
+        int errcode = clarinet_log_open(&log, nullptr, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_open(&log, rings, 0, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_open(&log, rings, 2, nullptr, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const uint32_t capacity = GENERATE(0u, 6u, (uint32_t)CLARINET_LOG_CAPACITY_MAX * 2);
+        errcode = clarinet_log_open(&log, rings, 2, records, capacity);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN log")
+    {
+        clarinet_log log;
+        clarinet_log_init(&log);
+
+        int errcode = clarinet_log_close(&log);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_setsink(&log, collect, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_setlevel(&log, CLARINET_LOG_LEVEL_DEBUG);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_drain(&log, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(CLARINET_ENABLE_LOG)
+    SECTION("SAME log TWICE")
+    {
+        clarinet_log log;
+        clarinet_log_init(&log);
+
+        int errcode = clarinet_log_open(&log, rings, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(log.count == 2);
+        REQUIRE(log.capacity == 8);
+        REQUIRE(log.level == CLARINET_LOG_LEVEL_INFO);
+
+        errcode = clarinet_log_open(&log, rings, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_close(&log);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_close(&log);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("TWO logs")
+    {
+        clarinet_log log;
+        clarinet_log_init(&log);
+        clarinet_log other;
+        clarinet_log_init(&other);
+        clarinet_log_ring other_rings[1];
+        clarinet_log_record other_records[8];
+
+        int errcode = clarinet_log_open(&log, rings, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_open(&other, other_rings, 1, other_records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EALREADY));
+
+        errcode = clarinet_log_close(&log);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_open(&other, other_rings, 1, other_records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_close(&other);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+    #else
+    SECTION("NOT supported")
+    {
+        clarinet_log log;
+        clarinet_log_init(&log);
+
+        int errcode = clarinet_log_open(&log, rings, 2, records, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, 1, 2, 3, 4);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+
+        errcode = clarinet_log_detach();
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+    }
+    #endif
+}
+
+#if defined(CLARINET_ENABLE_LOG)
+TEST_CASE("Log Write/Drain")
+{
+    clarinet_log_ring rings[4];
+    clarinet_log_record records[4 * 8];
+    clarinet_log log;
+    clarinet_log_init(&log);
+
+    int errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, 1, 2, 3, 4);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENOTREADY));
+
+    errcode = clarinet_log_open(&log, rings, 4, records, 8);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&log]
+    {
+        clarinet_log_detach();
+        clarinet_log_close(&log);
+    });
+
+    collector c;
+    errcode = clarinet_log_setsink(&log, collect, &c);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    SECTION("With INVALID arguments")
+    {
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_NONE, CLARINET_LOG_EVENT_USER, 0, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_write(-1, CLARINET_LOG_EVENT_USER, 0, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_setlevel(&log, CLARINET_LOG_LEVEL_NONE + 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_log_drain(&log, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("In order")
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            errcode = clarinet_log_write(CLARINET_LOG_LEVEL_WARN, CLARINET_LOG_EVENT_USER, i, -i, 0, 0);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        int n = clarinet_log_drain(&log, 2);
+        REQUIRE(n == 2);
+        n = clarinet_log_drain(&log, 16);
+        REQUIRE(n == 1);
+        n = clarinet_log_drain(&log, 16);
+        REQUIRE(n == 0);
+
+        REQUIRE(c.records.size() == 3);
+        for (size_t i = 0; i < c.records.size(); ++i)
+        {
+            REQUIRE(c.records[i].level == CLARINET_LOG_LEVEL_WARN);
+            REQUIRE(c.records[i].event == CLARINET_LOG_EVENT_USER);
+            REQUIRE(c.records[i].args[0] == (int64_t)i);
+            REQUIRE(c.records[i].args[1] == -(int64_t)i);
+            if (i > 0)
+                REQUIRE(c.records[i].timestamp >= c.records[i - 1].timestamp);
+        }
+        REQUIRE(c.messages[2] == "2 -2 0 0");
+    }
+
+    SECTION("Below level")
+    {
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_DEBUG, CLARINET_LOG_EVENT_USER, 1, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_log_drain(&log, 16) == 0);
+
+        errcode = clarinet_log_setlevel(&log, CLARINET_LOG_LEVEL_TRACE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_TRACE, CLARINET_LOG_EVENT_USER, 2, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_setlevel(&log, CLARINET_LOG_LEVEL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_ERROR, CLARINET_LOG_EVENT_USER, 3, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        REQUIRE(clarinet_log_drain(&log, 16) == 1);
+        REQUIRE(c.records[0].args[0] == 2);
+    }
+
+    SECTION("With FULL ring")
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, i, 0, 0, 0);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, i, 0, 0, 0);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+        }
+
+        REQUIRE(clarinet_log_drain(&log, 16) == 9);
+        REQUIRE(c.records[0].event == CLARINET_LOG_EVENT_DROPPED);
+        REQUIRE(c.records[0].args[0] == 3);
+        REQUIRE(c.messages[0] == "3 records dropped");
+        REQUIRE(c.records[8].args[0] == 7);
+
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, 8, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_log_drain(&log, 16) == 1);
+    }
+
+    SECTION("Detach")
+    {
+        errcode = clarinet_log_detach();
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, 1, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_detach();
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_log_detach();
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        // Records written before detaching are still drained
+        REQUIRE(clarinet_log_drain(&log, 16) == 1);
+    }
+
+    SECTION("With NO rings left")
+    {
+        std::vector<std::thread> threads;
+        std::vector<int> results(5, CLARINET_ENONE);
+        for (int t = 0; t < 5; ++t)
+        {
+            threads.emplace_back([&results, t]
+            {
+                results[t] = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, t, 0, 0, 0);
+            });
+            threads.back().join();
+        }
+
+        // Threads that exit without detaching keep their rings
+        for (int t = 0; t < 4; ++t)
+            REQUIRE(Error(results[t]) == Error(CLARINET_ENONE));
+        REQUIRE(Error(results[4]) == Error(CLARINET_ENOBUFS));
+        REQUIRE(clarinet_log_drain(&log, 16) == 4);
+    }
+
+    SECTION("From multiple threads")
+    {
+        constexpr int count = 1000;
+        std::vector<std::thread> threads;
+        bool failed[3] = { false };
+        for (int t = 0; t < 3; ++t)
+        {
+            threads.emplace_back([&failed, t]
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    int e;
+                    while ((e = clarinet_log_write(CLARINET_LOG_LEVEL_INFO, CLARINET_LOG_EVENT_USER, t, i, 0, 0))
+                           == CLARINET_ENOBUFS)
+                        std::this_thread::yield();
+
+                    if (e != CLARINET_ENONE)
+                        failed[t] = true;
+                }
+                clarinet_log_detach();
+            });
+        }
+
+        // Writers that find their ring full also produce DROPPED records
+        size_t drained = 0;
+        while (drained < 3 * count)
+        {
+            const size_t before = c.records.size();
+            const int n = clarinet_log_drain(&log, 64);
+            REQUIRE(n >= 0);
+            for (size_t i = before; i < c.records.size(); ++i)
+            {
+                if (c.records[i].event == CLARINET_LOG_EVENT_USER)
+                    drained++;
+            }
+        }
+
+        for (auto& thread: threads)
+            thread.join();
+
+        for (bool f: failed)
+            REQUIRE_FALSE(f);
+
+        // Records of each thread are drained in order
+        int next[3] = { 0 };
+        for (const auto& record: c.records)
+        {
+            if (record.event == CLARINET_LOG_EVENT_DROPPED)
+                continue;
+
+            const auto t = (size_t)record.args[0];
+            REQUIRE(t < 3);
+            REQUIRE(record.args[1] == next[t]);
+            next[t]++;
+        }
+
+        for (int n: next)
+            REQUIRE(n == count);
+    }
+
+    SECTION("From socket")
+    {
+        errcode = clarinet_log_setlevel(&log, CLARINET_LOG_LEVEL_DEBUG);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_socket sp;
+        clarinet_socket_init(&sp);
+        errcode = clarinet_socket_open(&sp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto handle = (int64_t)(intptr_t)sp.handle;
+        errcode = clarinet_socket_close(&sp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        REQUIRE(clarinet_log_drain(&log, 16) == 2);
+        REQUIRE(c.records[0].event == CLARINET_LOG_EVENT_SOCKET_OPEN);
+        REQUIRE(c.records[0].args[0] == handle);
+        REQUIRE(c.records[0].args[1] == CLARINET_AF_INET);
+        REQUIRE(c.records[0].args[2] == CLARINET_PROTO_UDP);
+        REQUIRE(c.records[1].event == CLARINET_LOG_EVENT_SOCKET_CLOSE);
+        REQUIRE(c.records[1].args[0] == handle);
+    }
+}
+#endif
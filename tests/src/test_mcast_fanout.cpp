@@ -0,0 +1,414 @@
+#include "test.h"
+
+#if defined(__linux__)
+#include <net/if.h>
+#endif
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static clarinet_addr make_addr(const char* str)
+{
+    clarinet_addr addr;
+    memset(&addr, 0, sizeof(addr));
+    const int errcode = clarinet_addr_from_string(&addr, str, strlen(str));
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    return addr;
+}
+
+TEST_CASE("Multicast Address")
+{
+    clarinet_addr addr = make_addr("239.255.0.1");
+    REQUIRE(clarinet_addr_is_multicast_ipv4(&addr));
+    REQUIRE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("224.0.0.1");
+    REQUIRE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("223.255.255.255");
+    REQUIRE_FALSE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("240.0.0.1");
+    REQUIRE_FALSE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("ff02::1");
+    REQUIRE(clarinet_addr_is_multicast_ipv6(&addr));
+    REQUIRE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("fe80::1");
+    REQUIRE_FALSE(clarinet_addr_is_multicast_ip(&addr));
+
+    addr = make_addr("::ffff:239.255.0.1");
+    REQUIRE_FALSE(clarinet_addr_is_multicast_ip(&addr));
+}
+
+TEST_CASE("Multicast Fanout Initialize")
+{
+    clarinet_mcast_fanout fanout;
+    memset(&fanout, 0xFF, sizeof(fanout));
+    clarinet_mcast_fanout_init(&fanout);
+
+    clarinet_mcast_fanout expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&fanout, &expected, sizeof(fanout)) == 0);
+}
+
+TEST_CASE("Multicast Fanout Open/Close")
+{
+    clarinet_mcast_fanout fanout;
+    clarinet_mcast_fanout_init(&fanout);
+
+    clarinet_socket socket;
+    clarinet_socket* sp = &socket;
+    clarinet_socket_init(sp);
+
+    int errcode = clarinet_socket_open(sp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&sp]
+    {
+        clarinet_socket_close(sp);
+    });
+
+    const clarinet_endpoint group = clarinet_make_endpoint(make_addr("239.255.0.1"), 5000);
+
+    SECTION("With INVALID arguments")
+    {
+        errcode = clarinet_mcast_fanout_open(nullptr, sp, &group, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_mcast_fanout_open(&fanout, nullptr, &group, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, nullptr, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &group, 0, 1, 0x80);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_endpoint unicast = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 5000);
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &unicast, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_endpoint noport = clarinet_make_endpoint(group.addr, 0);
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &noport, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_endpoint ipv6 = clarinet_make_endpoint(make_addr("ff12::1234"), 5000);
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &ipv6, 0, 1, CLARINET_MCAST_FANOUT_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN fanout")
+    {
+        errcode = clarinet_mcast_fanout_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_mcast_fanout_close(&fanout);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const uint8_t buf[] = { 0xAA };
+        errcode = clarinet_mcast_fanout_send(&fanout, buf, sizeof(buf));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const clarinet_iovec iov = { (void*)buf, sizeof(buf) };
+        errcode = clarinet_mcast_fanout_sendv(&fanout, &iov, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("Open and close")
+    {
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &group, 0, 3, CLARINET_MCAST_FANOUT_LOOP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(fanout.socket == sp);
+        REQUIRE(clarinet_endpoint_is_equal(&fanout.group, &group));
+        REQUIRE(fanout.flags == CLARINET_MCAST_FANOUT_LOOP);
+
+        uint32_t val = 0;
+        size_t len = sizeof(val);
+        errcode = clarinet_socket_getopt(sp, CLARINET_IP_MCAST_TTL, &val, &len);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(val == 3);
+
+        errcode = clarinet_mcast_fanout_open(&fanout, sp, &group, 0, 3, CLARINET_MCAST_FANOUT_LOOP);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_mcast_fanout_close(&fanout);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(fanout.socket == nullptr);
+    }
+    #endif
+}
+
+#if defined(__linux__)
+TEST_CASE("Multicast Socket Options")
+{
+    const uint32_t lo = if_nametoindex("lo");
+    REQUIRE(lo > 0);
+
+    int family;
+    const char* group;
+    const char* source;
+    std::tie(family, group, source) = GENERATE(table<int, const char*, const char*>({
+        { CLARINET_AF_INET, "239.255.0.1", "127.0.0.1" },
+        { CLARINET_AF_INET6, "ff12::1234", "::1" },
+    }));
+    FROM(group);
+
+    clarinet_socket socket;
+    clarinet_socket* sp = &socket;
+    clarinet_socket_init(sp);
+
+    int errcode = clarinet_socket_open(sp, family, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&sp]
+    {
+        clarinet_socket_close(sp);
+    });
+
+    SECTION("TTL")
+    {
+        const uint32_t ttl = 7;
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_TTL, &ttl, sizeof(ttl));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        uint32_t val = 0;
+        size_t len = sizeof(val);
+        errcode = clarinet_socket_getopt(sp, CLARINET_IP_MCAST_TTL, &val, &len);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(len == sizeof(uint32_t));
+        REQUIRE(val == ttl);
+
+        const uint32_t invalid = 256;
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_TTL, &invalid, sizeof(invalid));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("Loop")
+    {
+        for (uint32_t loop: { 0u, 1u, 0u })
+        {
+            errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_LOOP, &loop, sizeof(loop));
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            uint32_t val = 0xFF;
+            size_t len = sizeof(val);
+            errcode = clarinet_socket_getopt(sp, CLARINET_IP_MCAST_LOOP, &val, &len);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(val == loop);
+        }
+    }
+
+    SECTION("Interface")
+    {
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_IF, &lo, sizeof(lo));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const uint32_t any = 0;
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_IF, &any, sizeof(any));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("Join/Leave")
+    {
+        clarinet_mcast_group mgroup;
+        memset(&mgroup, 0, sizeof(mgroup));
+        mgroup.iface = lo;
+        mgroup.addr = make_addr(group);
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_EADDRINUSE));
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_LEAVE, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_LEAVE, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) != Error(CLARINET_ENONE));
+    }
+
+    SECTION("Join/Leave source-specific")
+    {
+        clarinet_mcast_group mgroup;
+        memset(&mgroup, 0, sizeof(mgroup));
+        mgroup.iface = lo;
+        mgroup.addr = make_addr(group);
+        mgroup.source = make_addr(source);
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_LEAVE, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("With INVALID group")
+    {
+        clarinet_mcast_group mgroup;
+        memset(&mgroup, 0, sizeof(mgroup));
+        mgroup.iface = lo;
+
+        // Not a multicast address
+        mgroup.addr = make_addr(source);
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Source of a different family
+        mgroup.addr = make_addr(group);
+        mgroup.source = make_addr(family == CLARINET_AF_INET ? "::1" : "127.0.0.1");
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Wrong size
+        errcode = clarinet_socket_setopt(sp, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup) - 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+}
+
+TEST_CASE("Multicast Fanout Delivery")
+{
+    // IPv6 multicast is not routed through the loopback interface on Linux so the stream is only tested with IPv4.
+    const uint32_t lo = if_nametoindex("lo");
+    REQUIRE(lo > 0);
+
+    const clarinet_addr group = make_addr("239.255.0.1");
+    const int32_t on = 1;
+    const int32_t timeout = 1000;
+
+    // The publisher is bound to a specific address so that source-specific subscribers can select it.
+    clarinet_socket publisher;
+    clarinet_socket* psp = &publisher;
+    clarinet_socket_init(psp);
+
+    int errcode = clarinet_socket_open(psp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onpublisherexit = finalizer([&psp]
+    {
+        clarinet_socket_close(psp);
+    });
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    errcode = clarinet_socket_bind(psp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    // Subscribers share the port of the group.
+    constexpr size_t count = 3;
+    clarinet_socket subscribers[count];
+    for (auto& s: subscribers)
+        clarinet_socket_init(&s);
+
+    const auto onsubscribersexit = finalizer([&subscribers]
+    {
+        for (auto& s: subscribers)
+            clarinet_socket_close(&s);
+    });
+
+    clarinet_endpoint bound = clarinet_make_endpoint(clarinet_addr_any_ipv4, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        clarinet_socket* ssp = &subscribers[i];
+        errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_REUSEADDR, &on, sizeof(on));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_RCVTIMEO, &timeout, sizeof(timeout));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_bind(ssp, &bound);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        if (i == 0)
+        {
+            errcode = clarinet_socket_local_endpoint(ssp, &bound);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+    }
+
+    clarinet_mcast_fanout fanout;
+    clarinet_mcast_fanout_init(&fanout);
+
+    const clarinet_endpoint endpoint = clarinet_make_endpoint(group, bound.port);
+    errcode = clarinet_mcast_fanout_open(&fanout, psp, &endpoint, lo, 1, CLARINET_MCAST_FANOUT_LOOP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onfanoutexit = finalizer([&fanout]
+    {
+        clarinet_mcast_fanout_close(&fanout);
+    });
+
+    SECTION("Any source")
+    {
+        for (auto& s: subscribers)
+        {
+            clarinet_mcast_group mgroup;
+            memset(&mgroup, 0, sizeof(mgroup));
+            mgroup.iface = lo;
+            mgroup.addr = group;
+            errcode = clarinet_socket_setopt(&s, CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        // One send reaches every subscriber
+        const uint8_t state[] = { 0x01, 0x02, 0x03, 0x04 };
+        errcode = clarinet_mcast_fanout_send(&fanout, state, sizeof(state));
+        REQUIRE(errcode == (int)sizeof(state));
+
+        const uint8_t header[] = { 0xF0 };
+        const clarinet_iovec iov[] = { { (void*)header, sizeof(header) }, { (void*)state, sizeof(state) } };
+        errcode = clarinet_mcast_fanout_sendv(&fanout, iov, 2);
+        REQUIRE(errcode == (int)(sizeof(header) + sizeof(state)));
+
+        for (auto& s: subscribers)
+        {
+            uint8_t buf[16];
+            clarinet_endpoint remote;
+            errcode = clarinet_socket_recvfrom(&s, buf, sizeof(buf), &remote);
+            REQUIRE(errcode == (int)sizeof(state));
+            REQUIRE(memcmp(buf, state, sizeof(state)) == 0);
+            REQUIRE(clarinet_addr_is_loopback_ipv4(&remote.addr));
+
+            errcode = clarinet_socket_recvfrom(&s, buf, sizeof(buf), &remote);
+            REQUIRE(errcode == (int)(sizeof(header) + sizeof(state)));
+            REQUIRE(buf[0] == header[0]);
+            REQUIRE(memcmp(buf + 1, state, sizeof(state)) == 0);
+        }
+    }
+
+    SECTION("Source-specific")
+    {
+        // The first subscriber accepts the publisher as the source, the others expect a different source.
+        for (size_t i = 0; i < count; ++i)
+        {
+            clarinet_mcast_group mgroup;
+            memset(&mgroup, 0, sizeof(mgroup));
+            mgroup.iface = lo;
+            mgroup.addr = group;
+            mgroup.source = make_addr(i == 0 ? "127.0.0.1" : "127.0.0.2");
+            errcode = clarinet_socket_setopt(&subscribers[i], CLARINET_IP_MCAST_JOIN, &mgroup, sizeof(mgroup));
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            const int32_t shortwait = 100;
+            errcode = clarinet_socket_setopt(&subscribers[i], CLARINET_SO_RCVTIMEO, &shortwait, sizeof(shortwait));
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        const uint8_t state[] = { 0x05, 0x06 };
+        errcode = clarinet_mcast_fanout_send(&fanout, state, sizeof(state));
+        REQUIRE(errcode == (int)sizeof(state));
+
+        uint8_t buf[16];
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_recvfrom(&subscribers[0], buf, sizeof(buf), &remote);
+        REQUIRE(errcode == (int)sizeof(state));
+
+        for (size_t i = 1; i < count; ++i)
+        {
+            errcode = clarinet_socket_recvfrom(&subscribers[i], buf, sizeof(buf), &remote);
+            REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+        }
+    }
+}
+#endif
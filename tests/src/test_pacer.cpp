@@ -0,0 +1,238 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const uint64_t RATE = 10000;     // 100ms per datagram of SIZE bytes
+static const size_t SIZE = 1000;
+
+// Opens a pair of UDP sockets on loopback where the destination receives the datagrams sent by the source.
+struct loopback
+{
+    clarinet_socket source;
+    clarinet_socket destination;
+    clarinet_endpoint remote;
+
+    loopback()
+    {
+        clarinet_socket_init(&source);
+        clarinet_socket_init(&destination);
+        REQUIRE(Error(clarinet_socket_open(&source, CLARINET_AF_INET, CLARINET_PROTO_UDP)) == Error(CLARINET_ENONE));
+        REQUIRE(Error(clarinet_socket_open(&destination, CLARINET_AF_INET, CLARINET_PROTO_UDP))
+                == Error(CLARINET_ENONE));
+
+        const int32_t timeout = 1000;
+        REQUIRE(Error(clarinet_socket_setopt(&destination, CLARINET_SO_RCVTIMEO, &timeout, sizeof(timeout)))
+                == Error(CLARINET_ENONE));
+
+        remote = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        REQUIRE(Error(clarinet_socket_bind(&destination, &remote)) == Error(CLARINET_ENONE));
+        REQUIRE(Error(clarinet_socket_local_endpoint(&destination, &remote)) == Error(CLARINET_ENONE));
+    }
+
+    ~loopback()
+    {
+        clarinet_socket_close(&source);
+        clarinet_socket_close(&destination);
+    }
+
+    void receive(int count)
+    {
+        uint8_t buf[SIZE + 1];
+        for (int i = 0; i < count; ++i)
+        {
+            clarinet_endpoint sender;
+            REQUIRE(clarinet_socket_recvfrom(&destination, buf, sizeof(buf), &sender) == (int)SIZE);
+        }
+    }
+};
+
+TEST_CASE("Pacer Initialize")
+{
+    clarinet_pacer pacer;
+    memset(&pacer, 0xFF, sizeof(pacer));
+    clarinet_pacer_init(&pacer);
+
+    clarinet_pacer expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&pacer, &expected, sizeof(pacer)) == 0);
+}
+
+TEST_CASE("Pacer Open/Close")
+{
+    loopback net;
+
+    clarinet_pacer pacer;
+    clarinet_pacer_init(&pacer);
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_pacer_open(nullptr, &net.source, RATE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pacer_open(&pacer, nullptr, RATE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pacer_open(&pacer, &net.source, RATE, CLARINET_PACER_TXTIME);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("When not open")
+    {
+        const uint8_t buf[SIZE] = { 0 };
+        int errcode = clarinet_pacer_close(&pacer);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pacer_setrate(&pacer, RATE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(clarinet_pacer_timeout(&pacer, 0) == -1);
+    }
+
+    SECTION("Open twice")
+    {
+        int errcode = clarinet_pacer_open(&pacer, &net.source, RATE, CLARINET_PACER_USERSPACE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_pacer_open(&pacer, &net.source, RATE, CLARINET_PACER_USERSPACE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(Error(clarinet_pacer_close(&pacer)) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("Open and close")
+    {
+        int errcode = clarinet_pacer_open(&pacer, &net.source, RATE, CLARINET_PACER_USERSPACE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(pacer.socket == &net.source);
+        REQUIRE(pacer.rate == RATE);
+        REQUIRE(pacer.flags == CLARINET_PACER_USERSPACE);
+        REQUIRE(clarinet_pacer_timeout(&pacer, 0) == 0);
+
+        errcode = clarinet_pacer_close(&pacer);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_pacer expected;
+        clarinet_pacer_init(&expected);
+        REQUIRE(memcmp(&pacer, &expected, sizeof(pacer)) == 0);
+    }
+}
+
+TEST_CASE("Pacer User-space")
+{
+    loopback net;
+
+    clarinet_pacer pacer;
+    clarinet_pacer_init(&pacer);
+    REQUIRE(Error(clarinet_pacer_open(&pacer, &net.source, RATE, CLARINET_PACER_USERSPACE)) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pacer]
+    {
+        clarinet_pacer_close(&pacer);
+    });
+
+    const uint8_t buf[SIZE] = { 0 };
+    const uint64_t start = 1000000;
+    uint64_t now = start;
+
+    SECTION("Datagrams are spaced by the rate")
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+            int errcode = clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now);
+            REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+            REQUIRE(clarinet_pacer_timeout(&pacer, now) == 100000);
+            REQUIRE(clarinet_pacer_timeout(&pacer, now + 99999) == 1);
+
+            now += 100000;
+            REQUIRE(clarinet_pacer_timeout(&pacer, now) == 0);
+        }
+
+        net.receive(3);
+    }
+
+    SECTION("Idle time does not accumulate")
+    {
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+        now += 10 * 100000;
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+        int errcode = clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+        REQUIRE(pacer.next == now + 100000);
+
+        net.receive(2);
+    }
+
+    SECTION("Rate changes")
+    {
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+        // Without a rate datagrams are sent right away
+        REQUIRE(Error(clarinet_pacer_setrate(&pacer, 0)) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_pacer_timeout(&pacer, now) == 0);
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+        // A new rate applies from the next datagram on
+        REQUIRE(Error(clarinet_pacer_setrate(&pacer, RATE * 2)) == Error(CLARINET_ENONE));
+        now += 100000;
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+        REQUIRE(clarinet_pacer_timeout(&pacer, now) == 50000);
+
+        net.receive(4);
+    }
+
+    SECTION("Failures do not consume time")
+    {
+        std::vector<uint8_t> big(65536, 0);
+        int errcode = clarinet_pacer_sendto(&pacer, big.data(), big.size(), &net.remote, now);
+        REQUIRE(Error(errcode) == Error(CLARINET_EMSGSIZE));
+        REQUIRE(clarinet_pacer_timeout(&pacer, now) == 0);
+    }
+}
+
+#if defined(__linux__)
+TEST_CASE("Pacer Transmit Time")
+{
+    loopback net;
+
+    clarinet_pacer pacer;
+    clarinet_pacer_init(&pacer);
+    REQUIRE(Error(clarinet_pacer_open(&pacer, &net.source, RATE, 0)) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pacer]
+    {
+        clarinet_pacer_close(&pacer);
+    });
+
+    REQUIRE(pacer.flags == CLARINET_PACER_TXTIME);
+
+    int32_t optval = 0;
+    size_t optlen = sizeof(optval);
+    REQUIRE(Error(clarinet_socket_getopt(&net.source, CLARINET_SO_TXTIME, &optval, &optlen)) == Error(CLARINET_ENONE));
+    REQUIRE(optval == 1);
+
+    // A whole burst is handed to the system at once up to the horizon
+    const uint8_t buf[SIZE] = { 0 };
+    const uint64_t now = clarinet_time_now_us();
+    const int count = (int)(CLARINET_PACER_HORIZON / 100000) + 1;
+    for (int i = 0; i < count; ++i)
+        REQUIRE(clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now) == (int)SIZE);
+
+    REQUIRE(pacer.next == now + (uint64_t)count * 100000);
+
+    int errcode = clarinet_pacer_sendto(&pacer, buf, sizeof(buf), &net.remote, now);
+    REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+    REQUIRE(clarinet_pacer_timeout(&pacer, now) == 100000);
+
+    // Loopback usually has no queueing discipline so transmit times are ignored and all datagrams arrive right away.
+    net.receive(count);
+}
+#endif
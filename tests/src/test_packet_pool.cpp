@@ -0,0 +1,229 @@
+#include "test.h"
+
+#include <vector>
+#include <set>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Packet Pool Initialize")
+{
+    clarinet_packet_pool pool;
+    memset(&pool, 0xFF, sizeof(pool));
+    clarinet_packet_pool_init(&pool);
+
+    clarinet_packet_pool expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&pool, &expected, sizeof(pool)) == 0);
+}
+
+TEST_CASE("Packet Pool Open/Close")
+{
+    SECTION("With NULL pool")
+    {
+        int errcode = clarinet_packet_pool_open(nullptr, 1500, 16, CLARINET_PACKET_POOL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_packet_pool_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN pool")
+    {
+        clarinet_packet_pool pool;
+        clarinet_packet_pool_init(&pool);
+
+        int errcode = clarinet_packet_pool_close(&pool);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        void* buf = nullptr;
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With INVALID arguments")
+    {
+        clarinet_packet_pool pool;
+        clarinet_packet_pool_init(&pool);
+
+        int errcode = clarinet_packet_pool_open(&pool, 0, 16, CLARINET_PACKET_POOL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_packet_pool_open(&pool, 1500, 0, CLARINET_PACKET_POOL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_packet_pool_open(&pool, 1500, 16, 0x80);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("SAME pool TWICE")
+    {
+        clarinet_packet_pool pool;
+        clarinet_packet_pool_init(&pool);
+
+        int errcode = clarinet_packet_pool_open(&pool, 1500, 16, CLARINET_PACKET_POOL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(pool.slabsize == 1500);
+        REQUIRE(pool.count == 16);
+        REQUIRE(pool.flags == CLARINET_PACKET_POOL_NONE);
+
+        errcode = clarinet_packet_pool_open(&pool, 1500, 16, CLARINET_PACKET_POOL_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_packet_pool_close(&pool);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_packet_pool_close(&pool);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With HUGEPAGES")
+    {
+        clarinet_packet_pool pool;
+        clarinet_packet_pool_init(&pool);
+
+        // Huge pages are optional and the pool falls back to regular pages when they are not available.
+        int errcode = clarinet_packet_pool_open(&pool, 1500, 16, CLARINET_PACKET_POOL_HUGEPAGES);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        if (!(pool.flags & CLARINET_PACKET_POOL_HUGEPAGES))
+            WARN("Huge pages are not available.");
+
+        errcode = clarinet_packet_pool_close(&pool);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+}
+
+TEST_CASE("Packet Pool Acquire/Release")
+{
+    const uint32_t count = 8;
+
+    clarinet_packet_pool pool;
+    clarinet_packet_pool_init(&pool);
+
+    int errcode = clarinet_packet_pool_open(&pool, 1500, count, CLARINET_PACKET_POOL_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&pool]
+    {
+        clarinet_packet_pool_close(&pool);
+    });
+
+    SECTION("From the pool")
+    {
+        std::set<void*> slabs;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            void* buf = nullptr;
+            errcode = clarinet_packet_pool_acquire(&pool, &buf);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(buf != nullptr);
+            REQUIRE(((uintptr_t)buf % CLARINET_PACKET_POOL_ALIGNMENT) == 0);
+            memset(buf, 0xAA, pool.slabsize);
+            slabs.insert(buf);
+        }
+
+        REQUIRE(slabs.size() == count);
+
+        void* buf = nullptr;
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+
+        errcode = clarinet_packet_pool_release(&pool, (uint8_t*)*slabs.begin() + 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_packet_pool_release(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        for (void* slab: slabs)
+        {
+            errcode = clarinet_packet_pool_release(&pool, slab);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(slabs.count(buf) == 1);
+    }
+
+    SECTION("From caches")
+    {
+        clarinet_packet_cache producer;
+        clarinet_packet_cache_init(&producer, &pool);
+
+        clarinet_packet_cache consumer;
+        clarinet_packet_cache_init(&consumer, &pool);
+
+        std::vector<void*> slabs;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            void* buf = nullptr;
+            errcode = clarinet_packet_cache_acquire(&producer, &buf);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            slabs.push_back(buf);
+        }
+
+        void* buf = nullptr;
+        errcode = clarinet_packet_cache_acquire(&producer, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+
+        // Ownership is transferred to the consumer which releases the slabs to its own cache.
+        for (void* slab: slabs)
+        {
+            errcode = clarinet_packet_cache_release(&consumer, slab);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        REQUIRE(consumer.count == count);
+
+        errcode = clarinet_packet_pool_acquire(&pool, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+
+        errcode = clarinet_packet_cache_flush(&consumer);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(consumer.count == 0);
+
+        errcode = clarinet_packet_cache_acquire(&producer, &buf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("From multiple threads")
+    {
+        std::vector<std::thread> threads;
+        bool failed[4] = { false };
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool, &failed, t]
+            {
+                clarinet_packet_cache cache;
+                clarinet_packet_cache_init(&cache, &pool);
+                for (int i = 0; i < 10000; ++i)
+                {
+                    void* buf = nullptr;
+                    if (clarinet_packet_cache_acquire(&cache, &buf) != CLARINET_ENONE)
+                        continue;
+
+                    memset(buf, t, pool.slabsize);
+                    std::this_thread::yield();
+                    if (((uint8_t*)buf)[pool.slabsize - 1] != (uint8_t)t)
+                        failed[t] = true;
+
+                    clarinet_packet_cache_release(&cache, buf);
+                }
+                clarinet_packet_cache_flush(&cache);
+            });
+        }
+
+        for (auto& thread: threads)
+            thread.join();
+
+        for (bool f: failed)
+            REQUIRE_FALSE(f);
+
+        // Every slab must be back in the pool.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            void* buf = nullptr;
+            errcode = clarinet_packet_pool_acquire(&pool, &buf);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+    }
+}
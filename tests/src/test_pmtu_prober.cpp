@@ -0,0 +1,467 @@
+#include "test.h"
+
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+static const uint32_t BASE = 1200;
+static const uint32_t MAX = 1472;
+static const uint32_t TIMEOUT = 100;
+
+// Emulates a path that only delivers datagrams up to a certain size. Probes that fit are acknowledged right away while
+// larger probes are silently dropped. Returns the number of probes sent until the search completed.
+static int search(clarinet_pmtu_prober* prober, uint32_t limit, uint64_t& now)
+{
+    int probes = 0;
+    while (prober->state != CLARINET_PMTU_STATE_COMPLETE)
+    {
+        REQUIRE(probes < 100);
+
+        uint32_t size = 0;
+        const int errcode = clarinet_pmtu_prober_poll(prober, now, &size);
+        if (errcode == CLARINET_EAGAIN)
+        {
+            const int timeout = clarinet_pmtu_prober_timeout(prober, now);
+            REQUIRE(timeout >= 0);
+            now += (uint64_t)timeout;
+            continue;
+        }
+
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(size == prober->probe);
+        probes++;
+        if (size <= limit)
+            REQUIRE(Error(clarinet_pmtu_prober_on_ack(prober, size, now)) == Error(CLARINET_ENONE));
+    }
+
+    return probes;
+}
+
+TEST_CASE("PMTU Prober Initialize")
+{
+    clarinet_pmtu_prober prober;
+    memset(&prober, 0xFF, sizeof(prober));
+    clarinet_pmtu_prober_init(&prober);
+
+    clarinet_pmtu_prober expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&prober, &expected, sizeof(prober)) == 0);
+}
+
+TEST_CASE("PMTU Prober Open/Close")
+{
+    clarinet_pmtu_prober prober;
+    clarinet_pmtu_prober_init(&prober);
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_pmtu_prober_open(nullptr, BASE, MAX, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, 0, MAX, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, BASE - 1, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, 65508, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, BASE - 1, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, MAX + 1, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("When not open")
+    {
+        uint32_t size;
+        int errcode = clarinet_pmtu_prober_close(&prober);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_poll(&prober, 0, &size);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_on_ack(&prober, BASE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_on_loss(&prober, BASE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_prober_on_ptb(&prober, BASE, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, 0) == -1);
+    }
+
+    SECTION("Open twice")
+    {
+        int errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(Error(clarinet_pmtu_prober_close(&prober)) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("Open and close")
+    {
+        int errcode = clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_SEARCHING);
+        REQUIRE(prober.pmtu == BASE);
+        REQUIRE(prober.probe == 0);
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, 0) == 0);
+
+        errcode = clarinet_pmtu_prober_close(&prober);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_CLOSED);
+    }
+}
+
+TEST_CASE("PMTU Prober Search")
+{
+    clarinet_pmtu_prober prober;
+    clarinet_pmtu_prober_init(&prober);
+    uint64_t now = 1000;
+
+    SECTION("Maximum size is confirmed with a single probe")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+        REQUIRE(search(&prober, MAX, now) == 1);
+        REQUIRE(prober.pmtu == MAX);
+        REQUIRE(now == 1000);
+    }
+
+    SECTION("Binary search finds the exact size")
+    {
+        const uint32_t limit = GENERATE(BASE, BASE + 1, 1280u, 1400u, MAX - 1);
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+        const int probes = search(&prober, limit, now);
+        REQUIRE(prober.pmtu == limit);
+
+        // Every size too big is probed the maximum number of times
+        REQUIRE(probes <= 10 * CLARINET_PMTU_PROBES_MAX);
+    }
+
+    SECTION("Hint is confirmed with a single probe")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 1400, TIMEOUT, now)) == Error(CLARINET_ENONE));
+        REQUIRE(search(&prober, 1400, now) == 1);
+        REQUIRE(prober.pmtu == 1400);
+    }
+
+    SECTION("Hint that is too big falls back to a binary search")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 1400, TIMEOUT, now)) == Error(CLARINET_ENONE));
+        search(&prober, 1300, now);
+        REQUIRE(prober.pmtu == 1300);
+    }
+
+    SECTION("Lost probe is retried before the size is considered too big")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+
+        uint32_t size = 0;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(size == MAX);
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_EAGAIN));
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, now) == (int)TIMEOUT);
+
+        now += TIMEOUT;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(size == MAX);
+
+        // A late acknowledgement still counts
+        REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, MAX, now + 1)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.pmtu == MAX);
+    }
+
+    SECTION("Packet too big indication")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+
+        uint32_t size = 0;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(size == MAX);
+
+        // Indications not below the probe are ignored
+        REQUIRE(Error(clarinet_pmtu_prober_on_ptb(&prober, MAX, now)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.probe == MAX);
+
+        // The probe is rejected right away and the search never goes above the indication
+        REQUIRE(Error(clarinet_pmtu_prober_on_ptb(&prober, 1400, now)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.probe == 0);
+        search(&prober, MAX, now);
+        REQUIRE(prober.pmtu == 1400);
+
+        // Indications never go below the base size
+        REQUIRE(Error(clarinet_pmtu_prober_on_ptb(&prober, 500, now)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.pmtu == BASE);
+    }
+
+    SECTION("Search is repeated after the raise timeout")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+        search(&prober, 1400, now);
+        REQUIRE(prober.pmtu == 1400);
+
+        uint32_t size = 0;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_EAGAIN));
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, now) == CLARINET_PMTU_RAISE_TIMEOUT);
+
+        now += CLARINET_PMTU_RAISE_TIMEOUT;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_SEARCHING);
+        REQUIRE(size == MAX);
+        REQUIRE(prober.pmtu == 1400);
+
+        REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, MAX, now)) == Error(CLARINET_ENONE));
+        search(&prober, MAX, now);
+        REQUIRE(prober.pmtu == MAX);
+    }
+
+    REQUIRE(Error(clarinet_pmtu_prober_close(&prober)) == Error(CLARINET_ENONE));
+}
+
+TEST_CASE("PMTU Prober Black Hole")
+{
+    clarinet_pmtu_prober prober;
+    clarinet_pmtu_prober_init(&prober);
+    uint64_t now = 1000;
+    REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, MAX, 0, TIMEOUT, now)) == Error(CLARINET_ENONE));
+    search(&prober, MAX, now);
+    REQUIRE(prober.pmtu == MAX);
+
+    // Losses of datagrams not larger than the base size or interrupted by an acknowledgement are not a black hole
+    for (uint32_t i = 0; i < 2 * CLARINET_PMTU_PROBES_MAX; ++i)
+        REQUIRE(Error(clarinet_pmtu_prober_on_loss(&prober, BASE, now)) == Error(CLARINET_ENONE));
+
+    for (uint32_t i = 0; i < CLARINET_PMTU_PROBES_MAX - 1; ++i)
+        REQUIRE(Error(clarinet_pmtu_prober_on_loss(&prober, MAX, now)) == Error(CLARINET_ENONE));
+
+    REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, MAX, now)) == Error(CLARINET_ENONE));
+    REQUIRE(Error(clarinet_pmtu_prober_on_loss(&prober, MAX, now)) == Error(CLARINET_ENONE));
+    REQUIRE(prober.state == CLARINET_PMTU_STATE_COMPLETE);
+    REQUIRE(prober.pmtu == MAX);
+
+    for (uint32_t i = 0; i < CLARINET_PMTU_PROBES_MAX - 1; ++i)
+        REQUIRE(Error(clarinet_pmtu_prober_on_loss(&prober, MAX, now)) == Error(CLARINET_ENONE));
+
+    REQUIRE(prober.state == CLARINET_PMTU_STATE_BASE);
+    REQUIRE(prober.pmtu == BASE);
+
+    // The base size is confirmed right away
+    uint32_t size = 0;
+    REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+    REQUIRE(size == BASE);
+
+    SECTION("Search resumes after a delay that doubles with every black hole")
+    {
+        REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, BASE, now)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_SEARCHING);
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_EAGAIN));
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, now) == (int)(2 * TIMEOUT));
+
+        search(&prober, 1400, now);
+        REQUIRE(prober.pmtu == 1400);
+
+        for (uint32_t i = 0; i < CLARINET_PMTU_PROBES_MAX; ++i)
+            REQUIRE(Error(clarinet_pmtu_prober_on_loss(&prober, 1400, now)) == Error(CLARINET_ENONE));
+
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, BASE, now)) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_pmtu_prober_timeout(&prober, now) == (int)(4 * TIMEOUT));
+    }
+
+    SECTION("Base size that does not work is an error")
+    {
+        for (uint32_t i = 1; i < CLARINET_PMTU_PROBES_MAX; ++i)
+        {
+            now += TIMEOUT;
+            REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+            REQUIRE(size == BASE);
+        }
+
+        now += TIMEOUT;
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_EAGAIN));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_ERROR);
+        REQUIRE(prober.pmtu == BASE);
+
+        // The base size is retried after the delay and resumes the search once confirmed
+        now += (uint64_t)clarinet_pmtu_prober_timeout(&prober, now);
+        REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, now, &size)) == Error(CLARINET_ENONE));
+        REQUIRE(size == BASE);
+        REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, BASE, now)) == Error(CLARINET_ENONE));
+        REQUIRE(prober.state == CLARINET_PMTU_STATE_SEARCHING);
+    }
+
+    REQUIRE(Error(clarinet_pmtu_prober_close(&prober)) == Error(CLARINET_ENONE));
+}
+
+#if defined(__linux__)
+TEST_CASE("PMTU Prober Send")
+{
+    clarinet_socket sender;
+    clarinet_socket_init(&sender);
+    clarinet_socket receiver;
+    clarinet_socket_init(&receiver);
+
+    int errcode = clarinet_socket_open(&sender, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    errcode = clarinet_socket_open(&receiver, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&]
+    {
+        clarinet_socket_close(&sender);
+        clarinet_socket_close(&receiver);
+    });
+
+    const int32_t mode = CLARINET_PMTUD_PROBE;
+    errcode = clarinet_socket_setopt(&sender, CLARINET_IP_MTU_DISCOVER, &mode, sizeof(mode));
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    const int32_t timeout = 1000;
+    errcode = clarinet_socket_setopt(&receiver, CLARINET_SO_RCVTIMEO, &timeout, sizeof(timeout));
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint dst = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    REQUIRE(Error(clarinet_socket_bind(&receiver, &dst)) == Error(CLARINET_ENONE));
+    REQUIRE(Error(clarinet_socket_local_endpoint(&receiver, &dst)) == Error(CLARINET_ENONE));
+
+    clarinet_pmtu_prober prober;
+    clarinet_pmtu_prober_init(&prober);
+    REQUIRE(Error(clarinet_pmtu_prober_open(&prober, BASE, 9000, 0, TIMEOUT, 0)) == Error(CLARINET_ENONE));
+
+    const uint8_t header[] = { 0xAA, 0xBB };
+    errcode = clarinet_pmtu_prober_sendto(&prober, &sender, header, sizeof(header), &dst, 0);
+    REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+    uint32_t size = 0;
+    REQUIRE(Error(clarinet_pmtu_prober_poll(&prober, 0, &size)) == Error(CLARINET_ENONE));
+    REQUIRE(size == 9000);
+
+    errcode = clarinet_pmtu_prober_sendto(&prober, &sender, header, size + 1, &dst, 0);
+    REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+    errcode = clarinet_pmtu_prober_sendto(&prober, &sender, header, sizeof(header), &dst, 0);
+    REQUIRE(errcode == (int)size);
+
+    std::vector<uint8_t> buf(size + 1);
+    clarinet_endpoint remote;
+    errcode = clarinet_socket_recvfrom(&receiver, buf.data(), buf.size(), &remote);
+    REQUIRE(errcode == (int)size);
+    REQUIRE(buf[0] == header[0]);
+    REQUIRE(buf[1] == header[1]);
+    for (size_t i = sizeof(header); i < size; ++i)
+        REQUIRE(buf[i] == 0);
+
+    REQUIRE(Error(clarinet_pmtu_prober_on_ack(&prober, size, 0)) == Error(CLARINET_ENONE));
+    REQUIRE(prober.pmtu == 9000);
+    REQUIRE(Error(clarinet_pmtu_prober_close(&prober)) == Error(CLARINET_ENONE));
+}
+#endif
+
+TEST_CASE("PMTU Cache")
+{
+    clarinet_pmtu_cache cache;
+    memset(&cache, 0xFF, sizeof(cache));
+    clarinet_pmtu_cache_init(&cache);
+
+    clarinet_pmtu_cache expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&cache, &expected, sizeof(cache)) == 0);
+
+    clarinet_pmtu_cache_entry entries[16];
+    const uint32_t lifetime = 60000;
+    const clarinet_addr a = clarinet_make_ipv4(192, 168, 0, 1);
+    const clarinet_addr b = clarinet_make_ipv4(192, 168, 0, 2);
+    uint32_t pmtu = 0;
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_pmtu_cache_open(nullptr, entries, 16, lifetime, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_open(&cache, nullptr, 16, lifetime, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_open(&cache, entries, 0, lifetime, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_open(&cache, entries, 15, lifetime, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_open(&cache, entries, 16, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_close(&cache);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_store(&cache, &a, MAX, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_lookup(&cache, &a, 0, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("Store and lookup")
+    {
+        REQUIRE(Error(clarinet_pmtu_cache_open(&cache, entries, 16, lifetime, 1234)) == Error(CLARINET_ENONE));
+        const auto onexit = finalizer([&]
+        {
+            clarinet_pmtu_cache_close(&cache);
+        });
+
+        int errcode = clarinet_pmtu_cache_store(&cache, &a, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_store(&cache, &clarinet_addr_none, MAX, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_pmtu_cache_lookup(&cache, &a, 0, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_pmtu_cache_store(&cache, &a, 1400, 1000);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_pmtu_cache_lookup(&cache, &a, 1000, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(pmtu == 1400);
+
+        // IPv4 mapped to IPv6 addresses share the entry of their IPv4 form
+        const clarinet_addr mapped = clarinet_make_ipv6(0, 0, 0, 0, 0, 0xFFFF, 0xC0A8, 0x0001, 0);
+        errcode = clarinet_pmtu_cache_lookup(&cache, &mapped, 1000, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(pmtu == 1400);
+
+        // Entries expire
+        errcode = clarinet_pmtu_cache_lookup(&cache, &a, 1000 + lifetime, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("New entry replaces an entry with the same slot")
+    {
+        REQUIRE(Error(clarinet_pmtu_cache_open(&cache, entries, 1, lifetime, 1234)) == Error(CLARINET_ENONE));
+        const auto onexit = finalizer([&]
+        {
+            clarinet_pmtu_cache_close(&cache);
+        });
+
+        REQUIRE(Error(clarinet_pmtu_cache_store(&cache, &a, 1400, 0)) == Error(CLARINET_ENONE));
+        REQUIRE(Error(clarinet_pmtu_cache_store(&cache, &b, MAX, 0)) == Error(CLARINET_ENONE));
+
+        int errcode = clarinet_pmtu_cache_lookup(&cache, &a, 0, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_pmtu_cache_lookup(&cache, &b, 0, &pmtu);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(pmtu == MAX);
+    }
+}
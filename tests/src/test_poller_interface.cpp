@@ -0,0 +1,181 @@
+#include "test.h"
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Poller Initialize")
+{
+    clarinet_poller poller;
+    memset(&poller, 0xFF, sizeof(poller));
+    clarinet_poller_init(&poller);
+
+    clarinet_poller expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&poller, &expected, sizeof(poller)) == 0);
+}
+
+TEST_CASE("Poller Open/Close")
+{
+    SECTION("With NULL poller")
+    {
+        int errcode = clarinet_poller_open(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_poller_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN poller")
+    {
+        clarinet_poller poller;
+        clarinet_poller_init(&poller);
+
+        int errcode = clarinet_poller_close(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("SAME poller TWICE")
+    {
+        clarinet_poller poller;
+        clarinet_poller_init(&poller);
+
+        int errcode = clarinet_poller_open(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_poller_open(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_poller_close(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_poller_close(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+    #else
+    SECTION("With UNSUPPORTED platform")
+    {
+        clarinet_poller poller;
+        clarinet_poller_init(&poller);
+
+        int errcode = clarinet_poller_open(&poller);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+    }
+    #endif
+}
+
+#if defined(__linux__)
+TEST_CASE("Poller Wait")
+{
+    clarinet_poller poller;
+    clarinet_poller* pp = &poller;
+    clarinet_poller_init(pp);
+
+    int errcode = clarinet_poller_open(pp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onpollerexit = finalizer([&pp]
+    {
+        clarinet_poller_close(pp);
+    });
+
+    clarinet_socket source;
+    clarinet_socket* ssp = &source;
+    clarinet_socket_init(ssp);
+
+    errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onsourceexit = finalizer([&ssp]
+    {
+        clarinet_socket_close(ssp);
+    });
+
+    // Several destinations so we can check only the one that is ready gets reported.
+    static constexpr size_t count = 8;
+    std::vector<clarinet_socket> destinations(count);
+    std::vector<clarinet_endpoint> endpoints(count);
+    const auto ondestinationsexit = finalizer([&destinations]
+    {
+        for (auto& s: destinations)
+            clarinet_socket_close(&s);
+    });
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        clarinet_socket* sp = &destinations[i];
+        clarinet_socket_init(sp);
+
+        errcode = clarinet_socket_open(sp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_bind(sp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_local_endpoint(sp, &endpoints[i]);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_poller_add(pp, sp, CLARINET_POLL_RECV, &destinations[i]);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    SECTION("With NO events")
+    {
+        clarinet_poller_event events[count];
+        errcode = clarinet_poller_wait(pp, events, count, 0);
+        REQUIRE(errcode == 0);
+    }
+
+    SECTION("With socket added TWICE")
+    {
+        errcode = clarinet_poller_add(pp, &destinations[0], CLARINET_POLL_RECV, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EALREADY));
+    }
+
+    SECTION("With socket NOT added")
+    {
+        errcode = clarinet_poller_modify(pp, ssp, CLARINET_POLL_RECV, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        errcode = clarinet_poller_remove(pp, ssp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("With ONE socket ready")
+    {
+        const size_t target = GENERATE(range((size_t)0, count));
+        FROM(target);
+
+        const uint8_t buf[] = { 0xAA, 0xBB, 0xCC };
+        errcode = clarinet_socket_sendto(ssp, buf, sizeof(buf), &endpoints[target]);
+        REQUIRE(errcode == (int)sizeof(buf));
+
+        clarinet_poller_event events[count];
+        errcode = clarinet_poller_wait(pp, events, count, 1000);
+        REQUIRE(errcode == 1);
+        REQUIRE(events[0].data == &destinations[target]);
+        REQUIRE(events[0].events == CLARINET_POLL_RECV);
+
+        // Level-triggered so the event is reported again until the datagram is consumed
+        errcode = clarinet_poller_wait(pp, events, count, 0);
+        REQUIRE(errcode == 1);
+
+        SECTION("Modify")
+        {
+            errcode = clarinet_poller_modify(pp, &destinations[target], CLARINET_POLL_NONE, nullptr);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            errcode = clarinet_poller_wait(pp, events, count, 0);
+            REQUIRE(errcode == 0);
+        }
+
+        SECTION("Remove")
+        {
+            errcode = clarinet_poller_remove(pp, &destinations[target]);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            errcode = clarinet_poller_wait(pp, events, count, 0);
+            REQUIRE(errcode == 0);
+        }
+    }
+}
+#endif
@@ -0,0 +1,284 @@
+#include "test.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Socket Group Initialize")
+{
+    clarinet_socket_group group;
+    memset(&group, 0xFF, sizeof(group));
+    clarinet_socket_group_init(&group);
+
+    clarinet_socket_group expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&group, &expected, sizeof(group)) == 0);
+}
+
+TEST_CASE("Socket Group Open/Close")
+{
+    constexpr size_t count = 4;
+    clarinet_socket sockets[count];
+    for (auto& s: sockets)
+        clarinet_socket_init(&s);
+
+    clarinet_socket_group group;
+    clarinet_socket_group_init(&group);
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    SECTION("With INVALID arguments")
+    {
+        int errcode = clarinet_socket_group_open(nullptr, sockets, count, &local, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, nullptr, count, &local, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, sockets, 0, &local, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, sockets, CLARINET_SOCKET_GROUP_MAX + 1, &local,
+                                             CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, sockets, count, nullptr, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, sockets, count, &local,
+                                             CLARINET_SOCKET_GROUP_STEER_HASH | CLARINET_SOCKET_GROUP_STEER_CPU);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_open(&group, sockets, count, &local, 0x80);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN group")
+    {
+        int errcode = clarinet_socket_group_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_close(&group);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_pin(&group, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if defined(__linux__)
+    SECTION("With ephemeral port")
+    {
+        int errcode = clarinet_socket_group_open(&group, sockets, count, &local, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(group.sockets == sockets);
+        REQUIRE(group.count == count);
+        REQUIRE(group.local.port != 0);
+
+        for (auto& s: sockets)
+        {
+            clarinet_endpoint endpoint;
+            errcode = clarinet_socket_local_endpoint(&s, &endpoint);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(clarinet_endpoint_is_equal(&endpoint, &group.local));
+        }
+
+        errcode = clarinet_socket_group_open(&group, sockets, count, &local, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_group_close(&group);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(group.sockets == nullptr);
+        for (auto& s: sockets)
+            REQUIRE(s.family == CLARINET_AF_UNSPEC);
+
+        errcode = clarinet_socket_group_close(&group);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With endpoint IN USE")
+    {
+        clarinet_socket other;
+        clarinet_socket* osp = &other;
+        clarinet_socket_init(osp);
+
+        int errcode = clarinet_socket_open(osp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onotherexit = finalizer([&osp]
+        {
+            clarinet_socket_close(osp);
+        });
+
+        errcode = clarinet_socket_bind(osp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint taken;
+        errcode = clarinet_socket_local_endpoint(osp, &taken);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_group_open(&group, sockets, count, &taken, CLARINET_SOCKET_GROUP_NONE);
+        REQUIRE(Error(errcode) == Error(CLARINET_EADDRINUSE));
+        REQUIRE(group.sockets == nullptr);
+        for (auto& s: sockets)
+            REQUIRE(s.family == CLARINET_AF_UNSPEC);
+    }
+    #endif
+}
+
+#if defined(__linux__)
+TEST_CASE("Socket Group Steering")
+{
+    constexpr size_t count = 4;
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    const uint32_t flags = GENERATE(CLARINET_SOCKET_GROUP_NONE,
+                                    CLARINET_SOCKET_GROUP_STEER_HASH,
+                                    CLARINET_SOCKET_GROUP_STEER_CPU);
+    FROM(flags);
+
+    clarinet_socket sockets[count];
+    for (auto& s: sockets)
+        clarinet_socket_init(&s);
+
+    clarinet_socket_group group;
+    clarinet_socket_group* gp = &group;
+    clarinet_socket_group_init(gp);
+
+    int errcode = clarinet_socket_group_open(gp, sockets, count, &local, flags);
+    if (errcode == CLARINET_ENOTSUP)
+    {
+        WARN("Steering is not supported by the system");
+        return;
+    }
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto ongroupexit = finalizer([&gp]
+    {
+        clarinet_socket_group_close(gp);
+    });
+
+    clarinet_poller poller;
+    clarinet_poller* pp = &poller;
+    clarinet_poller_init(pp);
+
+    errcode = clarinet_poller_open(pp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onpollerexit = finalizer([&pp]
+    {
+        clarinet_poller_close(pp);
+    });
+
+    for (auto& s: sockets)
+    {
+        errcode = clarinet_poller_add(pp, &s, CLARINET_POLL_RECV, &s);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    }
+
+    // Every client must always land on the same shard no matter how many datagrams it sends.
+    constexpr size_t nclients = 16;
+    for (size_t c = 0; c < nclients; ++c)
+    {
+        clarinet_socket client;
+        clarinet_socket* csp = &client;
+        clarinet_socket_init(csp);
+
+        errcode = clarinet_socket_open(csp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onclientexit = finalizer([&csp]
+        {
+            clarinet_socket_close(csp);
+        });
+
+        const clarinet_socket* shard = nullptr;
+        for (int k = 0; k < 4; ++k)
+        {
+            const uint8_t buf[] = { 0xAA, 0xBB, 0xCC };
+            errcode = clarinet_socket_sendto(csp, buf, sizeof(buf), &group.local);
+            REQUIRE(errcode == (int)sizeof(buf));
+
+            clarinet_poller_event events[count];
+            errcode = clarinet_poller_wait(pp, events, count, 1000);
+            REQUIRE(errcode == 1);
+
+            auto sp = (clarinet_socket*)events[0].data;
+            if (shard == nullptr)
+                shard = sp;
+            REQUIRE(sp == shard);
+
+            uint8_t data[8];
+            clarinet_endpoint remote;
+            errcode = clarinet_socket_recvfrom(sp, data, sizeof(data), &remote);
+            REQUIRE(errcode == (int)sizeof(buf));
+        }
+    }
+}
+
+TEST_CASE("Socket Group Pin")
+{
+    constexpr size_t count = 4;
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    clarinet_socket sockets[count];
+    for (auto& s: sockets)
+        clarinet_socket_init(&s);
+
+    clarinet_socket_group group;
+    clarinet_socket_group* gp = &group;
+    clarinet_socket_group_init(gp);
+
+    int errcode = clarinet_socket_group_open(gp, sockets, count, &local, CLARINET_SOCKET_GROUP_NONE);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto ongroupexit = finalizer([&gp]
+    {
+        clarinet_socket_group_close(gp);
+    });
+
+    errcode = clarinet_socket_group_pin(gp, count);
+    REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+    // Pin worker threads so the affinity of the test thread is not affected.
+    int results[count];
+    int cpus[count];
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < count; ++i)
+    {
+        workers.emplace_back([gp, i, &results, &cpus]
+        {
+            results[i] = clarinet_socket_group_pin(gp, i);
+            #if defined(__linux__)
+            cpus[i] = sched_getcpu();
+            #else
+            cpus[i] = -1;
+            #endif
+        });
+    }
+
+    for (auto& w: workers)
+        w.join();
+
+    #if defined(__linux__)
+    cpu_set_t allowed;
+    REQUIRE(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    #endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        FROM(i);
+        REQUIRE(Error(results[i]) == Error(CLARINET_ENONE));
+
+        #if defined(__linux__)
+        // A shard must run on a CPU that CPU steering delivers to it whenever the test thread is allowed to run on one.
+        for (size_t cpu = i; cpu < CPU_SETSIZE; cpu += count)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+            {
+                REQUIRE(cpus[i] >= 0);
+                REQUIRE((size_t)cpus[i] % count == i);
+                break;
+            }
+        }
+        #endif
+    }
+}
+#endif
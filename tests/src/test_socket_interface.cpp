@@ -3541,6 +3541,980 @@ TEST_CASE("Socket Recv From")
     }
 }
 
+TEST_CASE("Socket Send/Recv Vector")
+{
+    SECTION("With NULL socket")
+    {
+        uint8_t buf[8] = { 0 };
+        clarinet_iovec iov[1] = { { buf, sizeof(buf) } };
+        clarinet_endpoint remote = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+        int errcode = clarinet_socket_sendv(nullptr, iov, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        errcode = clarinet_socket_sendtov(nullptr, iov, 1, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        errcode = clarinet_socket_recvv(nullptr, iov, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        errcode = clarinet_socket_recvfromv(nullptr, iov, 1, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket ON " CONFIG_SYSTEM_NAME)
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        // Source is bound to loopback too so its local endpoint is the address the destination receives from
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(ssp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        char header[] = "HDR:";
+        char acks[] = "ACK:";
+        char payload[] = "PAYLOAD";
+        const clarinet_iovec parts[] = {
+            { header, 4 },
+            { nullptr, 0 },
+            { acks, 4 },
+            { payload, 7 },
+        };
+
+        SECTION("With invalid buffers")
+        {
+            clarinet_iovec invalid[] = { { nullptr, 4 } };
+            errcode = clarinet_socket_sendtov(ssp, invalid, 1, &remote);
+            REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+            errcode = clarinet_socket_sendtov(ssp, parts, 0, &remote);
+            REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+            errcode = clarinet_socket_sendtov(ssp, parts, CLARINET_IOVEC_MAX + 1, &remote);
+            REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        }
+
+        SECTION("With buffers that fit")
+        {
+            errcode = clarinet_socket_sendtov(ssp, parts, 4, &remote);
+            REQUIRE(errcode == 15);
+
+            char first[6] = { 0 };
+            char second[16] = { 0 };
+            const clarinet_iovec rparts[] = {
+                { first, sizeof(first) },
+                { second, sizeof(second) },
+            };
+
+            clarinet_endpoint sender = { { 0 } };
+            errcode = clarinet_socket_recvfromv(dsp, rparts, 2, &sender);
+            REQUIRE(errcode == 15);
+            REQUIRE(memcmp(first, "HDR:AC", 6) == 0);
+            REQUIRE(memcmp(second, "K:PAYLOAD", 9) == 0);
+
+            clarinet_endpoint expected;
+            errcode = clarinet_socket_local_endpoint(ssp, &expected);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(clarinet_endpoint_is_equal(&sender, &expected));
+        }
+
+        SECTION("With buffers that are too small")
+        {
+            errcode = clarinet_socket_sendtov(ssp, parts, 4, &remote);
+            REQUIRE(errcode == 15);
+
+            char first[4] = { 0 };
+            char second[4] = { 0 };
+            const clarinet_iovec rparts[] = {
+                { first, sizeof(first) },
+                { second, sizeof(second) },
+            };
+
+            clarinet_endpoint sender = { { 0 } };
+            errcode = clarinet_socket_recvfromv(dsp, rparts, 2, &sender);
+            REQUIRE(Error(errcode) == Error(CLARINET_EMSGSIZE));
+        }
+
+        SECTION("With connected sockets")
+        {
+            errcode = clarinet_socket_connect(ssp, &remote);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            errcode = clarinet_socket_sendv(ssp, parts, 4);
+            REQUIRE(errcode == 15);
+
+            char buf[32] = { 0 };
+            const clarinet_iovec rparts[] = { { buf, sizeof(buf) } };
+            errcode = clarinet_socket_recvv(dsp, rparts, 1);
+            REQUIRE(errcode == 15);
+            REQUIRE(memcmp(buf, "HDR:ACK:PAYLOAD", 15) == 0);
+        }
+    }
+}
+
+TEST_CASE("Socket Send/Recv Many")
+{
+    SECTION("With NULL socket")
+    {
+        clarinet_socket_message msg = { nullptr, 0, clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 9), 0 };
+
+        int errcode = clarinet_socket_sendmany(nullptr, &msg, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_recvmany(nullptr, &msg, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN socket")
+    {
+        uint8_t buf[8] = { 0 };
+        clarinet_socket_message msg = { buf, sizeof(buf), clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 9), 0 };
+
+        clarinet_socket socket;
+        clarinet_socket* sp = &socket;
+        clarinet_socket_init(sp);
+
+        int errcode = clarinet_socket_sendmany(sp, &msg, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_recvmany(sp, &msg, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket")
+    {
+        clarinet_family family = GENERATE(values({
+            CLARINET_TEST_SOCKET_OPEN_SUPPORTED_AF_LIST
+        }));
+        FROM(family);
+
+        clarinet_endpoint local;
+        switch (family)
+        {
+            case CLARINET_AF_INET:
+                local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+                break;
+            case CLARINET_AF_INET6:
+                local = clarinet_make_endpoint(clarinet_addr_loopback_ipv6, 0);
+                break;
+            default:
+                FAIL();
+        }
+
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, family, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, family, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        // Send more messages than fit in a single batch so the implementation has to split the operation. Every other
+        // message is larger than the receive buffer and must be reported as truncated.
+        constexpr size_t count = CLARINET_SOCKET_MESSAGE_BATCH_SIZE + 8;
+        constexpr size_t small = 16;
+        constexpr size_t large = 64;
+
+        std::vector<std::vector<uint8_t>> sbufs(count);
+        std::vector<clarinet_socket_message> smsgs(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            sbufs[i].assign((i % 2) ? large : small, (uint8_t)i);
+            smsgs[i] = { sbufs[i].data(), sbufs[i].size(), remote, 0 };
+        }
+
+        errcode = clarinet_socket_sendmany(ssp, smsgs.data(), smsgs.size());
+        REQUIRE(errcode == (int)count);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(smsgs[i].result == (int)sbufs[i].size());
+
+        std::vector<std::vector<uint8_t>> rbufs(count, std::vector<uint8_t>(small * 2));
+        std::vector<clarinet_socket_message> rmsgs(count);
+        for (size_t i = 0; i < count; ++i)
+            rmsgs[i] = { rbufs[i].data(), rbufs[i].size(), { clarinet_addr_none, 0 }, 0 };
+
+        // On loopback all datagrams are queued by the time sendmany returns but the receiver is allowed to return
+        // early so we may need more than one call.
+        size_t received = 0;
+        while (received < count)
+        {
+            errcode = clarinet_socket_recvmany(dsp, rmsgs.data() + received, count - received);
+            REQUIRE(errcode > 0);
+            received += (size_t)errcode;
+        }
+
+        clarinet_endpoint sender;
+        errcode = clarinet_socket_local_endpoint(ssp, &sender);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            FROM(i);
+            REQUIRE(rmsgs[i].remote.port == sender.port);
+            if (i % 2)
+            {
+                REQUIRE(Error(rmsgs[i].result) == Error(CLARINET_EMSGSIZE));
+            }
+            else
+            {
+                REQUIRE(rmsgs[i].result == (int)small);
+                REQUIRE(rbufs[i][0] == (uint8_t)i);
+            }
+        }
+    }
+}
+
+TEST_CASE("Socket Send/Recv Segments")
+{
+    SECTION("With NULL socket")
+    {
+        uint8_t buf[8] = { 0 };
+        const clarinet_endpoint remote = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 9);
+
+        int errcode = clarinet_socket_sendsegments(nullptr, buf, sizeof(buf), 4, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        size_t segsize = 0;
+        clarinet_endpoint source;
+        errcode = clarinet_socket_recvsegments(nullptr, buf, sizeof(buf), &segsize, &source);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket ON " CONFIG_SYSTEM_NAME)
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        // 10 full segments plus a short one
+        constexpr size_t segment = 100;
+        std::vector<uint8_t> buf(segment * 10 + segment / 2, 0xAA);
+
+        #if defined(__linux__)
+        errcode = clarinet_socket_sendsegments(ssp, buf.data(), buf.size(), segment, &remote);
+        REQUIRE(errcode == (int)buf.size());
+
+        // Without GRO every segment is received as an individual datagram
+        std::vector<uint8_t> rbuf(65536);
+        size_t received = 0;
+        while (received < buf.size())
+        {
+            size_t segsize = 0;
+            clarinet_endpoint sender;
+            errcode = clarinet_socket_recvsegments(dsp, rbuf.data(), rbuf.size(), &segsize, &sender);
+            REQUIRE(errcode > 0);
+            REQUIRE(segsize == (size_t)errcode);
+            REQUIRE(segsize == ((buf.size() - received) < segment ? (buf.size() - received) : segment));
+            received += (size_t)errcode;
+        }
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(dsp, CLARINET_UDP_GRO, &enabled, sizeof(enabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const int32_t value = (int32_t)segment;
+        errcode = clarinet_socket_setopt(ssp, CLARINET_UDP_SEGMENT, &value, sizeof(value));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        int32_t optval = 0;
+        size_t optlen = sizeof(optval);
+        errcode = clarinet_socket_getopt(ssp, CLARINET_UDP_SEGMENT, &optval, &optlen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(optval == value);
+
+        errcode = clarinet_socket_sendto(ssp, buf.data(), buf.size(), &remote);
+        REQUIRE(errcode == (int)buf.size());
+
+        // With GRO the system is allowed but not required to coalesce segments so we can only verify that the total
+        // number of bytes adds up and no segment is larger than expected.
+        received = 0;
+        while (received < buf.size())
+        {
+            size_t segsize = 0;
+            clarinet_endpoint sender;
+            errcode = clarinet_socket_recvsegments(dsp, rbuf.data(), rbuf.size(), &segsize, &sender);
+            REQUIRE(errcode > 0);
+            REQUIRE(segsize <= segment);
+            received += (size_t)errcode;
+        }
+        REQUIRE(received == buf.size());
+        #else
+        errcode = clarinet_socket_sendsegments(ssp, buf.data(), buf.size(), segment, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+        #endif
+    }
+}
+
+TEST_CASE("Socket Recv From Timestamp")
+{
+    SECTION("With NULL arguments")
+    {
+        uint8_t buf[8] = { 0 };
+        uint64_t timestamp = 0;
+        clarinet_endpoint source;
+
+        int errcode = clarinet_socket_recvfromts(nullptr, buf, sizeof(buf), &timestamp, &source);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_socket socket;
+        clarinet_socket* sp = &socket;
+        clarinet_socket_init(sp);
+
+        errcode = clarinet_socket_open(sp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsocketexit = finalizer([&sp]
+        {
+            clarinet_socket_close(sp);
+        });
+
+        errcode = clarinet_socket_recvfromts(sp, buf, sizeof(buf), nullptr, &source);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket ON " CONFIG_SYSTEM_NAME)
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const uint8_t buf[] = { 0xAA, 0xBB, 0xCC };
+        uint8_t rbuf[16];
+        uint64_t timestamp = UINT64_MAX;
+        clarinet_endpoint sender;
+
+        #if !defined(_WIN32)
+        // Without the option enabled there is no timestamp
+        errcode = clarinet_socket_sendto(ssp, buf, sizeof(buf), &remote);
+        REQUIRE(errcode == (int)sizeof(buf));
+
+        errcode = clarinet_socket_recvfromts(dsp, rbuf, sizeof(rbuf), &timestamp, &sender);
+        REQUIRE(errcode == (int)sizeof(buf));
+        REQUIRE(timestamp == 0);
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(dsp, CLARINET_SO_TIMESTAMP, &enabled, sizeof(enabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        int32_t optval = 0;
+        size_t optlen = sizeof(optval);
+        errcode = clarinet_socket_getopt(dsp, CLARINET_SO_TIMESTAMP, &optval, &optlen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(optval == 1);
+
+        const auto now = []
+        {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        };
+
+        // Allow some slack for the difference in resolution between the system clock and the timestamps.
+        const uint64_t before = now() - 1000000;
+        errcode = clarinet_socket_sendto(ssp, buf, sizeof(buf), &remote);
+        REQUIRE(errcode == (int)sizeof(buf));
+
+        suspend(50);
+
+        errcode = clarinet_socket_recvfromts(dsp, rbuf, sizeof(rbuf), &timestamp, &sender);
+        REQUIRE(errcode == (int)sizeof(buf));
+        REQUIRE(timestamp >= before);
+
+        // The datagram waited in the socket buffer so it must have been received before it was fetched.
+        const uint64_t after = now();
+        REQUIRE(timestamp <= after);
+        REQUIRE(after - timestamp >= 40000000);
+        #else
+        errcode = clarinet_socket_recvfromts(dsp, rbuf, sizeof(rbuf), &timestamp, &sender);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+        #endif
+    }
+
+    SECTION("With TCP socket")
+    {
+        clarinet_socket socket;
+        clarinet_socket* sp = &socket;
+        clarinet_socket_init(sp);
+
+        int errcode = clarinet_socket_open(sp, CLARINET_AF_INET, CLARINET_PROTO_TCP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsocketexit = finalizer([&sp]
+        {
+            clarinet_socket_close(sp);
+        });
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(sp, CLARINET_SO_TIMESTAMP, &enabled, sizeof(enabled));
+        #if !defined(_WIN32)
+        REQUIRE(Error(errcode) == Error(CLARINET_EPROTONOSUPPORT));
+        #else
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        #endif
+    }
+}
+
+TEST_CASE("Socket Send Zero-copy")
+{
+    SECTION("With NULL socket")
+    {
+        uint8_t buf[8] = { 0 };
+        int errcode = clarinet_socket_sendzc(nullptr, buf, sizeof(buf), nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_zerocopy_range ranges[1];
+        errcode = clarinet_socket_zerocopy_reap(nullptr, ranges, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket ON " CONFIG_SYSTEM_NAME)
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        std::vector<uint8_t> buf(CLARINET_ZEROCOPY_THRESHOLD, 0xAA);
+
+        #if defined(__linux__)
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_ZEROCOPY, &enabled, sizeof(enabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        int32_t optval = 0;
+        size_t optlen = sizeof(optval);
+        errcode = clarinet_socket_getopt(ssp, CLARINET_SO_ZEROCOPY, &optval, &optlen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(optval == enabled);
+
+        // Two zero-copy sends (identifiers 0 and 1) and a small one that is copied and gets no identifier
+        errcode = clarinet_socket_sendzc(ssp, buf.data(), buf.size(), &remote);
+        REQUIRE(errcode == (int)buf.size());
+
+        errcode = clarinet_socket_sendzc(ssp, buf.data(), 16, &remote);
+        REQUIRE(errcode == 16);
+
+        errcode = clarinet_socket_sendzc(ssp, buf.data(), buf.size(), &remote);
+        REQUIRE(errcode == (int)buf.size());
+
+        std::vector<uint8_t> rbuf(buf.size());
+        for (int i = 0; i < 3; ++i)
+        {
+            clarinet_endpoint sender;
+            errcode = clarinet_socket_recvfrom(dsp, rbuf.data(), rbuf.size(), &sender);
+            REQUIRE(errcode > 0);
+        }
+
+        // Notifications are asynchronous and may be split in several ranges.
+        uint32_t expected = 0;
+        for (int attempts = 0; expected < 2 && attempts < 100; ++attempts)
+        {
+            clarinet_zerocopy_range ranges[4];
+            errcode = clarinet_socket_zerocopy_reap(ssp, ranges, 4);
+            REQUIRE(errcode >= 0);
+            for (int i = 0; i < errcode; ++i)
+            {
+                REQUIRE(ranges[i].first == expected);
+                REQUIRE(ranges[i].last >= ranges[i].first);
+                expected = ranges[i].last + 1;
+            }
+
+            if (expected < 2)
+                suspend(10);
+        }
+        REQUIRE(expected == 2);
+        #else
+        errcode = clarinet_socket_sendzc(ssp, buf.data(), buf.size(), &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+        #endif
+    }
+}
+
+TEST_CASE("Socket Send Timed")
+{
+    SECTION("With NULL socket")
+    {
+        uint8_t buf[8] = { 0 };
+        const clarinet_endpoint remote = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 1);
+        int errcode = clarinet_socket_sendtoat(nullptr, buf, sizeof(buf), &remote, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket ON " CONFIG_SYSTEM_NAME)
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const uint8_t buf[] = { 0xAA, 0xBB, 0xCC };
+        uint8_t rbuf[16];
+        clarinet_endpoint sender;
+
+        #if defined(__linux__)
+        uint64_t rate = 0;
+        size_t ratelen = sizeof(rate);
+        errcode = clarinet_socket_getopt(ssp, CLARINET_SO_MAX_PACING_RATE, &rate, &ratelen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(rate == UINT64_MAX);
+
+        for (const uint64_t value: { (uint64_t)125000, (uint64_t)UINT32_MAX - 1, (uint64_t)UINT64_MAX })
+        {
+            errcode = clarinet_socket_setopt(ssp, CLARINET_SO_MAX_PACING_RATE, &value, sizeof(value));
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            ratelen = sizeof(rate);
+            errcode = clarinet_socket_getopt(ssp, CLARINET_SO_MAX_PACING_RATE, &rate, &ratelen);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(ratelen == sizeof(rate));
+            REQUIRE(rate == value);
+        }
+
+        rate = 0;
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_MAX_PACING_RATE, &rate, sizeof(rate));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Transmit times are rejected until the option is enabled
+        errcode = clarinet_socket_sendtoat(ssp, buf, sizeof(buf), &remote, clarinet_time_now_us());
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        int32_t optval = -1;
+        size_t optlen = sizeof(optval);
+        errcode = clarinet_socket_getopt(ssp, CLARINET_SO_TXTIME, &optval, &optlen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(optval == 0);
+
+        // The option cannot be disabled
+        const int32_t disabled = 0;
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_TXTIME, &disabled, sizeof(disabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(ssp, CLARINET_SO_TXTIME, &enabled, sizeof(enabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        optlen = sizeof(optval);
+        errcode = clarinet_socket_getopt(ssp, CLARINET_SO_TXTIME, &optval, &optlen);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(optval == 1);
+
+        // Whether the datagram is delayed depends on the queueing discipline of the interface so only check that it
+        // arrives. Loopback usually has none in which case transmit times are ignored.
+        errcode = clarinet_socket_sendtoat(ssp, buf, sizeof(buf), &remote, clarinet_time_now_us() + 1000);
+        REQUIRE(errcode == (int)sizeof(buf));
+
+        errcode = clarinet_socket_recvfrom(dsp, rbuf, sizeof(rbuf), &sender);
+        REQUIRE(errcode == (int)sizeof(buf));
+        REQUIRE(memcmp(rbuf, buf, sizeof(buf)) == 0);
+        #else
+        errcode = clarinet_socket_sendtoat(ssp, buf, sizeof(buf), &remote, clarinet_time_now_us());
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+        #endif
+    }
+
+    SECTION("With TCP socket")
+    {
+        clarinet_socket socket;
+        clarinet_socket* sp = &socket;
+        clarinet_socket_init(sp);
+
+        int errcode = clarinet_socket_open(sp, CLARINET_AF_INET, CLARINET_PROTO_TCP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsocketexit = finalizer([&sp]
+        {
+            clarinet_socket_close(sp);
+        });
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(sp, CLARINET_SO_TXTIME, &enabled, sizeof(enabled));
+        #if defined(__linux__)
+        REQUIRE(Error(errcode) == Error(CLARINET_EPROTONOSUPPORT));
+        #else
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+        #endif
+    }
+}
+
+TEST_CASE("Socket Statistics")
+{
+    clarinet_socket_stats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    SECTION("With NULL arguments")
+    {
+        int errcode = clarinet_socket_setstats(nullptr, &stats);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_getstats(nullptr, &stats);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_socket socket;
+        clarinet_socket_init(&socket);
+
+        errcode = clarinet_socket_getstats(&socket, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UDP socket")
+    {
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint remote;
+        errcode = clarinet_socket_local_endpoint(dsp, &remote);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        #if defined(CLARINET_ENABLE_PROFILE)
+        clarinet_socket_stats snapshot;
+        errcode = clarinet_socket_getstats(dsp, &snapshot);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+
+        clarinet_socket_stats input;
+        memset(&input, 0, sizeof(input));
+
+        errcode = clarinet_socket_setstats(ssp, &stats);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_setstats(dsp, &input);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const int32_t enabled = 1;
+        errcode = clarinet_socket_setopt(dsp, CLARINET_SO_NONBLOCK, &enabled, sizeof(enabled));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        const uint8_t buf[100] = { 0 };
+        for (size_t i = 1; i <= 3; ++i)
+        {
+            errcode = clarinet_socket_sendto(ssp, buf, i * 10, &remote);
+            REQUIRE(errcode == (int)(i * 10));
+        }
+
+        suspend(10);
+
+        // Two datagrams fit the buffer and the third is truncated
+        uint8_t rbuf[25];
+        clarinet_endpoint sender;
+        for (size_t i = 1; i <= 2; ++i)
+        {
+            errcode = clarinet_socket_recvfrom(dsp, rbuf, sizeof(rbuf), &sender);
+            REQUIRE(errcode == (int)(i * 10));
+        }
+
+        errcode = clarinet_socket_recvfrom(dsp, rbuf, sizeof(rbuf), &sender);
+        REQUIRE(Error(errcode) == Error(CLARINET_EMSGSIZE));
+
+        errcode = clarinet_socket_recvfrom(dsp, rbuf, sizeof(rbuf), &sender);
+        REQUIRE(Error(errcode) == Error(CLARINET_EAGAIN));
+
+        // Arguments that never reach the system are not counted
+        errcode = clarinet_socket_recvfrom(dsp, rbuf, 0, &sender);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_socket_getstats(ssp, &snapshot);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(snapshot.syscalls == 3);
+        REQUIRE(snapshot.packets_out == 3);
+        REQUIRE(snapshot.bytes_out == 60);
+        REQUIRE(snapshot.packets_in == 0);
+        REQUIRE(snapshot.errors == 0);
+
+        errcode = clarinet_socket_getstats(dsp, &snapshot);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(snapshot.syscalls == 4);
+        REQUIRE(snapshot.packets_in == 2);
+        REQUIRE(snapshot.bytes_in == 30);
+        REQUIRE(snapshot.truncated == 1);
+        REQUIRE(snapshot.again == 1);
+        REQUIRE(snapshot.errors == 0);
+        REQUIRE(snapshot.packets_out == 0);
+
+        #if defined(__linux__)
+        // An ICMP port unreachable is reported by the next operation on a connected socket
+        clarinet_socket closed;
+        clarinet_socket* csp = &closed;
+        clarinet_socket_init(csp);
+
+        errcode = clarinet_socket_open(csp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_bind(csp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint unreachable;
+        errcode = clarinet_socket_local_endpoint(csp, &unreachable);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_close(csp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_connect(ssp, &unreachable);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_send(ssp, buf, sizeof(buf));
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        suspend(10);
+
+        errcode = clarinet_socket_send(ssp, buf, sizeof(buf));
+        REQUIRE(Error(errcode) == Error(CLARINET_ECONNREFUSED));
+
+        errcode = clarinet_socket_getstats(ssp, &snapshot);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(snapshot.syscalls == 5);
+        REQUIRE(snapshot.packets_out == 4);
+        REQUIRE(snapshot.errors == 1);
+        REQUIRE(snapshot.errors_by_code[-CLARINET_ECONNREFUSED] == 1);
+        #endif
+
+        // Counters are detached when the socket is closed
+        errcode = clarinet_socket_close(dsp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(destination.stats == nullptr);
+        #else
+        errcode = clarinet_socket_setstats(ssp, &stats);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+
+        clarinet_socket_stats snapshot;
+        errcode = clarinet_socket_getstats(ssp, &snapshot);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+        #endif
+    }
+}
+
+TEST_CASE("Socket Poll")
+{
+    clarinet_socket source;
+    clarinet_socket* ssp = &source;
+    clarinet_socket_init(ssp);
+
+    int errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onsourceexit = finalizer([&ssp]
+    {
+        clarinet_socket_close(ssp);
+    });
+
+    clarinet_socket destination;
+    clarinet_socket* dsp = &destination;
+    clarinet_socket_init(dsp);
+
+    errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto ondestinationexit = finalizer([&dsp]
+    {
+        clarinet_socket_close(dsp);
+    });
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+    errcode = clarinet_socket_bind(dsp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint remote;
+    errcode = clarinet_socket_local_endpoint(dsp, &remote);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_socket unopen;
+    clarinet_socket_init(&unopen);
+
+    const clarinet_socket_poll_target targets[] = {
+        { dsp, CLARINET_POLL_RECV },
+        { ssp, CLARINET_POLL_SEND },
+        { &unopen, CLARINET_POLL_RECV },
+    };
+    constexpr size_t count = sizeof(targets) / sizeof(targets[0]);
+
+    const int size = clarinet_socket_poll_context_calcsize(count);
+    REQUIRE(size > 0);
+    std::vector<uint8_t> context((size_t)size);
+
+    const uint8_t buf[] = { 0xAA, 0xBB, 0xCC };
+    errcode = clarinet_socket_sendto(ssp, buf, sizeof(buf), &remote);
+    REQUIRE(errcode == (int)sizeof(buf));
+
+    errcode = clarinet_socket_poll(context.data(), targets, count, 1000);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    uint16_t status = CLARINET_POLL_NONE;
+    errcode = clarinet_socket_poll_context_getstatus(context.data(), 0, &status);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    REQUIRE(status == CLARINET_POLL_RECV);
+
+    errcode = clarinet_socket_poll_context_getstatus(context.data(), 1, &status);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    REQUIRE(status == CLARINET_POLL_SEND);
+
+    errcode = clarinet_socket_poll_context_getstatus(context.data(), 2, &status);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    REQUIRE(status == CLARINET_POLL_INVALID);
+}
+
 TEST_CASE("Socket Shutdown")
 {
     SECTION("With NULL socket")
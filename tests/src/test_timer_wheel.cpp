@@ -0,0 +1,372 @@
+#include "test.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+TEST_CASE("Timer Wheel Initialize")
+{
+    clarinet_timer_wheel wheel;
+    memset(&wheel, 0xFF, sizeof(wheel));
+    clarinet_timer_wheel_init(&wheel);
+
+    clarinet_timer_wheel expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&wheel, &expected, sizeof(wheel)) == 0);
+
+    clarinet_timer timer;
+    memset(&timer, 0xFF, sizeof(timer));
+    clarinet_timer_init(&timer);
+    REQUIRE_FALSE(clarinet_timer_is_scheduled(&timer));
+}
+
+TEST_CASE("Timer Wheel Clock")
+{
+    const uint64_t a = clarinet_time_now();
+    const uint64_t c = clarinet_time_now_us();
+    suspend(20);
+    const uint64_t b = clarinet_time_now();
+    const uint64_t d = clarinet_time_now_us();
+    REQUIRE(b >= a + 10);
+    REQUIRE(d >= c + 10000);
+}
+
+TEST_CASE("Timer Wheel Open/Close")
+{
+    SECTION("With NULL wheel")
+    {
+        int errcode = clarinet_timer_wheel_open(nullptr, 1, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_wheel_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(clarinet_timer_wheel_timeout(nullptr, 0) == -1);
+    }
+
+    SECTION("With UNOPEN wheel")
+    {
+        clarinet_timer_wheel wheel;
+        clarinet_timer_wheel_init(&wheel);
+        clarinet_timer timer;
+        clarinet_timer_init(&timer);
+        clarinet_timer* expired[1];
+
+        int errcode = clarinet_timer_wheel_close(&wheel);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_schedule(&wheel, &timer, 10);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_cancel(&wheel, &timer);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_wheel_advance(&wheel, 10, expired, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, 0) == -1);
+    }
+
+    SECTION("With ZERO resolution")
+    {
+        clarinet_timer_wheel wheel;
+        clarinet_timer_wheel_init(&wheel);
+
+        int errcode = clarinet_timer_wheel_open(&wheel, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("SAME wheel TWICE")
+    {
+        clarinet_timer_wheel wheel;
+        clarinet_timer_wheel_init(&wheel);
+
+        int errcode = clarinet_timer_wheel_open(&wheel, 10, 1000);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(wheel.resolution == 10);
+        REQUIRE(wheel.count == 0);
+
+        errcode = clarinet_timer_wheel_open(&wheel, 10, 1000);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_wheel_close(&wheel);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_timer_wheel_close(&wheel);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With SCHEDULED timers")
+    {
+        clarinet_timer_wheel wheel;
+        clarinet_timer_wheel_init(&wheel);
+        int errcode = clarinet_timer_wheel_open(&wheel, 1, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_timer timers[4];
+        const uint64_t expiry[] = { 0, 10, 100000, UINT64_MAX };
+        for (size_t i = 0; i < 4; ++i)
+        {
+            clarinet_timer_init(&timers[i]);
+            errcode = clarinet_timer_schedule(&wheel, &timers[i], expiry[i]);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            REQUIRE(clarinet_timer_is_scheduled(&timers[i]));
+        }
+        REQUIRE(wheel.count == 4);
+
+        errcode = clarinet_timer_wheel_close(&wheel);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        for (auto& timer: timers)
+            REQUIRE_FALSE(clarinet_timer_is_scheduled(&timer));
+    }
+}
+
+TEST_CASE("Timer Wheel Schedule/Cancel")
+{
+    clarinet_timer_wheel wheel;
+    clarinet_timer_wheel_init(&wheel);
+    int errcode = clarinet_timer_wheel_open(&wheel, 1, 1000);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&wheel]
+    {
+        clarinet_timer_wheel_close(&wheel);
+    });
+
+    clarinet_timer timer;
+    clarinet_timer_init(&timer);
+    clarinet_timer* expired[4];
+
+    SECTION("With INVALID arguments")
+    {
+        errcode = clarinet_timer_schedule(&wheel, nullptr, 10);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_cancel(&wheel, nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_wheel_advance(&wheel, 1000, nullptr, 1);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_timer_wheel_advance(&wheel, 1000, expired, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("UNSCHEDULED timer")
+    {
+        errcode = clarinet_timer_cancel(&wheel, &timer);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("Cancel")
+    {
+        errcode = clarinet_timer_schedule(&wheel, &timer, 1010);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_timer_cancel(&wheel, &timer);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE_FALSE(clarinet_timer_is_scheduled(&timer));
+        REQUIRE(wheel.count == 0);
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, 1000) == -1);
+
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 2000, expired, 4) == 0);
+
+        errcode = clarinet_timer_cancel(&wheel, &timer);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTFOUND));
+    }
+
+    SECTION("Reschedule")
+    {
+        errcode = clarinet_timer_schedule(&wheel, &timer, 1010);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_timer_schedule(&wheel, &timer, 1500);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(wheel.count == 1);
+        REQUIRE(timer.expiry == 1500);
+
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 1499, expired, 4) == 0);
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 1500, expired, 4) == 1);
+        REQUIRE(expired[0] == &timer);
+        REQUIRE_FALSE(clarinet_timer_is_scheduled(&timer));
+        REQUIRE(wheel.count == 0);
+    }
+
+    SECTION("In the PAST")
+    {
+        errcode = clarinet_timer_schedule(&wheel, &timer, 10);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, 1000) == 0);
+
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 1000, expired, 4) == 1);
+        REQUIRE(expired[0] == &timer);
+    }
+
+    SECTION("Cancel EXPIRED timer not yet returned")
+    {
+        clarinet_timer other;
+        clarinet_timer_init(&other);
+
+        errcode = clarinet_timer_schedule(&wheel, &timer, 1001);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        errcode = clarinet_timer_schedule(&wheel, &other, 1001);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 1001, expired, 1) == 1);
+        clarinet_timer* pending = (expired[0] == &timer) ? &other : &timer;
+        errcode = clarinet_timer_cancel(&wheel, pending);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        REQUIRE(wheel.count == 0);
+
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, 1001, expired, 4) == 0);
+    }
+}
+
+TEST_CASE("Timer Wheel Advance")
+{
+    const uint32_t resolution = GENERATE(1u, 10u);
+    const uint64_t start = 123450;
+
+    clarinet_timer_wheel wheel;
+    clarinet_timer_wheel_init(&wheel);
+    int errcode = clarinet_timer_wheel_open(&wheel, resolution, start);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onexit = finalizer([&wheel]
+    {
+        clarinet_timer_wheel_close(&wheel);
+    });
+
+    SECTION("Every level")
+    {
+        // Delays cover all levels and go past the span of the wheel.
+        const uint64_t delays[] = { 1, 63, 64, 65, 4095, 4097, 300000, 16777215, 16777217, 40000000 };
+        constexpr size_t count = sizeof(delays) / sizeof(delays[0]);
+        clarinet_timer timers[count];
+        for (size_t i = 0; i < count; ++i)
+        {
+            clarinet_timer_init(&timers[i]);
+            timers[i].data = (void*)(uintptr_t)i;
+            errcode = clarinet_timer_schedule(&wheel, &timers[i], start + delays[i] * resolution);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        // Wake up only when the wheel says so and never find a timer late or early.
+        uint64_t now = start;
+        size_t next = 0;
+        size_t wakeups = 0;
+        while (next < count)
+        {
+            const int timeout = clarinet_timer_wheel_timeout(&wheel, now);
+            REQUIRE(timeout >= 0);
+            now += (uint64_t)timeout;
+            wakeups++;
+
+            clarinet_timer* expired[count];
+            const int n = clarinet_timer_wheel_advance(&wheel, now, expired, count);
+            REQUIRE(n >= 0);
+            for (int i = 0; i < n; ++i)
+            {
+                REQUIRE(expired[i] == &timers[next]);
+                REQUIRE(expired[i]->expiry == now);
+                next++;
+            }
+        }
+
+        REQUIRE(wheel.count == 0);
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, now) == -1);
+        REQUIRE(wakeups < 3 * count);
+    }
+
+    SECTION("In batches")
+    {
+        clarinet_timer timers[10];
+        for (auto& timer: timers)
+        {
+            clarinet_timer_init(&timer);
+            errcode = clarinet_timer_schedule(&wheel, &timer, start + 50 * resolution);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        clarinet_timer* expired[4];
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, start) == (int)(50 * resolution));
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, start + 50 * resolution, expired, 4) == 4);
+        REQUIRE(clarinet_timer_wheel_timeout(&wheel, start + 50 * resolution) == 0);
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, start + 50 * resolution, expired, 4) == 4);
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, start + 50 * resolution, expired, 4) == 2);
+        REQUIRE(clarinet_timer_wheel_advance(&wheel, start + 50 * resolution, expired, 4) == 0);
+        REQUIRE(wheel.count == 0);
+    }
+
+    SECTION("Against a REFERENCE")
+    {
+        constexpr size_t count = 2000;
+        std::mt19937_64 rng(42);
+        std::vector<clarinet_timer> timers(count);
+        for (auto& timer: timers)
+            clarinet_timer_init(&timer);
+
+        uint64_t now = start;
+        std::vector<clarinet_timer*> expired(count);
+        for (int round = 0; round < 2000; ++round)
+        {
+            // Schedule, reschedule or cancel a few random timers with delays of every magnitude.
+            for (int k = 0; k < 8; ++k)
+            {
+                clarinet_timer* timer = &timers[rng() % count];
+                if (rng() % 4 == 0)
+                {
+                    clarinet_timer_cancel(&wheel, timer);
+                }
+                else
+                {
+                    const uint64_t delay = rng() % ((uint64_t)1 << (rng() % 26));
+                    errcode = clarinet_timer_schedule(&wheel, timer, now + delay);
+                    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+                }
+            }
+
+            now += rng() % ((uint64_t)1 << (rng() % 20));
+            const int n = clarinet_timer_wheel_advance(&wheel, now, expired.data(), count);
+            REQUIRE(n >= 0);
+
+            // Every timer that is due must have expired and no other.
+            const uint64_t deadline = now - now % resolution;
+            for (int i = 0; i < n; ++i)
+            {
+                REQUIRE(expired[i]->expiry <= deadline);
+                REQUIRE_FALSE(clarinet_timer_is_scheduled(expired[i]));
+            }
+
+            size_t scheduled = 0;
+            for (auto& timer: timers)
+            {
+                if (!clarinet_timer_is_scheduled(&timer))
+                    continue;
+
+                scheduled++;
+                REQUIRE(timer.expiry > deadline);
+            }
+            REQUIRE(wheel.count == scheduled);
+
+            const int timeout = clarinet_timer_wheel_timeout(&wheel, now);
+            if (scheduled == 0)
+            {
+                REQUIRE(timeout == -1);
+            }
+            else
+            {
+                const auto first = std::min_element(timers.begin(), timers.end(),
+                                                    [](const clarinet_timer& a, const clarinet_timer& b)
+                                                    {
+                                                        const uint64_t x = a.pprev ? a.expiry : UINT64_MAX;
+                                                        const uint64_t y = b.pprev ? b.expiry : UINT64_MAX;
+                                                        return x < y;
+                                                    });
+                REQUIRE(timeout >= 0);
+                REQUIRE(now + (uint64_t)timeout <= first->expiry + resolution - 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,571 @@
+#include "test.h"
+
+// Scope initialize and finalize the library
+static autoload loader;
+
+// The running kernel may not support io_uring even when the library is built with it so every test that depends on an
+// open ring must tolerate CLARINET_ENOTSUP.
+#define DEPENDS_ON_URING(errcode) do { if ((errcode) == CLARINET_ENOTSUP) { WARN("io_uring is not supported by the system."); return; } } while(0)
+
+TEST_CASE("Uring Initialize")
+{
+    clarinet_uring ring;
+    memset(&ring, 0xFF, sizeof(ring));
+    clarinet_uring_init(&ring);
+
+    clarinet_uring expected;
+    memset(&expected, 0, sizeof(expected));
+    REQUIRE(memcmp(&ring, &expected, sizeof(ring)) == 0);
+}
+
+TEST_CASE("Uring Open/Close")
+{
+    SECTION("With NULL ring")
+    {
+        int errcode = clarinet_uring_open(nullptr, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_close(nullptr);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With UNOPEN ring")
+    {
+        clarinet_uring ring;
+        clarinet_uring_init(&ring);
+
+        int errcode = clarinet_uring_close(&ring);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        clarinet_uring_completion completions[1];
+        errcode = clarinet_uring_wait(&ring, completions, 1, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With ZERO entries")
+    {
+        clarinet_uring ring;
+        clarinet_uring_init(&ring);
+
+        int errcode = clarinet_uring_open(&ring, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    #if CLARINET_ENABLE_URING
+    SECTION("SAME ring TWICE")
+    {
+        clarinet_uring ring;
+        clarinet_uring_init(&ring);
+
+        int errcode = clarinet_uring_open(&ring, 8);
+        DEPENDS_ON_URING(errcode);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_open(&ring, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_close(&ring);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_close(&ring);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+    #else
+    SECTION("With UNSUPPORTED platform")
+    {
+        clarinet_uring ring;
+        clarinet_uring_init(&ring);
+
+        int errcode = clarinet_uring_open(&ring, 8);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOTSUP));
+    }
+    #endif
+}
+
+#if CLARINET_ENABLE_URING
+TEST_CASE("Uring Send/Recv")
+{
+    clarinet_uring ring;
+    clarinet_uring* ur = &ring;
+    clarinet_uring_init(ur);
+
+    int errcode = clarinet_uring_open(ur, 8);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onringexit = finalizer([&ur]
+    {
+        clarinet_uring_close(ur);
+    });
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    clarinet_socket source;
+    clarinet_socket* ssp = &source;
+    clarinet_socket_init(ssp);
+
+    errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onsourceexit = finalizer([&ssp]
+    {
+        clarinet_socket_close(ssp);
+    });
+
+    errcode = clarinet_socket_bind(ssp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint source_endpoint;
+    errcode = clarinet_socket_local_endpoint(ssp, &source_endpoint);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_socket destination;
+    clarinet_socket* dsp = &destination;
+    clarinet_socket_init(dsp);
+
+    errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto ondestinationexit = finalizer([&dsp]
+    {
+        clarinet_socket_close(dsp);
+    });
+
+    errcode = clarinet_socket_bind(dsp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint destination_endpoint;
+    errcode = clarinet_socket_local_endpoint(dsp, &destination_endpoint);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    const uint8_t sendbuf[] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE };
+    clarinet_uring_completion completions[4];
+
+    SECTION("With NO operations")
+    {
+        errcode = clarinet_uring_wait(ur, completions, 4, 1000);
+        REQUIRE(errcode == 0);
+    }
+
+    SECTION("With datagram that FITS")
+    {
+        uint8_t recvbuf[sizeof(sendbuf)] = { 0 };
+        clarinet_endpoint remote = { clarinet_addr_none, 0 };
+
+        errcode = clarinet_uring_recvfrom(ur, dsp, recvbuf, sizeof(recvbuf), &remote, recvbuf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_sendto(ur, ssp, sendbuf, sizeof(sendbuf), &destination_endpoint, (void*)sendbuf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        size_t reaped = 0;
+        while (reaped < 2)
+        {
+            errcode = clarinet_uring_wait(ur, &completions[reaped], 4 - reaped, 1000);
+            REQUIRE(errcode > 0);
+            reaped += (size_t)errcode;
+        }
+
+        for (size_t i = 0; i < reaped; ++i)
+            REQUIRE(completions[i].result == (int)sizeof(sendbuf));
+
+        REQUIRE(memcmp(recvbuf, sendbuf, sizeof(sendbuf)) == 0);
+        REQUIRE(clarinet_endpoint_is_equal(&remote, &source_endpoint));
+    }
+
+    SECTION("With datagram TRUNCATED")
+    {
+        uint8_t recvbuf[sizeof(sendbuf) - 1] = { 0 };
+        clarinet_endpoint remote = { clarinet_addr_none, 0 };
+
+        errcode = clarinet_uring_recvfrom(ur, dsp, recvbuf, sizeof(recvbuf), &remote, recvbuf);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_socket_sendto(ssp, sendbuf, sizeof(sendbuf), &destination_endpoint);
+        REQUIRE(errcode == (int)sizeof(sendbuf));
+
+        errcode = clarinet_uring_wait(ur, completions, 4, 1000);
+        REQUIRE(errcode == 1);
+        REQUIRE(completions[0].data == recvbuf);
+        REQUIRE(Error(completions[0].result) == Error(CLARINET_EMSGSIZE));
+        REQUIRE(clarinet_endpoint_is_equal(&remote, &source_endpoint));
+    }
+
+    SECTION("With TOO MANY operations")
+    {
+        uint8_t recvbuf[sizeof(sendbuf)];
+        int queued = 0;
+        do
+        {
+            errcode = clarinet_uring_recv(ur, dsp, recvbuf, sizeof(recvbuf), nullptr);
+        } while (errcode == CLARINET_ENONE && ++queued < 1024);
+
+        REQUIRE(Error(errcode) == Error(CLARINET_ENOBUFS));
+        REQUIRE(queued >= 8);
+
+        // Closing the ring must cancel every operation in-flight.
+    }
+}
+
+TEST_CASE("Uring Recv Multishot")
+{
+    clarinet_uring ring;
+    clarinet_uring* ur = &ring;
+    clarinet_uring_init(ur);
+
+    int errcode = clarinet_uring_open(ur, 8);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onringexit = finalizer([&ur]
+    {
+        clarinet_uring_close(ur);
+    });
+
+    constexpr size_t bufsize = CLARINET_URING_BUFFER_OVERHEAD + 16;
+    constexpr uint16_t bufcount = 4;
+    std::vector<uint8_t> buffers(bufsize * bufcount);
+
+    errcode = clarinet_uring_provide(ur, 0, buffers.data(), bufsize, bufcount);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    SECTION("With group registered TWICE")
+    {
+        errcode = clarinet_uring_provide(ur, 0, buffers.data(), bufsize, bufcount);
+        REQUIRE(Error(errcode) == Error(CLARINET_EALREADY));
+    }
+
+    SECTION("With INVALID buffers")
+    {
+        errcode = clarinet_uring_provide(ur, CLARINET_URING_GROUPS_MAX, buffers.data(), bufsize, bufcount);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_provide(ur, 1, buffers.data(), CLARINET_URING_BUFFER_OVERHEAD, bufcount);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_provide(ur, 1, buffers.data(), bufsize, 3);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_release(ur, 0, bufcount);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_release(ur, 1, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        // Buffers are all held by the system until a completion hands them over.
+        errcode = clarinet_uring_release(ur, 0, 0);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+    }
+
+    SECTION("With datagrams")
+    {
+        const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+        clarinet_socket source;
+        clarinet_socket* ssp = &source;
+        clarinet_socket_init(ssp);
+
+        errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto onsourceexit = finalizer([&ssp]
+        {
+            clarinet_socket_close(ssp);
+        });
+
+        errcode = clarinet_socket_bind(ssp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint source_endpoint;
+        errcode = clarinet_socket_local_endpoint(ssp, &source_endpoint);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_socket destination;
+        clarinet_socket* dsp = &destination;
+        clarinet_socket_init(dsp);
+
+        errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        const auto ondestinationexit = finalizer([&dsp]
+        {
+            clarinet_socket_close(dsp);
+        });
+
+        errcode = clarinet_socket_bind(dsp, &local);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        clarinet_endpoint destination_endpoint;
+        errcode = clarinet_socket_local_endpoint(dsp, &destination_endpoint);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_recvfrom_multishot(ur, dsp, 0, dsp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_submit(ur);
+        REQUIRE(errcode == 1);
+
+        // One datagram more than the number of buffers so the operation terminates for lack of buffers.
+        const uint8_t sendbuf[] = { 0xAA, 0xBB, 0xCC };
+        for (size_t i = 0; i <= bufcount; ++i)
+        {
+            errcode = clarinet_socket_sendto(ssp, sendbuf, sizeof(sendbuf), &destination_endpoint);
+            REQUIRE(errcode == (int)sizeof(sendbuf));
+        }
+
+        clarinet_uring_completion completions[bufcount + 1];
+        size_t reaped = 0;
+        while (reaped < bufcount + 1)
+        {
+            errcode = clarinet_uring_wait(ur, &completions[reaped], bufcount + 1 - reaped, 1000);
+            if (errcode == CLARINET_EINVAL && reaped == 0)
+            {
+                WARN("Multishot receive is not supported by the system.");
+                return;
+            }
+            REQUIRE(errcode > 0);
+            reaped += (size_t)errcode;
+        }
+
+        for (size_t i = 0; i < bufcount; ++i)
+        {
+            const clarinet_uring_completion* completion = &completions[i];
+            REQUIRE(completion->data == dsp);
+            REQUIRE(completion->result == (int)sizeof(sendbuf));
+            REQUIRE(completion->flags == (CLARINET_URING_COMPLETION_MORE | CLARINET_URING_COMPLETION_BUFFER));
+            REQUIRE(completion->buffer < bufcount);
+            REQUIRE(memcmp(completion->buf, sendbuf, sizeof(sendbuf)) == 0);
+            REQUIRE(clarinet_endpoint_is_equal(&completion->remote, &source_endpoint));
+        }
+
+        REQUIRE(Error(completions[bufcount].result) == Error(CLARINET_ENOBUFS));
+        REQUIRE(completions[bufcount].flags == CLARINET_URING_COMPLETION_NONE);
+
+        // Release the buffers and re-arm to get the datagram left.
+        for (size_t i = 0; i < bufcount; ++i)
+        {
+            errcode = clarinet_uring_release(ur, 0, completions[i].buffer);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+        }
+
+        errcode = clarinet_uring_release(ur, 0, completions[0].buffer);
+        REQUIRE(Error(errcode) == Error(CLARINET_EINVAL));
+
+        errcode = clarinet_uring_recvfrom_multishot(ur, dsp, 0, dsp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_wait(ur, completions, 1, 1000);
+        REQUIRE(errcode == 1);
+        REQUIRE(completions[0].result == (int)sizeof(sendbuf));
+
+        errcode = clarinet_uring_cancel(ur, dsp);
+        REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+        errcode = clarinet_uring_wait(ur, completions, 1, 1000);
+        REQUIRE(errcode == 1);
+        REQUIRE(Error(completions[0].result) == Error(CLARINET_EINTR));
+        REQUIRE(completions[0].flags == CLARINET_URING_COMPLETION_NONE);
+    }
+}
+
+TEST_CASE("Uring Completion Overflow")
+{
+    clarinet_uring ring;
+    clarinet_uring* ur = &ring;
+    clarinet_uring_init(ur);
+
+    // The smallest ring has room for 2 completions so a multishot receive overflows it.
+    int errcode = clarinet_uring_open(ur, 1);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onringexit = finalizer([&ur]
+    {
+        clarinet_uring_close(ur);
+    });
+
+    constexpr size_t bufsize = CLARINET_URING_BUFFER_OVERHEAD + 16;
+    constexpr uint16_t bufcount = 8;
+    std::vector<uint8_t> buffers(bufsize * bufcount);
+
+    errcode = clarinet_uring_provide(ur, 0, buffers.data(), bufsize, bufcount);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    clarinet_socket source;
+    clarinet_socket* ssp = &source;
+    clarinet_socket_init(ssp);
+
+    errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onsourceexit = finalizer([&ssp]
+    {
+        clarinet_socket_close(ssp);
+    });
+
+    clarinet_socket destination;
+    clarinet_socket* dsp = &destination;
+    clarinet_socket_init(dsp);
+
+    errcode = clarinet_socket_open(dsp, CLARINET_AF_INET, CLARINET_PROTO_UDP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto ondestinationexit = finalizer([&dsp]
+    {
+        clarinet_socket_close(dsp);
+    });
+
+    errcode = clarinet_socket_bind(dsp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint destination_endpoint;
+    errcode = clarinet_socket_local_endpoint(dsp, &destination_endpoint);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_uring_recvfrom_multishot(ur, dsp, 0, dsp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_uring_submit(ur);
+    REQUIRE(errcode == 1);
+
+    const uint8_t sendbuf[] = { 0xAA, 0xBB, 0xCC };
+    for (size_t i = 0; i < bufcount; ++i)
+    {
+        errcode = clarinet_socket_sendto(ssp, sendbuf, sizeof(sendbuf), &destination_endpoint);
+        REQUIRE(errcode == (int)sizeof(sendbuf));
+    }
+
+    // The system terminates a multishot receive whose completion overflows the queue. That last completion must still
+    // be delivered once there is room for it so the operation can be re-armed until every datagram is received.
+    size_t received = 0;
+    while (received < bufcount)
+    {
+        clarinet_uring_completion completions[bufcount];
+        const int n = clarinet_uring_wait(ur, completions, bufcount, 1000);
+        if (n == CLARINET_EINVAL && received == 0)
+        {
+            WARN("Multishot receive is not supported by the system.");
+            return;
+        }
+        REQUIRE(n > 0);
+
+        for (size_t i = 0; i < (size_t)n; ++i)
+        {
+            const clarinet_uring_completion* completion = &completions[i];
+            REQUIRE(completion->result == (int)sizeof(sendbuf));
+            REQUIRE((completion->flags & CLARINET_URING_COMPLETION_BUFFER) != 0);
+            received++;
+
+            errcode = clarinet_uring_release(ur, 0, completion->buffer);
+            REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+            if (!(completion->flags & CLARINET_URING_COMPLETION_MORE) && received < bufcount)
+            {
+                errcode = clarinet_uring_recvfrom_multishot(ur, dsp, 0, dsp);
+                REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+            }
+        }
+    }
+
+    errcode = clarinet_uring_cancel(ur, dsp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+}
+
+TEST_CASE("Uring Accept/Connect")
+{
+    clarinet_uring ring;
+    clarinet_uring* ur = &ring;
+    clarinet_uring_init(ur);
+
+    int errcode = clarinet_uring_open(ur, 8);
+    DEPENDS_ON_URING(errcode);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onringexit = finalizer([&ur]
+    {
+        clarinet_uring_close(ur);
+    });
+
+    const clarinet_endpoint local = clarinet_make_endpoint(clarinet_addr_loopback_ipv4, 0);
+
+    clarinet_socket server;
+    clarinet_socket* ssp = &server;
+    clarinet_socket_init(ssp);
+
+    errcode = clarinet_socket_open(ssp, CLARINET_AF_INET, CLARINET_PROTO_TCP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onserverexit = finalizer([&ssp]
+    {
+        clarinet_socket_close(ssp);
+    });
+
+    errcode = clarinet_socket_bind(ssp, &local);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_socket_listen(ssp, 1);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_endpoint server_endpoint;
+    errcode = clarinet_socket_local_endpoint(ssp, &server_endpoint);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_socket client;
+    clarinet_socket* csp = &client;
+    clarinet_socket_init(csp);
+
+    errcode = clarinet_socket_open(csp, CLARINET_AF_INET, CLARINET_PROTO_TCP);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    const auto onclientexit = finalizer([&csp]
+    {
+        clarinet_socket_close(csp);
+    });
+
+    clarinet_socket accepted;
+    clarinet_socket* asp = &accepted;
+    clarinet_socket_init(asp);
+    const auto onacceptedexit = finalizer([&asp]
+    {
+        clarinet_socket_close(asp);
+    });
+
+    clarinet_endpoint remote = { clarinet_addr_none, 0 };
+    errcode = clarinet_uring_accept(ur, ssp, asp, &remote, asp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_uring_connect(ur, csp, &server_endpoint, csp);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    clarinet_uring_completion completions[2];
+    size_t reaped = 0;
+    while (reaped < 2)
+    {
+        errcode = clarinet_uring_wait(ur, &completions[reaped], 2 - reaped, 1000);
+        REQUIRE(errcode > 0);
+        reaped += (size_t)errcode;
+    }
+
+    REQUIRE(Error(completions[0].result) == Error(CLARINET_ENONE));
+    REQUIRE(Error(completions[1].result) == Error(CLARINET_ENONE));
+    REQUIRE(asp->family == CLARINET_AF_INET);
+
+    clarinet_endpoint client_endpoint;
+    errcode = clarinet_socket_local_endpoint(csp, &client_endpoint);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+    REQUIRE(clarinet_endpoint_is_equal(&remote, &client_endpoint));
+
+    const uint8_t sendbuf[] = { 0xAA, 0xBB, 0xCC };
+    uint8_t recvbuf[16] = { 0 };
+
+    errcode = clarinet_uring_recv(ur, asp, recvbuf, sizeof(recvbuf), recvbuf);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    errcode = clarinet_uring_send(ur, csp, sendbuf, sizeof(sendbuf), (void*)sendbuf);
+    REQUIRE(Error(errcode) == Error(CLARINET_ENONE));
+
+    reaped = 0;
+    while (reaped < 2)
+    {
+        errcode = clarinet_uring_wait(ur, &completions[reaped], 2 - reaped, 1000);
+        REQUIRE(errcode > 0);
+        reaped += (size_t)errcode;
+    }
+
+    REQUIRE(completions[0].result == (int)sizeof(sendbuf));
+    REQUIRE(completions[1].result == (int)sizeof(sendbuf));
+    REQUIRE(memcmp(recvbuf, sendbuf, sizeof(sendbuf)) == 0);
+}
+#endif